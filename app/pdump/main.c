@@ -23,15 +23,23 @@
 #include <rte_errno.h>
 #include <rte_dev.h>
 #include <rte_kvargs.h>
+#include <rte_malloc.h>
 #include <rte_mempool.h>
 #include <rte_ring.h>
 #include <rte_string_fns.h>
 #include <rte_pdump.h>
+#include <rte_bpf.h>
+
+#ifdef RTE_PORT_PCAP
+#include <pcap/pcap.h>
+#endif
 
 #define CMD_LINE_OPT_PDUMP "pdump"
 #define CMD_LINE_OPT_PDUMP_NUM 256
 #define CMD_LINE_OPT_MULTI "multi"
 #define CMD_LINE_OPT_MULTI_NUM 257
+#define CMD_LINE_OPT_FILTER "filter"
+#define CMD_LINE_OPT_FILTER_NUM 258
 #define PDUMP_PORT_ARG "port"
 #define PDUMP_PCI_ARG "device_id"
 #define PDUMP_QUEUE_ARG "queue"
@@ -41,9 +49,16 @@
 #define PDUMP_RING_SIZE_ARG "ring-size"
 #define PDUMP_MSIZE_ARG "mbuf-size"
 #define PDUMP_NUM_MBUFS_ARG "total-num-mbufs"
+#define PDUMP_SNAPLEN_ARG "snaplen"
+#define PDUMP_FORMAT_ARG "format"
 
 #define VDEV_NAME_FMT "net_pcap_%s_%d"
 #define VDEV_PCAP_ARGS_FMT "tx_pcap=%s"
+#define VDEV_PCAPNG_ARGS_FMT "tx_pcapng=%s"
+/* vdev args of a capture file, in the format of the pdump tuple */
+#define VDEV_FILE_ARGS_FMT(pt) \
+	((pt)->format_flags & RTE_PDUMP_FLAG_PCAPNG ? \
+	 VDEV_PCAPNG_ARGS_FMT : VDEV_PCAP_ARGS_FMT)
 #define VDEV_IFACE_ARGS_FMT "tx_iface=%s"
 #define TX_STREAM_SIZE 64
 
@@ -97,6 +112,8 @@ static const char * const valid_pdump_arguments[] = {
 	PDUMP_RING_SIZE_ARG,
 	PDUMP_MSIZE_ARG,
 	PDUMP_NUM_MBUFS_ARG,
+	PDUMP_SNAPLEN_ARG,
+	PDUMP_FORMAT_ARG,
 	NULL
 };
 
@@ -116,12 +133,16 @@ struct pdump_tuples {
 	uint32_t ring_size;
 	uint16_t mbuf_data_size;
 	uint32_t total_num_mbufs;
+	uint32_t snaplen;
+	uint32_t format_flags; /* RTE_PDUMP_FLAG_PCAPNG for pcapng files */
+	char *filter;
 
 	/* params for library API call */
 	uint32_t dir;
 	struct rte_mempool *mp;
 	struct rte_ring *rx_ring;
 	struct rte_ring *tx_ring;
+	struct rte_bpf_prm *prm;
 
 	/* params for packet dumping */
 	enum pdump_by dump_by_type;
@@ -160,7 +181,10 @@ pdump_usage(const char *prgname)
 			" tx-dev=<iface or pcap file>,"
 			"[ring-size=<ring size>default:16384],"
 			"[mbuf-size=<mbuf data size>default:2176],"
-			"[total-num-mbufs=<number of mbufs>default:65535]'\n",
+			"[total-num-mbufs=<number of mbufs>default:65535],"
+			"[snaplen=<max bytes captured per packet>default:0 (all)],"
+			"[format=<pcap|pcapng>default:pcap]'"
+			" [--"CMD_LINE_OPT_FILTER" '<pcap filter expression>']\n",
 			prgname);
 }
 
@@ -212,6 +236,25 @@ parse_rxtxdev(const char *key, const char *value, void *extra_args)
 	return 0;
 }
 
+static int
+parse_format(const char *key __rte_unused, const char *value,
+		void *extra_args)
+{
+	struct pdump_tuples *pt = extra_args;
+
+	if (!strcmp(value, "pcap"))
+		pt->format_flags = 0;
+	else if (!strcmp(value, "pcapng"))
+		pt->format_flags = RTE_PDUMP_FLAG_PCAPNG;
+	else {
+		printf("invalid format '%s', should be pcap or pcapng\n",
+			value);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 parse_uint_value(const char *key, const char *value, void *extra_args)
 {
@@ -370,6 +413,29 @@ parse_pdump(const char *optarg)
 	} else
 		pt->total_num_mbufs = MBUFS_PER_POOL;
 
+	/* snaplen parsing and validation */
+	cnt1 = rte_kvargs_count(kvlist, PDUMP_SNAPLEN_ARG);
+	if (cnt1 == 1) {
+		v.min = 0;
+		v.max = UINT32_MAX;
+		ret = rte_kvargs_process(kvlist, PDUMP_SNAPLEN_ARG,
+						&parse_uint_value, &v);
+		if (ret < 0)
+			goto free_kvlist;
+		pt->snaplen = (uint32_t) v.val;
+	} else
+		pt->snaplen = 0;
+
+	/* capture file format parsing and validation */
+	pt->format_flags = 0;
+	cnt1 = rte_kvargs_count(kvlist, PDUMP_FORMAT_ARG);
+	if (cnt1 == 1) {
+		ret = rte_kvargs_process(kvlist, PDUMP_FORMAT_ARG,
+						&parse_format, pt);
+		if (ret < 0)
+			goto free_kvlist;
+	}
+
 	num_tuples++;
 
 free_kvlist:
@@ -377,6 +443,35 @@ parse_pdump(const char *optarg)
 	return ret;
 }
 
+/*
+ * The filter expression may contain commas and equal signs, it is given in
+ * its own option following the --pdump one it applies to.
+ */
+static int
+parse_filter(const char *optarg)
+{
+	struct pdump_tuples *pt;
+
+	if (num_tuples == 0) {
+		printf("--%s=\"%s\": must follow a --%s option\n",
+			CMD_LINE_OPT_FILTER, optarg, CMD_LINE_OPT_PDUMP);
+		return -1;
+	}
+
+	pt = &pdump_t[num_tuples - 1];
+	if (pt->filter != NULL) {
+		printf("--%s=\"%s\": only one filter per --%s option\n",
+			CMD_LINE_OPT_FILTER, optarg, CMD_LINE_OPT_PDUMP);
+		return -1;
+	}
+
+	pt->filter = strdup(optarg);
+	if (pt->filter == NULL)
+		return -1;
+
+	return 0;
+}
+
 /* Parse the argument given in the command line of the application */
 static int
 launch_args_parse(int argc, char **argv, char *prgname)
@@ -386,6 +481,7 @@ launch_args_parse(int argc, char **argv, char *prgname)
 	static struct option long_option[] = {
 		{CMD_LINE_OPT_PDUMP, 1, 0, CMD_LINE_OPT_PDUMP_NUM},
 		{CMD_LINE_OPT_MULTI, 0, 0, CMD_LINE_OPT_MULTI_NUM},
+		{CMD_LINE_OPT_FILTER, 1, 0, CMD_LINE_OPT_FILTER_NUM},
 		{NULL, 0, 0, 0}
 	};
 
@@ -406,6 +502,13 @@ launch_args_parse(int argc, char **argv, char *prgname)
 		case CMD_LINE_OPT_MULTI_NUM:
 			multiple_core_capture = 1;
 			break;
+		case CMD_LINE_OPT_FILTER_NUM:
+			ret = parse_filter(optarg);
+			if (ret) {
+				pdump_usage(prgname);
+				return -1;
+			}
+			break;
 		default:
 			pdump_usage(prgname);
 			return -1;
@@ -550,6 +653,11 @@ cleanup_pdump_resources(void)
 			rte_eal_hotplug_remove("vdev", name);
 		}
 
+		/* the pdump library keeps its own copy of the filter */
+		rte_free(pt->prm);
+		pt->prm = NULL;
+		free(pt->filter);
+		pt->filter = NULL;
 	}
 	cleanup_rings();
 }
@@ -691,7 +799,7 @@ create_mp_ring_vdev(void)
 			snprintf(vdev_args, sizeof(vdev_args),
 				 VDEV_IFACE_ARGS_FMT, pt->rx_dev) :
 			snprintf(vdev_args, sizeof(vdev_args),
-				 VDEV_PCAP_ARGS_FMT, pt->rx_dev);
+				 VDEV_FILE_ARGS_FMT(pt), pt->rx_dev);
 			if (rte_eal_hotplug_add("vdev", vdev_name,
 						vdev_args) < 0) {
 				cleanup_rings();
@@ -721,7 +829,7 @@ create_mp_ring_vdev(void)
 				snprintf(vdev_args, sizeof(vdev_args),
 					 VDEV_IFACE_ARGS_FMT, pt->tx_dev) :
 				snprintf(vdev_args, sizeof(vdev_args),
-					 VDEV_PCAP_ARGS_FMT, pt->tx_dev);
+					 VDEV_FILE_ARGS_FMT(pt), pt->tx_dev);
 				if (rte_eal_hotplug_add("vdev", vdev_name,
 							vdev_args) < 0) {
 					cleanup_rings();
@@ -761,7 +869,7 @@ create_mp_ring_vdev(void)
 			snprintf(vdev_args, sizeof(vdev_args),
 				 VDEV_IFACE_ARGS_FMT, pt->rx_dev) :
 			snprintf(vdev_args, sizeof(vdev_args),
-				 VDEV_PCAP_ARGS_FMT, pt->rx_dev);
+				 VDEV_FILE_ARGS_FMT(pt), pt->rx_dev);
 			if (rte_eal_hotplug_add("vdev", vdev_name,
 						vdev_args) < 0) {
 				cleanup_rings();
@@ -798,7 +906,7 @@ create_mp_ring_vdev(void)
 			snprintf(vdev_args, sizeof(vdev_args),
 				 VDEV_IFACE_ARGS_FMT, pt->tx_dev) :
 			snprintf(vdev_args, sizeof(vdev_args),
-				 VDEV_PCAP_ARGS_FMT, pt->tx_dev);
+				 VDEV_FILE_ARGS_FMT(pt), pt->tx_dev);
 			if (rte_eal_hotplug_add("vdev", vdev_name,
 						vdev_args) < 0) {
 				cleanup_rings();
@@ -821,6 +929,57 @@ create_mp_ring_vdev(void)
 	}
 }
 
+#ifdef RTE_PORT_PCAP
+/* Compile a pcap filter expression to an eBPF program for the pdump library */
+static struct rte_bpf_prm *
+compile_filter(const char *filter, uint32_t snaplen)
+{
+	struct rte_bpf_prm *prm;
+	struct bpf_program fcode;
+	pcap_t *pcap;
+
+	pcap = pcap_open_dead(DLT_EN10MB, snaplen == 0 ? 65535 : snaplen);
+	if (pcap == NULL)
+		rte_exit(EXIT_FAILURE, "pcap_open_dead failed\n");
+
+	if (pcap_compile(pcap, &fcode, filter, 1,
+			 PCAP_NETMASK_UNKNOWN) != 0)
+		rte_exit(EXIT_FAILURE, "Invalid filter \"%s\": %s\n",
+			 filter, pcap_geterr(pcap));
+
+	prm = rte_bpf_convert(&fcode);
+	if (prm == NULL)
+		rte_exit(EXIT_FAILURE, "Cannot convert filter \"%s\": %s\n",
+			 filter, rte_strerror(rte_errno));
+
+	pcap_freecode(&fcode);
+	pcap_close(pcap);
+
+	return prm;
+}
+#else
+static struct rte_bpf_prm *
+compile_filter(const char *filter, uint32_t snaplen __rte_unused)
+{
+	rte_exit(EXIT_FAILURE, "Cannot use filter \"%s\": no libpcap support\n",
+		 filter);
+	return NULL;
+}
+#endif
+
+static void
+compile_filters(void)
+{
+	struct pdump_tuples *pt;
+	int i;
+
+	for (i = 0; i < num_tuples; i++) {
+		pt = &pdump_t[i];
+		if (pt->filter != NULL)
+			pt->prm = compile_filter(pt->filter, pt->snaplen);
+	}
+}
+
 static void
 enable_pdump(void)
 {
@@ -832,48 +991,62 @@ enable_pdump(void)
 		pt = &pdump_t[i];
 		if (pt->dir == RTE_PDUMP_FLAG_RXTX) {
 			if (pt->dump_by_type == DEVICE_ID) {
-				ret = rte_pdump_enable_by_deviceid(
+				ret = rte_pdump_enable_bpf_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						RTE_PDUMP_FLAG_RX,
+						RTE_PDUMP_FLAG_RX |
+						pt->format_flags,
+						pt->snaplen,
 						pt->rx_ring,
-						pt->mp, NULL);
-				ret1 = rte_pdump_enable_by_deviceid(
+						pt->mp, pt->prm);
+				ret1 = rte_pdump_enable_bpf_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						RTE_PDUMP_FLAG_TX,
+						RTE_PDUMP_FLAG_TX |
+						pt->format_flags,
+						pt->snaplen,
 						pt->tx_ring,
-						pt->mp, NULL);
+						pt->mp, pt->prm);
 			} else if (pt->dump_by_type == PORT_ID) {
-				ret = rte_pdump_enable(pt->port, pt->queue,
-						RTE_PDUMP_FLAG_RX,
-						pt->rx_ring, pt->mp, NULL);
-				ret1 = rte_pdump_enable(pt->port, pt->queue,
-						RTE_PDUMP_FLAG_TX,
-						pt->tx_ring, pt->mp, NULL);
+				ret = rte_pdump_enable_bpf(pt->port, pt->queue,
+						RTE_PDUMP_FLAG_RX |
+						pt->format_flags,
+						pt->snaplen,
+						pt->rx_ring, pt->mp, pt->prm);
+				ret1 = rte_pdump_enable_bpf(pt->port, pt->queue,
+						RTE_PDUMP_FLAG_TX |
+						pt->format_flags,
+						pt->snaplen,
+						pt->tx_ring, pt->mp, pt->prm);
 			}
 		} else if (pt->dir == RTE_PDUMP_FLAG_RX) {
 			if (pt->dump_by_type == DEVICE_ID)
-				ret = rte_pdump_enable_by_deviceid(
+				ret = rte_pdump_enable_bpf_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						pt->dir, pt->rx_ring,
-						pt->mp, NULL);
+						pt->dir | pt->format_flags,
+						pt->snaplen,
+						pt->rx_ring,
+						pt->mp, pt->prm);
 			else if (pt->dump_by_type == PORT_ID)
-				ret = rte_pdump_enable(pt->port, pt->queue,
-						pt->dir,
-						pt->rx_ring, pt->mp, NULL);
+				ret = rte_pdump_enable_bpf(pt->port, pt->queue,
+						pt->dir | pt->format_flags,
+						pt->snaplen,
+						pt->rx_ring, pt->mp, pt->prm);
 		} else if (pt->dir == RTE_PDUMP_FLAG_TX) {
 			if (pt->dump_by_type == DEVICE_ID)
-				ret = rte_pdump_enable_by_deviceid(
+				ret = rte_pdump_enable_bpf_by_deviceid(
 						pt->device_id,
 						pt->queue,
-						pt->dir,
-						pt->tx_ring, pt->mp, NULL);
+						pt->dir | pt->format_flags,
+						pt->snaplen,
+						pt->tx_ring,
+						pt->mp, pt->prm);
 			else if (pt->dump_by_type == PORT_ID)
-				ret = rte_pdump_enable(pt->port, pt->queue,
-						pt->dir,
-						pt->tx_ring, pt->mp, NULL);
+				ret = rte_pdump_enable_bpf(pt->port, pt->queue,
+						pt->dir | pt->format_flags,
+						pt->snaplen,
+						pt->tx_ring, pt->mp, pt->prm);
 		}
 		if (ret < 0 || ret1 < 0) {
 			cleanup_pdump_resources();
@@ -1005,6 +1178,7 @@ main(int argc, char **argv)
 
 	/* create mempool, ring and vdevs info */
 	create_mp_ring_vdev();
+	compile_filters();
 	enable_pdump();
 	enable_primary_monitor();
 	dump_packets();
@@ -11,6 +11,9 @@
 #include <rte_per_lcore.h>
 #include <rte_lcore.h>
 #include <rte_ip.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+#include <rte_rcu_qsbr.h>
 
 #define	PRINT_USAGE_START	"%s [EAL options] --\n"
 
@@ -41,6 +44,9 @@
 #define	OPT_ITER_NUM		"iter"
 #define	OPT_VERBOSE		"verbose"
 #define	OPT_IPV6		"ipv6"
+#define	OPT_CHURN		"churn"
+#define	OPT_MERGE_THR		"mergethr"
+#define	OPT_BLD_THREADS		"bldthreads"
 
 #define	TRACE_DEFAULT_NUM	0x10000
 #define	TRACE_STEP_MAX		0x1000
@@ -48,6 +54,11 @@
 
 #define	RULE_NUM		0x10000
 
+#define	MERGE_THR_DEF		0x100
+
+/* no more tries to build at once */
+#define	BLD_THREADS_MAX		8
+
 enum {
 	DUMP_NONE,
 	DUMP_SEARCH,
@@ -105,10 +116,19 @@ static struct {
 	uint32_t            iter_num;
 	uint32_t            verbose;
 	uint32_t            ipv6;
+	uint32_t            churn;
+	uint32_t            merge_thr;
+	uint32_t            bld_threads;
 	struct acl_alg      alg;
 	uint32_t            used_traces;
 	void               *traces;
 	struct rte_acl_ctx *acx;
+	struct rte_acl_config cfg;
+	uint32_t            used_rules;
+	void               *rules;
+	struct rte_acl_inc *ictx;
+	struct rte_rcu_qsbr *qsv;
+	volatile uint32_t   churn_done;
 } config = {
 	.bld_categories = 3,
 	.run_categories = 1,
@@ -121,7 +141,9 @@ static struct {
 		.name = "default",
 		.alg = RTE_ACL_CLASSIFY_DEFAULT,
 	},
-	.ipv6 = 0
+	.ipv6 = 0,
+	.merge_thr = MERGE_THR_DEF,
+	.bld_threads = 1,
 };
 
 static struct rte_acl_param prm = {
@@ -756,8 +778,15 @@ add_cb_rules(FILE *f, struct rte_acl_ctx *ctx)
 				n, rc, strerror(-rc));
 			return rc;
 		}
+
+		/* keep a copy of the rules to update them during churn. */
+		if (config.rules != NULL)
+			memcpy((struct acl_rule *)config.rules + n - 1, &v,
+				sizeof(v));
 	}
 
+	config.used_rules = n - 1;
+
 	return 0;
 }
 
@@ -766,6 +795,8 @@ acx_init(void)
 {
 	int ret;
 	FILE *f;
+	uint32_t n;
+	uint64_t tm;
 	struct rte_acl_config cfg;
 
 	memset(&cfg, 0, sizeof(cfg));
@@ -789,6 +820,13 @@ acx_init(void)
 	if (config.acx == NULL)
 		rte_exit(rte_errno, "failed to create ACL context\n");
 
+	if (config.churn != 0) {
+		config.rules = rte_zmalloc(NULL,
+			prm.max_rule_num * sizeof(struct acl_rule), 0);
+		if (config.rules == NULL)
+			rte_exit(-ENOMEM, "failed to allocate rules copy\n");
+	}
+
 	/* set default classify method for this context. */
 	if (config.alg.alg != RTE_ACL_CLASSIFY_DEFAULT) {
 		ret = rte_acl_set_ctx_classify(config.acx, config.alg.alg);
@@ -810,16 +848,38 @@ acx_init(void)
 	fclose(f);
 
 	/* perform build. */
+	tm = rte_rdtsc_precise();
 	ret = rte_acl_build(config.acx, &cfg);
+	tm = rte_rdtsc_precise() - tm;
 
 	dump_verbose(DUMP_NONE, stdout,
-		"rte_acl_build(%u) finished with %d\n",
-		config.bld_categories, ret);
+		"rte_acl_build(%u) finished with %d, "
+		"%" PRIu64 " cycles (%.2Lf usec)\n",
+		config.bld_categories, ret, tm,
+		(long double)tm * US_PER_S / rte_get_timer_hz());
 
 	rte_acl_dump(config.acx);
 
 	if (ret != 0)
 		rte_exit(ret, "failed to build search context\n");
+
+	/* report build time for each number of build threads. */
+	for (n = 2; n <= config.bld_threads; n++) {
+		tm = rte_rdtsc_precise();
+		ret = rte_acl_build_parallel(config.acx, &cfg, n);
+		tm = rte_rdtsc_precise() - tm;
+
+		dump_verbose(DUMP_NONE, stdout,
+			"rte_acl_build_parallel(%u, %u threads) finished "
+			"with %d, %" PRIu64 " cycles (%.2Lf usec)\n",
+			config.bld_categories, n, ret, tm,
+			(long double)tm * US_PER_S / rte_get_timer_hz());
+
+		if (ret != 0)
+			rte_exit(ret, "failed to build search context\n");
+	}
+
+	config.cfg = cfg;
 }
 
 static uint32_t
@@ -895,6 +955,242 @@ search_ip5tuples(__rte_unused void *arg)
 	return 0;
 }
 
+/*
+ * Incremental updates benchmark: the worker lcores classify the traces
+ * with an incremental ACL context, while the main lcore deletes and adds
+ * back random rules, and a control thread merges the delta trie set into
+ * the main one in the background.
+ */
+static uint32_t
+churn_search_once(uint32_t lcore, uint32_t categories, uint32_t step)
+{
+	int ret;
+	uint32_t i, j, n;
+	const uint8_t *data[step], *v;
+	uint32_t results[step * categories];
+
+	v = config.traces;
+	for (i = 0; i != config.used_traces; i += n) {
+
+		n = RTE_MIN(step, config.used_traces - i);
+
+		for (j = 0; j != n; j++) {
+			data[j] = v;
+			v += config.trace_sz;
+		}
+
+		ret = rte_acl_inc_classify(config.ictx, data, results,
+			n, categories);
+		if (ret != 0)
+			rte_exit(ret, "incremental classify returns %d\n", ret);
+
+		rte_rcu_qsbr_quiescent(config.qsv, lcore);
+	}
+
+	return i;
+}
+
+static int
+churn_search(__rte_unused void *arg)
+{
+	uint64_t pkt, start, tm;
+	uint32_t i, lcore;
+	long double st;
+
+	lcore = rte_lcore_id();
+	rte_rcu_qsbr_thread_register(config.qsv, lcore);
+	rte_rcu_qsbr_thread_online(config.qsv, lcore);
+
+	start = rte_rdtsc_precise();
+	pkt = 0;
+
+	for (i = 0; config.churn_done == 0; i++)
+		pkt += churn_search_once(lcore, config.run_categories,
+			config.trace_step);
+
+	tm = rte_rdtsc_precise() - start;
+
+	rte_rcu_qsbr_thread_offline(config.qsv, lcore);
+	rte_rcu_qsbr_thread_unregister(config.qsv, lcore);
+
+	st = (long double)tm / rte_get_timer_hz();
+	dump_verbose(DUMP_NONE, stdout,
+		"%s  @lcore %u: %" PRIu32 " iterations, %" PRIu64 " pkts, %"
+		PRIu32 " categories, %" PRIu64 " cycles (%.2Lf sec), "
+		"%.2Lf cycles/pkt, %.2Lf pkt/sec\n",
+		__func__, lcore, i, pkt,
+		config.run_categories, tm, st,
+		(pkt == 0) ? 0 : (long double)tm / pkt, pkt / st);
+
+	return 0;
+}
+
+static void *
+churn_merge(__rte_unused void *arg)
+{
+	int ret;
+	uint32_t n;
+	uint64_t tm, total;
+	struct rte_acl_inc_stats st;
+
+	n = 0;
+	total = 0;
+	while (config.churn_done == 0) {
+		rte_acl_inc_get_stats(config.ictx, &st);
+		if (st.delta_rules < config.merge_thr) {
+			rte_delay_us_sleep(100);
+			continue;
+		}
+
+		tm = rte_rdtsc_precise();
+		ret = rte_acl_inc_merge(config.ictx);
+		tm = rte_rdtsc_precise() - tm;
+		if (ret != 0)
+			rte_exit(ret, "failed to merge ACL context\n");
+		total += tm;
+		n++;
+	}
+
+	dump_verbose(DUMP_NONE, stdout,
+		"%s: %u merges, %.2Lf usec/merge\n", __func__, n,
+		(n == 0) ? 0 : (long double)total * US_PER_S / n /
+		rte_get_timer_hz());
+	return NULL;
+}
+
+static void
+churn_update(void)
+{
+	int ret;
+	uint32_t i, k;
+	uint64_t min, max, sum, tm;
+	struct acl_rule *r;
+
+	min = UINT64_MAX;
+	max = 0;
+	sum = 0;
+
+	for (i = 0; i != config.churn; i++) {
+		k = rte_rand() % config.used_rules;
+		r = (struct acl_rule *)config.rules + k;
+
+		tm = rte_rdtsc_precise();
+		ret = rte_acl_inc_del_rules(config.ictx, &r->data.userdata, 1);
+		if (ret != 0)
+			rte_exit(ret, "failed to delete rule %u\n", k + 1);
+
+		/* deleted rules are released by the merge in progress */
+		do {
+			if (ret == -ENOMEM)
+				rte_delay_us_sleep(10);
+			ret = rte_acl_inc_add_rules(config.ictx,
+				(struct rte_acl_rule *)r, 1);
+		} while (ret == -ENOMEM);
+		tm = rte_rdtsc_precise() - tm;
+
+		if (ret != 0)
+			rte_exit(ret, "failed to update rule %u\n", k + 1);
+
+		min = RTE_MIN(min, tm);
+		max = RTE_MAX(max, tm);
+		sum += tm;
+	}
+
+	/* each update is a delete and an add */
+	dump_verbose(DUMP_NONE, stdout,
+		"%s: %u updates, cycles/update min: %" PRIu64 ", avg: %.2Lf, "
+		"max: %" PRIu64 ", avg: %.2Lf usec/update\n",
+		__func__, i, min, (long double)sum / i, max,
+		(long double)sum * US_PER_S / i / rte_get_timer_hz());
+}
+
+static void
+churn_init(void)
+{
+	int ret;
+	size_t sz;
+	uint64_t tm;
+	struct rte_acl_inc_param iprm;
+	struct rte_acl_rcu_config rcfg;
+
+	if (config.used_rules == 0)
+		rte_exit(-EINVAL, "no rules to update\n");
+
+	iprm.name = APP_NAME "_inc";
+	iprm.socket_id = SOCKET_ID_ANY;
+	iprm.rule_size = sizeof(struct acl_rule);
+	/* leave room for the rules deleted until the next merge */
+	iprm.max_rule_num = config.used_rules + 4 * config.merge_thr;
+	iprm.cfg = &config.cfg;
+
+	config.ictx = rte_acl_inc_create(&iprm);
+	if (config.ictx == NULL)
+		rte_exit(rte_errno, "failed to create incremental ACL context\n");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	config.qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (config.qsv == NULL)
+		rte_exit(-ENOMEM, "failed to allocate RCU QSBR variable\n");
+	rte_rcu_qsbr_init(config.qsv, RTE_MAX_LCORE);
+
+	memset(&rcfg, 0, sizeof(rcfg));
+	rcfg.v = config.qsv;
+	rcfg.mode = RTE_ACL_QSBR_MODE_DQ;
+	ret = rte_acl_inc_rcu_qsbr_add(config.ictx, &rcfg);
+	if (ret != 0)
+		rte_exit(ret, "failed to attach RCU QSBR variable\n");
+
+	ret = rte_acl_inc_add_rules(config.ictx, config.rules,
+		config.used_rules);
+	if (ret != 0)
+		rte_exit(ret, "failed to add rules into incremental ACL "
+			"context\n");
+
+	tm = rte_rdtsc_precise();
+	ret = rte_acl_inc_merge(config.ictx);
+	tm = rte_rdtsc_precise() - tm;
+	if (ret != 0)
+		rte_exit(ret, "failed to merge incremental ACL context\n");
+
+	dump_verbose(DUMP_NONE, stdout,
+		"rte_acl_inc_merge(%u rules) finished, "
+		"%" PRIu64 " cycles (%.2Lf usec)\n",
+		config.used_rules, tm,
+		(long double)tm * US_PER_S / rte_get_timer_hz());
+}
+
+static void
+churn_run(void)
+{
+	int ret;
+	uint32_t lcore;
+	pthread_t tid;
+
+	churn_init();
+
+	if (rte_lcore_count() == 1)
+		dump_verbose(DUMP_NONE, stdout,
+			"no worker lcore, classify throughput is not measured\n");
+
+	RTE_LCORE_FOREACH_WORKER(lcore)
+		rte_eal_remote_launch(churn_search, NULL, lcore);
+
+	ret = rte_ctrl_thread_create(&tid, APP_NAME "-merge", NULL,
+		churn_merge, NULL);
+	if (ret != 0)
+		rte_exit(-ret, "failed to create merge thread\n");
+
+	churn_update();
+
+	config.churn_done = 1;
+	pthread_join(tid, NULL);
+	rte_eal_mp_wait_lcore();
+
+	rte_acl_inc_free(config.ictx);
+	rte_free(config.qsv);
+	rte_free(config.rules);
+}
+
 static unsigned long
 get_ulong_opt(const char *opt, const char *name, size_t min, size_t max)
 {
@@ -966,7 +1262,14 @@ print_usage(const char *prgname)
 		"[--" OPT_ITER_NUM "=<number of iterations to perform>]\n"
 		"[--" OPT_VERBOSE "=<verbose level>]\n"
 		"[--" OPT_SEARCH_ALG "=%s]\n"
-		"[--" OPT_IPV6 "=<IPv6 rules and trace files>]\n",
+		"[--" OPT_IPV6 "=<IPv6 rules and trace files>]\n"
+		"[--" OPT_CHURN "=<number of rule updates to perform "
+			"while classifying with an incremental context>]\n"
+		"[--" OPT_MERGE_THR "=<number of rules in the delta trie set "
+			"to trigger a merge>]\n"
+		"[--" OPT_BLD_THREADS "=<maximum number of threads to "
+			"build with, the build time is reported for each "
+			"number of threads>]\n",
 		prgname, RTE_ACL_RESULTS_MULTIPLIER,
 		(uint32_t)RTE_ACL_MAX_CATEGORIES,
 		buf);
@@ -989,6 +1292,9 @@ dump_config(FILE *f)
 	fprintf(f, "%s:%u(%s)\n", OPT_SEARCH_ALG, config.alg.alg,
 		config.alg.name);
 	fprintf(f, "%s:%u\n", OPT_IPV6, config.ipv6);
+	fprintf(f, "%s:%u\n", OPT_CHURN, config.churn);
+	fprintf(f, "%s:%u\n", OPT_MERGE_THR, config.merge_thr);
+	fprintf(f, "%s:%u\n", OPT_BLD_THREADS, config.bld_threads);
 }
 
 static void
@@ -999,6 +1305,11 @@ check_config(void)
 		rte_exit(-EINVAL, "mandatory option %s is not specified\n",
 			OPT_RULE_FILE);
 	}
+	if (config.churn != 0 && config.trace_file == NULL) {
+		print_usage(config.prgname);
+		rte_exit(-EINVAL, "option %s requires option %s\n",
+			OPT_CHURN, OPT_TRACE_FILE);
+	}
 }
 
 
@@ -1018,6 +1329,9 @@ get_input_opts(int argc, char **argv)
 		{OPT_VERBOSE, 1, 0, 0},
 		{OPT_SEARCH_ALG, 1, 0, 0},
 		{OPT_IPV6, 0, 0, 0},
+		{OPT_CHURN, 1, 0, 0},
+		{OPT_MERGE_THR, 1, 0, 0},
+		{OPT_BLD_THREADS, 1, 0, 0},
 		{NULL, 0, 0, 0}
 	};
 
@@ -1067,6 +1381,16 @@ get_input_opts(int argc, char **argv)
 			get_alg_opt(optarg, lgopts[opt_idx].name);
 		} else if (strcmp(lgopts[opt_idx].name, OPT_IPV6) == 0) {
 			config.ipv6 = 1;
+		} else if (strcmp(lgopts[opt_idx].name, OPT_CHURN) == 0) {
+			config.churn = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 0, UINT32_MAX);
+		} else if (strcmp(lgopts[opt_idx].name, OPT_MERGE_THR) == 0) {
+			config.merge_thr = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 1, RTE_ACL_MAX_INDEX);
+		} else if (strcmp(lgopts[opt_idx].name,
+				OPT_BLD_THREADS) == 0) {
+			config.bld_threads = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 1, BLD_THREADS_MAX);
 		}
 	}
 	config.trace_sz = config.ipv6 ? sizeof(struct ipv6_5tuple) :
@@ -1105,6 +1429,9 @@ main(int argc, char **argv)
 
 	rte_eal_mp_wait_lcore();
 
+	if (config.churn != 0)
+		churn_run();
+
 	rte_acl_free(config.acx);
 	return 0;
 }
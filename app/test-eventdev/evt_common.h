@@ -61,6 +61,7 @@ struct evt_options {
 	uint16_t vector_size;
 	uint16_t eth_queues;
 	uint32_t nb_flows;
+	uint32_t nb_elephant_flows;
 	uint32_t tx_first;
 	uint32_t max_pkt_sz;
 	uint32_t deq_tmo_nsec;
@@ -134,6 +135,17 @@ evt_service_setup(uint32_t service_id)
 			RTE_MAX_LCORE);
 	if (core_cnt < 0)
 		return -ENOENT;
+	/* Run a multi-thread safe service, e.g. a partitioned scheduler, on
+	 * all the service cores.
+	 */
+	if (rte_service_probe_capability(service_id,
+			RTE_SERVICE_CAP_MT_SAFE) == 1) {
+		while (core_cnt--)
+			if (rte_service_map_lcore_set(service_id,
+					core_array[core_cnt], 1))
+				return -ENOENT;
+		return 0;
+	}
 	/* Get the core which has least number of services running. */
 	while (core_cnt--) {
 		/* Reset default mapping */
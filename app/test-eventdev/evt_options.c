@@ -57,6 +57,16 @@ evt_parse_nb_flows(struct evt_options *opt, const char *arg)
 	return ret;
 }
 
+static int
+evt_parse_nb_elephant_flows(struct evt_options *opt, const char *arg)
+{
+	int ret;
+
+	ret = parser_read_uint32(&(opt->nb_elephant_flows), arg);
+
+	return ret;
+}
+
 static int
 evt_parse_dev_id(struct evt_options *opt, const char *arg)
 {
@@ -311,6 +321,8 @@ usage(char *program)
 		"\t--wlcores          : list of lcore ids for workers\n"
 		"\t--stlist           : list of scheduled types of the stages\n"
 		"\t--nb_flows         : number of flows to produce\n"
+		"\t--nb_elephant_flows : number of flows carrying half of\n"
+		"\t                      the produced events.\n"
 		"\t--nb_pkts          : number of packets to produce\n"
 		"\t--worker_deq_depth : dequeue depth of the worker\n"
 		"\t--fwd_latency      : perform fwd_latency measurement\n"
@@ -381,6 +393,7 @@ evt_parse_sched_type_list(struct evt_options *opt, const char *arg)
 
 static struct option lgopts[] = {
 	{ EVT_NB_FLOWS,            1, 0, 0 },
+	{ EVT_NB_ELEPHANT_FLOWS,   1, 0, 0 },
 	{ EVT_DEVICE,              1, 0, 0 },
 	{ EVT_VERBOSE,             1, 0, 0 },
 	{ EVT_TEST,                1, 0, 0 },
@@ -419,6 +432,7 @@ evt_opts_parse_long(int opt_idx, struct evt_options *opt)
 
 	struct long_opt_parser parsermap[] = {
 		{ EVT_NB_FLOWS, evt_parse_nb_flows},
+		{ EVT_NB_ELEPHANT_FLOWS, evt_parse_nb_elephant_flows},
 		{ EVT_DEVICE, evt_parse_dev_id},
 		{ EVT_VERBOSE, evt_parse_verbose},
 		{ EVT_TEST, evt_parse_test_name},
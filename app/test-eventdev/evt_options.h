@@ -23,6 +23,7 @@
 #define EVT_PROD_LCORES          ("plcores")
 #define EVT_WORK_LCORES          ("wlcores")
 #define EVT_NB_FLOWS             ("nb_flows")
+#define EVT_NB_ELEPHANT_FLOWS    ("nb_elephant_flows")
 #define EVT_SOCKET_ID            ("socket_id")
 #define EVT_POOL_SZ              ("pool_sz")
 #define EVT_WKR_DEQ_DEP          ("worker_deq_depth")
@@ -184,6 +185,8 @@ static inline void
 evt_dump_nb_flows(struct evt_options *opt)
 {
 	evt_dump("nb_flows", "%d", opt->nb_flows);
+	if (opt->nb_elephant_flows)
+		evt_dump("nb_elephant_flows", "%d", opt->nb_elephant_flows);
 }
 
 static inline void
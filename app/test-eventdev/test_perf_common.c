@@ -27,6 +27,21 @@ perf_test_result(struct evt_test *test, struct evt_options *opt)
 	return t->result;
 }
 
+/* With elephant flows, every other event belongs to one of them, to
+ * produce a skewed flow distribution.
+ */
+static inline uint32_t
+perf_next_flow_id(uint32_t *flow_counter, uint32_t nb_flows,
+		  uint32_t nb_elephant_flows)
+{
+	uint32_t counter = (*flow_counter)++;
+
+	if (nb_elephant_flows > 0 && (counter & 1))
+		return (counter >> 1) % nb_elephant_flows;
+
+	return counter % nb_flows;
+}
+
 static inline int
 perf_producer(void *arg)
 {
@@ -39,6 +54,7 @@ perf_producer(void *arg)
 	struct rte_mempool *pool = t->pool;
 	const uint64_t nb_pkts = t->nb_pkts;
 	const uint32_t nb_flows = t->nb_flows;
+	const uint32_t nb_elephant_flows = t->nb_elephant_flows;
 	uint32_t flow_counter = 0;
 	uint64_t count = 0;
 	struct perf_elt *m[BURST_SIZE + 1] = {NULL};
@@ -60,7 +76,8 @@ perf_producer(void *arg)
 		if (rte_mempool_get_bulk(pool, (void **)m, BURST_SIZE) < 0)
 			continue;
 		for (i = 0; i < BURST_SIZE; i++) {
-			ev.flow_id = flow_counter++ % nb_flows;
+			ev.flow_id = perf_next_flow_id(&flow_counter, nb_flows,
+						       nb_elephant_flows);
 			ev.event_ptr = m[i];
 			m[i]->timestamp = rte_get_timer_cycles();
 			while (rte_event_enqueue_burst(dev_id,
@@ -595,6 +612,11 @@ perf_opt_check(struct evt_options *opt, uint64_t nb_queues)
 	if (evt_has_invalid_sched_type(opt))
 		return -1;
 
+	if (opt->nb_elephant_flows > opt->nb_flows) {
+		evt_err("number of elephant flows exceeds number of flows");
+		return -1;
+	}
+
 	if (nb_queues > EVT_MAX_QUEUES) {
 		evt_err("number of queues exceeds %d", EVT_MAX_QUEUES);
 		return -1;
@@ -823,6 +845,7 @@ perf_test_setup(struct evt_test *test, struct evt_options *opt)
 	t->nb_workers = evt_nr_active_lcores(opt->wlcores);
 	t->done = false;
 	t->nb_flows = opt->nb_flows;
+	t->nb_elephant_flows = opt->nb_elephant_flows;
 	t->result = EVT_TEST_FAILED;
 	t->opt = opt;
 	memcpy(t->sched_type_list, opt->sched_type_list,
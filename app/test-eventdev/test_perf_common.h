@@ -50,6 +50,7 @@ struct test_perf {
 	uint8_t nb_workers;
 	enum evt_test_result result;
 	uint32_t nb_flows;
+	uint32_t nb_elephant_flows;
 	uint64_t nb_pkts;
 	struct rte_mempool *pool;
 	struct prod_data prod[EVT_MAX_PORTS];
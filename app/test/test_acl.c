@@ -13,6 +13,7 @@
 #include <rte_ip.h>
 #include <rte_acl.h>
 #include <rte_common.h>
+#include <rte_random.h>
 
 #include "test_acl.h"
 
@@ -1716,6 +1717,386 @@ test_u32_range(void)
 	return rc;
 }
 
+#define	INC_TEST_RULES		256
+#define	INC_TEST_DATA		512
+#define	INC_TEST_ROUNDS		12
+#define	INC_TEST_CHURN		16
+#define	INC_TEST_CATEGORIES	4
+
+static void
+inc_gen_rule(struct acl_ipv4vlan_rule *r, uint32_t n)
+{
+	struct rte_acl_ipv4vlan_rule ri;
+	uint16_t lo, hi;
+
+	memset(&ri, 0, sizeof(ri));
+
+	/* each rule has a different priority, so that the results are unique */
+	ri.data.userdata = n + 1;
+	ri.data.priority = n + 1;
+	ri.data.category_mask = (rte_rand() & RTE_LEN2MASK(INC_TEST_CATEGORIES,
+		uint32_t)) | 1;
+
+	if (rte_rand() & 1) {
+		ri.proto = (rte_rand() & 1) ? IPPROTO_TCP : IPPROTO_UDP;
+		ri.proto_mask = UINT8_MAX;
+	}
+
+	/* keep the addresses and ports in small ranges to get overlaps */
+	ri.src_addr = RTE_IPV4(10, 0, rte_rand() & 3, rte_rand() & 7);
+	ri.src_mask_len = 24 + rte_rand() % 9;
+	ri.dst_addr = RTE_IPV4(192, 168, 0, rte_rand() & 7);
+	ri.dst_mask_len = 28 + rte_rand() % 5;
+
+	lo = rte_rand() & 15;
+	hi = lo + (rte_rand() & 15);
+	ri.src_port_low = lo;
+	ri.src_port_high = hi;
+	lo = rte_rand() & 15;
+	hi = lo + (rte_rand() & 15);
+	ri.dst_port_low = lo;
+	ri.dst_port_high = hi;
+
+	convert_rule(&ri, r);
+}
+
+static void
+inc_gen_data(struct ipv4_7tuple *data, uint32_t num)
+{
+	uint32_t i;
+
+	memset(data, 0, num * sizeof(data[0]));
+	for (i = 0; i != num; i++) {
+		data[i].proto = (rte_rand() & 1) ? IPPROTO_TCP : IPPROTO_UDP;
+		data[i].ip_src = RTE_IPV4(10, 0, rte_rand() & 3, rte_rand() & 7);
+		data[i].ip_dst = RTE_IPV4(192, 168, 0, rte_rand() & 7);
+		data[i].port_src = rte_rand() & 31;
+		data[i].port_dst = rte_rand() & 31;
+	}
+	bswap_test_data(data, num, 1);
+}
+
+/*
+ * Compare the results of an incremental context with the ones of
+ * a context built from all its live rules.
+ */
+static int
+inc_check(struct rte_acl_inc *ictx, const struct acl_ipv4vlan_rule *rules,
+	const uint8_t *live, const uint8_t **data)
+{
+	static uint32_t res[INC_TEST_DATA * INC_TEST_CATEGORIES];
+	static uint32_t ref[INC_TEST_DATA * INC_TEST_CATEGORIES];
+	struct rte_acl_param prm;
+	struct rte_acl_ctx *acx;
+	uint32_t i, n;
+	int32_t rc;
+
+	prm = acl_param;
+	prm.name = "acl_inc_ref";
+	prm.max_rule_num = INC_TEST_RULES;
+
+	acx = rte_acl_create(&prm);
+	if (acx == NULL) {
+		printf("%s#%i: Error creating ACL context!\n",
+			__func__, __LINE__);
+		return -1;
+	}
+
+	for (i = 0, n = 0; i != INC_TEST_RULES; i++) {
+		if (live[i] == 0)
+			continue;
+		n++;
+		rc = rte_acl_add_rules(acx,
+			(const struct rte_acl_rule *)&rules[i], 1);
+		if (rc != 0) {
+			printf("%s#%i: Adding rule to ACL context "
+				"failed with error code: %d\n",
+				__func__, __LINE__, rc);
+			rte_acl_free(acx);
+			return rc;
+		}
+	}
+
+	/* an empty context can't be built, and matches nothing */
+	memset(ref, 0, sizeof(ref));
+	rc = 0;
+	if (n != 0) {
+		rc = build_convert_rules(acx, convert_config, 0);
+		if (rc == 0)
+			rc = rte_acl_classify(acx, data, ref, INC_TEST_DATA,
+				INC_TEST_CATEGORIES);
+	}
+	rte_acl_free(acx);
+	if (rc != 0) {
+		printf("%s#%i: Error building reference ACL context: %d\n",
+			__func__, __LINE__, rc);
+		return rc;
+	}
+
+	rc = rte_acl_inc_classify(ictx, data, res, INC_TEST_DATA,
+		INC_TEST_CATEGORIES);
+	if (rc != 0) {
+		printf("%s#%i: rte_acl_inc_classify failed: %d\n",
+			__func__, __LINE__, rc);
+		return rc;
+	}
+
+	for (i = 0; i != RTE_DIM(res); i++) {
+		if (res[i] != ref[i]) {
+			printf("%s#%i: result %u of data %u is %u, "
+				"expected %u\n", __func__, __LINE__,
+				i % INC_TEST_CATEGORIES,
+				i / INC_TEST_CATEGORIES, res[i], ref[i]);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Test incremental rule updates: add and delete random rules, with and
+ * without merges, and check that the incremental context always gives
+ * the same results as a context built from scratch.
+ */
+static int
+test_incremental(void)
+{
+	static struct acl_ipv4vlan_rule rules[INC_TEST_RULES];
+	static struct ipv4_7tuple test_data[INC_TEST_DATA];
+	const uint8_t *data[INC_TEST_DATA];
+	uint8_t live[INC_TEST_RULES];
+	uint32_t del[INC_TEST_CHURN];
+	struct rte_acl_inc_param prm;
+	struct rte_acl_inc_stats st;
+	struct rte_acl_config cfg;
+	struct rte_acl_inc *ictx;
+	uint32_t i, k, n, r;
+	int32_t rc;
+
+	for (i = 0; i != INC_TEST_RULES; i++)
+		inc_gen_rule(&rules[i], i);
+	inc_gen_data(test_data, INC_TEST_DATA);
+	for (i = 0; i != INC_TEST_DATA; i++)
+		data[i] = (const uint8_t *)&test_data[i];
+
+	memset(&cfg, 0, sizeof(cfg));
+	convert_config(&cfg);
+
+	prm.name = "acl_inc";
+	prm.socket_id = SOCKET_ID_ANY;
+	prm.rule_size = RTE_ACL_IPV4VLAN_RULE_SZ;
+	prm.max_rule_num = INC_TEST_RULES;
+	prm.cfg = &cfg;
+
+	ictx = rte_acl_inc_create(&prm);
+	if (ictx == NULL) {
+		printf("%s#%i: Error creating incremental ACL context!\n",
+			__func__, __LINE__);
+		return -1;
+	}
+
+	/* start with half the rules */
+	memset(live, 0, sizeof(live));
+	n = INC_TEST_RULES / 2;
+	rc = rte_acl_inc_add_rules(ictx, (const struct rte_acl_rule *)rules,
+		n);
+	for (i = 0; i != n; i++)
+		live[i] = 1;
+
+	/* rules are only used after the first merge */
+	if (rc == 0)
+		rc = rte_acl_inc_merge(ictx);
+	if (rc == 0)
+		rc = inc_check(ictx, rules, live, data);
+	if (rc != 0)
+		goto out;
+
+	/* invalid updates */
+	if (rte_acl_inc_add_rules(ictx,
+			(const struct rte_acl_rule *)rules, 1) != -EEXIST) {
+		printf("%s#%i: Adding a duplicate rule should fail!\n",
+			__func__, __LINE__);
+		rc = -1;
+		goto out;
+	}
+	del[0] = INC_TEST_RULES + 1;
+	if (rte_acl_inc_del_rules(ictx, del, 1) != -ENOENT) {
+		printf("%s#%i: Deleting an unknown rule should fail!\n",
+			__func__, __LINE__);
+		rc = -1;
+		goto out;
+	}
+
+	for (r = 0; r != INC_TEST_ROUNDS && rc == 0; r++) {
+
+		/* delete random live rules */
+		for (k = 0; k != INC_TEST_CHURN; k++) {
+			do {
+				i = rte_rand() % INC_TEST_RULES;
+			} while (live[i] == 0);
+			live[i] = 0;
+			del[k] = rules[i].data.userdata;
+		}
+		rc = rte_acl_inc_del_rules(ictx, del, INC_TEST_CHURN);
+		if (rc == 0)
+			rc = inc_check(ictx, rules, live, data);
+		if (rc != 0)
+			break;
+
+		/* add random rules not in the context */
+		for (k = 0; k != INC_TEST_CHURN && rc == 0; k++) {
+			i = rte_rand() % INC_TEST_RULES;
+			while (live[i] != 0)
+				i = (i + 1) % INC_TEST_RULES;
+			live[i] = 1;
+			rc = rte_acl_inc_add_rules(ictx,
+				(const struct rte_acl_rule *)&rules[i], 1);
+		}
+		if (rc == 0)
+			rc = inc_check(ictx, rules, live, data);
+
+		if (rc == 0 && (r % 3) == 2) {
+			rc = rte_acl_inc_merge(ictx);
+			if (rc == 0)
+				rc = inc_check(ictx, rules, live, data);
+		}
+	}
+
+	if (rc != 0) {
+		printf("%s#%i: incremental update test failed at round %u: "
+			"%d\n", __func__, __LINE__, r, rc);
+		goto out;
+	}
+
+	rc = rte_acl_inc_merge(ictx);
+	if (rc == 0)
+		rc = rte_acl_inc_get_stats(ictx, &st);
+	if (rc == 0) {
+		for (i = 0, n = 0; i != INC_TEST_RULES; i++)
+			n += live[i];
+		if (st.main_rules != n || st.delta_rules != 0 ||
+				st.deleted_rules != 0) {
+			printf("%s#%i: unexpected stats after merge: "
+				"main %u, delta %u, deleted %u\n",
+				__func__, __LINE__, st.main_rules,
+				st.delta_rules, st.deleted_rules);
+			rc = -1;
+		}
+	}
+	if (rc == 0)
+		rc = inc_check(ictx, rules, live, data);
+
+out:
+	rte_acl_inc_free(ictx);
+	return rc;
+}
+
+#define	PAR_TEST_RULES		2048
+#define	PAR_TEST_DATA		1024
+#define	PAR_TEST_THREADS	4
+
+/*
+ * Test parallel build: random rules with wide ranges get split into
+ * several tries, check that a context built with several threads gives
+ * the same results as a context built with rte_acl_build().
+ */
+static int
+test_build_parallel(void)
+{
+	static struct ipv4_7tuple test_data[PAR_TEST_DATA];
+	static uint32_t res[2][PAR_TEST_DATA * RTE_ACL_MAX_CATEGORIES];
+	const uint8_t *data[PAR_TEST_DATA];
+	struct rte_acl_ipv4vlan_rule ri;
+	struct acl_ipv4vlan_rule r;
+	struct rte_acl_ctx *acx[2];
+	struct rte_acl_param prm;
+	struct rte_acl_config cfg;
+	uint16_t a, b;
+	uint32_t i, k;
+	int32_t rc;
+
+	prm = acl_param;
+	prm.max_rule_num = PAR_TEST_RULES;
+
+	prm.name = "acl_seq";
+	acx[0] = rte_acl_create(&prm);
+	prm.name = "acl_par";
+	acx[1] = rte_acl_create(&prm);
+	if (acx[0] == NULL || acx[1] == NULL) {
+		printf("%s#%i: Error creating ACL context!\n",
+			__func__, __LINE__);
+		rte_acl_free(acx[0]);
+		rte_acl_free(acx[1]);
+		return -1;
+	}
+
+	rc = 0;
+	for (i = 0; i != PAR_TEST_RULES && rc == 0; i++) {
+		memset(&ri, 0, sizeof(ri));
+		ri.data.userdata = i + 1;
+		ri.data.priority = i + 1;
+		ri.data.category_mask = RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES,
+			uint32_t);
+		ri.src_addr = rte_rand();
+		ri.src_mask_len = rte_rand() % (BIT_SIZEOF(ri.src_addr) + 1);
+		ri.dst_addr = rte_rand();
+		ri.dst_mask_len = rte_rand() % (BIT_SIZEOF(ri.dst_addr) + 1);
+		a = rte_rand();
+		b = rte_rand();
+		ri.src_port_low = RTE_MIN(a, b);
+		ri.src_port_high = RTE_MAX(a, b);
+		a = rte_rand();
+		b = rte_rand();
+		ri.dst_port_low = RTE_MIN(a, b);
+		ri.dst_port_high = RTE_MAX(a, b);
+		convert_rule(&ri, &r);
+
+		for (k = 0; k != RTE_DIM(acx) && rc == 0; k++)
+			rc = rte_acl_add_rules(acx[k],
+				(const struct rte_acl_rule *)&r, 1);
+	}
+
+	memset(&cfg, 0, sizeof(cfg));
+	convert_config(&cfg);
+
+	if (rc == 0)
+		rc = rte_acl_build(acx[0], &cfg);
+	if (rc == 0)
+		rc = rte_acl_build_parallel(acx[1], &cfg, PAR_TEST_THREADS);
+	if (rc != 0) {
+		printf("%s#%i: Error building ACL context: %d\n",
+			__func__, __LINE__, rc);
+		goto out;
+	}
+
+	for (i = 0; i != PAR_TEST_DATA; i++) {
+		test_data[i].ip_src = rte_rand();
+		test_data[i].ip_dst = rte_rand();
+		test_data[i].port_src = rte_rand();
+		test_data[i].port_dst = rte_rand();
+		data[i] = (const uint8_t *)&test_data[i];
+	}
+
+	for (k = 0; k != RTE_DIM(acx); k++)
+		rte_acl_classify(acx[k], data, res[k], PAR_TEST_DATA,
+			RTE_ACL_MAX_CATEGORIES);
+
+	for (i = 0; i != RTE_DIM(res[0]); i++) {
+		if (res[0][i] != res[1][i]) {
+			printf("%s#%i: result %u differs: %u, expected %u\n",
+				__func__, __LINE__, i, res[1][i], res[0][i]);
+			rc = -1;
+			break;
+		}
+	}
+
+out:
+	rte_acl_free(acx[0]);
+	rte_acl_free(acx[1]);
+	return rc;
+}
+
 static int
 test_acl(void)
 {
@@ -1737,6 +2118,10 @@ test_acl(void)
 		return -1;
 	if (test_u32_range() < 0)
 		return -1;
+	if (test_incremental() < 0)
+		return -1;
+	if (test_build_parallel() < 0)
+		return -1;
 
 	return 0;
 }
@@ -8,6 +8,7 @@
 #include <inttypes.h>
 
 #include <rte_memory.h>
+#include <rte_malloc.h>
 #include <rte_debug.h>
 #include <rte_hexdump.h>
 #include <rte_random.h>
@@ -16,6 +17,11 @@
 #include <rte_bpf.h>
 #include <rte_ether.h>
 #include <rte_ip.h>
+#include <rte_tcp.h>
+
+#ifdef RTE_PORT_PCAP
+#include <pcap/pcap.h>
+#endif
 
 #include "test.h"
 
@@ -3216,6 +3222,182 @@ run_test(const struct bpf_test *tst)
 
 }
 
+#ifdef RTE_PORT_PCAP
+
+/*
+ * Classic BPF filters compiled by libpcap, converted with rte_bpf_convert()
+ * and run on a TCP SYN packet split over two segments.
+ */
+
+static const struct {
+	const char *expr;
+	uint64_t match;
+} test_filters[] = {
+	{ "tcp", 1 },
+	{ "udp", 0 },
+	{ "ip6", 0 },
+	{ "vlan", 0 },
+	{ "host 10.0.0.1", 1 },
+	{ "src host 10.0.0.2", 0 },
+	{ "tcp dst port 80", 1 },
+	{ "tcp src port 80", 0 },
+	{ "ip src 10.0.0.1 and tcp dst port 80", 1 },
+	{ "tcp[tcpflags] & tcp-syn != 0", 1 },
+	{ "tcp[tcpflags] & tcp-ack != 0", 0 },
+	{ "ether[0] & 1 != 0", 0 },
+	{ "len >= 100", 1 },
+	{ "greater 1000", 0 },
+	{ "ip[8] = 64 or ip[8] = 128", 1 },
+	{ "ip[2:2] / 4 = 25", 1 },
+	{ "not net 10.0.0.0/8", 0 },
+};
+
+static void
+test_filter_prepare(struct dummy_mbuf *dm)
+{
+	struct rte_ether_hdr *eh;
+	struct rte_ipv4_hdr *ih;
+	struct rte_tcp_hdr *th;
+	uint8_t pkt[sizeof(dm->buf[0])];
+	uint8_t *p;
+
+	const uint32_t plen = 100;
+	const uint32_t seg = sizeof(*eh) + sizeof(*ih) + 3;
+
+	memset(pkt, 0, sizeof(pkt));
+	eh = (struct rte_ether_hdr *)pkt;
+	ih = (struct rte_ipv4_hdr *)(eh + 1);
+	th = (struct rte_tcp_hdr *)(ih + 1);
+
+	eh->d_addr.addr_bytes[5] = 2;
+	eh->s_addr.addr_bytes[5] = 1;
+	eh->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+	ih->version_ihl = RTE_IPV4_VHL_DEF;
+	ih->total_length = rte_cpu_to_be_16(plen);
+	ih->time_to_live = 64;
+	ih->next_proto_id = IPPROTO_TCP;
+	ih->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+	ih->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 2));
+	th->src_port = rte_cpu_to_be_16(1234);
+	th->dst_port = rte_cpu_to_be_16(80);
+	th->data_off = sizeof(*th) << 2;
+	th->tcp_flags = RTE_TCP_SYN_FLAG;
+
+	memset(dm, 0, sizeof(*dm));
+	dummy_mbuf_prep(&dm->mb[0], dm->buf[0], sizeof(dm->buf[0]), seg);
+	dummy_mbuf_prep(&dm->mb[1], dm->buf[1], sizeof(dm->buf[1]),
+		sizeof(*eh) + plen - seg);
+	rte_pktmbuf_chain(&dm->mb[0], &dm->mb[1]);
+
+	p = rte_pktmbuf_mtod(&dm->mb[0], uint8_t *);
+	memcpy(p, pkt, seg);
+	p = rte_pktmbuf_mtod(&dm->mb[1], uint8_t *);
+	memcpy(p, pkt + seg, sizeof(*eh) + plen - seg);
+}
+
+static int
+test_filter(const char *expr, uint64_t match, struct dummy_mbuf *dm)
+{
+	struct bpf_program fcode;
+	struct rte_bpf_prm *prm;
+	struct rte_bpf_jit jit;
+	struct rte_bpf *bpf;
+	pcap_t *pcap;
+	uint64_t rc;
+	int ret = 0;
+
+	pcap = pcap_open_dead(DLT_EN10MB, 65535);
+	if (pcap == NULL) {
+		printf("%s@%d: pcap_open_dead failed\n", __func__, __LINE__);
+		return -1;
+	}
+
+	if (pcap_compile(pcap, &fcode, expr, 1, PCAP_NETMASK_UNKNOWN) != 0) {
+		printf("%s@%d: pcap_compile(\"%s\") failed: %s\n",
+			__func__, __LINE__, expr, pcap_geterr(pcap));
+		pcap_close(pcap);
+		return -1;
+	}
+
+	prm = rte_bpf_convert(&fcode);
+	pcap_freecode(&fcode);
+	pcap_close(pcap);
+	if (prm == NULL) {
+		printf("%s@%d: rte_bpf_convert(\"%s\") failed, error=%d(%s);\n",
+			__func__, __LINE__, expr, rte_errno,
+			strerror(rte_errno));
+		return -1;
+	}
+
+	bpf = rte_bpf_load(prm);
+	rte_free(prm);
+	if (bpf == NULL) {
+		printf("%s@%d: failed to load \"%s\", error=%d(%s);\n",
+			__func__, __LINE__, expr, rte_errno,
+			strerror(rte_errno));
+		return -1;
+	}
+
+	test_filter_prepare(dm);
+	rc = rte_bpf_exec(bpf, dm->mb);
+	if ((rc != 0) != match) {
+		printf("%s@%d: \"%s\" returned %#" PRIx64 ", expected %s;\n",
+			__func__, __LINE__, expr, rc,
+			match ? "a match" : "no match");
+		ret = -1;
+	}
+
+	rte_bpf_get_jit(bpf, &jit);
+	if (jit.func != NULL) {
+		rc = jit.func(dm->mb);
+		if ((rc != 0) != match) {
+			printf("%s@%d: \"%s\" jit returned %#" PRIx64
+				", expected %s;\n", __func__, __LINE__, expr,
+				rc, match ? "a match" : "no match");
+			ret = -1;
+		}
+	}
+
+	rte_bpf_destroy(bpf);
+	return ret;
+}
+
+static int
+test_bpf_filters(void)
+{
+	struct dummy_mbuf *dm;
+	uint32_t i;
+	int ret = 0;
+
+	/* mbuf as input argument is not supported on 32 bit platform */
+	if (sizeof(uint64_t) != sizeof(uintptr_t))
+		return 0;
+
+	dm = rte_zmalloc(NULL, sizeof(*dm), 0);
+	if (dm == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i != RTE_DIM(test_filters); i++) {
+		printf("%s(\"%s\") start\n", __func__, test_filters[i].expr);
+		ret |= test_filter(test_filters[i].expr, test_filters[i].match,
+			dm);
+	}
+
+	rte_free(dm);
+	return ret;
+}
+
+#else
+
+static int
+test_bpf_filters(void)
+{
+	printf("no libpcap, skipping classic BPF conversion tests\n");
+	return 0;
+}
+
+#endif /* RTE_PORT_PCAP */
+
 static int
 test_bpf(void)
 {
@@ -3229,6 +3411,8 @@ test_bpf(void)
 			rc |= rv;
 	}
 
+	rc |= test_bpf_filters();
+
 	return rc;
 }
 
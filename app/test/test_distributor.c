@@ -813,7 +813,11 @@ test_distributor(void)
 {
 	static struct rte_distributor *ds;
 	static struct rte_distributor *db;
-	static struct rte_distributor *dist[2];
+	static struct rte_distributor *dsticky;
+	static struct rte_distributor *dist[3];
+	static const char * const dist_names[3] = {
+		"single", "burst", "burst sticky"
+	};
 	static struct rte_mempool *p;
 	int i;
 
@@ -847,6 +851,20 @@ test_distributor(void)
 		rte_distributor_clear_returns(db);
 	}
 
+	if (dsticky == NULL) {
+		dsticky = rte_distributor_create("Test_dist_sticky",
+				rte_socket_id(),
+				rte_lcore_count() - 1,
+				RTE_DIST_ALG_BURST_STICKY);
+		if (dsticky == NULL) {
+			printf("Error creating burst sticky distributor\n");
+			return -1;
+		}
+	} else {
+		rte_distributor_flush(dsticky);
+		rte_distributor_clear_returns(dsticky);
+	}
+
 	if (ds == NULL) {
 		ds = rte_distributor_create("Test_dist_single",
 				rte_socket_id(),
@@ -874,16 +892,13 @@ test_distributor(void)
 
 	dist[0] = ds;
 	dist[1] = db;
+	dist[2] = dsticky;
 
-	for (i = 0; i < 2; i++) {
+	for (i = 0; i < 3; i++) {
 
 		worker_params.dist = dist[i];
-		if (i)
-			strlcpy(worker_params.name, "burst",
-					sizeof(worker_params.name));
-		else
-			strlcpy(worker_params.name, "single",
-					sizeof(worker_params.name));
+		strlcpy(worker_params.name, dist_names[i],
+				sizeof(worker_params.name));
 
 		rte_eal_mp_remote_launch(handle_work,
 				&worker_params, SKIP_MAIN);
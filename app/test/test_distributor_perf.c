@@ -12,6 +12,7 @@
 #include <rte_mbuf.h>
 #include <rte_distributor.h>
 #include <rte_pause.h>
+#include <rte_vect.h>
 
 #define ITER_POWER_CL 25 /* log 2 of how many iterations  for Cache Line test */
 #define ITER_POWER 21 /* log 2 of how many iterations we do when timing. */
@@ -202,12 +203,29 @@ quit_workers(struct rte_distributor *d, struct rte_mempool *p)
 	worker_idx = 0;
 }
 
+/*
+ * Burst mode flow matching, the only difference between these distributors,
+ * is chosen at creation time, according to the max SIMD bitwidth.
+ */
+static const struct {
+	uint16_t bitwidth;
+	const char *name;
+} perf_burst_modes[] = {
+	{ RTE_VECT_SIMD_128, "burst mode, 128-bit SIMD" },
+	{ RTE_VECT_SIMD_256, "burst mode, 256-bit SIMD" },
+	{ RTE_VECT_SIMD_512, "burst mode, 512-bit SIMD" },
+};
+
 static int
 test_distributor_perf(void)
 {
 	static struct rte_distributor *ds;
-	static struct rte_distributor *db;
+	static struct rte_distributor *db[RTE_DIM(perf_burst_modes)];
+	static struct rte_distributor *dsticky;
 	static struct rte_mempool *p;
+	char name[32];
+	uint16_t bitwidth;
+	unsigned int i;
 
 	if (rte_lcore_count() < 2) {
 		printf("Not enough cores for distributor_perf_autotest, expecting at least 2\n");
@@ -229,16 +247,37 @@ test_distributor_perf(void)
 		rte_distributor_clear_returns(ds);
 	}
 
-	if (db == NULL) {
-		db = rte_distributor_create("Test_burst", rte_socket_id(),
+	bitwidth = rte_vect_get_max_simd_bitwidth();
+	for (i = 0; i < RTE_DIM(perf_burst_modes); i++) {
+		if (db[i] != NULL) {
+			rte_distributor_clear_returns(db[i]);
+			continue;
+		}
+		/* fails if forced with --force-max-simd-bitwidth */
+		rte_vect_set_max_simd_bitwidth(perf_burst_modes[i].bitwidth);
+		snprintf(name, sizeof(name), "Test_burst_%u",
+				perf_burst_modes[i].bitwidth);
+		db[i] = rte_distributor_create(name, rte_socket_id(),
 				rte_lcore_count() - 1,
 				RTE_DIST_ALG_BURST);
-		if (db == NULL) {
+		rte_vect_set_max_simd_bitwidth(bitwidth);
+		if (db[i] == NULL) {
 			printf("Error creating burst distributor\n");
 			return -1;
 		}
+	}
+
+	if (dsticky == NULL) {
+		dsticky = rte_distributor_create("Test_burst_sticky",
+				rte_socket_id(),
+				rte_lcore_count() - 1,
+				RTE_DIST_ALG_BURST_STICKY);
+		if (dsticky == NULL) {
+			printf("Error creating burst sticky distributor\n");
+			return -1;
+		}
 	} else {
-		rte_distributor_clear_returns(db);
+		rte_distributor_clear_returns(dsticky);
 	}
 
 	const unsigned nb_bufs = (511 * rte_lcore_count()) < BIG_BATCH ?
@@ -258,11 +297,20 @@ test_distributor_perf(void)
 		return -1;
 	quit_workers(ds, p);
 
-	printf("=== Performance test of distributor (burst mode) ===\n");
-	rte_eal_mp_remote_launch(handle_work, db, SKIP_MAIN);
-	if (perf_test(db, p) < 0)
+	for (i = 0; i < RTE_DIM(perf_burst_modes); i++) {
+		printf("=== Performance test of distributor (%s) ===\n",
+				perf_burst_modes[i].name);
+		rte_eal_mp_remote_launch(handle_work, db[i], SKIP_MAIN);
+		if (perf_test(db[i], p) < 0)
+			return -1;
+		quit_workers(db[i], p);
+	}
+
+	printf("=== Performance test of distributor (burst sticky mode) ===\n");
+	rte_eal_mp_remote_launch(handle_work, dsticky, SKIP_MAIN);
+	if (perf_test(dsticky, p) < 0)
 		return -1;
-	quit_workers(db, p);
+	quit_workers(dsticky, p);
 
 	return 0;
 }
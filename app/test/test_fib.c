@@ -9,6 +9,9 @@
 
 #include <rte_ip.h>
 #include <rte_log.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_malloc.h>
 #include <rte_fib.h>
 
 #include "test.h"
@@ -21,6 +24,9 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_invalid_rcu(void);
+static int32_t test_fib_rcu_dq_reclaim(void);
+static int32_t test_fib_rcu_sync_rw(void);
 
 #define MAX_ROUTES	(1 << 16)
 #define MAX_TBL8	(1 << 15)
@@ -371,6 +377,339 @@ test_lookup(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * rte_fib_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to FIB
+ *  - Add another RCU QSBR variable to FIB
+ *  - Check returns
+ */
+int32_t
+test_invalid_rcu(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr *qsv2;
+	int32_t status;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	uint64_t def_nh = 100;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+
+	/* adding rcu to RTE_FIB_DUMMY FIB type */
+	config.type = RTE_FIB_DUMMY;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == -ENOTSUP,
+		"rte_fib_rcu_qsbr_add returned wrong error status\n");
+	rte_fib_free(fib);
+
+	/* Invalid QSBR mode */
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	rcu_cfg.mode = 2;
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status != 0, "Failed to add RCU\n");
+
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_DQ;
+
+	/* Attach RCU QSBR to FIB to check for double attach */
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Create and attach another RCU QSBR to FIB table */
+	qsv2 = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv2 != NULL, "Can not allocate memory for RCU\n");
+
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_SYNC;
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status != 0, "Secondary RCU was mistakenly attached\n");
+
+	rte_fib_free(fib);
+	rte_free(qsv);
+	rte_free(qsv2);
+
+	return TEST_SUCCESS;
+}
+
+#define RCU_DQ_NUM_TBL8		64
+
+/*
+ * rte_fib_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Create FIB whose tbl8 groups are all in use
+ *  - Add RCU QSBR variable to FIB
+ *  - Register a reader thread (not a real thread)
+ *  - Writer delete a route with depth > 24
+ *  - Reader lookup the route
+ *  - Writer re-add the route (no available tbl8 group)
+ *  - Reader report quiescent state
+ *  - Writer re-add the route
+ *  - Reader lookup the route
+ */
+int32_t
+test_fib_rcu_dq_reclaim(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint64_t def_nh = 100;
+	uint64_t next_hop = 1;
+	uint64_t nh_ret;
+	uint32_t ip;
+	uint8_t depth = 28;
+	size_t sz;
+	int32_t status;
+	unsigned int i;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = RCU_DQ_NUM_TBL8;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+		RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Can not allocate memory for RCU\n");
+
+	status = rte_rcu_qsbr_init(qsv, 1);
+	RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_DQ;
+	status = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+	/* Use up all the tbl8 groups */
+	for (i = 0; i < RCU_DQ_NUM_TBL8; i++) {
+		ip = RTE_IPV4(192, 0, i, 100);
+		status = rte_fib_add(fib, ip, depth, next_hop);
+		RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+	}
+	ip = RTE_IPV4(192, 0, 0, 100);
+
+	/* Register pseudo reader */
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "Can not register reader\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	status = rte_fib_lookup_bulk(fib, &ip, &nh_ret, 1);
+	RTE_TEST_ASSERT((status == 0) && (nh_ret == next_hop),
+		"Failed to get proper nexthop\n");
+
+	/* Writer update */
+	status = rte_fib_delete(fib, ip, depth);
+	RTE_TEST_ASSERT(status == 0, "Failed to delete a route\n");
+
+	status = rte_fib_lookup_bulk(fib, &ip, &nh_ret, 1);
+	RTE_TEST_ASSERT((status == 0) && (nh_ret == def_nh),
+		"Failed to get proper nexthop\n");
+
+	/* tbl8 group is still in the defer queue */
+	status = rte_fib_add(fib, ip, depth, next_hop);
+	RTE_TEST_ASSERT(status != 0,
+		"Route was added while tbl8 group was not reclaimed\n");
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	status = rte_fib_add(fib, ip, depth, next_hop);
+	RTE_TEST_ASSERT(status == 0, "Failed to add a route\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	status = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	RTE_TEST_ASSERT(status == 0, "Can not unregister reader\n");
+
+	status = rte_fib_lookup_bulk(fib, &ip, &nh_ret, 1);
+	RTE_TEST_ASSERT((status == 0) && (nh_ret == next_hop),
+		"Failed to get proper nexthop\n");
+
+	rte_fib_free(fib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+static struct rte_fib *g_fib;
+static struct rte_rcu_qsbr *g_v;
+static uint32_t g_ip = RTE_IPV4(192, 0, 2, 100);
+static volatile uint8_t writer_done;
+static volatile uint8_t reader_failed;
+/* Report quiescent state interval every 1024 lookups. Larger critical
+ * sections in reader will result in writer polling multiple times.
+ */
+#define QSBR_REPORTING_INTERVAL 1024
+#define WRITER_ITERATIONS	512
+#define RCU_TEST_DEF_NH		100
+#define RCU_TEST_NH		1
+
+/*
+ * Reader thread using rte_fib data structure with RCU.
+ * The looked up next hop must always be either the route's one
+ * or the default one, never the contents of a freed tbl8 group.
+ */
+static int
+test_fib_rcu_qsbr_reader(void *arg)
+{
+	int i;
+	uint64_t next_hop_return = 0;
+
+	RTE_SET_USED(arg);
+	/* Register this thread to report quiescent state */
+	rte_rcu_qsbr_thread_register(g_v, 0);
+	rte_rcu_qsbr_thread_online(g_v, 0);
+
+	do {
+		for (i = 0; i < QSBR_REPORTING_INTERVAL; i++) {
+			rte_fib_lookup_bulk(g_fib, &g_ip, &next_hop_return, 1);
+			if ((next_hop_return != RCU_TEST_NH) &&
+					(next_hop_return != RCU_TEST_DEF_NH))
+				reader_failed = 1;
+		}
+
+		/* Update quiescent state */
+		rte_rcu_qsbr_quiescent(g_v, 0);
+	} while (!writer_done);
+
+	rte_rcu_qsbr_thread_offline(g_v, 0);
+	rte_rcu_qsbr_thread_unregister(g_v, 0);
+
+	return 0;
+}
+
+/*
+ * rte_fib_rcu_qsbr_add functional test with a real reader.
+ * 1 Reader and 1 writer. They cannot be in the same thread in this test.
+ *  - Create FIB with the minimal number of tbl8 groups
+ *  - Add RCU QSBR variable to FIB in both SYNC and DQ modes
+ *  - Register a reader thread. Reader keeps looking up a specific route.
+ *  - Writer keeps adding and deleting a specific route with depth=28 (> 24)
+ */
+int32_t
+test_fib_rcu_sync_rw(void)
+{
+	struct rte_fib_conf config;
+	size_t sz;
+	int32_t status = 0;
+	uint32_t i, m;
+	uint8_t depth;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	enum rte_fib_qsbr_mode modes[] = {
+		RTE_FIB_QSBR_MODE_SYNC,
+		RTE_FIB_QSBR_MODE_DQ,
+	};
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for %s, expecting at least 2\n",
+			__func__);
+		return TEST_SKIPPED;
+	}
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = RCU_TEST_DEF_NH;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = 1;
+
+	for (m = 0; m < RTE_DIM(modes); m++) {
+		g_fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(g_fib != NULL, "Failed to create FIB\n");
+
+		/* Create RCU QSBR variable */
+		sz = rte_rcu_qsbr_get_memsize(1);
+		g_v = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+			RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+		RTE_TEST_ASSERT(g_v != NULL,
+			"Can not allocate memory for RCU\n");
+
+		status = rte_rcu_qsbr_init(g_v, 1);
+		RTE_TEST_ASSERT(status == 0, "Can not initialize RCU\n");
+
+		rcu_cfg.v = g_v;
+		rcu_cfg.mode = modes[m];
+		/* Attach RCU QSBR to FIB table */
+		status = rte_fib_rcu_qsbr_add(g_fib, &rcu_cfg);
+		RTE_TEST_ASSERT(status == 0, "Can not attach RCU to FIB\n");
+
+		writer_done = 0;
+		reader_failed = 0;
+		/* Launch reader thread */
+		rte_eal_remote_launch(test_fib_rcu_qsbr_reader, NULL,
+			rte_get_next_lcore(-1, 1, 0));
+
+		depth = 28;
+		status = rte_fib_add(g_fib, g_ip, depth, RCU_TEST_NH);
+		if (status != 0) {
+			printf("%s: Failed to add route\n", __func__);
+			goto error;
+		}
+
+		/* Writer update */
+		for (i = 0; i < WRITER_ITERATIONS; i++) {
+			status = rte_fib_delete(g_fib, g_ip, depth);
+			if (status != 0) {
+				printf("%s: Failed to delete route at iteration %d\n",
+					__func__, i);
+				goto error;
+			}
+
+			/*
+			 * In DQ mode the only tbl8 group may still wait in
+			 * the defer queue for the reader to go quiescent.
+			 */
+			do {
+				status = rte_fib_add(g_fib, g_ip, depth,
+					RCU_TEST_NH);
+			} while ((status == -ENOSPC) &&
+					(modes[m] == RTE_FIB_QSBR_MODE_DQ));
+			if (status != 0) {
+				printf("%s: Failed to add route at iteration %d\n",
+					__func__, i);
+				goto error;
+			}
+		}
+
+error:
+		writer_done = 1;
+		/* Wait until reader exited. */
+		rte_eal_mp_wait_lcore();
+
+		rte_fib_free(g_fib);
+		rte_free(g_v);
+
+		RTE_TEST_ASSERT(status == 0, "FIB update failed\n");
+		RTE_TEST_ASSERT(reader_failed == 0,
+			"Reader got next hop from a freed tbl8 group\n");
+	}
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite fib_fast_tests = {
 	.suite_name = "fib autotest",
 	.setup = NULL,
@@ -381,6 +720,9 @@ static struct unit_test_suite fib_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_invalid_rcu),
+	TEST_CASE(test_fib_rcu_dq_reclaim),
+	TEST_CASE(test_fib_rcu_sync_rw),
 	TEST_CASES_END()
 	}
 };
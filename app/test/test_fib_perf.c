@@ -11,6 +11,7 @@
 #include <rte_cycles.h>
 #include <rte_random.h>
 #include <rte_branch_prediction.h>
+#include <rte_malloc.h>
 #include <rte_ip.h>
 #include <rte_fib.h>
 
@@ -25,9 +26,15 @@
 } while (0)
 
 #define ITERATIONS (1 << 10)
+#define RCU_ITERATIONS 10
 #define BATCH_SIZE (1 << 12)
 #define BULK_SIZE 32
 
+/* Report quiescent state interval every 1024 lookups. Larger critical
+ * sections in reader will result in writer polling multiple times.
+ */
+#define QSBR_REPORTING_INTERVAL 1024
+
 #define MAX_RULE_NUM (1200000)
 
 struct route_rule {
@@ -36,9 +43,25 @@ struct route_rule {
 };
 
 static struct route_rule large_route_table[MAX_RULE_NUM];
+/* Route table for routes with depth > 24 */
+static struct route_rule large_ldepth_route_table[MAX_RULE_NUM];
 
 static uint32_t num_route_entries;
+static uint32_t num_ldepth_route_entries;
 #define NUM_ROUTE_ENTRIES num_route_entries
+#define NUM_LDEPTH_ROUTE_ENTRIES num_ldepth_route_entries
+
+#define TOTAL_WRITES (RCU_ITERATIONS * NUM_LDEPTH_ROUTE_ENTRIES)
+
+static struct rte_fib *g_fib;
+static struct rte_rcu_qsbr *rv;
+static volatile uint8_t writer_done;
+static volatile uint32_t thr_id;
+static uint64_t gwrite_cycles;
+static uint64_t glookups;
+static uint32_t num_writers;
+/* FIB APIs are not thread safe, use mutex to provide thread safety */
+static pthread_mutex_t fib_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 enum {
 	IP_CLASS_A,
@@ -192,7 +215,7 @@ static void generate_random_rule_prefix(uint32_t ip_class, uint8_t depth)
 	uint32_t ip_head_mask;
 	uint32_t rule_num;
 	uint32_t k;
-	struct route_rule *ptr_rule;
+	struct route_rule *ptr_rule, *ptr_ldepth_rule;
 
 	if (ip_class == IP_CLASS_A) {        /* IP Address class A */
 		fixed_bit_num = IP_HEAD_BIT_NUM_A;
@@ -237,10 +260,20 @@ static void generate_random_rule_prefix(uint32_t ip_class, uint8_t depth)
 	 */
 	start = lrand48() & mask;
 	ptr_rule = &large_route_table[num_route_entries];
+	ptr_ldepth_rule = &large_ldepth_route_table[num_ldepth_route_entries];
 	for (k = 0; k < rule_num; k++) {
 		ptr_rule->ip = (start << (RTE_FIB_MAX_DEPTH - depth))
 			| ip_head_mask;
 		ptr_rule->depth = depth;
+		/* If the depth of the route is more than 24, store it
+		 * in another table as well.
+		 */
+		if (depth > 24) {
+			ptr_ldepth_rule->ip = ptr_rule->ip;
+			ptr_ldepth_rule->depth = ptr_rule->depth;
+			ptr_ldepth_rule++;
+			num_ldepth_route_entries++;
+		}
 		ptr_rule++;
 		start = (start + step) & mask;
 	}
@@ -274,6 +307,7 @@ static void generate_large_route_rule_table(void)
 	uint8_t  depth;
 
 	num_route_entries = 0;
+	num_ldepth_route_entries = 0;
 	memset(large_route_table, 0, sizeof(large_route_table));
 
 	for (ip_class = IP_CLASS_A; ip_class <= IP_CLASS_C; ip_class++) {
@@ -316,6 +350,278 @@ print_route_distribution(const struct route_rule *table, uint32_t n)
 	printf("\n");
 }
 
+static uint16_t enabled_core_ids[RTE_MAX_LCORE];
+static unsigned int num_cores;
+
+/* Simple way to allocate thread ids in 0 to RTE_MAX_LCORE space */
+static inline uint32_t
+alloc_thread_id(void)
+{
+	uint32_t tmp_thr_id;
+
+	tmp_thr_id = __atomic_fetch_add(&thr_id, 1, __ATOMIC_RELAXED);
+	if (tmp_thr_id >= RTE_MAX_LCORE)
+		printf("Invalid thread id %u\n", tmp_thr_id);
+
+	return tmp_thr_id;
+}
+
+/*
+ * Reader thread using rte_fib data structure without RCU.
+ */
+static int
+test_fib_reader(void *arg)
+{
+	int i;
+	uint32_t ip_batch[QSBR_REPORTING_INTERVAL];
+	uint64_t next_hops[BULK_SIZE];
+	uint64_t lookups = 0;
+
+	RTE_SET_USED(arg);
+	do {
+		for (i = 0; i < QSBR_REPORTING_INTERVAL; i++)
+			ip_batch[i] = rte_rand();
+
+		for (i = 0; i < QSBR_REPORTING_INTERVAL; i += BULK_SIZE)
+			rte_fib_lookup_bulk(g_fib, &ip_batch[i], next_hops,
+				BULK_SIZE);
+
+		lookups += QSBR_REPORTING_INTERVAL;
+	} while (!writer_done);
+
+	__atomic_fetch_add(&glookups, lookups, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+/*
+ * Reader thread using rte_fib data structure with RCU.
+ */
+static int
+test_fib_rcu_qsbr_reader(void *arg)
+{
+	int i;
+	uint32_t thread_id = alloc_thread_id();
+	uint32_t ip_batch[QSBR_REPORTING_INTERVAL];
+	uint64_t next_hops[BULK_SIZE];
+	uint64_t lookups = 0;
+
+	RTE_SET_USED(arg);
+	/* Register this thread to report quiescent state */
+	rte_rcu_qsbr_thread_register(rv, thread_id);
+	rte_rcu_qsbr_thread_online(rv, thread_id);
+
+	do {
+		for (i = 0; i < QSBR_REPORTING_INTERVAL; i++)
+			ip_batch[i] = rte_rand();
+
+		for (i = 0; i < QSBR_REPORTING_INTERVAL; i += BULK_SIZE)
+			rte_fib_lookup_bulk(g_fib, &ip_batch[i], next_hops,
+				BULK_SIZE);
+
+		lookups += QSBR_REPORTING_INTERVAL;
+
+		/* Update quiescent state */
+		rte_rcu_qsbr_quiescent(rv, thread_id);
+	} while (!writer_done);
+
+	rte_rcu_qsbr_thread_offline(rv, thread_id);
+	rte_rcu_qsbr_thread_unregister(rv, thread_id);
+
+	__atomic_fetch_add(&glookups, lookups, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+/*
+ * Writer thread churning routes with depth > 24, so every add and
+ * delete allocates or releases a tbl8 group.
+ */
+static int
+test_fib_rcu_qsbr_writer(void *arg)
+{
+	unsigned int i, j, si, ei;
+	uint64_t begin, total_cycles;
+	uint64_t next_hop_add = 0xAA;
+	uint8_t pos_core = (uint8_t)((uintptr_t)arg);
+
+	si = (pos_core * NUM_LDEPTH_ROUTE_ENTRIES) / num_writers;
+	ei = ((pos_core + 1) * NUM_LDEPTH_ROUTE_ENTRIES) / num_writers;
+
+	/* Measure add/delete. */
+	begin = rte_rdtsc_precise();
+	for (i = 0; i < RCU_ITERATIONS; i++) {
+		/* Add all the entries */
+		for (j = si; j < ei; j++) {
+			if (num_writers > 1)
+				pthread_mutex_lock(&fib_mutex);
+			if (rte_fib_add(g_fib, large_ldepth_route_table[j].ip,
+					large_ldepth_route_table[j].depth,
+					next_hop_add) != 0) {
+				printf("Failed to add iteration %d, route# %d\n",
+					i, j);
+				goto error;
+			}
+			if (num_writers > 1)
+				pthread_mutex_unlock(&fib_mutex);
+		}
+
+		/* Delete all the entries */
+		for (j = si; j < ei; j++) {
+			if (num_writers > 1)
+				pthread_mutex_lock(&fib_mutex);
+			if (rte_fib_delete(g_fib,
+					large_ldepth_route_table[j].ip,
+					large_ldepth_route_table[j].depth) != 0) {
+				printf("Failed to delete iteration %d, route# %d\n",
+					i, j);
+				goto error;
+			}
+			if (num_writers > 1)
+				pthread_mutex_unlock(&fib_mutex);
+		}
+	}
+
+	total_cycles = rte_rdtsc_precise() - begin;
+
+	__atomic_fetch_add(&gwrite_cycles, total_cycles, __ATOMIC_RELAXED);
+
+	return 0;
+
+error:
+	if (num_writers > 1)
+		pthread_mutex_unlock(&fib_mutex);
+	return -1;
+}
+
+/*
+ * Route churn under lookup:
+ * 1/2 writers keep adding and deleting routes, rest are readers
+ * doing bulk lookups. Reports the update cost and the lookup rate
+ * readers sustain while routes churn.
+ */
+static int
+test_fib_rcu_perf_multi_writer(uint8_t use_rcu)
+{
+	struct rte_fib_conf config;
+	size_t sz;
+	unsigned int i, j;
+	uint16_t core_id;
+	uint64_t begin, elapsed;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	int (*reader_f)(void *arg) = NULL;
+
+	if (rte_lcore_count() < 3) {
+		printf("Not enough cores for fib_rcu_perf_autotest, expecting at least 3\n");
+		return TEST_SKIPPED;
+	}
+
+	num_cores = 0;
+	RTE_LCORE_FOREACH_WORKER(core_id) {
+		enabled_core_ids[num_cores] = core_id;
+		num_cores++;
+	}
+
+	for (j = 1; j < 3; j++) {
+		if (use_rcu)
+			printf("\nPerf test: %d writer(s), %d reader(s),"
+			       " RCU integration enabled\n", j, num_cores - j);
+		else
+			printf("\nPerf test: %d writer(s), %d reader(s),"
+			       " RCU integration disabled\n", j, num_cores - j);
+
+		num_writers = j;
+
+		/* Create FIB table */
+		config.max_routes = 2 * NUM_LDEPTH_ROUTE_ENTRIES;
+		config.type = RTE_FIB_DIR24_8;
+		config.default_nh = 0;
+		config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+		config.dir24_8.num_tbl8 = 2 * NUM_LDEPTH_ROUTE_ENTRIES;
+		g_fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+		TEST_FIB_ASSERT(g_fib != NULL);
+
+		/* Init RCU variable */
+		if (use_rcu) {
+			sz = rte_rcu_qsbr_get_memsize(num_cores);
+			rv = (struct rte_rcu_qsbr *)rte_zmalloc("rcu0", sz,
+							RTE_CACHE_LINE_SIZE);
+			rte_rcu_qsbr_init(rv, num_cores);
+
+			rcu_cfg.v = rv;
+			/* Assign the RCU variable to FIB */
+			if (rte_fib_rcu_qsbr_add(g_fib, &rcu_cfg) != 0) {
+				printf("RCU variable assignment failed\n");
+				goto error;
+			}
+
+			reader_f = test_fib_rcu_qsbr_reader;
+		} else
+			reader_f = test_fib_reader;
+
+		writer_done = 0;
+		__atomic_store_n(&gwrite_cycles, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&glookups, 0, __ATOMIC_RELAXED);
+
+		__atomic_store_n(&thr_id, 0, __ATOMIC_SEQ_CST);
+
+		begin = rte_rdtsc_precise();
+
+		/* Launch reader threads */
+		for (i = j; i < num_cores; i++)
+			rte_eal_remote_launch(reader_f, NULL,
+						enabled_core_ids[i]);
+
+		/* Launch writer threads */
+		for (i = 0; i < j; i++)
+			rte_eal_remote_launch(test_fib_rcu_qsbr_writer,
+						(void *)(uintptr_t)i,
+						enabled_core_ids[i]);
+
+		/* Wait for writer threads */
+		for (i = 0; i < j; i++)
+			if (rte_eal_wait_lcore(enabled_core_ids[i]) < 0)
+				goto error;
+
+		printf("Total FIB Adds: %d\n", TOTAL_WRITES);
+		printf("Total FIB Deletes: %d\n", TOTAL_WRITES);
+		printf("Average FIB Add/Del: %"PRIu64" cycles\n",
+			__atomic_load_n(&gwrite_cycles, __ATOMIC_RELAXED)
+			/ TOTAL_WRITES);
+
+		writer_done = 1;
+		/* Wait until all readers have exited */
+		for (i = j; i < num_cores; i++)
+			rte_eal_wait_lcore(enabled_core_ids[i]);
+
+		elapsed = rte_rdtsc_precise() - begin;
+		printf("Average FIB Lookup rate per reader under churn: "
+			"%.2f Mlookups/s\n",
+			(double)__atomic_load_n(&glookups, __ATOMIC_RELAXED) /
+			(num_cores - j) /
+			((double)elapsed / rte_get_tsc_hz()) / 1e6);
+
+		rte_fib_free(g_fib);
+		rte_free(rv);
+		g_fib = NULL;
+		rv = NULL;
+	}
+
+	return 0;
+
+error:
+	writer_done = 1;
+	/* Wait until all readers have exited */
+	rte_eal_mp_wait_lcore();
+
+	rte_fib_free(g_fib);
+	rte_free(rv);
+	g_fib = NULL;
+	rv = NULL;
+
+	return -1;
+}
+
 static int
 test_fib_perf(void)
 {
@@ -405,6 +711,12 @@ test_fib_perf(void)
 
 	rte_fib_free(fib);
 
+	if (test_fib_rcu_perf_multi_writer(0) < 0)
+		return -1;
+
+	if (test_fib_rcu_perf_multi_writer(1) < 0)
+		return -1;
+
 	return 0;
 }
 
@@ -0,0 +1,538 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_vxlan.h>
+#include <rte_mbuf.h>
+#include <rte_gro.h>
+
+#include "test.h"
+
+#define NUM_MBUFS 1024
+#define BURST 32
+#define PAYLOAD_LEN 1000
+#define FIRST_SEQ 1000
+#define PERF_ITERATIONS 4096
+#define PERF_FLOWS 8
+
+#define TCP6_HDR_LEN (RTE_ETHER_HDR_LEN + sizeof(struct rte_ipv6_hdr) + \
+		sizeof(struct rte_tcp_hdr))
+#define VXLAN6_TCP4_HDR_LEN (RTE_ETHER_HDR_LEN + \
+		sizeof(struct rte_ipv6_hdr) + sizeof(struct rte_udp_hdr) + \
+		sizeof(struct rte_vxlan_hdr) + RTE_ETHER_HDR_LEN + \
+		sizeof(struct rte_ipv4_hdr) + sizeof(struct rte_tcp_hdr))
+
+static struct rte_mempool *pkt_pool;
+
+static void
+fill_tcp_hdr(struct rte_tcp_hdr *tcp, uint16_t flow, uint32_t seq,
+		uint8_t flags)
+{
+	memset(tcp, 0, sizeof(*tcp));
+	tcp->src_port = rte_cpu_to_be_16(1024 + flow);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(seq);
+	tcp->recv_ack = rte_cpu_to_be_32(1);
+	tcp->data_off = (sizeof(*tcp) / 4) << 4;
+	tcp->tcp_flags = flags;
+	tcp->rx_win = rte_cpu_to_be_16(UINT16_MAX);
+}
+
+static void
+fill_ipv6_hdr(struct rte_ipv6_hdr *ip, uint16_t flow, uint8_t proto,
+		uint16_t payload_len)
+{
+	memset(ip, 0, sizeof(*ip));
+	ip->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip->payload_len = rte_cpu_to_be_16(payload_len);
+	ip->proto = proto;
+	ip->hop_limits = 64;
+	ip->src_addr[0] = 0x20;
+	ip->src_addr[1] = 0x01;
+	ip->src_addr[14] = flow >> 8;
+	ip->src_addr[15] = flow & 0xff;
+	ip->dst_addr[0] = 0x20;
+	ip->dst_addr[1] = 0x01;
+	ip->dst_addr[15] = 1;
+}
+
+static void
+fill_ether_hdr(struct rte_ether_hdr *eth, uint16_t ether_type)
+{
+	static const struct rte_ether_addr src = {
+		.addr_bytes = { 0x02, 0, 0, 0, 0, 1 } };
+	static const struct rte_ether_addr dst = {
+		.addr_bytes = { 0x02, 0, 0, 0, 0, 2 } };
+
+	rte_ether_addr_copy(&src, &eth->s_addr);
+	rte_ether_addr_copy(&dst, &eth->d_addr);
+	eth->ether_type = rte_cpu_to_be_16(ether_type);
+}
+
+/* Build an Ethernet/IPv6/TCP packet carrying PAYLOAD_LEN bytes. */
+static struct rte_mbuf *
+build_tcp6_pkt(uint16_t flow, uint32_t seq, uint8_t flags)
+{
+	struct rte_mbuf *m;
+	struct rte_ether_hdr *eth;
+	struct rte_ipv6_hdr *ip;
+	struct rte_tcp_hdr *tcp;
+	char *payload;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+			TCP6_HDR_LEN + PAYLOAD_LEN);
+	if (eth == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	ip = (struct rte_ipv6_hdr *)(eth + 1);
+	tcp = (struct rte_tcp_hdr *)(ip + 1);
+	payload = (char *)(tcp + 1);
+
+	fill_ether_hdr(eth, RTE_ETHER_TYPE_IPV6);
+	fill_ipv6_hdr(ip, flow, IPPROTO_TCP,
+			sizeof(*tcp) + PAYLOAD_LEN);
+	fill_tcp_hdr(tcp, flow, seq, flags);
+	memset(payload, seq & 0xff, PAYLOAD_LEN);
+
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+	m->l4_len = sizeof(*tcp);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6 |
+		RTE_PTYPE_L4_TCP;
+
+	return m;
+}
+
+/*
+ * Build a VxLAN packet with an outer IPv6 header and an inner
+ * Ethernet/IPv4/TCP packet carrying PAYLOAD_LEN bytes.
+ */
+static struct rte_mbuf *
+build_vxlan6_tcp4_pkt(uint16_t flow, uint32_t seq, uint16_t ip_id)
+{
+	struct rte_mbuf *m;
+	struct rte_ether_hdr *outer_eth, *eth;
+	struct rte_ipv6_hdr *outer_ip;
+	struct rte_udp_hdr *udp;
+	struct rte_vxlan_hdr *vxlan;
+	struct rte_ipv4_hdr *ip;
+	struct rte_tcp_hdr *tcp;
+	char *payload;
+	uint16_t len;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	outer_eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+			VXLAN6_TCP4_HDR_LEN + PAYLOAD_LEN);
+	if (outer_eth == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	outer_ip = (struct rte_ipv6_hdr *)(outer_eth + 1);
+	udp = (struct rte_udp_hdr *)(outer_ip + 1);
+	vxlan = (struct rte_vxlan_hdr *)(udp + 1);
+	eth = (struct rte_ether_hdr *)(vxlan + 1);
+	ip = (struct rte_ipv4_hdr *)(eth + 1);
+	tcp = (struct rte_tcp_hdr *)(ip + 1);
+	payload = (char *)(tcp + 1);
+
+	len = m->pkt_len - sizeof(*outer_eth) - sizeof(*outer_ip);
+	fill_ether_hdr(outer_eth, RTE_ETHER_TYPE_IPV6);
+	fill_ipv6_hdr(outer_ip, 0, IPPROTO_UDP, len);
+	udp->src_port = rte_cpu_to_be_16(49152 + flow);
+	udp->dst_port = rte_cpu_to_be_16(RTE_VXLAN_DEFAULT_PORT);
+	udp->dgram_len = rte_cpu_to_be_16(len);
+	udp->dgram_cksum = 0;
+	vxlan->vx_flags = rte_cpu_to_be_32(0x08000000);
+	vxlan->vx_vni = rte_cpu_to_be_32(100 << 8);
+
+	len -= sizeof(*udp) + sizeof(*vxlan) + sizeof(*eth);
+	fill_ether_hdr(eth, RTE_ETHER_TYPE_IPV4);
+	memset(ip, 0, sizeof(*ip));
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->total_length = rte_cpu_to_be_16(len);
+	ip->packet_id = rte_cpu_to_be_16(ip_id);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_TCP;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, flow >> 8, flow));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 1, 0, 1));
+	fill_tcp_hdr(tcp, flow, seq, RTE_TCP_ACK_FLAG);
+	memset(payload, seq & 0xff, PAYLOAD_LEN);
+
+	m->outer_l2_len = sizeof(*outer_eth);
+	m->outer_l3_len = sizeof(*outer_ip);
+	m->l2_len = sizeof(*udp) + sizeof(*vxlan) + sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+	m->l4_len = sizeof(*tcp);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6 |
+		RTE_PTYPE_L4_UDP | RTE_PTYPE_TUNNEL_VXLAN |
+		RTE_PTYPE_INNER_L2_ETHER | RTE_PTYPE_INNER_L3_IPV4 |
+		RTE_PTYPE_INNER_L4_TCP;
+
+	return m;
+}
+
+static void
+free_pkts(struct rte_mbuf **pkts, uint16_t nb_pkts)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts; i++)
+		rte_pktmbuf_free(pkts[i]);
+}
+
+/* Check the headers of a TCP/IPv6 packet made of nb_segs segments. */
+static int
+check_tcp6_pkt(struct rte_mbuf *m, uint16_t nb_segs)
+{
+	struct rte_ipv6_hdr *ip;
+	struct rte_tcp_hdr *tcp;
+
+	ip = rte_pktmbuf_mtod_offset(m, struct rte_ipv6_hdr *,
+			RTE_ETHER_HDR_LEN);
+	tcp = (struct rte_tcp_hdr *)(ip + 1);
+
+	TEST_ASSERT_EQUAL(m->nb_segs, nb_segs, "Wrong number of segments");
+	TEST_ASSERT_EQUAL(m->pkt_len, TCP6_HDR_LEN + nb_segs * PAYLOAD_LEN,
+			"Wrong packet length");
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->payload_len),
+			m->pkt_len - RTE_ETHER_HDR_LEN - sizeof(*ip),
+			"Wrong IPv6 payload length");
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_32(tcp->sent_seq), FIRST_SEQ,
+			"Wrong TCP sequence number");
+
+	return 0;
+}
+
+/*
+ * Lightweight mode TCP/IPv6 GRO:
+ *	- in order segments of a flow are merged
+ *	- out of order segments of a flow are merged
+ *	- segments of different flows are not merged
+ *	- packets with SYN set or IPv6 extension headers are left as is
+ */
+static int
+test_gro_tcp6_burst(void)
+{
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_TCP_IPV6,
+		.max_flow_num = 4,
+		.max_item_per_flow = BURST,
+	};
+	struct rte_mbuf *pkts[BURST];
+	uint16_t i, nb_pkts;
+
+	/* 8 segments of one flow, in reverse order, and a SYN */
+	for (i = 0; i < 8; i++) {
+		pkts[i] = build_tcp6_pkt(0,
+				FIRST_SEQ + (7 - i) * PAYLOAD_LEN,
+				RTE_TCP_ACK_FLAG);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Failed to build packet");
+	}
+	pkts[8] = build_tcp6_pkt(0, 0, RTE_TCP_SYN_FLAG);
+	TEST_ASSERT_NOT_NULL(pkts[8], "Failed to build packet");
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, 9, &param);
+	TEST_ASSERT_EQUAL(nb_pkts, 2, "Wrong number of packets after GRO");
+	TEST_ASSERT_SUCCESS(check_tcp6_pkt(pkts[0], 8),
+			"Wrong merged packet");
+	TEST_ASSERT_EQUAL(pkts[1]->nb_segs, 1, "SYN packet merged");
+	free_pkts(pkts, nb_pkts);
+
+	/* 2 flows, 4 segments each, interleaved */
+	for (i = 0; i < 8; i++) {
+		pkts[i] = build_tcp6_pkt(i & 1,
+				FIRST_SEQ + (i / 2) * PAYLOAD_LEN,
+				RTE_TCP_ACK_FLAG);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Failed to build packet");
+	}
+	nb_pkts = rte_gro_reassemble_burst(pkts, 8, &param);
+	TEST_ASSERT_EQUAL(nb_pkts, 2, "Wrong number of packets after GRO");
+	for (i = 0; i < nb_pkts; i++)
+		TEST_ASSERT_SUCCESS(check_tcp6_pkt(pkts[i], 4),
+				"Wrong merged packet");
+	free_pkts(pkts, nb_pkts);
+
+	/* IPv6 extension headers are not supported */
+	for (i = 0; i < 2; i++) {
+		pkts[i] = build_tcp6_pkt(0, FIRST_SEQ + i * PAYLOAD_LEN,
+				RTE_TCP_ACK_FLAG);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Failed to build packet");
+		pkts[i]->l3_len += 8;
+	}
+	nb_pkts = rte_gro_reassemble_burst(pkts, 2, &param);
+	TEST_ASSERT_EQUAL(nb_pkts, 2, "Packets with IPv6 ext headers merged");
+	free_pkts(pkts, nb_pkts);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Lightweight mode GRO of VxLAN packets with an outer IPv6 header:
+ *	- in order segments of a flow are merged
+ *	- the outer IPv6, outer UDP and inner IPv4 lengths are updated
+ *	- segments with non consecutive inner IPv4 IDs are not merged
+ */
+static int
+test_gro_vxlan6_tcp4_burst(void)
+{
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_IPV6_VXLAN_TCP_IPV4,
+		.max_flow_num = 4,
+		.max_item_per_flow = BURST,
+	};
+	struct rte_mbuf *pkts[BURST];
+	struct rte_ipv6_hdr *outer_ip;
+	struct rte_udp_hdr *udp;
+	struct rte_ipv4_hdr *ip;
+	uint16_t i, nb_pkts;
+
+	for (i = 0; i < 4; i++) {
+		pkts[i] = build_vxlan6_tcp4_pkt(0,
+				FIRST_SEQ + i * PAYLOAD_LEN, i);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Failed to build packet");
+	}
+	/* next segment of the flow, but with a IPv4 ID gap */
+	pkts[4] = build_vxlan6_tcp4_pkt(0, FIRST_SEQ + 4 * PAYLOAD_LEN, 10);
+	TEST_ASSERT_NOT_NULL(pkts[4], "Failed to build packet");
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, 5, &param);
+	TEST_ASSERT_EQUAL(nb_pkts, 2, "Wrong number of packets after GRO");
+	TEST_ASSERT_EQUAL(pkts[0]->nb_segs, 4, "Wrong number of segments");
+	TEST_ASSERT_EQUAL(pkts[0]->pkt_len,
+			VXLAN6_TCP4_HDR_LEN + 4 * PAYLOAD_LEN,
+			"Wrong packet length");
+
+	outer_ip = rte_pktmbuf_mtod_offset(pkts[0], struct rte_ipv6_hdr *,
+			pkts[0]->outer_l2_len);
+	udp = (struct rte_udp_hdr *)(outer_ip + 1);
+	ip = (struct rte_ipv4_hdr *)((char *)udp + pkts[0]->l2_len);
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(outer_ip->payload_len),
+			pkts[0]->pkt_len - pkts[0]->outer_l2_len -
+			pkts[0]->outer_l3_len,
+			"Wrong outer IPv6 payload length");
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(udp->dgram_len),
+			rte_be_to_cpu_16(outer_ip->payload_len),
+			"Wrong outer UDP length");
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->total_length),
+			rte_be_to_cpu_16(udp->dgram_len) - pkts[0]->l2_len,
+			"Wrong inner IPv4 length");
+	TEST_ASSERT_EQUAL(pkts[1]->nb_segs, 1, "Packet with ID gap merged");
+	free_pkts(pkts, nb_pkts);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Heavyweight mode GRO with both IPv6 types:
+ *	- packets are kept in the context until flushed
+ *	- flushed packets are merged per flow
+ */
+static int
+test_gro_ipv6_ctx(void)
+{
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_TCP_IPV6 | RTE_GRO_IPV6_VXLAN_TCP_IPV4,
+		.max_flow_num = 4,
+		.max_item_per_flow = BURST,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	struct rte_mbuf *pkts[BURST];
+	uint16_t i, nb_pkts;
+	void *ctx;
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_ASSERT_NOT_NULL(ctx, "Failed to create GRO context");
+
+	for (i = 0; i < 8; i++) {
+		if (i & 1)
+			pkts[i] = build_vxlan6_tcp4_pkt(0,
+					FIRST_SEQ + (i / 2) * PAYLOAD_LEN,
+					i / 2);
+		else
+			pkts[i] = build_tcp6_pkt(0,
+					FIRST_SEQ + (i / 2) * PAYLOAD_LEN,
+					RTE_TCP_ACK_FLAG);
+		TEST_ASSERT_NOT_NULL(pkts[i], "Failed to build packet");
+	}
+
+	nb_pkts = rte_gro_reassemble(pkts, 4, ctx);
+	TEST_ASSERT_EQUAL(nb_pkts, 0, "Packets not kept in the context");
+	nb_pkts = rte_gro_reassemble(&pkts[4], 4, ctx);
+	TEST_ASSERT_EQUAL(nb_pkts, 0, "Packets not kept in the context");
+	TEST_ASSERT_EQUAL(rte_gro_get_pkt_count(ctx), 2,
+			"Wrong number of packets in the context");
+
+	nb_pkts = rte_gro_timeout_flush(ctx, 0, RTE_GRO_TCP_IPV6, pkts,
+			BURST);
+	TEST_ASSERT_EQUAL(nb_pkts, 1, "Wrong number of flushed packets");
+	TEST_ASSERT_SUCCESS(check_tcp6_pkt(pkts[0], 4),
+			"Wrong merged packet");
+	free_pkts(pkts, nb_pkts);
+
+	nb_pkts = rte_gro_timeout_flush(ctx, 0, RTE_GRO_IPV6_VXLAN_TCP_IPV4,
+			pkts, BURST);
+	TEST_ASSERT_EQUAL(nb_pkts, 1, "Wrong number of flushed packets");
+	TEST_ASSERT_EQUAL(pkts[0]->nb_segs, 4, "Wrong number of segments");
+	free_pkts(pkts, nb_pkts);
+
+	TEST_ASSERT_EQUAL(rte_gro_get_pkt_count(ctx), 0,
+			"Context not empty after flush");
+	rte_gro_ctx_destroy(ctx);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_setup(void)
+{
+	if (pkt_pool == NULL) {
+		pkt_pool = rte_pktmbuf_pool_create("GRO_MBUF_POOL",
+				NUM_MBUFS, BURST, 0,
+				RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+		if (pkt_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void
+test_teardown(void)
+{
+	rte_mempool_free(pkt_pool);
+	pkt_pool = NULL;
+}
+
+static struct unit_test_suite gro_test_suite = {
+	.setup = test_setup,
+	.teardown = test_teardown,
+	.suite_name = "GRO Unit Test Suite",
+	.unit_test_cases = {
+		TEST_CASE(test_gro_tcp6_burst),
+		TEST_CASE(test_gro_vxlan6_tcp4_burst),
+		TEST_CASE(test_gro_ipv6_ctx),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_gro(void)
+{
+	return unit_test_suite_runner(&gro_test_suite);
+}
+
+/*
+ * Build a burst of PERF_FLOWS flows with BURST / PERF_FLOWS in order
+ * segments each, interleaved as they would be received.
+ */
+static int
+build_perf_burst(uint64_t gro_type, struct rte_mbuf **pkts)
+{
+	uint16_t i, flow, seg;
+
+	for (i = 0; i < BURST; i++) {
+		flow = i % PERF_FLOWS;
+		seg = i / PERF_FLOWS;
+		if (gro_type == RTE_GRO_TCP_IPV6)
+			pkts[i] = build_tcp6_pkt(flow,
+					FIRST_SEQ + seg * PAYLOAD_LEN,
+					RTE_TCP_ACK_FLAG);
+		else
+			pkts[i] = build_vxlan6_tcp4_pkt(flow,
+					FIRST_SEQ + seg * PAYLOAD_LEN, seg);
+		if (pkts[i] == NULL) {
+			free_pkts(pkts, i);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static int
+test_gro_perf_type(uint64_t gro_type, const char *name)
+{
+	struct rte_gro_param param = {
+		.gro_types = gro_type,
+		.max_flow_num = PERF_FLOWS,
+		.max_item_per_flow = BURST / PERF_FLOWS,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	struct rte_mbuf *pkts[BURST];
+	uint64_t burst_cycles = 0, ctx_cycles = 0, start;
+	uint16_t nb_pkts;
+	unsigned int i;
+	void *ctx;
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_ASSERT_NOT_NULL(ctx, "Failed to create GRO context");
+
+	for (i = 0; i < PERF_ITERATIONS; i++) {
+		TEST_ASSERT_SUCCESS(build_perf_burst(gro_type, pkts),
+				"Failed to build packets");
+		start = rte_rdtsc_precise();
+		nb_pkts = rte_gro_reassemble_burst(pkts, BURST, &param);
+		burst_cycles += rte_rdtsc_precise() - start;
+		TEST_ASSERT_EQUAL(nb_pkts, PERF_FLOWS,
+				"Wrong number of packets after GRO");
+		free_pkts(pkts, nb_pkts);
+
+		TEST_ASSERT_SUCCESS(build_perf_burst(gro_type, pkts),
+				"Failed to build packets");
+		start = rte_rdtsc_precise();
+		nb_pkts = rte_gro_reassemble(pkts, BURST, ctx);
+		nb_pkts += rte_gro_timeout_flush(ctx, 0, gro_type,
+				&pkts[nb_pkts], BURST - nb_pkts);
+		ctx_cycles += rte_rdtsc_precise() - start;
+		TEST_ASSERT_EQUAL(nb_pkts, PERF_FLOWS,
+				"Wrong number of packets after GRO");
+		free_pkts(pkts, nb_pkts);
+	}
+	rte_gro_ctx_destroy(ctx);
+
+	printf("%-24s burst mode: %6.1f cycles/pkt, context mode: %6.1f cycles/pkt\n",
+			name,
+			(double)burst_cycles / (PERF_ITERATIONS * BURST),
+			(double)ctx_cycles / (PERF_ITERATIONS * BURST));
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_gro_perf(void)
+{
+	int ret;
+
+	if (test_setup() < 0)
+		return TEST_FAILED;
+
+	printf("%u flows, %u segments of %u bytes per flow and burst\n",
+			PERF_FLOWS, BURST / PERF_FLOWS, PAYLOAD_LEN);
+	ret = test_gro_perf_type(RTE_GRO_TCP_IPV6, "TCP/IPv6");
+	if (ret == TEST_SUCCESS)
+		ret = test_gro_perf_type(RTE_GRO_IPV6_VXLAN_TCP_IPV4,
+				"VxLAN/IPv6 TCP/IPv4");
+
+	test_teardown();
+
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(gro_autotest, test_gro);
+REGISTER_TEST_COMMAND(gro_perf_autotest, test_gro_perf);
@@ -0,0 +1,630 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_gre.h>
+#include <rte_vxlan.h>
+#include <rte_mbuf.h>
+#include <rte_ethdev.h>
+#include <rte_gso.h>
+
+#include "test.h"
+
+#define NUM_MBUFS 1024
+#define NUM_BIG_MBUFS 16
+#define BURST 64
+#define GSO_SIZE 1514
+#define PAYLOAD_LEN 4000
+#define PERF_PAYLOAD_LEN 16000
+#define BIG_BUF_SIZE (RTE_PKTMBUF_HEADROOM + PERF_PAYLOAD_LEN + 256)
+#define FIRST_SEQ 1000
+#define FIRST_IP_ID 100
+#define PERF_ITERATIONS 4096
+
+#define TUNNEL_GSO_TYPES (DEV_TX_OFFLOAD_TCP_TSO | DEV_TX_OFFLOAD_UDP_TSO | \
+		DEV_TX_OFFLOAD_VXLAN_TNL_TSO | DEV_TX_OFFLOAD_GRE_TNL_TSO)
+
+static struct rte_mempool *pkt_pool;
+static struct rte_mempool *direct_pool;
+static struct rte_mempool *indirect_pool;
+
+static void
+fill_ipv4_hdr(struct rte_ipv4_hdr *ip, uint8_t proto, uint16_t len)
+{
+	memset(ip, 0, sizeof(*ip));
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->total_length = rte_cpu_to_be_16(len);
+	ip->packet_id = rte_cpu_to_be_16(FIRST_IP_ID);
+	ip->time_to_live = 64;
+	ip->next_proto_id = proto;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 2));
+}
+
+static void
+fill_ipv6_hdr(struct rte_ipv6_hdr *ip, uint8_t proto, uint16_t len)
+{
+	memset(ip, 0, sizeof(*ip));
+	ip->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip->payload_len = rte_cpu_to_be_16(len - sizeof(*ip));
+	ip->proto = proto;
+	ip->hop_limits = 64;
+	ip->src_addr[0] = 0x20;
+	ip->src_addr[1] = 0x01;
+	ip->src_addr[15] = 1;
+	ip->dst_addr[0] = 0x20;
+	ip->dst_addr[1] = 0x01;
+	ip->dst_addr[15] = 2;
+}
+
+static void
+fill_ether_hdr(struct rte_ether_hdr *eth, uint16_t ether_type)
+{
+	static const struct rte_ether_addr src = {
+		.addr_bytes = { 0x02, 0, 0, 0, 0, 1 } };
+	static const struct rte_ether_addr dst = {
+		.addr_bytes = { 0x02, 0, 0, 0, 0, 2 } };
+
+	rte_ether_addr_copy(&src, &eth->s_addr);
+	rte_ether_addr_copy(&dst, &eth->d_addr);
+	eth->ether_type = rte_cpu_to_be_16(ether_type);
+}
+
+/*
+ * Fill an IPv4 or IPv6 header, depending on is_ipv6, followed by a TCP or
+ * UDP header and payload_len bytes of payload. Return the length of the
+ * IP and L4 headers.
+ */
+static uint16_t
+fill_ip_l4(char *hdr, int is_ipv6, int is_tcp, uint16_t payload_len,
+		struct rte_mbuf *m)
+{
+	struct rte_tcp_hdr *tcp;
+	struct rte_udp_hdr *udp;
+	uint16_t l3_len, l4_len, i;
+	uint8_t proto;
+	char *l4;
+
+	l3_len = is_ipv6 ? sizeof(struct rte_ipv6_hdr) :
+		sizeof(struct rte_ipv4_hdr);
+	l4_len = is_tcp ? sizeof(struct rte_tcp_hdr) :
+		sizeof(struct rte_udp_hdr);
+	proto = is_tcp ? IPPROTO_TCP : IPPROTO_UDP;
+
+	if (is_ipv6)
+		fill_ipv6_hdr((struct rte_ipv6_hdr *)hdr, proto,
+				l3_len + l4_len + payload_len);
+	else
+		fill_ipv4_hdr((struct rte_ipv4_hdr *)hdr, proto,
+				l3_len + l4_len + payload_len);
+
+	l4 = hdr + l3_len;
+	if (is_tcp) {
+		tcp = (struct rte_tcp_hdr *)l4;
+		memset(tcp, 0, sizeof(*tcp));
+		tcp->src_port = rte_cpu_to_be_16(1024);
+		tcp->dst_port = rte_cpu_to_be_16(80);
+		tcp->sent_seq = rte_cpu_to_be_32(FIRST_SEQ);
+		tcp->recv_ack = rte_cpu_to_be_32(1);
+		tcp->data_off = (sizeof(*tcp) / 4) << 4;
+		tcp->tcp_flags = RTE_TCP_ACK_FLAG | RTE_TCP_PSH_FLAG;
+		tcp->rx_win = rte_cpu_to_be_16(UINT16_MAX);
+	} else {
+		udp = (struct rte_udp_hdr *)l4;
+		udp->src_port = rte_cpu_to_be_16(1024);
+		udp->dst_port = rte_cpu_to_be_16(5000);
+		udp->dgram_len = rte_cpu_to_be_16(l4_len + payload_len);
+		udp->dgram_cksum = 0;
+	}
+
+	for (i = 0; i < payload_len; i++)
+		l4[l4_len + i] = i & 0xff;
+
+	m->l3_len = l3_len;
+	m->l4_len = l4_len;
+
+	return l3_len + l4_len;
+}
+
+/*
+ * Build a packet matching ol_flags: PKT_TX_TCP_SEG or PKT_TX_UDP_SEG for
+ * the L4 type, PKT_TX_IPV4 or PKT_TX_IPV6 for the (inner) IP type and, for
+ * VxLAN or GRE tunnels, PKT_TX_OUTER_IPV4 or PKT_TX_OUTER_IPV6 for the
+ * outer IP type.
+ */
+static struct rte_mbuf *
+build_pkt(struct rte_mempool *mp, uint64_t ol_flags, uint16_t payload_len)
+{
+	struct rte_mbuf *m;
+	struct rte_ether_hdr *eth;
+	struct rte_udp_hdr *udp;
+	struct rte_vxlan_hdr *vxlan;
+	struct rte_gre_hdr *gre;
+	uint64_t tunnel = ol_flags & PKT_TX_TUNNEL_MASK;
+	int is_ipv6 = !!(ol_flags & PKT_TX_IPV6);
+	int is_tcp = !!(ol_flags & PKT_TX_TCP_SEG);
+	uint16_t len, tunnel_len = 0, outer_l3_len = 0;
+	char *hdr;
+
+	m = rte_pktmbuf_alloc(mp);
+	if (m == NULL)
+		return NULL;
+
+	if (tunnel != 0) {
+		outer_l3_len = (ol_flags & PKT_TX_OUTER_IPV6) ?
+			sizeof(struct rte_ipv6_hdr) :
+			sizeof(struct rte_ipv4_hdr);
+		tunnel_len = (tunnel == PKT_TX_TUNNEL_VXLAN) ?
+			sizeof(*udp) + sizeof(*vxlan) + sizeof(*eth) :
+			sizeof(*gre);
+	}
+	len = sizeof(*eth) + outer_l3_len + tunnel_len +
+		(is_ipv6 ? sizeof(struct rte_ipv6_hdr) :
+		 sizeof(struct rte_ipv4_hdr)) +
+		(is_tcp ? sizeof(struct rte_tcp_hdr) :
+		 sizeof(struct rte_udp_hdr)) + payload_len;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m, len);
+	if (eth == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	hdr = (char *)(eth + 1);
+
+	if (tunnel == 0) {
+		fill_ether_hdr(eth, is_ipv6 ? RTE_ETHER_TYPE_IPV6 :
+				RTE_ETHER_TYPE_IPV4);
+		m->l2_len = sizeof(*eth);
+		fill_ip_l4(hdr, is_ipv6, is_tcp, payload_len, m);
+		m->ol_flags = ol_flags;
+		return m;
+	}
+
+	len -= sizeof(*eth);
+	if (ol_flags & PKT_TX_OUTER_IPV6) {
+		fill_ether_hdr(eth, RTE_ETHER_TYPE_IPV6);
+		fill_ipv6_hdr((struct rte_ipv6_hdr *)hdr,
+				tunnel == PKT_TX_TUNNEL_VXLAN ?
+				IPPROTO_UDP : IPPROTO_GRE, len);
+	} else {
+		fill_ether_hdr(eth, RTE_ETHER_TYPE_IPV4);
+		fill_ipv4_hdr((struct rte_ipv4_hdr *)hdr,
+				tunnel == PKT_TX_TUNNEL_VXLAN ?
+				IPPROTO_UDP : IPPROTO_GRE, len);
+	}
+	hdr += outer_l3_len;
+	len -= outer_l3_len;
+
+	if (tunnel == PKT_TX_TUNNEL_VXLAN) {
+		udp = (struct rte_udp_hdr *)hdr;
+		udp->src_port = rte_cpu_to_be_16(49152);
+		udp->dst_port = rte_cpu_to_be_16(RTE_VXLAN_DEFAULT_PORT);
+		udp->dgram_len = rte_cpu_to_be_16(len);
+		udp->dgram_cksum = 0;
+		vxlan = (struct rte_vxlan_hdr *)(udp + 1);
+		vxlan->vx_flags = rte_cpu_to_be_32(0x08000000);
+		vxlan->vx_vni = rte_cpu_to_be_32(100 << 8);
+		fill_ether_hdr((struct rte_ether_hdr *)(vxlan + 1),
+				is_ipv6 ? RTE_ETHER_TYPE_IPV6 :
+				RTE_ETHER_TYPE_IPV4);
+	} else {
+		gre = (struct rte_gre_hdr *)hdr;
+		memset(gre, 0, sizeof(*gre));
+		gre->proto = rte_cpu_to_be_16(is_ipv6 ? RTE_ETHER_TYPE_IPV6 :
+				RTE_ETHER_TYPE_IPV4);
+	}
+	hdr += tunnel_len;
+
+	m->outer_l2_len = sizeof(*eth);
+	m->outer_l3_len = outer_l3_len;
+	m->l2_len = tunnel_len;
+	fill_ip_l4(hdr, is_ipv6, is_tcp, payload_len, m);
+	m->ol_flags = ol_flags;
+
+	return m;
+}
+
+static void
+free_pkts(struct rte_mbuf **pkts, uint16_t nb_pkts)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts; i++)
+		rte_pktmbuf_free(pkts[i]);
+}
+
+/* Check the length field of the IPv4 or IPv6 header at offset off. */
+static int
+check_ip_len(struct rte_mbuf *seg, uint16_t off, int is_ipv6)
+{
+	struct rte_ipv4_hdr *ipv4;
+	struct rte_ipv6_hdr *ipv6;
+
+	if (is_ipv6) {
+		ipv6 = rte_pktmbuf_mtod_offset(seg, struct rte_ipv6_hdr *, off);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ipv6->payload_len),
+				seg->pkt_len - off - sizeof(*ipv6),
+				"Wrong IPv6 payload length");
+	} else {
+		ipv4 = rte_pktmbuf_mtod_offset(seg, struct rte_ipv4_hdr *, off);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ipv4->total_length),
+				seg->pkt_len - off, "Wrong IPv4 total length");
+	}
+	return 0;
+}
+
+/*
+ * Check the GSO segments of pkt:
+ *	- each segment fits in GSO_SIZE bytes
+ *	- the payloads of the segments, in order, are the payload of pkt
+ *	- the IP, UDP and TCP header fields are updated
+ *	- the UDP/IPv6 segments are IPv6 fragments of the packet
+ */
+static int
+check_segments(struct rte_mbuf *pkt, uint64_t ol_flags,
+		struct rte_mbuf **segs, uint16_t nb_segs)
+{
+	uint8_t in_buf[GSO_SIZE], out_buf[GSO_SIZE];
+	const void *in_data, *out_data;
+	struct rte_ipv4_hdr *ipv4;
+	struct rte_ipv6_fragment_ext *frag;
+	struct rte_udp_hdr *udp;
+	struct rte_tcp_hdr *tcp;
+	uint64_t tunnel = ol_flags & PKT_TX_TUNNEL_MASK;
+	int is_ipv6 = !!(ol_flags & PKT_TX_IPV6);
+	int is_tcp = !!(ol_flags & PKT_TX_TCP_SEG);
+	uint16_t outer_off, inner_off, in_hdr_len, out_hdr_len, pyld_len, i;
+	uint32_t frag_id = 0, pyld_off = 0;
+
+	outer_off = pkt->outer_l2_len;
+	inner_off = outer_off + pkt->outer_l3_len + pkt->l2_len;
+	in_hdr_len = inner_off + pkt->l3_len + (is_tcp ? pkt->l4_len : 0);
+
+	for (i = 0; i < nb_segs; i++) {
+		TEST_ASSERT(segs[i]->pkt_len <= GSO_SIZE,
+				"Segment %u too long (%u bytes)", i,
+				segs[i]->pkt_len);
+		out_hdr_len = in_hdr_len;
+		if (!is_tcp && is_ipv6 && tunnel == 0) {
+			/* A fragment header follows the IPv6 header */
+			out_hdr_len += RTE_IPV6_FRAG_HDR_SIZE;
+			TEST_ASSERT_EQUAL(segs[i]->l3_len,
+					pkt->l3_len + RTE_IPV6_FRAG_HDR_SIZE,
+					"Wrong l3_len of segment %u", i);
+			frag = rte_pktmbuf_mtod_offset(segs[i],
+					struct rte_ipv6_fragment_ext *,
+					inner_off + pkt->l3_len);
+			TEST_ASSERT_EQUAL(frag->next_header, IPPROTO_UDP,
+					"Wrong fragment next header");
+			TEST_ASSERT_EQUAL(rte_be_to_cpu_16(frag->frag_data),
+					RTE_IPV6_SET_FRAG_DATA(pyld_off,
+						i < nb_segs - 1),
+					"Wrong fragment data of segment %u", i);
+			if (i == 0)
+				frag_id = frag->id;
+			TEST_ASSERT_EQUAL(frag->id, frag_id,
+					"Fragments with different IDs");
+		}
+
+		/* Payload */
+		pyld_len = segs[i]->pkt_len - out_hdr_len;
+		TEST_ASSERT(pyld_len > 0, "Segment %u without payload", i);
+		in_data = rte_pktmbuf_read(pkt, in_hdr_len + pyld_off,
+				pyld_len, in_buf);
+		out_data = rte_pktmbuf_read(segs[i], out_hdr_len, pyld_len,
+				out_buf);
+		TEST_ASSERT(in_data != NULL && out_data != NULL &&
+				memcmp(in_data, out_data, pyld_len) == 0,
+				"Wrong payload in segment %u", i);
+
+		/* Headers */
+		if (tunnel != 0) {
+			TEST_ASSERT_SUCCESS(check_ip_len(segs[i], outer_off,
+					!!(ol_flags & PKT_TX_OUTER_IPV6)),
+					"Wrong outer IP header");
+			if (tunnel == PKT_TX_TUNNEL_VXLAN) {
+				udp = rte_pktmbuf_mtod_offset(segs[i],
+						struct rte_udp_hdr *,
+						outer_off + pkt->outer_l3_len);
+				TEST_ASSERT_EQUAL(
+					rte_be_to_cpu_16(udp->dgram_len),
+					segs[i]->pkt_len - outer_off -
+					pkt->outer_l3_len,
+					"Wrong outer UDP length");
+			}
+		}
+		TEST_ASSERT_SUCCESS(check_ip_len(segs[i], inner_off, is_ipv6),
+				"Wrong IP header");
+		if (!is_ipv6 && is_tcp) {
+			ipv4 = rte_pktmbuf_mtod_offset(segs[i],
+					struct rte_ipv4_hdr *, inner_off);
+			TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ipv4->packet_id),
+					FIRST_IP_ID + i, "Wrong IPv4 ID");
+		}
+		if (is_tcp) {
+			tcp = rte_pktmbuf_mtod_offset(segs[i],
+					struct rte_tcp_hdr *,
+					inner_off + pkt->l3_len);
+			TEST_ASSERT_EQUAL(rte_be_to_cpu_32(tcp->sent_seq),
+					FIRST_SEQ + pyld_off,
+					"Wrong TCP sequence number");
+			TEST_ASSERT_EQUAL(!!(tcp->tcp_flags & RTE_TCP_PSH_FLAG),
+					(i == nb_segs - 1),
+					"Wrong PSH flag in segment %u", i);
+		}
+		pyld_off += pyld_len;
+	}
+	TEST_ASSERT_EQUAL(in_hdr_len + pyld_off, pkt->pkt_len,
+			"Segments don't cover the packet");
+
+	return 0;
+}
+
+static int
+test_gso_type(uint64_t ol_flags, uint32_t gso_types)
+{
+	struct rte_gso_ctx ctx = {
+		.direct_pool = direct_pool,
+		.indirect_pool = indirect_pool,
+		.gso_types = gso_types,
+		.gso_size = GSO_SIZE,
+	};
+	struct rte_mbuf *segs[BURST];
+	struct rte_mbuf *pkt;
+	int ret;
+
+	pkt = build_pkt(pkt_pool, ol_flags, PAYLOAD_LEN);
+	TEST_ASSERT_NOT_NULL(pkt, "Failed to build packet");
+
+	ret = rte_gso_segment(pkt, &ctx, segs, BURST);
+	TEST_ASSERT(ret > 1, "Packet not segmented (ret=%d)", ret);
+	TEST_ASSERT((pkt->ol_flags & (PKT_TX_TCP_SEG | PKT_TX_UDP_SEG)) == 0,
+			"Segmentation flag not cleared");
+	TEST_ASSERT_SUCCESS(check_segments(pkt, ol_flags, segs, ret),
+			"Wrong GSO segments");
+	free_pkts(segs, ret);
+	rte_pktmbuf_free(pkt);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_gso_tcp6(void)
+{
+	return test_gso_type(PKT_TX_TCP_SEG | PKT_TX_IPV6,
+			DEV_TX_OFFLOAD_TCP_TSO);
+}
+
+static int
+test_gso_udp6(void)
+{
+	return test_gso_type(PKT_TX_UDP_SEG | PKT_TX_IPV6,
+			DEV_TX_OFFLOAD_UDP_TSO);
+}
+
+static int
+test_gso_ipv6_tunnels(void)
+{
+	static const uint64_t flags[] = {
+		PKT_TX_TCP_SEG | PKT_TX_IPV4 | PKT_TX_OUTER_IPV6 |
+			PKT_TX_TUNNEL_VXLAN,
+		PKT_TX_UDP_SEG | PKT_TX_IPV4 | PKT_TX_OUTER_IPV6 |
+			PKT_TX_TUNNEL_VXLAN,
+		PKT_TX_TCP_SEG | PKT_TX_IPV4 | PKT_TX_OUTER_IPV6 |
+			PKT_TX_TUNNEL_GRE,
+		PKT_TX_TCP_SEG | PKT_TX_IPV6 | PKT_TX_OUTER_IPV4 |
+			PKT_TX_TUNNEL_VXLAN,
+		PKT_TX_TCP_SEG | PKT_TX_IPV6 | PKT_TX_OUTER_IPV6 |
+			PKT_TX_TUNNEL_VXLAN,
+		PKT_TX_TCP_SEG | PKT_TX_IPV6 | PKT_TX_OUTER_IPV4 |
+			PKT_TX_TUNNEL_GRE,
+		PKT_TX_TCP_SEG | PKT_TX_IPV6 | PKT_TX_OUTER_IPV6 |
+			PKT_TX_TUNNEL_GRE,
+	};
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(flags); i++)
+		TEST_ASSERT_SUCCESS(test_gso_type(flags[i], TUNNEL_GSO_TYPES),
+				"Tunnel GSO failed (ol_flags=0x%" PRIx64 ")",
+				flags[i]);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Packets which are not processed:
+ *	- GSO type not enabled in the context
+ *	- UDP/IPv6 packets with extension headers
+ *	- segment size too small for the headers
+ */
+static int
+test_gso_ipv6_unsupported(void)
+{
+	struct rte_gso_ctx ctx = {
+		.direct_pool = direct_pool,
+		.indirect_pool = indirect_pool,
+		.gso_types = DEV_TX_OFFLOAD_UDP_TSO,
+		.gso_size = GSO_SIZE,
+	};
+	struct rte_mbuf *segs[BURST];
+	struct rte_mbuf *pkt;
+	int ret;
+
+	pkt = build_pkt(pkt_pool, PKT_TX_TCP_SEG | PKT_TX_IPV6, PAYLOAD_LEN);
+	TEST_ASSERT_NOT_NULL(pkt, "Failed to build packet");
+	ret = rte_gso_segment(pkt, &ctx, segs, BURST);
+	TEST_ASSERT_EQUAL(ret, 0, "TCP/IPv6 packet segmented without TSO");
+	rte_pktmbuf_free(pkt);
+
+	pkt = build_pkt(pkt_pool, PKT_TX_UDP_SEG | PKT_TX_IPV6, PAYLOAD_LEN);
+	TEST_ASSERT_NOT_NULL(pkt, "Failed to build packet");
+	pkt->l3_len += 8;
+	ret = rte_gso_segment(pkt, &ctx, segs, BURST);
+	TEST_ASSERT_EQUAL(ret, 0,
+			"UDP/IPv6 packet with ext headers segmented");
+	rte_pktmbuf_free(pkt);
+
+	pkt = build_pkt(pkt_pool, PKT_TX_UDP_SEG | PKT_TX_IPV6, PAYLOAD_LEN);
+	TEST_ASSERT_NOT_NULL(pkt, "Failed to build packet");
+	ctx.gso_size = RTE_GSO_UDP_SEG_SIZE_MIN;
+	ret = rte_gso_segment(pkt, &ctx, segs, BURST);
+	TEST_ASSERT_EQUAL(ret, -EINVAL,
+			"UDP/IPv6 packet segmented without room for payload");
+	TEST_ASSERT((pkt->ol_flags & PKT_TX_UDP_SEG) != 0,
+			"Segmentation flag not restored");
+	rte_pktmbuf_free(pkt);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_setup(void)
+{
+	if (pkt_pool == NULL) {
+		pkt_pool = rte_pktmbuf_pool_create("GSO_PKT_POOL",
+				NUM_BIG_MBUFS, 0, 0, BIG_BUF_SIZE,
+				SOCKET_ID_ANY);
+		if (pkt_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+	if (direct_pool == NULL) {
+		direct_pool = rte_pktmbuf_pool_create("GSO_DIRECT_POOL",
+				NUM_MBUFS, BURST, 0,
+				RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+		if (direct_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+	if (indirect_pool == NULL) {
+		indirect_pool = rte_pktmbuf_pool_create("GSO_INDIRECT_POOL",
+				NUM_MBUFS, BURST, 0, 0, SOCKET_ID_ANY);
+		if (indirect_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void
+test_teardown(void)
+{
+	rte_mempool_free(indirect_pool);
+	indirect_pool = NULL;
+	rte_mempool_free(direct_pool);
+	direct_pool = NULL;
+	rte_mempool_free(pkt_pool);
+	pkt_pool = NULL;
+}
+
+static struct unit_test_suite gso_test_suite = {
+	.setup = test_setup,
+	.teardown = test_teardown,
+	.suite_name = "GSO Unit Test Suite",
+	.unit_test_cases = {
+		TEST_CASE(test_gso_tcp6),
+		TEST_CASE(test_gso_udp6),
+		TEST_CASE(test_gso_ipv6_tunnels),
+		TEST_CASE(test_gso_ipv6_unsupported),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_gso(void)
+{
+	return unit_test_suite_runner(&gso_test_suite);
+}
+
+static int
+test_gso_perf_type(uint64_t ol_flags, const char *name)
+{
+	struct rte_gso_ctx ctx = {
+		.direct_pool = direct_pool,
+		.indirect_pool = indirect_pool,
+		.gso_types = TUNNEL_GSO_TYPES,
+		.gso_size = GSO_SIZE,
+	};
+	struct rte_mbuf *segs[BURST];
+	struct rte_mbuf *pkt;
+	uint64_t cycles = 0, nb_segs = 0, start;
+	unsigned int i;
+	int ret;
+
+	pkt = build_pkt(pkt_pool, ol_flags, PERF_PAYLOAD_LEN);
+	TEST_ASSERT_NOT_NULL(pkt, "Failed to build packet");
+
+	for (i = 0; i < PERF_ITERATIONS; i++) {
+		/* The flags are cleared by a successful segmentation */
+		pkt->ol_flags = ol_flags;
+		start = rte_rdtsc_precise();
+		ret = rte_gso_segment(pkt, &ctx, segs, BURST);
+		cycles += rte_rdtsc_precise() - start;
+		TEST_ASSERT(ret > 1, "Packet not segmented (ret=%d)", ret);
+		nb_segs += ret;
+		free_pkts(segs, ret);
+	}
+	rte_pktmbuf_free(pkt);
+
+	printf("%-24s %6.1f cycles/segment, %7.2f Msegments/s\n", name,
+			(double)cycles / nb_segs,
+			(double)nb_segs * rte_get_tsc_hz() / cycles / 1E6);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_gso_perf(void)
+{
+	static const struct {
+		uint64_t ol_flags;
+		const char *name;
+	} types[] = {
+		{ PKT_TX_TCP_SEG | PKT_TX_IPV4, "TCP/IPv4" },
+		{ PKT_TX_TCP_SEG | PKT_TX_IPV6, "TCP/IPv6" },
+		{ PKT_TX_UDP_SEG | PKT_TX_IPV4, "UDP/IPv4" },
+		{ PKT_TX_UDP_SEG | PKT_TX_IPV6, "UDP/IPv6" },
+		{ PKT_TX_TCP_SEG | PKT_TX_IPV4 | PKT_TX_OUTER_IPV4 |
+			PKT_TX_TUNNEL_VXLAN, "VxLAN/IPv4 TCP/IPv4" },
+		{ PKT_TX_TCP_SEG | PKT_TX_IPV4 | PKT_TX_OUTER_IPV6 |
+			PKT_TX_TUNNEL_VXLAN, "VxLAN/IPv6 TCP/IPv4" },
+		{ PKT_TX_TCP_SEG | PKT_TX_IPV6 | PKT_TX_OUTER_IPV6 |
+			PKT_TX_TUNNEL_VXLAN, "VxLAN/IPv6 TCP/IPv6" },
+		{ PKT_TX_TCP_SEG | PKT_TX_IPV6 | PKT_TX_OUTER_IPV6 |
+			PKT_TX_TUNNEL_GRE, "GRE/IPv6 TCP/IPv6" },
+	};
+	unsigned int i;
+	int ret = 0;
+
+	if (test_setup() < 0) {
+		test_teardown();
+		return TEST_FAILED;
+	}
+
+	printf("%u bytes of payload per packet, %u bytes segments\n",
+			PERF_PAYLOAD_LEN, GSO_SIZE);
+	for (i = 0; i < RTE_DIM(types); i++) {
+		ret = test_gso_perf_type(types[i].ol_flags, types[i].name);
+		if (ret != TEST_SUCCESS)
+			break;
+	}
+
+	test_teardown();
+
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(gso_autotest, test_gso);
+REGISTER_TEST_COMMAND(gso_perf_autotest, test_gso_perf);
@@ -997,6 +997,140 @@ static int test_extendable_bucket(void)
 	return 0;
 }
 
+/*
+ * Add and delete bursts of keys with the bulk APIs:
+ *	- bulk add: all keys added, unique positions
+ *	- bulk lookup: hit, data matches
+ *	- bulk add: update, same positions, updated data
+ *	- bulk delete of half of the keys: hit
+ *	- bulk lookup: miss for deleted keys, hit for the others
+ *	- bulk delete of all the keys: hit for remaining keys only
+ * With ext_table, all keys share one bucket and go to extendable buckets.
+ */
+static int test_bulk_add_delete(uint32_t ext_table)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_bulk",
+		.entries = 128,
+		.key_len = sizeof(struct flow_key), /* 13 */
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+	};
+	struct rte_hash *handle;
+	struct flow_key bulk_keys[RTE_HASH_LOOKUP_BULK_MAX];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	void *lkp_data[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t pos[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t expected_pos[RTE_HASH_LOOKUP_BULK_MAX];
+	uint64_t hit_mask;
+	unsigned int i, j;
+	int ret;
+
+	if (ext_table) {
+		params.hash_func = pseudo_hash;
+		params.extra_flag = RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	}
+
+	memset(bulk_keys, 0, sizeof(bulk_keys));
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++) {
+		bulk_keys[i].ip_src = i;
+		bulk_keys[i].port_dst = i;
+		key_ptrs[i] = &bulk_keys[i];
+		data[i] = (void *)(uintptr_t)i;
+	}
+
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	/* Add */
+	ret = rte_hash_add_key_bulk_data(handle, key_ptrs, data,
+					 RTE_HASH_LOOKUP_BULK_MAX, pos);
+	RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX,
+			"failed to bulk add keys (ret=%d)", ret);
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++) {
+		print_key_info("Add", &bulk_keys[i], pos[i]);
+		RETURN_IF_ERROR(pos[i] < 0,
+			"failed to add key (pos[%u]=%d)", i, pos[i]);
+		for (j = 0; j < i; j++)
+			RETURN_IF_ERROR(pos[j] == pos[i],
+				"same position for keys %u and %u", j, i);
+		expected_pos[i] = pos[i];
+	}
+
+	/* Lookup */
+	ret = rte_hash_lookup_bulk_data(handle, key_ptrs,
+				RTE_HASH_LOOKUP_BULK_MAX, &hit_mask, lkp_data);
+	RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX,
+			"failed to find keys (ret=%d)", ret);
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++)
+		RETURN_IF_ERROR(lkp_data[i] != data[i],
+			"wrong data for key %u", i);
+
+	/* Add - update */
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++)
+		data[i] = (void *)(uintptr_t)(i + RTE_HASH_LOOKUP_BULK_MAX);
+	ret = rte_hash_add_key_bulk_data(handle, key_ptrs, data,
+					 RTE_HASH_LOOKUP_BULK_MAX, pos);
+	RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX,
+			"failed to bulk update keys (ret=%d)", ret);
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++)
+		RETURN_IF_ERROR(pos[i] != expected_pos[i],
+			"failed to update key (pos[%u]=%d)", i, pos[i]);
+
+	ret = rte_hash_lookup_bulk_data(handle, key_ptrs,
+				RTE_HASH_LOOKUP_BULK_MAX, &hit_mask, lkp_data);
+	RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX,
+			"failed to find keys (ret=%d)", ret);
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++)
+		RETURN_IF_ERROR(lkp_data[i] != data[i],
+			"data not updated for key %u", i);
+
+	/* Delete the first half of the keys */
+	ret = rte_hash_del_key_bulk(handle, key_ptrs,
+				    RTE_HASH_LOOKUP_BULK_MAX / 2, pos);
+	RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX / 2,
+			"failed to bulk delete keys (ret=%d)", ret);
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX / 2; i++) {
+		print_key_info("Del", &bulk_keys[i], pos[i]);
+		RETURN_IF_ERROR(pos[i] != expected_pos[i],
+			"failed to delete key (pos[%u]=%d)", i, pos[i]);
+	}
+
+	ret = rte_hash_lookup_bulk(handle, key_ptrs,
+				   RTE_HASH_LOOKUP_BULK_MAX, pos);
+	RETURN_IF_ERROR(ret != 0, "failed to lookup keys (ret=%d)", ret);
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++) {
+		if (i < RTE_HASH_LOOKUP_BULK_MAX / 2)
+			RETURN_IF_ERROR(pos[i] != -ENOENT,
+				"found deleted key (pos[%u]=%d)", i, pos[i]);
+		else
+			RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to find key (pos[%u]=%d)", i, pos[i]);
+	}
+
+	/* Delete all the keys, only the second half is still present */
+	ret = rte_hash_del_key_bulk(handle, key_ptrs,
+				    RTE_HASH_LOOKUP_BULK_MAX, pos);
+	RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX / 2,
+			"failed to bulk delete keys (ret=%d)", ret);
+	for (i = 0; i < RTE_HASH_LOOKUP_BULK_MAX; i++) {
+		if (i < RTE_HASH_LOOKUP_BULK_MAX / 2)
+			RETURN_IF_ERROR(pos[i] != -ENOENT,
+				"deleted key twice (pos[%u]=%d)", i, pos[i]);
+		else
+			RETURN_IF_ERROR(pos[i] != expected_pos[i],
+				"failed to delete key (pos[%u]=%d)", i, pos[i]);
+	}
+	RETURN_IF_ERROR(rte_hash_count(handle) != 0,
+			"hash not empty after bulk delete");
+
+	rte_hash_free(handle);
+
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -2208,6 +2342,10 @@ test_hash(void)
 		return -1;
 	if (test_extendable_bucket() < 0)
 		return -1;
+	if (test_bulk_add_delete(0) < 0)
+		return -1;
+	if (test_bulk_add_delete(1) < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
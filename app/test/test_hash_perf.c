@@ -34,6 +34,8 @@ enum operations {
 	LOOKUP,
 	LOOKUP_MULTI,
 	DELETE,
+	ADD_BULK,
+	DELETE_BULK,
 	NUM_OPERATIONS
 };
 
@@ -313,6 +315,53 @@ timed_adds(unsigned int with_hash, unsigned int with_data,
 	return 0;
 }
 
+/*
+ * Add the keys in bursts with rte_hash_add_key_bulk_data().
+ * There is no bulk add with precomputed hash values, with_hash
+ * is only used to store the result.
+ */
+static int
+timed_adds_bulk(unsigned int with_hash, unsigned int with_data,
+				unsigned int table_index, unsigned int ext)
+{
+	unsigned int i, k, n;
+	const void *keys_burst[BURST_SIZE];
+	void *data_burst[BURST_SIZE];
+	int ret;
+	unsigned int keys_to_add;
+
+	if (!ext)
+		keys_to_add = KEYS_TO_ADD * ADD_PERCENT;
+	else
+		keys_to_add = KEYS_TO_ADD;
+
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < keys_to_add; i += n) {
+		n = RTE_MIN(keys_to_add - i, (unsigned int)BURST_SIZE);
+		for (k = 0; k < n; k++) {
+			keys_burst[k] = keys[i + k];
+			data_burst[k] = (void *) ((uintptr_t) signatures[i + k]);
+		}
+		ret = rte_hash_add_key_bulk_data(h[table_index],
+					keys_burst,
+					with_data ? data_burst : NULL,
+					n, &positions[i]);
+		if (ret != (int)n) {
+			printf("Expect to add %u keys, but added %d\n", n, ret);
+			return -1;
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[table_index][ADD_BULK][with_hash][with_data] =
+		time_taken/keys_to_add;
+
+	return 0;
+}
+
 static int
 timed_lookups(unsigned int with_hash, unsigned int with_data,
 				unsigned int table_index, unsigned int ext)
@@ -555,6 +604,45 @@ timed_deletes(unsigned int with_hash, unsigned int with_data,
 	return 0;
 }
 
+/* Delete the keys in bursts with rte_hash_del_key_bulk(). */
+static int
+timed_deletes_bulk(unsigned int with_hash, unsigned int with_data,
+				unsigned int table_index, unsigned int ext)
+{
+	unsigned int i, k, n;
+	const void *keys_burst[BURST_SIZE];
+	int ret;
+	unsigned int keys_to_add;
+
+	if (!ext)
+		keys_to_add = KEYS_TO_ADD * ADD_PERCENT;
+	else
+		keys_to_add = KEYS_TO_ADD;
+
+	const uint64_t start_tsc = rte_rdtsc();
+
+	for (i = 0; i < keys_to_add; i += n) {
+		n = RTE_MIN(keys_to_add - i, (unsigned int)BURST_SIZE);
+		for (k = 0; k < n; k++)
+			keys_burst[k] = keys[i + k];
+		ret = rte_hash_del_key_bulk(h[table_index], keys_burst, n,
+					    &positions[i]);
+		if (ret != (int)n) {
+			printf("Expect to delete %u keys, but deleted %d\n",
+				n, ret);
+			return -1;
+		}
+	}
+
+	const uint64_t end_tsc = rte_rdtsc();
+	const uint64_t time_taken = end_tsc - start_tsc;
+
+	cycles[table_index][DELETE_BULK][with_hash][with_data] =
+		time_taken/keys_to_add;
+
+	return 0;
+}
+
 static void
 free_table(unsigned table_index)
 {
@@ -600,6 +688,14 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 				if (timed_deletes(with_hash, with_data, i, ext) < 0)
 					return -1;
 
+				if (timed_adds_bulk(with_hash, with_data,
+						i, ext) < 0)
+					return -1;
+
+				if (timed_deletes_bulk(with_hash, with_data,
+						i, ext) < 0)
+					return -1;
+
 				/* Print a dot to show progress on operations */
 				printf(".");
 				fflush(stdout);
@@ -623,8 +719,9 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 			else
 				printf("\nWithout pre-computed hash values\n");
 
-			printf("\n%-18s%-18s%-18s%-18s%-18s\n",
-			"Keysize", "Add", "Lookup", "Lookup_bulk", "Delete");
+			printf("\n%-18s%-18s%-18s%-18s%-18s%-18s%-18s\n",
+			"Keysize", "Add", "Lookup", "Lookup_bulk", "Delete",
+			"Add_bulk", "Delete_bulk");
 			for (i = 0; i < NUM_KEYSIZES; i++) {
 				printf("%-18d", hashtest_key_lens[i]);
 				for (j = 0; j < NUM_OPERATIONS; j++)
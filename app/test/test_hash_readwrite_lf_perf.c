@@ -62,6 +62,7 @@ struct rwc_perf {
 	uint32_t multi_rw[NUM_TEST - 1][2][NUM_TEST];
 	uint32_t w_ks_r_hit_extbkt[2][NUM_TEST];
 	uint32_t writer_add_del[NUM_TEST];
+	uint32_t writer_add_del_bulk[NUM_TEST];
 };
 
 static struct rwc_perf rwc_lf_results, rwc_non_lf_results;
@@ -1287,14 +1288,47 @@ test_hash_rcu_qsbr_writer(void *arg)
 	return 0;
 }
 
+/*
+ * Writer thread using rte_hash data structure with RCU,
+ * deleting and adding keys in bursts
+ */
+static int
+test_hash_rcu_qsbr_writer_bulk(void *arg)
+{
+	uint32_t i, j, n, offset, end;
+	uint64_t begin, cycles;
+	const void *keys_burst[BULK_LOOKUP_SIZE];
+	int32_t pos[BULK_LOOKUP_SIZE];
+	uint8_t pos_core = (uint32_t)((uintptr_t)arg);
+	offset = pos_core * tbl_rwc_test_param.single_insert;
+	end = offset + tbl_rwc_test_param.single_insert;
+
+	begin = rte_rdtsc_precise();
+	for (i = offset; i < end; i += n) {
+		n = RTE_MIN(end - i, (uint32_t)BULK_LOOKUP_SIZE);
+		for (j = 0; j < n; j++)
+			keys_burst[j] = tbl_rwc_test_param.keys_no_ks + i + j;
+		/* Delete elements from the shared data structure */
+		rte_hash_del_key_bulk(tbl_rwc_test_param.h, keys_burst, n,
+				      pos);
+		rte_hash_add_key_bulk_data(tbl_rwc_test_param.h, keys_burst,
+					   NULL, n, pos);
+	}
+	cycles = rte_rdtsc_precise() - begin;
+	__atomic_fetch_add(&gwrite_cycles, cycles, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&gwrites, tbl_rwc_test_param.single_insert,
+			   __ATOMIC_RELAXED);
+	return 0;
+}
+
 /*
  * Writer perf test with RCU QSBR in DQ mode:
- * Writer(s) delete and add keys in the table.
+ * Writer(s) delete and add keys in the table, one by one or in bursts.
  * Readers lookup keys in the hash table
  */
 static int
 test_hash_rcu_qsbr_writer_perf(struct rwc_perf *rwc_perf_results, int rwc_lf,
-				int htm, int ext_bkt)
+				int htm, int ext_bkt, int bulk)
 {
 	unsigned int n;
 	uint64_t i;
@@ -1304,7 +1338,8 @@ test_hash_rcu_qsbr_writer_perf(struct rwc_perf *rwc_perf_results, int rwc_lf,
 	uint32_t sz;
 	uint8_t pos_core;
 
-	printf("\nTest: Writer perf with integrated RCU\n");
+	printf("\nTest: Writer perf with integrated RCU%s\n",
+		bulk ? " (bulk add/delete)" : "");
 
 	if (init_params(rwc_lf, use_jhash, htm, ext_bkt) != 0)
 		goto err;
@@ -1342,6 +1377,7 @@ test_hash_rcu_qsbr_writer_perf(struct rwc_perf *rwc_perf_results, int rwc_lf,
 		if (write_keys(write_type) < 0)
 			goto err;
 
+		writer_done = 0;
 		/* Launch 2 readers */
 		for (i = 1; i <= 2; i++)
 			rte_eal_remote_launch(test_hash_rcu_qsbr_reader, NULL,
@@ -1349,7 +1385,9 @@ test_hash_rcu_qsbr_writer_perf(struct rwc_perf *rwc_perf_results, int rwc_lf,
 		pos_core = 0;
 		/* Launch writer(s) */
 		for (; i <= rwc_core_cnt[n] + 2; i++) {
-			rte_eal_remote_launch(test_hash_rcu_qsbr_writer,
+			rte_eal_remote_launch(bulk ?
+				test_hash_rcu_qsbr_writer_bulk :
+				test_hash_rcu_qsbr_writer,
 				(void *)(uintptr_t)pos_core,
 				enabled_core_ids[i]);
 			pos_core++;
@@ -1367,7 +1405,11 @@ test_hash_rcu_qsbr_writer_perf(struct rwc_perf *rwc_perf_results, int rwc_lf,
 		unsigned long long cycles_per_write_operation =
 			__atomic_load_n(&gwrite_cycles, __ATOMIC_RELAXED) /
 			__atomic_load_n(&gwrites, __ATOMIC_RELAXED);
-		rwc_perf_results->writer_add_del[n]
+		if (bulk)
+			rwc_perf_results->writer_add_del_bulk[n]
+					= cycles_per_write_operation;
+		else
+			rwc_perf_results->writer_add_del[n]
 					= cycles_per_write_operation;
 		printf("Cycles per write operation: %llu\n",
 				cycles_per_write_operation);
@@ -1446,7 +1488,10 @@ test_hash_readwrite_lf_perf_main(void)
 							htm, ext_bkt) < 0)
 			return -1;
 		if (test_hash_rcu_qsbr_writer_perf(&rwc_lf_results, rwc_lf,
-						   htm, ext_bkt) < 0)
+						   htm, ext_bkt, 0) < 0)
+			return -1;
+		if (test_hash_rcu_qsbr_writer_perf(&rwc_lf_results, rwc_lf,
+						   htm, ext_bkt, 1) < 0)
 			return -1;
 	}
 	printf("\nTest lookup with read-write concurrency lock free support"
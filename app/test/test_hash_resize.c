@@ -0,0 +1,529 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_hash.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
+
+#include "test.h"
+
+/*
+ * Hash table resize
+ * =================
+ *
+ * #. Functional test: keys are added, updated and deleted between the
+ *    migration steps of a resize, with and without extendable buckets.
+ *    After each step, every key must be found with its last data by the
+ *    single and bulk lookups, and returned once by the iterator.
+ *
+ * #. Lock-free test: the worker lcores look a set of keys up while the
+ *    main lcore grows the table twice, adding and deleting other keys.
+ *    The readers must always find the keys of the set, and the integrated
+ *    RCU QSBR must free the data of the deleted keys only, once.
+ */
+
+#define NB_KEYS 4096
+#define INIT_ENTRIES 256
+#define INIT_KEYS 200
+#define RESIZE_ENTRIES 4096
+#define BULK 64
+
+/* data of the key, 0 if the key is not in the table */
+static uintptr_t expected[NB_KEYS];
+static uint8_t seen[NB_KEYS];
+
+static struct rte_hash *
+create_table(const char *name, uint32_t entries, uint8_t extra_flag)
+{
+	struct rte_hash_parameters params = {
+		.name = name,
+		.entries = entries,
+		.key_len = sizeof(uint32_t),
+		.socket_id = SOCKET_ID_ANY,
+		.extra_flag = extra_flag,
+	};
+
+	return rte_hash_create(&params);
+}
+
+static inline void *
+key_data(uint32_t key, unsigned int version)
+{
+	return (void *)(((uintptr_t)version << 16) | (key + 1));
+}
+
+static int
+add_key(struct rte_hash *h, uint32_t key, unsigned int version)
+{
+	int ret;
+
+	ret = rte_hash_add_key_data(h, &key, key_data(key, version));
+	if (ret == 0)
+		expected[key] = (uintptr_t)key_data(key, version);
+	return ret;
+}
+
+static int
+del_key(struct rte_hash *h, uint32_t key)
+{
+	int ret;
+
+	ret = rte_hash_del_key(h, &key);
+	if ((ret >= 0) != (expected[key] != 0)) {
+		printf("key %u: delete returned %d\n", key, ret);
+		return -1;
+	}
+	expected[key] = 0;
+	return 0;
+}
+
+/* check the content of the table with all the lookup functions */
+static int
+check_table(const struct rte_hash *h)
+{
+	uint32_t bulk_keys[BULK];
+	const void *keys[BULK];
+	void *data[BULK];
+	uint32_t i, j, key, next;
+	uint64_t hit_mask;
+	const void *k;
+	unsigned int nb_keys = 0;
+	void *d;
+	int ret;
+
+	for (key = 0; key < NB_KEYS; key++) {
+		ret = rte_hash_lookup_data(h, &key, &d);
+		if (expected[key] == 0 && ret != -ENOENT) {
+			printf("key %u: deleted key found\n", key);
+			return -1;
+		}
+		if (expected[key] != 0 &&
+				(ret < 0 || (uintptr_t)d != expected[key])) {
+			printf("key %u: lookup returned %d, data %p instead of %p\n",
+				key, ret, d, (void *)expected[key]);
+			return -1;
+		}
+		if (expected[key] != 0)
+			nb_keys++;
+	}
+
+	if (rte_hash_count(h) != (int32_t)nb_keys) {
+		printf("count %d instead of %u\n", rte_hash_count(h), nb_keys);
+		return -1;
+	}
+
+	for (i = 0; i < NB_KEYS; i += BULK) {
+		for (j = 0; j < BULK; j++) {
+			bulk_keys[j] = i + j;
+			keys[j] = &bulk_keys[j];
+		}
+		ret = rte_hash_lookup_bulk_data(h, keys, BULK, &hit_mask, data);
+		for (j = 0; j < BULK; j++) {
+			if (expected[i + j] == 0 && (hit_mask & (1ULL << j))) {
+				printf("key %u: deleted key found by bulk lookup\n",
+					i + j);
+				return -1;
+			}
+			if (expected[i + j] != 0 &&
+					(!(hit_mask & (1ULL << j)) ||
+					 (uintptr_t)data[j] != expected[i + j])) {
+				printf("key %u: bulk lookup failed\n", i + j);
+				return -1;
+			}
+		}
+	}
+
+	memset(seen, 0, sizeof(seen));
+	next = 0;
+	while (rte_hash_iterate(h, &k, &d, &next) >= 0) {
+		key = *(const uint32_t *)k;
+		if (key >= NB_KEYS || seen[key] != 0 ||
+				(uintptr_t)d != expected[key]) {
+			printf("key %u: iteration failed\n", key);
+			return -1;
+		}
+		seen[key] = 1;
+		nb_keys--;
+	}
+	if (nb_keys != 0) {
+		printf("%u keys missed by the iteration\n", nb_keys);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+test_resize_functional(uint8_t ext_bkt)
+{
+	uint32_t bulk_keys[4];
+	const void *keys[4];
+	void *data[4];
+	int32_t positions[4];
+	struct rte_hash *h;
+	unsigned int step;
+	uint32_t key, i;
+	void *k;
+	int ret;
+
+	printf("resize test %s extendable buckets\n",
+		ext_bkt ? "with" : "without");
+	memset(expected, 0, sizeof(expected));
+
+	h = create_table("resize_func", INIT_ENTRIES,
+			ext_bkt ? RTE_HASH_EXTRA_FLAGS_EXT_TABLE : 0);
+	TEST_ASSERT_NOT_NULL(h, "cannot create hash table");
+
+	for (key = 0; key < INIT_KEYS; key++)
+		TEST_ASSERT_SUCCESS(add_key(h, key, 0), "cannot add key %u",
+				key);
+	TEST_ASSERT_SUCCESS(check_table(h), "wrong table content");
+
+	TEST_ASSERT_EQUAL(rte_hash_resize(h, INIT_ENTRIES / 2), -EINVAL,
+			"shrink not rejected");
+	TEST_ASSERT_SUCCESS(rte_hash_resize(h, RESIZE_ENTRIES),
+			"cannot start resize");
+	TEST_ASSERT_EQUAL(rte_hash_resize(h, 2 * RESIZE_ENTRIES), -EBUSY,
+			"second resize not rejected");
+	TEST_ASSERT_EQUAL(rte_hash_get_key_with_position(h, 0, &k), -EBUSY,
+			"position lookup not rejected");
+
+	/* update, delete and add keys between the migration steps */
+	key = INIT_KEYS;
+	step = 0;
+	do {
+		TEST_ASSERT_SUCCESS(add_key(h, (step * 3) % INIT_KEYS,
+				step + 1), "cannot update key");
+		TEST_ASSERT_SUCCESS(del_key(h, (step * 7 + 1) % INIT_KEYS),
+				"cannot delete key");
+
+		for (i = 0; i < RTE_DIM(bulk_keys); i++) {
+			bulk_keys[i] = key + i;
+			keys[i] = &bulk_keys[i];
+			data[i] = key_data(key + i, 0);
+		}
+		TEST_ASSERT_EQUAL(rte_hash_add_key_bulk_data(h, keys, data,
+				RTE_DIM(bulk_keys), positions),
+				(int)RTE_DIM(bulk_keys), "cannot add keys");
+		for (i = 0; i < RTE_DIM(bulk_keys); i++)
+			expected[key + i] = (uintptr_t)data[i];
+		TEST_ASSERT_EQUAL(rte_hash_del_key_bulk(h, keys, 1, positions),
+				1, "cannot delete key");
+		expected[key] = 0;
+		key += RTE_DIM(bulk_keys);
+
+		TEST_ASSERT_SUCCESS(check_table(h),
+				"wrong table content before step %u", step);
+		ret = rte_hash_resize_step(h, 1);
+		TEST_ASSERT(ret >= 0, "resize step %u failed", step);
+		step++;
+	} while (ret > 0);
+
+	TEST_ASSERT_EQUAL(step, INIT_ENTRIES / 8, "wrong number of steps");
+	TEST_ASSERT_SUCCESS(check_table(h), "wrong table content");
+	TEST_ASSERT_EQUAL(rte_hash_resize_step(h, 1), 0,
+			"resize not complete");
+
+	/* fill the larger table */
+	for (; key < RESIZE_ENTRIES * 3 / 4; key++)
+		TEST_ASSERT_SUCCESS(add_key(h, key, 0), "cannot add key %u",
+				key);
+	TEST_ASSERT_SUCCESS(check_table(h), "wrong table content");
+
+	/* the table can be resized again */
+	TEST_ASSERT_SUCCESS(rte_hash_resize(h, 2 * RESIZE_ENTRIES),
+			"cannot start resize");
+	TEST_ASSERT_EQUAL(rte_hash_resize_step(h, UINT32_MAX), 0,
+			"resize not complete");
+	TEST_ASSERT_SUCCESS(check_table(h), "wrong table content");
+
+	/* a reset ends a resize */
+	TEST_ASSERT_SUCCESS(rte_hash_resize(h, 4 * RESIZE_ENTRIES),
+			"cannot start resize");
+	rte_hash_reset(h);
+	memset(expected, 0, sizeof(expected));
+	TEST_ASSERT_SUCCESS(check_table(h), "wrong table content");
+	TEST_ASSERT_EQUAL(rte_hash_resize_step(h, 0), 0,
+			"resize not ended by reset");
+
+	rte_hash_free(h);
+
+	return 0;
+}
+
+static int
+test_resize_unsupported(void)
+{
+	struct rte_hash *h;
+	hash_sig_t sig;
+	uint32_t key;
+	void *data;
+
+	h = create_table("resize_mw", INIT_ENTRIES,
+			RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD);
+	TEST_ASSERT_NOT_NULL(h, "cannot create hash table");
+	TEST_ASSERT_EQUAL(rte_hash_resize(h, RESIZE_ENTRIES), -ENOTSUP,
+			"resize of multi-writer table not rejected");
+	rte_hash_free(h);
+
+	h = create_table("resize_lf", INIT_ENTRIES,
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF);
+	TEST_ASSERT_NOT_NULL(h, "cannot create hash table");
+	TEST_ASSERT_EQUAL(rte_hash_resize(h, RESIZE_ENTRIES), -ENOTSUP,
+			"resize of lock-free table without RCU not rejected");
+	rte_hash_free(h);
+
+	/* a key added with its hash is migrated */
+	h = create_table("resize_sig", INIT_ENTRIES, 0);
+	TEST_ASSERT_NOT_NULL(h, "cannot create hash table");
+	key = 1;
+	sig = rte_hash_hash(h, &key);
+	TEST_ASSERT(rte_hash_add_key_with_hash_data(h, &key, sig,
+			key_data(key, 0)) == 0, "cannot add key");
+	TEST_ASSERT_EQUAL(rte_hash_resize(h, RESIZE_ENTRIES), 0,
+			"resize of table with hashed keys failed");
+	TEST_ASSERT_EQUAL(rte_hash_resize_step(h, INIT_ENTRIES), 0,
+			"resize not complete");
+	TEST_ASSERT(rte_hash_lookup_with_hash_data(h, &key, sig, &data) >= 0 &&
+			data == key_data(key, 0), "key lost by resize");
+
+	/* a key added with another signature cannot be */
+	key = 2;
+	TEST_ASSERT(rte_hash_add_key_with_hash_data(h, &key,
+			~rte_hash_hash(h, &key), key_data(key, 0)) == 0,
+			"cannot add key");
+	TEST_ASSERT_EQUAL(rte_hash_resize(h, 2 * RESIZE_ENTRIES), -ENOTSUP,
+			"resize of table with external signatures not rejected");
+	rte_hash_free(h);
+
+	return 0;
+}
+
+#define LF_STABLE_KEYS 1024
+#define LF_LIVE_KEYS 8
+
+static struct rte_hash *lf_hash;
+static struct rte_rcu_qsbr *lf_qsv;
+static uint32_t lf_writer_done;
+static uint32_t lf_reader_errors;
+static uint8_t lf_deleted[NB_KEYS];
+static unsigned int lf_freed;
+static unsigned int lf_free_errors;
+
+static void
+lf_free_key_data(void *p __rte_unused, void *key_data)
+{
+	uint32_t key = (uint32_t)(uintptr_t)key_data - 1;
+
+	/* only the data of a deleted key is freed, once */
+	if (key < LF_STABLE_KEYS || key >= NB_KEYS || lf_deleted[key] != 1)
+		lf_free_errors++;
+	else
+		lf_deleted[key] = 2;
+	lf_freed++;
+}
+
+static int
+lf_reader(void *arg __rte_unused)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	uint32_t bulk_keys[BULK];
+	const void *keys[BULK];
+	void *data[BULK];
+	uint64_t hit_mask;
+	uint32_t key, i;
+	void *d;
+	int ret;
+
+	rte_rcu_qsbr_thread_register(lf_qsv, lcore_id);
+	rte_rcu_qsbr_thread_online(lf_qsv, lcore_id);
+
+	do {
+		for (key = 0; key < LF_STABLE_KEYS; key++) {
+			ret = rte_hash_lookup_data(lf_hash, &key, &d);
+			if (ret < 0 || (uintptr_t)d != key + 1)
+				__atomic_fetch_add(&lf_reader_errors, 1,
+						__ATOMIC_RELAXED);
+		}
+
+		for (key = 0; key < LF_STABLE_KEYS; key += BULK) {
+			for (i = 0; i < BULK; i++) {
+				bulk_keys[i] = key + i;
+				keys[i] = &bulk_keys[i];
+			}
+			rte_hash_lookup_bulk_data(lf_hash, keys, BULK,
+					&hit_mask, data);
+			for (i = 0; i < BULK; i++) {
+				if (!(hit_mask & (1ULL << i)) ||
+						(uintptr_t)data[i] != key + i + 1)
+					__atomic_fetch_add(&lf_reader_errors, 1,
+							__ATOMIC_RELAXED);
+			}
+		}
+
+		rte_rcu_qsbr_quiescent(lf_qsv, lcore_id);
+	} while (!__atomic_load_n(&lf_writer_done, __ATOMIC_ACQUIRE));
+
+	rte_rcu_qsbr_thread_offline(lf_qsv, lcore_id);
+	rte_rcu_qsbr_thread_unregister(lf_qsv, lcore_id);
+
+	return 0;
+}
+
+static int
+test_resize_lock_free(uint8_t ext_bkt)
+{
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	uint32_t entries = LF_STABLE_KEYS + 64;
+	unsigned int round, nb_deleted = 0;
+	uint32_t key, live;
+	int ret = -1;
+	size_t sz;
+
+	if (rte_lcore_count() < 2) {
+		printf("not enough lcores for the lock-free resize test\n");
+		return TEST_SKIPPED;
+	}
+
+	printf("lock-free resize test %s extendable buckets\n",
+		ext_bkt ? "with" : "without");
+
+	lf_writer_done = 0;
+	lf_reader_errors = 0;
+	lf_freed = 0;
+	lf_free_errors = 0;
+	memset(lf_deleted, 0, sizeof(lf_deleted));
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	lf_qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (lf_qsv == NULL || rte_rcu_qsbr_init(lf_qsv, RTE_MAX_LCORE) != 0) {
+		printf("cannot create the RCU QSBR variable\n");
+		goto out;
+	}
+
+	lf_hash = create_table("resize_lf", entries,
+			RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+			(ext_bkt ? RTE_HASH_EXTRA_FLAGS_EXT_TABLE : 0));
+	if (lf_hash == NULL) {
+		printf("cannot create hash table\n");
+		goto out;
+	}
+
+	rcu_cfg.v = lf_qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+	rcu_cfg.free_key_data_func = lf_free_key_data;
+	if (rte_hash_rcu_qsbr_add(lf_hash, &rcu_cfg) != 0) {
+		printf("cannot attach RCU QSBR to the hash table\n");
+		goto out;
+	}
+
+	for (key = 0; key < LF_STABLE_KEYS; key++) {
+		if (rte_hash_add_key_data(lf_hash, &key,
+				(void *)(uintptr_t)(key + 1)) != 0) {
+			printf("cannot add key %u\n", key);
+			goto out;
+		}
+	}
+
+	rte_eal_mp_remote_launch(lf_reader, NULL, SKIP_MAIN);
+
+	/* grow the table twice, adding and deleting keys between the
+	 * migration steps
+	 */
+	live = LF_STABLE_KEYS;
+	key = LF_STABLE_KEYS;
+	for (round = 0; round < 2; round++) {
+		entries *= 4;
+		if (rte_hash_resize(lf_hash, entries) != 0) {
+			printf("cannot start resize to %u entries\n", entries);
+			goto out_stop;
+		}
+
+		do {
+			if (key == NB_KEYS) {
+				printf("not enough keys\n");
+				goto out_stop;
+			}
+			if (rte_hash_add_key_data(lf_hash, &key,
+					(void *)(uintptr_t)(key + 1)) != 0) {
+				printf("cannot add key %u\n", key);
+				goto out_stop;
+			}
+			key++;
+			if (key - live > LF_LIVE_KEYS) {
+				if (rte_hash_del_key(lf_hash, &live) < 0) {
+					printf("cannot delete key %u\n", live);
+					goto out_stop;
+				}
+				lf_deleted[live] = 1;
+				nb_deleted++;
+				live++;
+			}
+
+			ret = rte_hash_resize_step(lf_hash, 1);
+			if (ret < 0) {
+				printf("resize step failed\n");
+				goto out_stop;
+			}
+		} while (ret > 0);
+	}
+
+out_stop:
+	__atomic_store_n(&lf_writer_done, 1, __ATOMIC_RELEASE);
+	rte_eal_mp_wait_lcore();
+	if (ret != 0)
+		goto out;
+	ret = -1;
+
+	if (lf_reader_errors != 0) {
+		printf("readers missed %u keys\n", lf_reader_errors);
+		goto out;
+	}
+	if (lf_free_errors != 0 || lf_freed != nb_deleted) {
+		printf("%u data freed for %u deleted keys, %u wrongly\n",
+			lf_freed, nb_deleted, lf_free_errors);
+		goto out;
+	}
+	if (rte_hash_count(lf_hash) != (int32_t)(LF_STABLE_KEYS + key - live)) {
+		printf("count %d instead of %u\n", rte_hash_count(lf_hash),
+			LF_STABLE_KEYS + key - live);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	rte_hash_free(lf_hash);
+	lf_hash = NULL;
+	rte_free(lf_qsv);
+	lf_qsv = NULL;
+	return ret;
+}
+
+static int
+test_hash_resize(void)
+{
+	int ret;
+
+	if (test_resize_functional(0) < 0 || test_resize_functional(1) < 0)
+		return -1;
+
+	if (test_resize_unsupported() < 0)
+		return -1;
+
+	ret = test_resize_lock_free(0);
+	if (ret != 0)
+		return ret;
+
+	return test_resize_lock_free(1);
+}
+
+REGISTER_TEST_COMMAND(hash_resize_autotest, test_hash_resize);
@@ -13,7 +13,10 @@
 #include "sample_packet_forward.h"
 #include "test.h"
 
-#define NUM_STATS 4
+#define NUM_STATS 8
+#define MIN_LATENCY 0
+#define MAX_LATENCY 2
+#define FIRST_PERCENTILE 4
 #define LATENCY_NUM_PACKETS 10
 #define QUEUE_ID 0
 
@@ -25,6 +28,10 @@ static struct rte_metric_name lat_stats_strings[] = {
 	{"avg_latency_ns"},
 	{"max_latency_ns"},
 	{"jitter_ns"},
+	{"p50_latency_ns"},
+	{"p90_latency_ns"},
+	{"p99_latency_ns"},
+	{"p99_9_latency_ns"},
 };
 
 /* Test case for latency init with metrics init */
@@ -80,7 +87,7 @@ static int test_latencystats_get_names(void)
 	/* Success Test: Valid names and size */
 	size = NUM_STATS;
 	ret = rte_latencystats_get_names(names, size);
-	for (i = 0; i <= NUM_STATS; i++) {
+	for (i = 0; i < NUM_STATS; i++) {
 		if (strcmp(lat_stats_strings[i].name, names[i].name) == 0)
 			printf(" %s\n", names[i].name);
 		else
@@ -119,6 +126,17 @@ static int test_latencystats_get(void)
 	TEST_ASSERT((ret == NUM_STATS), "Test Failed to get latency metrics"
 			" values");
 
+	/* Percentiles are ordered and within the min and max latency */
+	for (i = FIRST_PERCENTILE; i < NUM_STATS; i++) {
+		uint64_t lower = values[i == FIRST_PERCENTILE ?
+					MIN_LATENCY : i - 1].value;
+
+		TEST_ASSERT(values[i].value >= lower &&
+			    values[i].value <= values[MAX_LATENCY].value,
+			    "Test Failed: %s out of order",
+			    lat_stats_strings[i].name);
+	}
+
 	/* Failure Test: Invalid values and valid size */
 	ret = rte_latencystats_get(NULL, size);
 	TEST_ASSERT((ret == NUM_STATS), "Test Failed to get the stats count,"
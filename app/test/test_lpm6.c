@@ -8,6 +8,7 @@
 #include <string.h>
 
 #include <rte_memory.h>
+#include <rte_random.h>
 #include <rte_lpm6.h>
 
 #include "test.h"
@@ -51,6 +52,7 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -83,6 +85,7 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
 };
 
 #define MAX_DEPTH                                                    128
@@ -90,6 +93,7 @@ rte_lpm6_test tests6[] = {
 #define NUMBER_TBL8S                                           (1 << 16)
 #define MAX_NUM_TBL8S                                          (1 << 21)
 #define PASS 0
+#define NUM_BULK_IPS                                                1007
 
 static void
 IPv6(uint8_t *ip, uint8_t b1, uint8_t b2, uint8_t b3, uint8_t b4, uint8_t b5,
@@ -1770,6 +1774,88 @@ test28(void)
 	return PASS;
 }
 
+/*
+ * Add the set of random routes used by test25 and look up a batch of
+ * addresses, half of them matching the routes and half of them random,
+ * with every bulk lookup implementation supported on this machine.
+ * Checks that the results are the same as the ones of rte_lpm6_lookup().
+ * The batch size is not a multiple of the lookup widths, so that the
+ * tail handling is covered as well.
+ */
+int32_t
+test29(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	static uint8_t ips[NUM_BULK_IPS][RTE_LPM6_IPV6_ADDR_SIZE];
+	int32_t next_hops[NUM_BULK_IPS];
+	int32_t next_hops_expected[NUM_BULK_IPS];
+	const enum rte_lpm6_lookup_type types[] = {
+		RTE_LPM6_LOOKUP_DEFAULT,
+		RTE_LPM6_LOOKUP_SCALAR,
+		RTE_LPM6_LOOKUP_SCALAR_X4,
+		RTE_LPM6_LOOKUP_SCALAR_X8,
+		RTE_LPM6_LOOKUP_VECTOR_AVX512,
+	};
+	const uint32_t sizes[] = { 1, 15, 17, NUM_BULK_IPS };
+	uint32_t i, j, next_hop_return;
+	int32_t status = 0;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	status = rte_lpm6_select_lookup(lpm, RTE_LPM6_LOOKUP_VECTOR_AVX512 + 1);
+	TEST_LPM_ASSERT(status == -EINVAL);
+
+	for (i = 0; i < 1000; i++) {
+		status = rte_lpm6_add(lpm, large_route_table[i].ip,
+				large_route_table[i].depth,
+				large_route_table[i].next_hop);
+		TEST_LPM_ASSERT(status == 0);
+	}
+
+	/* generate large IPS table and expected next_hops */
+	generate_large_ips_table(1);
+
+	for (i = 0; i < NUM_BULK_IPS; i++) {
+		if (i % 2 == 0) {
+			memcpy(ips[i], large_ips_table[i].ip, 16);
+			next_hops_expected[i] = large_ips_table[i].next_hop;
+		} else {
+			for (j = 0; j < 16; j++)
+				ips[i][j] = rte_rand();
+			status = rte_lpm6_lookup(lpm, ips[i], &next_hop_return);
+			next_hops_expected[i] = (status == 0) ?
+					(int32_t)next_hop_return : -1;
+		}
+	}
+
+	for (i = 0; i < RTE_DIM(types); i++) {
+		if (rte_lpm6_select_lookup(lpm, types[i]) != 0) {
+			/* only the vector implementation can be unsupported */
+			TEST_LPM_ASSERT(types[i] == RTE_LPM6_LOOKUP_VECTOR_AVX512);
+			continue;
+		}
+
+		for (j = 0; j < RTE_DIM(sizes); j++) {
+			memset(next_hops, 0, sizeof(next_hops));
+			status = rte_lpm6_lookup_bulk_func(lpm, ips, next_hops,
+					sizes[j]);
+			TEST_LPM_ASSERT(status == 0);
+			TEST_LPM_ASSERT(memcmp(next_hops, next_hops_expected,
+					sizes[j] * sizeof(next_hops[0])) == 0);
+		}
+	}
+
+	rte_lpm6_free(lpm);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
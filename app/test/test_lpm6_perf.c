@@ -50,13 +50,23 @@ print_route_distribution(const struct rules_tbl_entry *table, uint32_t n)
 	printf("\n");
 }
 
+static const struct {
+	enum rte_lpm6_lookup_type type;
+	const char *name;
+} lookup_types[] = {
+	{ RTE_LPM6_LOOKUP_SCALAR, "scalar" },
+	{ RTE_LPM6_LOOKUP_SCALAR_X4, "scalar x4" },
+	{ RTE_LPM6_LOOKUP_SCALAR_X8, "scalar x8" },
+	{ RTE_LPM6_LOOKUP_VECTOR_AVX512, "avx512" },
+};
+
 static int
 test_lpm6_perf(void)
 {
 	struct rte_lpm6 *lpm = NULL;
 	struct rte_lpm6_config config;
 	uint64_t begin, total_time;
-	unsigned i, j;
+	unsigned i, j, t;
 	uint32_t next_hop_add = 0xAA, next_hop_return = 0;
 	int status = 0;
 	int64_t count = 0;
@@ -114,30 +124,40 @@ test_lpm6_perf(void)
 			(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
 			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
 
-	/* Measure bulk Lookup */
-	total_time = 0;
-	count = 0;
-
+	/* Measure bulk Lookup with every implementation */
 	uint8_t ip_batch[NUM_IPS_ENTRIES][16];
 	int32_t next_hops[NUM_IPS_ENTRIES];
 
 	for (i = 0; i < NUM_IPS_ENTRIES; i++)
 		memcpy(ip_batch[i], large_ips_table[i].ip, 16);
 
-	for (i = 0; i < ITERATIONS; i ++) {
+	for (t = 0; t < RTE_DIM(lookup_types); t++) {
+		if (rte_lpm6_select_lookup(lpm, lookup_types[t].type) != 0) {
+			printf("BULK LPM Lookup (%s): not supported\n",
+					lookup_types[t].name);
+			continue;
+		}
 
-		/* Lookup per batch */
-		begin = rte_rdtsc();
-		rte_lpm6_lookup_bulk_func(lpm, ip_batch, next_hops, NUM_IPS_ENTRIES);
-		total_time += rte_rdtsc() - begin;
+		total_time = 0;
+		count = 0;
 
-		for (j = 0; j < NUM_IPS_ENTRIES; j++)
-			if (next_hops[j] < 0)
-				count++;
+		for (i = 0; i < ITERATIONS; i ++) {
+
+			/* Lookup per batch */
+			begin = rte_rdtsc();
+			rte_lpm6_lookup_bulk_func(lpm, ip_batch, next_hops,
+					NUM_IPS_ENTRIES);
+			total_time += rte_rdtsc() - begin;
+
+			for (j = 0; j < NUM_IPS_ENTRIES; j++)
+				if (next_hops[j] < 0)
+					count++;
+		}
+		printf("BULK LPM Lookup (%s): %.1f cycles (fails = %.1f%%)\n",
+				lookup_types[t].name,
+				(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
+				(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
 	}
-	printf("BULK LPM Lookup: %.1f cycles (fails = %.1f%%)\n",
-			(double)total_time / ((double)ITERATIONS * BATCH_SIZE),
-			(count * 100.0) / (double)(ITERATIONS * BATCH_SIZE));
 
 	/* Delete */
 	status = 0;
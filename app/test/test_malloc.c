@@ -22,6 +22,7 @@
 #include <rte_cycles.h>
 #include <rte_random.h>
 #include <rte_string_fns.h>
+#include <rte_errno.h>
 
 #include "test.h"
 
@@ -979,6 +980,100 @@ test_alloc_socket(void)
 	return 0;
 }
 
+static int
+test_malloc_cache(void)
+{
+	struct rte_malloc_cache_stats stats[2];
+	unsigned int lcore_id = rte_lcore_id();
+	char *p[4];
+	unsigned int i, j;
+
+	if (rte_malloc_cache_stats_get(lcore_id, &stats[0]) < 0) {
+		if (rte_errno != ENOTSUP) {
+			printf("%s: unexpected error %d\n", __func__, rte_errno);
+			return -1;
+		}
+		printf("%s: --malloc-cache not set, skipped\n", __func__);
+		return 0;
+	}
+
+	if (rte_malloc_cache_stats_get(RTE_MAX_LCORE, &stats[1]) == 0 ||
+			rte_errno != EINVAL) {
+		printf("%s: invalid lcore accepted\n", __func__);
+		return -1;
+	}
+
+	/* cycle objects of a cached size through the cache, they must come
+	 * back zeroed
+	 */
+	for (i = 0; i < RTE_DIM(p); i++) {
+		p[i] = rte_malloc(NULL, RTE_CACHE_LINE_SIZE, 0);
+		if (p[i] == NULL) {
+			printf("%s: rte_malloc() failed\n", __func__);
+			return -1;
+		}
+		memset(p[i], 0xA5, RTE_CACHE_LINE_SIZE);
+	}
+	for (i = 0; i < RTE_DIM(p); i++)
+		rte_free(p[i]);
+	for (i = 0; i < RTE_DIM(p); i++) {
+		p[i] = rte_malloc(NULL, RTE_CACHE_LINE_SIZE, 0);
+		if (p[i] == NULL) {
+			printf("%s: rte_malloc() failed\n", __func__);
+			return -1;
+		}
+		for (j = 0; j < RTE_CACHE_LINE_SIZE; j++) {
+			if (p[i][j] != 0) {
+				printf("%s: cached object not zeroed\n",
+					__func__);
+				return -1;
+			}
+		}
+	}
+	for (i = 0; i < RTE_DIM(p); i++)
+		rte_free(p[i]);
+
+	rte_malloc_cache_stats_get(lcore_id, &stats[1]);
+	if (stats[1].alloc_count - stats[0].alloc_count < 2 * RTE_DIM(p) ||
+			stats[1].free_count - stats[0].free_count <
+			2 * RTE_DIM(p)) {
+		printf("%s: objects did not go through the cache\n", __func__);
+		return -1;
+	}
+
+	/* a cached object freed again must not be handed out twice */
+	p[0] = rte_malloc(NULL, RTE_CACHE_LINE_SIZE, 0);
+	if (p[0] == NULL) {
+		printf("%s: rte_malloc() failed\n", __func__);
+		return -1;
+	}
+	rte_free(p[0]);
+	rte_free(p[0]);
+	p[1] = rte_malloc(NULL, RTE_CACHE_LINE_SIZE, 0);
+	p[2] = rte_malloc(NULL, RTE_CACHE_LINE_SIZE, 0);
+	if (p[1] == NULL || p[2] == NULL) {
+		printf("%s: rte_malloc() failed\n", __func__);
+		rte_free(p[1]);
+		rte_free(p[2]);
+		return -1;
+	}
+	rte_free(p[1]);
+	rte_free(p[2]);
+	if (p[1] == p[2]) {
+		printf("%s: double free not detected\n", __func__);
+		return -1;
+	}
+
+	rte_malloc_cache_flush();
+	rte_malloc_cache_stats_get(lcore_id, &stats[1]);
+	if (stats[1].cached_count != 0 || stats[1].cached_bytes != 0) {
+		printf("%s: cache not empty after flush\n", __func__);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_malloc(void)
 {
@@ -1069,6 +1164,14 @@ test_malloc(void)
 	}
 	else printf("test_alloc_socket() passed\n");
 
+	ret = test_malloc_cache();
+	if (ret < 0) {
+		printf("test_malloc_cache() failed\n");
+		return ret;
+	}
+	else
+		printf("test_malloc_cache() passed\n");
+
 	ret = test_multi_alloc_statistics();
 	if (ret < 0) {
 		printf("test_multi_alloc_statistics() failed\n");
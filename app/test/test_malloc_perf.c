@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+
+#include "test.h"
+
+/*
+ * Cost of rte_malloc()/rte_free() pairs done concurrently on all the lcores.
+ * Run the test with and without the --malloc-cache EAL option to compare the
+ * heap and the per-lcore cache paths.
+ */
+
+#define N_ITERATIONS 4096
+#define N_OBJS 16
+
+static const size_t obj_sizes[] = {64, 128, 256, 1024, 2048, 4096};
+
+static uint32_t start_flag;
+static uint64_t lcore_cycles[RTE_MAX_LCORE];
+
+static int
+malloc_perf_lcore(void *arg)
+{
+	size_t size = *(const size_t *)arg;
+	void *objs[N_OBJS];
+	uint64_t start;
+	unsigned int i, j;
+
+	while (__atomic_load_n(&start_flag, __ATOMIC_ACQUIRE) == 0)
+		rte_pause();
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < N_ITERATIONS; i++) {
+		for (j = 0; j < N_OBJS; j++) {
+			objs[j] = rte_malloc(NULL, size, 0);
+			if (objs[j] == NULL) {
+				while (j-- > 0)
+					rte_free(objs[j]);
+				return -1;
+			}
+		}
+		for (j = 0; j < N_OBJS; j++)
+			rte_free(objs[j]);
+	}
+	lcore_cycles[rte_lcore_id()] = rte_rdtsc_precise() - start;
+
+	return 0;
+}
+
+static int
+malloc_perf_run(size_t size, double *cycles)
+{
+	unsigned int lcore_id, n_lcores = 0;
+	uint64_t total = 0;
+	int ret = 0;
+
+	memset(lcore_cycles, 0, sizeof(lcore_cycles));
+	__atomic_store_n(&start_flag, 0, __ATOMIC_RELAXED);
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		rte_eal_remote_launch(malloc_perf_lcore, &size, lcore_id);
+
+	__atomic_store_n(&start_flag, 1, __ATOMIC_RELEASE);
+	if (malloc_perf_lcore(&size) < 0)
+		ret = -1;
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			ret = -1;
+	}
+	if (ret < 0)
+		return ret;
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		total += lcore_cycles[lcore_id];
+		n_lcores++;
+	}
+
+	*cycles = (double)total / n_lcores / (N_ITERATIONS * N_OBJS);
+	return 0;
+}
+
+static int
+test_malloc_perf(void)
+{
+	struct rte_malloc_cache_stats stats;
+	unsigned int lcore_id;
+	unsigned int i;
+	int cache_enabled;
+
+	cache_enabled = rte_malloc_cache_stats_get(rte_lcore_id(), &stats) == 0;
+
+	printf("%u lcores, per-lcore malloc cache %s\n", rte_lcore_count(),
+	       cache_enabled ? "enabled" : "disabled (--malloc-cache not set)");
+	printf("%-12s%24s\n", "Size", "Cycles per malloc+free");
+
+	for (i = 0; i < RTE_DIM(obj_sizes); i++) {
+		double cycles;
+
+		TEST_ASSERT_SUCCESS(malloc_perf_run(obj_sizes[i], &cycles),
+			"Allocation of %zu bytes failed", obj_sizes[i]);
+		printf("%-12zu%24.2f\n", obj_sizes[i], cycles);
+	}
+
+	if (!cache_enabled)
+		return TEST_SUCCESS;
+
+	printf("\n%-8s%12s%12s%10s%10s%10s\n", "lcore", "allocs", "frees",
+	       "refills", "flushes", "cached");
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (rte_malloc_cache_stats_get(lcore_id, &stats) < 0)
+			continue;
+		printf("%-8u%12" PRIu64 "%12" PRIu64 "%10" PRIu64 "%10" PRIu64
+		       "%10" PRIu64 "\n", lcore_id, stats.alloc_count,
+		       stats.free_count, stats.refill_count, stats.flush_count,
+		       stats.cached_count);
+	}
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(malloc_perf_autotest, test_malloc_perf);
@@ -25,6 +25,8 @@
 #include <rte_mempool.h>
 #include <rte_spinlock.h>
 #include <rte_malloc.h>
+#include <rte_ring.h>
+#include <rte_pause.h>
 #include <rte_mbuf_pool_ops.h>
 
 #include "test.h"
@@ -51,6 +53,12 @@
  *      - One core with user-owned cache
  *      - Two cores with user-owned cache
  *      - Max. cores with user-owned cache
+ *      - One core with cache, objects kept in software ring entries
+ *      - Two cores with cache, objects kept in software ring entries
+ *      - Max. cores with cache, objects kept in software ring entries
+ *      - One core with cache, software ring with zero-copy cache access
+ *      - Two cores with cache, software ring with zero-copy cache access
+ *      - Max. cores with cache, software ring with zero-copy cache access
  *
  *    - Bulk size (*n_get_bulk*, *n_put_bulk*)
  *
@@ -61,6 +69,22 @@
  *
  *      - 32
  *      - 128
+ *
+ *    With a software ring, the objects are kept in entries holding other
+ *    fields too, as the Tx queue of a PMD does, so they are copied from and
+ *    to a table for the get and put calls. With zero-copy cache access,
+ *    they are copied straight from and to the cache.
+ *
+ *    An asymmetric configuration is also measured: the cores are split in
+ *    pairs, a consumer core gets objects per bulk of *ASYM_BULK* and passes
+ *    them through a ring to a producer core, which puts them back in the
+ *    pool. It is done with the default cache, the adaptive cache
+ *    (MEMPOOL_F_CACHE_ADAPTIVE), and the adaptive cache with the caches of
+ *    each pair of cores paired.
+ *
+ *    Finally, the mempool handlers ring_mp_mc, stack, bucket and numa are
+ *    compared on max. cores without cache, so that all the gets and puts
+ *    reach the handler. Handlers which are not available are skipped.
  */
 
 #define N 65536
@@ -69,6 +93,12 @@
 #define MAX_KEEP 128
 #define MEMPOOL_SIZE ((rte_lcore_count()*(MAX_KEEP+RTE_MEMPOOL_CACHE_MAX_SIZE))-1)
 
+#define ASYM_BULK 32
+#define ASYM_CACHE_SIZE 256
+#define ASYM_RING_SIZE 1024
+#define ASYM_POOL_SIZE \
+	((rte_lcore_count() / 2 + 1) * RTE_MEMPOOL_CACHE_MAX_SIZE * 16 - 1)
+
 #define LOG_ERR() printf("test failed at %s():%d\n", __func__, __LINE__)
 #define RET_ERR() do {							\
 		LOG_ERR();						\
@@ -83,6 +113,9 @@
 static int use_external_cache;
 static unsigned external_cache_size = RTE_MEMPOOL_CACHE_MAX_SIZE;
 
+static int use_sw_ring;
+static int use_zc;
+
 static rte_atomic32_t synchro;
 
 /* number of objects in one bulk operation (get or put) */
@@ -99,6 +132,23 @@ struct mempool_test_stats {
 
 static struct mempool_test_stats stats[RTE_MAX_LCORE];
 
+/* software ring entry, keeping an object along with other fields */
+struct mempool_test_entry {
+	void *obj;
+	uint64_t data;
+};
+
+/* a consumer and a producer core of the asymmetric test */
+struct asym_pair {
+	struct rte_mempool *mp;
+	struct rte_ring *r;     /* objects passed from consumer to producer */
+	unsigned int consumer;
+	unsigned int producer;
+	int done;               /* set by the consumer once finished */
+};
+
+static struct asym_pair asym_pairs[RTE_MAX_LCORE / 2];
+
 /*
  * save the object number in the first 4 bytes of object data. All
  * other bytes are set to 0.
@@ -112,9 +162,56 @@ my_obj_init(struct rte_mempool *mp, __rte_unused void *arg,
 	*objnum = i;
 }
 
+/* get objects into software ring entries */
+static __rte_always_inline int
+sw_ring_get(struct rte_mempool *mp, struct mempool_test_entry *ring,
+	    unsigned int n, struct rte_mempool_cache *cache)
+{
+	void *obj_table[MAX_KEEP];
+	void **objs = obj_table;
+	unsigned int i;
+
+	if (use_zc) {
+		objs = rte_mempool_cache_zc_get_peek(cache, mp, n);
+		if (objs == NULL)
+			return -ENOENT;
+	} else if (rte_mempool_generic_get(mp, obj_table, n, cache) < 0) {
+		return -ENOENT;
+	}
+
+	for (i = 0; i < n; i++)
+		ring[i].obj = objs[i];
+
+	if (use_zc)
+		rte_mempool_cache_zc_get_consume(cache, mp, n);
+	return 0;
+}
+
+/* put back the objects of software ring entries */
+static __rte_always_inline void
+sw_ring_put(struct rte_mempool *mp, struct mempool_test_entry *ring,
+	    unsigned int n, struct rte_mempool_cache *cache)
+{
+	void *obj_table[MAX_KEEP];
+	void **objs = obj_table;
+	unsigned int i;
+
+	if (use_zc)
+		objs = rte_mempool_cache_zc_put_reserve(cache, mp, n);
+
+	for (i = 0; i < n; i++)
+		objs[i] = ring[i].obj;
+
+	if (use_zc)
+		rte_mempool_cache_zc_put_commit(cache, mp, n);
+	else
+		rte_mempool_generic_put(mp, obj_table, n, cache);
+}
+
 static int
 per_lcore_mempool_test(void *arg)
 {
+	struct mempool_test_entry sw_ring[MAX_KEEP];
 	void *obj_table[MAX_KEEP];
 	unsigned i, idx;
 	struct rte_mempool *mp = arg;
@@ -135,6 +232,10 @@ per_lcore_mempool_test(void *arg)
 		cache = rte_mempool_default_cache(mp, lcore_id);
 	}
 
+	/* zero-copy access needs a cache */
+	if (use_zc && cache == NULL)
+		GOTO_ERR(ret, out);
+
 	/* n_get_bulk and n_put_bulk must be divisors of n_keep */
 	if (((n_keep / n_get_bulk) * n_get_bulk) != n_keep)
 		GOTO_ERR(ret, out);
@@ -154,7 +255,11 @@ per_lcore_mempool_test(void *arg)
 			/* get n_keep objects by bulk of n_bulk */
 			idx = 0;
 			while (idx < n_keep) {
-				ret = rte_mempool_generic_get(mp,
+				if (use_sw_ring)
+					ret = sw_ring_get(mp, &sw_ring[idx],
+							  n_get_bulk, cache);
+				else
+					ret = rte_mempool_generic_get(mp,
 							      &obj_table[idx],
 							      n_get_bulk,
 							      cache);
@@ -169,7 +274,12 @@ per_lcore_mempool_test(void *arg)
 			/* put the objects back */
 			idx = 0;
 			while (idx < n_keep) {
-				rte_mempool_generic_put(mp, &obj_table[idx],
+				if (use_sw_ring)
+					sw_ring_put(mp, &sw_ring[idx],
+						    n_put_bulk, cache);
+				else
+					rte_mempool_generic_put(mp,
+							&obj_table[idx],
 							n_put_bulk,
 							cache);
 				idx += n_put_bulk;
@@ -250,6 +360,174 @@ launch_cores(struct rte_mempool *mp, unsigned int cores)
 	return 0;
 }
 
+/* get objects and pass them to the producer core */
+static int
+asym_consumer(void *arg)
+{
+	struct asym_pair *pair = arg;
+	void *obj_table[ASYM_BULK];
+	uint64_t start_cycles, hz = rte_get_timer_hz();
+	uint64_t count = 0;
+	unsigned int i;
+
+	while (rte_atomic32_read(&synchro) == 0)
+		;
+
+	start_cycles = rte_get_timer_cycles();
+
+	while (rte_get_timer_cycles() - start_cycles < TIME_S * hz) {
+		for (i = 0; i < N / ASYM_BULK; i++) {
+			if (rte_mempool_get_bulk(pair->mp, obj_table,
+					ASYM_BULK) < 0)
+				continue;
+			while (rte_ring_sp_enqueue_bulk(pair->r, obj_table,
+					ASYM_BULK, NULL) == 0)
+				rte_pause();
+			count += ASYM_BULK;
+		}
+	}
+	stats[pair->consumer].enq_count = count;
+
+	__atomic_store_n(&pair->done, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/* put back the objects received from the consumer core */
+static int
+asym_producer(void *arg)
+{
+	struct asym_pair *pair = arg;
+	void *obj_table[ASYM_BULK];
+	unsigned int n;
+
+	for (;;) {
+		n = rte_ring_sc_dequeue_burst(pair->r, obj_table, ASYM_BULK,
+			NULL);
+		if (n == 0) {
+			if (__atomic_load_n(&pair->done, __ATOMIC_ACQUIRE) &&
+					rte_ring_empty(pair->r))
+				break;
+			rte_pause();
+			continue;
+		}
+		rte_mempool_put_bulk(pair->mp, obj_table, n);
+	}
+	return 0;
+}
+
+/* launch the asymmetric test on all the pairs of cores */
+static int
+launch_asym(struct rte_mempool *mp, const char *mode, int pair_caches)
+{
+	unsigned int lcores[RTE_MAX_LCORE];
+	struct rte_mempool_cache_stats cs, ps;
+	unsigned int nb_lcores = 0;
+	unsigned int nb_pairs, i;
+	unsigned int lcore_id;
+	char name[RTE_RING_NAMESIZE];
+	int main_role = -1;
+	uint64_t rate;
+	int ret = 0;
+
+	RTE_LCORE_FOREACH(lcore_id)
+		lcores[nb_lcores++] = lcore_id;
+	nb_pairs = nb_lcores / 2;
+
+	printf("mempool_autotest asymmetric %s cache=%u pairs=%u n_bulk=%u ",
+	       mode, mp->cache_size, nb_pairs, ASYM_BULK);
+
+	if (rte_mempool_avail_count(mp) != ASYM_POOL_SIZE) {
+		printf("mempool is not full\n");
+		return -1;
+	}
+
+	rte_atomic32_set(&synchro, 0);
+	memset(stats, 0, sizeof(stats));
+	memset(asym_pairs, 0, sizeof(asym_pairs));
+
+	for (i = 0; i < nb_pairs; i++) {
+		struct asym_pair *pair = &asym_pairs[i];
+
+		pair->mp = mp;
+		pair->consumer = lcores[2 * i];
+		pair->producer = lcores[2 * i + 1];
+		snprintf(name, sizeof(name), "asym_perf_%u", i);
+		pair->r = rte_ring_create(name, ASYM_RING_SIZE, SOCKET_ID_ANY,
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+		if (pair->r == NULL)
+			GOTO_ERR(ret, out);
+		if (pair_caches && rte_mempool_cache_pair(mp, pair->producer,
+				pair->consumer) < 0)
+			GOTO_ERR(ret, out);
+	}
+
+	for (i = 0; i < nb_pairs; i++) {
+		struct asym_pair *pair = &asym_pairs[i];
+
+		if (pair->consumer == rte_get_main_lcore())
+			main_role = 2 * i;
+		else
+			rte_eal_remote_launch(asym_consumer, pair,
+				pair->consumer);
+		if (pair->producer == rte_get_main_lcore())
+			main_role = 2 * i + 1;
+		else
+			rte_eal_remote_launch(asym_producer, pair,
+				pair->producer);
+	}
+
+	/* start synchro and run the role of the main core, if any */
+	rte_atomic32_set(&synchro, 1);
+
+	if (main_role >= 0) {
+		if (main_role % 2 == 0)
+			asym_consumer(&asym_pairs[main_role / 2]);
+		else
+			asym_producer(&asym_pairs[main_role / 2]);
+	}
+
+	rte_eal_mp_wait_lcore();
+
+	rate = 0;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		rate += (stats[lcore_id].enq_count / TIME_S);
+
+	printf("rate_persec=%" PRIu64 "\n", rate);
+
+	if (rte_mempool_cache_stats_get(mp, asym_pairs[0].consumer,
+			&cs) == 0 &&
+	    rte_mempool_cache_stats_get(mp, asym_pairs[0].producer,
+			&ps) == 0)
+		printf("  consumer cache size=%u refills=%" PRIu64
+		       " xfer_in=%" PRIu64 ", producer cache size=%u"
+		       " flushes=%" PRIu64 " xfer_out=%" PRIu64 "\n",
+		       cs.size, cs.refills, cs.xfer_in,
+		       ps.size, ps.flushes, ps.xfer_out);
+
+out:
+	for (i = 0; i < nb_pairs; i++)
+		rte_ring_free(asym_pairs[i].r);
+	return ret;
+}
+
+/* run the asymmetric test with the default and the adaptive caches */
+static int
+do_asym_mempool_test(struct rte_mempool *mp, struct rte_mempool *mp_adaptive)
+{
+	if (rte_lcore_count() < 2) {
+		printf("not enough lcores for the asymmetric test\n");
+		return 0;
+	}
+
+	if (launch_asym(mp, "default", 0) < 0)
+		return -1;
+	if (launch_asym(mp_adaptive, "adaptive", 0) < 0)
+		return -1;
+	if (launch_asym(mp_adaptive, "adaptive-paired", 1) < 0)
+		return -1;
+	return 0;
+}
+
 /* for a given number of core, launch all test cases */
 static int
 do_one_mempool_test(struct rte_mempool *mp, unsigned int cores)
@@ -279,12 +557,56 @@ do_one_mempool_test(struct rte_mempool *mp, unsigned int cores)
 	return 0;
 }
 
+/* run the test on max cores with a mempool without cache using a handler */
+static int
+do_handler_mempool_test(const char *ops_name)
+{
+	char name[RTE_MEMPOOL_NAMESIZE];
+	struct rte_mempool *mp;
+	int ret;
+
+	snprintf(name, sizeof(name), "perf_test_%s", ops_name);
+	mp = rte_mempool_create_empty(name, MEMPOOL_SIZE, MEMPOOL_ELT_SIZE,
+				      0, 0, SOCKET_ID_ANY, 0);
+	if (mp == NULL) {
+		printf("cannot allocate %s mempool\n", ops_name);
+		return -1;
+	}
+
+	if (rte_mempool_set_ops_byname(mp, ops_name, NULL) < 0) {
+		printf("%s handler not available, skipped\n", ops_name);
+		rte_mempool_free(mp);
+		return 0;
+	}
+
+	if (rte_mempool_populate_default(mp) < 0) {
+		printf("cannot populate %s mempool\n", ops_name);
+		rte_mempool_free(mp);
+		return -1;
+	}
+
+	rte_mempool_obj_iter(mp, my_obj_init, NULL);
+
+	printf("start performance test for %s handler (without cache)\n",
+	       ops_name);
+	ret = do_one_mempool_test(mp, rte_lcore_count());
+
+	rte_mempool_free(mp);
+	return ret;
+}
+
 static int
 test_mempool_perf(void)
 {
+	static const char * const handlers[] = {
+		"ring_mp_mc", "stack", "bucket", "numa",
+	};
+	unsigned int i;
 	struct rte_mempool *mp_cache = NULL;
 	struct rte_mempool *mp_nocache = NULL;
 	struct rte_mempool *default_pool = NULL;
+	struct rte_mempool *mp_asym = NULL;
+	struct rte_mempool *mp_asym_adaptive = NULL;
 	const char *default_pool_ops;
 	int ret = -1;
 
@@ -335,6 +657,26 @@ test_mempool_perf(void)
 
 	rte_mempool_obj_iter(default_pool, my_obj_init, NULL);
 
+	/* create the mempools of the asymmetric test */
+	mp_asym = rte_mempool_create("perf_test_asym", ASYM_POOL_SIZE,
+				     MEMPOOL_ELT_SIZE, ASYM_CACHE_SIZE, 0,
+				     NULL, NULL,
+				     my_obj_init, NULL,
+				     SOCKET_ID_ANY, 0);
+	if (mp_asym == NULL)
+		goto err;
+
+	mp_asym_adaptive = rte_mempool_create("perf_test_asym_adapt",
+					      ASYM_POOL_SIZE,
+					      MEMPOOL_ELT_SIZE,
+					      ASYM_CACHE_SIZE, 0,
+					      NULL, NULL,
+					      my_obj_init, NULL,
+					      SOCKET_ID_ANY,
+					      MEMPOOL_F_CACHE_ADAPTIVE);
+	if (mp_asym_adaptive == NULL)
+		goto err;
+
 	/* performance test with 1, 2 and max cores */
 	printf("start performance test (without cache)\n");
 
@@ -372,6 +714,35 @@ test_mempool_perf(void)
 	if (do_one_mempool_test(mp_cache, rte_lcore_count()) < 0)
 		goto err;
 
+	/* performance test with 1, 2 and max cores */
+	printf("start performance test (with cache, software ring)\n");
+	use_sw_ring = 1;
+
+	if (do_one_mempool_test(mp_cache, 1) < 0)
+		goto err;
+
+	if (do_one_mempool_test(mp_cache, 2) < 0)
+		goto err;
+
+	if (do_one_mempool_test(mp_cache, rte_lcore_count()) < 0)
+		goto err;
+
+	/* performance test with 1, 2 and max cores */
+	printf("start performance test (with cache, software ring, zero-copy)\n");
+	use_zc = 1;
+
+	if (do_one_mempool_test(mp_cache, 1) < 0)
+		goto err;
+
+	if (do_one_mempool_test(mp_cache, 2) < 0)
+		goto err;
+
+	if (do_one_mempool_test(mp_cache, rte_lcore_count()) < 0)
+		goto err;
+
+	use_sw_ring = 0;
+	use_zc = 0;
+
 	/* performance test with 1, 2 and max cores */
 	printf("start performance test (with user-owned cache)\n");
 	use_external_cache = 1;
@@ -385,6 +756,19 @@ test_mempool_perf(void)
 	if (do_one_mempool_test(mp_nocache, rte_lcore_count()) < 0)
 		goto err;
 
+	/* asymmetric producer/consumer test */
+	printf("start asymmetric performance test (with cache)\n");
+	use_external_cache = 0;
+
+	if (do_asym_mempool_test(mp_asym, mp_asym_adaptive) < 0)
+		goto err;
+
+	/* mempool handlers comparison */
+	for (i = 0; i < RTE_DIM(handlers); i++) {
+		if (do_handler_mempool_test(handlers[i]) < 0)
+			goto err;
+	}
+
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
@@ -393,6 +777,8 @@ test_mempool_perf(void)
 	rte_mempool_free(mp_cache);
 	rte_mempool_free(mp_nocache);
 	rte_mempool_free(default_pool);
+	rte_mempool_free(mp_asym);
+	rte_mempool_free(mp_asym_adaptive);
 	return ret;
 }
 
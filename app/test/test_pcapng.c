@@ -0,0 +1,417 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_pcapng.h>
+
+#include "test.h"
+
+/*
+ * Write packets with and without capture metadata to a pcapng file, then
+ * parse the file and check its blocks.
+ */
+
+#define PCAPNG_TEST_NUM_MBUFS 512
+#define PCAPNG_TEST_PKTS 100
+#define PCAPNG_TEST_PKT_LEN 300
+#define PCAPNG_TEST_SNAPLEN 128
+#define PCAPNG_TEST_QUEUE 3
+#define PCAPNG_TEST_PORT 1
+
+/* pcapng blocks and options checked by the test */
+#define SHB_TYPE 0x0A0D0D0A
+#define IDB_TYPE 0x00000001
+#define EPB_TYPE 0x00000006
+#define BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define OPT_END 0
+#define EPB_FLAGS 2
+#define EPB_HASH 3
+#define EPB_QUEUE 6
+
+struct epb_info {
+	uint32_t if_id;
+	uint32_t cap_len;
+	uint32_t orig_len;
+	uint32_t flags;
+	uint32_t queue;
+	uint32_t hash;
+	int has_flags;
+	int has_queue;
+	int has_hash;
+	const uint8_t *data;
+};
+
+static struct rte_mempool *pcapng_pool;
+
+static struct rte_mbuf *
+test_pkt_build(uint32_t len, uint32_t seed)
+{
+	struct rte_mbuf *m, *seg;
+	uint32_t half = len / 2;
+	uint8_t *p;
+	uint32_t i;
+
+	/* two segments, to check that the writer walks the chain */
+	m = rte_pktmbuf_alloc(pcapng_pool);
+	seg = rte_pktmbuf_alloc(pcapng_pool);
+	if (m == NULL || seg == NULL) {
+		rte_pktmbuf_free(m);
+		rte_pktmbuf_free(seg);
+		return NULL;
+	}
+
+	p = (uint8_t *)rte_pktmbuf_append(m, half);
+	for (i = 0; i < half; i++)
+		p[i] = seed + i;
+	p = (uint8_t *)rte_pktmbuf_append(seg, len - half);
+	for (i = half; i < len; i++)
+		p[i - half] = seed + i;
+	rte_pktmbuf_chain(m, seg);
+
+	m->port = PCAPNG_TEST_PORT;
+	m->hash.rss = seed;
+	m->ol_flags |= PKT_RX_RSS_HASH;
+
+	return m;
+}
+
+static int
+test_opts_parse(const uint8_t *p, const uint8_t *end, struct epb_info *info)
+{
+	uint16_t code, len;
+
+	while (p + 2 * sizeof(uint16_t) <= end) {
+		memcpy(&code, p, sizeof(code));
+		memcpy(&len, p + sizeof(code), sizeof(len));
+		p += 2 * sizeof(uint16_t);
+		if (code == OPT_END)
+			return p == end ? 0 : -1;
+		if (p + len > end)
+			return -1;
+
+		switch (code) {
+		case EPB_FLAGS:
+			memcpy(&info->flags, p, sizeof(info->flags));
+			info->has_flags = 1;
+			break;
+		case EPB_QUEUE:
+			memcpy(&info->queue, p, sizeof(info->queue));
+			info->has_queue = 1;
+			break;
+		case EPB_HASH:
+			memcpy(&info->hash, p + 1, sizeof(info->hash));
+			info->has_hash = 1;
+			break;
+		}
+		p += RTE_ALIGN(len, sizeof(uint32_t));
+	}
+
+	return -1;
+}
+
+/* Parse the file, fill the info of its packets and return their number */
+static int
+test_file_parse(const uint8_t *buf, size_t size, struct epb_info *pkts,
+		uint32_t max_pkts, uint32_t *nb_ifs)
+{
+	const uint8_t *p = buf;
+	uint32_t hdr[2], trailer, nb_pkts = 0;
+	uint32_t epb[5];
+
+	*nb_ifs = 0;
+	while (p < buf + size) {
+		memcpy(hdr, p, sizeof(hdr));
+		if (hdr[1] % sizeof(uint32_t) != 0 || p + hdr[1] > buf + size)
+			return -1;
+		memcpy(&trailer, p + hdr[1] - sizeof(trailer),
+		       sizeof(trailer));
+		if (trailer != hdr[1])
+			return -1;
+
+		if (p == buf) {
+			uint32_t magic;
+
+			memcpy(&magic, p + sizeof(hdr), sizeof(magic));
+			if (hdr[0] != SHB_TYPE || magic != BYTE_ORDER_MAGIC)
+				return -1;
+		} else if (hdr[0] == IDB_TYPE) {
+			(*nb_ifs)++;
+		} else if (hdr[0] == EPB_TYPE) {
+			struct epb_info *info = &pkts[nb_pkts];
+
+			if (nb_pkts == max_pkts)
+				return -1;
+			memset(info, 0, sizeof(*info));
+			memcpy(epb, p + sizeof(hdr), sizeof(epb));
+			info->if_id = epb[0];
+			info->cap_len = epb[3];
+			info->orig_len = epb[4];
+			info->data = p + sizeof(hdr) + sizeof(epb);
+			if (test_opts_parse(info->data +
+					RTE_ALIGN(info->cap_len, sizeof(uint32_t)),
+					p + hdr[1] - sizeof(trailer), info) < 0)
+				return -1;
+			nb_pkts++;
+		} else
+			return -1;
+
+		p += hdr[1];
+	}
+
+	return nb_pkts;
+}
+
+static int
+test_pcapng_write(void)
+{
+	struct rte_mbuf *orig[PCAPNG_TEST_PKTS];
+	struct rte_mbuf *pkts[PCAPNG_TEST_PKTS];
+	struct epb_info *info = NULL;
+	char name[] = "/tmp/pcapng_test_XXXXXX";
+	rte_pcapng_t *pcapng = NULL;
+	uint8_t *buf = NULL;
+	struct stat st;
+	uint32_t i, j, nb_ifs, len;
+	ssize_t written;
+	int fd, nb, ret = TEST_FAILED;
+
+	memset(orig, 0, sizeof(orig));
+	memset(pkts, 0, sizeof(pkts));
+
+	fd = mkstemp(name);
+	TEST_ASSERT(fd >= 0, "Cannot create temporary file");
+	unlink(name);
+
+	/* keep a descriptor to read the file back once the writer closes */
+	pcapng = rte_pcapng_fdopen(dup(fd), NULL, NULL, "pcapng_autotest",
+				   "test comment");
+	if (pcapng == NULL) {
+		printf("rte_pcapng_fdopen failed: %s\n",
+		       rte_strerror(rte_errno));
+		goto out;
+	}
+
+	/* even packets copied with metadata, odd packets written as is */
+	for (i = 0; i < PCAPNG_TEST_PKTS; i++) {
+		orig[i] = test_pkt_build(PCAPNG_TEST_PKT_LEN, i);
+		if (orig[i] == NULL) {
+			printf("Cannot allocate packet %u\n", i);
+			goto out;
+		}
+		if (i % 2 != 0) {
+			pkts[i] = orig[i];
+			continue;
+		}
+		pkts[i] = rte_pcapng_copy(PCAPNG_TEST_PORT, PCAPNG_TEST_QUEUE,
+			orig[i], pcapng_pool, PCAPNG_TEST_SNAPLEN,
+			i % 4 == 0 ? RTE_PCAPNG_DIRECTION_IN :
+			RTE_PCAPNG_DIRECTION_OUT);
+		if (pkts[i] == NULL) {
+			printf("rte_pcapng_copy failed: %s\n",
+			       rte_strerror(rte_errno));
+			goto out;
+		}
+	}
+
+	written = rte_pcapng_write_packets(pcapng, pkts, PCAPNG_TEST_PKTS);
+	if (written <= 0) {
+		printf("rte_pcapng_write_packets failed: %s\n",
+		       rte_strerror(rte_errno));
+		goto out;
+	}
+	rte_pcapng_close(pcapng);
+	pcapng = NULL;
+
+	if (fstat(fd, &st) < 0 || st.st_size <= written) {
+		printf("Unexpected file size\n");
+		goto out;
+	}
+	buf = malloc(st.st_size);
+	info = calloc(PCAPNG_TEST_PKTS, sizeof(*info));
+	if (buf == NULL || info == NULL ||
+	    pread(fd, buf, st.st_size, 0) != st.st_size) {
+		printf("Cannot read the file back\n");
+		goto out;
+	}
+
+	nb = test_file_parse(buf, st.st_size, info, PCAPNG_TEST_PKTS,
+			     &nb_ifs);
+	if (nb != PCAPNG_TEST_PKTS || nb_ifs != 1) {
+		printf("Invalid file: %d packets, %u interfaces\n", nb, nb_ifs);
+		goto out;
+	}
+
+	for (i = 0; i < PCAPNG_TEST_PKTS; i++) {
+		len = i % 2 ? PCAPNG_TEST_PKT_LEN : PCAPNG_TEST_SNAPLEN;
+		if (info[i].if_id != 0 || info[i].cap_len != len ||
+		    info[i].orig_len != PCAPNG_TEST_PKT_LEN) {
+			printf("Packet %u: invalid lengths %u/%u\n", i,
+			       info[i].cap_len, info[i].orig_len);
+			goto out;
+		}
+		for (j = 0; j < len; j++) {
+			if (info[i].data[j] != (uint8_t)(i + j)) {
+				printf("Packet %u: invalid data at %u\n", i, j);
+				goto out;
+			}
+		}
+		if (!info[i].has_hash || info[i].hash != i) {
+			printf("Packet %u: invalid hash\n", i);
+			goto out;
+		}
+		if (i % 2 != 0) {
+			if (info[i].has_queue || info[i].has_flags) {
+				printf("Packet %u: unexpected metadata\n", i);
+				goto out;
+			}
+			continue;
+		}
+		if (!info[i].has_queue || info[i].queue != PCAPNG_TEST_QUEUE ||
+		    !info[i].has_flags ||
+		    info[i].flags != (i % 4 == 0 ? 1u : 2u)) {
+			printf("Packet %u: invalid metadata\n", i);
+			goto out;
+		}
+	}
+
+	ret = TEST_SUCCESS;
+out:
+	rte_pcapng_close(pcapng);
+	for (i = 0; i < PCAPNG_TEST_PKTS; i++) {
+		if (pkts[i] != orig[i])
+			rte_pktmbuf_free(pkts[i]);
+		rte_pktmbuf_free(orig[i]);
+	}
+	free(info);
+	free(buf);
+	close(fd);
+	return ret;
+}
+
+/* A port whose description could not be written is described again */
+static int
+test_pcapng_write_error(void)
+{
+	struct rte_mbuf *m = NULL;
+	struct epb_info info;
+	char name[] = "/tmp/pcapng_test_XXXXXX";
+	rte_pcapng_t *pcapng = NULL;
+	uint8_t *buf = NULL;
+	struct stat st;
+	uint32_t nb_ifs;
+	int fd, wfd, full, nb, ret = TEST_FAILED;
+
+	full = open("/dev/full", O_WRONLY);
+	if (full < 0) {
+		printf("Cannot open /dev/full, skipping\n");
+		return TEST_SKIPPED;
+	}
+
+	fd = mkstemp(name);
+	if (fd < 0) {
+		printf("Cannot create temporary file\n");
+		close(full);
+		return TEST_FAILED;
+	}
+	unlink(name);
+
+	wfd = dup(fd);
+	pcapng = rte_pcapng_fdopen(wfd, NULL, NULL, "pcapng_autotest", NULL);
+	if (pcapng == NULL) {
+		printf("rte_pcapng_fdopen failed: %s\n",
+		       rte_strerror(rte_errno));
+		close(wfd);
+		goto out;
+	}
+	m = test_pkt_build(PCAPNG_TEST_PKT_LEN, 0);
+	if (m == NULL) {
+		printf("Cannot allocate packet\n");
+		goto out;
+	}
+
+	/* the first write of the port fails with its IDB queued */
+	if (dup2(full, wfd) < 0 ||
+	    rte_pcapng_write_packets(pcapng, &m, 1) >= 0) {
+		printf("Write to a full device did not fail\n");
+		goto out;
+	}
+
+	if (dup2(fd, wfd) < 0 ||
+	    rte_pcapng_write_packets(pcapng, &m, 1) <= 0) {
+		printf("rte_pcapng_write_packets failed: %s\n",
+		       rte_strerror(rte_errno));
+		goto out;
+	}
+	rte_pcapng_close(pcapng);
+	pcapng = NULL;
+
+	if (fstat(fd, &st) < 0 || (buf = malloc(st.st_size)) == NULL ||
+	    pread(fd, buf, st.st_size, 0) != st.st_size) {
+		printf("Cannot read the file back\n");
+		goto out;
+	}
+
+	nb = test_file_parse(buf, st.st_size, &info, 1, &nb_ifs);
+	if (nb != 1 || nb_ifs != 1 || info.if_id != 0) {
+		printf("Invalid file: %d packets, %u interfaces\n", nb, nb_ifs);
+		goto out;
+	}
+
+	ret = TEST_SUCCESS;
+out:
+	rte_pcapng_close(pcapng);
+	rte_pktmbuf_free(m);
+	free(buf);
+	close(full);
+	close(fd);
+	return ret;
+}
+
+static int
+test_pcapng_setup(void)
+{
+	pcapng_pool = rte_pktmbuf_pool_create("pcapng_test_pool",
+			PCAPNG_TEST_NUM_MBUFS, 0, 0,
+			RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(pcapng_pool, "Cannot create mbuf pool");
+
+	return TEST_SUCCESS;
+}
+
+static void
+test_pcapng_teardown(void)
+{
+	rte_mempool_free(pcapng_pool);
+	pcapng_pool = NULL;
+}
+
+static struct unit_test_suite pcapng_testsuite = {
+	.suite_name = "pcapng autotest",
+	.setup = test_pcapng_setup,
+	.teardown = test_pcapng_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_pcapng_write),
+		TEST_CASE(test_pcapng_write_error),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_pcapng(void)
+{
+	return unit_test_suite_runner(&pcapng_testsuite);
+}
+
+REGISTER_TEST_COMMAND(pcapng_autotest, test_pcapng);
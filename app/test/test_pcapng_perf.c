@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_pcapng.h>
+
+#include "test.h"
+
+/*
+ * Measure the pcapng write throughput to tmpfs, for several packet sizes
+ * and burst sizes, with packets copied by rte_pcapng_copy().
+ */
+
+#define PERF_NUM_MBUFS 1024
+#define PERF_MAX_BURST 32
+#define PERF_ITERATIONS (1 << 18)
+#define PERF_FILE_TEMPLATE "/dev/shm/pcapng_perf_XXXXXX"
+
+static const uint16_t pkt_sizes[] = {64, 512, 1500};
+static const uint16_t burst_sizes[] = {1, PERF_MAX_BURST};
+
+static int
+perf_write(struct rte_mempool *mp, uint16_t pkt_size, uint16_t burst)
+{
+	struct rte_mbuf *pkts[PERF_MAX_BURST];
+	char name[] = PERF_FILE_TEMPLATE;
+	rte_pcapng_t *pcapng;
+	uint64_t start, cycles, bytes = 0;
+	uint32_t i, iterations = PERF_ITERATIONS / burst;
+	double secs, mpps, gbps;
+	ssize_t ret;
+	int fd;
+
+	/* written packets are copies, as they would be by pdump */
+	for (i = 0; i < burst; i++) {
+		struct rte_mbuf *m = rte_pktmbuf_alloc(mp);
+
+		pkts[i] = NULL;
+		if (m != NULL && rte_pktmbuf_append(m, pkt_size) != NULL)
+			pkts[i] = rte_pcapng_copy(0, 0, m, mp, UINT32_MAX,
+						  RTE_PCAPNG_DIRECTION_IN);
+		rte_pktmbuf_free(m);
+		if (pkts[i] == NULL) {
+			printf("Cannot allocate packets\n");
+			rte_pktmbuf_free_bulk(pkts, i);
+			return -1;
+		}
+	}
+
+	fd = mkstemp(name);
+	if (fd < 0) {
+		printf("Cannot create %s\n", name);
+		rte_pktmbuf_free_bulk(pkts, burst);
+		return -1;
+	}
+	unlink(name);
+
+	pcapng = rte_pcapng_fdopen(fd, NULL, NULL, "pcapng_perf_autotest",
+				   NULL);
+	if (pcapng == NULL) {
+		printf("rte_pcapng_fdopen failed: %s\n",
+		       rte_strerror(rte_errno));
+		close(fd);
+		rte_pktmbuf_free_bulk(pkts, burst);
+		return -1;
+	}
+
+	start = rte_rdtsc_precise();
+	for (i = 0; i < iterations; i++) {
+		ret = rte_pcapng_write_packets(pcapng, pkts, burst);
+		if (ret < 0)
+			break;
+		bytes += ret;
+	}
+	cycles = rte_rdtsc_precise() - start;
+
+	rte_pcapng_close(pcapng);
+	rte_pktmbuf_free_bulk(pkts, burst);
+
+	if (i != iterations) {
+		printf("rte_pcapng_write_packets failed: %s\n",
+		       rte_strerror(rte_errno));
+		return -1;
+	}
+
+	secs = (double)cycles / rte_get_tsc_hz();
+	mpps = (double)iterations * burst / secs / 1e6;
+	gbps = (double)bytes * 8 / secs / 1e9;
+	printf("%8u %8u %10.2f %10.2f %12.1f\n", pkt_size, burst, mpps, gbps,
+	       (double)cycles / ((uint64_t)iterations * burst));
+
+	return 0;
+}
+
+static int
+test_pcapng_perf(void)
+{
+	struct rte_mempool *mp;
+	unsigned int i, j;
+	int ret = 0;
+
+	mp = rte_pktmbuf_pool_create("pcapng_perf_pool", PERF_NUM_MBUFS, 0, 0,
+				     RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (mp == NULL) {
+		printf("Cannot create mbuf pool\n");
+		return TEST_FAILED;
+	}
+
+	printf("\n%8s %8s %10s %10s %12s\n", "pkt_size", "burst", "Mpps",
+	       "Gbps", "cycles/pkt");
+	for (i = 0; i < RTE_DIM(pkt_sizes) && ret == 0; i++)
+		for (j = 0; j < RTE_DIM(burst_sizes) && ret == 0; j++)
+			ret = perf_write(mp, pkt_sizes[i], burst_sizes[j]);
+
+	rte_mempool_free(mp);
+
+	return ret == 0 ? TEST_SUCCESS : TEST_FAILED;
+}
+
+REGISTER_TEST_COMMAND(pcapng_perf_autotest, test_pcapng_perf);
@@ -330,6 +330,244 @@ test_reorder_drain(void)
 	return ret;
 }
 
+static int
+test_reorder_insert_burst(void)
+{
+	struct rte_reorder_buffer *b = NULL;
+	struct rte_mempool *p = test_params->p;
+	const unsigned int size = 4;
+	const unsigned int num_bufs = 5;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *burst[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	int ret = 0;
+	unsigned int i, cnt;
+
+	memset(bufs, 0, sizeof(bufs));
+	memset(robufs, 0, sizeof(robufs));
+
+	b = rte_reorder_create("test_insert_burst", rte_socket_id(), size);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		TEST_ASSERT_NOT_NULL(bufs[i], "Packet allocation failed\n");
+		*rte_reorder_seqn(bufs[i]) = i;
+	}
+	/* late packet */
+	*rte_reorder_seqn(bufs[4]) = 3 * size;
+
+	/* Insert should stop at the late packet:
+	 * reorder_seq = 0
+	 * OB[] = {0, 1, NULL, NULL}
+	 */
+	burst[0] = bufs[1];
+	burst[1] = bufs[0];
+	burst[2] = bufs[4];
+	burst[3] = bufs[3];
+	burst[4] = bufs[2];
+	cnt = rte_reorder_insert_burst(b, burst, num_bufs);
+	if (cnt != 2 || rte_errno != ERANGE) {
+		printf("%s:%d: %u packets inserted, expected 2 and ERANGE\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	bufs[0] = NULL;
+	bufs[1] = NULL;
+
+	/* Insert the packets after the late one:
+	 * reorder_seq = 0
+	 * OB[] = {0, 1, 2, 3}
+	 */
+	cnt = rte_reorder_insert_burst(b, &burst[3], 2);
+	if (cnt != 2) {
+		printf("%s:%d: %u packets inserted, expected 2\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	bufs[2] = NULL;
+	bufs[3] = NULL;
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != size) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++) {
+		if (*rte_reorder_seqn(robufs[i]) != i) {
+			printf("%s:%d: packet %u drained out of order\n",
+					__func__, __LINE__, i);
+			ret = -1;
+			goto exit;
+		}
+	}
+
+	ret = 0;
+exit:
+	rte_reorder_free(b);
+	for (i = 0; i < num_bufs; i++) {
+		if (bufs[i] != NULL)
+			rte_pktmbuf_free(bufs[i]);
+		if (robufs[i] != NULL)
+			rte_pktmbuf_free(robufs[i]);
+	}
+	return ret;
+}
+
+static int
+test_reorder_mp_insert(void)
+{
+	struct rte_reorder_buffer *b = NULL;
+	struct rte_mempool *p = test_params->p;
+	const unsigned int size = 4;
+	const unsigned int num_bufs = 8;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	struct rte_mbuf *burst[3];
+	int ret = 0;
+	unsigned int i, cnt;
+
+	memset(bufs, 0, sizeof(bufs));
+
+	b = rte_reorder_create_flags("test_mp_insert", rte_socket_id(), size,
+			RTE_REORDER_F_MP_INSERT);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		TEST_ASSERT_NOT_NULL(bufs[i], "Packet allocation failed\n");
+		*rte_reorder_seqn(bufs[i]) = i;
+	}
+
+	/* reorder_seq = 0, OB[] = {0, 1, 2, NULL} */
+	burst[0] = bufs[0];
+	burst[1] = bufs[2];
+	burst[2] = bufs[1];
+	cnt = rte_reorder_insert_burst(b, burst, 3);
+	if (cnt != 3) {
+		printf("%s:%d: %u packets inserted, expected 3\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+	bufs[0] = bufs[1] = bufs[2] = NULL;
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	rte_pktmbuf_free_bulk(robufs, cnt);
+	if (cnt != 3) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	/* reorder_seq = 3, OB[] = {4, NULL, NULL, NULL} */
+	ret = rte_reorder_insert(b, bufs[4]);
+	if (ret != 0) {
+		printf("%s:%d: Error inserting packet in window\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+	bufs[4] = NULL;
+
+	/* early packet - window is only moved by the next drain */
+	ret = rte_reorder_insert(b, bufs[7]);
+	if (!((ret == -1) && (rte_errno == ENOSPC))) {
+		printf("%s:%d: No error inserting early packet\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+
+	/* skip the missing packet 3: reorder_seq = 5 */
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	rte_pktmbuf_free_bulk(robufs, cnt);
+	if (cnt != 1) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	/* late packet */
+	ret = rte_reorder_insert(b, bufs[3]);
+	if (!((ret == -1) && (rte_errno == ERANGE))) {
+		printf("%s:%d: No error inserting late packet\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+
+	/* reorder_seq = 5, OB[] = {NULL, 5, 6, 7} */
+	for (i = 5; i < num_bufs; i++) {
+		ret = rte_reorder_insert(b, bufs[i]);
+		if (ret != 0) {
+			printf("%s:%d: Error inserting packet %u\n",
+					__func__, __LINE__, i);
+			ret = -1;
+			goto exit;
+		}
+		bufs[i] = NULL;
+	}
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	for (i = 0; i < cnt; i++) {
+		if (*rte_reorder_seqn(robufs[i]) != i + 5)
+			ret = -1;
+	}
+	rte_pktmbuf_free_bulk(robufs, cnt);
+	if (cnt != 3 || ret != 0) {
+		printf("%s:%d:%d: expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		ret = -1;
+		goto exit;
+	}
+
+	/* reorder_seq = 8, packet two windows early */
+	bufs[0] = rte_pktmbuf_alloc(p);
+	TEST_ASSERT_NOT_NULL(bufs[0], "Packet allocation failed\n");
+	*rte_reorder_seqn(bufs[0]) = 8 + 2 * size;
+	ret = rte_reorder_insert(b, bufs[0]);
+	if (!((ret == -1) && (rte_errno == ENOSPC))) {
+		printf("%s:%d: No error inserting early packet\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+
+	/* skip the missing packets 8 to 12: reorder_seq = 13 */
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 0) {
+		printf("%s:%d:%d: number of expected packets not drained\n",
+				__func__, __LINE__, cnt);
+		rte_pktmbuf_free_bulk(robufs, cnt);
+		ret = -1;
+		goto exit;
+	}
+	ret = rte_reorder_insert(b, bufs[0]);
+	if (ret != 0) {
+		printf("%s:%d: Error inserting packet in window\n",
+				__func__, __LINE__);
+		ret = -1;
+		goto exit;
+	}
+	bufs[0] = NULL;
+
+	ret = 0;
+exit:
+	rte_reorder_free(b);
+	for (i = 0; i < num_bufs; i++) {
+		if (bufs[i] != NULL)
+			rte_pktmbuf_free(bufs[i]);
+	}
+	return ret;
+}
+
 static int
 test_setup(void)
 {
@@ -380,6 +618,8 @@ static struct unit_test_suite reorder_test_suite  = {
 		TEST_CASE(test_reorder_free),
 		TEST_CASE(test_reorder_insert),
 		TEST_CASE(test_reorder_drain),
+		TEST_CASE(test_reorder_insert_burst),
+		TEST_CASE(test_reorder_mp_insert),
 		TEST_CASES_END()
 	}
 };
@@ -0,0 +1,316 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_pause.h>
+#include <rte_reorder.h>
+#include <rte_ring.h>
+
+#include "test.h"
+
+/*
+ * Measure the throughput of the reorder stage of the packet_ordering
+ * example, where workers return bursts of packets out of order:
+ *  - on a single lcore, the cost of reordering with rte_reorder_insert()
+ *    for each packet, as done by the example, and rte_reorder_insert_burst();
+ *  - with worker lcores, the rate of packets transmitted by the TX lcore,
+ *    when it dequeues the packets from a ring and inserts them, as the
+ *    example does, and when the workers insert the packets themselves in a
+ *    reorder buffer created with RTE_REORDER_F_MP_INSERT.
+ */
+
+#define PERF_BURST 32
+#define PERF_BUFFER_SIZE 8192
+#define PERF_RING_SIZE 16384
+#define PERF_NUM_MBUFS (2 * PERF_BUFFER_SIZE + PERF_RING_SIZE + 8192)
+#define PERF_MBUF_CACHE 256
+#define PERF_ITERATIONS (1 << 16)
+#define PERF_PIPELINE_PKTS (1 << 23)
+
+enum perf_mode {
+	PERF_INSERT,        /* TX lcore inserts each packet */
+	PERF_INSERT_BURST,  /* TX lcore inserts bursts of packets */
+	PERF_MP_INSERT,     /* workers insert, TX lcore only drains */
+};
+
+static const char * const perf_mode_names[] = {
+	[PERF_INSERT] = "insert",
+	[PERF_INSERT_BURST] = "insert_burst",
+	[PERF_MP_INSERT] = "mp_insert",
+};
+
+struct perf_pipeline {
+	enum perf_mode mode;
+	struct rte_mempool *mp;
+	struct rte_ring *ring;
+	struct rte_reorder_buffer *b;
+	uint32_t next_seqn;     /* next sequence number given to a worker */
+	uint32_t nb_workers_done;
+};
+
+/* Swap pairs of packets of the burst, as out of order workers would */
+static inline void
+perf_shuffle(struct rte_mbuf **pkts, unsigned int n)
+{
+	struct rte_mbuf *m;
+	unsigned int i;
+
+	for (i = 1; i + 1 < n; i += 2) {
+		m = pkts[i];
+		pkts[i] = pkts[i + 1];
+		pkts[i + 1] = m;
+	}
+}
+
+/* Insert a burst on the TX lcore, dropping the packets not inserted */
+static unsigned int
+perf_insert(struct rte_reorder_buffer *b, enum perf_mode mode,
+		struct rte_mbuf **pkts, unsigned int n)
+{
+	unsigned int i, nb_failed = 0;
+
+	if (mode == PERF_INSERT) {
+		for (i = 0; i < n; i++) {
+			if (rte_reorder_insert(b, pkts[i]) != 0) {
+				rte_pktmbuf_free(pkts[i]);
+				nb_failed++;
+			}
+		}
+		return nb_failed;
+	}
+
+	for (i = 0; i < n; i++) {
+		i += rte_reorder_insert_burst(b, &pkts[i], n - i);
+		if (i == n)
+			break;
+		rte_pktmbuf_free(pkts[i]);
+		nb_failed++;
+	}
+	return nb_failed;
+}
+
+static int
+perf_single_lcore(struct rte_mempool *mp, enum perf_mode mode)
+{
+	struct rte_mbuf *pkts[PERF_BURST], *out[PERF_BURST];
+	struct rte_reorder_buffer *b;
+	uint64_t start, cycles = 0;
+	uint32_t seqn = 0;
+	unsigned int i, j, n;
+	int ret = 0;
+
+	b = rte_reorder_create_flags("reorder_perf", rte_socket_id(),
+			PERF_BUFFER_SIZE,
+			mode == PERF_MP_INSERT ? RTE_REORDER_F_MP_INSERT : 0);
+	if (b == NULL) {
+		printf("Cannot create reorder buffer: %s\n",
+		       rte_strerror(rte_errno));
+		return -1;
+	}
+
+	for (i = 0; i < PERF_ITERATIONS && ret == 0; i++) {
+		if (rte_pktmbuf_alloc_bulk(mp, pkts, PERF_BURST) != 0) {
+			printf("Cannot allocate packets\n");
+			ret = -1;
+			break;
+		}
+		for (j = 0; j < PERF_BURST; j++)
+			*rte_reorder_seqn(pkts[j]) = seqn++;
+		perf_shuffle(pkts, PERF_BURST);
+
+		start = rte_rdtsc();
+		if (mode == PERF_MP_INSERT) {
+			if (rte_reorder_insert_burst(b, pkts, PERF_BURST) !=
+					PERF_BURST)
+				ret = -1;
+		} else if (perf_insert(b, mode, pkts, PERF_BURST) != 0) {
+			ret = -1;
+		}
+		n = rte_reorder_drain(b, out, PERF_BURST);
+		cycles += rte_rdtsc() - start;
+
+		rte_pktmbuf_free_bulk(out, n);
+		if (n != PERF_BURST)
+			ret = -1;
+	}
+	rte_reorder_free(b);
+
+	if (ret != 0) {
+		printf("%s: packets not reordered\n", perf_mode_names[mode]);
+		return -1;
+	}
+	printf("%-14s %10.2f\n", perf_mode_names[mode],
+	       (double)cycles / ((uint64_t)PERF_ITERATIONS * PERF_BURST));
+	return 0;
+}
+
+static int
+perf_worker(void *arg)
+{
+	struct perf_pipeline *pl = arg;
+	struct rte_mbuf *pkts[PERF_BURST];
+	unsigned int i, n;
+	uint32_t seqn;
+
+	for (;;) {
+		/* allocate first, not to hold back sequence numbers */
+		while (rte_pktmbuf_alloc_bulk(pl->mp, pkts, PERF_BURST) != 0)
+			rte_pause();
+		seqn = __atomic_fetch_add(&pl->next_seqn, PERF_BURST,
+				__ATOMIC_RELAXED);
+		if (seqn >= PERF_PIPELINE_PKTS) {
+			rte_pktmbuf_free_bulk(pkts, PERF_BURST);
+			break;
+		}
+
+		for (i = 0; i < PERF_BURST; i++)
+			*rte_reorder_seqn(pkts[i]) = seqn + i;
+		perf_shuffle(pkts, PERF_BURST);
+
+		if (pl->mode != PERF_MP_INSERT) {
+			n = 0;
+			while (n < PERF_BURST)
+				n += rte_ring_enqueue_burst(pl->ring,
+						(void **)&pkts[n],
+						PERF_BURST - n, NULL);
+			continue;
+		}
+
+		/* retry early packets until the TX lcore makes room */
+		n = 0;
+		while (n < PERF_BURST) {
+			n += rte_reorder_insert_burst(pl->b, &pkts[n],
+					PERF_BURST - n);
+			if (n == PERF_BURST)
+				break;
+			if (rte_errno == ENOSPC) {
+				rte_pause();
+				continue;
+			}
+			rte_pktmbuf_free(pkts[n++]);
+		}
+	}
+
+	__atomic_fetch_add(&pl->nb_workers_done, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/*
+ * TX lcore loop, modeled after send_thread() of packet_ordering. Packets
+ * left behind a dropped one once all the workers are done are not counted.
+ */
+static uint64_t
+perf_tx(struct perf_pipeline *pl)
+{
+	struct rte_mbuf *pkts[PERF_BURST], *out[PERF_BURST];
+	unsigned int nb_workers = rte_lcore_count() - 1;
+	uint64_t nb_tx = 0;
+	unsigned int n, nb_rx = 0;
+
+	while (nb_tx < PERF_PIPELINE_PKTS) {
+		if (pl->mode != PERF_MP_INSERT) {
+			nb_rx = rte_ring_dequeue_burst(pl->ring, (void **)pkts,
+					PERF_BURST, NULL);
+			if (nb_rx != 0)
+				perf_insert(pl->b, pl->mode, pkts, nb_rx);
+		}
+		n = rte_reorder_drain(pl->b, out, PERF_BURST);
+		rte_pktmbuf_free_bulk(out, n);
+		nb_tx += n;
+
+		if (n == 0 && nb_rx == 0 &&
+				__atomic_load_n(&pl->nb_workers_done,
+					__ATOMIC_ACQUIRE) == nb_workers &&
+				rte_ring_empty(pl->ring))
+			break;
+	}
+
+	return nb_tx;
+}
+
+static int
+perf_pipeline(struct rte_mempool *mp, struct rte_ring *ring,
+		enum perf_mode mode)
+{
+	struct perf_pipeline pl = {
+		.mode = mode,
+		.mp = mp,
+		.ring = ring,
+	};
+	uint64_t start, cycles, nb_tx;
+	double secs;
+
+	pl.b = rte_reorder_create_flags("reorder_perf", rte_socket_id(),
+			PERF_BUFFER_SIZE,
+			mode == PERF_MP_INSERT ? RTE_REORDER_F_MP_INSERT : 0);
+	if (pl.b == NULL) {
+		printf("Cannot create reorder buffer: %s\n",
+		       rte_strerror(rte_errno));
+		return -1;
+	}
+
+	start = rte_rdtsc_precise();
+	rte_eal_mp_remote_launch(perf_worker, &pl, SKIP_MAIN);
+	nb_tx = perf_tx(&pl);
+	cycles = rte_rdtsc_precise() - start;
+	rte_eal_mp_wait_lcore();
+	rte_reorder_free(pl.b);
+
+	secs = (double)cycles / rte_get_tsc_hz();
+	printf("%-14s %8u %10.2f %10" PRIu64 "\n", perf_mode_names[mode],
+	       rte_lcore_count() - 1, nb_tx / secs / 1e6,
+	       PERF_PIPELINE_PKTS - nb_tx);
+	return 0;
+}
+
+static int
+test_reorder_perf(void)
+{
+	struct rte_mempool *mp;
+	struct rte_ring *ring;
+	enum perf_mode mode;
+	int ret = 0;
+
+	mp = rte_pktmbuf_pool_create("reorder_perf_pool", PERF_NUM_MBUFS,
+				     PERF_MBUF_CACHE, 0,
+				     RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	ring = rte_ring_create("reorder_perf_ring", PERF_RING_SIZE,
+			       rte_socket_id(), RING_F_SC_DEQ);
+	if (mp == NULL || ring == NULL) {
+		printf("Cannot create mbuf pool or ring\n");
+		ret = -1;
+		goto out;
+	}
+
+	printf("\n### Single lcore, burst %u\n", PERF_BURST);
+	printf("%-14s %10s\n", "mode", "cycles/pkt");
+	for (mode = PERF_INSERT; mode <= PERF_MP_INSERT && ret == 0; mode++)
+		ret = perf_single_lcore(mp, mode);
+
+	if (ret == 0 && rte_lcore_count() < 2) {
+		printf("Not enough lcores for the pipeline test\n");
+		goto out;
+	}
+
+	printf("\n### Pipeline, TX on main lcore\n");
+	printf("%-14s %8s %10s %10s\n", "mode", "workers", "Mpps", "not_tx");
+	for (mode = PERF_INSERT; mode <= PERF_MP_INSERT && ret == 0; mode++)
+		ret = perf_pipeline(mp, ring, mode);
+
+out:
+	rte_ring_free(ring);
+	rte_mempool_free(mp);
+	return ret == 0 ? TEST_SUCCESS : TEST_FAILED;
+}
+
+REGISTER_TEST_COMMAND(reorder_perf_autotest, test_reorder_perf);
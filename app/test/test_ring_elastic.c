@@ -0,0 +1,354 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+#include <rte_random.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_ring.h>
+#include <rte_ring_elastic.h>
+
+#include "test.h"
+
+/*
+ * Elastic ring
+ * ============
+ *
+ * #. Functional tests: parameters, FIFO order across a growth, objects
+ *    enqueued late in the previous ring, seal, custom element size.
+ *
+ * #. Stress test: the worker lcores enqueue sequence numbers while the
+ *    main lcore dequeues them and grows the ring, sealing the previous
+ *    ring after a grace period of the producers. Every object must be
+ *    received once and in order.
+ */
+
+#define RING_SIZE 64
+#define BURST 8
+
+#define STRESS_OBJS (1 << 16)
+#define STRESS_GROWS 8
+
+static int
+test_ring_elastic_negative(void)
+{
+	struct rte_ring_elastic *er;
+	char name[RTE_RING_NAMESIZE];
+
+	memset(name, 'a', sizeof(name) - 1);
+	name[sizeof(name) - 1] = '\0';
+	er = rte_ring_elastic_create(name, sizeof(void *), RING_SIZE,
+			SOCKET_ID_ANY, 0);
+	TEST_ASSERT(er == NULL && rte_errno == ENAMETOOLONG,
+			"long name not rejected");
+
+	er = rte_ring_elastic_create("re_neg", 3, RING_SIZE, SOCKET_ID_ANY, 0);
+	TEST_ASSERT(er == NULL && rte_errno == EINVAL,
+			"invalid element size not rejected");
+
+	er = rte_ring_elastic_create("re_neg", sizeof(void *), RING_SIZE,
+			SOCKET_ID_ANY, 0);
+	TEST_ASSERT_NOT_NULL(er, "cannot create elastic ring");
+	TEST_ASSERT_EQUAL(rte_ring_elastic_grow(er, RING_SIZE / 2), -EINVAL,
+			"shrink not rejected");
+	TEST_ASSERT_EQUAL(rte_ring_elastic_grow(NULL, RING_SIZE * 2),
+			-EINVAL, "NULL ring not rejected");
+
+	/* nothing to seal */
+	rte_ring_elastic_seal(er);
+	rte_ring_elastic_free(er);
+	rte_ring_elastic_free(NULL);
+
+	/* an exact size ring can grow by one object, up to the ring limit */
+	er = rte_ring_elastic_create("re_neg", sizeof(void *), RING_SIZE,
+			SOCKET_ID_ANY, RING_F_EXACT_SZ);
+	TEST_ASSERT_NOT_NULL(er, "cannot create elastic ring");
+	while (er->nb_rings < RTE_RING_ELASTIC_MAX_RINGS) {
+		TEST_ASSERT_SUCCESS(rte_ring_elastic_grow(er,
+				rte_ring_elastic_get_capacity(er) + 1),
+				"cannot grow elastic ring");
+		rte_ring_elastic_seal(er);
+	}
+	TEST_ASSERT_EQUAL(rte_ring_elastic_get_capacity(er),
+			RING_SIZE + RTE_RING_ELASTIC_MAX_RINGS - 1,
+			"wrong capacity");
+	TEST_ASSERT_EQUAL(rte_ring_elastic_grow(er,
+			rte_ring_elastic_get_capacity(er) + 1), -ENOSPC,
+			"too many rings not rejected");
+	rte_ring_elastic_free(er);
+
+	return 0;
+}
+
+static int
+test_ring_elastic_fifo(void)
+{
+	struct rte_ring_elastic *er;
+	void *objs[RING_SIZE * 4];
+	unsigned int i, n, seq;
+	uintptr_t late;
+
+	er = rte_ring_elastic_create("re_fifo", sizeof(void *), RING_SIZE,
+			SOCKET_ID_ANY, 0);
+	TEST_ASSERT_NOT_NULL(er, "cannot create elastic ring");
+
+	/* fill the ring, then grow it and go on enqueuing */
+	for (i = 0; i < RTE_DIM(objs); i++)
+		objs[i] = (void *)(uintptr_t)i;
+	n = rte_ring_elastic_enqueue_burst(er, objs, RTE_DIM(objs), NULL);
+	TEST_ASSERT_EQUAL(n, RING_SIZE - 1, "ring not full");
+	TEST_ASSERT_EQUAL(rte_ring_elastic_enqueue_bulk(er, &objs[n], 1, NULL),
+			0, "enqueue in a full ring");
+
+	TEST_ASSERT_SUCCESS(rte_ring_elastic_grow(er, RING_SIZE * 4),
+			"cannot grow elastic ring");
+	TEST_ASSERT_EQUAL(rte_ring_elastic_grow(er, RING_SIZE * 8), -EBUSY,
+			"grow before seal not rejected");
+	TEST_ASSERT_EQUAL(rte_ring_elastic_get_capacity(er),
+			RING_SIZE * 4 - 1, "wrong capacity");
+	n += rte_ring_elastic_enqueue_bulk(er, &objs[n], RING_SIZE, NULL);
+	TEST_ASSERT_EQUAL(n, RING_SIZE * 2 - 1, "cannot enqueue");
+	TEST_ASSERT_EQUAL(rte_ring_elastic_count(er), n, "wrong count");
+
+	/* dequeue half of the previous ring */
+	seq = 0;
+	TEST_ASSERT_EQUAL(rte_ring_elastic_dequeue_burst(er, objs,
+			RING_SIZE / 2, NULL), RING_SIZE / 2, "cannot dequeue");
+	for (i = 0; i < RING_SIZE / 2; i++, seq++)
+		TEST_ASSERT_EQUAL((uintptr_t)objs[i], seq, "wrong order");
+
+	/* a late producer enqueues in the previous ring */
+	late = n;
+	TEST_ASSERT_EQUAL(rte_ring_enqueue(er->old, (void *)late), 0,
+			"cannot enqueue in the previous ring");
+
+	/* the previous ring is drained, not the current one until sealed */
+	n = rte_ring_elastic_dequeue_burst(er, objs, RTE_DIM(objs), NULL);
+	TEST_ASSERT_EQUAL(n, RING_SIZE / 2, "previous ring not drained");
+	for (i = 0; i < n - 1; i++, seq++)
+		TEST_ASSERT_EQUAL((uintptr_t)objs[i], seq, "wrong order");
+	TEST_ASSERT_EQUAL((uintptr_t)objs[n - 1], late, "late object lost");
+	TEST_ASSERT_EQUAL(rte_ring_elastic_dequeue_burst(er, objs,
+			RTE_DIM(objs), NULL), 0, "dequeue before seal");
+
+	rte_ring_elastic_seal(er);
+	n = rte_ring_elastic_dequeue_burst(er, objs, RTE_DIM(objs), NULL);
+	TEST_ASSERT_EQUAL(n, RING_SIZE, "current ring not dequeued");
+	for (i = 0; i < n; i++, seq++)
+		TEST_ASSERT_EQUAL((uintptr_t)objs[i], seq, "wrong order");
+	TEST_ASSERT_NULL(er->old, "previous ring not released");
+	TEST_ASSERT_EQUAL(rte_ring_elastic_count(er), 0, "wrong count");
+
+	/* a sealed empty ring does not prevent the next growth */
+	TEST_ASSERT_SUCCESS(rte_ring_elastic_grow(er, RING_SIZE * 8),
+			"cannot grow elastic ring");
+	rte_ring_elastic_seal(er);
+	TEST_ASSERT_SUCCESS(rte_ring_elastic_grow(er, RING_SIZE * 16),
+			"cannot grow sealed empty elastic ring");
+
+	rte_ring_elastic_dump(stdout, er);
+	rte_ring_elastic_free(er);
+
+	return 0;
+}
+
+struct elem {
+	uint64_t seq;
+	uint64_t pad;
+};
+
+static int
+test_ring_elastic_elem(void)
+{
+	struct rte_ring_elastic *er;
+	struct elem objs[RING_SIZE];
+	unsigned int i, n;
+
+	er = rte_ring_elastic_create("re_elem", sizeof(struct elem),
+			RING_SIZE, SOCKET_ID_ANY, RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT_NOT_NULL(er, "cannot create elastic ring");
+
+	for (i = 0; i < RING_SIZE; i++)
+		objs[i].seq = i;
+	n = rte_ring_elastic_enqueue_burst_elem(er, objs, sizeof(objs[0]),
+			RING_SIZE / 2, NULL);
+	TEST_ASSERT_EQUAL(n, RING_SIZE / 2, "cannot enqueue");
+
+	/* a single producer seals right after the growth */
+	TEST_ASSERT_SUCCESS(rte_ring_elastic_grow(er, RING_SIZE * 2),
+			"cannot grow elastic ring");
+	rte_ring_elastic_seal(er);
+	n = rte_ring_elastic_enqueue_bulk_elem(er, &objs[n], sizeof(objs[0]),
+			RING_SIZE / 2, NULL);
+	TEST_ASSERT_EQUAL(n, RING_SIZE / 2, "cannot enqueue");
+
+	memset(objs, 0, sizeof(objs));
+	n = 0;
+	while (n < RING_SIZE) {
+		i = rte_ring_elastic_dequeue_burst_elem(er, &objs[n],
+				sizeof(objs[0]), RING_SIZE - n, NULL);
+		TEST_ASSERT(i != 0, "cannot dequeue");
+		n += i;
+	}
+	for (i = 0; i < RING_SIZE; i++)
+		TEST_ASSERT_EQUAL(objs[i].seq, i, "wrong order");
+
+	rte_ring_elastic_free(er);
+
+	return 0;
+}
+
+static struct rte_ring_elastic *stress_er;
+static struct rte_rcu_qsbr *stress_qsv;
+static volatile int stress_stop;
+
+/* enqueue the producer id and a sequence number, in random bursts */
+static int
+stress_producer(void *arg __rte_unused)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	void *objs[BURST];
+	unsigned int sent, n, i;
+
+	rte_rcu_qsbr_thread_register(stress_qsv, lcore_id);
+	rte_rcu_qsbr_thread_online(stress_qsv, lcore_id);
+
+	for (sent = 0; sent < STRESS_OBJS && !stress_stop; sent += n) {
+		n = RTE_MIN(rte_rand() % BURST + 1, STRESS_OBJS - sent);
+		for (i = 0; i < n; i++)
+			objs[i] = (void *)(((uintptr_t)lcore_id << 24) |
+					(sent + i));
+		n = rte_ring_elastic_enqueue_burst(stress_er, objs, n, NULL);
+		/* the ring read by this thread is not used anymore */
+		rte_rcu_qsbr_quiescent(stress_qsv, lcore_id);
+		if (n == 0)
+			rte_pause();
+	}
+
+	rte_rcu_qsbr_thread_offline(stress_qsv, lcore_id);
+	rte_rcu_qsbr_thread_unregister(stress_qsv, lcore_id);
+
+	return 0;
+}
+
+static int
+test_ring_elastic_stress(void)
+{
+	uint32_t expected[RTE_MAX_LCORE] = { 0 };
+	unsigned int nb_workers, lcore_id, grows, n, i;
+	uint64_t received, total, tsc;
+	void *objs[BURST * 4];
+	uintptr_t obj;
+	int ret = -1;
+
+	nb_workers = rte_lcore_count() - 1;
+	if (nb_workers == 0) {
+		printf("not enough lcores for the stress test, skipped\n");
+		return 0;
+	}
+
+	stress_qsv = rte_zmalloc(NULL,
+			rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+			RTE_CACHE_LINE_SIZE);
+	stress_er = rte_ring_elastic_create("re_stress", sizeof(void *),
+			RING_SIZE, SOCKET_ID_ANY, RING_F_EXACT_SZ);
+	if (stress_qsv == NULL || stress_er == NULL ||
+			rte_rcu_qsbr_init(stress_qsv, RTE_MAX_LCORE) != 0) {
+		printf("cannot create elastic ring\n");
+		goto out;
+	}
+
+	stress_stop = 0;
+	rte_eal_mp_remote_launch(stress_producer, NULL, SKIP_MAIN);
+
+	total = (uint64_t)nb_workers * STRESS_OBJS;
+	grows = 0;
+	tsc = rte_get_timer_cycles() + 60 * rte_get_timer_hz();
+	for (received = 0; received < total; received += n) {
+		n = rte_ring_elastic_dequeue_burst(stress_er, objs,
+				RTE_DIM(objs), NULL);
+		for (i = 0; i < n; i++) {
+			obj = (uintptr_t)objs[i];
+			lcore_id = obj >> 24;
+			if (lcore_id >= RTE_MAX_LCORE ||
+					(obj & 0xffffff) != expected[lcore_id]) {
+				printf("lcore %u: got %" PRIuPTR ", expected %u\n",
+					lcore_id, obj & 0xffffff,
+					expected[lcore_id]);
+				break;
+			}
+			expected[lcore_id]++;
+		}
+		if (i != n)
+			break;
+
+		/* grow at regular intervals, seal after a grace period, the
+		 * previous ring may not be drained yet
+		 */
+		if (grows < STRESS_GROWS &&
+				received >= total * (grows + 1) /
+				(STRESS_GROWS + 1)) {
+			ret = rte_ring_elastic_grow(stress_er,
+				rte_ring_elastic_get_capacity(stress_er) * 2);
+			if (ret == 0) {
+				rte_rcu_qsbr_synchronize(stress_qsv,
+						RTE_QSBR_THRID_INVALID);
+				rte_ring_elastic_seal(stress_er);
+				grows++;
+			} else if (ret != -EBUSY) {
+				printf("cannot grow elastic ring\n");
+				break;
+			}
+			ret = -1;
+		}
+
+		if (n == 0 && rte_get_timer_cycles() > tsc) {
+			printf("stalled after %" PRIu64 "/%" PRIu64 " objects\n",
+				received, total);
+			rte_ring_elastic_dump(stdout, stress_er);
+			break;
+		}
+	}
+
+	stress_stop = 1;
+	rte_eal_mp_wait_lcore();
+
+	if (received == total && grows == STRESS_GROWS &&
+			rte_ring_elastic_count(stress_er) == 0)
+		ret = 0;
+	printf("elastic ring stress: %" PRIu64 " objects, %u growths\n",
+		received, grows);
+out:
+	rte_ring_elastic_free(stress_er);
+	stress_er = NULL;
+	rte_free(stress_qsv);
+	stress_qsv = NULL;
+	return ret;
+}
+
+static int
+test_ring_elastic(void)
+{
+	if (test_ring_elastic_negative() < 0)
+		return -1;
+	if (test_ring_elastic_fifo() < 0)
+		return -1;
+	if (test_ring_elastic_elem() < 0)
+		return -1;
+	if (test_ring_elastic_stress() < 0)
+		return -1;
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(ring_elastic_autotest, test_ring_elastic);
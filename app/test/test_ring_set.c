@@ -0,0 +1,491 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+#include <rte_random.h>
+#include <rte_ring.h>
+#include <rte_ring_set.h>
+
+#include "test.h"
+
+/*
+ * Ring set
+ * ========
+ *
+ * #. Functional tests: parameters, doorbells, round-robin and priority
+ *    policies, notification of objects enqueued with the ring API,
+ *    custom element size.
+ *
+ * #. Stress test: each worker lcore enqueues sequence numbers in its own
+ *    rings, the main lcore dequeues them from the set and checks that every
+ *    object is received once and in order, while the rings go empty and
+ *    non-empty all the time.
+ *
+ * #. Performance tests are in test_ring_set_perf.c
+ */
+
+#define RING_SIZE 1024
+#define NB_RINGS 130
+#define BURST 8
+
+#define STRESS_RINGS_PER_LCORE 4
+#define STRESS_OBJS (1 << 20)
+
+static struct rte_ring *rings[RTE_RING_SET_MAX_RINGS];
+
+static void
+free_set(struct rte_ring_set *set, unsigned int nb_rings)
+{
+	unsigned int i;
+
+	for (i = 0; i < nb_rings; i++) {
+		rte_ring_free(rings[i]);
+		rings[i] = NULL;
+	}
+	rte_ring_set_free(set);
+}
+
+static struct rte_ring_set *
+create_set(const char *name, unsigned int nb_rings, unsigned int set_flags,
+	unsigned int esize, unsigned int ring_flags)
+{
+	char ring_name[RTE_RING_NAMESIZE];
+	struct rte_ring_set *set;
+	unsigned int i;
+
+	set = rte_ring_set_create(name, nb_rings, SOCKET_ID_ANY, set_flags);
+	if (set == NULL)
+		return NULL;
+
+	for (i = 0; i < nb_rings; i++) {
+		snprintf(ring_name, sizeof(ring_name), "%s_%u", name, i);
+		rings[i] = rte_ring_create_elem(ring_name, esize, RING_SIZE,
+				SOCKET_ID_ANY, ring_flags);
+		if (rings[i] == NULL ||
+				rte_ring_set_add(set, rings[i]) != (int)i) {
+			free_set(set, nb_rings);
+			return NULL;
+		}
+	}
+
+	return set;
+}
+
+static int
+test_ring_set_negative(void)
+{
+	struct rte_ring_set *set;
+	struct rte_ring *r;
+
+	set = rte_ring_set_create("rs_neg", 0, SOCKET_ID_ANY, 0);
+	TEST_ASSERT(set == NULL && rte_errno == EINVAL,
+		"set created with no ring");
+	set = rte_ring_set_create("rs_neg", RTE_RING_SET_MAX_RINGS + 1,
+			SOCKET_ID_ANY, 0);
+	TEST_ASSERT(set == NULL && rte_errno == EINVAL,
+		"set created with too many rings");
+	set = rte_ring_set_create("rs_neg", 1, SOCKET_ID_ANY, 0x8000);
+	TEST_ASSERT(set == NULL && rte_errno == EINVAL,
+		"set created with invalid flags");
+	set = rte_ring_set_create("rs_neg_with_a_name_much_too_long", 1,
+			SOCKET_ID_ANY, 0);
+	TEST_ASSERT(set == NULL && rte_errno == ENAMETOOLONG,
+		"set created with a too long name");
+
+	set = rte_ring_set_create("rs_neg", 1, SOCKET_ID_ANY, 0);
+	TEST_ASSERT_NOT_NULL(set, "cannot create set");
+	r = rte_ring_create("rs_neg_0", RING_SIZE, SOCKET_ID_ANY, 0);
+	TEST_ASSERT_NOT_NULL(r, "cannot create ring");
+
+	TEST_ASSERT_EQUAL(rte_ring_set_add(set, NULL), -EINVAL,
+		"NULL ring added");
+	TEST_ASSERT_EQUAL(rte_ring_set_add(set, r), 0, "cannot add ring");
+	TEST_ASSERT_EQUAL(rte_ring_set_add(set, r), -ENOSPC,
+		"ring added to a full set");
+
+	rte_ring_free(r);
+	rte_ring_set_free(set);
+	return 0;
+}
+
+static int
+test_ring_set_round_robin(void)
+{
+	static const unsigned int used[] = { 5, 63, 64, 70, 129 };
+	void *objs[BURST * 2];
+	struct rte_ring_set *set;
+	unsigned int i, j, n, idx;
+	int ret = -1;
+
+	set = create_set("rs_rr", NB_RINGS, 0, sizeof(void *), 0);
+	if (set == NULL) {
+		printf("cannot create ring set\n");
+		goto out;
+	}
+
+	if (rte_ring_set_dequeue_burst(set, objs, BURST, &idx) != 0) {
+		printf("objects dequeued from an empty set\n");
+		goto out;
+	}
+
+	/* two bursts in each used ring */
+	for (i = 0; i < RTE_DIM(used); i++) {
+		for (j = 0; j < BURST * 2; j++)
+			objs[j] = (void *)(uintptr_t)(used[i] << 16 | j);
+		if (rte_ring_set_enqueue_burst(set, used[i], objs, BURST * 2,
+				NULL) != BURST * 2) {
+			printf("cannot enqueue in ring %u\n", used[i]);
+			goto out;
+		}
+	}
+
+	/* the rings are served in turn, a burst at a time */
+	for (j = 0; j < 2; j++) {
+		for (i = 0; i < RTE_DIM(used); i++) {
+			idx = UINT_MAX;
+			n = rte_ring_set_dequeue_burst(set, objs, BURST, &idx);
+			if (n != BURST || idx != used[i] ||
+					(uintptr_t)objs[0] !=
+					(used[i] << 16 | j * BURST)) {
+				printf("round %u: got %u objects from ring %u, expected ring %u\n",
+					j, n, idx, used[i]);
+				goto out;
+			}
+		}
+	}
+
+	if (rte_ring_set_dequeue_burst(set, objs, BURST, &idx) != 0) {
+		printf("objects dequeued from an empty set\n");
+		goto out;
+	}
+
+	for (i = 0; i < RTE_ALIGN_CEIL(NB_RINGS, 64) / 64; i++) {
+		if (set->doorbell[i] != 0) {
+			printf("doorbell word %u not cleared: %#" PRIx64 "\n",
+				i, set->doorbell[i]);
+			goto out;
+		}
+	}
+
+	ret = 0;
+out:
+	if (ret != 0 && set != NULL)
+		rte_ring_set_dump(stdout, set);
+	free_set(set, NB_RINGS);
+	return ret;
+}
+
+static int
+test_ring_set_priority(void)
+{
+	void *objs[BURST];
+	struct rte_ring_set *set;
+	unsigned int i, n, idx;
+	int ret = -1;
+
+	set = create_set("rs_prio", 8, RTE_RING_SET_F_PRIORITY,
+			sizeof(void *), 0);
+	if (set == NULL) {
+		printf("cannot create ring set\n");
+		goto out;
+	}
+
+	for (i = 0; i < BURST; i++)
+		objs[i] = (void *)(uintptr_t)i;
+	if (rte_ring_set_enqueue_bulk(set, 6, objs, BURST, NULL) != BURST ||
+			rte_ring_set_enqueue_bulk(set, 2, objs, BURST,
+				NULL) != BURST) {
+		printf("cannot enqueue\n");
+		goto out;
+	}
+
+	/* ring 2 is drained before ring 6, even across calls */
+	for (i = 0; i < BURST; i++) {
+		idx = UINT_MAX;
+		n = rte_ring_set_dequeue_burst(set, objs, 1, &idx);
+		if (n != 1 || idx != 2) {
+			printf("got %u objects from ring %u, expected ring 2\n",
+				n, idx);
+			goto out;
+		}
+	}
+	idx = UINT_MAX;
+	n = rte_ring_set_dequeue_burst(set, objs, 1, &idx);
+	if (n != 1 || idx != 6) {
+		printf("got %u objects from ring %u, expected ring 6\n",
+			n, idx);
+		goto out;
+	}
+
+	/* ring 2 is served first as soon as it has objects again */
+	if (rte_ring_set_enqueue_bulk(set, 2, objs, 1, NULL) != 1) {
+		printf("cannot enqueue\n");
+		goto out;
+	}
+	idx = UINT_MAX;
+	n = rte_ring_set_dequeue_burst(set, objs, BURST, &idx);
+	if (n != 1 || idx != 2) {
+		printf("got %u objects from ring %u, expected ring 2\n",
+			n, idx);
+		goto out;
+	}
+
+	idx = UINT_MAX;
+	n = rte_ring_set_dequeue_burst(set, objs, BURST, &idx);
+	if (n != BURST - 1 || idx != 6) {
+		printf("got %u objects from ring %u, expected %u from ring 6\n",
+			n, idx, BURST - 1);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	if (ret != 0 && set != NULL)
+		rte_ring_set_dump(stdout, set);
+	free_set(set, 8);
+	return ret;
+}
+
+static int
+test_ring_set_notify(void)
+{
+	struct rte_ring_set *set;
+	struct rte_ring *r;
+	void *objs[BURST];
+	unsigned int n, idx;
+	int ret = -1;
+
+	set = create_set("rs_notify", 4, 0, sizeof(void *), 0);
+	if (set == NULL) {
+		printf("cannot create ring set\n");
+		goto out;
+	}
+
+	memset(objs, 0, sizeof(objs));
+
+	/* enqueued with the ring API, not seen until notified */
+	if (rte_ring_enqueue_burst(rings[3], objs, BURST, NULL) != BURST) {
+		printf("cannot enqueue\n");
+		goto out;
+	}
+	if (rte_ring_set_dequeue_burst(set, objs, BURST, &idx) != 0) {
+		printf("objects dequeued without doorbell\n");
+		goto out;
+	}
+	rte_ring_set_notify(set, 3);
+	idx = UINT_MAX;
+	n = rte_ring_set_dequeue_burst(set, objs, BURST, &idx);
+	if (n != BURST || idx != 3) {
+		printf("got %u objects from ring %u after notify\n", n, idx);
+		goto out;
+	}
+
+	/* a ring holding objects when added rings its doorbell */
+	r = rte_ring_create("rs_notify_x", RING_SIZE, SOCKET_ID_ANY, 0);
+	if (r == NULL || rte_ring_enqueue_burst(r, objs, 1, NULL) != 1) {
+		printf("cannot create ring\n");
+		rte_ring_free(r);
+		goto out;
+	}
+	rte_ring_set_free(set);
+	set = rte_ring_set_create("rs_notify", 1, SOCKET_ID_ANY, 0);
+	if (set == NULL || rte_ring_set_add(set, r) != 0 ||
+			rte_ring_set_dequeue_burst(set, objs, BURST,
+				&idx) != 1) {
+		printf("objects of an added ring not dequeued\n");
+		rte_ring_free(r);
+		goto out;
+	}
+	rte_ring_free(r);
+
+	ret = 0;
+out:
+	rte_ring_set_free(set);
+	free_set(NULL, 4);
+	return ret;
+}
+
+struct elem16 {
+	uint64_t a;
+	uint64_t b;
+};
+
+static int
+test_ring_set_elem(void)
+{
+	struct elem16 in[BURST], out[BURST];
+	struct rte_ring_set *set;
+	unsigned int i, n, idx;
+	int ret = -1;
+
+	set = create_set("rs_elem", 3, 0, sizeof(struct elem16),
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	if (set == NULL) {
+		printf("cannot create ring set\n");
+		goto out;
+	}
+
+	for (i = 0; i < BURST; i++) {
+		in[i].a = i;
+		in[i].b = ~(uint64_t)i;
+	}
+	if (rte_ring_set_enqueue_burst_elem(set, 1, in, sizeof(in[0]), BURST,
+			NULL) != BURST) {
+		printf("cannot enqueue\n");
+		goto out;
+	}
+	memset(out, 0, sizeof(out));
+	idx = UINT_MAX;
+	n = rte_ring_set_dequeue_burst_elem(set, out, sizeof(out[0]), BURST,
+			&idx);
+	if (n != BURST || idx != 1 || memcmp(in, out, sizeof(in)) != 0) {
+		printf("bad objects dequeued from ring %u\n", idx);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	free_set(set, 3);
+	return ret;
+}
+
+struct stress_args {
+	struct rte_ring_set *set;
+	unsigned int first_ring;
+	unsigned int nb_objs;
+};
+
+static struct stress_args stress_args[RTE_MAX_LCORE];
+static volatile int stress_stop;
+
+/* enqueue sequence numbers in the rings of the lcore, in random bursts */
+static int
+stress_producer(void *arg)
+{
+	struct stress_args *a = arg;
+	uint64_t seq[STRESS_RINGS_PER_LCORE] = { 0 };
+	void *objs[BURST];
+	unsigned int sent, r, n, i;
+
+	for (sent = 0; sent < a->nb_objs && !stress_stop; sent += n) {
+		r = rte_rand() % STRESS_RINGS_PER_LCORE;
+		n = RTE_MIN(rte_rand() % BURST + 1, a->nb_objs - sent);
+		for (i = 0; i < n; i++)
+			objs[i] = (void *)(uintptr_t)(seq[r] + i);
+		n = rte_ring_set_enqueue_burst(a->set, a->first_ring + r,
+				objs, n, NULL);
+		seq[r] += n;
+		if (n == 0)
+			rte_pause();
+	}
+
+	return 0;
+}
+
+static int
+test_ring_set_stress(void)
+{
+	uint64_t *expected = NULL;
+	struct rte_ring_set *set;
+	unsigned int lcore_id, nb_workers, nb_rings, n, idx, i;
+	uint64_t received, total, tsc;
+	void *objs[BURST * 4];
+	int ret = -1;
+
+	nb_workers = rte_lcore_count() - 1;
+	if (nb_workers == 0) {
+		printf("not enough lcores for the stress test, skipped\n");
+		return 0;
+	}
+	nb_rings = RTE_MIN(nb_workers * STRESS_RINGS_PER_LCORE,
+			(unsigned int)RTE_RING_SET_MAX_RINGS);
+	nb_workers = nb_rings / STRESS_RINGS_PER_LCORE;
+
+	set = create_set("rs_stress", nb_rings, 0, sizeof(void *),
+			RING_F_SP_ENQ | RING_F_SC_DEQ);
+	expected = rte_zmalloc(NULL, nb_rings * sizeof(*expected), 0);
+	if (set == NULL || expected == NULL) {
+		printf("cannot create ring set\n");
+		goto out;
+	}
+
+	stress_stop = 0;
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (i == nb_workers)
+			break;
+		stress_args[lcore_id].set = set;
+		stress_args[lcore_id].first_ring = i * STRESS_RINGS_PER_LCORE;
+		stress_args[lcore_id].nb_objs = STRESS_OBJS;
+		rte_eal_remote_launch(stress_producer,
+				&stress_args[lcore_id], lcore_id);
+		i++;
+	}
+
+	total = (uint64_t)nb_workers * STRESS_OBJS;
+	tsc = rte_get_timer_cycles() + 60 * rte_get_timer_hz();
+	for (received = 0; received < total; received += n) {
+		n = rte_ring_set_dequeue_burst(set, objs, RTE_DIM(objs), &idx);
+		for (i = 0; i < n; i++) {
+			if ((uintptr_t)objs[i] != expected[idx]) {
+				printf("ring %u: got %" PRIuPTR ", expected %" PRIu64 "\n",
+					idx, (uintptr_t)objs[i], expected[idx]);
+				break;
+			}
+			expected[idx]++;
+		}
+		if (i != n)
+			break;
+		if (n == 0 && rte_get_timer_cycles() > tsc) {
+			printf("stalled after %" PRIu64 "/%" PRIu64 " objects\n",
+				received, total);
+			rte_ring_set_dump(stdout, set);
+			break;
+		}
+	}
+
+	stress_stop = 1;
+	rte_eal_mp_wait_lcore();
+
+	if (received == total)
+		ret = 0;
+	printf("ring set stress: %" PRIu64 " objects through %u rings\n",
+		received, nb_rings);
+out:
+	rte_free(expected);
+	free_set(set, nb_rings);
+	return ret;
+}
+
+static int
+test_ring_set(void)
+{
+	if (test_ring_set_negative() < 0)
+		return -1;
+	if (test_ring_set_round_robin() < 0)
+		return -1;
+	if (test_ring_set_priority() < 0)
+		return -1;
+	if (test_ring_set_notify() < 0)
+		return -1;
+	if (test_ring_set_elem() < 0)
+		return -1;
+	if (test_ring_set_stress() < 0)
+		return -1;
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(ring_set_autotest, test_ring_set);
@@ -0,0 +1,262 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+#include <rte_ring_set.h>
+
+#include "test.h"
+
+/*
+ * Ring set performance test cases, compare a consumer polling each of its
+ * rings in turn with rte_ring_dequeue_burst() to a consumer dequeuing from
+ * a ring set.
+ *
+ * #. Poll: on one core, *active* rings out of *nb_rings* hold objects.
+ *    A poll dequeues a burst from every ring with objects and enqueues the
+ *    objects back in their ring. Reported in cycles per poll.
+ *
+ * #. Pipeline: each worker lcore enqueues objects in a ring out of
+ *    *nb_rings* and the main lcore dequeues them. Reported in cycles per
+ *    object on the main lcore.
+ */
+
+#define RING_SIZE 1024
+#define MAX_RINGS 256
+#define BURST 32
+#define POLL_ITERATIONS (1 << 16)
+#define PIPELINE_OBJS (1 << 22)
+
+static struct rte_ring *rings[MAX_RINGS];
+static struct rte_ring_set *set;
+
+static int
+create_rings(unsigned int nb_rings)
+{
+	char name[RTE_RING_NAMESIZE];
+	unsigned int i;
+
+	set = rte_ring_set_create("RS_PERF", nb_rings, SOCKET_ID_ANY, 0);
+	if (set == NULL)
+		return -1;
+
+	for (i = 0; i < nb_rings; i++) {
+		snprintf(name, sizeof(name), "RS_PERF_%u", i);
+		rings[i] = rte_ring_create(name, RING_SIZE, SOCKET_ID_ANY,
+				RING_F_SC_DEQ);
+		if (rings[i] == NULL || rte_ring_set_add(set, rings[i]) < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+static void
+free_rings(unsigned int nb_rings)
+{
+	unsigned int i;
+
+	for (i = 0; i < nb_rings; i++) {
+		rte_ring_free(rings[i]);
+		rings[i] = NULL;
+	}
+	rte_ring_set_free(set);
+	set = NULL;
+}
+
+/* the active rings are spread among all the rings */
+static inline unsigned int
+active_ring(unsigned int nb_rings, unsigned int nb_active, unsigned int i)
+{
+	return i * (nb_rings / nb_active);
+}
+
+static int
+test_poll(unsigned int nb_rings, unsigned int nb_active)
+{
+	void *objs[BURST] = { NULL };
+	uint64_t start, loop_cycles, set_cycles;
+	unsigned int iter, i, n, idx;
+	int ret = -1;
+
+	if (create_rings(nb_rings) < 0) {
+		printf("cannot create rings\n");
+		goto out;
+	}
+
+	for (i = 0; i < nb_active; i++)
+		rte_ring_set_enqueue_burst(set,
+			active_ring(nb_rings, nb_active, i), objs, BURST, NULL);
+
+	start = rte_rdtsc();
+	for (iter = 0; iter < POLL_ITERATIONS; iter++) {
+		for (i = 0; i < nb_rings; i++) {
+			n = rte_ring_dequeue_burst(rings[i], objs, BURST,
+					NULL);
+			if (n != 0)
+				rte_ring_enqueue_burst(rings[i], objs, n,
+						NULL);
+		}
+	}
+	loop_cycles = rte_rdtsc() - start;
+
+	start = rte_rdtsc();
+	for (iter = 0; iter < POLL_ITERATIONS; iter++) {
+		for (i = 0; i < nb_active; i++) {
+			n = rte_ring_set_dequeue_burst(set, objs, BURST, &idx);
+			if (n == 0)
+				break;
+			rte_ring_set_enqueue_burst(set, idx, objs, n, NULL);
+		}
+		/* the poll ends on an empty dequeue when no ring is active */
+		if (nb_active == 0)
+			rte_ring_set_dequeue_burst(set, objs, BURST, &idx);
+	}
+	set_cycles = rte_rdtsc() - start;
+
+	printf("%3u rings, %3u active: ring loop %8.2f, ring set %8.2f cycles per poll\n",
+		nb_rings, nb_active,
+		(double)loop_cycles / POLL_ITERATIONS,
+		(double)set_cycles / POLL_ITERATIONS);
+	ret = 0;
+out:
+	free_rings(nb_rings);
+	return ret;
+}
+
+struct pipeline_args {
+	unsigned int ring;
+	int use_set;
+};
+
+static struct pipeline_args pipeline_args[RTE_MAX_LCORE];
+
+static int
+pipeline_producer(void *arg)
+{
+	struct pipeline_args *a = arg;
+	void *objs[BURST] = { NULL };
+	unsigned int sent, n;
+
+	for (sent = 0; sent < PIPELINE_OBJS; sent += n) {
+		if (a->use_set)
+			n = rte_ring_set_enqueue_burst(set, a->ring, objs,
+					BURST, NULL);
+		else
+			n = rte_ring_enqueue_burst(rings[a->ring], objs,
+					BURST, NULL);
+		if (n == 0)
+			rte_pause();
+	}
+
+	return 0;
+}
+
+static int
+run_pipeline(unsigned int nb_rings, unsigned int nb_producers, int use_set,
+	double *cycles_per_obj)
+{
+	void *objs[BURST];
+	unsigned int lcore_id, i, n, idx;
+	uint64_t received, total, start;
+
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (i == nb_producers)
+			break;
+		pipeline_args[lcore_id].ring =
+			active_ring(nb_rings, nb_producers, i);
+		pipeline_args[lcore_id].use_set = use_set;
+		rte_eal_remote_launch(pipeline_producer,
+				&pipeline_args[lcore_id], lcore_id);
+		i++;
+	}
+
+	total = (uint64_t)nb_producers * PIPELINE_OBJS;
+	received = 0;
+	start = rte_rdtsc();
+	if (use_set) {
+		while (received < total) {
+			received += rte_ring_set_dequeue_burst(set, objs,
+					BURST, &idx);
+		}
+	} else {
+		while (received < total) {
+			for (i = 0; i < nb_rings; i++) {
+				n = rte_ring_dequeue_burst(rings[i], objs,
+						BURST, NULL);
+				received += n;
+			}
+		}
+	}
+	*cycles_per_obj = (double)(rte_rdtsc() - start) / total;
+
+	rte_eal_mp_wait_lcore();
+	return 0;
+}
+
+static int
+test_pipeline(unsigned int nb_rings)
+{
+	unsigned int nb_producers;
+	double loop, rset;
+	int ret = -1;
+
+	nb_producers = RTE_MIN(rte_lcore_count() - 1, nb_rings);
+	if (nb_producers == 0) {
+		printf("not enough lcores for the pipeline test, skipped\n");
+		return 0;
+	}
+
+	if (create_rings(nb_rings) < 0) {
+		printf("cannot create rings\n");
+		goto out;
+	}
+
+	if (run_pipeline(nb_rings, nb_producers, 0, &loop) < 0 ||
+			run_pipeline(nb_rings, nb_producers, 1, &rset) < 0)
+		goto out;
+
+	printf("%3u rings, %3u producers: ring loop %8.2f, ring set %8.2f cycles per object\n",
+		nb_rings, nb_producers, loop, rset);
+	ret = 0;
+out:
+	free_rings(nb_rings);
+	return ret;
+}
+
+static int
+test_ring_set_perf(void)
+{
+	static const unsigned int nb_rings_tab[] = { 16, 64, MAX_RINGS };
+	static const unsigned int nb_active_tab[] = { 0, 1, 4, 16 };
+	unsigned int i, j;
+
+	printf("\n### Ring set poll test ###\n");
+	for (i = 0; i < RTE_DIM(nb_rings_tab); i++) {
+		for (j = 0; j < RTE_DIM(nb_active_tab); j++) {
+			if (nb_active_tab[j] > nb_rings_tab[i])
+				continue;
+			if (test_poll(nb_rings_tab[i], nb_active_tab[j]) < 0)
+				return -1;
+		}
+	}
+
+	printf("\n### Ring set pipeline test ###\n");
+	for (i = 0; i < RTE_DIM(nb_rings_tab); i++) {
+		if (test_pipeline(nb_rings_tab[i]) < 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(ring_set_perf_autotest, test_ring_set_perf);
@@ -0,0 +1,395 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_swx_port.h>
+#include <rte_swx_table_em.h>
+#include <rte_swx_pipeline.h>
+#include <rte_swx_ctl.h>
+
+#include "test.h"
+
+/*
+ * Interpreted versus generated code throughput of the SWX pipeline, measured
+ * on the specification files of the pipeline example application that have
+ * actions. The generated code has to be compiled against the DPDK headers: when
+ * these are not installed, the RTE_SWX_PIPELINE_INCLUDE_PATH environment
+ * variable has to list their directories, otherwise the test is skipped. When
+ * this variable is set, the test fails if the code generation fails.
+ */
+#ifndef SWX_PIPELINE_EXAMPLES_DIR
+#define SWX_PIPELINE_EXAMPLES_DIR "examples/pipeline/examples"
+#endif
+
+#define N_PORTS_IN 4
+#define N_PORTS_OUT 5
+#define N_PKTS (1 << 22)
+#define N_PKTS_VERIFY 4096
+#define N_INSTRUCTIONS 1024
+
+#define PKT_HEADROOM 128
+#define PKT_SIZE 64
+#define PKT_BUF_SIZE (PKT_HEADROOM + PKT_SIZE)
+#define N_PKT_BUFS 64
+
+static const struct {
+	const char *spec;
+	const char *table_name;
+	const char *table_file;
+} pipeline_specs[] = {
+	{"l2fwd.spec", NULL, NULL},
+	{"l2fwd_macswp.spec", NULL, NULL},
+	{"vxlan.spec", "vxlan_table", "vxlan_table.txt"},
+};
+
+/*
+ * Memory ports: the input port replays a set of template packets, the output
+ * port counts the packets and computes a digest of the first n_pkts_digest
+ * ones.
+ */
+static uint8_t pkt_templates[N_PKT_BUFS][PKT_SIZE];
+
+struct mem_port_in {
+	uint8_t bufs[N_PKT_BUFS][PKT_BUF_SIZE];
+	uint32_t pos;
+};
+
+static uint64_t n_pkts_out;
+static uint64_t n_pkts_digest;
+static uint64_t pkts_out_digest;
+
+static void *
+mem_port_in_create(void *args __rte_unused)
+{
+	return calloc(1, sizeof(struct mem_port_in));
+}
+
+static void
+mem_port_in_free(void *port)
+{
+	free(port);
+}
+
+static int
+mem_port_in_pkt_rx(void *port, struct rte_swx_pkt *pkt)
+{
+	struct mem_port_in *p = port;
+	uint32_t pos = p->pos++ & (N_PKT_BUFS - 1);
+	uint8_t *buf = p->bufs[pos];
+
+	/* The pipeline threads hold up to one packet each, the buffer is free
+	 * again by the time the input port wraps around.
+	 */
+	memcpy(&buf[PKT_HEADROOM], pkt_templates[pos], PKT_SIZE);
+
+	pkt->handle = NULL;
+	pkt->pkt = buf;
+	pkt->offset = PKT_HEADROOM;
+	pkt->length = PKT_SIZE;
+
+	return 1;
+}
+
+static void
+mem_port_in_stats_read(void *port __rte_unused,
+		       struct rte_swx_port_in_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+
+static struct rte_swx_port_in_ops mem_port_in_ops = {
+	.create = mem_port_in_create,
+	.free = mem_port_in_free,
+	.pkt_rx = mem_port_in_pkt_rx,
+	.stats_read = mem_port_in_stats_read,
+};
+
+static void *
+mem_port_out_create(void *args)
+{
+	return args;
+}
+
+static void
+mem_port_out_free(void *port __rte_unused)
+{
+}
+
+static void
+mem_port_out_pkt_tx(void *port, struct rte_swx_pkt *pkt)
+{
+	if (n_pkts_out++ < n_pkts_digest) {
+		uint8_t *data = &pkt->pkt[pkt->offset];
+		uint32_t i;
+
+		pkts_out_digest = pkts_out_digest * 31 + (uintptr_t)port;
+		pkts_out_digest = pkts_out_digest * 31 + pkt->length;
+		for (i = 0; i < pkt->length; i++)
+			pkts_out_digest = pkts_out_digest * 31 + data[i];
+	}
+}
+
+static void
+mem_port_out_stats_read(void *port __rte_unused,
+			struct rte_swx_port_out_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+
+static struct rte_swx_port_out_ops mem_port_out_ops = {
+	.create = mem_port_out_create,
+	.free = mem_port_out_free,
+	.pkt_tx = mem_port_out_pkt_tx,
+	.flush = NULL,
+	.stats_read = mem_port_out_stats_read,
+};
+
+static void
+pkt_templates_init(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < N_PKT_BUFS; i++) {
+		uint8_t *pkt = pkt_templates[i];
+		uint32_t j;
+
+		memset(pkt, 0, PKT_SIZE);
+
+		/* Ethernet: destination address aa:bb:cc:dd:00:xx matching the
+		 * entries of the VXLAN example table, IPv4 ethertype.
+		 */
+		pkt[0] = 0xaa;
+		pkt[1] = 0xbb;
+		pkt[2] = 0xcc;
+		pkt[3] = 0xdd;
+		pkt[4] = 0x00;
+		pkt[5] = i & 0xF;
+		for (j = 6; j < 12; j++)
+			pkt[j] = (uint8_t)(i + j);
+		pkt[12] = 0x08;
+		pkt[13] = 0x00;
+
+		/* IPv4: version, IHL, total length, TTL, protocol, addresses. */
+		pkt[14] = 0x45;
+		pkt[16] = 0;
+		pkt[17] = PKT_SIZE - 14;
+		pkt[22] = 64;
+		pkt[23] = 17;
+		for (j = 26; j < 34; j++)
+			pkt[j] = (uint8_t)(i * j);
+	}
+}
+
+static void
+table_entry_free(struct rte_swx_table_entry *entry)
+{
+	if (!entry)
+		return;
+
+	free(entry->key);
+	free(entry->key_mask);
+	free(entry->action_data);
+	free(entry);
+}
+
+static int
+pipeline_table_load(struct rte_swx_pipeline *p,
+		    const char *table_name,
+		    const char *table_file)
+{
+	struct rte_swx_ctl_pipeline *ctl;
+	char path[PATH_MAX], line[2048];
+	FILE *f;
+	int status = 0;
+
+	ctl = rte_swx_ctl_pipeline_create(p);
+	if (!ctl)
+		return -1;
+
+	snprintf(path, sizeof(path), "%s/%s", SWX_PIPELINE_EXAMPLES_DIR,
+		 table_file);
+	f = fopen(path, "r");
+	if (!f) {
+		rte_swx_ctl_pipeline_free(ctl);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), f)) {
+		struct rte_swx_table_entry *entry;
+		int is_blank_or_comment;
+
+		entry = rte_swx_ctl_pipeline_table_entry_read(ctl,
+			table_name,
+			line,
+			&is_blank_or_comment);
+		if (!entry) {
+			if (is_blank_or_comment)
+				continue;
+
+			status = -1;
+			break;
+		}
+
+		status = rte_swx_ctl_pipeline_table_entry_add(ctl,
+			table_name,
+			entry);
+		table_entry_free(entry);
+		if (status)
+			break;
+	}
+
+	fclose(f);
+
+	if (!status)
+		status = rte_swx_ctl_pipeline_commit(ctl, 1);
+
+	rte_swx_ctl_pipeline_free(ctl);
+	return status;
+}
+
+static struct rte_swx_pipeline *
+pipeline_create(uint32_t spec_id, int codegen)
+{
+	struct rte_swx_pipeline *p = NULL;
+	char path[PATH_MAX];
+	const char *err_msg;
+	uint32_t err_line, i;
+	FILE *spec;
+	int status;
+
+	status = rte_swx_pipeline_config(&p, 0);
+	if (status)
+		return NULL;
+
+	status = rte_swx_pipeline_port_in_type_register(p, "mem",
+		&mem_port_in_ops);
+	status |= rte_swx_pipeline_port_out_type_register(p, "mem",
+		&mem_port_out_ops);
+	status |= rte_swx_pipeline_table_type_register(p, "exact",
+		RTE_SWX_TABLE_MATCH_EXACT, &rte_swx_table_exact_match_ops);
+	for (i = 0; i < N_PORTS_IN; i++)
+		status |= rte_swx_pipeline_port_in_config(p, i, "mem", NULL);
+	for (i = 0; i < N_PORTS_OUT; i++)
+		status |= rte_swx_pipeline_port_out_config(p, i, "mem",
+			(void *)(uintptr_t)(i + 1));
+	if (status)
+		goto error;
+
+	if (codegen && rte_swx_pipeline_codegen_enable(p, NULL))
+		goto error;
+
+	snprintf(path, sizeof(path), "%s/%s", SWX_PIPELINE_EXAMPLES_DIR,
+		 pipeline_specs[spec_id].spec);
+	spec = fopen(path, "r");
+	if (!spec) {
+		printf("Cannot open %s\n", path);
+		goto error;
+	}
+
+	status = rte_swx_pipeline_build_from_spec(p, spec, &err_line, &err_msg);
+	fclose(spec);
+	if (status) {
+		printf("%s: line %u: %s\n", path, err_line, err_msg);
+		goto error;
+	}
+
+	if (pipeline_specs[spec_id].table_file &&
+	    pipeline_table_load(p,
+				pipeline_specs[spec_id].table_name,
+				pipeline_specs[spec_id].table_file)) {
+		printf("Cannot load table %s\n",
+		       pipeline_specs[spec_id].table_name);
+		goto error;
+	}
+
+	return p;
+
+error:
+	rte_swx_pipeline_free(p);
+	return NULL;
+}
+
+static void
+pipeline_run(struct rte_swx_pipeline *p, uint64_t n_pkts)
+{
+	n_pkts_out = 0;
+
+	while (n_pkts_out < n_pkts)
+		rte_swx_pipeline_run(p, N_INSTRUCTIONS);
+}
+
+static int
+test_swx_pipeline_perf(void)
+{
+	uint32_t i;
+
+	pkt_templates_init();
+
+	printf("%-24s%16s%16s%10s\n", "Specification", "Interpreted",
+	       "Generated", "Actions");
+
+	for (i = 0; i < RTE_DIM(pipeline_specs); i++) {
+		struct rte_swx_pipeline *p[2];
+		uint64_t digest[2], cycles[2];
+		int mode, n_actions = 0;
+
+		for (mode = 0; mode < 2; mode++) {
+			uint64_t start;
+
+			p[mode] = pipeline_create(i, mode);
+			TEST_ASSERT_NOT_NULL(p[mode],
+				"Cannot create pipeline for %s",
+				pipeline_specs[i].spec);
+
+			/* Output check. */
+			pkts_out_digest = 0;
+			n_pkts_digest = N_PKTS_VERIFY;
+			pipeline_run(p[mode], N_PKTS_VERIFY);
+			n_pkts_digest = 0;
+			digest[mode] = pkts_out_digest;
+
+			/* Throughput. */
+			start = rte_rdtsc_precise();
+			pipeline_run(p[mode], N_PKTS);
+			cycles[mode] = rte_rdtsc_precise() - start;
+
+			if (mode)
+				n_actions = rte_swx_pipeline_codegen_action_count(p[mode]);
+
+			rte_swx_pipeline_free(p[mode]);
+		}
+
+		if (!n_actions) {
+			TEST_ASSERT_NULL(getenv(RTE_SWX_PIPELINE_INCLUDE_PATH_ENV),
+				"No action of %s compiled with %s=%s",
+				pipeline_specs[i].spec,
+				RTE_SWX_PIPELINE_INCLUDE_PATH_ENV,
+				getenv(RTE_SWX_PIPELINE_INCLUDE_PATH_ENV));
+			printf("Generated code not available, set %s to the DPDK header directories\n",
+			       RTE_SWX_PIPELINE_INCLUDE_PATH_ENV);
+			return TEST_SKIPPED;
+		}
+
+		TEST_ASSERT_EQUAL(digest[0], digest[1],
+			"Interpreted and generated code output mismatch for %s",
+			pipeline_specs[i].spec);
+
+		printf("%-24s%16.2f%16.2f%10d\n", pipeline_specs[i].spec,
+		       (double)cycles[0] / N_PKTS,
+		       (double)cycles[1] / N_PKTS,
+		       n_actions);
+	}
+
+	printf("(CPU cycles per packet)\n");
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(swx_pipeline_perf_autotest, test_swx_pipeline_perf);
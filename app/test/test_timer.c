@@ -43,6 +43,8 @@
  *      all cores randomly reschedule them.
  *    - Again we check that the expected number of callbacks has occurred when
  *      we call timer-manage.
+ *    - The test runs on a timer data instance of each backend, skiplist and
+ *      wheel.
  *
  * #. Basic test.
  *
@@ -270,11 +272,19 @@ timer_stress2_cb(struct rte_timer *tim __rte_unused, void *arg __rte_unused)
 	cb_count++;
 }
 
+/* rte_timer_alt_manage() callback for second stress test */
+static void
+timer_stress2_manage_cb(struct rte_timer *tim)
+{
+	tim->f(tim, tim->arg);
+}
+
 #define NB_STRESS2_TIMERS 8192
 
 static int
-timer_stress2_main_loop(__rte_unused void *arg)
+timer_stress2_main_loop(void *arg)
 {
+	uint32_t timer_data_id = *(uint32_t *)arg;
 	static struct rte_timer *timers;
 	int i, ret;
 	uint64_t delay = rte_get_timer_hz() / 20;
@@ -307,8 +317,8 @@ timer_stress2_main_loop(__rte_unused void *arg)
 
 	/* have all cores schedule all timers on main lcore */
 	for (i = 0; i < NB_STRESS2_TIMERS; i++) {
-		ret = rte_timer_reset(&timers[i], delay, SINGLE, main_lcore,
-				timer_stress2_cb, NULL);
+		ret = rte_timer_alt_reset(timer_data_id, &timers[i], delay,
+				SINGLE, main_lcore, timer_stress2_cb, NULL);
 		/* there will be collisions when multiple cores simultaneously
 		 * configure the same timers */
 		if (ret != 0)
@@ -332,7 +342,8 @@ timer_stress2_main_loop(__rte_unused void *arg)
 		my_collisions = rte_atomic32_read(&collisions);
 		if (my_collisions != 0)
 			printf("- %d timer reset collisions (OK)\n", my_collisions);
-		rte_timer_manage();
+		rte_timer_alt_manage(timer_data_id, NULL, 0,
+				timer_stress2_manage_cb);
 		if (cb_count != NB_STRESS2_TIMERS) {
 			printf("Test Failed\n");
 			printf("- Stress test 2, part 1 failed\n");
@@ -355,16 +366,16 @@ timer_stress2_main_loop(__rte_unused void *arg)
 
 	/* now test again, just stop and restart timers at random after init*/
 	for (i = 0; i < NB_STRESS2_TIMERS; i++)
-		rte_timer_reset(&timers[i], delay, SINGLE, main_lcore,
-				timer_stress2_cb, NULL);
+		rte_timer_alt_reset(timer_data_id, &timers[i], delay, SINGLE,
+				main_lcore, timer_stress2_cb, NULL);
 
 	/* pick random timer to reset, stopping them first half the time */
 	for (i = 0; i < 100000; i++) {
 		int r = rand() % NB_STRESS2_TIMERS;
 		if (i % 2)
-			rte_timer_stop(&timers[r]);
-		rte_timer_reset(&timers[r], delay, SINGLE, main_lcore,
-				timer_stress2_cb, NULL);
+			rte_timer_alt_stop(timer_data_id, &timers[r]);
+		rte_timer_alt_reset(timer_data_id, &timers[r], delay, SINGLE,
+				main_lcore, timer_stress2_cb, NULL);
 	}
 
 	/* wait long enough for timers to expire */
@@ -374,7 +385,8 @@ timer_stress2_main_loop(__rte_unused void *arg)
 	if (lcore_id == main_lcore) {
 		main_wait_for_workers();
 
-		rte_timer_manage();
+		rte_timer_alt_manage(timer_data_id, NULL, 0,
+				timer_stress2_manage_cb);
 		if (cb_count != NB_STRESS2_TIMERS) {
 			printf("Test Failed\n");
 			printf("- Stress test 2, part 2 failed\n");
@@ -535,9 +547,12 @@ timer_sanity_check(void)
 static int
 test_timer(void)
 {
+	struct rte_timer_data_conf conf;
 	unsigned i;
 	uint64_t cur_time;
 	uint64_t hz;
+	uint32_t timer_data_id;
+	int ret;
 
 	if (rte_lcore_count() < 2) {
 		printf("Not enough cores for timer_autotest, expecting at least 2\n");
@@ -570,13 +585,28 @@ test_timer(void)
 	/* stop timer 0 used for stress test */
 	rte_timer_stop_sync(&mytiminfo[0].tim);
 
-	/* run a second, slightly different set of stress tests */
-	printf("\nStart timer stress tests 2\n");
-	test_failed = 0;
-	rte_eal_mp_remote_launch(timer_stress2_main_loop, NULL, CALL_MAIN);
-	rte_eal_mp_wait_lcore();
-	if (test_failed)
-		return TEST_FAILED;
+	/* run a second, slightly different set of stress tests, on each
+	 * timer backend
+	 */
+	memset(&conf, 0, sizeof(conf));
+	for (conf.backend = RTE_TIMER_BACKEND_SKIPLIST;
+	     conf.backend <= RTE_TIMER_BACKEND_WHEEL; conf.backend++) {
+		printf("\nStart timer stress tests 2 (%s)\n",
+		       conf.backend == RTE_TIMER_BACKEND_WHEEL ?
+		       "wheel" : "skiplist");
+		ret = rte_timer_data_alloc_conf(&timer_data_id, &conf);
+		if (ret < 0) {
+			printf("Cannot allocate timer data: %d\n", ret);
+			return TEST_FAILED;
+		}
+		test_failed = 0;
+		rte_eal_mp_remote_launch(timer_stress2_main_loop,
+					 &timer_data_id, CALL_MAIN);
+		rte_eal_mp_wait_lcore();
+		rte_timer_data_dealloc(timer_data_id);
+		if (test_failed)
+			return TEST_FAILED;
+	}
 
 	/* calculate the "end of test" time */
 	cur_time = rte_get_timer_cycles();
@@ -5,6 +5,7 @@
 #include "test.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <inttypes.h>
 #include <rte_cycles.h>
@@ -33,37 +34,79 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #define do_delay() rte_pause()
 #endif
 
+/* cycles per timer of each operation, with MAX_ITERATIONS timers */
+struct timer_perf_result {
+	uint64_t arm;
+	uint64_t rearm;
+	uint64_t stop;
+	uint64_t callback;
+};
+
+static void
+timer_manage_cb(struct rte_timer *t)
+{
+	t->f(t, t->arg);
+}
+
+static void
+print_time(const char *what, unsigned int iterations, uint64_t cycles)
+{
+	const uint64_t ticks_per_ms = rte_get_tsc_hz()/1000;
+	const uint64_t ticks_per_us = ticks_per_ms/1000;
+
+	printf("Time for %u %s: %"PRIu64" (%"PRIu64"ms), ", iterations, what,
+			cycles, (cycles+ticks_per_ms/2)/(ticks_per_ms));
+	printf("Time per timer: %"PRIu64" (%"PRIu64"us)\n",
+			cycles/iterations,
+			(cycles/iterations+ticks_per_us/2)/(ticks_per_us));
+}
+
 static int
-test_timer_perf(void)
+timer_perf_run(uint32_t timer_data_id, struct rte_timer *tms,
+	       struct timer_perf_result *res)
 {
 	unsigned iterations = 100;
 	unsigned i;
-	struct rte_timer *tms;
 	uint64_t start_tsc, end_tsc, delay_start;
 	unsigned lcore_id = rte_lcore_id();
 
-	tms = rte_malloc(NULL, sizeof(*tms) * MAX_ITERATIONS, 0);
-
 	for (i = 0; i < MAX_ITERATIONS; i++)
 		rte_timer_init(&tms[i]);
 
 	const uint64_t ticks = rte_get_timer_hz() * DELAY_SECONDS;
-	const uint64_t ticks_per_ms = rte_get_tsc_hz()/1000;
-	const uint64_t ticks_per_us = ticks_per_ms/1000;
 
 	while (iterations <= MAX_ITERATIONS) {
 
 		printf("Appending %u timers\n", iterations);
 		start_tsc = rte_rdtsc();
 		for (i = 0; i < iterations; i++)
-			rte_timer_reset(&tms[i], ticks, SINGLE, lcore_id,
-					timer_cb, NULL);
+			rte_timer_alt_reset(timer_data_id, &tms[i], ticks,
+					SINGLE, lcore_id, timer_cb, NULL);
+		end_tsc = rte_rdtsc();
+		print_time("timers", iterations, end_tsc - start_tsc);
+		res->arm = (end_tsc - start_tsc) / iterations;
+
+		printf("Re-arming %u pending timers\n", iterations);
+		start_tsc = rte_rdtsc();
+		for (i = 0; i < iterations; i++)
+			rte_timer_alt_reset(timer_data_id, &tms[i],
+					ticks - rte_rand() % (ticks / 2),
+					SINGLE, lcore_id, timer_cb, NULL);
 		end_tsc = rte_rdtsc();
-		printf("Time for %u timers: %"PRIu64" (%"PRIu64"ms), ", iterations,
-				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
-		printf("Time per timer: %"PRIu64" (%"PRIu64"us)\n",
-				(end_tsc-start_tsc)/iterations,
-				((end_tsc-start_tsc)/iterations+ticks_per_us/2)/(ticks_per_us));
+		print_time("timers", iterations, end_tsc - start_tsc);
+		res->rearm = (end_tsc - start_tsc) / iterations;
+
+		printf("Stopping %u pending timers\n", iterations);
+		start_tsc = rte_rdtsc();
+		for (i = 0; i < iterations; i++)
+			rte_timer_alt_stop(timer_data_id, &tms[i]);
+		end_tsc = rte_rdtsc();
+		print_time("timers", iterations, end_tsc - start_tsc);
+		res->stop = (end_tsc - start_tsc) / iterations;
+
+		for (i = 0; i < iterations; i++)
+			rte_timer_alt_reset(timer_data_id, &tms[i], ticks,
+					SINGLE, lcore_id, timer_cb, NULL);
 		outstanding_count = iterations;
 		delay_start = rte_get_timer_cycles();
 		while (rte_get_timer_cycles() < delay_start + ticks)
@@ -71,32 +114,28 @@ test_timer_perf(void)
 
 		start_tsc = rte_rdtsc();
 		while (outstanding_count)
-			rte_timer_manage();
+			rte_timer_alt_manage(timer_data_id, NULL, 0,
+					timer_manage_cb);
 		end_tsc = rte_rdtsc();
-		printf("Time for %u callbacks: %"PRIu64" (%"PRIu64"ms), ", iterations,
-				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
-		printf("Time per callback: %"PRIu64" (%"PRIu64"us)\n",
-				(end_tsc-start_tsc)/iterations,
-				((end_tsc-start_tsc)/iterations+ticks_per_us/2)/(ticks_per_us));
+		print_time("callbacks", iterations, end_tsc - start_tsc);
+		res->callback = (end_tsc - start_tsc) / iterations;
 
 		printf("Resetting %u timers\n", iterations);
 		start_tsc = rte_rdtsc();
 		for (i = 0; i < iterations; i++)
-			rte_timer_reset(&tms[i], rte_rand() % ticks, SINGLE, lcore_id,
+			rte_timer_alt_reset(timer_data_id, &tms[i],
+					rte_rand() % ticks, SINGLE, lcore_id,
 					timer_cb, NULL);
 		end_tsc = rte_rdtsc();
-		printf("Time for %u timers: %"PRIu64" (%"PRIu64"ms), ", iterations,
-				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
-		printf("Time per timer: %"PRIu64" (%"PRIu64"us)\n",
-				(end_tsc-start_tsc)/iterations,
-				((end_tsc-start_tsc)/iterations+ticks_per_us/2)/(ticks_per_us));
+		print_time("timers", iterations, end_tsc - start_tsc);
 		outstanding_count = iterations;
 
+		/* leave time for the wheel tick of the last timers to end */
 		delay_start = rte_get_timer_cycles();
-		while (rte_get_timer_cycles() < delay_start + ticks)
+		while (rte_get_timer_cycles() < delay_start + ticks + ticks / 100)
 			do_delay();
 
-		rte_timer_manage();
+		rte_timer_alt_manage(timer_data_id, NULL, 0, timer_manage_cb);
 		if (outstanding_count != 0) {
 			printf("Error: outstanding callback count = %d\n", outstanding_count);
 			return -1;
@@ -111,24 +150,74 @@ test_timer_perf(void)
 	/* measure time to poll an empty timer list */
 	start_tsc = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		rte_timer_manage();
+		rte_timer_alt_manage(timer_data_id, NULL, 0, timer_manage_cb);
 	end_tsc = rte_rdtsc();
 	printf("\nTime per rte_timer_manage with zero timers: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
 	/* measure time to poll a timer list with timers, but without
 	 * calling any callbacks */
-	rte_timer_reset(&tms[0], ticks * 100, SINGLE, lcore_id,
-			timer_cb, NULL);
+	rte_timer_alt_reset(timer_data_id, &tms[0], ticks * 100, SINGLE,
+			lcore_id, timer_cb, NULL);
 	start_tsc = rte_rdtsc();
 	for (i = 0; i < iterations; i++)
-		rte_timer_manage();
+		rte_timer_alt_manage(timer_data_id, NULL, 0, timer_manage_cb);
 	end_tsc = rte_rdtsc();
 	printf("Time per rte_timer_manage with zero callbacks: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
+	rte_timer_alt_stop(timer_data_id, &tms[0]);
 
-	rte_free(tms);
 	return 0;
 }
 
+static int
+test_timer_perf(void)
+{
+	static const char * const names[] = {
+		[RTE_TIMER_BACKEND_SKIPLIST] = "skiplist",
+		[RTE_TIMER_BACKEND_WHEEL] = "wheel",
+	};
+	struct timer_perf_result res[RTE_DIM(names)];
+	struct rte_timer_data_conf conf;
+	struct rte_timer *tms;
+	uint32_t timer_data_id;
+	unsigned int b;
+	int ret = 0;
+
+	tms = rte_malloc(NULL, sizeof(*tms) * MAX_ITERATIONS, 0);
+	if (tms == NULL) {
+		printf("Cannot allocate %u timers\n", MAX_ITERATIONS);
+		return -1;
+	}
+
+	memset(&conf, 0, sizeof(conf));
+	for (b = 0; b < RTE_DIM(names); b++) {
+		printf("\n=== %s backend ===\n\n", names[b]);
+		conf.backend = b;
+		ret = rte_timer_data_alloc_conf(&timer_data_id, &conf);
+		if (ret < 0) {
+			printf("Cannot allocate timer data: %d\n", ret);
+			break;
+		}
+		ret = timer_perf_run(timer_data_id, tms, &res[b]);
+		rte_timer_data_dealloc(timer_data_id);
+		if (ret < 0)
+			break;
+	}
+
+	if (ret == 0) {
+		printf("\nCycles per timer with %u timers:\n", MAX_ITERATIONS);
+		printf("%-10s %10s %10s %10s %10s\n", "backend", "arm",
+				"re-arm", "stop", "callback");
+		for (b = 0; b < RTE_DIM(names); b++)
+			printf("%-10s %10"PRIu64" %10"PRIu64" %10"PRIu64
+					" %10"PRIu64"\n", names[b], res[b].arm,
+					res[b].rearm, res[b].stop,
+					res[b].callback);
+	}
+
+	rte_free(tms);
+	return ret;
+}
+
 REGISTER_TEST_COMMAND(timer_perf_autotest, test_timer_perf);
@@ -3,10 +3,12 @@
  */
 
 #include <stdbool.h>
+#include <stdlib.h>
 
 #include <rte_cycles.h>
 #include <eventdev_pmd.h>
 #include <eventdev_pmd_vdev.h>
+#include <rte_kvargs.h>
 #include <rte_random.h>
 #include <rte_ring_elem.h>
 
@@ -14,6 +16,8 @@
 
 #define EVENTDEV_NAME_DSW_PMD event_dsw
 
+#define DSW_WORK_STEALING_ARG "work_stealing"
+
 static int
 dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	       const struct rte_event_port_conf *conf)
@@ -31,7 +35,8 @@ dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		.dsw = dsw,
 		.dequeue_depth = conf->dequeue_depth,
 		.enqueue_depth = conf->enqueue_depth,
-		.new_event_threshold = conf->new_event_threshold
+		.new_event_threshold = conf->new_event_threshold,
+		.steal_request = DSW_NO_STEAL_REQUEST
 	};
 
 	snprintf(ring_name, sizeof(ring_name), "dsw%d_p%u", dev->data->dev_id,
@@ -67,6 +72,9 @@ dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	port->migration_interval =
 		(DSW_MIGRATION_INTERVAL * rte_get_timer_hz()) / US_PER_S;
 
+	port->steal_interval =
+		(DSW_STEAL_INTERVAL * rte_get_timer_hz()) / US_PER_S;
+
 	dev->data->ports[port_id] = port;
 
 	return 0;
@@ -389,15 +397,68 @@ static struct rte_eventdev_ops dsw_evdev_ops = {
 	.xstats_get_by_name = dsw_xstats_get_by_name
 };
 
+static int
+set_work_stealing(const char *key __rte_unused, const char *value,
+		  void *opaque)
+{
+	bool *work_stealing = opaque;
+	int enable = atoi(value);
+
+	if (enable < 0 || enable > 1)
+		return -1;
+
+	*work_stealing = enable;
+
+	return 0;
+}
+
+static int
+dsw_parse_args(const char *name, const char *params, bool *work_stealing)
+{
+	static const char *const args[] = {
+		DSW_WORK_STEALING_ARG,
+		NULL
+	};
+	struct rte_kvargs *kvlist;
+	int ret;
+
+	if (params == NULL || params[0] == '\0')
+		return 0;
+
+	kvlist = rte_kvargs_parse(params, args);
+	if (kvlist == NULL) {
+		RTE_LOG(ERR, EVENTDEV, "[%s] Invalid parameters for device "
+			"%s\n", DSW_PMD_NAME, name);
+		return -EINVAL;
+	}
+
+	ret = rte_kvargs_process(kvlist, DSW_WORK_STEALING_ARG,
+				 set_work_stealing, work_stealing);
+	if (ret != 0)
+		RTE_LOG(ERR, EVENTDEV, "[%s] Invalid %s parameter for device "
+			"%s\n", DSW_PMD_NAME, DSW_WORK_STEALING_ARG, name);
+
+	rte_kvargs_free(kvlist);
+
+	return ret != 0 ? -EINVAL : 0;
+}
+
 static int
 dsw_probe(struct rte_vdev_device *vdev)
 {
 	const char *name;
 	struct rte_eventdev *dev;
 	struct dsw_evdev *dsw;
+	bool work_stealing = false;
+	int ret;
 
 	name = rte_vdev_device_name(vdev);
 
+	ret = dsw_parse_args(name, rte_vdev_device_args(vdev),
+			     &work_stealing);
+	if (ret < 0)
+		return ret;
+
 	dev = rte_event_pmd_vdev_init(name, sizeof(struct dsw_evdev),
 				      rte_socket_id());
 	if (dev == NULL)
@@ -416,6 +477,7 @@ dsw_probe(struct rte_vdev_device *vdev)
 
 	dsw = dev->data->dev_private;
 	dsw->data = dev->data;
+	dsw->work_stealing = work_stealing;
 
 	return 0;
 }
@@ -438,3 +500,4 @@ static struct rte_vdev_driver evdev_dsw_pmd_drv = {
 };
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_DSW_PMD, evdev_dsw_pmd_drv);
+RTE_PMD_REGISTER_PARAM_STRING(event_dsw, DSW_WORK_STEALING_ARG "=<0|1>");
@@ -5,6 +5,8 @@
 #ifndef _DSW_EVDEV_H_
 #define _DSW_EVDEV_H_
 
+#include <stdbool.h>
+
 #include <rte_event_ring.h>
 #include <rte_eventdev.h>
 
@@ -95,6 +97,21 @@
 #define DSW_MAX_TARGET_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(95))
 #define DSW_REBALANCE_THRESHOLD (DSW_LOAD_FROM_PERCENT(3))
 
+/* With work stealing enabled, a port which load is below
+ * DSW_MAX_LOAD_FOR_STEALING asks the most loaded port it shares a
+ * queue with, if loaded above DSW_MIN_VICTIM_LOAD_FOR_STEALING, to
+ * migrate flows to it. The loaded port handles the request at its
+ * next background task, without waiting for its next migration
+ * interval, and moves as many flows as needed to even out the load
+ * between the two ports. Atomic flows go through the usual pause
+ * procedure, so atomicity is maintained. A port makes at most one
+ * steal request per DSW_STEAL_INTERVAL.
+ */
+#define DSW_MAX_LOAD_FOR_STEALING (DSW_LOAD_FROM_PERCENT(10))
+#define DSW_MIN_VICTIM_LOAD_FOR_STEALING (DSW_LOAD_FROM_PERCENT(50))
+#define DSW_STEAL_INTERVAL (DSW_MIGRATION_INTERVAL/4)
+#define DSW_NO_STEAL_REQUEST (-1)
+
 #define DSW_MAX_EVENTS_RECORDED (128)
 
 #define DSW_MAX_FLOWS_PER_MIGRATION (8)
@@ -181,6 +198,12 @@ struct dsw_port {
 
 	uint64_t immigrations;
 
+	/* For work stealing. */
+	uint64_t next_steal;
+	uint64_t steal_interval;
+	uint64_t steal_requests;
+	uint64_t stolen_flows;
+
 	uint16_t paused_flows_len;
 	struct dsw_queue_flow paused_flows[DSW_MAX_PAUSED_FLOWS];
 
@@ -222,6 +245,10 @@ struct dsw_port {
 	int16_t load __rte_cache_aligned;
 	/* Estimate of flows currently migrating to this port. */
 	int32_t immigration_load __rte_cache_aligned;
+	/* Id of a lightly loaded port asking for flows, or
+	 * DSW_NO_STEAL_REQUEST.
+	 */
+	int32_t steal_request;
 } __rte_cache_aligned;
 
 struct dsw_queue {
@@ -240,6 +267,7 @@ struct dsw_evdev {
 	struct dsw_queue queues[DSW_MAX_QUEUES];
 	uint8_t num_queues;
 	int32_t max_inflight;
+	bool work_stealing;
 
 	int32_t credits_on_loan __rte_cache_aligned;
 };
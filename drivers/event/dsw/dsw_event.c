@@ -437,11 +437,26 @@ dsw_is_serving_port(struct dsw_evdev *dsw, uint8_t port_id, uint8_t queue_id)
 	return false;
 }
 
+static bool
+dsw_ports_share_queue(struct dsw_evdev *dsw, uint8_t port_id_a,
+		      uint8_t port_id_b)
+{
+	uint8_t queue_id;
+
+	for (queue_id = 0; queue_id < dsw->num_queues; queue_id++)
+		if (dsw_is_serving_port(dsw, port_id_a, queue_id) &&
+		    dsw_is_serving_port(dsw, port_id_b, queue_id))
+			return true;
+
+	return false;
+}
+
 static bool
 dsw_select_emigration_target(struct dsw_evdev *dsw,
 			    struct dsw_queue_flow_burst *bursts,
 			    uint16_t num_bursts, uint8_t source_port_id,
 			    int16_t *port_loads, uint16_t num_ports,
+			    int16_t min_source_load, int32_t thief_port_id,
 			    uint8_t *target_port_ids,
 			    struct dsw_queue_flow *target_qfs,
 			    uint8_t *targets_len)
@@ -453,7 +468,7 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 	int16_t candidate_flow_load = -1;
 	uint16_t i;
 
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION)
+	if (source_port_load < min_source_load)
 		return false;
 
 	for (i = 0; i < num_bursts; i++) {
@@ -474,6 +489,13 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 			if (port_id == source_port_id)
 				continue;
 
+			/* A steal request restricts the candidate targets
+			 * to the requesting port.
+			 */
+			if (thief_port_id != DSW_NO_STEAL_REQUEST &&
+			    port_id != thief_port_id)
+				continue;
+
 			if (!dsw_is_serving_port(dsw, port_id, qf->queue_id))
 				continue;
 
@@ -517,7 +539,8 @@ static void
 dsw_select_emigration_targets(struct dsw_evdev *dsw,
 			      struct dsw_port *source_port,
 			      struct dsw_queue_flow_burst *bursts,
-			      uint16_t num_bursts, int16_t *port_loads)
+			      uint16_t num_bursts, int16_t *port_loads,
+			      int16_t min_source_load, int32_t thief_port_id)
 {
 	struct dsw_queue_flow *target_qfs = source_port->emigration_target_qfs;
 	uint8_t *target_port_ids = source_port->emigration_target_port_ids;
@@ -530,6 +553,8 @@ dsw_select_emigration_targets(struct dsw_evdev *dsw,
 		found = dsw_select_emigration_target(dsw, bursts, num_bursts,
 						     source_port->id,
 						     port_loads, dsw->num_ports,
+						     min_source_load,
+						     thief_port_id,
 						     target_port_ids,
 						     target_qfs,
 						     targets_len);
@@ -807,6 +832,20 @@ dsw_port_move_parallel_flows(struct dsw_evdev *dsw,
 	dsw_port_end_emigration(dsw, source_port, RTE_SCHED_TYPE_PARALLEL);
 }
 
+static int32_t
+dsw_port_take_steal_request(struct dsw_port *port)
+{
+	/* Avoid writing to the shared cache line in the common case
+	 * of no pending request.
+	 */
+	if (likely(__atomic_load_n(&port->steal_request, __ATOMIC_RELAXED) ==
+		   DSW_NO_STEAL_REQUEST))
+		return DSW_NO_STEAL_REQUEST;
+
+	return __atomic_exchange_n(&port->steal_request, DSW_NO_STEAL_REQUEST,
+				   __ATOMIC_RELAXED);
+}
+
 static void
 dsw_port_consider_emigration(struct dsw_evdev *dsw,
 			     struct dsw_port *source_port,
@@ -819,8 +858,20 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 	uint16_t num_bursts;
 	int16_t source_port_load;
 	int16_t port_loads[dsw->num_ports];
+	int16_t min_source_load = DSW_MIN_SOURCE_LOAD_FOR_MIGRATION;
+	int32_t thief_port_id;
+
+	/* A request from an idle port is served right away, and
+	 * migrates flows from less loaded ports than regular
+	 * emigration does.
+	 */
+	thief_port_id = dsw_port_take_steal_request(source_port);
 
-	if (now < source_port->next_emigration)
+	if (thief_port_id != DSW_NO_STEAL_REQUEST) {
+		DSW_LOG_DP_PORT(DEBUG, source_port->id, "Port %d requested "
+				"flows.\n", thief_port_id);
+		min_source_load = DSW_MIN_VICTIM_LOAD_FOR_STEALING;
+	} else if (now < source_port->next_emigration)
 		return;
 
 	if (dsw->num_ports == 1)
@@ -835,9 +886,10 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 	 * emigration at the same in point in time, which might lead
 	 * to all choosing the same target port.
 	 */
-	source_port->next_emigration = now +
-		source_port->migration_interval / 2 +
-		rte_rand() % source_port->migration_interval;
+	if (thief_port_id == DSW_NO_STEAL_REQUEST)
+		source_port->next_emigration = now +
+			source_port->migration_interval / 2 +
+			rte_rand() % source_port->migration_interval;
 
 	if (source_port->migration_state != DSW_MIGRATION_STATE_IDLE) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
@@ -857,11 +909,11 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 
 	source_port_load =
 		__atomic_load_n(&source_port->load, __ATOMIC_RELAXED);
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION) {
+	if (source_port_load < min_source_load) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 		      "Load %d is below threshold level %d.\n",
 		      DSW_LOAD_TO_PERCENT(source_port_load),
-		      DSW_LOAD_TO_PERCENT(DSW_MIN_SOURCE_LOAD_FOR_MIGRATION));
+		      DSW_LOAD_TO_PERCENT(min_source_load));
 		return;
 	}
 
@@ -893,11 +945,16 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 	}
 
 	dsw_select_emigration_targets(dsw, source_port, bursts, num_bursts,
-				      port_loads);
+				      port_loads, min_source_load,
+				      thief_port_id);
 
 	if (source_port->emigration_targets_len == 0)
 		return;
 
+	if (thief_port_id != DSW_NO_STEAL_REQUEST)
+		source_port->stolen_flows +=
+			source_port->emigration_targets_len;
+
 	source_port->migration_state = DSW_MIGRATION_STATE_PAUSING;
 	source_port->emigration_start = rte_get_timer_cycles();
 
@@ -1102,6 +1159,64 @@ dsw_port_note_op(struct dsw_port *port, uint16_t num_events)
 	port->ops_since_bg_task += (num_events+1);
 }
 
+static void
+dsw_port_consider_steal(struct dsw_evdev *dsw, struct dsw_port *port,
+			uint64_t now)
+{
+	int16_t port_loads[dsw->num_ports];
+	int32_t victim_port_id = DSW_NO_STEAL_REQUEST;
+	int32_t no_request = DSW_NO_STEAL_REQUEST;
+	struct dsw_port *victim_port;
+	uint16_t i;
+
+	if (!dsw->work_stealing || now < port->next_steal)
+		return;
+
+	port->next_steal = now + port->steal_interval;
+
+	dsw_retrieve_port_loads(dsw, port_loads, DSW_MAX_LOAD);
+
+	/* The immigration load of the port is included, so a port
+	 * with flows on their way does not ask for more.
+	 */
+	if (port_loads[port->id] > DSW_MAX_LOAD_FOR_STEALING)
+		return;
+
+	for (i = 0; i < dsw->num_ports; i++) {
+		if (i == port->id ||
+		    port_loads[i] < DSW_MIN_VICTIM_LOAD_FOR_STEALING)
+			continue;
+
+		if (victim_port_id != DSW_NO_STEAL_REQUEST &&
+		    port_loads[i] <= port_loads[victim_port_id])
+			continue;
+
+		/* Producer-only ports, and ports serving other queues,
+		 * have no flows to take from the victim.
+		 */
+		if (!dsw_ports_share_queue(dsw, port->id, i))
+			continue;
+
+		victim_port_id = i;
+	}
+
+	if (victim_port_id == DSW_NO_STEAL_REQUEST)
+		return;
+
+	/* Only one request at a time per victim, other thieves will
+	 * try again later on.
+	 */
+	victim_port = &dsw->ports[victim_port_id];
+	if (__atomic_compare_exchange_n(&victim_port->steal_request,
+					&no_request, port->id, false,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		DSW_LOG_DP_PORT(DEBUG, port->id, "Requested flows from port "
+				"%d with load %d.\n", victim_port_id,
+				DSW_LOAD_TO_PERCENT(port_loads[victim_port_id]));
+		port->steal_requests++;
+	}
+}
+
 static void
 dsw_port_bg_process(struct dsw_evdev *dsw, struct dsw_port *port)
 {
@@ -1136,6 +1251,8 @@ dsw_port_bg_process(struct dsw_evdev *dsw, struct dsw_port *port)
 
 		dsw_port_consider_emigration(dsw, port, now);
 
+		dsw_port_consider_steal(dsw, port, now);
+
 		port->ops_since_bg_task = 0;
 	}
 }
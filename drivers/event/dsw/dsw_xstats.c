@@ -86,6 +86,8 @@ dsw_xstats_port_get_queue_dequeued(struct dsw_evdev *dsw, uint8_t port_id,
 
 DSW_GEN_PORT_ACCESS_FN(emigrations)
 DSW_GEN_PORT_ACCESS_FN(immigrations)
+DSW_GEN_PORT_ACCESS_FN(steal_requests)
+DSW_GEN_PORT_ACCESS_FN(stolen_flows)
 
 static uint64_t
 dsw_xstats_port_get_migration_latency(struct dsw_evdev *dsw, uint8_t port_id,
@@ -152,6 +154,10 @@ static struct dsw_xstats_port dsw_port_xstats[] = {
 	  false },
 	{ "port_%u_immigrations", dsw_xstats_port_get_immigrations,
 	  false },
+	{ "port_%u_steal_requests", dsw_xstats_port_get_steal_requests,
+	  false },
+	{ "port_%u_stolen_flows", dsw_xstats_port_get_stolen_flows,
+	  false },
 	{ "port_%u_event_proc_latency", dsw_xstats_port_get_event_proc_latency,
 	  false },
 	{ "port_%u_busy_cycles", dsw_xstats_port_get_busy_cycles,
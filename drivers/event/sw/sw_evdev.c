@@ -23,10 +23,21 @@
 #define MIN_BURST_SIZE_ARG "min_burst"
 #define DEQ_BURST_SIZE_ARG "deq_burst"
 #define REFIL_ONCE_ARG "refill_once"
+#define SCHED_PARTITIONS_ARG "sched_partitions"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
 
+/* IQ chunks of a QID, owned by its partition if the scheduler has several */
+static struct sw_queue_chunk **
+sw_qid_chunk_list(struct sw_evdev *sw, unsigned int qid_id)
+{
+	if (sw->partitions == NULL)
+		return &sw->chunk_list_head;
+
+	return &sw->partitions[sw->qid_partition[qid_id]].chunk_list_head;
+}
+
 static int
 sw_port_link(struct rte_eventdev *dev, void *port, const uint8_t queues[],
 		const uint8_t priorities[], uint16_t num)
@@ -363,7 +374,7 @@ sw_init_qid_iqs(struct sw_evdev *sw)
 			continue;
 
 		for (j = 0; j < SW_IQS_MAX; j++)
-			iq_init(sw, &qid->iq[j]);
+			iq_init(sw_qid_chunk_list(sw, i), &qid->iq[j]);
 	}
 }
 
@@ -396,6 +407,46 @@ sw_ports_empty(struct sw_evdev *sw)
 	return 1;
 }
 
+static int
+sw_partitions_empty(struct sw_evdev *sw)
+{
+	unsigned int i, j;
+
+	if (sw->partitions == NULL)
+		return 1;
+
+	/* events left in a port by its partition, or passed between them */
+	for (i = 0; i < sw->port_count; i++)
+		if (sw->ports[i].pp_buf_count)
+			return 0;
+
+	for (i = 0; i < sw->sched_partitions; i++) {
+		struct sw_partition *part = &sw->partitions[i];
+
+		if (rte_event_ring_count(part->rx_ring))
+			return 0;
+
+		for (j = 0; j < sw->sched_partitions; j++)
+			if (part->fwd_count[j])
+				return 0;
+
+		for (j = 0; j < sw->port_count; j++)
+			if (part->cqs[j].count)
+				return 0;
+	}
+
+	/* reorder buffer entries completed by a partition, not another one */
+	for (i = 0; i < sw->qid_count; i++) {
+		struct sw_qid *qid = &sw->qids[i];
+
+		if (qid->type == RTE_SCHED_TYPE_ORDERED &&
+		    qid->reorder_buffer[qid->reorder_buffer_index].ready)
+			return 0;
+	}
+
+	return 1;
+}
+
 static void
 sw_drain_ports(struct rte_eventdev *dev)
 {
@@ -423,9 +474,9 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_queue_chunk **chunk_list,
+		struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -437,7 +488,7 @@ sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
 	while (iq_count(iq) > 0) {
 		struct rte_event ev;
 
-		iq_dequeue_burst(sw, iq, &ev, 1);
+		iq_dequeue_burst(chunk_list, iq, &ev, 1);
 
 		if (flush)
 			flush(dev_id, ev, arg);
@@ -452,7 +503,8 @@ sw_drain_queues(struct rte_eventdev *dev)
 
 	for (i = 0; i < sw->qid_count; i++) {
 		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+			sw_drain_queue(dev, sw_qid_chunk_list(sw, i),
+					&sw->qids[i].iq[j]);
 	}
 }
 
@@ -469,7 +521,8 @@ sw_clean_qid_iqs(struct rte_eventdev *dev)
 		for (j = 0; j < SW_IQS_MAX; j++) {
 			if (!qid->iq[j].head)
 				continue;
-			iq_free_chunk_list(sw, qid->iq[j].head);
+			iq_free_chunk_list(sw_qid_chunk_list(sw, i),
+					qid->iq[j].head);
 			qid->iq[j].head = NULL;
 		}
 	}
@@ -505,6 +558,120 @@ sw_port_def_conf(struct rte_eventdev *dev, uint8_t port_id,
 	port_conf->event_port_cfg = 0;
 }
 
+static void
+sw_partitions_free(struct sw_evdev *sw)
+{
+	unsigned int i;
+
+	if (sw->partitions == NULL)
+		return;
+
+	for (i = 0; i < sw->sched_partitions; i++) {
+		rte_free(sw->partitions[i].chunks);
+		rte_event_ring_free(sw->partitions[i].rx_ring);
+	}
+	rte_free(sw->partitions);
+	sw->partitions = NULL;
+}
+
+static int
+sw_partitions_configure(struct sw_evdev *sw)
+{
+	const int dev_id = sw->data->dev_id;
+	const int socket_id = sw->data->socket_id;
+	unsigned int i;
+	int j;
+
+	if (sw->partitions == NULL) {
+		sw->partitions = rte_zmalloc_socket(NULL,
+				sw->sched_partitions * sizeof(*sw->partitions),
+				RTE_CACHE_LINE_SIZE, socket_id);
+		if (sw->partitions == NULL)
+			return -ENOMEM;
+	}
+
+	/* QIDs are spread over the partitions round robin */
+	for (i = 0; i < RTE_DIM(sw->qid_partition); i++)
+		sw->qid_partition[i] = i % sw->sched_partitions;
+
+	for (i = 0; i < sw->sched_partitions; i++) {
+		struct sw_partition *part = &sw->partitions[i];
+		char buf[RTE_RING_NAMESIZE];
+		int nb_qids, num_chunks;
+
+		part->id = i;
+		rte_spinlock_init(&part->lock);
+
+		/* Sized for all the events in the IQs of this partition */
+		nb_qids = (sw->qid_count + sw->sched_partitions - 1 - i) /
+				sw->sched_partitions;
+		num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
+				nb_qids*SW_IQS_MAX*2;
+
+		rte_free(part->chunks);
+		part->chunks = rte_malloc_socket(NULL,
+				sizeof(struct sw_queue_chunk) * num_chunks,
+				0, socket_id);
+		if (!part->chunks)
+			goto error;
+
+		part->chunk_list_head = NULL;
+		for (j = 0; j < num_chunks; j++)
+			iq_free_chunk(&part->chunk_list_head, &part->chunks[j]);
+
+		if (part->rx_ring != NULL)
+			continue;
+
+		/* Large enough for all the events of the device */
+		snprintf(buf, sizeof(buf), "sw%d_part%u_rx_ring", dev_id, i);
+		part->rx_ring = rte_event_ring_create(buf,
+				SW_INFLIGHT_EVENTS_TOTAL, socket_id,
+				RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (part->rx_ring == NULL) {
+			SW_LOG_ERR("Error creating ring for partition %u\n",
+					i);
+			goto error;
+		}
+	}
+
+	return 0;
+
+error:
+	sw_partitions_free(sw);
+	return -ENOMEM;
+}
+
+static void
+sw_partitions_start(struct sw_evdev *sw)
+{
+	unsigned int i, j;
+
+	for (i = 0; i < sw->sched_partitions; i++) {
+		struct sw_partition *part = &sw->partitions[i];
+
+		part->port_count = 0;
+		for (j = i; j < sw->port_count; j += sw->sched_partitions)
+			part->ports[part->port_count++] = j;
+
+		/* keep the priority order of the device */
+		part->qid_count = 0;
+		for (j = 0; j < sw->qid_count; j++) {
+			struct sw_qid *qid = sw->qids_prioritized[j];
+
+			if (sw->qid_partition[qid->id] == i)
+				part->qids_prioritized[part->qid_count++] =
+						qid;
+		}
+
+		memset(part->fwd_count, 0, sizeof(part->fwd_count));
+		for (j = 0; j < sw->port_count; j++) {
+			part->cqs[j].count = 0;
+			part->cqs[j].space = rte_event_ring_free_count(
+					sw->ports[j].cq_worker_ring);
+		}
+	}
+}
+
 static int
 sw_dev_configure(const struct rte_eventdev *dev)
 {
@@ -539,11 +706,14 @@ sw_dev_configure(const struct rte_eventdev *dev)
 
 	sw->chunk_list_head = NULL;
 	for (i = 0; i < num_chunks; i++)
-		iq_free_chunk(sw, &sw->chunks[i]);
+		iq_free_chunk(&sw->chunk_list_head, &sw->chunks[i]);
 
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
 
+	if (sw->sched_partitions > 1)
+		return sw_partitions_configure(sw);
+
 	return 0;
 }
 
@@ -634,6 +804,20 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sw->sched_cq_qid_called);
 	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sw->sched_no_iq_enqueues);
 	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sw->sched_no_cq_enqueues);
+	for (i = 0; sw->partitions != NULL && i < sw->sched_partitions; i++) {
+		const struct sw_partition *part = &sw->partitions[i];
+
+		fprintf(f, "  Partition %u: qids %u, ports %u\n", i,
+			part->qid_count, part->port_count);
+		fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64
+			"\n\ttx   %"PRIu64"\n", part->stats.rx_pkts,
+			part->stats.rx_dropped, part->stats.tx_pkts);
+		fprintf(f, "\tsched calls: %"PRIu64"\n", part->sched_called);
+		fprintf(f, "\tsched no IQ enq: %"PRIu64"\n",
+			part->sched_no_iq_enqueues);
+		fprintf(f, "\tsched no CQ enq: %"PRIu64"\n",
+			part->sched_no_cq_enqueues);
+	}
 	uint32_t inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
@@ -811,6 +995,9 @@ sw_start(struct rte_eventdev *dev)
 		}
 	}
 
+	if (sw->partitions != NULL)
+		sw_partitions_start(sw);
+
 	sw_init_qid_iqs(sw);
 
 	if (sw_xstats_init(sw) < 0)
@@ -837,7 +1024,8 @@ sw_stop(struct rte_eventdev *dev)
 		rte_pause();
 
 	/* Flush all events out of the device */
-	while (!(sw_qids_empty(sw) && sw_ports_empty(sw))) {
+	while (!(sw_qids_empty(sw) && sw_ports_empty(sw) &&
+			sw_partitions_empty(sw))) {
 		sw_event_schedule(dev);
 		sw_drain_ports(dev);
 		sw_drain_queues(dev);
@@ -871,6 +1059,7 @@ sw_close(struct rte_eventdev *dev)
 	sw->sched_no_iq_enqueues = 0;
 	sw->sched_no_cq_enqueues = 0;
 	sw->sched_cq_qid_called = 0;
+	sw_partitions_free(sw);
 
 	return 0;
 }
@@ -935,6 +1124,18 @@ set_refill_once(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_sched_partitions(const char *key __rte_unused, const char *value,
+		void *opaque)
+{
+	int *sched_partitions = opaque;
+	*sched_partitions = atoi(value);
+	if (*sched_partitions < 1 ||
+			*sched_partitions > SW_SCHED_PARTITIONS_MAX)
+		return -1;
+	return 0;
+}
+
 static int32_t sw_sched_service_func(void *args)
 {
 	struct rte_eventdev *dev = args;
@@ -984,6 +1185,7 @@ sw_probe(struct rte_vdev_device *vdev)
 		MIN_BURST_SIZE_ARG,
 		DEQ_BURST_SIZE_ARG,
 		REFIL_ONCE_ARG,
+		SCHED_PARTITIONS_ARG,
 		NULL
 	};
 	const char *name;
@@ -996,6 +1198,7 @@ sw_probe(struct rte_vdev_device *vdev)
 	int min_burst_size = 1;
 	int deq_burst_size = SCHED_DEQUEUE_DEFAULT_BURST_SIZE;
 	int refill_once = 0;
+	int sched_partitions = 1;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1067,6 +1270,17 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SCHED_PARTITIONS_ARG,
+					set_sched_partitions,
+					&sched_partitions);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing sched partitions parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
@@ -1074,9 +1288,11 @@ sw_probe(struct rte_vdev_device *vdev)
 	SW_LOG_INFO(
 			"Creating eventdev sw device %s, numa_node=%d, "
 			"sched_quanta=%d, credit_quanta=%d "
-			"min_burst=%d, deq_burst=%d, refill_once=%d\n",
+			"min_burst=%d, deq_burst=%d, refill_once=%d, "
+			"sched_partitions=%d\n",
 			name, socket_id, sched_quanta, credit_quanta,
-			min_burst_size, deq_burst_size, refill_once);
+			min_burst_size, deq_burst_size, refill_once,
+			sched_partitions);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id);
@@ -1104,6 +1320,7 @@ sw_probe(struct rte_vdev_device *vdev)
 	sw->sched_min_burst_size = min_burst_size;
 	sw->sched_deq_burst_size = deq_burst_size;
 	sw->refill_once_per_iter = refill_once;
+	sw->sched_partitions = sched_partitions;
 
 	/* register service with EAL */
 	struct rte_service_spec service;
@@ -1114,6 +1331,9 @@ sw_probe(struct rte_vdev_device *vdev)
 	service.socket_id = socket_id;
 	service.callback = sw_sched_service_func;
 	service.callback_userdata = (void *)dev;
+	/* partitions can be scheduled by several service cores at once */
+	if (sched_partitions > 1)
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
 
 	int32_t ret = rte_service_component_register(&service, &sw->service_id);
 	if (ret) {
@@ -1150,5 +1370,5 @@ RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
 		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
 		MIN_BURST_SIZE_ARG "=<int>" DEQ_BURST_SIZE_ARG "=<int>"
-		REFIL_ONCE_ARG "=<int>");
+		REFIL_ONCE_ARG "=<int>" SCHED_PARTITIONS_ARG "=<int>");
 RTE_LOG_REGISTER_DEFAULT(eventdev_sw_log_level, NOTICE);
@@ -9,6 +9,7 @@
 #include <rte_eventdev.h>
 #include <eventdev_pmd_vdev.h>
 #include <rte_atomic.h>
+#include <rte_spinlock.h>
 
 #define SW_DEFAULT_CREDIT_QUANTA 32
 #define SW_DEFAULT_SCHED_QUANTA 128
@@ -21,6 +22,7 @@
 /* allow for lots of over-provisioning */
 #define MAX_SW_PROD_Q_DEPTH 4096
 #define SW_FRAGMENTS_MAX 16
+#define SW_SCHED_PARTITIONS_MAX 8
 
 /* Should be power-of-two minus one, to leave room for the next pointer */
 #define SW_EVS_PER_Q_CHUNK 255
@@ -80,10 +82,18 @@ struct sw_point_stats {
 
 /* structure used to track what port a flow (FID) is pinned to */
 struct sw_fid_t {
-	/* which CQ this FID is currently pinned to */
-	int32_t cq;
-	/* number of packets gone to the CQ with this FID */
-	uint32_t pcount;
+	RTE_STD_C11
+	union {
+		RTE_STD_C11
+		struct {
+			/* which CQ this FID is currently pinned to */
+			int32_t cq;
+			/* number of packets gone to the CQ with this FID */
+			uint32_t pcount;
+		};
+		/* both fields, updated at once by scheduler partitions */
+		uint64_t val;
+	};
 };
 
 struct reorder_buffer_entry {
@@ -192,6 +202,8 @@ struct sw_port {
 
 	/* History list structs, containing info on pkts egressed to worker */
 	uint16_t hist_head __rte_cache_aligned;
+	/* taken by scheduler partitions to push to the cq_worker_ring */
+	rte_spinlock_t cq_lock;
 	uint16_t hist_tail;
 	uint16_t inflights;
 	struct sw_hist_list_entry hist_list[SW_PORT_HIST_LIST];
@@ -209,6 +221,58 @@ struct sw_port {
 	uint8_t num_qids_mapped;
 };
 
+/* Events scheduled by a partition to a port, not pushed to its CQ yet */
+struct sw_partition_cq {
+	uint16_t count;
+	uint16_t space; /* cached free space of the cq_worker_ring */
+	struct sw_hist_list_entry hist[MAX_SW_CONS_Q_DEPTH];
+	struct rte_event events[MAX_SW_CONS_Q_DEPTH];
+};
+
+/* A scheduler partition owns a subset of the QIDs, and pulls the events
+ * of a subset of the ports. Partitions are run concurrently by the service
+ * cores mapped to the device service, one lcore at a time each.
+ */
+struct sw_partition {
+	rte_spinlock_t lock; /* held by the lcore running the partition */
+	uint8_t id;
+
+	/* Ports pulled by this partition */
+	uint32_t port_count;
+	uint8_t ports[SW_PORTS_MAX];
+
+	/* Owned QIDs sorted by priority level */
+	uint32_t qid_count;
+	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+
+	/* IQ chunks of the owned QIDs */
+	struct sw_queue_chunk *chunk_list_head;
+	struct sw_queue_chunk *chunks;
+
+	/* Events for the owned QIDs, pulled by other partitions */
+	struct rte_event_ring *rx_ring;
+
+	/* Events pulled for the QIDs of other partitions */
+	uint16_t fwd_count[SW_SCHED_PARTITIONS_MAX];
+	struct rte_event fwd_buf[SW_SCHED_PARTITIONS_MAX]
+			[SCHED_DEQUEUE_MAX_BURST_SIZE];
+
+	struct sw_partition_cq cqs[SW_PORTS_MAX];
+
+	/* Current values */
+	uint32_t sched_flush_count;
+	uint32_t sched_min_burst;
+
+	/* Stats, summed up in the device stats */
+	struct sw_point_stats stats __rte_cache_aligned;
+	uint64_t sched_called;
+	uint64_t sched_no_iq_enqueues;
+	uint64_t sched_no_cq_enqueues;
+	uint64_t sched_cq_qid_called;
+	uint64_t sched_last_iter_bitmask;
+	uint8_t sched_progress_last_iter;
+} __rte_cache_aligned;
+
 struct sw_evdev {
 	struct rte_eventdev_data *data;
 
@@ -274,6 +338,12 @@ struct sw_evdev {
 
 	uint32_t service_id;
 	char service_name[SW_PMD_NAME_MAX];
+
+	/* Scheduler partitions, NULL when a single one schedules all QIDs */
+	uint32_t sched_partitions;
+	struct sw_partition *partitions;
+	/* Partition owning each QID */
+	uint8_t qid_partition[RTE_EVENT_MAX_QUEUES_PER_DEV];
 };
 
 static inline struct sw_evdev *
@@ -5,6 +5,7 @@
 #include <rte_ring.h>
 #include <rte_hash_crc.h>
 #include <rte_event_ring.h>
+#include <rte_lcore.h>
 #include "sw_evdev.h"
 #include "iq_chunk.h"
 #include "event_ring.h"
@@ -28,10 +29,355 @@
 #define SW_HASH_FLOWID(f) (((f) ^ (f >> 10)) & FLOWID_MASK)
 
 
-static inline uint32_t
-sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
-		uint32_t iq_num, unsigned int count)
+/*
+ * Partitioned scheduling. Each partition owns the QIDs mapped to it in
+ * sw->qid_partition, with their IQs, flow pinning and reorder buffers, and
+ * pulls the events of the ports mapped to it. Events pulled for a QID of
+ * another partition are passed to its rx_ring. The flow pinning of atomic
+ * QIDs is updated by both the owner and the pulling partition, and is
+ * kept in a single word updated with compare-and-swap.
+ *
+ * The scheduling functions below take the partition being run, or NULL
+ * when a single scheduler owns all the QIDs and ports. They are inlined in
+ * both schedulers, so the single one does not pay for the partitions.
+ */
+
+/* Scheduler state of the partition, or of the device if there is none */
+#define SW_SCHED(sw, part, field) \
+	(*((part) == NULL ? &(sw)->field : &(part)->field))
+
+/* Port id of the i-th port pulled by the scheduler */
+static __rte_always_inline uint32_t
+sw_sched_port_id(struct sw_partition *part, uint32_t i)
+{
+	return part == NULL ? i : part->ports[i];
+}
+
+static __rte_always_inline void
+sw_enqueue_iq(struct sw_queue_chunk **chunk_list, struct sw_qid *qid,
+		const struct rte_event *qe)
+{
+	uint32_t iq_num = PRIO_TO_IQ(qe->priority);
+
+	qid->iq_pkt_mask |= (1 << (iq_num));
+	iq_enqueue(chunk_list, &qid->iq[iq_num], qe);
+	qid->iq_pkt_count[iq_num]++;
+	qid->stats.rx_pkts++;
+}
+
+static __rte_always_inline void
+sw_part_fwd_flush(struct sw_evdev *sw, struct sw_partition *part,
+		uint8_t dest)
+{
+	uint16_t count = part->fwd_count[dest];
+	uint16_t enq;
+
+	enq = rte_event_ring_enqueue_burst(sw->partitions[dest].rx_ring,
+			part->fwd_buf[dest], count, NULL);
+	if (unlikely(enq < count))
+		memmove(part->fwd_buf[dest], &part->fwd_buf[dest][enq],
+				(count - enq) * sizeof(part->fwd_buf[dest][0]));
+	part->fwd_count[dest] = count - enq;
+}
+
+/* Check that an event for the QID can be accepted by the scheduler */
+static __rte_always_inline int
+sw_fwd_room(struct sw_evdev *sw, struct sw_partition *part, uint8_t qid_id)
+{
+	uint8_t dest;
+
+	if (part == NULL)
+		return 1;
+
+	dest = sw->qid_partition[qid_id];
+	if (dest == part->id ||
+			part->fwd_count[dest] < SCHED_DEQUEUE_MAX_BURST_SIZE)
+		return 1;
+
+	sw_part_fwd_flush(sw, part, dest);
+	return part->fwd_count[dest] < SCHED_DEQUEUE_MAX_BURST_SIZE;
+}
+
+/* Enqueue an event to its QID, or buffer it for the owning partition.
+ * Returns 1 if the event was enqueued to an IQ, to count it once.
+ */
+static __rte_always_inline uint32_t
+sw_qid_enqueue(struct sw_evdev *sw, struct sw_partition *part,
+		const struct rte_event *qe)
+{
+	if (part != NULL) {
+		uint8_t dest = sw->qid_partition[qe->queue_id];
+
+		if (dest != part->id) {
+			part->fwd_buf[dest][part->fwd_count[dest]++] = *qe;
+			return 0;
+		}
+	}
+
+	sw_enqueue_iq(&SW_SCHED(sw, part, chunk_list_head),
+			&sw->qids[qe->queue_id], qe);
+	return 1;
+}
+
+/* Free space of the CQ, less the events buffered for it */
+static __rte_always_inline uint16_t
+sw_cq_space(struct sw_evdev *sw, struct sw_partition *part, uint32_t cq)
+{
+	return part == NULL ? sw->cq_ring_space[cq] : part->cqs[cq].space;
+}
+
+static __rte_always_inline uint16_t
+sw_cq_count(struct sw_evdev *sw, struct sw_partition *part, uint32_t cq)
+{
+	return part == NULL ? sw->ports[cq].cq_buf_count : part->cqs[cq].count;
+}
+
+/* Check if no event can be scheduled to the CQ for now */
+static __rte_always_inline int
+sw_cq_busy(struct sw_evdev *sw, struct sw_partition *part, uint32_t cq)
+{
+	struct sw_port *p = &sw->ports[cq];
+
+	if (part == NULL)
+		return p->inflights == SW_PORT_HIST_LIST ||
+			rte_event_ring_free_count(p->cq_worker_ring) == 0;
+
+	return part->cqs[cq].space == 0 ||
+		__atomic_load_n(&p->inflights, __ATOMIC_RELAXED) >=
+			SW_PORT_HIST_LIST;
+}
+
+/* Take a history list entry of the port for an event scheduled to its CQ.
+ * Partitions scheduling to the same port take them concurrently, so the
+ * check and the increment of the inflights are done at once.
+ */
+static __rte_always_inline int
+sw_cq_reserve(struct sw_evdev *sw, struct sw_partition *part, uint32_t cq)
+{
+	struct sw_port *p = &sw->ports[cq];
+	uint16_t inflights;
+
+	if (sw_cq_space(sw, part, cq) == 0)
+		return 0;
+
+	if (part == NULL) {
+		if (p->inflights == SW_PORT_HIST_LIST)
+			return 0;
+		p->inflights++;
+		return 1;
+	}
+
+	inflights = __atomic_load_n(&p->inflights, __ATOMIC_RELAXED);
+	do {
+		if (inflights >= SW_PORT_HIST_LIST)
+			return 0;
+	} while (!__atomic_compare_exchange_n(&p->inflights, &inflights,
+			inflights + 1, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+	return 1;
+}
+
+/* Buffer an event for the CQ, with its history list entry */
+static __rte_always_inline void
+sw_cq_buffer(struct sw_evdev *sw, struct sw_partition *part, uint32_t cq,
+		const struct rte_event *qe, uint32_t qid_id, int32_t fid,
+		struct reorder_buffer_entry *rob_entry)
+{
+	struct sw_port *p = &sw->ports[cq];
+	struct sw_hist_list_entry *hist;
+
+	if (part == NULL) {
+		/* a single scheduler fills in the history list directly */
+		hist = &p->hist_list[p->hist_head++ & (SW_PORT_HIST_LIST-1)];
+		p->cq_buf[p->cq_buf_count++] = *qe;
+		p->stats.tx_pkts++;
+		sw->cq_ring_space[cq]--;
+	} else {
+		struct sw_partition_cq *pcq = &part->cqs[cq];
+
+		hist = &pcq->hist[pcq->count];
+		pcq->events[pcq->count++] = *qe;
+		pcq->space--;
+	}
+
+	hist->qid = qid_id;
+	hist->fid = fid;
+	hist->rob_entry = rob_entry;
+}
+
+/* Push the events a partition buffered to the CQ, with their history list
+ * entries in the same order. Events that do not fit in the CQ stay buffered.
+ */
+static void
+sw_part_cq_flush(struct sw_evdev *sw, struct sw_partition *part, uint32_t cq)
 {
+	struct sw_partition_cq *pcq = &part->cqs[cq];
+	struct sw_port *p = &sw->ports[cq];
+	uint16_t free_count, count, i;
+
+	rte_spinlock_lock(&p->cq_lock);
+
+	/* only the lock owner enqueues, so the free count can only grow */
+	free_count = rte_event_ring_free_count(p->cq_worker_ring);
+	count = RTE_MIN(pcq->count, free_count);
+
+	if (!p->is_directed) {
+		for (i = 0; i < count; i++) {
+			uint16_t head = (p->hist_head + i) &
+					(SW_PORT_HIST_LIST - 1);
+			p->hist_list[head] = pcq->hist[i];
+		}
+		__atomic_store_n(&p->hist_head, p->hist_head + count,
+				__ATOMIC_RELEASE);
+	}
+
+	rte_event_ring_enqueue_burst(p->cq_worker_ring, pcq->events, count,
+			&free_count);
+	p->stats.tx_pkts += count;
+
+	rte_spinlock_unlock(&p->cq_lock);
+
+	pcq->count -= count;
+	if (unlikely(pcq->count)) {
+		memmove(pcq->events, &pcq->events[count],
+				pcq->count * sizeof(pcq->events[0]));
+		memmove(pcq->hist, &pcq->hist[count],
+				pcq->count * sizeof(pcq->hist[0]));
+	}
+	pcq->space = free_count > pcq->count ? free_count - pcq->count : 0;
+}
+
+static __rte_always_inline void
+sw_cq_flush(struct sw_evdev *sw, struct sw_partition *part, uint32_t cq)
+{
+	struct sw_port *p = &sw->ports[cq];
+
+	if (part != NULL) {
+		sw_part_cq_flush(sw, part, cq);
+		return;
+	}
+
+	rte_event_ring_enqueue_burst(p->cq_worker_ring, p->cq_buf,
+			p->cq_buf_count, &sw->cq_ring_space[cq]);
+	p->cq_buf_count = 0;
+}
+
+/* Update the cached free space of the CQ */
+static __rte_always_inline void
+sw_cq_refresh(struct sw_evdev *sw, struct sw_partition *part, uint32_t cq)
+{
+	unsigned int free_count =
+		rte_event_ring_free_count(sw->ports[cq].cq_worker_ring);
+	uint16_t count = sw_cq_count(sw, part, cq);
+	uint16_t space = free_count > count ? free_count - count : 0;
+
+	if (part == NULL)
+		sw->cq_ring_space[cq] = space;
+	else
+		part->cqs[cq].space = space;
+}
+
+static __rte_always_inline int
+sw_atomic_cq(struct sw_evdev *sw, struct sw_partition *part,
+		struct sw_qid * const qid)
+{
+	uint32_t cq_idx;
+	int cq;
+
+	if (qid->cq_next_tx >= qid->cq_num_mapped_cqs)
+		qid->cq_next_tx = 0;
+	cq_idx = qid->cq_next_tx++;
+
+	cq = qid->cq_map[cq_idx];
+
+	/* find least used */
+	int cq_free_cnt = sw_cq_space(sw, part, cq);
+	for (cq_idx = 0; cq_idx < qid->cq_num_mapped_cqs; cq_idx++) {
+		int test_cq = qid->cq_map[cq_idx];
+		int test_cq_free = sw_cq_space(sw, part, test_cq);
+		if (test_cq_free > cq_free_cnt) {
+			cq = test_cq;
+			cq_free_cnt = test_cq_free;
+		}
+	}
+
+	return cq;
+}
+
+/* Pin the flow to a CQ if it is not, and count the event on it.
+ * Returns the CQ, or -1 if the event cannot be scheduled for now.
+ */
+static __rte_always_inline int
+sw_fid_schedule(struct sw_evdev *sw, struct sw_partition *part,
+		struct sw_qid * const qid, struct sw_fid_t *fid)
+{
+	struct sw_fid_t old_fid, new_fid;
+	int cq = -1;
+
+	if (part == NULL) {
+		if (fid->cq < 0)
+			fid->cq = sw_atomic_cq(sw, NULL, qid); /* this pins early */
+		if (!sw_cq_reserve(sw, NULL, fid->cq))
+			return -1;
+		fid->pcount++;
+		return fid->cq;
+	}
+
+	/* The partition pulling the port of the flow may release it
+	 * concurrently, but only the owner pins it or adds to it.
+	 */
+	old_fid.val = __atomic_load_n(&fid->val, __ATOMIC_ACQUIRE);
+	for (;;) {
+		new_fid.val = old_fid.val;
+		if (new_fid.cq < 0) {
+			if (cq < 0)
+				cq = sw_atomic_cq(sw, part, qid);
+			new_fid.cq = cq;
+		}
+
+		if (!sw_cq_reserve(sw, part, new_fid.cq))
+			return -1;
+		new_fid.pcount++;
+
+		if (__atomic_compare_exchange_n(&fid->val, &old_fid.val,
+				new_fid.val, 0, __ATOMIC_ACQ_REL,
+				__ATOMIC_ACQUIRE))
+			return new_fid.cq;
+
+		/* released meanwhile, give the entry back and retry */
+		__atomic_fetch_sub(&sw->ports[new_fid.cq].inflights, 1,
+				__ATOMIC_RELAXED);
+	}
+}
+
+static __rte_always_inline void
+sw_fid_release(struct sw_partition *part, struct sw_fid_t *fid,
+		uint16_t eop)
+{
+	struct sw_fid_t old_fid, new_fid;
+
+	if (part == NULL) {
+		fid->pcount -= eop;
+		if (fid->pcount == 0)
+			fid->cq = -1;
+		return;
+	}
+
+	old_fid.val = __atomic_load_n(&fid->val, __ATOMIC_RELAXED);
+	do {
+		new_fid.val = old_fid.val;
+		new_fid.pcount -= eop;
+		if (new_fid.pcount == 0)
+			new_fid.cq = -1;
+	} while (!__atomic_compare_exchange_n(&fid->val, &old_fid.val,
+			new_fid.val, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+}
+
+static __rte_always_inline uint32_t
+sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_partition *part,
+		struct sw_qid * const qid, uint32_t iq_num, unsigned int count)
+{
+	struct sw_queue_chunk **chunk_list =
+			&SW_SCHED(sw, part, chunk_list_head);
 	struct rte_event qes[MAX_PER_IQ_DEQUEUE]; /* count <= MAX */
 	struct rte_event blocked_qes[MAX_PER_IQ_DEQUEUE];
 	uint32_t nb_blocked = 0;
@@ -45,75 +391,36 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	 */
 	uint32_t qid_id = qid->id;
 
-	iq_dequeue_burst(sw, &qid->iq[iq_num], qes, count);
+	iq_dequeue_burst(chunk_list, &qid->iq[iq_num], qes, count);
 	for (i = 0; i < count; i++) {
 		const struct rte_event *qe = &qes[i];
 		const uint16_t flow_id = SW_HASH_FLOWID(qes[i].flow_id);
-		struct sw_fid_t *fid = &qid->fids[flow_id];
-		int cq = fid->cq;
+		int cq = sw_fid_schedule(sw, part, qid, &qid->fids[flow_id]);
 
 		if (cq < 0) {
-			uint32_t cq_idx;
-			if (qid->cq_next_tx >= qid->cq_num_mapped_cqs)
-				qid->cq_next_tx = 0;
-			cq_idx = qid->cq_next_tx++;
-
-			cq = qid->cq_map[cq_idx];
-
-			/* find least used */
-			int cq_free_cnt = sw->cq_ring_space[cq];
-			for (cq_idx = 0; cq_idx < qid->cq_num_mapped_cqs;
-					cq_idx++) {
-				int test_cq = qid->cq_map[cq_idx];
-				int test_cq_free = sw->cq_ring_space[test_cq];
-				if (test_cq_free > cq_free_cnt) {
-					cq = test_cq;
-					cq_free_cnt = test_cq_free;
-				}
-			}
-
-			fid->cq = cq; /* this pins early */
-		}
-
-		if (sw->cq_ring_space[cq] == 0 ||
-				sw->ports[cq].inflights == SW_PORT_HIST_LIST) {
 			blocked_qes[nb_blocked++] = *qe;
 			continue;
 		}
 
-		struct sw_port *p = &sw->ports[cq];
-
 		/* at this point we can queue up the packet on the cq_buf */
-		fid->pcount++;
-		p->cq_buf[p->cq_buf_count++] = *qe;
-		p->inflights++;
-		sw->cq_ring_space[cq]--;
+		sw_cq_buffer(sw, part, cq, qe, qid_id, flow_id, NULL);
 
-		int head = (p->hist_head++ & (SW_PORT_HIST_LIST-1));
-		p->hist_list[head].fid = flow_id;
-		p->hist_list[head].qid = qid_id;
-
-		p->stats.tx_pkts++;
 		qid->stats.tx_pkts++;
 		qid->to_port[cq]++;
 
 		/* if we just filled in the last slot, flush the buffer */
-		if (sw->cq_ring_space[cq] == 0) {
-			struct rte_event_ring *worker = p->cq_worker_ring;
-			rte_event_ring_enqueue_burst(worker, p->cq_buf,
-					p->cq_buf_count,
-					&sw->cq_ring_space[cq]);
-			p->cq_buf_count = 0;
-		}
+		if (sw_cq_space(sw, part, cq) == 0)
+			sw_cq_flush(sw, part, cq);
 	}
-	iq_put_back(sw, &qid->iq[iq_num], blocked_qes, nb_blocked);
+	iq_put_back(chunk_list, &qid->iq[iq_num], blocked_qes, nb_blocked);
 
 	return count - nb_blocked;
 }
 
-static inline uint32_t
-sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
-		uint32_t iq_num, unsigned int count, int keep_order)
+static __rte_always_inline uint32_t
+sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_partition *part,
+		struct sw_qid * const qid, uint32_t iq_num, unsigned int count,
+		int keep_order)
 {
 	uint32_t i;
 	uint32_t cq_idx = qid->cq_next_tx;
@@ -133,6 +440,7 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 
 	for (i = 0; i < count; i++) {
 		const struct rte_event *qe = iq_peek(&qid->iq[iq_num]);
+		struct reorder_buffer_entry *rob_entry = NULL;
 		uint32_t cq_check_count = 0;
 		uint32_t cq;
 
@@ -148,78 +456,77 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 				cq_idx = 0;
 			cq = qid->cq_map[cq_idx++];
 
-		} while (sw->ports[cq].inflights == SW_PORT_HIST_LIST ||
-				rte_event_ring_free_count(
-					sw->ports[cq].cq_worker_ring) == 0);
+		} while (sw_cq_busy(sw, part, cq));
 
-		struct sw_port *p = &sw->ports[cq];
-		if (sw->cq_ring_space[cq] == 0 ||
-				p->inflights == SW_PORT_HIST_LIST)
+		if (!sw_cq_reserve(sw, part, cq))
 			break;
 
-		sw->cq_ring_space[cq]--;
-
 		qid->stats.tx_pkts++;
 
-		const int head = (p->hist_head & (SW_PORT_HIST_LIST-1));
-		p->hist_list[head].fid = SW_HASH_FLOWID(qe->flow_id);
-		p->hist_list[head].qid = qid_id;
-
 		if (keep_order)
 			rob_ring_dequeue(qid->reorder_buffer_freelist,
-					(void *)&p->hist_list[head].rob_entry);
-
-		sw->ports[cq].cq_buf[sw->ports[cq].cq_buf_count++] = *qe;
-		iq_pop(sw, &qid->iq[iq_num]);
+					(void *)&rob_entry);
 
-		rte_compiler_barrier();
-		p->inflights++;
-		p->stats.tx_pkts++;
-		p->hist_head++;
+		/* no flow pinning to release on completion */
+		sw_cq_buffer(sw, part, cq, qe, qid_id, -1, rob_entry);
+		iq_pop(&SW_SCHED(sw, part, chunk_list_head), &qid->iq[iq_num]);
 	}
 exit:
 	qid->cq_next_tx = cq_idx;
 	return i;
 }
 
-static uint32_t
-sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
-		uint32_t iq_num, unsigned int count __rte_unused)
+static __rte_always_inline uint32_t
+sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_partition *part,
+		struct sw_qid * const qid, uint32_t iq_num,
+		unsigned int count __rte_unused)
 {
 	uint32_t cq_id = qid->cq_map[0];
 	struct sw_port *port = &sw->ports[cq_id];
+	uint32_t ret;
 
 	/* get max burst enq size for cq_ring */
-	uint32_t count_free = sw->cq_ring_space[cq_id];
+	uint32_t count_free = sw_cq_space(sw, part, cq_id);
 	if (count_free == 0)
 		return 0;
 
 	/* burst dequeue from the QID IQ ring */
 	struct sw_iq *iq = &qid->iq[iq_num];
-	uint32_t ret = iq_dequeue_burst(sw, iq,
-			&port->cq_buf[port->cq_buf_count], count_free);
-	port->cq_buf_count += ret;
+	if (part == NULL) {
+		ret = iq_dequeue_burst(&sw->chunk_list_head, iq,
+				&port->cq_buf[port->cq_buf_count], count_free);
+		port->cq_buf_count += ret;
+		port->stats.tx_pkts += ret;
+
+		/* Subtract credits from cached value */
+		sw->cq_ring_space[cq_id] -= ret;
+	} else {
+		struct sw_partition_cq *pcq = &part->cqs[cq_id];
 
-	/* Update QID, Port and Total TX stats */
-	qid->stats.tx_pkts += ret;
-	port->stats.tx_pkts += ret;
+		ret = iq_dequeue_burst(&part->chunk_list_head, iq,
+				&pcq->events[pcq->count], count_free);
+		pcq->count += ret;
+		pcq->space -= ret;
+	}
 
-	/* Subtract credits from cached value */
-	sw->cq_ring_space[cq_id] -= ret;
+	/* Update QID and Total TX stats */
+	qid->stats.tx_pkts += ret;
 
 	return ret;
 }
 
-static uint32_t
-sw_schedule_qid_to_cq(struct sw_evdev *sw)
+static __rte_always_inline uint32_t
+sw_schedule_qid_to_cq(struct sw_evdev *sw, struct sw_partition *part)
 {
+	struct sw_qid * const *qids = SW_SCHED(sw, part, qids_prioritized);
+	const uint32_t qid_count = SW_SCHED(sw, part, qid_count);
 	uint32_t pkts = 0;
 	uint32_t qid_idx;
 
-	sw->sched_cq_qid_called++;
+	SW_SCHED(sw, part, sched_cq_qid_called)++;
 
-	for (qid_idx = 0; qid_idx < sw->qid_count; qid_idx++) {
-		struct sw_qid *qid = sw->qids_prioritized[qid_idx];
+	for (qid_idx = 0; qid_idx < qid_count; qid_idx++) {
+		struct sw_qid *qid = qids[qid_idx];
 
 		int type = qid->type;
 		int iq_num = PKT_MASK_TO_IQ(qid->iq_pkt_mask);
@@ -231,16 +538,16 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 		uint32_t pkts_done = 0;
 		uint32_t count = iq_count(&qid->iq[iq_num]);
 
-		if (count >= sw->sched_min_burst) {
+		if (count >= SW_SCHED(sw, part, sched_min_burst)) {
 			if (type == SW_SCHED_TYPE_DIRECT)
-				pkts_done += sw_schedule_dir_to_cq(sw, qid,
-						iq_num, count);
+				pkts_done += sw_schedule_dir_to_cq(sw, part,
+						qid, iq_num, count);
 			else if (type == RTE_SCHED_TYPE_ATOMIC)
-				pkts_done += sw_schedule_atomic_to_cq(sw, qid,
-						iq_num, count);
+				pkts_done += sw_schedule_atomic_to_cq(sw, part,
+						qid, iq_num, count);
 			else
-				pkts_done += sw_schedule_parallel_to_cq(sw, qid,
-						iq_num, count,
+				pkts_done += sw_schedule_parallel_to_cq(sw,
+						part, qid, iq_num, count,
 						type == RTE_SCHED_TYPE_ORDERED);
 		}
 
@@ -260,8 +567,9 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
  * the appropriate QID IQ. As LB and DIR QIDs are in the same array, but *NOT*
  * contiguous in that array, this function accepts a "range" of QIDs to scan.
  */
-static uint16_t
-sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
+static __rte_always_inline uint16_t
+sw_schedule_reorder(struct sw_evdev *sw, struct sw_partition *part,
+		int qid_start, int qid_end)
 {
 	/* Perform egress reordering */
 	struct rte_event *qe;
@@ -274,10 +582,13 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 		if (qid->type != RTE_SCHED_TYPE_ORDERED)
 			continue;
 
+		if (part != NULL && sw->qid_partition[qid_start] != part->id)
+			continue;
+
 		num_entries_in_use = rob_ring_free_count(
 					qid->reorder_buffer_freelist);
 
-		if (num_entries_in_use < sw->sched_min_burst)
+		if (num_entries_in_use < SW_SCHED(sw, part, sched_min_burst))
 			num_entries_in_use = 0;
 
 		for (i = 0; i < num_entries_in_use; i++) {
@@ -286,52 +597,41 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 
 			entry = &qid->reorder_buffer[qid->reorder_buffer_index];
 
-			if (!entry->ready)
+			/* set by the scheduler pulling the port, after the
+			 * fragments are written
+			 */
+			if (!__atomic_load_n(&entry->ready, __ATOMIC_ACQUIRE))
 				break;
 
 			for (j = 0; j < entry->num_fragments; j++) {
-				uint16_t dest_qid;
-				uint16_t dest_iq;
-
 				int idx = entry->fragment_index + j;
 				qe = &entry->fragments[idx];
 
-				dest_qid = qe->queue_id;
-				dest_iq  = PRIO_TO_IQ(qe->priority);
-
-				if (dest_qid >= sw->qid_count) {
-					sw->stats.rx_dropped++;
+				if (qe->queue_id >= sw->qid_count) {
+					SW_SCHED(sw, part, stats).rx_dropped++;
 					continue;
 				}
 
-				pkts_iter++;
+				if (!sw_fwd_room(sw, part, qe->queue_id))
+					break;
 
-				struct sw_qid *q = &sw->qids[dest_qid];
-				struct sw_iq *iq = &q->iq[dest_iq];
-
-				/* we checked for space above, so enqueue must
-				 * succeed
-				 */
-				iq_enqueue(sw, iq, qe);
-				q->iq_pkt_mask |= (1 << (dest_iq));
-				q->iq_pkt_count[dest_iq]++;
-				q->stats.rx_pkts++;
+				pkts_iter += sw_qid_enqueue(sw, part, qe);
 			}
 
-			entry->ready = (j != entry->num_fragments);
 			entry->num_fragments -= j;
 			entry->fragment_index += j;
 
-			if (!entry->ready) {
-				entry->fragment_index = 0;
+			/* keep the order, resume from this entry next time */
+			if (entry->num_fragments)
+				break;
 
-				rob_ring_enqueue(
-						qid->reorder_buffer_freelist,
-						entry);
+			entry->ready = 0;
+			entry->fragment_index = 0;
 
-				qid->reorder_buffer_index++;
-				qid->reorder_buffer_index %= qid->window_size;
-			}
+			rob_ring_enqueue(qid->reorder_buffer_freelist, entry);
+
+			qid->reorder_buffer_index++;
+			qid->reorder_buffer_index %= qid->window_size;
 		}
 	}
 	return pkts_iter;
@@ -348,78 +648,64 @@ sw_refill_pp_buf(struct sw_evdev *sw, struct sw_port *port)
 }
 
 static __rte_always_inline uint32_t
-__pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
+__pull_port_lb(struct sw_evdev *sw, struct sw_partition *part,
+		uint32_t port_id, int allow_reorder)
 {
-	static struct reorder_buffer_entry dummy_rob;
 	uint32_t pkts_iter = 0;
 	struct sw_port *port = &sw->ports[port_id];
+	uint16_t hist_head;
 
 	/* If shadow ring has 0 pkts, pull from worker ring */
 	if (!sw->refill_once_per_iter && port->pp_buf_count == 0)
 		sw_refill_pp_buf(sw, port);
 
+	/* history of all the events completed by the pulled events */
+	hist_head = __atomic_load_n(&port->hist_head, __ATOMIC_ACQUIRE);
+
 	while (port->pp_buf_count) {
 		const struct rte_event *qe = &port->pp_buf[port->pp_buf_start];
-		struct sw_hist_list_entry *hist_entry = NULL;
+		struct reorder_buffer_entry *rob_entry = NULL;
 		uint8_t flags = qe->op;
 		const uint16_t eop = !(flags & QE_FLAG_NOT_EOP);
-		int needs_reorder = 0;
 		/* if no-reordering, having PARTIAL == NEW */
 		if (!allow_reorder && !eop)
 			flags = QE_FLAG_VALID;
 
-		/*
-		 * if we don't have space for this packet in an IQ,
-		 * then move on to next queue. Technically, for a
-		 * packet that needs reordering, we don't need to check
-		 * here, but it simplifies things not to special-case
-		 */
-		uint32_t iq_num = PRIO_TO_IQ(qe->priority);
-		struct sw_qid *qid = &sw->qids[qe->queue_id];
+		/* leave the event in the port until it can be passed on */
+		if ((flags & QE_FLAG_VALID) &&
+				!sw_fwd_room(sw, part, qe->queue_id))
+			break;
 
 		/* now process based on flags. Note that for directed
 		 * queues, the enqueue_flush masks off all but the
 		 * valid flag. This makes FWD and PARTIAL enqueues just
 		 * NEW type, and makes DROPS no-op calls.
 		 */
-		if ((flags & QE_FLAG_COMPLETE) && port->inflights > 0) {
+		if ((flags & QE_FLAG_COMPLETE) && port->hist_tail != hist_head) {
 			const uint32_t hist_tail = port->hist_tail &
 					(SW_PORT_HIST_LIST - 1);
+			struct sw_hist_list_entry *hist_entry =
+					&port->hist_list[hist_tail];
 
-			hist_entry = &port->hist_list[hist_tail];
-			const uint32_t hist_qid = hist_entry->qid;
-			const uint32_t hist_fid = hist_entry->fid;
-
-			struct sw_fid_t *fid =
-				&sw->qids[hist_qid].fids[hist_fid];
-			fid->pcount -= eop;
-			if (fid->pcount == 0)
-				fid->cq = -1;
-
-			if (allow_reorder) {
-				/* set reorder ready if an ordered QID */
-				uintptr_t rob_ptr =
-					(uintptr_t)hist_entry->rob_entry;
-				const uintptr_t valid = (rob_ptr != 0);
-				needs_reorder = valid;
-				rob_ptr |=
-					((valid - 1) & (uintptr_t)&dummy_rob);
-				struct reorder_buffer_entry *tmp_rob_ptr =
-					(struct reorder_buffer_entry *)rob_ptr;
-				tmp_rob_ptr->ready = eop * needs_reorder;
-			}
+			if (hist_entry->fid >= 0)
+				sw_fid_release(part, &sw->qids[
+					hist_entry->qid].fids[hist_entry->fid],
+					eop);
 
-			port->inflights -= eop;
+			if (allow_reorder)
+				rob_entry = hist_entry->rob_entry;
+
+			if (part == NULL)
+				port->inflights -= eop;
+			else
+				__atomic_fetch_sub(&port->inflights, eop,
+						__ATOMIC_RELAXED);
 			port->hist_tail += eop;
 		}
 		if (flags & QE_FLAG_VALID) {
 			port->stats.rx_pkts++;
 
-			if (allow_reorder && needs_reorder) {
-				struct reorder_buffer_entry *rob_entry =
-						hist_entry->rob_entry;
-
-				hist_entry->rob_entry = NULL;
+			if (rob_entry != NULL) {
 				/* Although fragmentation not currently
 				 * supported by eventdev API, we support it
 				 * here. Open: How do we alert the user that
@@ -427,26 +713,20 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				 */
 				int num_frag = rob_entry->num_fragments;
 				if (num_frag == SW_FRAGMENTS_MAX)
-					sw->stats.rx_dropped++;
+					SW_SCHED(sw, part, stats).rx_dropped++;
 				else {
-					int idx = rob_entry->num_fragments++;
-					rob_entry->fragments[idx] = *qe;
+					rob_entry->fragments[num_frag] = *qe;
+					rob_entry->num_fragments++;
 				}
-				goto end_qe;
-			}
-
-			/* Use the iq_num from above to push the QE
-			 * into the qid at the right priority
-			 */
-
-			qid->iq_pkt_mask |= (1 << (iq_num));
-			iq_enqueue(sw, &qid->iq[iq_num], qe);
-			qid->iq_pkt_count[iq_num]++;
-			qid->stats.rx_pkts++;
-			pkts_iter++;
+			} else
+				pkts_iter += sw_qid_enqueue(sw, part, qe);
 		}
 
-end_qe:
+		/* hand the entry over to the scheduler owning its QID */
+		if (rob_entry != NULL && eop)
+			__atomic_store_n(&rob_entry->ready, 1,
+					__ATOMIC_RELEASE);
+
 		port->pp_buf_start++;
 		port->pp_buf_count--;
 	} /* while (avail_qes) */
@@ -454,20 +734,23 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 	return pkts_iter;
 }
 
-static uint32_t
-sw_schedule_pull_port_lb(struct sw_evdev *sw, uint32_t port_id)
+static __rte_always_inline uint32_t
+sw_schedule_pull_port_lb(struct sw_evdev *sw, struct sw_partition *part,
+		uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 1);
+	return __pull_port_lb(sw, part, port_id, 1);
 }
 
-static uint32_t
-sw_schedule_pull_port_no_reorder(struct sw_evdev *sw, uint32_t port_id)
+static __rte_always_inline uint32_t
+sw_schedule_pull_port_no_reorder(struct sw_evdev *sw,
+		struct sw_partition *part, uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 0);
+	return __pull_port_lb(sw, part, port_id, 0);
 }
 
-static uint32_t
-sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
+static __rte_always_inline uint32_t
+sw_schedule_pull_port_dir(struct sw_evdev *sw, struct sw_partition *part,
+		uint32_t port_id)
 {
 	uint32_t pkts_iter = 0;
 	struct sw_port *port = &sw->ports[port_id];
@@ -483,20 +766,13 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 		if ((flags & QE_FLAG_VALID) == 0)
 			goto end_qe;
 
-		uint32_t iq_num = PRIO_TO_IQ(qe->priority);
-		struct sw_qid *qid = &sw->qids[qe->queue_id];
-		struct sw_iq *iq = &qid->iq[iq_num];
+		if (!sw_fwd_room(sw, part, qe->queue_id))
+			break;
 
 		port->stats.rx_pkts++;
 
-		/* Use the iq_num from above to push the QE
-		 * into the qid at the right priority
-		 */
-		qid->iq_pkt_mask |= (1 << (iq_num));
-		iq_enqueue(sw, iq, qe);
-		qid->iq_pkt_count[iq_num]++;
-		qid->stats.rx_pkts++;
-		pkts_iter++;
+		/* Push the QE into the qid at the right priority */
+		pkts_iter += sw_qid_enqueue(sw, part, qe);
 
 end_qe:
 		port->pp_buf_start++;
@@ -506,46 +782,80 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 	return pkts_iter;
 }
 
-void
-sw_event_schedule(struct rte_eventdev *dev)
+/* Enqueue the events pulled by other partitions to the owned QIDs */
+static uint32_t
+sw_part_pull_rx_ring(struct sw_evdev *sw, struct sw_partition *part)
+{
+	struct rte_event qes[SCHED_DEQUEUE_MAX_BURST_SIZE];
+	uint32_t i, count;
+
+	count = rte_event_ring_dequeue_burst(part->rx_ring, qes,
+			sw->sched_deq_burst_size, NULL);
+	for (i = 0; i < count; i++)
+		sw_enqueue_iq(&part->chunk_list_head,
+				&sw->qids[qes[i].queue_id], &qes[i]);
+
+	return count;
+}
+
+static __rte_always_inline uint32_t
+sw_schedule_pull_ports(struct sw_evdev *sw, struct sw_partition *part)
+{
+	const uint32_t port_count = SW_SCHED(sw, part, port_count);
+	uint32_t pkts = 0;
+	uint32_t i;
+
+	for (i = 0; i < port_count; i++) {
+		uint32_t port_id = sw_sched_port_id(part, i);
+		struct sw_port *port = &sw->ports[port_id];
+
+		/* ack the unlinks in progress as done */
+		if (port->unlinks_in_progress)
+			port->unlinks_in_progress = 0;
+
+		if (port->is_directed)
+			pkts += sw_schedule_pull_port_dir(sw, part, port_id);
+		else if (port->num_ordered_qids > 0)
+			pkts += sw_schedule_pull_port_lb(sw, part, port_id);
+		else
+			pkts += sw_schedule_pull_port_no_reorder(sw, part,
+					port_id);
+	}
+
+	if (part != NULL) {
+		for (i = 0; i < sw->sched_partitions; i++)
+			if (part->fwd_count[i])
+				sw_part_fwd_flush(sw, part, i);
+
+		pkts += sw_part_pull_rx_ring(sw, part);
+	}
+
+	return pkts;
+}
+
+static __rte_always_inline void
+sw_schedule(struct sw_evdev *sw, struct sw_partition *part)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	uint32_t in_pkts, out_pkts;
 	uint32_t out_pkts_total = 0, in_pkts_total = 0;
 	int32_t sched_quanta = sw->sched_quanta;
 	uint32_t i;
 
-	sw->sched_called++;
-	if (unlikely(!sw->started))
-		return;
-
 	do {
 		uint32_t in_pkts_this_iteration = 0;
 
 		/* Pull from rx_ring for ports */
 		do {
-			in_pkts = 0;
-			for (i = 0; i < sw->port_count; i++) {
-				/* ack the unlinks in progress as done */
-				if (sw->ports[i].unlinks_in_progress)
-					sw->ports[i].unlinks_in_progress = 0;
-
-				if (sw->ports[i].is_directed)
-					in_pkts += sw_schedule_pull_port_dir(sw, i);
-				else if (sw->ports[i].num_ordered_qids > 0)
-					in_pkts += sw_schedule_pull_port_lb(sw, i);
-				else
-					in_pkts += sw_schedule_pull_port_no_reorder(sw, i);
-			}
+			in_pkts = sw_schedule_pull_ports(sw, part);
 
 			/* QID scan for re-ordered */
-			in_pkts += sw_schedule_reorder(sw, 0,
+			in_pkts += sw_schedule_reorder(sw, part, 0,
 					sw->qid_count);
 			in_pkts_this_iteration += in_pkts;
 		} while (in_pkts > 4 &&
 				(int)in_pkts_this_iteration < sched_quanta);
 
-		out_pkts = sw_schedule_qid_to_cq(sw);
+		out_pkts = sw_schedule_qid_to_cq(sw, part);
 		out_pkts_total += out_pkts;
 		in_pkts_total += in_pkts_this_iteration;
 
@@ -553,61 +863,104 @@ sw_event_schedule(struct rte_eventdev *dev)
 			break;
 	} while ((int)out_pkts_total < sched_quanta);
 
-	sw->stats.tx_pkts += out_pkts_total;
-	sw->stats.rx_pkts += in_pkts_total;
+	SW_SCHED(sw, part, stats).tx_pkts += out_pkts_total;
+	SW_SCHED(sw, part, stats).rx_pkts += in_pkts_total;
 
-	sw->sched_no_iq_enqueues += (in_pkts_total == 0);
-	sw->sched_no_cq_enqueues += (out_pkts_total == 0);
+	SW_SCHED(sw, part, sched_no_iq_enqueues) += (in_pkts_total == 0);
+	SW_SCHED(sw, part, sched_no_cq_enqueues) += (out_pkts_total == 0);
 
 	uint64_t work_done = (in_pkts_total + out_pkts_total) != 0;
-	sw->sched_progress_last_iter = work_done;
+	SW_SCHED(sw, part, sched_progress_last_iter) = work_done;
 
 	uint64_t cqs_scheds_last_iter = 0;
 
+	/* If shadow ring has 0 pkts, pull from worker ring */
+	if (sw->refill_once_per_iter) {
+		for (i = 0; i < SW_SCHED(sw, part, port_count); i++) {
+			struct sw_port *port =
+				&sw->ports[sw_sched_port_id(part, i)];
+
+			if (port->pp_buf_count == 0)
+				sw_refill_pp_buf(sw, port);
+		}
+	}
+
 	/* push all the internal buffered QEs in port->cq_ring to the
 	 * worker cores: aka, do the ring transfers batched.
 	 */
 	int no_enq = 1;
 	for (i = 0; i < sw->port_count; i++) {
-		struct sw_port *port = &sw->ports[i];
-		struct rte_event_ring *worker = port->cq_worker_ring;
-
-		/* If shadow ring has 0 pkts, pull from worker ring */
-		if (sw->refill_once_per_iter && port->pp_buf_count == 0)
-			sw_refill_pp_buf(sw, port);
-
-		if (port->cq_buf_count >= sw->sched_min_burst) {
-			rte_event_ring_enqueue_burst(worker,
-					port->cq_buf,
-					port->cq_buf_count,
-					&sw->cq_ring_space[i]);
-			port->cq_buf_count = 0;
+		if (sw_cq_count(sw, part, i) >=
+				SW_SCHED(sw, part, sched_min_burst)) {
+			sw_cq_flush(sw, part, i);
 			no_enq = 0;
 			cqs_scheds_last_iter |= (1ULL << i);
 		} else {
-			sw->cq_ring_space[i] =
-					rte_event_ring_free_count(worker) -
-					port->cq_buf_count;
+			sw_cq_refresh(sw, part, i);
 		}
 	}
 
 	if (no_enq) {
-		if (unlikely(sw->sched_flush_count > SCHED_NO_ENQ_CYCLE_FLUSH))
-			sw->sched_min_burst = 1;
+		if (unlikely(SW_SCHED(sw, part, sched_flush_count) >
+				SCHED_NO_ENQ_CYCLE_FLUSH))
+			SW_SCHED(sw, part, sched_min_burst) = 1;
 		else
-			sw->sched_flush_count++;
+			SW_SCHED(sw, part, sched_flush_count)++;
 	} else {
-		if (sw->sched_flush_count)
-			sw->sched_flush_count--;
+		if (SW_SCHED(sw, part, sched_flush_count))
+			SW_SCHED(sw, part, sched_flush_count)--;
 		else
-			sw->sched_min_burst = sw->sched_min_burst_size;
+			SW_SCHED(sw, part, sched_min_burst) =
+					sw->sched_min_burst_size;
 	}
 
 	/* Provide stats on what eventdev ports were scheduled to this
 	 * iteration. If more than 64 ports are active, always report that
 	 * all Eventdev ports have been scheduled events.
 	 */
-	sw->sched_last_iter_bitmask = cqs_scheds_last_iter;
+	SW_SCHED(sw, part, sched_last_iter_bitmask) = cqs_scheds_last_iter;
 	if (unlikely(sw->port_count >= 64))
-		sw->sched_last_iter_bitmask = UINT64_MAX;
+		SW_SCHED(sw, part, sched_last_iter_bitmask) = UINT64_MAX;
+}
+
+/* Run the partitions not run by other lcores, starting from a different
+ * one on each lcore so that they tend to stay on the same lcore.
+ */
+static void
+sw_event_schedule_partitions(struct sw_evdev *sw)
+{
+	uint32_t nb_parts = sw->sched_partitions;
+	uint32_t first = rte_lcore_id() % nb_parts;
+	uint32_t i;
+
+	if (unlikely(!sw->started))
+		return;
+
+	for (i = 0; i < nb_parts; i++) {
+		struct sw_partition *part =
+				&sw->partitions[(first + i) % nb_parts];
+
+		if (!rte_spinlock_trylock(&part->lock))
+			continue;
+		part->sched_called++;
+		sw_schedule(sw, part);
+		rte_spinlock_unlock(&part->lock);
+	}
+}
+
+void
+sw_event_schedule(struct rte_eventdev *dev)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+
+	if (sw->partitions != NULL) {
+		sw_event_schedule_partitions(sw);
+		return;
+	}
+
+	sw->sched_called++;
+	if (unlikely(!sw->started))
+		return;
+
+	sw_schedule(sw, NULL);
 }
@@ -163,10 +163,13 @@ init(struct test *t, int nb_queues, int nb_ports)
 	};
 	int ret;
 
-	void *temp = t->mbuf_pool; /* save and restore mbuf pool */
+	/* save and restore mbuf pool and service of the device under test */
+	void *temp = t->mbuf_pool;
+	uint32_t service_id = t->service_id;
 
 	memset(t, 0, sizeof(*t));
 	t->mbuf_pool = temp;
+	t->service_id = service_id;
 
 	ret = rte_event_dev_configure(evdev, &config);
 	if (ret < 0)
@@ -3179,6 +3182,193 @@ worker_loopback(struct test *t, uint8_t disable_implicit_release)
 	return 0;
 }
 
+#define PARTITIONED_FLOWS 4
+
+static int
+partitioned_pipeline(struct test *t)
+{
+	/*
+	 * Pass events through an ordered and an atomic queue, owned by
+	 * different scheduler partitions, and check that the atomic flows are
+	 * never scheduled to two ports at once, and that the events leave the
+	 * pipeline in order.
+	 *
+	 * rx_port - qid0 (ordered) - w1_port, w2_port - qid1 (atomic)
+	 *         - w1_port, w2_port - qid2 (directed) - tx_port
+	 */
+	const uint8_t rx_port = 0;
+	const uint8_t w1_port = 1;
+	const uint8_t w2_port = 2;
+	const uint8_t tx_port = 3;
+	const uint32_t nb_events = 256;
+	const uint32_t nb_flows = PARTITIONED_FLOWS;
+	uint64_t next_seq[PARTITIONED_FLOWS];
+	uint32_t i, deq_total = 0, iter;
+	int err;
+
+	if (init(t, 3, tx_port + 1) < 0 ||
+			create_ports(t, tx_port + 1) < 0 ||
+			create_ordered_qids(t, 1) < 0 ||
+			create_atomic_qids(t, 1) < 0 ||
+			create_directed_qids(t, 1, &tx_port)) {
+		printf("%d: Error initializing device\n", __LINE__);
+		return -1;
+	}
+
+	for (i = w1_port; i <= w2_port; i++) {
+		err = rte_event_port_link(evdev, t->port[i], t->qid, NULL, 2);
+		if (err != 2) {
+			printf("%d: error mapping lb qids\n", __LINE__);
+			cleanup(t);
+			return -1;
+		}
+	}
+
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		return -1;
+	}
+
+	for (i = 0; i < nb_events; i++) {
+		struct rte_event ev = {
+				.op = RTE_EVENT_OP_NEW,
+				.queue_id = t->qid[0],
+				.flow_id = i % nb_flows,
+				.u64 = i,
+		};
+
+		err = rte_event_enqueue_burst(evdev, t->port[rx_port], &ev, 1);
+		if (err != 1) {
+			printf("%d: Failed to enqueue event %u\n", __LINE__, i);
+			goto err;
+		}
+	}
+
+	for (i = 0; i < nb_flows; i++)
+		next_seq[i] = i;
+
+	for (iter = 0; iter < 1000 && deq_total < nb_events; iter++) {
+		struct rte_event deq_ev[3][DEQUEUE_DEPTH];
+		uint16_t nb_deq[3];
+		uint8_t flow_port[PARTITIONED_FLOWS];
+		uint16_t j;
+
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+		/* hold the events of both workers before forwarding them */
+		memset(flow_port, 0, sizeof(flow_port));
+		for (i = w1_port; i <= w2_port; i++) {
+			nb_deq[i] = rte_event_dequeue_burst(evdev, t->port[i],
+					deq_ev[i], DEQUEUE_DEPTH, 0);
+			for (j = 0; j < nb_deq[i]; j++) {
+				uint32_t flow = deq_ev[i][j].flow_id;
+
+				if (deq_ev[i][j].queue_id != t->qid[1])
+					continue;
+				if (flow_port[flow] != 0 &&
+						flow_port[flow] != i) {
+					printf("%d: flow %u on two ports\n",
+							__LINE__, flow);
+					goto err;
+				}
+				flow_port[flow] = i;
+			}
+		}
+
+		/* complete the second worker first, to reorder qid0 */
+		for (i = w2_port; i >= w1_port; i--) {
+			for (j = 0; j < nb_deq[i]; j++) {
+				deq_ev[i][j].op = RTE_EVENT_OP_FORWARD;
+				deq_ev[i][j].queue_id++;
+			}
+			err = rte_event_enqueue_burst(evdev, t->port[i],
+					deq_ev[i], nb_deq[i]);
+			if (err != nb_deq[i]) {
+				printf("%d: Failed to forward\n", __LINE__);
+				goto err;
+			}
+		}
+
+		nb_deq[0] = rte_event_dequeue_burst(evdev, t->port[tx_port],
+				deq_ev[0], DEQUEUE_DEPTH, 0);
+		for (j = 0; j < nb_deq[0]; j++) {
+			uint32_t flow = deq_ev[0][j].flow_id;
+
+			if (deq_ev[0][j].u64 != next_seq[flow]) {
+				printf("%d: flow %u: got event %"PRIu64
+						", expected %"PRIu64"\n",
+						__LINE__, flow,
+						deq_ev[0][j].u64,
+						next_seq[flow]);
+				goto err;
+			}
+			next_seq[flow] += nb_flows;
+		}
+		deq_total += nb_deq[0];
+	}
+
+	if (deq_total != nb_events) {
+		printf("%d: expected %u events at tx port, got %u\n",
+				__LINE__, nb_events, deq_total);
+		goto err;
+	}
+
+	cleanup(t);
+	return 0;
+err:
+	rte_event_dev_dump(evdev, stdout);
+	cleanup(t);
+	return -1;
+}
+
+static int
+test_sw_partitioned(struct test *t)
+{
+	const char *eventdev_name = "event_sw_partitioned";
+	int sw_evdev = evdev;
+	uint32_t service_id = t->service_id;
+	int ret = -1;
+
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0) {
+		if (rte_vdev_init(eventdev_name, "sched_partitions=2") < 0) {
+			printf("Error creating eventdev\n");
+			goto out;
+		}
+		evdev = rte_event_dev_get_dev_id(eventdev_name);
+		if (evdev < 0) {
+			printf("Error finding newly created eventdev\n");
+			goto out;
+		}
+	}
+
+	if (rte_event_dev_service_id_get(evdev, &t->service_id) < 0) {
+		printf("Failed to get service ID for software event dev\n");
+		goto out;
+	}
+	rte_service_runstate_set(t->service_id, 1);
+	rte_service_set_runstate_mapped_check(t->service_id, 0);
+
+	printf("*** Running Partitioned Pipeline test...\n");
+	ret = partitioned_pipeline(t);
+	if (ret != 0) {
+		printf("ERROR - Partitioned Pipeline test FAILED.\n");
+		goto out;
+	}
+	if (rte_lcore_count() >= 3) {
+		printf("*** Running Partitioned Worker loopback test...\n");
+		ret = worker_loopback(t, 0);
+		if (ret != 0)
+			printf("ERROR - Partitioned Worker loopback test FAILED.\n");
+	}
+
+out:
+	/* t is reset by init(), restore the default device service */
+	evdev = sw_evdev;
+	t->service_id = service_id;
+	return ret;
+}
+
 static struct rte_mempool *eventdev_func_mempool;
 
 int
@@ -3409,6 +3599,9 @@ test_sw_eventdev(void)
 		printf("### Not enough cores for worker loopback tests.\n");
 		printf("### Need at least 3 cores for the tests.\n");
 	}
+	ret = test_sw_partitioned(t);
+	if (ret != 0)
+		goto test_fail;
 
 	/*
 	 * Free test instance, leaving mempool initialized, and a pointer to it
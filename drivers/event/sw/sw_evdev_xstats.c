@@ -48,10 +48,43 @@ struct sw_xstats_entry {
 	uint64_t reset_value; /* an offset to be taken away to emulate resets */
 };
 
+static uint64_t
+get_partitions_stat(const struct sw_evdev *sw, enum xstats_type type)
+{
+	uint64_t val = 0;
+	unsigned int i;
+
+	for (i = 0; i < sw->sched_partitions; i++) {
+		const struct sw_partition *part = &sw->partitions[i];
+
+		switch (type) {
+		case rx: val += part->stats.rx_pkts; break;
+		case tx: val += part->stats.tx_pkts; break;
+		case dropped: val += part->stats.rx_dropped; break;
+		case calls: val += part->sched_called; break;
+		case no_iq_enq: val += part->sched_no_iq_enqueues; break;
+		case no_cq_enq: val += part->sched_no_cq_enqueues; break;
+		case sched_last_iter_bitmask:
+			val |= part->sched_last_iter_bitmask;
+			break;
+		case sched_progress_last_iter:
+			val |= part->sched_progress_last_iter;
+			break;
+
+		default: return -1;
+		}
+	}
+
+	return val;
+}
+
 static uint64_t
 get_dev_stat(const struct sw_evdev *sw, uint16_t obj_idx __rte_unused,
 		enum xstats_type type, int extra_arg __rte_unused)
 {
+	if (sw->partitions != NULL)
+		return get_partitions_stat(sw, type);
+
 	switch (type) {
 	case rx: return sw->stats.rx_pkts;
 	case tx: return sw->stats.tx_pkts;
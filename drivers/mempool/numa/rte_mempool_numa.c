@@ -0,0 +1,234 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+
+/*
+ * The NUMA mempool driver splits the objects of a mempool among one ring
+ * (shard) per NUMA socket, so that the lcores of different sockets do not
+ * share the head and tail cache lines of a single ring.
+ *
+ * Objects are enqueued in the shard of the socket of the calling lcore and
+ * dequeued from it. Only when this shard does not hold enough objects, they
+ * are stolen from the shards of the other sockets. When the mempool is
+ * populated, objects are enqueued in the shard of the socket of their memory.
+ *
+ * Each shard is big enough to hold all the objects, so enqueues never fail.
+ */
+
+struct numa_data {
+	/** Shard of the socket of the memory being populated, or -1. */
+	int fill_shard;
+	/** Shard used by the threads not bound to a socket. */
+	unsigned int default_shard;
+	unsigned int nb_shards;
+	/** Shard index of each socket ID. */
+	uint8_t socket_shard[RTE_MAX_NUMA_NODES];
+	struct rte_ring *shards[RTE_MAX_NUMA_NODES];
+};
+
+static inline unsigned int
+numa_local_shard(const struct numa_data *d)
+{
+	unsigned int socket_id = rte_socket_id();
+
+	if (unlikely(socket_id >= RTE_MAX_NUMA_NODES))
+		return d->default_shard;
+	return d->socket_shard[socket_id];
+}
+
+static int
+numa_enqueue(struct rte_mempool *mp, void * const *obj_table,
+	unsigned int n)
+{
+	struct numa_data *d = mp->pool_data;
+	unsigned int shard;
+
+	if (unlikely(d->fill_shard >= 0))
+		shard = d->fill_shard;
+	else
+		shard = numa_local_shard(d);
+
+	return rte_ring_mp_enqueue_bulk(d->shards[shard],
+			obj_table, n, NULL) == 0 ? -ENOBUFS : 0;
+}
+
+static int
+numa_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct numa_data *d = mp->pool_data;
+	unsigned int local, shard, got, i;
+
+	local = numa_local_shard(d);
+	if (likely(rte_ring_mc_dequeue_bulk(d->shards[local],
+			obj_table, n, NULL) != 0))
+		return 0;
+
+	/* steal the whole bulk from a remote shard */
+	shard = local;
+	for (i = 1; i < d->nb_shards; i++) {
+		if (++shard == d->nb_shards)
+			shard = 0;
+		if (rte_ring_mc_dequeue_bulk(d->shards[shard],
+				obj_table, n, NULL) != 0)
+			return 0;
+	}
+
+	if (d->nb_shards == 1)
+		return -ENOBUFS;
+
+	/*
+	 * No shard holds enough objects on its own, gather them from
+	 * all the shards, and give them back to the local shard if there
+	 * are not enough.
+	 */
+	got = 0;
+	shard = local;
+	for (i = 0; i < d->nb_shards && got < n; i++) {
+		got += rte_ring_mc_dequeue_burst(d->shards[shard],
+				obj_table + got, n - got, NULL);
+		if (++shard == d->nb_shards)
+			shard = 0;
+	}
+	if (got == n)
+		return 0;
+
+	rte_ring_mp_enqueue_bulk(d->shards[local], obj_table, got, NULL);
+	return -ENOBUFS;
+}
+
+static unsigned int
+numa_get_count(const struct rte_mempool *mp)
+{
+	const struct numa_data *d = mp->pool_data;
+	unsigned int count = 0;
+	unsigned int i;
+
+	for (i = 0; i < d->nb_shards; i++)
+		count += rte_ring_count(d->shards[i]);
+
+	return count;
+}
+
+static void
+numa_free(struct rte_mempool *mp)
+{
+	struct numa_data *d = mp->pool_data;
+	unsigned int i;
+
+	if (d == NULL)
+		return;
+
+	for (i = 0; i < d->nb_shards; i++)
+		rte_free(d->shards[i]);
+	rte_free(d);
+}
+
+static int
+numa_alloc(struct rte_mempool *mp)
+{
+	char rg_name[RTE_RING_NAMESIZE];
+	struct numa_data *d;
+	struct rte_ring *r;
+	unsigned int count;
+	ssize_t rg_size;
+	unsigned int i;
+	int socket_id;
+	int ret;
+
+	d = rte_zmalloc_socket("mempool_numa", sizeof(*d),
+			       RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (d == NULL) {
+		rte_errno = ENOMEM;
+		return -rte_errno;
+	}
+	d->fill_shard = -1;
+	d->nb_shards = RTE_MAX(rte_socket_count(), 1U);
+	mp->pool_data = d;
+
+	count = rte_align32pow2(mp->size + 1);
+	rg_size = rte_ring_get_memsize(count);
+	if (rg_size < 0) {
+		ret = rg_size;
+		goto err;
+	}
+
+	for (i = 0; i < d->nb_shards; i++) {
+		socket_id = rte_socket_id_by_idx(i);
+		if (socket_id < 0)
+			socket_id = SOCKET_ID_ANY;
+		else
+			d->socket_shard[socket_id] = i;
+		if (socket_id == mp->socket_id)
+			d->default_shard = i;
+
+		/* the shard rings are not looked up by name, do not register */
+		r = rte_zmalloc_socket("mempool_numa_shard", rg_size,
+				       RTE_CACHE_LINE_SIZE, socket_id);
+		if (r == NULL)
+			r = rte_zmalloc_socket("mempool_numa_shard", rg_size,
+					       RTE_CACHE_LINE_SIZE,
+					       SOCKET_ID_ANY);
+		if (r == NULL) {
+			ret = -ENOMEM;
+			goto err;
+		}
+		d->shards[i] = r;
+
+		snprintf(rg_name, sizeof(rg_name), "MPN%u_%s", i, mp->name);
+		ret = rte_ring_init(r, rg_name, count, 0);
+		if (ret < 0)
+			goto err;
+	}
+
+	return 0;
+
+err:
+	numa_free(mp);
+	mp->pool_data = NULL;
+	rte_errno = -ret;
+	return ret;
+}
+
+static int
+numa_populate(struct rte_mempool *mp, unsigned int max_objs,
+	      void *vaddr, rte_iova_t iova, size_t len,
+	      rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct numa_data *d = mp->pool_data;
+	const struct rte_memseg_list *msl;
+	int ret;
+
+	/* memory not allocated by EAL is left to the local shard */
+	msl = rte_mem_virt2memseg_list(vaddr);
+	if (msl != NULL && msl->socket_id >= 0 &&
+			msl->socket_id < RTE_MAX_NUMA_NODES)
+		d->fill_shard = d->socket_shard[msl->socket_id];
+
+	ret = rte_mempool_op_populate_helper(mp, 0, max_objs, vaddr, iova,
+					     len, obj_cb, obj_cb_arg);
+
+	d->fill_shard = -1;
+	return ret;
+}
+
+static const struct rte_mempool_ops ops_numa = {
+	.name = "numa",
+	.alloc = numa_alloc,
+	.free = numa_free,
+	.enqueue = numa_enqueue,
+	.dequeue = numa_dequeue,
+	.get_count = numa_get_count,
+	.populate = numa_populate,
+};
+
+MEMPOOL_REGISTER_OPS(ops_numa);
@@ -34,9 +34,13 @@
 #define ETH_AF_PACKET_FRAMESIZE_ARG	"framesz"
 #define ETH_AF_PACKET_FRAMECOUNT_ARG	"framecnt"
 #define ETH_AF_PACKET_QDISC_BYPASS_ARG	"qdisc_bypass"
+#define ETH_AF_PACKET_TPACKET_V3_ARG	"tpacket_v3"
+#define ETH_AF_PACKET_BLOCKTMO_ARG	"blocktmo"
+#define ETH_AF_PACKET_ZEROCOPY_ARG	"zerocopy"
 
 #define DFLT_FRAME_SIZE		(1 << 11)
 #define DFLT_FRAME_COUNT	(1 << 9)
+#define DFLT_V3_BLOCK_SIZE	(1 << 17)
 
 struct pkt_rx_queue {
 	int sockfd;
@@ -46,6 +50,14 @@ struct pkt_rx_queue {
 	unsigned int framecount;
 	unsigned int framenum;
 
+	/* TPACKET_V3: rd describes the blocks instead of the frames */
+	unsigned int blockcount;
+	unsigned int blocknum;
+	unsigned int block_pkts_left;
+	struct tpacket3_hdr *block_ppd;
+	/* zero-copy: one shared info per block, counting its attached mbufs */
+	struct rte_mbuf_ext_shared_info *shinfo;
+
 	struct rte_mempool *mb_pool;
 	uint16_t in_port;
 
@@ -55,7 +67,9 @@ struct pkt_rx_queue {
 
 struct pkt_tx_queue {
 	int sockfd;
+	int tpver;
 	unsigned int frame_data_size;
+	unsigned int frame_data_offset;
 
 	struct iovec *rd;
 	uint8_t *map;
@@ -74,6 +88,8 @@ struct pmd_internals {
 	char *if_name;
 	struct rte_ether_addr eth_addr;
 
+	int tpver;
+	unsigned int tp_hdrlen;
 	struct tpacket_req req;
 
 	struct pkt_rx_queue *rx_queue;
@@ -87,6 +103,9 @@ static const char *valid_arguments[] = {
 	ETH_AF_PACKET_FRAMESIZE_ARG,
 	ETH_AF_PACKET_FRAMECOUNT_ARG,
 	ETH_AF_PACKET_QDISC_BYPASS_ARG,
+	ETH_AF_PACKET_TPACKET_V3_ARG,
+	ETH_AF_PACKET_BLOCKTMO_ARG,
+	ETH_AF_PACKET_ZEROCOPY_ARG,
 	NULL
 };
 
@@ -167,13 +186,162 @@ eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/*
+ * Zero-copy mbufs are attached to the TPACKET_V3 block they were received in,
+ * the block goes back to the kernel once its last mbuf is freed.
+ */
+static void
+eth_af_packet_block_free_cb(void *addr __rte_unused, void *opaque)
+{
+	struct tpacket_block_desc *pbd = opaque;
+
+	__atomic_store_n(&pbd->hdr.bh1.block_status, TP_STATUS_KERNEL,
+			 __ATOMIC_RELEASE);
+}
+
+static inline void
+eth_af_packet_block_release(struct pkt_rx_queue *pkt_q)
+{
+	unsigned int blocknum = pkt_q->blocknum;
+	struct tpacket_block_desc *pbd = pkt_q->rd[blocknum].iov_base;
+
+	/* drop the reference held by the Rx path while walking the block */
+	if (pkt_q->shinfo == NULL ||
+	    rte_mbuf_ext_refcnt_update(&pkt_q->shinfo[blocknum], -1) == 0)
+		__atomic_store_n(&pbd->hdr.bh1.block_status, TP_STATUS_KERNEL,
+				 __ATOMIC_RELEASE);
+
+	if (++blocknum >= pkt_q->blockcount)
+		blocknum = 0;
+	pkt_q->blocknum = blocknum;
+}
+
+static uint16_t
+eth_af_packet_rx_v3(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct tpacket_block_desc *pbd;
+	struct tpacket3_hdr *ppd;
+	struct rte_mbuf *mbuf;
+	uint8_t *pbuf;
+	struct pkt_rx_queue *pkt_q = queue;
+	uint16_t num_rx = 0;
+	unsigned long num_rx_bytes = 0;
+	uint32_t len;
+
+	if (unlikely(nb_pkts == 0))
+		return 0;
+
+	/*
+	 * Walks the packets of the blocks retired by the kernel, a block is
+	 * handed back once all of its packets are consumed.
+	 */
+	while (num_rx < nb_pkts) {
+		if (pkt_q->block_pkts_left == 0) {
+			pbd = pkt_q->rd[pkt_q->blocknum].iov_base;
+			if ((__atomic_load_n(&pbd->hdr.bh1.block_status,
+					     __ATOMIC_ACQUIRE) &
+			     TP_STATUS_USER) == 0)
+				break;
+
+			if (pkt_q->shinfo != NULL)
+				rte_mbuf_ext_refcnt_set(
+					&pkt_q->shinfo[pkt_q->blocknum], 1);
+
+			pkt_q->block_pkts_left = pbd->hdr.bh1.num_pkts;
+			pkt_q->block_ppd = (struct tpacket3_hdr *)((uint8_t *)pbd +
+				pbd->hdr.bh1.offset_to_first_pkt);
+			if (unlikely(pkt_q->block_pkts_left == 0)) {
+				eth_af_packet_block_release(pkt_q);
+				continue;
+			}
+		}
+
+		/* allocate the next mbuf */
+		mbuf = rte_pktmbuf_alloc(pkt_q->mb_pool);
+		if (unlikely(mbuf == NULL))
+			break;
+
+		ppd = pkt_q->block_ppd;
+		pbuf = (uint8_t *)ppd + ppd->tp_mac;
+		len = ppd->tp_snaplen;
+
+		if (pkt_q->shinfo != NULL &&
+		    ppd->tp_mac + len <= UINT16_MAX) {
+			/* attach the mbuf to the packet within the block */
+			rte_mbuf_ext_refcnt_update(
+				&pkt_q->shinfo[pkt_q->blocknum], 1);
+			rte_pktmbuf_attach_extbuf(mbuf, ppd, RTE_BAD_IOVA,
+				ppd->tp_mac + len,
+				&pkt_q->shinfo[pkt_q->blocknum]);
+			mbuf->data_off = ppd->tp_mac;
+		} else {
+			/* truncate what does not fit in the mbuf, as V2 does */
+			len = RTE_MIN(len, (uint32_t)rte_pktmbuf_tailroom(mbuf));
+			memcpy(rte_pktmbuf_mtod(mbuf, void *), pbuf, len);
+		}
+		rte_pktmbuf_pkt_len(mbuf) = rte_pktmbuf_data_len(mbuf) = len;
+
+		/* check for vlan info */
+		if (ppd->tp_status & TP_STATUS_VLAN_VALID) {
+			mbuf->vlan_tci = ppd->hv1.tp_vlan_tci;
+			mbuf->ol_flags |= (PKT_RX_VLAN | PKT_RX_VLAN_STRIPPED);
+		}
+		mbuf->port = pkt_q->in_port;
+
+		/* advance within the block, release it after its last packet */
+		pkt_q->block_ppd = (struct tpacket3_hdr *)((uint8_t *)ppd +
+			ppd->tp_next_offset);
+		if (--pkt_q->block_pkts_left == 0)
+			eth_af_packet_block_release(pkt_q);
+
+		/* account for the receive frame */
+		bufs[num_rx++] = mbuf;
+		num_rx_bytes += mbuf->pkt_len;
+	}
+	pkt_q->rx_pkts += num_rx;
+	pkt_q->rx_bytes += num_rx_bytes;
+	return num_rx;
+}
+
+/*
+ * The Tx ring is made of frames for both TPACKET_V2 and TPACKET_V3, with the
+ * frame header layout depending on the version.
+ */
+static inline uint32_t
+tx_frame_status(const struct pkt_tx_queue *pkt_q, void *ppd)
+{
+	if (pkt_q->tpver == TPACKET_V3)
+		return ((struct tpacket3_hdr *)ppd)->tp_status;
+
+	return ((struct tpacket2_hdr *)ppd)->tp_status;
+}
+
+static inline void
+tx_frame_send_request(const struct pkt_tx_queue *pkt_q, void *ppd,
+		      uint32_t len)
+{
+	if (pkt_q->tpver == TPACKET_V3) {
+		struct tpacket3_hdr *ppd3 = ppd;
+
+		ppd3->tp_len = len;
+		ppd3->tp_snaplen = len;
+		ppd3->tp_status = TP_STATUS_SEND_REQUEST;
+	} else {
+		struct tpacket2_hdr *ppd2 = ppd;
+
+		ppd2->tp_len = len;
+		ppd2->tp_snaplen = len;
+		ppd2->tp_status = TP_STATUS_SEND_REQUEST;
+	}
+}
+
 /*
  * Callback to handle sending packets through a real NIC.
  */
 static uint16_t
 eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
-	struct tpacket2_hdr *ppd;
+	void *ppd;
 	struct rte_mbuf *mbuf;
 	uint8_t *pbuf;
 	unsigned int framecount, framenum;
@@ -193,7 +361,7 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 	framecount = pkt_q->framecount;
 	framenum = pkt_q->framenum;
-	ppd = (struct tpacket2_hdr *) pkt_q->rd[framenum].iov_base;
+	ppd = pkt_q->rd[framenum].iov_base;
 	for (i = 0; i < nb_pkts; i++) {
 		mbuf = *bufs++;
 
@@ -212,13 +380,12 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		}
 
 		/* point at the next incoming frame */
-		if ((ppd->tp_status != TP_STATUS_AVAILABLE) &&
+		if ((tx_frame_status(pkt_q, ppd) != TP_STATUS_AVAILABLE) &&
 		    (poll(&pfd, 1, -1) < 0))
 			break;
 
 		/* copy the tx frame data */
-		pbuf = (uint8_t *) ppd + TPACKET2_HDRLEN -
-			sizeof(struct sockaddr_ll);
+		pbuf = (uint8_t *)ppd + pkt_q->frame_data_offset;
 
 		struct rte_mbuf *tmp_mbuf = mbuf;
 		while (tmp_mbuf) {
@@ -228,14 +395,11 @@ eth_af_packet_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			tmp_mbuf = tmp_mbuf->next;
 		}
 
-		ppd->tp_len = mbuf->pkt_len;
-		ppd->tp_snaplen = mbuf->pkt_len;
-
 		/* release incoming frame and advance ring buffer */
-		ppd->tp_status = TP_STATUS_SEND_REQUEST;
+		tx_frame_send_request(pkt_q, ppd, mbuf->pkt_len);
 		if (++framenum >= framecount)
 			framenum = 0;
-		ppd = (struct tpacket2_hdr *) pkt_q->rd[framenum].iov_base;
+		ppd = pkt_q->rd[framenum].iov_base;
 
 		num_tx++;
 		num_tx_bytes += mbuf->pkt_len;
@@ -396,6 +560,7 @@ eth_dev_close(struct rte_eth_dev *dev)
 		munmap(internals->rx_queue[q].map,
 			2 * req->tp_block_size * req->tp_block_nr);
 		rte_free(internals->rx_queue[q].rd);
+		rte_free(internals->rx_queue[q].shinfo);
 		rte_free(internals->tx_queue[q].rd);
 	}
 	free(internals->if_name);
@@ -437,9 +602,10 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 	buf_size = rte_pktmbuf_data_room_size(pkt_q->mb_pool) -
 		RTE_PKTMBUF_HEADROOM;
 	data_size = internals->req.tp_frame_size;
-	data_size -= TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
+	data_size -= internals->tp_hdrlen - sizeof(struct sockaddr_ll);
 
-	if (data_size > buf_size) {
+	/* zero-copy mbufs only point into the TPACKET_V3 blocks */
+	if (pkt_q->shinfo == NULL && data_size > buf_size) {
 		PMD_LOG(ERR,
 			"%s: %d bytes will not fit in mbuf (%d bytes)",
 			dev->device->name, data_size, buf_size);
@@ -474,7 +640,7 @@ eth_dev_mtu_set(struct rte_eth_dev *dev, uint16_t mtu)
 	int ret;
 	int s;
 	unsigned int data_size = internals->req.tp_frame_size -
-				 TPACKET2_HDRLEN;
+				 internals->tp_hdrlen;
 
 	if (mtu > data_size)
 		return -EINVAL;
@@ -610,6 +776,9 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
                        unsigned int framesize,
                        unsigned int framecnt,
 		       unsigned int qdisc_bypass,
+		       unsigned int tpacket_v3,
+		       unsigned int blocktmo,
+		       unsigned int zerocopy,
                        struct pmd_internals **internals,
                        struct rte_eth_dev **eth_dev,
                        struct rte_kvargs *kvlist)
@@ -623,6 +792,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	unsigned k_idx;
 	struct sockaddr_ll sockaddr;
 	struct tpacket_req *req;
+	struct tpacket_req3 req3;
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
 	int rc, tpver, discard;
@@ -680,6 +850,21 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	req->tp_frame_size = framesize;
 	req->tp_frame_nr = framecnt;
 
+	if (tpacket_v3) {
+		(*internals)->tpver = TPACKET_V3;
+		(*internals)->tp_hdrlen = TPACKET3_HDRLEN;
+	} else {
+		(*internals)->tpver = TPACKET_V2;
+		(*internals)->tp_hdrlen = TPACKET2_HDRLEN;
+	}
+
+	/* the Tx ring of a TPACKET_V3 socket does not take block settings */
+	memset(&req3, 0, sizeof(req3));
+	req3.tp_block_size = blocksize;
+	req3.tp_block_nr = blockcnt;
+	req3.tp_frame_size = framesize;
+	req3.tp_frame_nr = framecnt;
+
 	ifnamelen = strlen(pair->value);
 	if (ifnamelen < sizeof(ifr.ifr_name)) {
 		memcpy(ifr.ifr_name, pair->value, ifnamelen);
@@ -728,7 +913,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		tpver = TPACKET_V2;
+		tpver = (*internals)->tpver;
 		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_VERSION,
 				&tpver, sizeof(tpver));
 		if (rc == -1) {
@@ -761,7 +946,15 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		RTE_SET_USED(qdisc_bypass);
 #endif
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING, req, sizeof(*req));
+		if (tpver == TPACKET_V3) {
+			req3.tp_retire_blk_tov = blocktmo;
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+					&req3, sizeof(req3));
+			req3.tp_retire_blk_tov = 0;
+		} else {
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+					req, sizeof(*req));
+		}
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
@@ -769,7 +962,12 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
+		if (tpver == TPACKET_V3)
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING,
+					&req3, sizeof(req3));
+		else
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING,
+					req, sizeof(*req));
 		if (rc == -1) {
 			PMD_LOG_ERRNO(ERR,
 				"%s: could not set PACKET_TX_RING on AF_PACKET "
@@ -796,17 +994,43 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		rx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
 		if (rx_queue->rd == NULL)
 			goto error;
-		for (i = 0; i < req->tp_frame_nr; ++i) {
-			rx_queue->rd[i].iov_base = rx_queue->map + (i * framesize);
-			rx_queue->rd[i].iov_len = req->tp_frame_size;
+		if (tpver == TPACKET_V3) {
+			rx_queue->blockcount = req->tp_block_nr;
+			for (i = 0; i < req->tp_block_nr; ++i) {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * blocksize);
+				rx_queue->rd[i].iov_len = req->tp_block_size;
+			}
+		} else {
+			for (i = 0; i < req->tp_frame_nr; ++i) {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * framesize);
+				rx_queue->rd[i].iov_len = req->tp_frame_size;
+			}
 		}
 		rx_queue->sockfd = qsockfd;
 
+		if (zerocopy) {
+			rx_queue->shinfo = rte_zmalloc_socket(name,
+				req->tp_block_nr * sizeof(*rx_queue->shinfo),
+				0, numa_node);
+			if (rx_queue->shinfo == NULL)
+				goto error;
+			for (i = 0; i < req->tp_block_nr; ++i) {
+				rx_queue->shinfo[i].free_cb =
+					eth_af_packet_block_free_cb;
+				rx_queue->shinfo[i].fcb_opaque =
+					rx_queue->rd[i].iov_base;
+			}
+		}
+
 		tx_queue = &((*internals)->tx_queue[q]);
+		tx_queue->tpver = tpver;
 		tx_queue->framecount = req->tp_frame_nr;
-		tx_queue->frame_data_size = req->tp_frame_size;
-		tx_queue->frame_data_size -= TPACKET2_HDRLEN -
+		tx_queue->frame_data_offset = (*internals)->tp_hdrlen -
 			sizeof(struct sockaddr_ll);
+		tx_queue->frame_data_size = req->tp_frame_size;
+		tx_queue->frame_data_size -= tx_queue->frame_data_offset;
 
 		tx_queue->map = rx_queue->map + req->tp_block_size * req->tp_block_nr;
 
@@ -875,6 +1099,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			       2 * req->tp_block_size * req->tp_block_nr);
 
 		rte_free((*internals)->rx_queue[q].rd);
+		rte_free((*internals)->rx_queue[q].shinfo);
 		rte_free((*internals)->tx_queue[q].rd);
 		if (((*internals)->rx_queue[q].sockfd >= 0) &&
 			((*internals)->rx_queue[q].sockfd != qsockfd))
@@ -899,18 +1124,19 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	struct rte_kvargs_pair *pair = NULL;
 	unsigned k_idx;
 	unsigned int blockcount;
-	unsigned int blocksize;
+	unsigned int blocksize = 0;
 	unsigned int framesize = DFLT_FRAME_SIZE;
 	unsigned int framecount = DFLT_FRAME_COUNT;
 	unsigned int qpairs = 1;
 	unsigned int qdisc_bypass = 1;
+	unsigned int tpacket_v3 = 0;
+	unsigned int blocktmo = 0;
+	unsigned int zerocopy = 0;
 
 	/* do some parameter checking */
 	if (*sockfd < 0)
 		return -1;
 
-	blocksize = getpagesize();
-
 	/*
 	 * Walk arguments for configurable settings
 	 */
@@ -966,8 +1192,44 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 			}
 			continue;
 		}
+		if (strstr(pair->key, ETH_AF_PACKET_TPACKET_V3_ARG) != NULL) {
+			tpacket_v3 = atoi(pair->value);
+			if (tpacket_v3 > 1) {
+				PMD_LOG(ERR,
+					"%s: invalid tpacket_v3 value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_BLOCKTMO_ARG) != NULL) {
+			blocktmo = atoi(pair->value);
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_ZEROCOPY_ARG) != NULL) {
+			zerocopy = atoi(pair->value);
+			if (zerocopy > 1) {
+				PMD_LOG(ERR,
+					"%s: invalid zerocopy value",
+					name);
+				return -1;
+			}
+			continue;
+		}
 	}
 
+	if (zerocopy && !tpacket_v3) {
+		PMD_LOG(ERR,
+			"%s: zero-copy receive requires TPACKET_V3",
+			name);
+		return -1;
+	}
+
+	/* TPACKET_V3 blocks hold many packets, so default to larger blocks */
+	if (!blocksize)
+		blocksize = tpacket_v3 ? DFLT_V3_BLOCK_SIZE :
+			(unsigned int)getpagesize();
+
 	if (framesize > blocksize) {
 		PMD_LOG(ERR,
 			"%s: AF_PACKET MMAP frame size exceeds block size!",
@@ -987,16 +1249,24 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	PMD_LOG(INFO, "%s:\tblock count %d", name, blockcount);
 	PMD_LOG(INFO, "%s:\tframe size %d", name, framesize);
 	PMD_LOG(INFO, "%s:\tframe count %d", name, framecount);
+	if (tpacket_v3) {
+		PMD_LOG(INFO, "%s:\tTPACKET_V3 block timeout %u ms%s", name,
+			blocktmo, zerocopy ? ", zero-copy" : "");
+	}
 
 	if (rte_pmd_init_internals(dev, *sockfd, qpairs,
 				   blocksize, blockcount,
 				   framesize, framecount,
 				   qdisc_bypass,
+				   tpacket_v3, blocktmo, zerocopy,
 				   &internals, &eth_dev,
 				   kvlist) < 0)
 		return -1;
 
-	eth_dev->rx_pkt_burst = eth_af_packet_rx;
+	if (tpacket_v3)
+		eth_dev->rx_pkt_burst = eth_af_packet_rx_v3;
+	else
+		eth_dev->rx_pkt_burst = eth_af_packet_rx;
 	eth_dev->tx_pkt_burst = eth_af_packet_tx;
 
 	rte_eth_dev_probing_finish(eth_dev);
@@ -1088,4 +1358,7 @@ RTE_PMD_REGISTER_PARAM_STRING(net_af_packet,
 	"blocksz=<int> "
 	"framesz=<int> "
 	"framecnt=<int> "
-	"qdisc_bypass=<0|1>");
+	"qdisc_bypass=<0|1> "
+	"tpacket_v3=<0|1> "
+	"blocktmo=<int> "
+	"zerocopy=<0|1>");
@@ -29,6 +29,7 @@ i40e_rxq_rearm(struct i40e_rx_queue *rxq)
 	struct i40e_rx_entry *rxep = &rxq->sw_ring[rxq->rxrearm_start];
 	struct rte_mempool_cache *cache = rte_mempool_default_cache(rxq->mp,
 			rte_lcore_id());
+	void **cache_objs;
 
 	rxdp = rxq->rx_ring + rxq->rxrearm_start;
 
@@ -36,39 +37,27 @@ i40e_rxq_rearm(struct i40e_rx_queue *rxq)
 		return i40e_rxq_rearm_common(rxq, true);
 
 	/* We need to pull 'n' more MBUFs into the software ring from mempool
-	 * We inline the mempool function here, so we can vectorize the copy
+	 * We peek at them in the mempool cache, so we can vectorize the copy
 	 * from the cache into the shadow ring.
 	 */
-
-	if (cache->len < RTE_I40E_RXQ_REARM_THRESH) {
-		/* No. Backfill the cache first, and then fill from it */
-		uint32_t req = RTE_I40E_RXQ_REARM_THRESH + (cache->size -
-				cache->len);
-
-		/* How many do we require
-		 * i.e. number to fill the cache + the request
-		 */
-		int ret = rte_mempool_ops_dequeue_bulk(rxq->mp,
-				&cache->objs[cache->len], req);
-		if (ret == 0) {
-			cache->len += req;
-		} else {
-			if (rxq->rxrearm_nb + RTE_I40E_RXQ_REARM_THRESH >=
-					rxq->nb_rx_desc) {
-				__m128i dma_addr0;
-
-				dma_addr0 = _mm_setzero_si128();
-				for (i = 0; i < RTE_I40E_DESCS_PER_LOOP; i++) {
-					rxep[i].mbuf = &rxq->fake_mbuf;
-					_mm_store_si128
-						((__m128i *)&rxdp[i].read,
-							dma_addr0);
-				}
+	cache_objs = rte_mempool_cache_zc_get_peek(cache, rxq->mp,
+			RTE_I40E_RXQ_REARM_THRESH);
+	if (unlikely(cache_objs == NULL)) {
+		if (rxq->rxrearm_nb + RTE_I40E_RXQ_REARM_THRESH >=
+				rxq->nb_rx_desc) {
+			__m128i dma_addr0;
+
+			dma_addr0 = _mm_setzero_si128();
+			for (i = 0; i < RTE_I40E_DESCS_PER_LOOP; i++) {
+				rxep[i].mbuf = &rxq->fake_mbuf;
+				_mm_store_si128
+					((__m128i *)&rxdp[i].read,
+						dma_addr0);
 			}
-			rte_eth_devices[rxq->port_id].data->rx_mbuf_alloc_failed +=
-					RTE_I40E_RXQ_REARM_THRESH;
-			return;
 		}
+		rte_eth_devices[rxq->port_id].data->rx_mbuf_alloc_failed +=
+				RTE_I40E_RXQ_REARM_THRESH;
+		return;
 	}
 
 	const __m512i iova_offsets =  _mm512_set1_epi64
@@ -89,7 +78,7 @@ i40e_rxq_rearm(struct i40e_rx_queue *rxq)
 	 */
 	for (i = 0; i < RTE_I40E_RXQ_REARM_THRESH / 8; i++) {
 		const __m512i mbuf_ptrs = _mm512_loadu_si512
-			(&cache->objs[cache->len - 8]);
+			(&cache_objs[RTE_I40E_RXQ_REARM_THRESH - 8 * (i + 1)]);
 		_mm512_store_si512(rxep, mbuf_ptrs);
 
 		/* gather iova of mbuf0-7 into one zmm reg */
@@ -133,8 +122,10 @@ i40e_rxq_rearm(struct i40e_rx_queue *rxq)
 		_mm512_store_si512((void *)rxdp, desc_rd_0_3);
 		_mm512_store_si512((void *)(rxdp + 4), desc_rd_4_7);
 #endif
-		rxep += 8, rxdp += 8, cache->len -= 8;
+		rxep += 8, rxdp += 8;
 	}
+	rte_mempool_cache_zc_get_consume(cache, rxq->mp,
+			RTE_I40E_RXQ_REARM_THRESH);
 
 	rxq->rxrearm_start += RTE_I40E_RXQ_REARM_THRESH;
 	if (rxq->rxrearm_start >= rxq->nb_rx_desc)
@@ -908,19 +899,13 @@ i40e_tx_free_bufs_avx512(struct i40e_tx_queue *txq)
 		if (!cache || cache->len == 0)
 			goto normal;
 
-		cache_objs = &cache->objs[cache->len];
-
-		if (n > RTE_MEMPOOL_CACHE_MAX_SIZE) {
+		cache_objs = rte_mempool_cache_zc_put_reserve(cache, mp, n);
+		if (cache_objs == NULL) {
 			rte_mempool_ops_enqueue_bulk(mp, (void *)txep, n);
 			goto done;
 		}
 
-		/* The cache follows the following algorithm
-		 *   1. Add the objects to the cache
-		 *   2. Anything greater than the cache min value (if it
-		 *   crosses the cache flush threshold) is flushed to the ring.
-		 */
-		/* Add elements back into the cache */
+		/* Store the elements straight into the cache */
 		uint32_t copied = 0;
 		/* n is multiple of 32 */
 		while (copied < n) {
@@ -935,14 +920,7 @@ i40e_tx_free_bufs_avx512(struct i40e_tx_queue *txq)
 			_mm512_storeu_si512(&cache_objs[copied + 24], d);
 			copied += 32;
 		}
-		cache->len += n;
-
-		if (cache->len >= cache->flushthresh) {
-			rte_mempool_ops_enqueue_bulk
-				(mp, &cache->objs[cache->size],
-				cache->len - cache->size);
-			cache->len = cache->size;
-		}
+		rte_mempool_cache_zc_put_commit(cache, mp, n);
 		goto done;
 	}
 
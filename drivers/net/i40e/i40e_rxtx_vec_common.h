@@ -99,6 +99,32 @@ i40e_tx_free_bufs(struct i40e_tx_queue *txq)
 	  * tx_next_dd - (tx_rs_thresh-1)
 	  */
 	txep = &txq->sw_ring[txq->tx_next_dd - (n - 1)];
+
+	if (txq->offloads & DEV_TX_OFFLOAD_MBUF_FAST_FREE) {
+		/*
+		 * All the mbufs are direct with a refcnt of 1 and come from
+		 * the same mempool: store them straight into its cache.
+		 */
+		struct rte_mempool *mp = txep[0].mbuf->pool;
+		struct rte_mempool_cache *cache;
+		void **cache_objs = NULL;
+
+		cache = rte_mempool_default_cache(mp, rte_lcore_id());
+		if (cache != NULL)
+			cache_objs = rte_mempool_cache_zc_put_reserve(cache,
+					mp, n);
+		if (cache_objs != NULL) {
+			for (i = 0; i < n; i++)
+				cache_objs[i] = txep[i].mbuf;
+			rte_mempool_cache_zc_put_commit(cache, mp, n);
+		} else {
+			for (i = 0; i < n; i++)
+				free[i] = txep[i].mbuf;
+			rte_mempool_put_bulk(mp, (void **)free, n);
+		}
+		goto done;
+	}
+
 	m = rte_pktmbuf_prefree_seg(txep[0].mbuf);
 	if (likely(m != NULL)) {
 		free[0] = m;
@@ -126,6 +152,7 @@ i40e_tx_free_bufs(struct i40e_tx_queue *txq)
 		}
 	}
 
+done:
 	/* buffers were freed, update counters */
 	txq->nb_tx_free = (uint16_t)(txq->nb_tx_free + txq->tx_rs_thresh);
 	txq->tx_next_dd = (uint16_t)(txq->tx_next_dd + txq->tx_rs_thresh);
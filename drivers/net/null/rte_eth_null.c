@@ -79,6 +79,34 @@ RTE_LOG_REGISTER_DEFAULT(eth_null_logtype, NOTICE);
 	rte_log(RTE_LOG_ ## level, eth_null_logtype, \
 		"%s(): " fmt "\n", __func__, ##args)
 
+/*
+ * Allocate mbufs straight from the mempool cache, instead of copying them
+ * to the array first with rte_pktmbuf_alloc_bulk().
+ */
+static inline int
+eth_null_alloc_bulk(struct rte_mempool *mp, struct rte_mbuf **bufs,
+		uint16_t nb_bufs)
+{
+	struct rte_mempool_cache *cache;
+	void **objs = NULL;
+	uint16_t i;
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	if (cache != NULL)
+		objs = rte_mempool_cache_zc_get_peek(cache, mp, nb_bufs);
+	if (objs == NULL)
+		return rte_pktmbuf_alloc_bulk(mp, bufs, nb_bufs);
+
+	for (i = 0; i < nb_bufs; i++) {
+		bufs[i] = objs[i];
+		__rte_mbuf_raw_sanity_check(bufs[i]);
+		rte_pktmbuf_reset(bufs[i]);
+	}
+	rte_mempool_cache_zc_get_consume(cache, mp, nb_bufs);
+
+	return 0;
+}
+
 static uint16_t
 eth_null_rx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 {
@@ -90,7 +118,7 @@ eth_null_rx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 		return 0;
 
 	packet_size = h->internals->packet_size;
-	if (rte_pktmbuf_alloc_bulk(h->mb_pool, bufs, nb_bufs) != 0)
+	if (eth_null_alloc_bulk(h->mb_pool, bufs, nb_bufs) != 0)
 		return 0;
 
 	for (i = 0; i < nb_bufs; i++) {
@@ -115,7 +143,7 @@ eth_null_copy_rx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 		return 0;
 
 	packet_size = h->internals->packet_size;
-	if (rte_pktmbuf_alloc_bulk(h->mb_pool, bufs, nb_bufs) != 0)
+	if (eth_null_alloc_bulk(h->mb_pool, bufs, nb_bufs) != 0)
 		return 0;
 
 	for (i = 0; i < nb_bufs; i++) {
@@ -141,18 +169,16 @@ eth_null_no_rx(void *q __rte_unused, struct rte_mbuf **bufs __rte_unused,
 static uint16_t
 eth_null_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 {
-	int i;
 	struct null_queue *h = q;
 
 	if ((q == NULL) || (bufs == NULL))
 		return 0;
 
-	for (i = 0; i < nb_bufs; i++)
-		rte_pktmbuf_free(bufs[i]);
+	rte_pktmbuf_free_bulk(bufs, nb_bufs);
 
-	rte_atomic64_add(&(h->tx_pkts), i);
+	rte_atomic64_add(&(h->tx_pkts), nb_bufs);
 
-	return i;
+	return nb_bufs;
 }
 
 static uint16_t
@@ -166,11 +192,10 @@ eth_null_copy_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 		return 0;
 
 	packet_size = h->internals->packet_size;
-	for (i = 0; i < nb_bufs; i++) {
+	for (i = 0; i < nb_bufs; i++)
 		rte_memcpy(h->dummy_packet, rte_pktmbuf_mtod(bufs[i], void *),
 					packet_size);
-		rte_pktmbuf_free(bufs[i]);
-	}
+	rte_pktmbuf_free_bulk(bufs, nb_bufs);
 
 	rte_atomic64_add(&(h->tx_pkts), i);
 
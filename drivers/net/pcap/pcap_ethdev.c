@@ -4,7 +4,9 @@
  * All rights reserved.
  */
 
+#include <fcntl.h>
 #include <time.h>
+#include <unistd.h>
 
 #include <pcap.h>
 
@@ -17,6 +19,9 @@
 #include <rte_mbuf_dyn.h>
 #include <rte_bus_vdev.h>
 #include <rte_os_shim.h>
+#ifdef RTE_LIB_PCAPNG
+#include <rte_pcapng.h>
+#endif
 
 #include "pcap_osdep.h"
 
@@ -27,6 +32,7 @@
 
 #define ETH_PCAP_RX_PCAP_ARG  "rx_pcap"
 #define ETH_PCAP_TX_PCAP_ARG  "tx_pcap"
+#define ETH_PCAP_TX_PCAPNG_ARG "tx_pcapng"
 #define ETH_PCAP_RX_IFACE_ARG "rx_iface"
 #define ETH_PCAP_RX_IFACE_IN_ARG "rx_iface_in"
 #define ETH_PCAP_TX_IFACE_ARG "tx_iface"
@@ -36,6 +42,12 @@
 
 #define ETH_PCAP_ARG_MAXLEN	64
 
+#ifdef RTE_LIB_PCAPNG
+#define ETH_PCAP_TX_PCAPNG_PARAM ETH_PCAP_TX_PCAPNG_ARG "=<string> "
+#else
+#define ETH_PCAP_TX_PCAPNG_PARAM ""
+#endif
+
 #define RTE_PMD_PCAP_MAX_QUEUES 16
 
 static char errbuf[PCAP_ERRBUF_SIZE];
@@ -98,12 +110,18 @@ struct pmd_process_private {
 	pcap_t *rx_pcap[RTE_PMD_PCAP_MAX_QUEUES];
 	pcap_t *tx_pcap[RTE_PMD_PCAP_MAX_QUEUES];
 	pcap_dumper_t *tx_dumper[RTE_PMD_PCAP_MAX_QUEUES];
+#ifdef RTE_LIB_PCAPNG
+	rte_pcapng_t *tx_pcapng[RTE_PMD_PCAP_MAX_QUEUES];
+#endif
 };
 
 struct pmd_devargs {
 	unsigned int num_of_queue;
 	struct devargs_queue {
 		pcap_dumper_t *dumper;
+#ifdef RTE_LIB_PCAPNG
+		rte_pcapng_t *pcapng;
+#endif
 		pcap_t *pcap;
 		const char *name;
 		const char *type;
@@ -116,6 +134,7 @@ struct pmd_devargs_all {
 	struct pmd_devargs tx_queues;
 	int single_iface;
 	unsigned int is_tx_pcap;
+	unsigned int is_tx_pcapng;
 	unsigned int is_tx_iface;
 	unsigned int is_rx_pcap;
 	unsigned int is_rx_iface;
@@ -125,6 +144,9 @@ struct pmd_devargs_all {
 static const char *valid_arguments[] = {
 	ETH_PCAP_RX_PCAP_ARG,
 	ETH_PCAP_TX_PCAP_ARG,
+#ifdef RTE_LIB_PCAPNG
+	ETH_PCAP_TX_PCAPNG_ARG,
+#endif
 	ETH_PCAP_RX_IFACE_ARG,
 	ETH_PCAP_RX_IFACE_IN_ARG,
 	ETH_PCAP_TX_IFACE_ARG,
@@ -425,6 +447,43 @@ eth_pcap_tx_dumper(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return nb_pkts;
 }
 
+#ifdef RTE_LIB_PCAPNG
+/*
+ * Callback to handle writing packets to a pcapng file.
+ * The whole burst is written with a single system call, from the mbufs.
+ */
+static uint16_t
+eth_pcap_tx_pcapng(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pmd_process_private *pp;
+	struct pcap_tx_queue *pcapng_q = queue;
+	rte_pcapng_t *pcapng;
+	uint32_t tx_bytes = 0;
+	unsigned int i;
+
+	pp = rte_eth_devices[pcapng_q->port_id].process_private;
+	pcapng = pp->tx_pcapng[pcapng_q->queue_id];
+
+	if (pcapng == NULL || nb_pkts == 0)
+		return 0;
+
+	for (i = 0; i < nb_pkts; i++)
+		tx_bytes += rte_pktmbuf_pkt_len(bufs[i]);
+
+	if (rte_pcapng_write_packets(pcapng, bufs, nb_pkts) < 0) {
+		PMD_LOG(ERR, "Failed to write to %s: %s", pcapng_q->name,
+			rte_strerror(rte_errno));
+		pcapng_q->tx_stat.err_pkts += nb_pkts;
+	} else {
+		pcapng_q->tx_stat.pkts += nb_pkts;
+		pcapng_q->tx_stat.bytes += tx_bytes;
+	}
+	rte_pktmbuf_free_bulk(bufs, nb_pkts);
+
+	return nb_pkts;
+}
+#endif
+
 /*
  * Callback to handle dropping packets in the infinite rx case.
  */
@@ -561,6 +620,31 @@ open_single_tx_pcap(const char *pcap_filename, pcap_dumper_t **dumper)
 	return 0;
 }
 
+#ifdef RTE_LIB_PCAPNG
+static int
+open_single_tx_pcapng(const char *pcapng_filename, rte_pcapng_t **pcapng)
+{
+	int fd;
+
+	fd = open(pcapng_filename, O_WRONLY | O_CREAT | O_TRUNC, 0664);
+	if (fd < 0) {
+		PMD_LOG(ERR, "Couldn't open %s for writing: %s",
+			pcapng_filename, strerror(errno));
+		return -1;
+	}
+
+	*pcapng = rte_pcapng_fdopen(fd, NULL, NULL, NULL, NULL);
+	if (*pcapng == NULL) {
+		close(fd);
+		PMD_LOG(ERR, "Couldn't start pcapng file %s: %s",
+			pcapng_filename, rte_strerror(rte_errno));
+		return -1;
+	}
+
+	return 0;
+}
+#endif
+
 static int
 open_single_rx_pcap(const char *pcap_filename, pcap_t **pcap)
 {
@@ -625,6 +709,13 @@ eth_dev_start(struct rte_eth_dev *dev)
 			if (open_single_tx_pcap(tx->name,
 				&pp->tx_dumper[i]) < 0)
 				return -1;
+#ifdef RTE_LIB_PCAPNG
+		} else if (!pp->tx_pcapng[i] &&
+				strcmp(tx->type, ETH_PCAP_TX_PCAPNG_ARG) == 0) {
+			if (open_single_tx_pcapng(tx->name,
+				&pp->tx_pcapng[i]) < 0)
+				return -1;
+#endif
 		} else if (!pp->tx_pcap[i] &&
 				strcmp(tx->type, ETH_PCAP_TX_IFACE_ARG) == 0) {
 			if (open_single_iface(tx->name, &pp->tx_pcap[i]) < 0)
@@ -689,6 +780,13 @@ eth_dev_stop(struct rte_eth_dev *dev)
 			pp->tx_dumper[i] = NULL;
 		}
 
+#ifdef RTE_LIB_PCAPNG
+		if (pp->tx_pcapng[i] != NULL) {
+			rte_pcapng_close(pp->tx_pcapng[i]);
+			pp->tx_pcapng[i] = NULL;
+		}
+#endif
+
 		if (pp->tx_pcap[i] != NULL) {
 			pcap_close(pp->tx_pcap[i]);
 			pp->tx_pcap[i] = NULL;
@@ -1062,6 +1160,31 @@ open_tx_pcap(const char *key, const char *value, void *extra_args)
 	return 0;
 }
 
+#ifdef RTE_LIB_PCAPNG
+/*
+ * Opens a pcapng file for writing and stores a reference to it
+ * for use it later on.
+ */
+static int
+open_tx_pcapng(const char *key, const char *value, void *extra_args)
+{
+	const char *pcapng_filename = value;
+	struct pmd_devargs *writers = extra_args;
+	rte_pcapng_t *pcapng;
+
+	if (open_single_tx_pcapng(pcapng_filename, &pcapng) < 0)
+		return -1;
+
+	if (add_queue(writers, pcapng_filename, key, NULL, NULL) < 0) {
+		rte_pcapng_close(pcapng);
+		return -1;
+	}
+	writers->queue[writers->num_of_queue - 1].pcapng = pcapng;
+
+	return 0;
+}
+#endif
+
 /*
  * Opens an interface for reading and writing
  */
@@ -1301,6 +1424,9 @@ eth_from_pcaps_common(struct rte_vdev_device *vdev,
 		struct devargs_queue *queue = &tx_queues->queue[i];
 
 		pp->tx_dumper[i] = queue->dumper;
+#ifdef RTE_LIB_PCAPNG
+		pp->tx_pcapng[i] = queue->pcapng;
+#endif
 		pp->tx_pcap[i] = queue->pcap;
 		strlcpy(tx->name, queue->name, sizeof(tx->name));
 		strlcpy(tx->type, queue->type, sizeof(tx->type));
@@ -1353,6 +1479,10 @@ eth_from_pcaps(struct rte_vdev_device *vdev,
 	/* Assign tx ops. */
 	if (devargs_all->is_tx_pcap)
 		eth_dev->tx_pkt_burst = eth_pcap_tx_dumper;
+#ifdef RTE_LIB_PCAPNG
+	else if (devargs_all->is_tx_pcapng)
+		eth_dev->tx_pkt_burst = eth_pcap_tx_pcapng;
+#endif
 	else if (devargs_all->is_tx_iface || single_iface)
 		eth_dev->tx_pkt_burst = eth_pcap_tx;
 	else
@@ -1453,6 +1583,8 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 
 	devargs_all.is_tx_pcap =
 		rte_kvargs_count(kvlist, ETH_PCAP_TX_PCAP_ARG) ? 1 : 0;
+	devargs_all.is_tx_pcapng =
+		rte_kvargs_count(kvlist, ETH_PCAP_TX_PCAPNG_ARG) ? 1 : 0;
 	devargs_all.is_tx_iface =
 		rte_kvargs_count(kvlist, ETH_PCAP_TX_IFACE_ARG) ? 1 : 0;
 	dumpers.num_of_queue = 0;
@@ -1486,7 +1618,8 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 	} else if (devargs_all.is_rx_iface) {
 		ret = rte_kvargs_process(kvlist, NULL,
 				&rx_iface_args_process, &pcaps);
-	} else if (devargs_all.is_tx_iface || devargs_all.is_tx_pcap) {
+	} else if (devargs_all.is_tx_iface || devargs_all.is_tx_pcap ||
+			devargs_all.is_tx_pcapng) {
 		unsigned int i;
 
 		/* Count number of tx queue args passed before dummy rx queue
@@ -1494,6 +1627,7 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 		 */
 		unsigned int num_tx_queues =
 			(rte_kvargs_count(kvlist, ETH_PCAP_TX_PCAP_ARG) +
+			rte_kvargs_count(kvlist, ETH_PCAP_TX_PCAPNG_ARG) +
 			rte_kvargs_count(kvlist, ETH_PCAP_TX_IFACE_ARG));
 
 		PMD_LOG(INFO, "Creating null rx queue since no rx queues were provided.");
@@ -1516,6 +1650,11 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 	if (devargs_all.is_tx_pcap) {
 		ret = rte_kvargs_process(kvlist, ETH_PCAP_TX_PCAP_ARG,
 				&open_tx_pcap, &dumpers);
+#ifdef RTE_LIB_PCAPNG
+	} else if (devargs_all.is_tx_pcapng) {
+		ret = rte_kvargs_process(kvlist, ETH_PCAP_TX_PCAPNG_ARG,
+				&open_tx_pcapng, &dumpers);
+#endif
 	} else if (devargs_all.is_tx_iface) {
 		ret = rte_kvargs_process(kvlist, ETH_PCAP_TX_IFACE_ARG,
 				&open_tx_iface, &dumpers);
@@ -1560,6 +1699,9 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 
 		for (i = 0; i < dumpers.num_of_queue; i++) {
 			pp->tx_dumper[i] = dumpers.queue[i].dumper;
+#ifdef RTE_LIB_PCAPNG
+			pp->tx_pcapng[i] = dumpers.queue[i].pcapng;
+#endif
 			pp->tx_pcap[i] = dumpers.queue[i].pcap;
 		}
 
@@ -1567,6 +1709,10 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 		eth_dev->rx_pkt_burst = eth_pcap_rx;
 		if (devargs_all.is_tx_pcap)
 			eth_dev->tx_pkt_burst = eth_pcap_tx_dumper;
+#ifdef RTE_LIB_PCAPNG
+		else if (devargs_all.is_tx_pcapng)
+			eth_dev->tx_pkt_burst = eth_pcap_tx_pcapng;
+#endif
 		else
 			eth_dev->tx_pkt_burst = eth_pcap_tx;
 
@@ -1613,6 +1759,7 @@ RTE_PMD_REGISTER_ALIAS(net_pcap, eth_pcap);
 RTE_PMD_REGISTER_PARAM_STRING(net_pcap,
 	ETH_PCAP_RX_PCAP_ARG "=<string> "
 	ETH_PCAP_TX_PCAP_ARG "=<string> "
+	ETH_PCAP_TX_PCAPNG_PARAM
 	ETH_PCAP_RX_IFACE_ARG "=<ifc> "
 	ETH_PCAP_RX_IFACE_IN_ARG "=<ifc> "
 	ETH_PCAP_TX_IFACE_ARG "=<ifc> "
@@ -53,6 +53,7 @@
 #define ETH_TAP_IFACE_ARG       "iface"
 #define ETH_TAP_REMOTE_ARG      "remote"
 #define ETH_TAP_MAC_ARG         "mac"
+#define ETH_TAP_IO_URING_ARG    "io_uring"
 #define ETH_TAP_MAC_FIXED       "fixed"
 
 #define ETH_TAP_USR_MAC_FMT     "xx:xx:xx:xx:xx:xx"
@@ -80,6 +81,7 @@ static const char *valid_arguments[] = {
 	ETH_TAP_IFACE_ARG,
 	ETH_TAP_REMOTE_ARG,
 	ETH_TAP_MAC_ARG,
+	ETH_TAP_IO_URING_ARG,
 	NULL
 };
 
@@ -408,6 +410,298 @@ tap_rxq_pool_free(struct rte_mbuf *pool)
 	rte_pktmbuf_free(pool);
 }
 
+#ifdef HAVE_IO_URING
+
+/* Post the read of a packet into the mbuf of an idle Rx slot */
+static int
+tap_rx_uring_post(struct rx_queue *rxq, int fd)
+{
+	struct tap_uring_rx_slot *slot;
+	struct io_uring_sqe *sqe;
+	uint16_t idx;
+
+	if (rxq->uring_nb_idle == 0)
+		return -1;
+	sqe = tap_uring_sqe_get(&rxq->uring);
+	if (unlikely(sqe == NULL))
+		return -1;
+
+	idx = rxq->uring_idle[--rxq->uring_nb_idle];
+	slot = &rxq->uring_slots[idx];
+	tap_uring_sqe_prep_rw(sqe, IORING_OP_READV, fd,
+			      slot->iovecs, RTE_DIM(slot->iovecs), idx);
+	sqe->rw_flags = rxq->uring_rw_flags;
+	return 0;
+}
+
+/* Post the poll for input of an Rx queue, done while no read is posted */
+static void
+tap_rx_uring_poll(struct rx_queue *rxq, int fd)
+{
+	struct io_uring_sqe *sqe;
+
+	sqe = tap_uring_sqe_get(&rxq->uring);
+	if (unlikely(sqe == NULL))
+		return;
+
+	tap_uring_sqe_prep_poll(sqe, fd, TAP_URING_POLL_DATA);
+	rxq->uring_poll = 1;
+}
+
+static void
+tap_rx_uring_slot_set(struct tap_uring_rx_slot *slot, struct rte_mbuf *mbuf)
+{
+	slot->mbuf = mbuf;
+	slot->iovecs[0].iov_base = &slot->pi;
+	slot->iovecs[0].iov_len = sizeof(slot->pi);
+	slot->iovecs[1].iov_base = rte_pktmbuf_mtod(mbuf, void *);
+	slot->iovecs[1].iov_len = rte_pktmbuf_tailroom(mbuf);
+}
+
+/* Rx burst on the packets read through io_uring. The reads do not wait for
+ * a packet and fail with EAGAIN once the queue is empty: as many reads as
+ * packets got are kept posted, twice as many when none failed, up to the
+ * burst size, and a single poll for input is posted when no read is left.
+ */
+static uint16_t
+tap_rx_uring_burst(struct rx_queue *rxq, struct rte_mbuf **bufs,
+		   uint16_t nb_pkts)
+{
+	struct pmd_process_private *process_private;
+	struct io_uring_cqe *cqe;
+	uint16_t num_rx = 0;
+	unsigned long num_rx_bytes = 0;
+	uint32_t nb_read = 0;
+	uint32_t nb_empty = 0;
+	uint32_t nb_posted;
+	uint32_t nb_post;
+	int fd;
+
+	while (num_rx < nb_pkts) {
+		struct tap_uring_rx_slot *slot;
+		struct rte_mbuf *mbuf;
+		struct rte_mbuf *buf;
+		uint16_t idx;
+		int len;
+
+		cqe = tap_uring_cqe_peek(&rxq->uring);
+		if (cqe == NULL)
+			break;
+		if (cqe->user_data == TAP_URING_POLL_DATA) {
+			/* Input is available, as if a packet was read */
+			tap_uring_cqe_seen(&rxq->uring);
+			rxq->uring_poll = 0;
+			nb_read++;
+			continue;
+		}
+		idx = cqe->user_data;
+		len = cqe->res;
+		tap_uring_cqe_seen(&rxq->uring);
+
+		slot = &rxq->uring_slots[idx];
+		mbuf = slot->mbuf;
+		rxq->uring_idle[rxq->uring_nb_idle++] = idx;
+
+		if (len == -EAGAIN) {
+			nb_empty++;
+			continue;
+		}
+		/* Without RWF_NOWAIT support, the fd is non-blocking */
+		if (unlikely(len == -EOPNOTSUPP && rxq->uring_rw_flags != 0)) {
+			rxq->uring_rw_flags = 0;
+			nb_empty++;
+			continue;
+		}
+		nb_read++;
+
+		/* Packet couldn't fit in the provided mbuf, or read error */
+		if (unlikely(len < (int)sizeof(struct tun_pi) ||
+			     (slot->pi.flags & TUN_PKT_STRIP))) {
+			rxq->stats.ierrors++;
+			continue;
+		}
+
+		/* Drop the packet and read the next one in the same mbuf */
+		buf = rte_pktmbuf_alloc(rxq->mp);
+		if (unlikely(buf == NULL)) {
+			rxq->stats.rx_nombuf++;
+			continue;
+		}
+		tap_rx_uring_slot_set(slot, buf);
+
+		len -= sizeof(struct tun_pi);
+		mbuf->data_len = len;
+		mbuf->pkt_len = len;
+		mbuf->port = rxq->in_port;
+		mbuf->packet_type = rte_net_get_ptype(mbuf, NULL,
+						      RTE_PTYPE_ALL_MASK);
+		if (rxq->rxmode->offloads & DEV_RX_OFFLOAD_CHECKSUM)
+			tap_verify_csum(mbuf);
+
+		bufs[num_rx++] = mbuf;
+		num_rx_bytes += len;
+	}
+
+	process_private = rte_eth_devices[rxq->in_port].process_private;
+	fd = process_private->rxq_fds[rxq->queue_id];
+	nb_post = RTE_MIN(nb_empty == 0 ? 2 * nb_read : nb_read,
+			  (uint32_t)nb_pkts);
+	nb_posted = rxq->uring_nb_slots - rxq->uring_nb_idle;
+	while (nb_posted < nb_post && tap_rx_uring_post(rxq, fd) == 0)
+		nb_posted++;
+	if (nb_posted == 0 && !rxq->uring_poll)
+		tap_rx_uring_poll(rxq, fd);
+	/* The entries not submitted on failure are kept for the next burst */
+	tap_uring_submit(&rxq->uring);
+
+	rxq->stats.ipackets += num_rx;
+	rxq->stats.ibytes += num_rx_bytes;
+
+	return num_rx;
+}
+
+/* Set up the io_uring of an Rx queue and post its poll for input */
+static int
+tap_rx_uring_setup(struct rte_eth_dev *dev, struct rx_queue *rxq,
+		   uint16_t nb_rx_desc, unsigned int socket_id)
+{
+	uint32_t nb_slots = RTE_MIN(rte_align32pow2(RTE_MAX(nb_rx_desc, 1)),
+				    (uint32_t)TAP_URING_MAX_ENTRIES / 2);
+	struct pmd_process_private *process_private;
+	struct tap_uring_rx_slot *slots;
+	uint16_t *idle;
+	uint32_t i;
+	int ret;
+
+	slots = rte_zmalloc_socket(dev->device->name,
+				   nb_slots * sizeof(*slots),
+				   RTE_CACHE_LINE_SIZE, socket_id);
+	idle = rte_zmalloc_socket(dev->device->name,
+				  nb_slots * sizeof(*idle),
+				  RTE_CACHE_LINE_SIZE, socket_id);
+	if (slots == NULL || idle == NULL) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	for (i = 0; i < nb_slots; i++) {
+		struct rte_mbuf *mbuf = rte_pktmbuf_alloc(rxq->mp);
+
+		if (mbuf == NULL) {
+			ret = -ENOMEM;
+			goto error;
+		}
+		tap_rx_uring_slot_set(&slots[i], mbuf);
+		idle[i] = nb_slots - 1 - i;
+	}
+
+	/* A read for each slot and the poll */
+	ret = tap_uring_init(&rxq->uring, nb_slots + 1);
+	if (ret < 0)
+		goto error;
+
+	rxq->uring_slots = slots;
+	rxq->uring_idle = idle;
+	rxq->uring_nb_idle = nb_slots;
+	rxq->uring_nb_slots = nb_slots;
+	rxq->uring_poll = 0;
+	rxq->uring_rw_flags = RWF_NOWAIT;
+	process_private = rte_eth_devices[rxq->in_port].process_private;
+	tap_rx_uring_poll(rxq, process_private->rxq_fds[rxq->queue_id]);
+	ret = tap_uring_submit(&rxq->uring);
+	if (ret < 0) {
+		TAP_LOG(ERR, "%s: io_uring submission failed: %s",
+			dev->device->name, strerror(-ret));
+		rxq->uring_slots = NULL;
+		rxq->uring_idle = NULL;
+		rxq->uring_nb_idle = 0;
+		rxq->uring_nb_slots = 0;
+		goto error_uring;
+	}
+
+	return 0;
+
+error_uring:
+	tap_uring_free(&rxq->uring);
+error:
+	for (i = 0; slots != NULL && i < nb_slots; i++)
+		rte_pktmbuf_free(slots[i].mbuf);
+	rte_free(slots);
+	rte_free(idle);
+	return ret;
+}
+
+/* Wait for the reads in flight and release the io_uring of an Rx queue, the
+ * poll for input is canceled with it.
+ */
+static void
+tap_rx_uring_release(struct rx_queue *rxq)
+{
+	struct io_uring_cqe *cqe;
+	uint32_t inflight;
+	uint32_t i;
+
+	if (rxq->uring.fd == -1)
+		return;
+
+	inflight = rxq->uring_nb_slots - rxq->uring_nb_idle;
+	while (inflight) {
+		cqe = tap_uring_cqe_peek(&rxq->uring);
+		if (cqe == NULL) {
+			if (tap_uring_wait(&rxq->uring) < 0)
+				break;
+			continue;
+		}
+		if (cqe->user_data != TAP_URING_POLL_DATA)
+			inflight--;
+		tap_uring_cqe_seen(&rxq->uring);
+	}
+
+	tap_uring_free(&rxq->uring);
+
+	/* The kernel may still write into the mbufs of uncompleted reads */
+	if (inflight) {
+		TAP_LOG(ERR, "Rx queue %d: %u io_uring reads not completed",
+			rxq->queue_id, inflight);
+	} else {
+		for (i = 0; i < rxq->uring_nb_slots; i++)
+			rte_pktmbuf_free(rxq->uring_slots[i].mbuf);
+		rte_free(rxq->uring_slots);
+	}
+	rte_free(rxq->uring_idle);
+	rxq->uring_slots = NULL;
+	rxq->uring_idle = NULL;
+	rxq->uring_nb_idle = 0;
+	rxq->uring_nb_slots = 0;
+	rxq->uring_poll = 0;
+}
+
+#else /* HAVE_IO_URING */
+
+static uint16_t
+tap_rx_uring_burst(struct rx_queue *rxq __rte_unused,
+		   struct rte_mbuf **bufs __rte_unused,
+		   uint16_t nb_pkts __rte_unused)
+{
+	return 0;
+}
+
+static int
+tap_rx_uring_setup(struct rte_eth_dev *dev __rte_unused,
+		   struct rx_queue *rxq __rte_unused,
+		   uint16_t nb_rx_desc __rte_unused,
+		   unsigned int socket_id __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+static void
+tap_rx_uring_release(struct rx_queue *rxq __rte_unused)
+{
+}
+
+#endif /* HAVE_IO_URING */
+
 /* Callback to handle the rx burst of packets to the correct interface and
  * file descriptor(s) in a multi-queue setup.
  */
@@ -420,6 +714,9 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	unsigned long num_rx_bytes = 0;
 	uint32_t trigger = tap_trigger;
 
+	if (rxq->uring.fd != -1)
+		return tap_rx_uring_burst(rxq, bufs, nb_pkts);
+
 	if (trigger == rxq->trigger_seen)
 		return 0;
 
@@ -590,13 +887,328 @@ tap_tx_l3_cksum(char *packet, uint64_t ol_flags, unsigned int l2_len,
 	}
 }
 
+/* Tell whether the checksums of a packet are to be computed on Tx */
+static inline int
+tap_tx_is_cksum(struct tx_queue *txq, struct rte_mbuf *mbuf)
+{
+	return txq->csum &&
+		((mbuf->ol_flags & (PKT_TX_IP_CKSUM | PKT_TX_IPV4) ||
+		 (mbuf->ol_flags & PKT_TX_L4_MASK) == PKT_TX_UDP_CKSUM ||
+		 (mbuf->ol_flags & PKT_TX_L4_MASK) == PKT_TX_TCP_CKSUM));
+}
+
+/* Fill the iovecs to write a packet: packet info, copy of the headers in
+ * m_copy when checksums are computed, and the mbuf segments.
+ * Return the number of iovecs, -1 if the packet cannot be sent.
+ */
+static inline int
+tap_tx_iovecs_fill(struct tx_queue *txq, struct rte_mbuf *mbuf,
+		   struct iovec *iovecs, struct tun_pi *pi, char *m_copy)
+{
+	struct rte_mbuf *seg = mbuf;
+	int proto;
+	int j;
+	int k; /* current index in iovecs for copying segments */
+	uint16_t l234_hlen;
+	uint16_t seg_len; /* length of first segment */
+	uint16_t nb_segs;
+	uint16_t *l4_cksum; /* l4 checksum (pseudo header + payload) */
+	uint32_t l4_raw_cksum = 0; /* TCP/UDP payload raw checksum */
+	uint16_t l4_phdr_cksum = 0; /* TCP/UDP pseudo header checksum */
+	uint16_t is_cksum = 0; /* in case cksum should be offloaded */
+
+	l4_cksum = NULL;
+	pi->flags = 0;
+	pi->proto = 0x00;
+	if (txq->type == ETH_TUNTAP_TYPE_TUN) {
+		/*
+		 * TUN and TAP are created with IFF_NO_PI disabled.
+		 * For TUN PMD this mandatory as fields are used by
+		 * Kernel tun.c to determine whether its IP or non IP
+		 * packets.
+		 *
+		 * The logic fetches the first byte of data from mbuf
+		 * then compares whether its v4 or v6. If first byte
+		 * is 4 or 6, then protocol field is updated.
+		 */
+		char *buff_data = rte_pktmbuf_mtod(seg, void *);
+		proto = (*buff_data & 0xf0);
+		pi->proto = (proto == 0x40) ?
+			rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) :
+			((proto == 0x60) ?
+				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) :
+				0x00);
+	}
+
+	k = 0;
+	iovecs[k].iov_base = pi;
+	iovecs[k].iov_len = sizeof(*pi);
+	k++;
+
+	nb_segs = mbuf->nb_segs;
+	if (tap_tx_is_cksum(txq, mbuf)) {
+		is_cksum = 1;
+
+		/* Support only packets with at least layer 4
+		 * header included in the first segment
+		 */
+		seg_len = rte_pktmbuf_data_len(mbuf);
+		l234_hlen = mbuf->l2_len + mbuf->l3_len + mbuf->l4_len;
+		if (seg_len < l234_hlen)
+			return -1;
+
+		/* To change checksums, work on a * copy of l2, l3
+		 * headers + l4 pseudo header
+		 */
+		rte_memcpy(m_copy, rte_pktmbuf_mtod(mbuf, void *),
+				l234_hlen);
+		tap_tx_l3_cksum(m_copy, mbuf->ol_flags,
+			       mbuf->l2_len, mbuf->l3_len, mbuf->l4_len,
+			       &l4_cksum, &l4_phdr_cksum,
+			       &l4_raw_cksum);
+		iovecs[k].iov_base = m_copy;
+		iovecs[k].iov_len = l234_hlen;
+		k++;
+
+		/* Update next iovecs[] beyond l2, l3, l4 headers */
+		if (seg_len > l234_hlen) {
+			iovecs[k].iov_len = seg_len - l234_hlen;
+			iovecs[k].iov_base =
+				rte_pktmbuf_mtod(seg, char *) +
+					l234_hlen;
+			tap_tx_l4_add_rcksum(iovecs[k].iov_base,
+				iovecs[k].iov_len, l4_cksum,
+				&l4_raw_cksum);
+			k++;
+			nb_segs++;
+		}
+		seg = seg->next;
+	}
+
+	for (j = k; j <= nb_segs; j++) {
+		iovecs[j].iov_len = rte_pktmbuf_data_len(seg);
+		iovecs[j].iov_base = rte_pktmbuf_mtod(seg, void *);
+		if (is_cksum)
+			tap_tx_l4_add_rcksum(iovecs[j].iov_base,
+				iovecs[j].iov_len, l4_cksum,
+				&l4_raw_cksum);
+		seg = seg->next;
+	}
+
+	if (is_cksum)
+		tap_tx_l4_cksum(l4_cksum, l4_phdr_cksum, l4_raw_cksum);
+
+	return j;
+}
+
+#ifdef HAVE_IO_URING
+
+/* Release the mbufs of the completed writes */
+static void
+tap_tx_uring_reap(struct tx_queue *txq)
+{
+	struct io_uring_cqe *cqe;
+
+	while ((cqe = tap_uring_cqe_peek(&txq->uring)) != NULL) {
+		uint16_t idx = cqe->user_data;
+		struct rte_mbuf *mbuf = txq->uring_slots[idx].mbuf;
+
+		if (likely(cqe->res > 0)) {
+			txq->stats.opackets++;
+			txq->stats.obytes += rte_pktmbuf_pkt_len(mbuf);
+		} else {
+			txq->stats.errs++;
+		}
+		tap_uring_cqe_seen(&txq->uring);
+
+		rte_pktmbuf_free(mbuf);
+		txq->uring_free[txq->uring_nb_free++] = idx;
+	}
+}
+
+/* Tell whether a packet fits in a Tx slot */
+static inline int
+tap_tx_uring_fits(struct tx_queue *txq, struct rte_mbuf *mbuf)
+{
+	/* Packet info, headers copy and first segment remainder */
+	if (mbuf->nb_segs + 2 > TAP_URING_TX_IOV_MAX)
+		return 0;
+	if (tap_tx_is_cksum(txq, mbuf) &&
+	    mbuf->l2_len + mbuf->l3_len + mbuf->l4_len > TAP_URING_TX_HDR_MAX)
+		return 0;
+	return 1;
+}
+
+/* Post the write of a packet, the mbuf is referenced until it completes */
+static int
+tap_tx_uring_write(struct tx_queue *txq, struct rte_mbuf *mbuf)
+{
+	struct pmd_process_private *process_private;
+	struct tap_uring_tx_slot *slot;
+	struct io_uring_sqe *sqe;
+	uint16_t idx;
+	int n;
+
+	while (txq->uring_nb_free == 0) {
+		if (tap_uring_wait(&txq->uring) < 0)
+			return -1;
+		tap_tx_uring_reap(txq);
+	}
+
+	idx = txq->uring_free[txq->uring_nb_free - 1];
+	slot = &txq->uring_slots[idx];
+	n = tap_tx_iovecs_fill(txq, mbuf, slot->iovecs, &slot->pi, slot->hdr);
+	if (n < 0)
+		return -1;
+	sqe = tap_uring_sqe_get(&txq->uring);
+	if (unlikely(sqe == NULL))
+		return -1;
+	txq->uring_nb_free--;
+
+	process_private = rte_eth_devices[txq->out_port].process_private;
+	tap_uring_sqe_prep_rw(sqe, IORING_OP_WRITEV,
+			      process_private->txq_fds[txq->queue_id],
+			      slot->iovecs, n, idx);
+	/* Keep the packets order: the writes of a burst are linked, and the
+	 * first one waits for the writes of the previous bursts in flight.
+	 */
+	if (!tap_uring_sqe_link(&txq->uring) &&
+	    txq->uring_nb_free + 1 < txq->uring_nb_slots)
+		sqe->flags |= IOSQE_IO_DRAIN;
+	rte_pktmbuf_refcnt_update(mbuf, 1);
+	slot->mbuf = mbuf;
+
+	return 0;
+}
+
+/* Set up the io_uring of a Tx queue */
+static int
+tap_tx_uring_setup(struct rte_eth_dev *dev, struct tx_queue *txq,
+		   uint16_t nb_tx_desc, unsigned int socket_id)
+{
+	uint32_t nb_slots = RTE_MIN(rte_align32pow2(RTE_MAX(nb_tx_desc, 1)),
+				    (uint32_t)TAP_URING_MAX_ENTRIES);
+	uint32_t i;
+	int ret;
+
+	txq->uring_slots = rte_zmalloc_socket(dev->device->name,
+			nb_slots * sizeof(*txq->uring_slots),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	txq->uring_free = rte_zmalloc_socket(dev->device->name,
+			nb_slots * sizeof(*txq->uring_free),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (txq->uring_slots == NULL || txq->uring_free == NULL) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	ret = tap_uring_init(&txq->uring, nb_slots);
+	if (ret < 0)
+		goto error;
+
+	for (i = 0; i < nb_slots; i++)
+		txq->uring_free[i] = nb_slots - 1 - i;
+	txq->uring_nb_free = nb_slots;
+	txq->uring_nb_slots = nb_slots;
+
+	return 0;
+
+error:
+	rte_free(txq->uring_slots);
+	rte_free(txq->uring_free);
+	txq->uring_slots = NULL;
+	txq->uring_free = NULL;
+	return ret;
+}
+
+/* Submit the pending writes and wait for all the writes in flight */
+static int
+tap_tx_uring_drain(struct tx_queue *txq)
+{
+	tap_tx_uring_reap(txq);
+	while (txq->uring_nb_free != txq->uring_nb_slots) {
+		if (tap_uring_wait(&txq->uring) < 0)
+			return -1;
+		tap_tx_uring_reap(txq);
+	}
+	return 0;
+}
+
+/* Wait for the writes in flight and release the io_uring of a Tx queue */
+static void
+tap_tx_uring_release(struct tx_queue *txq)
+{
+	if (txq->uring.fd == -1)
+		return;
+
+	tap_tx_uring_drain(txq);
+
+	tap_uring_free(&txq->uring);
+
+	/* The kernel may still read the mbufs of uncompleted writes */
+	if (txq->uring_nb_free != txq->uring_nb_slots) {
+		TAP_LOG(ERR, "Tx queue %d: %u io_uring writes not completed",
+			txq->queue_id,
+			txq->uring_nb_slots - txq->uring_nb_free);
+	} else {
+		rte_free(txq->uring_slots);
+	}
+	rte_free(txq->uring_free);
+	txq->uring_slots = NULL;
+	txq->uring_free = NULL;
+	txq->uring_nb_free = 0;
+	txq->uring_nb_slots = 0;
+}
+
+#else /* HAVE_IO_URING */
+
+static void
+tap_tx_uring_reap(struct tx_queue *txq __rte_unused)
+{
+}
+
+static inline int
+tap_tx_uring_fits(struct tx_queue *txq __rte_unused,
+		  struct rte_mbuf *mbuf __rte_unused)
+{
+	return 0;
+}
+
+static int
+tap_tx_uring_write(struct tx_queue *txq __rte_unused,
+		   struct rte_mbuf *mbuf __rte_unused)
+{
+	return -1;
+}
+
+static int
+tap_tx_uring_drain(struct tx_queue *txq __rte_unused)
+{
+	return 0;
+}
+
+static int
+tap_tx_uring_setup(struct rte_eth_dev *dev __rte_unused,
+		   struct tx_queue *txq __rte_unused,
+		   uint16_t nb_tx_desc __rte_unused,
+		   unsigned int socket_id __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+static void
+tap_tx_uring_release(struct tx_queue *txq __rte_unused)
+{
+}
+
+#endif /* HAVE_IO_URING */
+
 static inline int
 tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 			struct rte_mbuf **pmbufs,
 			uint16_t *num_packets, unsigned long *num_tx_bytes)
 {
 	int i;
-	uint16_t l234_hlen;
 	struct pmd_process_private *process_private;
 
 	process_private = rte_eth_devices[txq->out_port].process_private;
@@ -604,101 +1216,27 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 	for (i = 0; i < num_mbufs; i++) {
 		struct rte_mbuf *mbuf = pmbufs[i];
 		struct iovec iovecs[mbuf->nb_segs + 2];
-		struct tun_pi pi = { .flags = 0, .proto = 0x00 };
-		struct rte_mbuf *seg = mbuf;
+		struct tun_pi pi;
 		char m_copy[mbuf->data_len];
-		int proto;
 		int n;
 		int j;
-		int k; /* current index in iovecs for copying segments */
-		uint16_t seg_len; /* length of first segment */
-		uint16_t nb_segs;
-		uint16_t *l4_cksum; /* l4 checksum (pseudo header + payload) */
-		uint32_t l4_raw_cksum = 0; /* TCP/UDP payload raw checksum */
-		uint16_t l4_phdr_cksum = 0; /* TCP/UDP pseudo header checksum */
-		uint16_t is_cksum = 0; /* in case cksum should be offloaded */
-
-		l4_cksum = NULL;
-		if (txq->type == ETH_TUNTAP_TYPE_TUN) {
-			/*
-			 * TUN and TAP are created with IFF_NO_PI disabled.
-			 * For TUN PMD this mandatory as fields are used by
-			 * Kernel tun.c to determine whether its IP or non IP
-			 * packets.
-			 *
-			 * The logic fetches the first byte of data from mbuf
-			 * then compares whether its v4 or v6. If first byte
-			 * is 4 or 6, then protocol field is updated.
-			 */
-			char *buff_data = rte_pktmbuf_mtod(seg, void *);
-			proto = (*buff_data & 0xf0);
-			pi.proto = (proto == 0x40) ?
-				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) :
-				((proto == 0x60) ?
-					rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) :
-					0x00);
-		}
-
-		k = 0;
-		iovecs[k].iov_base = &pi;
-		iovecs[k].iov_len = sizeof(pi);
-		k++;
-
-		nb_segs = mbuf->nb_segs;
-		if (txq->csum &&
-		    ((mbuf->ol_flags & (PKT_TX_IP_CKSUM | PKT_TX_IPV4) ||
-		     (mbuf->ol_flags & PKT_TX_L4_MASK) == PKT_TX_UDP_CKSUM ||
-		     (mbuf->ol_flags & PKT_TX_L4_MASK) == PKT_TX_TCP_CKSUM))) {
-			is_cksum = 1;
 
-			/* Support only packets with at least layer 4
-			 * header included in the first segment
+		if (txq->uring.fd != -1) {
+			if (tap_tx_uring_fits(txq, mbuf)) {
+				if (tap_tx_uring_write(txq, mbuf) < 0)
+					return -1;
+				continue;
+			}
+			/* Keep the packets order: the previous writes
+			 * complete before the one done below.
 			 */
-			seg_len = rte_pktmbuf_data_len(mbuf);
-			l234_hlen = mbuf->l2_len + mbuf->l3_len + mbuf->l4_len;
-			if (seg_len < l234_hlen)
+			if (tap_tx_uring_drain(txq) < 0)
 				return -1;
-
-			/* To change checksums, work on a * copy of l2, l3
-			 * headers + l4 pseudo header
-			 */
-			rte_memcpy(m_copy, rte_pktmbuf_mtod(mbuf, void *),
-					l234_hlen);
-			tap_tx_l3_cksum(m_copy, mbuf->ol_flags,
-				       mbuf->l2_len, mbuf->l3_len, mbuf->l4_len,
-				       &l4_cksum, &l4_phdr_cksum,
-				       &l4_raw_cksum);
-			iovecs[k].iov_base = m_copy;
-			iovecs[k].iov_len = l234_hlen;
-			k++;
-
-			/* Update next iovecs[] beyond l2, l3, l4 headers */
-			if (seg_len > l234_hlen) {
-				iovecs[k].iov_len = seg_len - l234_hlen;
-				iovecs[k].iov_base =
-					rte_pktmbuf_mtod(seg, char *) +
-						l234_hlen;
-				tap_tx_l4_add_rcksum(iovecs[k].iov_base,
-					iovecs[k].iov_len, l4_cksum,
-					&l4_raw_cksum);
-				k++;
-				nb_segs++;
-			}
-			seg = seg->next;
-		}
-
-		for (j = k; j <= nb_segs; j++) {
-			iovecs[j].iov_len = rte_pktmbuf_data_len(seg);
-			iovecs[j].iov_base = rte_pktmbuf_mtod(seg, void *);
-			if (is_cksum)
-				tap_tx_l4_add_rcksum(iovecs[j].iov_base,
-					iovecs[j].iov_len, l4_cksum,
-					&l4_raw_cksum);
-			seg = seg->next;
 		}
 
-		if (is_cksum)
-			tap_tx_l4_cksum(l4_cksum, l4_phdr_cksum, l4_raw_cksum);
+		j = tap_tx_iovecs_fill(txq, mbuf, iovecs, &pi, m_copy);
+		if (j < 0)
+			return -1;
 
 		/* copy the tx frame data */
 		n = writev(process_private->txq_fds[txq->queue_id], iovecs, j);
@@ -803,6 +1341,14 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			rte_pktmbuf_free_bulk(mbuf, num_tso_mbufs);
 	}
 
+	if (txq->uring.fd != -1) {
+		/* The writes not submitted on failure are kept for the next
+		 * burst, or the wait for a free slot.
+		 */
+		tap_uring_submit(&txq->uring);
+		tap_tx_uring_reap(txq);
+	}
+
 	txq->stats.opackets += num_packets;
 	txq->stats.errs += nb_pkts - num_tx;
 	txq->stats.obytes += num_tx_bytes;
@@ -1118,6 +1664,7 @@ tap_dev_close(struct rte_eth_dev *dev)
 	for (i = 0; i < RTE_PMD_TAP_MAX_QUEUES; i++) {
 		if (process_private->rxq_fds[i] != -1) {
 			rxq = &internals->rxq[i];
+			tap_rx_uring_release(rxq);
 			close(process_private->rxq_fds[i]);
 			process_private->rxq_fds[i] = -1;
 			tap_rxq_pool_free(rxq->pool);
@@ -1126,6 +1673,7 @@ tap_dev_close(struct rte_eth_dev *dev)
 			rxq->iovecs = NULL;
 		}
 		if (process_private->txq_fds[i] != -1) {
+			tap_tx_uring_release(&internals->txq[i]);
 			close(process_private->txq_fds[i]);
 			process_private->txq_fds[i] = -1;
 		}
@@ -1181,6 +1729,7 @@ tap_rx_queue_release(void *queue)
 		return;
 	process_private = rte_eth_devices[rxq->in_port].process_private;
 	if (process_private->rxq_fds[rxq->queue_id] != -1) {
+		tap_rx_uring_release(rxq);
 		close(process_private->rxq_fds[rxq->queue_id]);
 		process_private->rxq_fds[rxq->queue_id] = -1;
 		tap_rxq_pool_free(rxq->pool);
@@ -1201,6 +1750,7 @@ tap_tx_queue_release(void *queue)
 	process_private = rte_eth_devices[txq->out_port].process_private;
 
 	if (process_private->txq_fds[txq->queue_id] != -1) {
+		tap_tx_uring_release(txq);
 		close(process_private->txq_fds[txq->queue_id]);
 		process_private->txq_fds[txq->queue_id] = -1;
 	}
@@ -1572,6 +2122,21 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		goto error;
 	}
 
+	if (internals->io_uring &&
+	    !(rxq->rxmode->offloads & DEV_RX_OFFLOAD_SCATTER) &&
+	    !dev->data->dev_conf.intr_conf.rxq) {
+		ret = tap_rx_uring_setup(dev, rxq, nb_rx_desc, socket_id);
+		if (ret == 0) {
+			TAP_LOG(DEBUG, "  RX TUNTAP device name %s, qid %d on fd %d with io_uring",
+				internals->name, rx_queue_id, fd);
+			return 0;
+		}
+		TAP_LOG(WARNING,
+			"%s: io_uring not available for Rx queue %d (%s), using readv",
+			dev->device->name, rx_queue_id, strerror(-ret));
+		ret = 0;
+	}
+
 	(*rxq->iovecs)[0].iov_len = sizeof(struct tun_pi);
 	(*rxq->iovecs)[0].iov_base = &rxq->pi;
 
@@ -1608,8 +2173,8 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 static int
 tap_tx_queue_setup(struct rte_eth_dev *dev,
 		   uint16_t tx_queue_id,
-		   uint16_t nb_tx_desc __rte_unused,
-		   unsigned int socket_id __rte_unused,
+		   uint16_t nb_tx_desc,
+		   unsigned int socket_id,
 		   const struct rte_eth_txconf *tx_conf)
 {
 	struct pmd_internals *internals = dev->data->dev_private;
@@ -1634,6 +2199,14 @@ tap_tx_queue_setup(struct rte_eth_dev *dev,
 	ret = tap_setup_queue(dev, internals, tx_queue_id, 0);
 	if (ret == -1)
 		return -1;
+	if (internals->io_uring) {
+		ret = tap_tx_uring_setup(dev, txq, nb_tx_desc, socket_id);
+		if (ret < 0)
+			TAP_LOG(WARNING,
+				"%s: io_uring not available for Tx queue %d (%s), using writev",
+				dev->device->name, tx_queue_id,
+				strerror(-ret));
+	}
 	TAP_LOG(DEBUG,
 		"  TX TUNTAP device name %s, qid %d on fd %d csum %s",
 		internals->name, tx_queue_id,
@@ -1899,7 +2472,7 @@ static const struct eth_dev_ops ops = {
 static int
 eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 		   char *remote_iface, struct rte_ether_addr *mac_addr,
-		   enum rte_tuntap_type type)
+		   enum rte_tuntap_type type, int io_uring)
 {
 	int numa_node = rte_socket_id();
 	struct rte_eth_dev *dev;
@@ -1932,6 +2505,7 @@ eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 	pmd->dev = dev;
 	strlcpy(pmd->name, tap_name, sizeof(pmd->name));
 	pmd->type = type;
+	pmd->io_uring = io_uring;
 	pmd->ka_fd = -1;
 	pmd->nlsk_fd = -1;
 	pmd->gso_ctx_mp = NULL;
@@ -1969,6 +2543,8 @@ eth_dev_tap_create(struct rte_vdev_device *vdev, const char *tap_name,
 	for (i = 0; i < RTE_PMD_TAP_MAX_QUEUES; i++) {
 		process_private->rxq_fds[i] = -1;
 		process_private->txq_fds[i] = -1;
+		pmd->rxq[i].uring.fd = -1;
+		pmd->txq[i].uring.fd = -1;
 	}
 
 	if (pmd->type == ETH_TUNTAP_TYPE_TAP) {
@@ -2236,6 +2812,25 @@ set_mac_type(const char *key __rte_unused,
 	return -1;
 }
 
+static int
+set_io_uring(const char *key __rte_unused,
+	     const char *value,
+	     void *extra_args)
+{
+	int *io_uring = extra_args;
+
+	if (!value)
+		return 0;
+
+	if (strcmp(value, "0") && strcmp(value, "1")) {
+		TAP_LOG(ERR, "TAP io_uring param (%s) is not 0 or 1", value);
+		return -1;
+	}
+	*io_uring = value[0] == '1';
+	TAP_LOG(DEBUG, "TAP io_uring param (%s)", value);
+	return 0;
+}
+
 /*
  * Open a TUN interface device. TUN PMD
  * 1) sets tap_type as false
@@ -2251,6 +2846,7 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 	char tun_name[RTE_ETH_NAME_MAX_LEN];
 	char remote_iface[RTE_ETH_NAME_MAX_LEN];
 	struct rte_eth_dev *eth_dev;
+	int io_uring = 0;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -2286,6 +2882,16 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 				if (ret == -1)
 					goto leave;
 			}
+
+			if (rte_kvargs_count(kvlist, ETH_TAP_IO_URING_ARG) == 1) {
+				ret = rte_kvargs_process(kvlist,
+					ETH_TAP_IO_URING_ARG,
+					&set_io_uring,
+					&io_uring);
+
+				if (ret == -1)
+					goto leave;
+			}
 		}
 	}
 	pmd_link.link_speed = ETH_SPEED_NUM_10G;
@@ -2293,7 +2899,7 @@ rte_pmd_tun_probe(struct rte_vdev_device *dev)
 	TAP_LOG(DEBUG, "Initializing pmd_tun for %s", name);
 
 	ret = eth_dev_tap_create(dev, tun_name, remote_iface, 0,
-				 ETH_TUNTAP_TYPE_TUN);
+				 ETH_TUNTAP_TYPE_TUN, io_uring);
 
 leave:
 	if (ret == -1) {
@@ -2426,6 +3032,7 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	struct rte_ether_addr user_mac = { .addr_bytes = {0} };
 	struct rte_eth_dev *eth_dev;
 	int tap_devices_count_increased = 0;
+	int io_uring = 0;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -2440,6 +3047,13 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 		eth_dev->device = &dev->device;
 		eth_dev->rx_pkt_burst = pmd_rx_burst;
 		eth_dev->tx_pkt_burst = pmd_tx_burst;
+		if (((struct pmd_internals *)
+		     eth_dev->data->dev_private)->io_uring) {
+			/* The io_uring instances are private to the primary */
+			TAP_LOG(ERR, "%s: io_uring is not supported in secondary processes",
+				name);
+			return -1;
+		}
 		if (!rte_eal_primary_proc_alive(NULL)) {
 			TAP_LOG(ERR, "Primary process is missing");
 			return -1;
@@ -2499,6 +3113,15 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 				if (ret == -1)
 					goto leave;
 			}
+
+			if (rte_kvargs_count(kvlist, ETH_TAP_IO_URING_ARG) == 1) {
+				ret = rte_kvargs_process(kvlist,
+							 ETH_TAP_IO_URING_ARG,
+							 &set_io_uring,
+							 &io_uring);
+				if (ret == -1)
+					goto leave;
+			}
 		}
 	}
 	pmd_link.link_speed = speed;
@@ -2517,7 +3140,7 @@ rte_pmd_tap_probe(struct rte_vdev_device *dev)
 	tap_devices_count++;
 	tap_devices_count_increased = 1;
 	ret = eth_dev_tap_create(dev, tap_name, remote_iface, &user_mac,
-		ETH_TUNTAP_TYPE_TAP);
+		ETH_TUNTAP_TYPE_TAP, io_uring);
 
 leave:
 	if (ret == -1) {
@@ -2566,9 +3189,11 @@ RTE_PMD_REGISTER_VDEV(net_tap, pmd_tap_drv);
 RTE_PMD_REGISTER_VDEV(net_tun, pmd_tun_drv);
 RTE_PMD_REGISTER_ALIAS(net_tap, eth_tap);
 RTE_PMD_REGISTER_PARAM_STRING(net_tun,
-			      ETH_TAP_IFACE_ARG "=<string> ");
+			      ETH_TAP_IFACE_ARG "=<string> "
+			      ETH_TAP_IO_URING_ARG "=<0|1>");
 RTE_PMD_REGISTER_PARAM_STRING(net_tap,
 			      ETH_TAP_IFACE_ARG "=<string> "
 			      ETH_TAP_MAC_ARG "=" ETH_TAP_MAC_ARG_FMT " "
-			      ETH_TAP_REMOTE_ARG "=<string>");
+			      ETH_TAP_REMOTE_ARG "=<string> "
+			      ETH_TAP_IO_URING_ARG "=<0|1>");
 RTE_LOG_REGISTER_DEFAULT(tap_logtype, NOTICE);
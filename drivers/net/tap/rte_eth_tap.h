@@ -17,6 +17,7 @@
 #include <rte_ether.h>
 #include <rte_gso.h>
 #include "tap_log.h"
+#include "tap_uring.h"
 
 #ifdef IFF_MULTI_QUEUE
 #define RTE_PMD_TAP_MAX_QUEUES	TAP_MAX_QUEUES
@@ -53,6 +54,13 @@ struct rx_queue {
 	struct rte_mbuf *pool;          /* mbufs pool for this queue */
 	struct iovec (*iovecs)[];       /* descriptors for this queue */
 	struct tun_pi pi;               /* packet info for iovecs */
+	struct tap_uring uring;         /* io_uring, fd is -1 if not in use */
+	struct tap_uring_rx_slot *uring_slots; /* Buffers of io_uring reads */
+	uint16_t *uring_idle;           /* Stack of slots with no read posted */
+	uint16_t uring_nb_idle;         /* Number of slots with no read posted */
+	uint16_t uring_nb_slots;        /* Total number of slots */
+	uint16_t uring_poll;            /* 1 when the poll for input is posted */
+	uint32_t uring_rw_flags;        /* Flags of the reads, RWF_NOWAIT */
 };
 
 struct tx_queue {
@@ -63,6 +71,11 @@ struct tx_queue {
 	struct rte_gso_ctx gso_ctx;     /* GSO context */
 	uint16_t out_port;              /* Port ID */
 	uint16_t queue_id;		/* queue ID*/
+	struct tap_uring uring;         /* io_uring, fd is -1 if not in use */
+	struct tap_uring_tx_slot *uring_slots; /* Writes posted to io_uring */
+	uint16_t *uring_free;           /* Stack of free slot indexes */
+	uint16_t uring_nb_free;         /* Number of free slots */
+	uint16_t uring_nb_slots;        /* Total number of slots */
 };
 
 struct pmd_internals {
@@ -92,6 +105,7 @@ struct pmd_internals {
 	struct rte_intr_handle intr_handle;          /* LSC interrupt handle. */
 	int ka_fd;                        /* keep-alive file descriptor */
 	struct rte_mempool *gso_ctx_mp;     /* Mempool for GSO packets */
+	int io_uring;                     /* 1 to use io_uring on the queues */
 };
 
 struct pmd_process_private {
@@ -0,0 +1,230 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+/**
+ * @file
+ * io_uring setup for the tap driver queues.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "tap_log.h"
+#include "tap_uring.h"
+
+#ifdef HAVE_IO_URING
+
+/**
+ * Create an io_uring instance and map its rings.
+ *
+ * @param uring
+ *   io_uring instance to initialize.
+ * @param entries
+ *   Number of submission queue entries, rounded up to a power of 2 by the
+ *   kernel. The completion queue has twice as many entries.
+ *
+ * @return
+ *   0 on success, negative errno value otherwise.
+ */
+int
+tap_uring_init(struct tap_uring *uring, uint32_t entries)
+{
+	struct io_uring_params params;
+	uint32_t *sq_array;
+	uint32_t i;
+	int ret;
+
+	memset(uring, 0, sizeof(*uring));
+	memset(&params, 0, sizeof(params));
+
+	uring->fd = syscall(__NR_io_uring_setup, entries, &params);
+	if (uring->fd < 0) {
+		ret = -errno;
+		TAP_LOG(DEBUG, "io_uring_setup failed: %s", strerror(errno));
+		uring->fd = -1;
+		return ret;
+	}
+
+	uring->sq_ring_size = params.sq_off.array +
+		params.sq_entries * sizeof(uint32_t);
+	uring->cq_ring_size = params.cq_off.cqes +
+		params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		uring->sq_ring_size = uring->cq_ring_size =
+			RTE_MAX(uring->sq_ring_size, uring->cq_ring_size);
+	uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+	uring->sq_ring = mmap(NULL, uring->sq_ring_size,
+			      PROT_READ | PROT_WRITE,
+			      MAP_SHARED | MAP_POPULATE,
+			      uring->fd, IORING_OFF_SQ_RING);
+	if (uring->sq_ring == MAP_FAILED)
+		goto error;
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		uring->cq_ring = uring->sq_ring;
+	} else {
+		uring->cq_ring = mmap(NULL, uring->cq_ring_size,
+				      PROT_READ | PROT_WRITE,
+				      MAP_SHARED | MAP_POPULATE,
+				      uring->fd, IORING_OFF_CQ_RING);
+		if (uring->cq_ring == MAP_FAILED)
+			goto error;
+	}
+
+	uring->sqes = mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE,
+			   MAP_SHARED | MAP_POPULATE,
+			   uring->fd, IORING_OFF_SQES);
+	if (uring->sqes == MAP_FAILED)
+		goto error;
+
+	uring->sq_entries = params.sq_entries;
+	uring->sq_mask = *(uint32_t *)((char *)uring->sq_ring +
+				       params.sq_off.ring_mask);
+	uring->sq_khead = (uint32_t *)((char *)uring->sq_ring +
+				       params.sq_off.head);
+	uring->sq_ktail = (uint32_t *)((char *)uring->sq_ring +
+				       params.sq_off.tail);
+	uring->sq_tail = *uring->sq_ktail;
+	uring->sq_submitted = uring->sq_tail;
+
+	/* Submission entries are always used in ring order */
+	sq_array = (uint32_t *)((char *)uring->sq_ring + params.sq_off.array);
+	for (i = 0; i < params.sq_entries; i++)
+		sq_array[i] = i;
+
+	uring->cq_mask = *(uint32_t *)((char *)uring->cq_ring +
+				       params.cq_off.ring_mask);
+	uring->cq_khead = (uint32_t *)((char *)uring->cq_ring +
+				       params.cq_off.head);
+	uring->cq_ktail = (uint32_t *)((char *)uring->cq_ring +
+				       params.cq_off.tail);
+	uring->cqes = (char *)uring->cq_ring + params.cq_off.cqes;
+
+	return 0;
+
+error:
+	ret = -errno;
+	TAP_LOG(ERR, "io_uring mmap failed: %s", strerror(errno));
+	tap_uring_free(uring);
+	return ret;
+}
+
+/**
+ * Release an io_uring instance, the operations in flight are canceled.
+ *
+ * @param uring
+ *   io_uring instance, can be unused.
+ */
+void
+tap_uring_free(struct tap_uring *uring)
+{
+	if (uring->sqes != NULL && uring->sqes != MAP_FAILED)
+		munmap(uring->sqes, uring->sqes_size);
+	if (uring->cq_ring != NULL && uring->cq_ring != MAP_FAILED &&
+	    uring->cq_ring != uring->sq_ring)
+		munmap(uring->cq_ring, uring->cq_ring_size);
+	if (uring->sq_ring != NULL && uring->sq_ring != MAP_FAILED)
+		munmap(uring->sq_ring, uring->sq_ring_size);
+	if (uring->fd >= 0)
+		close(uring->fd);
+
+	memset(uring, 0, sizeof(*uring));
+	uring->fd = -1;
+}
+
+static int
+tap_uring_enter(struct tap_uring *uring, uint32_t min_complete,
+		uint32_t flags)
+{
+	uint32_t to_submit = uring->sq_tail - uring->sq_submitted;
+	int ret;
+
+	if (to_submit == 0 && min_complete == 0)
+		return 0;
+
+	__atomic_store_n(uring->sq_ktail, uring->sq_tail, __ATOMIC_RELEASE);
+	do {
+		ret = syscall(__NR_io_uring_enter, uring->fd, to_submit,
+			      min_complete, flags, NULL, 0);
+	} while (ret < 0 && errno == EINTR);
+	if (ret < 0)
+		return -errno;
+
+	uring->sq_submitted += ret;
+	/* The entries left are passed again by the next call, after the
+	 * completion of the submitted ones not to be reordered with them.
+	 */
+	if (uring->sq_submitted != uring->sq_tail)
+		((struct io_uring_sqe *)uring->sqes)[uring->sq_submitted &
+			uring->sq_mask].flags |= IOSQE_IO_DRAIN;
+	return ret;
+}
+
+/**
+ * Pass the prepared submission queue entries to the kernel. The entries not
+ * taken by the kernel, on partial submission or failure, stay prepared and
+ * in use until a next call passes them.
+ *
+ * @param uring
+ *   io_uring instance.
+ *
+ * @return
+ *   Number of entries submitted, negative errno value otherwise.
+ */
+int
+tap_uring_submit(struct tap_uring *uring)
+{
+	return tap_uring_enter(uring, 0, 0);
+}
+
+/**
+ * Pass the prepared submission queue entries to the kernel and wait for at
+ * least one completion.
+ *
+ * @param uring
+ *   io_uring instance.
+ *
+ * @return
+ *   Number of entries submitted, negative errno value otherwise.
+ */
+int
+tap_uring_wait(struct tap_uring *uring)
+{
+	return tap_uring_enter(uring, 1, IORING_ENTER_GETEVENTS);
+}
+
+#else /* HAVE_IO_URING */
+
+int
+tap_uring_init(struct tap_uring *uring, uint32_t entries __rte_unused)
+{
+	memset(uring, 0, sizeof(*uring));
+	uring->fd = -1;
+	return -ENOTSUP;
+}
+
+void
+tap_uring_free(struct tap_uring *uring)
+{
+	uring->fd = -1;
+}
+
+int
+tap_uring_submit(struct tap_uring *uring __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+int
+tap_uring_wait(struct tap_uring *uring __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+#endif /* HAVE_IO_URING */
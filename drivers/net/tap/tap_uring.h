@@ -0,0 +1,180 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _TAP_URING_H_
+#define _TAP_URING_H_
+
+/**
+ * @file
+ * Minimal io_uring instance for the tap driver queues, set up with the raw
+ * system calls so that no library is needed. Each queue owns its instance and
+ * is the only one to access it, no locking is done.
+ */
+
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include <linux/if_tun.h>
+
+#include <rte_common.h>
+#include <rte_mbuf.h>
+
+#include "tap_autoconf.h"
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#ifndef RWF_NOWAIT
+#define RWF_NOWAIT 0x00000008
+#endif
+
+/* Max number of entries of a queue io_uring */
+#define TAP_URING_MAX_ENTRIES 4096
+/* User data of the poll for input of an Rx queue, not a slot index */
+#define TAP_URING_POLL_DATA (UINT64_C(1) << 32)
+/* Max iovecs of a packet written through io_uring: info, headers, segments */
+#define TAP_URING_TX_IOV_MAX 16
+/* Max headers length to update checksums on for io_uring writes */
+#define TAP_URING_TX_HDR_MAX 256
+
+struct tap_uring {
+	int fd;                         /* io_uring fd, -1 when not in use */
+	uint32_t sq_entries;            /* Number of submission entries */
+	uint32_t sq_mask;               /* Submission ring index mask */
+	uint32_t sq_tail;               /* Local submission tail */
+	uint32_t sq_submitted;          /* Tail already passed to the kernel */
+	uint32_t *sq_khead;             /* Kernel submission head */
+	uint32_t *sq_ktail;             /* Kernel submission tail */
+	uint32_t cq_mask;               /* Completion ring index mask */
+	uint32_t *cq_khead;             /* Kernel completion head */
+	uint32_t *cq_ktail;             /* Kernel completion tail */
+	void *sqes;                     /* Submission queue entries */
+	void *cqes;                     /* Completion queue entries */
+	void *sq_ring;                  /* Mapping of the submission ring */
+	void *cq_ring;                  /* Mapping of the completion ring */
+	size_t sq_ring_size;
+	size_t cq_ring_size;
+	size_t sqes_size;
+};
+
+/* Read posted to the kernel by an Rx queue */
+struct tap_uring_rx_slot {
+	struct rte_mbuf *mbuf;          /* Buffer the packet is read into */
+	struct tun_pi pi;               /* Packet info read by the kernel */
+	struct iovec iovecs[2];         /* Packet info and mbuf data */
+};
+
+/* Write in flight for a Tx queue */
+struct tap_uring_tx_slot {
+	struct rte_mbuf *mbuf;          /* Reference released on completion */
+	struct tun_pi pi;               /* Packet info written to the kernel */
+	struct iovec iovecs[TAP_URING_TX_IOV_MAX];
+	char hdr[TAP_URING_TX_HDR_MAX]; /* Headers with checksums updated */
+};
+
+int tap_uring_init(struct tap_uring *uring, uint32_t entries);
+void tap_uring_free(struct tap_uring *uring);
+int tap_uring_submit(struct tap_uring *uring);
+int tap_uring_wait(struct tap_uring *uring);
+
+#ifdef HAVE_IO_URING
+
+/**
+ * Get a free submission queue entry, NULL when all of them are in use,
+ * including the entries a partial submission left to the kernel.
+ * The entry is passed to the kernel by the next tap_uring_submit().
+ */
+static inline struct io_uring_sqe *
+tap_uring_sqe_get(struct tap_uring *uring)
+{
+	uint32_t head = __atomic_load_n(uring->sq_khead, __ATOMIC_ACQUIRE);
+	struct io_uring_sqe *sqe;
+
+	if (uring->sq_tail - head >= uring->sq_entries)
+		return NULL;
+
+	sqe = &((struct io_uring_sqe *)uring->sqes)[uring->sq_tail &
+						    uring->sq_mask];
+	uring->sq_tail++;
+	memset(sqe, 0, sizeof(*sqe));
+	return sqe;
+}
+
+/**
+ * Prepare a readv or writev operation on a submission queue entry.
+ */
+static inline void
+tap_uring_sqe_prep_rw(struct io_uring_sqe *sqe, uint8_t opcode, int fd,
+		      const struct iovec *iovecs, uint32_t nb_iovecs,
+		      uint64_t user_data)
+{
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->addr = (uintptr_t)iovecs;
+	sqe->len = nb_iovecs;
+	sqe->user_data = user_data;
+}
+
+/**
+ * Prepare a poll for input, completed once the fd is readable.
+ */
+static inline void
+tap_uring_sqe_prep_poll(struct io_uring_sqe *sqe, int fd, uint64_t user_data)
+{
+	sqe->opcode = IORING_OP_POLL_ADD;
+	sqe->fd = fd;
+	sqe->poll_events = POLLIN;
+	sqe->user_data = user_data;
+}
+
+/**
+ * Link the previous entry to the entry got last, for the operation of the
+ * latter to start once the previous one completed, even on failure. Nothing
+ * is done when the previous entry is already submitted.
+ *
+ * @return
+ *   1 if linked, 0 if the entry got last is the first of the submission.
+ */
+static inline int
+tap_uring_sqe_link(struct tap_uring *uring)
+{
+	struct io_uring_sqe *prev;
+
+	if (uring->sq_tail - 1 == uring->sq_submitted)
+		return 0;
+
+	prev = &((struct io_uring_sqe *)uring->sqes)[(uring->sq_tail - 2) &
+						     uring->sq_mask];
+	prev->flags |= IOSQE_IO_HARDLINK;
+	return 1;
+}
+
+/**
+ * Get the oldest completion queue entry, NULL when there is none. It has to
+ * be released with tap_uring_cqe_seen() once processed.
+ */
+static inline struct io_uring_cqe *
+tap_uring_cqe_peek(struct tap_uring *uring)
+{
+	uint32_t head = *uring->cq_khead;
+
+	if (head == __atomic_load_n(uring->cq_ktail, __ATOMIC_ACQUIRE))
+		return NULL;
+
+	return &((struct io_uring_cqe *)uring->cqes)[head & uring->cq_mask];
+}
+
+static inline void
+tap_uring_cqe_seen(struct tap_uring *uring)
+{
+	__atomic_store_n(uring->cq_khead, *uring->cq_khead + 1,
+			 __ATOMIC_RELEASE);
+}
+
+#endif /* HAVE_IO_URING */
+
+#endif /* _TAP_URING_H_ */
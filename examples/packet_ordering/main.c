@@ -533,7 +533,6 @@ worker_thread(void *args_ptr)
 static int
 send_thread(struct send_thread_args *args)
 {
-	int ret;
 	unsigned int i, dret;
 	uint16_t nb_dq_mbufs;
 	uint8_t outp;
@@ -559,9 +558,12 @@ send_thread(struct send_thread_args *args)
 
 		for (i = 0; i < nb_dq_mbufs; i++) {
 			/* send dequeued mbufs for reordering */
-			ret = rte_reorder_insert(args->buffer, mbufs[i]);
+			i += rte_reorder_insert_burst(args->buffer, &mbufs[i],
+					nb_dq_mbufs - i);
+			if (i == nb_dq_mbufs)
+				break;
 
-			if (ret == -1 && rte_errno == ERANGE) {
+			if (rte_errno == ERANGE) {
 				/* Too early pkts should be transmitted out directly */
 				RTE_LOG_DP(DEBUG, REORDERAPP,
 						"%s():Cannot reorder early packet "
@@ -576,7 +578,7 @@ send_thread(struct send_thread_args *args)
 					app_stats.tx.early_pkts_tx_failed_woro++;
 				} else
 					app_stats.tx.early_pkts_txtd_woro++;
-			} else if (ret == -1 && rte_errno == ENOSPC) {
+			} else if (rte_errno == ENOSPC) {
 				/**
 				 * Early pkts just outside of window should be dropped
 				 */
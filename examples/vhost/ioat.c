@@ -69,10 +69,20 @@ open_ioat(const char *value)
 			goto out;
 		}
 
+		/*
+		 * "txd" binds the DMA to the enqueue path (guest Rx ring),
+		 * "rxd" to the dequeue path (guest Tx ring).
+		 */
 		start = strstr(ptrs[0], "txd");
-		if (start == NULL) {
-			ret = -1;
-			goto out;
+		if (start != NULL) {
+			vring_id = 0 + VIRTIO_RXQ;
+		} else {
+			start = strstr(ptrs[0], "rxd");
+			if (start == NULL) {
+				ret = -1;
+				goto out;
+			}
+			vring_id = 0 + VIRTIO_TXQ;
 		}
 
 		start += 3;
@@ -82,7 +92,6 @@ open_ioat(const char *value)
 			goto out;
 		}
 
-		vring_id = 0 + VIRTIO_RXQ;
 		if (rte_pci_addr_parse(ptrs[1],
 				&(dma_info + vid)->dmas[vring_id].addr) < 0) {
 			ret = -1;
@@ -122,13 +131,19 @@ open_ioat(const char *value)
 	return ret;
 }
 
+bool
+ioat_vring_is_bound(int vid, uint16_t vring_id)
+{
+	return dma_bind[vid].dmas[vring_id].is_valid;
+}
+
 uint32_t
 ioat_transfer_data_cb(int vid, uint16_t queue_id,
 		struct rte_vhost_async_desc *descs,
 		struct rte_vhost_async_status *opaque_data, uint16_t count)
 {
 	uint32_t i_desc;
-	uint16_t dev_id = dma_bind[vid].dmas[queue_id * 2 + VIRTIO_RXQ].dev_id;
+	uint16_t dev_id = dma_bind[vid].dmas[queue_id].dev_id;
 	struct rte_vhost_iov_iter *src = NULL;
 	struct rte_vhost_iov_iter *dst = NULL;
 	unsigned long i_seg;
@@ -181,8 +196,7 @@ ioat_check_completed_copies_cb(int vid, uint16_t queue_id,
 		unsigned short mask = MAX_ENQUEUED_SIZE - 1;
 		unsigned short i;
 
-		uint16_t dev_id = dma_bind[vid].dmas[queue_id * 2
-				+ VIRTIO_RXQ].dev_id;
+		uint16_t dev_id = dma_bind[vid].dmas[queue_id].dev_id;
 		n_seg = rte_ioat_completed_ops(dev_id, 255, NULL, NULL, dump, dump);
 		if (n_seg < 0) {
 			RTE_LOG(ERR,
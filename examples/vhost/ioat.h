@@ -27,6 +27,8 @@ struct dma_for_vhost {
 #ifdef RTE_RAW_IOAT
 int open_ioat(const char *value);
 
+bool ioat_vring_is_bound(int vid, uint16_t vring_id);
+
 uint32_t
 ioat_transfer_data_cb(int vid, uint16_t queue_id,
 		struct rte_vhost_async_desc *descs,
@@ -42,6 +44,12 @@ static int open_ioat(const char *value __rte_unused)
 	return -1;
 }
 
+static bool
+ioat_vring_is_bound(int vid __rte_unused, uint16_t vring_id __rte_unused)
+{
+	return false;
+}
+
 static uint32_t
 ioat_transfer_data_cb(int vid __rte_unused, uint16_t queue_id __rte_unused,
 		struct rte_vhost_async_desc *descs __rte_unused,
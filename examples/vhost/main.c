@@ -472,7 +472,7 @@ us_vhost_usage(const char *prgname)
 	"		--tso [0|1] disable/enable TCP segment offload.\n"
 	"		--client register a vhost-user socket as client mode.\n"
 	"		--dma-type register dma type for your vhost async driver. For example \"ioat\" for now.\n"
-	"		--dmas register dma channel for specific vhost device.\n",
+	"		--dmas register dma channel for specific vhost device, \"txd\" for enqueue and \"rxd\" for dequeue.\n",
 	       prgname);
 }
 
@@ -855,6 +855,27 @@ complete_async_pkts(struct vhost_dev *vdev)
 		free_pkts(p_cpl, complete_count);
 }
 
+static void
+complete_async_dequeue(struct vhost_dev *vdev)
+{
+	struct rte_mbuf *pkts[MAX_PKT_BURST];
+	uint16_t count;
+	int nr_inflight;
+
+	/*
+	 * The in-flight count is -1 when the vring lock could not be taken,
+	 * which does not mean that no packet is left.
+	 */
+	do {
+		count = rte_vhost_async_try_dequeue_burst(vdev->vid,
+					VIRTIO_TXQ, mbuf_pool, pkts,
+					MAX_PKT_BURST, &nr_inflight);
+		free_pkts(pkts, count);
+		if (nr_inflight < 0)
+			rte_pause();
+	} while (nr_inflight != 0);
+}
+
 static __rte_always_inline void
 sync_virtio_xmit(struct vhost_dev *dst_vdev, struct vhost_dev *src_vdev,
 	    struct rte_mbuf *m)
@@ -1259,6 +1280,12 @@ drain_virtio_tx(struct vhost_dev *vdev)
 	if (builtin_net_driver) {
 		count = vs_dequeue_pkts(vdev, VIRTIO_TXQ, mbuf_pool,
 					pkts, MAX_PKT_BURST);
+	} else if (vdev->async_dequeue) {
+		int nr_inflight;
+
+		count = rte_vhost_async_try_dequeue_burst(vdev->vid,
+					VIRTIO_TXQ, mbuf_pool, pkts,
+					MAX_PKT_BURST, &nr_inflight);
 	} else {
 		count = rte_vhost_dequeue_burst(vdev->vid, VIRTIO_TXQ,
 					mbuf_pool, pkts, MAX_PKT_BURST);
@@ -1400,6 +1427,12 @@ destroy_device(int vid)
 	if (async_vhost_driver)
 		rte_vhost_async_channel_unregister(vid, VIRTIO_RXQ);
 
+	if (vdev->async_dequeue) {
+		/* in-flight packets must be completed before unregistering */
+		complete_async_dequeue(vdev);
+		rte_vhost_async_channel_unregister(vid, VIRTIO_TXQ);
+	}
+
 	rte_free(vdev);
 }
 
@@ -1479,8 +1512,17 @@ new_device(int vid)
 			f.async_inorder = 1;
 			f.async_threshold = 256;
 
-			return rte_vhost_async_channel_register(vid, VIRTIO_RXQ,
-				f.intval, &channel_ops);
+			if (rte_vhost_async_channel_register(vid, VIRTIO_RXQ,
+					f.intval, &channel_ops) < 0)
+				return -1;
+
+			if (ioat_vring_is_bound(vid, VIRTIO_TXQ)) {
+				if (rte_vhost_async_channel_register(vid,
+						VIRTIO_TXQ, f.intval,
+						&channel_ops) < 0)
+					return -1;
+				vdev->async_dequeue = true;
+			}
 		}
 	}
 
@@ -46,6 +46,8 @@ struct vhost_dev {
 	volatile uint8_t ready;
 	/**< Device is marked for removal from the data core. */
 	volatile uint8_t remove;
+	/**< Guest Tx ring is drained through the async dequeue API. */
+	bool async_dequeue;
 
 	int vid;
 	uint64_t features;
@@ -187,6 +187,12 @@ struct rte_acl_ctx {
 	struct rte_acl_config config; /* copy of build config. */
 };
 
+struct rte_acl_ctx *acl_ctx_create(const struct rte_acl_param *param);
+
+void acl_ctx_free(struct rte_acl_ctx *ctx);
+
+int acl_check_rule(const struct rte_acl_rule_data *rd);
+
 int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
 	uint32_t num_categories, uint32_t data_index_sz, size_t max_size);
@@ -2,7 +2,10 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include <pthread.h>
+
 #include <rte_acl.h>
+#include <rte_lcore.h>
 #include "tb_mem.h"
 #include "acl.h"
 
@@ -62,6 +65,8 @@ struct rte_acl_build_rule {
 	uint32_t                    *wildness;
 };
 
+struct acl_build_job;
+
 /* Context for build phase */
 struct acl_build_context {
 	const struct rte_acl_ctx *acx;
@@ -85,6 +90,22 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/* tries rebuilt by build threads */
+	uint32_t                  num_threads;
+	uint32_t                  num_jobs;
+	uint32_t                  num_joined;
+	struct acl_build_job      *jobs[RTE_ACL_MAX_TRIES];
+};
+
+/* Rebuild of one trie, after a split, with its own build context */
+struct acl_build_job {
+	struct acl_build_context  bcx;
+	struct rte_acl_build_rule *rules;
+	uint32_t                  trie;
+	int32_t                   rc;
+	int32_t                   running;
+	pthread_t                 tid;
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -1335,6 +1356,152 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+static void
+acl_build_job_run(struct acl_build_job *job)
+{
+	int32_t rc;
+	struct rte_acl_build_rule *last;
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+
+	/* build thread runs out of memory. */
+	rc = sigsetjmp(job->bcx.pool.fail, 0);
+	if (rc != 0) {
+		job->rc = rc;
+		return;
+	}
+
+	rule_sets[job->trie] = job->rules;
+	last = build_one_trie(&job->bcx, rule_sets, job->trie, INT32_MAX);
+	if (job->bcx.bld_tries[job->trie].trie == NULL || last != NULL) {
+		RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", job->trie);
+		job->rc = -ENOMEM;
+		return;
+	}
+
+	job->rc = 0;
+}
+
+static void *
+acl_build_thread(void *arg)
+{
+	acl_build_job_run(arg);
+	return NULL;
+}
+
+/*
+ * Wait for the oldest build thread still running.
+ */
+static void
+acl_build_job_join(struct acl_build_context *context)
+{
+	struct acl_build_job *job;
+
+	for (; context->num_joined != context->num_jobs;
+			context->num_joined++) {
+		job = context->jobs[context->num_joined];
+		if (job->running != 0) {
+			pthread_join(job->tid, NULL);
+			job->running = 0;
+			context->num_joined++;
+			return;
+		}
+	}
+}
+
+/*
+ * Rebuild the trie for the given reduced rule-set on a build thread,
+ * while the remaining rules are split into the next tries.
+ */
+static int
+acl_build_job_start(struct acl_build_context *context,
+	struct rte_acl_build_rule *rules, uint32_t n)
+{
+	int32_t rc;
+	struct acl_build_job *job;
+	char name[RTE_MAX_THREAD_NAME_LEN];
+
+	/* the calling thread is one of the build threads. */
+	if (context->num_jobs - context->num_joined + 1 >=
+			context->num_threads)
+		acl_build_job_join(context);
+
+	job = calloc(1, sizeof(*job));
+	if (job == NULL)
+		return -ENOMEM;
+
+	job->bcx.acx = context->acx;
+	job->bcx.cfg = context->cfg;
+	job->bcx.category_mask = context->category_mask;
+	job->bcx.node_max = context->node_max;
+	job->bcx.pool.alignment = ACL_POOL_ALIGN;
+	job->bcx.pool.min_alloc = ACL_POOL_ALLOC_MIN;
+	job->rules = rules;
+	job->trie = n;
+	context->jobs[context->num_jobs++] = job;
+
+	snprintf(name, sizeof(name), "acl-bld-%u", n);
+	rc = rte_ctrl_thread_create(&job->tid, name, NULL, acl_build_thread,
+		job);
+	if (rc == 0)
+		job->running = 1;
+	else
+		acl_build_job_run(job);
+
+	return 0;
+}
+
+/*
+ * Wait for all the build threads, and get the tries they built.
+ */
+static int
+acl_build_jobs_finish(struct acl_build_context *context)
+{
+	int32_t rc;
+	uint32_t i, n;
+	struct acl_build_job *job;
+
+	while (context->num_joined != context->num_jobs)
+		acl_build_job_join(context);
+
+	rc = 0;
+	for (i = 0; i != context->num_jobs; i++) {
+		job = context->jobs[i];
+		if (job->rc != 0) {
+			rc = job->rc;
+			continue;
+		}
+
+		n = job->trie;
+		context->tries[n] = job->bcx.tries[n];
+		context->bld_tries[n] = job->bcx.bld_tries[n];
+		memcpy(context->data_indexes[n], job->bcx.data_indexes[n],
+			sizeof(context->data_indexes[n]));
+		context->tries[n].data_index = context->data_indexes[n];
+		context->num_nodes += job->bcx.num_nodes;
+	}
+
+	return rc;
+}
+
+/*
+ * Free the memory of the tries built by build threads.
+ */
+static void
+acl_build_jobs_free(struct acl_build_context *context)
+{
+	uint32_t i;
+
+	while (context->num_joined != context->num_jobs)
+		acl_build_job_join(context);
+
+	for (i = 0; i != context->num_jobs; i++) {
+		tb_free_pool(&context->jobs[i]->bcx.pool);
+		free(context->jobs[i]);
+	}
+	context->num_jobs = 0;
+	context->num_joined = 0;
+}
+
 static int
 acl_build_tries(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
@@ -1398,6 +1565,12 @@ acl_build_tries(struct acl_build_context *context,
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
 		 */
+		if (context->num_threads > 1) {
+			if (acl_build_job_start(context, rule_sets[n], n) != 0)
+				return -ENOMEM;
+			continue;
+		}
+
 		last = build_one_trie(context, rule_sets, n, INT32_MAX);
 		if (context->bld_tries[n].trie == NULL || last != NULL) {
 			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
@@ -1407,13 +1580,18 @@ acl_build_tries(struct acl_build_context *context,
 	}
 
 	context->num_tries = num_tries;
-	return 0;
+	return acl_build_jobs_finish(context);
 }
 
 static void
 acl_build_log(const struct acl_build_context *ctx)
 {
 	uint32_t n;
+	size_t alloc;
+
+	alloc = ctx->pool.alloc;
+	for (n = 0; n != ctx->num_jobs; n++)
+		alloc += ctx->jobs[n]->bcx.pool.alloc;
 
 	RTE_LOG(DEBUG, ACL, "Build phase for ACL \"%s\":\n"
 		"node limit for tree split: %u\n"
@@ -1422,7 +1600,7 @@ acl_build_log(const struct acl_build_context *ctx)
 		ctx->acx->name,
 		ctx->node_max,
 		ctx->num_nodes,
-		ctx->pool.alloc);
+		alloc);
 
 	for (n = 0; n < RTE_DIM(ctx->tries); n++) {
 		if (ctx->tries[n].count != 0)
@@ -1499,7 +1677,8 @@ acl_set_data_indexes(struct rte_acl_ctx *ctx)
  */
 static int
 acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
-	const struct rte_acl_config *cfg, uint32_t node_max)
+	const struct rte_acl_config *cfg, uint32_t node_max,
+	uint32_t num_threads)
 {
 	int32_t rc;
 
@@ -1512,6 +1691,7 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	bcx->category_mask = RTE_LEN2MASK(bcx->cfg.num_categories,
 		typeof(bcx->category_mask));
 	bcx->node_max = node_max;
+	bcx->num_threads = num_threads;
 
 	rc = sigsetjmp(bcx->pool.fail, 0);
 
@@ -1612,8 +1792,9 @@ get_first_load_size(const struct rte_acl_config *cfg)
 	return (ofs < max_ofs) ? sizeof(uint32_t) : sizeof(uint8_t);
 }
 
-int
-rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+static int
+acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	uint32_t num_threads)
 {
 	int32_t rc;
 	uint32_t n;
@@ -1637,7 +1818,7 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 	for (rc = -ERANGE; n >= NODE_MIN && rc == -ERANGE; n /= 2) {
 
 		/* perform build phase. */
-		rc = acl_bld(&bcx, ctx, cfg, n);
+		rc = acl_bld(&bcx, ctx, cfg, n, num_threads);
 
 		if (rc == 0) {
 			/* allocate and fill run-time  structures. */
@@ -1660,8 +1841,25 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 		acl_build_log(&bcx);
 
 		/* cleanup after build. */
+		acl_build_jobs_free(&bcx);
 		tb_free_pool(&bcx.pool);
 	}
 
 	return rc;
 }
+
+int
+rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+{
+	return acl_build(ctx, cfg, 1);
+}
+
+int
+rte_acl_build_parallel(struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg, uint32_t num_threads)
+{
+	if (num_threads == 0)
+		return -EINVAL;
+
+	return acl_build(ctx, cfg, num_threads);
+}
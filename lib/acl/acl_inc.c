@@ -0,0 +1,851 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_string_fns.h>
+#include <rte_acl.h>
+#include <rte_spinlock.h>
+
+#include "acl.h"
+
+/*
+ * Incremental ACL context.
+ *
+ * Each rule is stored in a slot, and the main and delta trie sets are
+ * built with the slot index + 1 as userdata, so that the readers can get
+ * the priority, the userdata and the deletion state of a rule from it.
+ *
+ * Each update increments the generation number of the context, and
+ * publishes the trie sets together with it. A deleted rule remains in the
+ * main trie set until the next merge, and is ignored by the readers of the
+ * generations it was deleted in. As the main trie set returns a deleted
+ * rule for all the input data matching it, whatever other rule matches,
+ * all the rules of the main trie set overlapping a deleted rule are added
+ * to the delta trie set, and only the result of the delta trie set is
+ * used then.
+ */
+
+/* number of input buffers classified at once in each trie set */
+#define ACL_INC_BURST	64
+
+/* deletion generation of the rules not deleted */
+#define ACL_INC_LIVE	UINT64_MAX
+
+/* multiplier of the userdata hash */
+#define ACL_INC_HASH_MUL	0x9e3779b1u
+
+/* rule data, as seen by the readers */
+struct acl_inc_rule {
+	uint32_t userdata;
+	int32_t  priority;
+	uint64_t del_gen;  /* generation the rule is deleted from */
+};
+
+/* trie sets, replaced as a whole by each update */
+struct acl_inc_gen {
+	uint64_t gen;
+	const struct rte_acl_ctx *main;
+	struct rte_acl_ctx *delta;
+};
+
+struct rte_acl_inc {
+	char name[RTE_ACL_NAMESIZE];
+	int32_t socket_id;
+	uint32_t rule_sz;
+	uint32_t max_rules;
+	struct rte_acl_config cfg;
+
+	/* read by the classify threads */
+	struct acl_inc_gen *cur;      /* published trie sets */
+	struct acl_inc_rule *rules;   /* per slot rule data */
+
+	/* serializes updates, and the start and end of merges */
+	rte_spinlock_t lock;
+	/* held during a merge */
+	rte_spinlock_t merge_lock;
+
+	uint64_t gen;           /* generation of the last update */
+	uint64_t main_gen;      /* generation the main trie set is built at */
+	struct rte_acl_ctx *main;
+	uint8_t *bodies;        /* rules, as given by the user */
+	uint64_t *add_gen;      /* generation each rule was added at */
+	uint8_t *shadow;        /* rules overlapping a deleted rule */
+	uint8_t *shadow_tmp;
+	uint32_t *slots;        /* slots of the delta rules */
+	uint32_t *batch;        /* slots of the rules being deleted */
+	uint32_t *free_slots;
+	uint32_t num_free;
+	uint32_t *hash;         /* userdata to slot + 1 */
+	uint32_t hash_mask;
+	uint32_t hash_shift;
+
+	uint32_t num_main;
+	uint32_t num_delta;
+	uint32_t num_deleted;
+	uint32_t merges;
+
+	/* RCU config */
+	struct rte_rcu_qsbr *v;        /* RCU QSBR variable. */
+	enum rte_acl_qsbr_mode rcu_mode;
+	struct rte_rcu_qsbr_dq *dq;    /* RCU QSBR defer queue. */
+};
+
+static inline struct rte_acl_rule *
+acl_inc_body(const struct rte_acl_inc *ictx, uint32_t slot)
+{
+	return (struct rte_acl_rule *)(ictx->bodies +
+		(size_t)slot * ictx->rule_sz);
+}
+
+static inline int
+acl_inc_live(const struct rte_acl_inc *ictx, uint32_t slot)
+{
+	return ictx->rules[slot].del_gen == ACL_INC_LIVE;
+}
+
+/*
+ * Open addressing hash table of the live rules, by userdata.
+ */
+static inline uint32_t
+acl_inc_hash(const struct rte_acl_inc *ictx, uint32_t userdata)
+{
+	return (userdata * ACL_INC_HASH_MUL) >> ictx->hash_shift;
+}
+
+static uint32_t
+acl_inc_hash_lookup(const struct rte_acl_inc *ictx, uint32_t userdata,
+	uint32_t *pos)
+{
+	uint32_t i, e;
+
+	for (i = acl_inc_hash(ictx, userdata); (e = ictx->hash[i]) != 0;
+			i = (i + 1) & ictx->hash_mask) {
+		if (ictx->rules[e - 1].userdata == userdata) {
+			if (pos != NULL)
+				*pos = i;
+			return e - 1;
+		}
+	}
+	return UINT32_MAX;
+}
+
+static void
+acl_inc_hash_add(struct rte_acl_inc *ictx, uint32_t slot)
+{
+	uint32_t i;
+
+	for (i = acl_inc_hash(ictx, ictx->rules[slot].userdata);
+			ictx->hash[i] != 0; i = (i + 1) & ictx->hash_mask)
+		;
+	ictx->hash[i] = slot + 1;
+}
+
+static void
+acl_inc_hash_del(struct rte_acl_inc *ictx, uint32_t slot)
+{
+	uint32_t i = 0, j, k;
+
+	if (acl_inc_hash_lookup(ictx, ictx->rules[slot].userdata, &i) !=
+			slot)
+		return;
+
+	/* move back the following entries, that would no longer be found */
+	for (j = (i + 1) & ictx->hash_mask; ictx->hash[j] != 0;
+			j = (j + 1) & ictx->hash_mask) {
+		k = acl_inc_hash(ictx,
+			ictx->rules[ictx->hash[j] - 1].userdata);
+		if (((j - k) & ictx->hash_mask) >=
+				((j - i) & ictx->hash_mask)) {
+			ictx->hash[i] = ictx->hash[j];
+			i = j;
+		}
+	}
+	ictx->hash[i] = 0;
+}
+
+static inline uint64_t
+acl_inc_field_value(const union rte_acl_field_types *v, uint8_t size)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		return v->u8;
+	case sizeof(uint16_t):
+		return v->u16;
+	case sizeof(uint32_t):
+		return v->u32;
+	default:
+		return v->u64;
+	}
+}
+
+/* check if some input value matches both fields */
+static int
+acl_inc_field_overlap(const struct rte_acl_field_def *def,
+	const struct rte_acl_field *f1, const struct rte_acl_field *f2)
+{
+	uint64_t v1, v2, m1, m2;
+
+	v1 = acl_inc_field_value(&f1->value, def->size);
+	v2 = acl_inc_field_value(&f2->value, def->size);
+
+	switch (def->type) {
+	case RTE_ACL_FIELD_TYPE_RANGE:
+		m1 = acl_inc_field_value(&f1->mask_range, def->size);
+		m2 = acl_inc_field_value(&f2->mask_range, def->size);
+		return v1 <= m2 && v2 <= m1;
+	case RTE_ACL_FIELD_TYPE_MASK:
+		m1 = RTE_ACL_MASKLEN_TO_BITMASK((uint64_t)f1->mask_range.u32,
+			def->size);
+		m2 = RTE_ACL_MASKLEN_TO_BITMASK((uint64_t)f2->mask_range.u32,
+			def->size);
+		return ((v1 ^ v2) & m1 & m2) == 0;
+	default:
+		m1 = acl_inc_field_value(&f1->mask_range, def->size);
+		m2 = acl_inc_field_value(&f2->mask_range, def->size);
+		return ((v1 ^ v2) & m1 & m2) == 0;
+	}
+}
+
+/* check if some input data matches both rules in a same category */
+static int
+acl_inc_rule_overlap(const struct rte_acl_inc *ictx,
+	const struct rte_acl_rule *r1, const struct rte_acl_rule *r2)
+{
+	const struct rte_acl_field_def *def;
+	uint32_t n;
+
+	if ((r1->data.category_mask & r2->data.category_mask) == 0)
+		return 0;
+
+	for (n = 0; n != ictx->cfg.num_fields; n++) {
+		def = &ictx->cfg.defs[n];
+		if (!acl_inc_field_overlap(def, &r1->field[def->field_index],
+				&r2->field[def->field_index]))
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Mark the live rules of the main trie set, built at main_gen, that
+ * overlap the deleted rule.
+ */
+static void
+acl_inc_shadow(const struct rte_acl_inc *ictx, uint8_t *shadow,
+	uint64_t main_gen, uint32_t deleted)
+{
+	const struct rte_acl_rule *rd;
+	uint32_t i;
+
+	rd = acl_inc_body(ictx, deleted);
+	for (i = 0; i != ictx->max_rules; i++) {
+		if (shadow[i] == 0 && acl_inc_live(ictx, i) &&
+				ictx->add_gen[i] <= main_gen &&
+				acl_inc_rule_overlap(ictx, rd,
+					acl_inc_body(ictx, i)))
+			shadow[i] = 1;
+	}
+}
+
+/* Build a trie set from the given rules */
+static int
+acl_inc_build(const struct rte_acl_inc *ictx, const uint32_t *slots,
+	uint32_t num, struct rte_acl_ctx **pctx)
+{
+	struct rte_acl_param prm = {
+		.name = ictx->name,
+		.socket_id = ictx->socket_id,
+		.rule_size = ictx->rule_sz,
+		.max_rule_num = num,
+	};
+	struct rte_acl_ctx *ctx;
+	struct rte_acl_rule *rule;
+	uint32_t i;
+	int rc;
+
+	*pctx = NULL;
+	if (num == 0)
+		return 0;
+
+	ctx = acl_ctx_create(&prm);
+	if (ctx == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i != num; i++) {
+		rule = (struct rte_acl_rule *)((uintptr_t)ctx->rules +
+			(size_t)i * ctx->rule_sz);
+		memcpy(rule, acl_inc_body(ictx, slots[i]), ctx->rule_sz);
+		rule->data.userdata = slots[i] + 1;
+	}
+	ctx->num_rules = num;
+
+	rc = rte_acl_build(ctx, &ictx->cfg);
+	if (rc != 0) {
+		acl_ctx_free(ctx);
+		return rc;
+	}
+
+	*pctx = ctx;
+	return 0;
+}
+
+static void
+acl_inc_gen_free(struct acl_inc_gen *g)
+{
+	if (g->delta != NULL)
+		acl_ctx_free(g->delta);
+	rte_free(g);
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(n);
+	acl_inc_gen_free(*(struct acl_inc_gen **)data);
+}
+
+/* Free trie sets, once readers can no longer use them */
+static void
+acl_inc_gen_retire(struct rte_acl_inc *ictx, struct acl_inc_gen *g)
+{
+	if (g == NULL)
+		return;
+
+	if (ictx->v == NULL) {
+		acl_inc_gen_free(g);
+	} else if (ictx->rcu_mode == RTE_ACL_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(ictx->v, RTE_QSBR_THRID_INVALID);
+		acl_inc_gen_free(g);
+	} else if (ictx->rcu_mode == RTE_ACL_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(ictx->dq, &g) != 0) {
+			/* Defer queue is full, fall back to blocking mode */
+			rte_rcu_qsbr_synchronize(ictx->v,
+				RTE_QSBR_THRID_INVALID);
+			acl_inc_gen_free(g);
+		}
+	}
+}
+
+/*
+ * Rebuild the delta trie set, from the rules added since the main trie set
+ * was built and the rules of the main trie set overlapping deleted rules,
+ * and publish it with the given main trie set as the current generation.
+ * Must be called with the lock held.
+ */
+static int
+acl_inc_publish(struct rte_acl_inc *ictx, struct rte_acl_ctx *main,
+	struct acl_inc_gen **old)
+{
+	struct acl_inc_gen *g;
+	uint32_t i, n;
+	int rc;
+
+	g = rte_zmalloc_socket(ictx->name, sizeof(*g), RTE_CACHE_LINE_SIZE,
+		ictx->socket_id);
+	if (g == NULL)
+		return -ENOMEM;
+
+	n = 0;
+	for (i = 0; i != ictx->max_rules; i++) {
+		if (acl_inc_live(ictx, i) &&
+				(ictx->add_gen[i] > ictx->main_gen ||
+				 ictx->shadow[i] != 0))
+			ictx->slots[n++] = i;
+	}
+
+	rc = acl_inc_build(ictx, ictx->slots, n, &g->delta);
+	if (rc != 0) {
+		RTE_LOG(ERR, ACL, "%s(%s): delta build failed: %d\n",
+			__func__, ictx->name, rc);
+		rte_free(g);
+		return rc;
+	}
+
+	g->gen = ictx->gen;
+	g->main = main;
+	ictx->num_delta = n;
+
+	*old = ictx->cur;
+	__atomic_store_n(&ictx->cur, g, __ATOMIC_RELEASE);
+	return 0;
+}
+
+static void
+acl_inc_free_slot(struct rte_acl_inc *ictx, uint32_t slot)
+{
+	__atomic_store_n(&ictx->rules[slot].del_gen, 0, __ATOMIC_RELAXED);
+	ictx->add_gen[slot] = 0;
+	ictx->shadow[slot] = 0;
+	ictx->free_slots[ictx->num_free++] = slot;
+}
+
+int
+rte_acl_inc_add_rules(struct rte_acl_inc *ictx,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	const struct rte_acl_rule *rv;
+	struct acl_inc_gen *old = NULL;
+	uint32_t i, slot;
+	int rc = 0;
+
+	if (ictx == NULL || rules == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != num; i++) {
+		rv = (const struct rte_acl_rule *)
+			((uintptr_t)rules + (size_t)i * ictx->rule_sz);
+		if (acl_check_rule(&rv->data) != 0 || rv->data.userdata == 0) {
+			RTE_LOG(ERR, ACL, "%s(%s): rule #%u is invalid\n",
+				__func__, ictx->name, i + 1);
+			return -EINVAL;
+		}
+	}
+
+	rte_spinlock_lock(&ictx->lock);
+
+	if (num > ictx->num_free) {
+		rte_spinlock_unlock(&ictx->lock);
+		return -ENOMEM;
+	}
+
+	ictx->gen++;
+	for (i = 0; i != num; i++) {
+		rv = (const struct rte_acl_rule *)
+			((uintptr_t)rules + (size_t)i * ictx->rule_sz);
+		if (acl_inc_hash_lookup(ictx, rv->data.userdata, NULL) !=
+				UINT32_MAX) {
+			rc = -EEXIST;
+			break;
+		}
+
+		slot = ictx->free_slots[--ictx->num_free];
+		memcpy(acl_inc_body(ictx, slot), rv, ictx->rule_sz);
+		ictx->rules[slot].userdata = rv->data.userdata;
+		ictx->rules[slot].priority = rv->data.priority;
+		ictx->add_gen[slot] = ictx->gen;
+		acl_inc_hash_add(ictx, slot);
+		__atomic_store_n(&ictx->rules[slot].del_gen, ACL_INC_LIVE,
+			__ATOMIC_RELAXED);
+	}
+
+	/* rules are only stored until the first merge */
+	if (rc == 0 && ictx->cur != NULL)
+		rc = acl_inc_publish(ictx, ictx->main, &old);
+
+	if (rc != 0) {
+		/* the slots taken are still on top of the free stack */
+		while (i-- != 0) {
+			slot = ictx->free_slots[ictx->num_free];
+			acl_inc_hash_del(ictx, slot);
+			acl_inc_free_slot(ictx, slot);
+		}
+	}
+
+	rte_spinlock_unlock(&ictx->lock);
+
+	acl_inc_gen_retire(ictx, old);
+	return rc;
+}
+
+int
+rte_acl_inc_del_rules(struct rte_acl_inc *ictx, const uint32_t *userdata,
+	uint32_t num)
+{
+	struct acl_inc_gen *old = NULL;
+	uint32_t i, slot, num_deleted;
+	int rc = 0;
+
+	if (ictx == NULL || userdata == NULL)
+		return -EINVAL;
+
+	rte_spinlock_lock(&ictx->lock);
+
+	ictx->gen++;
+	num_deleted = ictx->num_deleted;
+	for (i = 0; i != num; i++) {
+		slot = acl_inc_hash_lookup(ictx, userdata[i], NULL);
+		if (slot == UINT32_MAX) {
+			rc = -ENOENT;
+			break;
+		}
+		acl_inc_hash_del(ictx, slot);
+		__atomic_store_n(&ictx->rules[slot].del_gen, ictx->gen,
+			__ATOMIC_RELAXED);
+		ictx->batch[i] = slot;
+	}
+
+	if (rc == 0) {
+		for (i = 0; i != num; i++) {
+			slot = ictx->batch[i];
+			if (ictx->add_gen[slot] > ictx->main_gen)
+				continue;
+			acl_inc_shadow(ictx, ictx->shadow, ictx->main_gen,
+				slot);
+			ictx->num_deleted++;
+		}
+		if (ictx->cur != NULL)
+			rc = acl_inc_publish(ictx, ictx->main, &old);
+	}
+
+	/* shadow marks left by a failed update are harmless */
+	if (rc != 0) {
+		while (i-- != 0) {
+			slot = ictx->batch[i];
+			__atomic_store_n(&ictx->rules[slot].del_gen,
+				ACL_INC_LIVE, __ATOMIC_RELAXED);
+			acl_inc_hash_add(ictx, slot);
+		}
+		ictx->num_deleted = num_deleted;
+	}
+
+	rte_spinlock_unlock(&ictx->lock);
+
+	acl_inc_gen_retire(ictx, old);
+	return rc;
+}
+
+int
+rte_acl_inc_merge(struct rte_acl_inc *ictx)
+{
+	struct rte_acl_ctx *main, *old_main;
+	struct acl_inc_gen *old = NULL;
+	uint64_t snap, old_main_gen;
+	uint32_t i, n, num_deleted;
+	uint32_t *slots;
+	uint8_t *shadow;
+	int rc;
+
+	if (ictx == NULL)
+		return -EINVAL;
+
+	if (!rte_spinlock_trylock(&ictx->merge_lock))
+		return -EBUSY;
+
+	slots = rte_malloc_socket(NULL, ictx->max_rules * sizeof(slots[0]), 0,
+		ictx->socket_id);
+	if (slots == NULL) {
+		rte_spinlock_unlock(&ictx->merge_lock);
+		return -ENOMEM;
+	}
+
+	/* take a snapshot of the live rules */
+	rte_spinlock_lock(&ictx->lock);
+	snap = ictx->gen;
+	n = 0;
+	for (i = 0; i != ictx->max_rules; i++) {
+		if (acl_inc_live(ictx, i))
+			slots[n++] = i;
+	}
+	rte_spinlock_unlock(&ictx->lock);
+
+	/*
+	 * The rules of the snapshot are not freed before the end of the
+	 * merge, and the rules added meanwhile use other slots.
+	 */
+	rc = acl_inc_build(ictx, slots, n, &main);
+	if (rc != 0) {
+		RTE_LOG(ERR, ACL, "%s(%s): main build failed: %d\n",
+			__func__, ictx->name, rc);
+		goto out;
+	}
+
+	rte_spinlock_lock(&ictx->lock);
+
+	/* rules of the snapshot deleted meanwhile remain in the main set */
+	shadow = ictx->shadow_tmp;
+	memset(shadow, 0, ictx->max_rules);
+	num_deleted = 0;
+	for (i = 0; i != ictx->max_rules; i++) {
+		if (ictx->add_gen[i] <= snap && !acl_inc_live(ictx, i) &&
+				ictx->rules[i].del_gen > snap) {
+			acl_inc_shadow(ictx, shadow, snap, i);
+			num_deleted++;
+		}
+	}
+
+	ictx->shadow_tmp = ictx->shadow;
+	ictx->shadow = shadow;
+	old_main_gen = ictx->main_gen;
+	ictx->main_gen = snap;
+	ictx->gen++;
+
+	rc = acl_inc_publish(ictx, main, &old);
+	if (rc != 0) {
+		ictx->shadow = ictx->shadow_tmp;
+		ictx->shadow_tmp = shadow;
+		ictx->main_gen = old_main_gen;
+		rte_spinlock_unlock(&ictx->lock);
+		if (main != NULL)
+			acl_ctx_free(main);
+		goto out;
+	}
+
+	old_main = ictx->main;
+	ictx->main = main;
+	ictx->num_main = n;
+	ictx->num_deleted = num_deleted;
+	ictx->merges++;
+
+	rte_spinlock_unlock(&ictx->lock);
+
+	/* Wait for the readers of the previous main trie set */
+	if (ictx->v != NULL)
+		rte_rcu_qsbr_synchronize(ictx->v, RTE_QSBR_THRID_INVALID);
+	if (old != NULL)
+		acl_inc_gen_free(old);
+	if (old_main != NULL)
+		acl_ctx_free(old_main);
+
+	/* rules deleted before the snapshot are in no trie set anymore */
+	rte_spinlock_lock(&ictx->lock);
+	for (i = 0; i != ictx->max_rules; i++) {
+		if (ictx->rules[i].del_gen != 0 &&
+				ictx->rules[i].del_gen <= snap)
+			acl_inc_free_slot(ictx, i);
+	}
+	rte_spinlock_unlock(&ictx->lock);
+
+out:
+	rte_free(slots);
+	rte_spinlock_unlock(&ictx->merge_lock);
+	return rc;
+}
+
+/*
+ * Select the result of the main or delta trie set, and convert it to
+ * the userdata of the rule.
+ */
+static inline uint32_t
+acl_inc_result(const struct rte_acl_inc *ictx, uint64_t gen, uint32_t m,
+	uint32_t d)
+{
+	const struct acl_inc_rule *rm, *rd;
+
+	rd = (d != 0) ? &ictx->rules[d - 1] : NULL;
+	if (m == 0)
+		return (rd != NULL) ? rd->userdata : 0;
+
+	/* delta set has all the rules overlapping a deleted one */
+	rm = &ictx->rules[m - 1];
+	if (__atomic_load_n(&rm->del_gen, __ATOMIC_RELAXED) <= gen)
+		return (rd != NULL) ? rd->userdata : 0;
+
+	if (rd != NULL && rd->priority > rm->priority)
+		return rd->userdata;
+	return rm->userdata;
+}
+
+int
+rte_acl_inc_classify(const struct rte_acl_inc *ictx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories)
+{
+	uint32_t res_main[ACL_INC_BURST * RTE_ACL_MAX_CATEGORIES];
+	uint32_t res_delta[ACL_INC_BURST * RTE_ACL_MAX_CATEGORIES];
+	const struct acl_inc_gen *g;
+	uint32_t i, k, n;
+
+	if (ictx == NULL || data == NULL || results == NULL ||
+			categories == 0 ||
+			categories > RTE_ACL_MAX_CATEGORIES ||
+			(categories != 1 &&
+			(categories & (RTE_ACL_RESULTS_MULTIPLIER - 1)) != 0))
+		return -EINVAL;
+
+	g = __atomic_load_n(&ictx->cur, __ATOMIC_ACQUIRE);
+	if (g == NULL || (g->main == NULL && g->delta == NULL)) {
+		memset(results, 0, sizeof(results[0]) * num * categories);
+		return 0;
+	}
+
+	for (i = 0; i != num; i += n) {
+		n = RTE_MIN(num - i, (uint32_t)ACL_INC_BURST);
+
+		if (g->main != NULL)
+			rte_acl_classify(g->main, data + i, res_main, n,
+				categories);
+		else
+			memset(res_main, 0, sizeof(res_main[0]) * n *
+				categories);
+
+		if (g->delta != NULL)
+			rte_acl_classify(g->delta, data + i, res_delta, n,
+				categories);
+		else
+			memset(res_delta, 0, sizeof(res_delta[0]) * n *
+				categories);
+
+		for (k = 0; k != n * categories; k++)
+			results[i * categories + k] = acl_inc_result(ictx,
+				g->gen, res_main[k], res_delta[k]);
+	}
+
+	return 0;
+}
+
+int
+rte_acl_inc_get_stats(struct rte_acl_inc *ictx,
+	struct rte_acl_inc_stats *stats)
+{
+	if (ictx == NULL || stats == NULL)
+		return -EINVAL;
+
+	rte_spinlock_lock(&ictx->lock);
+	stats->generation = ictx->gen;
+	stats->main_rules = ictx->num_main;
+	stats->delta_rules = ictx->num_delta;
+	stats->deleted_rules = ictx->num_deleted;
+	stats->merges = ictx->merges;
+	rte_spinlock_unlock(&ictx->lock);
+
+	return 0;
+}
+
+int
+rte_acl_inc_rcu_qsbr_add(struct rte_acl_inc *ictx,
+	const struct rte_acl_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (ictx == NULL || cfg == NULL || cfg->v == NULL)
+		return -EINVAL;
+
+	if (ictx->v != NULL)
+		return -EEXIST;
+
+	if (cfg->mode == RTE_ACL_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_ACL_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"ACL_RCU_%s", ictx->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = RTE_ACL_RCU_DQ_RECLAIM_MAX * 4;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_ACL_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(struct acl_inc_gen *);
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = ictx;
+		params.v = cfg->v;
+		ictx->dq = rte_rcu_qsbr_dq_create(&params);
+		if (ictx->dq == NULL) {
+			RTE_LOG(ERR, ACL, "ACL defer queue creation failed\n");
+			return -rte_errno;
+		}
+	} else
+		return -EINVAL;
+
+	ictx->rcu_mode = cfg->mode;
+	ictx->v = cfg->v;
+
+	return 0;
+}
+
+void
+rte_acl_inc_free(struct rte_acl_inc *ictx)
+{
+	if (ictx == NULL)
+		return;
+
+	if (ictx->dq != NULL)
+		rte_rcu_qsbr_dq_delete(ictx->dq);
+	if (ictx->cur != NULL)
+		acl_inc_gen_free(ictx->cur);
+	if (ictx->main != NULL)
+		acl_ctx_free(ictx->main);
+
+	rte_free(ictx->hash);
+	rte_free(ictx->free_slots);
+	rte_free(ictx->batch);
+	rte_free(ictx->slots);
+	rte_free(ictx->shadow_tmp);
+	rte_free(ictx->shadow);
+	rte_free(ictx->add_gen);
+	rte_free(ictx->bodies);
+	rte_free(ictx->rules);
+	rte_free(ictx);
+}
+
+struct rte_acl_inc *
+rte_acl_inc_create(const struct rte_acl_inc_param *param)
+{
+	struct rte_acl_inc *ictx;
+	uint32_t i, hash_size;
+	size_t max;
+
+	if (param == NULL || param->name == NULL || param->cfg == NULL ||
+			param->rule_size < RTE_ACL_RULE_SZ(
+				param->cfg->num_fields) ||
+			param->max_rule_num == 0 ||
+			param->max_rule_num > RTE_ACL_MAX_INDEX ||
+			param->cfg->num_categories == 0 ||
+			param->cfg->num_categories > RTE_ACL_MAX_CATEGORIES ||
+			param->cfg->num_fields == 0 ||
+			param->cfg->num_fields > RTE_ACL_MAX_FIELDS) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	ictx = rte_zmalloc_socket(param->name, sizeof(*ictx),
+		RTE_CACHE_LINE_SIZE, param->socket_id);
+	if (ictx == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	strlcpy(ictx->name, param->name, sizeof(ictx->name));
+	ictx->socket_id = param->socket_id;
+	ictx->rule_sz = param->rule_size;
+	ictx->max_rules = param->max_rule_num;
+	ictx->cfg = *param->cfg;
+	rte_spinlock_init(&ictx->lock);
+	rte_spinlock_init(&ictx->merge_lock);
+
+	hash_size = rte_align32pow2(RTE_MAX(param->max_rule_num * 2, 16u));
+	ictx->hash_mask = hash_size - 1;
+	ictx->hash_shift = 32 - rte_bsf32(hash_size);
+
+	max = ictx->max_rules;
+	ictx->rules = rte_zmalloc_socket(NULL, max * sizeof(ictx->rules[0]),
+		RTE_CACHE_LINE_SIZE, ictx->socket_id);
+	ictx->bodies = rte_zmalloc_socket(NULL, max * ictx->rule_sz,
+		RTE_CACHE_LINE_SIZE, ictx->socket_id);
+	ictx->add_gen = rte_zmalloc_socket(NULL,
+		max * sizeof(ictx->add_gen[0]), 0, ictx->socket_id);
+	ictx->shadow = rte_zmalloc_socket(NULL, max, 0, ictx->socket_id);
+	ictx->shadow_tmp = rte_zmalloc_socket(NULL, max, 0, ictx->socket_id);
+	ictx->slots = rte_zmalloc_socket(NULL, max * sizeof(ictx->slots[0]),
+		0, ictx->socket_id);
+	ictx->batch = rte_zmalloc_socket(NULL, max * sizeof(ictx->batch[0]),
+		0, ictx->socket_id);
+	ictx->free_slots = rte_zmalloc_socket(NULL,
+		max * sizeof(ictx->free_slots[0]), 0, ictx->socket_id);
+	ictx->hash = rte_zmalloc_socket(NULL,
+		hash_size * sizeof(ictx->hash[0]), 0, ictx->socket_id);
+
+	if (ictx->rules == NULL || ictx->bodies == NULL ||
+			ictx->add_gen == NULL || ictx->shadow == NULL ||
+			ictx->shadow_tmp == NULL || ictx->slots == NULL ||
+			ictx->batch == NULL ||
+			ictx->free_slots == NULL || ictx->hash == NULL) {
+		RTE_LOG(ERR, ACL, "%s(%s): allocation failed\n",
+			__func__, param->name);
+		rte_acl_inc_free(ictx);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	/* lowest slots are used first */
+	for (i = 0; i != ictx->max_rules; i++)
+		ictx->free_slots[i] = ictx->max_rules - 1 - i;
+	ictx->num_free = ictx->max_rules;
+
+	return ictx;
+}
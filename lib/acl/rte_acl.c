@@ -358,19 +358,58 @@ rte_acl_free(struct rte_acl_ctx *ctx)
 
 	rte_mcfg_tailq_write_unlock();
 
+	acl_ctx_free(ctx);
+	rte_free(te);
+}
+
+/*
+ * Allocate and init new ACL context, that is not registered in the list of
+ * ACL contexts.
+ */
+struct rte_acl_ctx *
+acl_ctx_create(const struct rte_acl_param *param)
+{
+	size_t sz;
+	struct rte_acl_ctx *ctx;
+	char name[sizeof(ctx->name)];
+
+	snprintf(name, sizeof(name), "ACL_%s", param->name);
+
+	/* calculate amount of memory required for pattern set. */
+	sz = sizeof(*ctx) + param->max_rule_num * param->rule_size;
+
+	ctx = rte_zmalloc_socket(name, sz, RTE_CACHE_LINE_SIZE, param->socket_id);
+	if (ctx == NULL) {
+		RTE_LOG(ERR, ACL,
+			"allocation of %zu bytes on socket %d for %s failed\n",
+			sz, param->socket_id, name);
+		return NULL;
+	}
+
+	/* init new allocated context. */
+	ctx->rules = ctx + 1;
+	ctx->max_rules = param->max_rule_num;
+	ctx->rule_sz = param->rule_size;
+	ctx->socket_id = param->socket_id;
+	ctx->alg = acl_get_best_alg();
+	strlcpy(ctx->name, param->name, sizeof(ctx->name));
+
+	return ctx;
+}
+
+void
+acl_ctx_free(struct rte_acl_ctx *ctx)
+{
 	rte_free(ctx->mem);
 	rte_free(ctx);
-	rte_free(te);
 }
 
 struct rte_acl_ctx *
 rte_acl_create(const struct rte_acl_param *param)
 {
-	size_t sz;
 	struct rte_acl_ctx *ctx;
 	struct rte_acl_list *acl_list;
 	struct rte_tailq_entry *te;
-	char name[sizeof(ctx->name)];
 
 	acl_list = RTE_TAILQ_CAST(rte_acl_tailq.head, rte_acl_list);
 
@@ -380,11 +419,6 @@ rte_acl_create(const struct rte_acl_param *param)
 		return NULL;
 	}
 
-	snprintf(name, sizeof(name), "ACL_%s", param->name);
-
-	/* calculate amount of memory required for pattern set. */
-	sz = sizeof(*ctx) + param->max_rule_num * param->rule_size;
-
 	/* get EAL TAILQ lock. */
 	rte_mcfg_tailq_write_lock();
 
@@ -405,22 +439,11 @@ rte_acl_create(const struct rte_acl_param *param)
 			goto exit;
 		}
 
-		ctx = rte_zmalloc_socket(name, sz, RTE_CACHE_LINE_SIZE, param->socket_id);
-
+		ctx = acl_ctx_create(param);
 		if (ctx == NULL) {
-			RTE_LOG(ERR, ACL,
-				"allocation of %zu bytes on socket %d for %s failed\n",
-				sz, param->socket_id, name);
 			rte_free(te);
 			goto exit;
 		}
-		/* init new allocated context. */
-		ctx->rules = ctx + 1;
-		ctx->max_rules = param->max_rule_num;
-		ctx->rule_sz = param->rule_size;
-		ctx->socket_id = param->socket_id;
-		ctx->alg = acl_get_best_alg();
-		strlcpy(ctx->name, param->name, sizeof(ctx->name));
 
 		te->data = (void *) ctx;
 
@@ -448,7 +471,7 @@ acl_add_rules(struct rte_acl_ctx *ctx, const void *rules, uint32_t num)
 	return 0;
 }
 
-static int
+int
 acl_check_rule(const struct rte_acl_rule_data *rd)
 {
 	if ((RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES, typeof(rd->category_mask)) &
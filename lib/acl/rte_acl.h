@@ -12,6 +12,8 @@
  */
 
 #include <rte_acl_osdep.h>
+#include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -220,6 +222,35 @@ rte_acl_reset_rules(struct rte_acl_ctx *ctx);
 int
 rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Same as rte_acl_build(), but the tries the rules are split into are built
+ * by up to *num_threads* threads at once.
+ * The calling thread is one of them, the others are control threads
+ * created for the build, so they run on the CPUs not used by the lcores.
+ * Only the rule sets split into several tries are built faster.
+ * The resulting run-time structures are the same as with rte_acl_build().
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to build.
+ * @param cfg
+ *   Pointer to struct rte_acl_config - defines build parameters.
+ * @param num_threads
+ *   Maximum number of threads building tries at once.
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_build_parallel(struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg, uint32_t num_threads);
+
 /**
  * Delete all rules from the ACL context and
  * destroy all internal run-time structures.
@@ -354,6 +385,266 @@ rte_acl_dump(const struct rte_acl_ctx *ctx);
 void
 rte_acl_list_dump(void);
 
+/*
+ * Incremental ACL context.
+ *
+ * Rules of an incremental ACL context are split between a main trie set,
+ * built by rte_acl_inc_merge(), and a small delta trie set, rebuilt on each
+ * rte_acl_inc_add_rules() and rte_acl_inc_del_rules() call from the rules
+ * added since the last merge and the rules of the main trie set overlapping
+ * the deleted ones. rte_acl_inc_classify() searches both and returns the
+ * match with the highest priority, as rte_acl_classify() would with all the
+ * rules in a single context. The trie sets are swapped atomically, so that,
+ * with an RCU QSBR variable attached, classification can run on other
+ * threads while rules are updated or merged.
+ */
+
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_ACL_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_acl_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_ACL_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_ACL_QSBR_MODE_SYNC
+};
+
+/** Incremental ACL RCU QSBR configuration structure. */
+struct rte_acl_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_ACL_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_acl_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: RTE_ACL_RCU_DQ_RECLAIM_MAX * 4.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_ACL_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
+/**
+ * Parameters used when creating an incremental ACL context.
+ */
+struct rte_acl_inc_param {
+	const char *name;         /**< Name of the ACL context. */
+	int         socket_id;    /**< Socket ID to allocate memory for. */
+	uint32_t    rule_size;    /**< Size of each rule. */
+	uint32_t    max_rule_num;
+	/**< Maximum number of rules, including deleted rules not merged yet. */
+	const struct rte_acl_config *cfg;
+	/**< Build configuration of the main and delta trie sets. */
+};
+
+/**
+ * Statistics of an incremental ACL context.
+ */
+struct rte_acl_inc_stats {
+	uint64_t generation;    /**< Incremented by each update and merge. */
+	uint32_t main_rules;    /**< Rules in the main trie set. */
+	uint32_t delta_rules;   /**< Rules in the delta trie set. */
+	uint32_t deleted_rules; /**< Deleted rules still in the main trie set. */
+	uint32_t merges;        /**< Number of completed merges. */
+};
+
+struct rte_acl_inc;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new incremental ACL context.
+ *
+ * @param param
+ *   Parameters used to create and initialise the incremental ACL context.
+ * @return
+ *   Pointer to incremental ACL context structure, or NULL on error, with
+ *   error code set in rte_errno.
+ *   Possible rte_errno errors include:
+ *   - EINVAL - invalid parameter passed to function
+ *   - ENOMEM - memory allocation failure
+ */
+__rte_experimental
+struct rte_acl_inc *
+rte_acl_inc_create(const struct rte_acl_inc_param *param);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * De-allocate all memory used by incremental ACL context.
+ * No classification or update may run on the context anymore.
+ *
+ * @param ictx
+ *   Incremental ACL context to free
+ */
+__rte_experimental
+void
+rte_acl_inc_free(struct rte_acl_inc *ictx);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with an incremental ACL context.
+ *
+ * Once associated, the trie sets replaced by an update or a merge are only
+ * freed once all the reader threads registered with the QSBR variable have
+ * reported a quiescent state, so rte_acl_inc_classify() may run concurrently
+ * with rte_acl_inc_add_rules(), rte_acl_inc_del_rules() and
+ * rte_acl_inc_merge(). rte_acl_inc_merge() always waits for the readers.
+ *
+ * @param ictx
+ *   Incremental ACL context
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   -EINVAL - invalid parameters
+ *   -EEXIST - already added QSBR
+ *   -ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int
+rte_acl_inc_rcu_qsbr_add(struct rte_acl_inc *ictx,
+	const struct rte_acl_rcu_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add rules to an incremental ACL context.
+ * Before the first rte_acl_inc_merge() call, the rules are only stored.
+ * After it, they are added to the delta trie set, which is rebuilt, and
+ * are used by rte_acl_inc_classify() once this function returns.
+ * The userdata of each rule identifies it for rte_acl_inc_del_rules(),
+ * and has to be unique and non-zero.
+ * This function can be called concurrently with rte_acl_inc_merge(), but
+ * not with itself or rte_acl_inc_del_rules().
+ *
+ * @param ictx
+ *   Incremental ACL context to add rules to.
+ * @param rules
+ *   Array of rules to add, in the same format as for rte_acl_add_rules().
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOMEM if there is no space in the context for these rules,
+ *     or the delta trie set cannot be built.
+ *   - -EEXIST if a rule with the same userdata is already in the context.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_inc_add_rules(struct rte_acl_inc *ictx,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete rules from an incremental ACL context.
+ * The rules of the main trie set overlapping the deleted ones are added to
+ * the delta trie set, which is rebuilt. The deleted rules are no longer
+ * returned by rte_acl_inc_classify() once this function returns, but keep
+ * their room in the context until the next rte_acl_inc_merge().
+ * This function can be called concurrently with rte_acl_inc_merge(), but
+ * not with itself or rte_acl_inc_add_rules().
+ *
+ * @param ictx
+ *   Incremental ACL context to delete rules from.
+ * @param userdata
+ *   Array of the userdata of the rules to delete.
+ * @param num
+ *   Number of elements in the userdata array.
+ * @return
+ *   - -ENOENT if no rule has one of the userdata.
+ *   - -ENOMEM if the delta trie set cannot be built.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_inc_del_rules(struct rte_acl_inc *ictx, const uint32_t *userdata,
+	uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Rebuild the main trie set of an incremental ACL context from all its
+ * rules, and empty the delta trie set.
+ * The build runs without blocking classification or rule updates, so
+ * this function is meant to be called periodically from a control thread,
+ * e.g. when the delta trie set gets too big. It waits for the readers
+ * registered with the RCU QSBR variable to release the old trie sets.
+ *
+ * @param ictx
+ *   Incremental ACL context to merge.
+ * @return
+ *   - -EBUSY if a merge is already in progress.
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - Negative error code of rte_acl_build() if the build failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_inc_merge(struct rte_acl_inc *ictx);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Perform search for a matching ACL rule for each input data buffer, in
+ * the main and delta trie sets of an incremental ACL context.
+ * Same as rte_acl_classify(), except that the results are the userdata of
+ * the rules matching among all the rules of the context.
+ * With an RCU QSBR variable attached, the calling thread has to be
+ * registered with it and report its quiescent state periodically.
+ *
+ * @param ictx
+ *   Incremental ACL context to search with.
+ * @param data
+ *   Array of pointers to input data buffers to perform search.
+ * @param results
+ *   Array of search results, *categories* results per each input data buffer.
+ * @param num
+ *   Number of elements in the input data buffers array.
+ * @param categories
+ *   Number of maximum possible matches for each input buffer, one possible
+ *   match per category.
+ * @return
+ *   zero on successful completion.
+ *   -EINVAL for incorrect arguments.
+ */
+__rte_experimental
+int
+rte_acl_inc_classify(const struct rte_acl_inc *ictx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get statistics of an incremental ACL context.
+ *
+ * @param ictx
+ *   Incremental ACL context.
+ * @param stats
+ *   Structure to fill with the statistics.
+ * @return
+ *   zero on successful completion.
+ *   -EINVAL for incorrect arguments.
+ */
+__rte_experimental
+int
+rte_acl_inc_get_stats(struct rte_acl_inc *ictx,
+	struct rte_acl_inc_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,513 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+/*
+ * Conversion of the Classic BPF programs built by libpcap, e.g. with
+ * pcap_compile(), into eBPF programs run by the librte_bpf with an rte_mbuf
+ * as argument. The conversion follows the one done by the Linux kernel
+ * for its socket filters.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+
+/* libpcap declares a bpf_validate() function as librte_bpf does */
+#define bpf_validate(f, len) bpf_validate_libpcap(f, len)
+#include <pcap/pcap.h>
+#include <pcap/bpf.h>
+#undef bpf_validate
+
+#include "bpf_impl.h"
+
+/* Classic BPF machine registers mapped to eBPF registers */
+#define CBPF_REG_A	EBPF_REG_0	/* accumulator, LD_ABS/LD_IND result */
+#define CBPF_REG_X	EBPF_REG_7	/* index register */
+#define CBPF_REG_TMP	EBPF_REG_8	/* scratch register */
+#define CBPF_REG_CTX	EBPF_REG_6	/* rte_mbuf, used by LD_ABS/LD_IND */
+#define CBPF_REG_FP	EBPF_REG_10	/* frame pointer, for M[] */
+
+/* Max number of eBPF instructions a Classic BPF instruction converts to */
+#define CBPF_INSN_MAX_EBPF	6
+/* Max number of eBPF instructions of the program prologue */
+#define CBPF_PROLOGUE_MAX	(3 + BPF_MEMWORDS)
+
+/* Offset of the scratch memory word M[k] from the frame pointer */
+static inline int16_t
+cbpf_mem_off(uint32_t k)
+{
+	return -(int16_t)((BPF_MEMWORDS - k) * sizeof(uint32_t));
+}
+
+static inline struct ebpf_insn
+ebpf_insn(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm)
+{
+	struct ebpf_insn ins = {
+		.code = code,
+		.dst_reg = dst,
+		.src_reg = src,
+		.off = off,
+		.imm = imm,
+	};
+
+	return ins;
+}
+
+/*
+ * Conversion context: the conversion is done twice, the first pass only
+ * computes the position of the eBPF instructions of each Classic BPF one,
+ * needed to compute the jump offsets of the second pass.
+ */
+struct cbpf_conv {
+	const struct bpf_insn *cins; /* Classic BPF program */
+	uint32_t nb_cins;
+	uint32_t *pos; /* eBPF position of each Classic BPF instruction */
+	bool *reach; /* Classic BPF instruction is reachable */
+	struct ebpf_insn *ins; /* eBPF program, NULL on first pass */
+	uint32_t nb_ins;
+};
+
+static inline void
+cbpf_emit(struct cbpf_conv *cv, struct ebpf_insn ins)
+{
+	if (cv->ins != NULL)
+		cv->ins[cv->nb_ins] = ins;
+	cv->nb_ins++;
+}
+
+/* Offset of the jump of the next eBPF instruction to Classic BPF target */
+static int
+cbpf_jump_off(struct cbpf_conv *cv, uint32_t idx, uint32_t off, int16_t *joff)
+{
+	uint32_t target = idx + 1 + off;
+	int32_t delta;
+
+	if (target >= cv->nb_cins) {
+		RTE_BPF_LOG(ERR, "%s: jump out of program at %u\n",
+			__func__, idx);
+		return -EINVAL;
+	}
+
+	/* unknown on the first pass, only the instruction count matters */
+	if (cv->ins == NULL) {
+		*joff = 0;
+		return 0;
+	}
+
+	delta = (int32_t)cv->pos[target] - (int32_t)(cv->nb_ins + 1);
+	if (delta < INT16_MIN || delta > INT16_MAX) {
+		RTE_BPF_LOG(ERR, "%s: jump too far at %u\n", __func__, idx);
+		return -E2BIG;
+	}
+	*joff = delta;
+	return 0;
+}
+
+/* Negation of the conditional jumps, 0 if there is none */
+static uint8_t
+cbpf_jmp_negate(uint8_t op)
+{
+	switch (op) {
+	case BPF_JEQ:
+		return EBPF_JNE;
+	case BPF_JGT:
+		return EBPF_JLE;
+	case BPF_JGE:
+		return EBPF_JLT;
+	default:
+		return 0;
+	}
+}
+
+static int
+cbpf_convert_jmp(struct cbpf_conv *cv, uint32_t idx, const struct bpf_insn *ci)
+{
+	uint8_t op = BPF_OP(ci->code);
+	uint8_t src = BPF_K, src_reg = 0;
+	uint32_t imm = ci->k;
+	uint8_t jt = ci->jt, jf = ci->jf;
+	int16_t off;
+	int ret;
+
+	if (op == BPF_JA) {
+		if (ci->k > INT32_MAX)
+			return -EINVAL;
+		ret = cbpf_jump_off(cv, idx, ci->k, &off);
+		if (ret < 0)
+			return ret;
+		cbpf_emit(cv, ebpf_insn(BPF_JMP | BPF_JA, 0, 0, off, 0));
+		return 0;
+	}
+
+	if (op != BPF_JEQ && op != BPF_JGT && op != BPF_JGE && op != BPF_JSET)
+		return -EINVAL;
+
+	/*
+	 * eBPF immediates are sign extended to 64 bits while A is a zero
+	 * extended 32 bits value: compare to a register for the big ones.
+	 */
+	if (BPF_SRC(ci->code) == BPF_X) {
+		src = BPF_X;
+		src_reg = CBPF_REG_X;
+		imm = 0;
+	} else if (ci->k > INT32_MAX) {
+		cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_K,
+				CBPF_REG_TMP, 0, 0, ci->k));
+		src = BPF_X;
+		src_reg = CBPF_REG_TMP;
+		imm = 0;
+	}
+
+	/* jump on false only, with the negated condition when possible */
+	if (jt == 0 && jf != 0 && cbpf_jmp_negate(op) != 0) {
+		ret = cbpf_jump_off(cv, idx, jf, &off);
+		if (ret < 0)
+			return ret;
+		cbpf_emit(cv, ebpf_insn(BPF_JMP | cbpf_jmp_negate(op) | src,
+				CBPF_REG_A, src_reg, off, imm));
+		return 0;
+	}
+
+	ret = cbpf_jump_off(cv, idx, jt, &off);
+	if (ret < 0)
+		return ret;
+	cbpf_emit(cv, ebpf_insn(BPF_JMP | op | src, CBPF_REG_A, src_reg, off,
+			imm));
+
+	if (jf != 0) {
+		ret = cbpf_jump_off(cv, idx, jf, &off);
+		if (ret < 0)
+			return ret;
+		cbpf_emit(cv, ebpf_insn(BPF_JMP | BPF_JA, 0, 0, off, 0));
+	}
+
+	return 0;
+}
+
+static int
+cbpf_convert_insn(struct cbpf_conv *cv, uint32_t idx)
+{
+	const struct bpf_insn *ci = &cv->cins[idx];
+	uint16_t code = ci->code;
+	uint32_t k = ci->k;
+
+	switch (BPF_CLASS(code)) {
+	case BPF_LD:
+		switch (BPF_MODE(code)) {
+		case BPF_ABS:
+		case BPF_IND:
+			/* negative offsets are Linux ancillary data */
+			if (k > INT32_MAX || BPF_SIZE(code) == EBPF_DW)
+				return -EINVAL;
+			/*
+			 * The offset of the eBPF loads is computed on 32 bits,
+			 * return 0 before it can wrap around as Classic BPF
+			 * does for any load out of the packet.
+			 */
+			if (BPF_MODE(code) == BPF_IND) {
+				cbpf_emit(cv, ebpf_insn(BPF_JMP | EBPF_JLE | BPF_K,
+					CBPF_REG_X, 0, 2, INT32_MAX - k));
+				cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_K,
+					CBPF_REG_A, 0, 0, 0));
+				cbpf_emit(cv, ebpf_insn(BPF_JMP | EBPF_EXIT,
+					0, 0, 0, 0));
+			}
+			cbpf_emit(cv, ebpf_insn(code,
+				0, BPF_MODE(code) == BPF_IND ? CBPF_REG_X : 0,
+				0, k));
+			return 0;
+		case BPF_IMM:
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_K,
+				CBPF_REG_A, 0, 0, k));
+			return 0;
+		case BPF_MEM:
+			if (k >= BPF_MEMWORDS)
+				return -EINVAL;
+			cbpf_emit(cv, ebpf_insn(BPF_LDX | BPF_MEM | BPF_W,
+				CBPF_REG_A, CBPF_REG_FP, cbpf_mem_off(k), 0));
+			return 0;
+		case BPF_LEN:
+			cbpf_emit(cv, ebpf_insn(BPF_LDX | BPF_MEM | BPF_W,
+				CBPF_REG_A, CBPF_REG_CTX,
+				offsetof(struct rte_mbuf, pkt_len), 0));
+			return 0;
+		}
+		return -EINVAL;
+
+	case BPF_LDX:
+		switch (BPF_MODE(code)) {
+		case BPF_IMM:
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_K,
+				CBPF_REG_X, 0, 0, k));
+			return 0;
+		case BPF_MEM:
+			if (k >= BPF_MEMWORDS)
+				return -EINVAL;
+			cbpf_emit(cv, ebpf_insn(BPF_LDX | BPF_MEM | BPF_W,
+				CBPF_REG_X, CBPF_REG_FP, cbpf_mem_off(k), 0));
+			return 0;
+		case BPF_LEN:
+			cbpf_emit(cv, ebpf_insn(BPF_LDX | BPF_MEM | BPF_W,
+				CBPF_REG_X, CBPF_REG_CTX,
+				offsetof(struct rte_mbuf, pkt_len), 0));
+			return 0;
+		case BPF_MSH:
+			/* X = 4 * (P[k] & 0xf), A is preserved */
+			if (k > INT32_MAX)
+				return -EINVAL;
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_X,
+				CBPF_REG_TMP, CBPF_REG_A, 0, 0));
+			cbpf_emit(cv, ebpf_insn(BPF_LD | BPF_ABS | BPF_B,
+				0, 0, 0, k));
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | BPF_AND | BPF_K,
+				CBPF_REG_A, 0, 0, 0xf));
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | BPF_LSH | BPF_K,
+				CBPF_REG_A, 0, 0, 2));
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_X,
+				CBPF_REG_X, CBPF_REG_A, 0, 0));
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_X,
+				CBPF_REG_A, CBPF_REG_TMP, 0, 0));
+			return 0;
+		}
+		return -EINVAL;
+
+	case BPF_ST:
+	case BPF_STX:
+		if (k >= BPF_MEMWORDS)
+			return -EINVAL;
+		cbpf_emit(cv, ebpf_insn(BPF_STX | BPF_MEM | BPF_W, CBPF_REG_FP,
+			BPF_CLASS(code) == BPF_ST ? CBPF_REG_A : CBPF_REG_X,
+			cbpf_mem_off(k), 0));
+		return 0;
+
+	case BPF_ALU:
+		switch (BPF_OP(code)) {
+		case BPF_NEG:
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | BPF_NEG,
+				CBPF_REG_A, 0, 0, 0));
+			return 0;
+		case BPF_DIV:
+		case BPF_MOD:
+			if (BPF_SRC(code) == BPF_K && k == 0)
+				return -EINVAL;
+			/* fall-through */
+		case BPF_ADD:
+		case BPF_SUB:
+		case BPF_MUL:
+		case BPF_OR:
+		case BPF_AND:
+		case BPF_LSH:
+		case BPF_RSH:
+		case BPF_XOR:
+			if (BPF_SRC(code) == BPF_X)
+				cbpf_emit(cv, ebpf_insn(code, CBPF_REG_A,
+						CBPF_REG_X, 0, 0));
+			else
+				cbpf_emit(cv, ebpf_insn(code, CBPF_REG_A,
+						0, 0, k));
+			return 0;
+		}
+		return -EINVAL;
+
+	case BPF_JMP:
+		return cbpf_convert_jmp(cv, idx, ci);
+
+	case BPF_RET:
+		switch (BPF_RVAL(code)) {
+		case BPF_K:
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_K,
+				CBPF_REG_A, 0, 0, k));
+			/* fall-through */
+		case BPF_A:
+			cbpf_emit(cv, ebpf_insn(BPF_JMP | EBPF_EXIT, 0, 0, 0, 0));
+			return 0;
+		}
+		return -EINVAL;
+
+	case BPF_MISC:
+		switch (BPF_MISCOP(code)) {
+		case BPF_TAX:
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_X,
+				CBPF_REG_X, CBPF_REG_A, 0, 0));
+			return 0;
+		case BPF_TXA:
+			cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_X,
+				CBPF_REG_A, CBPF_REG_X, 0, 0));
+			return 0;
+		}
+		return -EINVAL;
+	}
+
+	return -EINVAL;
+}
+
+/*
+ * Find the reachable instructions, the verifier does not accept
+ * unreachable eBPF code. Classic BPF only has forward jumps.
+ */
+static int
+cbpf_reachable(struct cbpf_conv *cv)
+{
+	const struct bpf_insn *ci;
+	uint32_t i, next[2], nb_next, j;
+
+	memset(cv->reach, 0, cv->nb_cins * sizeof(cv->reach[0]));
+	cv->reach[0] = true;
+
+	for (i = 0; i != cv->nb_cins; i++) {
+		if (!cv->reach[i])
+			continue;
+
+		ci = &cv->cins[i];
+		nb_next = 0;
+		if (BPF_CLASS(ci->code) == BPF_RET) {
+			continue;
+		} else if (BPF_CLASS(ci->code) != BPF_JMP) {
+			next[nb_next++] = i + 1;
+		} else if (BPF_OP(ci->code) == BPF_JA) {
+			if (ci->k >= cv->nb_cins)
+				return -EINVAL;
+			next[nb_next++] = i + 1 + ci->k;
+		} else {
+			next[nb_next++] = i + 1 + ci->jt;
+			next[nb_next++] = i + 1 + ci->jf;
+		}
+
+		for (j = 0; j != nb_next; j++) {
+			if (next[j] >= cv->nb_cins) {
+				RTE_BPF_LOG(ERR, "%s: no return at %u\n",
+					__func__, i);
+				return -EINVAL;
+			}
+			cv->reach[next[j]] = true;
+		}
+	}
+
+	return 0;
+}
+
+static int
+cbpf_convert(struct cbpf_conv *cv)
+{
+	uint32_t i, mem = 0;
+	int ret;
+
+	cv->nb_ins = 0;
+
+	/* keep the mbuf for LD_ABS/LD_IND, A and X start at 0 */
+	cbpf_emit(cv, ebpf_insn(EBPF_ALU64 | EBPF_MOV | BPF_X,
+			CBPF_REG_CTX, EBPF_REG_1, 0, 0));
+	cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_K,
+			CBPF_REG_A, 0, 0, 0));
+	cbpf_emit(cv, ebpf_insn(BPF_ALU | EBPF_MOV | BPF_K,
+			CBPF_REG_X, 0, 0, 0));
+
+	/*
+	 * The scratch memory words start at 0 too, the verifier does not
+	 * accept loads of uninitialized stack.
+	 */
+	for (i = 0; i != cv->nb_cins; i++) {
+		uint16_t code = cv->cins[i].code;
+
+		if (cv->reach[i] && (BPF_CLASS(code) == BPF_LD ||
+				BPF_CLASS(code) == BPF_LDX) &&
+		    BPF_MODE(code) == BPF_MEM && cv->cins[i].k < BPF_MEMWORDS)
+			mem |= 1 << cv->cins[i].k;
+	}
+	for (i = 0; i != BPF_MEMWORDS; i++) {
+		if (mem & (1 << i))
+			cbpf_emit(cv, ebpf_insn(BPF_ST | BPF_MEM | BPF_W,
+				CBPF_REG_FP, 0, cbpf_mem_off(i), 0));
+	}
+
+	for (i = 0; i != cv->nb_cins; i++) {
+		cv->pos[i] = cv->nb_ins;
+		if (!cv->reach[i])
+			continue;
+		ret = cbpf_convert_insn(cv, i);
+		if (ret < 0) {
+			RTE_BPF_LOG(ERR,
+				"%s: cannot convert instruction %u: code 0x%x k 0x%x\n",
+				__func__, i, cv->cins[i].code, cv->cins[i].k);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+struct rte_bpf_prm *
+rte_bpf_convert(const struct bpf_program *prog)
+{
+	struct rte_bpf_prm *prm = NULL;
+	struct cbpf_conv cv;
+	int ret;
+
+	if (prog == NULL || prog->bf_insns == NULL || prog->bf_len == 0 ||
+	    prog->bf_len > BPF_MAXINSNS) {
+		RTE_BPF_LOG(ERR, "%s: invalid program\n", __func__);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	memset(&cv, 0, sizeof(cv));
+	cv.cins = prog->bf_insns;
+	cv.nb_cins = prog->bf_len;
+	cv.pos = malloc(cv.nb_cins * sizeof(cv.pos[0]));
+	cv.reach = malloc(cv.nb_cins * sizeof(cv.reach[0]));
+	if (cv.pos == NULL || cv.reach == NULL) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	ret = cbpf_reachable(&cv);
+	if (ret < 0)
+		goto error;
+
+	/* first pass to get the positions and the size of the program */
+	ret = cbpf_convert(&cv);
+	if (ret < 0)
+		goto error;
+	RTE_VERIFY(cv.nb_ins <= CBPF_PROLOGUE_MAX +
+			cv.nb_cins * CBPF_INSN_MAX_EBPF);
+
+	/* the instructions follow the parameters, in shared memory */
+	prm = rte_zmalloc("bpf_prm", sizeof(*prm) +
+			cv.nb_ins * sizeof(struct ebpf_insn), 0);
+	if (prm == NULL) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	cv.ins = (struct ebpf_insn *)(prm + 1);
+	ret = cbpf_convert(&cv);
+	if (ret < 0)
+		goto error;
+
+	prm->ins = cv.ins;
+	prm->nb_ins = cv.nb_ins;
+	prm->prog_arg.type = RTE_BPF_ARG_PTR_MBUF;
+	prm->prog_arg.size = sizeof(struct rte_mbuf);
+	prm->prog_arg.buf_size = RTE_MBUF_DEFAULT_BUF_SIZE;
+
+	free(cv.reach);
+	free(cv.pos);
+	return prm;
+
+error:
+	rte_free(prm);
+	free(cv.reach);
+	free(cv.pos);
+	rte_errno = -ret;
+	return NULL;
+}
@@ -112,6 +112,7 @@ struct bpf_jit_state {
 		uint32_t stack_ofs;
 	} ldmb;
 	uint32_t reguse;
+	uint32_t nb_moved; /* instructions moved since the previous run */
 	int32_t *off;
 	uint8_t *ins;
 };
@@ -715,7 +716,7 @@ emit_abs_jmp(struct bpf_jit_state *st, int32_t ofs)
 	const int32_t iszm = RTE_MAX(sz8, sz32);
 
 	joff = ofs - st->sz;
-	imsz = RTE_MAX(imm_size(joff), imm_size(joff + iszm));
+	imsz = RTE_MAX(imm_size(joff), imm_size(joff - iszm));
 
 	if (imsz == 1) {
 		emit_bytes(st, &op8, sizeof(op8));
@@ -833,7 +834,7 @@ emit_abs_jcc(struct bpf_jit_state *st, uint32_t op, int32_t ofs)
 	const int32_t iszm = RTE_MAX(sz8, sz32);
 
 	joff = ofs - st->sz;
-	imsz = RTE_MAX(imm_size(joff), imm_size(joff + iszm));
+	imsz = RTE_MAX(imm_size(joff), imm_size(joff - iszm));
 
 	bop = GET_BPF_OP(op);
 
@@ -903,7 +904,7 @@ emit_tst_imm(struct bpf_jit_state *st, uint32_t op, uint32_t dreg, uint32_t imm)
 	emit_rex(st, op, 0, dreg);
 	emit_bytes(st, &ops, sizeof(ops));
 	emit_modregrm(st, MOD_DIRECT, mods, dreg);
-	emit_imm(st, imm, imm_size(imm));
+	emit_imm(st, imm, sizeof(imm));
 }
 
 static void
@@ -1292,6 +1293,7 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 	/* reset state fields */
 	st->sz = 0;
 	st->exit.num = 0;
+	st->nb_moved = 0;
 	st->ldmb.stack_ofs = bpf->stack_sz;
 
 	emit_prolog(st, bpf->stack_sz);
@@ -1299,6 +1301,7 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 	for (i = 0; i != bpf->prm.nb_ins; i++) {
 
 		st->idx = i;
+		st->nb_moved += (st->off[i] != (int32_t)st->sz);
 		st->off[i] = st->sz;
 
 		ins = bpf->prm.ins + i;
@@ -1515,12 +1518,14 @@ bpf_jit_x86(struct rte_bpf *bpf)
 
 	/*
 	 * dry runs, used to calculate total code size and valid jump offsets.
-	 * stop when we get minimal possible size
+	 * stop when we get minimal possible size and no instruction moved:
+	 * the total size can stay the same while a jump shrinks and another
+	 * one grows.
 	 */
 	do {
 		sz = st.sz;
 		rc = emit(&st, bpf);
-	} while (rc == 0 && sz != st.sz);
+	} while (rc == 0 && (sz != st.sz || st.nb_moved != 0));
 
 	if (rc == 0) {
 
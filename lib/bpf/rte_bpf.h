@@ -198,6 +198,37 @@ rte_bpf_exec_burst(const struct rte_bpf *bpf, void *ctx[], uint64_t rc[],
 int
 rte_bpf_get_jit(const struct rte_bpf *bpf, struct rte_bpf_jit *jit);
 
+#ifdef RTE_PORT_PCAP
+
+struct bpf_program;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Convert a Classic BPF program from libpcap, e.g. built by pcap_compile(),
+ * into the parameters to load it as an eBPF program taking an rte_mbuf as
+ * argument.
+ * The parameters and the eBPF instructions are allocated with rte_malloc(),
+ * so that they can be passed to another process.
+ *
+ * @param prog
+ *   Classic BPF program to convert. The Linux specific ancillary data
+ *   loads (negative offsets) are not supported.
+ * @return
+ *   Parameters to pass to rte_bpf_load(), to free with rte_free(),
+ *   or NULL on error, with error code set in rte_errno.
+ *   Possible rte_errno errors include:
+ *   - EINVAL - invalid or unsupported program
+ *   - E2BIG - program too big once converted
+ *   - ENOMEM - can't reserve enough memory
+ */
+__rte_experimental
+struct rte_bpf_prm *
+rte_bpf_convert(const struct bpf_program *prog);
+
+#endif /* RTE_PORT_PCAP */
+
 #ifdef __cplusplus
 }
 #endif
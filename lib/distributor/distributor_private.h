@@ -66,6 +66,18 @@ union rte_distributor_buffer_single {
  */
 #define RTE_DIST_BURST_SIZE 8
 
+/*
+ * Number of entries of the flow table of RTE_DIST_ALG_BURST_STICKY, one per
+ * flow tag, which always has its lowest bit set.
+ */
+#define RTE_DIST_FLOW_TABLE_SIZE (1 << 15)
+
+/*
+ * Maximum number of flows moved away from a busy worker in a call to
+ * rte_distributor_process() in RTE_DIST_ALG_BURST_STICKY mode.
+ */
+#define RTE_DIST_STICKY_MAX_MOVES 8
+
 struct rte_distributor_backlog {
 	unsigned int start;
 	unsigned int count;
@@ -105,6 +117,8 @@ struct rte_distributor_single {
 enum rte_distributor_match_function {
 	RTE_DIST_MATCH_SCALAR = 0,
 	RTE_DIST_MATCH_VECTOR,
+	RTE_DIST_MATCH_AVX2,
+	RTE_DIST_MATCH_AVX512,
 	RTE_DIST_NUM_MATCH_FNS
 };
 
@@ -158,6 +172,12 @@ struct rte_distributor {
 
 	uint8_t active[RTE_DISTRIB_MAX_WORKERS];
 	uint8_t activesum;
+
+	/**
+	 * Worker ID (+1) each flow is pinned to in RTE_DIST_ALG_BURST_STICKY
+	 * mode, indexed by flow tag >> 1. Zero if not assigned yet.
+	 */
+	uint8_t flow_table[RTE_DIST_FLOW_TABLE_SIZE] __rte_cache_aligned;
 };
 
 void
@@ -170,6 +190,16 @@ find_match_vec(struct rte_distributor *d,
 			uint16_t *data_ptr,
 			uint16_t *output_ptr);
 
+void
+find_match_avx2(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr);
+
+void
+find_match_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr);
+
 #ifdef __cplusplus
 }
 #endif
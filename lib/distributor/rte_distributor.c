@@ -15,6 +15,7 @@
 #include <rte_pause.h>
 #include <rte_tailq.h>
 #include <rte_vect.h>
+#include <rte_cpuflags.h>
 
 #include "rte_distributor.h"
 #include "rte_distributor_single.h"
@@ -438,6 +439,57 @@ release(struct rte_distributor *d, unsigned int wkr)
 }
 
 
+/*
+ * Return the worker ID (+1) a flow is pinned to in RTE_DIST_ALG_BURST_STICKY
+ * mode, or zero to have it assigned by round robin. A flow is moved to the
+ * least loaded worker when its worker is still busy with a full backlog, and
+ * none of its packets is in flight or in the backlog of that worker, so that
+ * the packets of a flow are never processed at the same time.
+ */
+static inline uint16_t
+find_match_sticky(struct rte_distributor *d, uint16_t tag,
+		unsigned int *moves)
+{
+	uint8_t *entry = &d->flow_table[tag >> 1];
+	unsigned int wid = *entry, w, load, min_load, min_wid;
+
+	if (wid == 0 || !d->active[wid - 1])
+		return 0;
+	wid--;
+
+	if (likely(d->backlog[wid].count < RTE_DIST_BURST_SIZE ||
+			*moves == 0 ||
+			(__atomic_load_n(&(d->bufs[wid].bufptr64[0]),
+				__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF)))
+		return wid + 1;
+
+	for (w = 0; w < RTE_DIST_BURST_SIZE * 2; w++)
+		if (d->in_flight_tags[wid][w] == tag)
+			return wid + 1;
+
+	/* worker waiting for packets counts as having an empty burst */
+	min_wid = wid;
+	min_load = RTE_DIST_BURST_SIZE * 2;
+	for (w = 0; w < d->num_workers; w++) {
+		if (!d->active[w])
+			continue;
+		load = d->backlog[w].count;
+		if (!(__atomic_load_n(&(d->bufs[w].bufptr64[0]),
+				__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF))
+			load += RTE_DIST_BURST_SIZE;
+		if (load < min_load) {
+			min_load = load;
+			min_wid = w;
+		}
+	}
+
+	if (min_wid != wid) {
+		(*moves)--;
+		*entry = min_wid + 1;
+	}
+	return min_wid + 1;
+}
+
 /* process a set of packets to distribute them to workers */
 int
 rte_distributor_process(struct rte_distributor *d,
@@ -450,6 +502,8 @@ rte_distributor_process(struct rte_distributor *d,
 	uint16_t new_tag = 0;
 	uint16_t flows[RTE_DIST_BURST_SIZE] __rte_cache_aligned;
 	unsigned int i, j, w, wid, matching_required;
+	unsigned int moves = RTE_DIST_STICKY_MAX_MOVES;
+	int sticky;
 
 	if (d->alg_type == RTE_DIST_ALG_SINGLE) {
 		/* Call the old API */
@@ -477,6 +531,8 @@ rte_distributor_process(struct rte_distributor *d,
 	if (unlikely(!d->activesum))
 		return 0;
 
+	sticky = (d->alg_type == RTE_DIST_ALG_BURST_STICKY);
+
 	while (next_idx < num_mbufs) {
 		uint16_t matches[RTE_DIST_BURST_SIZE];
 		unsigned int pkts;
@@ -502,12 +558,24 @@ rte_distributor_process(struct rte_distributor *d,
 			if (unlikely(!d->activesum))
 				return next_idx;
 
-			if (unlikely(matching_required)) {
+			if (unlikely(matching_required) && !sticky) {
 				switch (d->dist_match_fn) {
 				case RTE_DIST_MATCH_VECTOR:
 					find_match_vec(d, &flows[0],
 						&matches[0]);
 					break;
+#ifdef CC_DIST_AVX2_SUPPORT
+				case RTE_DIST_MATCH_AVX2:
+					find_match_avx2(d, &flows[0],
+						&matches[0]);
+					break;
+#endif
+#ifdef CC_DIST_AVX512_SUPPORT
+				case RTE_DIST_MATCH_AVX512:
+					find_match_avx512(d, &flows[0],
+						&matches[0]);
+					break;
+#endif
 				default:
 					find_match_scalar(d, &flows[0],
 						&matches[0]);
@@ -539,6 +607,11 @@ rte_distributor_process(struct rte_distributor *d,
 			 */
 			/* matches[j] = 0; */
 
+			/* Sticky flows are looked up as they are distributed */
+			if (sticky)
+				matches[j] = find_match_sticky(d, new_tag,
+						&moves);
+
 			if (matches[j] && d->active[matches[j]-1]) {
 				struct rte_distributor_backlog *bl =
 						&d->backlog[matches[j]-1];
@@ -582,6 +655,8 @@ rte_distributor_process(struct rte_distributor *d,
 
 				bl->tags[idx] = new_tag;
 				bl->pkts[idx] = next_value;
+				if (sticky)
+					d->flow_table[new_tag >> 1] = wkr + 1;
 				/*
 				 * Now that we've just added an unpinned flow
 				 * to a worker, we need to ensure that all
@@ -766,6 +841,17 @@ rte_distributor_create(const char *name,
 	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_128)
 		d->dist_match_fn = RTE_DIST_MATCH_VECTOR;
 #endif
+#ifdef CC_DIST_AVX2_SUPPORT
+	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+		d->dist_match_fn = RTE_DIST_MATCH_AVX2;
+#endif
+#ifdef CC_DIST_AVX512_SUPPORT
+	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		d->dist_match_fn = RTE_DIST_MATCH_AVX512;
+#endif
 
 	/*
 	 * Set up the backlog tags so they're pointing at the second cache
@@ -776,6 +862,7 @@ rte_distributor_create(const char *name,
 
 	memset(d->active, 0, sizeof(d->active));
 	d->activesum = 0;
+	memset(d->flow_table, 0, sizeof(d->flow_table));
 
 	dist_burst_list = RTE_TAILQ_CAST(rte_dist_burst_tailq.head,
 					  rte_dist_burst_list);
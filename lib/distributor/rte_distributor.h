@@ -17,11 +17,20 @@
 extern "C" {
 #endif
 
-/* Type of distribution (burst/single) */
+/* Type of distribution (burst/single/burst sticky) */
 enum rte_distributor_alg_type {
 	RTE_DIST_ALG_BURST = 0,
 	RTE_DIST_ALG_SINGLE,
-	RTE_DIST_NUM_ALG_TYPES
+	RTE_DIST_NUM_ALG_TYPES,
+	/**
+	 * Burst API, where each flow stays on the worker it was first given
+	 * to, instead of being matched against the tags in flight on all the
+	 * workers. A flow is only moved, to the least loaded worker, when its
+	 * worker is busy and has no packet of the flow in flight or in its
+	 * backlog. Only a few flows are moved per rte_distributor_process().
+	 * Added after RTE_DIST_NUM_ALG_TYPES to keep its value.
+	 */
+	RTE_DIST_ALG_BURST_STICKY = RTE_DIST_NUM_ALG_TYPES + 1
 };
 
 struct rte_distributor;
@@ -44,6 +53,8 @@ struct rte_mbuf;
  *   Call the legacy API, or use the new burst API. legacy uses 32-bit
  *   flow ID, and works on a single packet at a time. Latest uses 15-
  *   bit flow ID and works on up to 8 packets at a time to workers.
+ *   RTE_DIST_ALG_BURST_STICKY uses the burst API with flows pinned to
+ *   workers.
  * @return
  *   The newly created distributor instance
  */
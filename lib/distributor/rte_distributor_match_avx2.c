@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_mbuf.h>
+#include <rte_vect.h>
+#include "rte_distributor.h"
+#include "distributor_private.h"
+
+void
+find_match_avx2(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	__m256i incoming_fids[RTE_DIST_BURST_SIZE];
+	__m256i worker_fids;
+	__m256i mask;
+	uint16_t i, j;
+
+	/*
+	 * Function overview:
+	 * 1. Broadcast each incoming flow ID into its own ymm reg
+	 * 2. Loop through all worker ID's
+	 *  2a. Load the inflights and backlog of the worker, which are
+	 *      contiguous, into a single ymm reg
+	 *  2b. Compare them to all incoming flow IDs, and skip the worker if
+	 *      none of them matches, as most workers will not
+	 *  2c. Otherwise store the worker ID for each matching flow ID
+	 */
+
+	for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+		incoming_fids[j] = _mm256_set1_epi16(data_ptr[j]);
+		output_ptr[j] = 0;
+	}
+
+	for (i = 0; i < d->num_workers; i++) {
+		worker_fids = _mm256_load_si256(
+				(const __m256i *)d->in_flight_tags[i]);
+
+		mask = _mm256_cmpeq_epi16(worker_fids, incoming_fids[0]);
+		for (j = 1; j < RTE_DIST_BURST_SIZE; j++)
+			mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(
+					worker_fids, incoming_fids[j]));
+		if (likely(_mm256_testz_si256(mask, mask)))
+			continue;
+
+		for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+			mask = _mm256_cmpeq_epi16(worker_fids,
+					incoming_fids[j]);
+			if (!_mm256_testz_si256(mask, mask))
+				output_ptr[j] = i + 1;
+		}
+	}
+}
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_mbuf.h>
+#include <rte_vect.h>
+#include "rte_distributor.h"
+#include "distributor_private.h"
+
+/* flow IDs of a worker, inflights and backlog, in a 512-bit register */
+#define WORKER_FIDS_MASK ((1u << (RTE_DIST_BURST_SIZE * 2)) - 1)
+
+void
+find_match_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	__m512i incoming_fids[RTE_DIST_BURST_SIZE];
+	__m512i worker_fids;
+	__mmask32 matches[RTE_DIST_BURST_SIZE];
+	__mmask32 any, valid;
+	unsigned int i, j;
+
+	/*
+	 * Function overview:
+	 * 1. Broadcast each incoming flow ID into its own zmm reg
+	 * 2. Loop through the worker ID's two at a time
+	 *  2a. Load the inflights and backlogs of both workers, which are
+	 *      contiguous, into a single zmm reg
+	 *  2b. Compare them to all incoming flow IDs into masks, and skip the
+	 *      workers if none of them matches, as most workers will not
+	 *  2c. Otherwise store the worker ID for each matching flow ID, from
+	 *      the low half of the mask for the first worker and the high
+	 *      half for the second one
+	 */
+
+	for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+		incoming_fids[j] = _mm512_set1_epi16(data_ptr[j]);
+		output_ptr[j] = 0;
+	}
+
+	for (i = 0; i < d->num_workers; i += 2) {
+		worker_fids = _mm512_load_si512(d->in_flight_tags[i]);
+
+		/* ignore the second worker past the last one */
+		valid = (i + 1 < d->num_workers) ? UINT32_MAX :
+				WORKER_FIDS_MASK;
+		any = 0;
+		for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+			matches[j] = _mm512_mask_cmpeq_epi16_mask(valid,
+					worker_fids, incoming_fids[j]);
+			any |= matches[j];
+		}
+		if (likely(any == 0))
+			continue;
+
+		for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+			if (matches[j] & WORKER_FIDS_MASK)
+				output_ptr[j] = i + 1;
+			if (matches[j] & ~WORKER_FIDS_MASK)
+				output_ptr[j] = i + 2;
+		}
+	}
+}
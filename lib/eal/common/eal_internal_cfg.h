@@ -72,6 +72,8 @@ struct internal_config {
 	 */
 	volatile unsigned match_allocations;
 	/**< true to free hugepages exactly as allocated */
+	unsigned int malloc_cache;
+	/**< true to enable the per-lcore caches of small malloc objects */
 	volatile unsigned single_file_segments;
 	/**< true if storing all pages within single files (per-page-size,
 	 * per-node) non-legacy mode only.
@@ -0,0 +1,342 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_eal.h>
+#include <rte_eal_memconfig.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <rte_telemetry.h>
+#endif
+
+#include "eal_internal_cfg.h"
+#include "eal_memcfg.h"
+#include "eal_private.h"
+#include "malloc_cache.h"
+#include "malloc_elem.h"
+#include "malloc_heap.h"
+
+/*
+ * Per-lcore caches of small objects in front of the heaps.
+ *
+ * Each lcore keeps, for each size class, a stack of objects allocated from
+ * the heap of its socket. The objects stay allocated from the heap point of
+ * view while they are in a cache, so that the caches are only accessed by
+ * their lcore and need no locking. Their state is ELEM_CACHED instead of
+ * ELEM_BUSY, so that freeing them again is detected. A cache is refilled
+ * from, and flushed to, the heap MALLOC_CACHE_BULK objects at a time.
+ */
+
+struct malloc_cache_class {
+	unsigned int len;
+	void *objs[MALLOC_CACHE_SIZE];
+};
+
+struct malloc_lcore_cache {
+	int socket_id; /**< Socket of the cached objects, -1 if unused */
+	int heap_id; /**< Heap of the cached objects */
+	struct malloc_cache_class classes[MALLOC_CACHE_NUM_CLASSES];
+	uint64_t allocs;
+	uint64_t frees;
+	uint64_t refills;
+	uint64_t flushes;
+} __rte_cache_aligned;
+
+static struct malloc_lcore_cache malloc_caches[RTE_MAX_LCORE];
+static bool malloc_cache_enabled;
+
+static inline size_t
+malloc_cache_class_size(unsigned int idx)
+{
+	return (size_t)RTE_CACHE_LINE_SIZE << idx;
+}
+
+/* Size class of an allocation, -1 if too big to be cached */
+static inline int
+malloc_cache_class_idx(size_t size)
+{
+	if (size > malloc_cache_class_size(MALLOC_CACHE_NUM_CLASSES - 1))
+		return -1;
+
+	return rte_log2_u32(RTE_MAX(size, (size_t)RTE_CACHE_LINE_SIZE)) -
+		rte_log2_u32(RTE_CACHE_LINE_SIZE);
+}
+
+/* Element of a cached object, which has no padding */
+static inline struct malloc_elem *
+malloc_cache_elem(void *obj)
+{
+	return RTE_PTR_SUB(obj, MALLOC_ELEM_HEADER_LEN);
+}
+
+/* Give back the oldest n objects of a size class to the heap */
+static void
+malloc_cache_class_flush(struct malloc_cache_class *cls, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		struct malloc_elem *elem = malloc_cache_elem(cls->objs[i]);
+
+		elem->state = ELEM_BUSY;
+		malloc_heap_free(elem);
+	}
+
+	cls->len -= n;
+	memmove(cls->objs, &cls->objs[n], cls->len * sizeof(cls->objs[0]));
+}
+
+static void
+malloc_cache_flush(struct malloc_lcore_cache *cache)
+{
+	unsigned int i;
+
+	for (i = 0; i < MALLOC_CACHE_NUM_CLASSES; i++) {
+		struct malloc_cache_class *cls = &cache->classes[i];
+
+		if (cls->len != 0) {
+			malloc_cache_class_flush(cls, cls->len);
+			cache->flushes++;
+		}
+	}
+}
+
+/*
+ * Get the cache of an lcore, set up for the socket of the calling thread.
+ * Return NULL if there is no heap for this socket.
+ */
+static inline struct malloc_lcore_cache *
+malloc_cache_get(unsigned int lcore_id)
+{
+	struct malloc_lcore_cache *cache = &malloc_caches[lcore_id];
+	int socket_id = malloc_get_numa_socket();
+
+	/* the lcore ID may have been reused by a thread on another socket */
+	if (unlikely(cache->socket_id != socket_id)) {
+		malloc_cache_flush(cache);
+		cache->socket_id = socket_id;
+		cache->heap_id = malloc_socket_to_heap_id(socket_id);
+	}
+
+	return cache->heap_id < 0 ? NULL : cache;
+}
+
+/*
+ * Allocate an object from the cache of the calling lcore. Return NULL if the
+ * allocation has to be done from the heap.
+ */
+void *
+malloc_cache_alloc(size_t size, int socket_arg)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct malloc_lcore_cache *cache;
+	struct malloc_cache_class *cls;
+	unsigned int i;
+	void *data;
+	int idx;
+
+	if (!malloc_cache_enabled || lcore_id >= RTE_MAX_LCORE)
+		return NULL;
+
+	idx = malloc_cache_class_idx(size);
+	if (idx < 0)
+		return NULL;
+
+	cache = malloc_cache_get(lcore_id);
+	if (cache == NULL ||
+	    (socket_arg != SOCKET_ID_ANY && socket_arg != cache->socket_id))
+		return NULL;
+
+	cls = &cache->classes[idx];
+	if (cls->len == 0) {
+		cls->len = malloc_heap_alloc_bulk(cache->heap_id,
+				malloc_cache_class_size(idx), cls->objs,
+				MALLOC_CACHE_BULK);
+		if (cls->len == 0)
+			return NULL;
+		for (i = 0; i < cls->len; i++)
+			malloc_cache_elem(cls->objs[i])->state = ELEM_CACHED;
+		cache->refills++;
+	}
+
+	cache->allocs++;
+	data = cls->objs[--cls->len];
+	malloc_cache_elem(data)->state = ELEM_BUSY;
+	return data;
+}
+
+/*
+ * Put an object in the cache of the calling lcore. Return -1 if the object
+ * has to be freed to the heap.
+ */
+int
+malloc_cache_free(struct malloc_elem *elem)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_mem_config *mcfg;
+	struct malloc_lcore_cache *cache;
+	struct malloc_cache_class *cls;
+	size_t size;
+	void *data;
+	int idx;
+
+	/* the double and invalid frees are reported by the heap */
+	if (!malloc_cache_enabled || lcore_id >= RTE_MAX_LCORE ||
+	    !malloc_elem_cookies_ok(elem) || elem->state != ELEM_BUSY ||
+	    elem->pad != 0)
+		return -1;
+
+	/* only the objects of the exact size of a class can be cached */
+	size = elem->size - MALLOC_ELEM_OVERHEAD;
+	idx = malloc_cache_class_idx(size);
+	if (idx < 0 || malloc_cache_class_size(idx) != size)
+		return -1;
+
+	cache = malloc_cache_get(lcore_id);
+	mcfg = rte_eal_get_configuration()->mem_config;
+	if (cache == NULL || elem->heap != &mcfg->malloc_heaps[cache->heap_id])
+		return -1;
+
+	cls = &cache->classes[idx];
+	if (cls->len == MALLOC_CACHE_SIZE) {
+		malloc_cache_class_flush(cls, MALLOC_CACHE_BULK);
+		cache->flushes++;
+	}
+
+	/* memory returned by rte_malloc is expected to be zeroed, as after a
+	 * free to the heap
+	 */
+	data = RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN);
+	memset(data, 0, size);
+
+	elem->state = ELEM_CACHED;
+	cls->objs[cls->len++] = data;
+	cache->frees++;
+	return 0;
+}
+
+void
+rte_malloc_cache_flush(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (!malloc_cache_enabled || lcore_id >= RTE_MAX_LCORE)
+		return;
+
+	malloc_cache_flush(&malloc_caches[lcore_id]);
+}
+
+int
+rte_malloc_cache_stats_get(unsigned int lcore_id,
+		struct rte_malloc_cache_stats *stats)
+{
+	const struct malloc_lcore_cache *cache;
+	unsigned int i;
+
+	if (lcore_id >= RTE_MAX_LCORE || stats == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+	if (!malloc_cache_enabled) {
+		rte_errno = ENOTSUP;
+		return -1;
+	}
+
+	cache = &malloc_caches[lcore_id];
+	memset(stats, 0, sizeof(*stats));
+	stats->alloc_count = cache->allocs;
+	stats->free_count = cache->frees;
+	stats->refill_count = cache->refills;
+	stats->flush_count = cache->flushes;
+	for (i = 0; i < MALLOC_CACHE_NUM_CLASSES; i++) {
+		unsigned int len = cache->classes[i].len;
+
+		stats->cached_count += len;
+		stats->cached_bytes += len * malloc_cache_class_size(i);
+	}
+
+	return 0;
+}
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+
+#define EAL_MALLOC_CACHE_STATS_REQ "/eal/malloc_cache_stats"
+
+/* callback handler for telemetry library to report the lcore caches stats */
+static int
+handle_malloc_cache_stats(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_malloc_cache_stats stats, total;
+	unsigned int lcore_id, first, last;
+	char *end;
+
+	if (!malloc_cache_enabled)
+		return -ENOTSUP;
+
+	if (params != NULL && params[0] != '\0') {
+		lcore_id = strtoul(params, &end, 0);
+		if (*end != '\0' || lcore_id >= RTE_MAX_LCORE)
+			return -EINVAL;
+		first = last = lcore_id;
+	} else {
+		first = 0;
+		last = RTE_MAX_LCORE - 1;
+	}
+
+	memset(&total, 0, sizeof(total));
+	for (lcore_id = first; lcore_id <= last; lcore_id++) {
+		rte_malloc_cache_stats_get(lcore_id, &stats);
+		total.alloc_count += stats.alloc_count;
+		total.free_count += stats.free_count;
+		total.refill_count += stats.refill_count;
+		total.flush_count += stats.flush_count;
+		total.cached_count += stats.cached_count;
+		total.cached_bytes += stats.cached_bytes;
+	}
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_u64(d, "alloc_count", total.alloc_count);
+	rte_tel_data_add_dict_u64(d, "free_count", total.free_count);
+	rte_tel_data_add_dict_u64(d, "refill_count", total.refill_count);
+	rte_tel_data_add_dict_u64(d, "flush_count", total.flush_count);
+	rte_tel_data_add_dict_u64(d, "cached_count", total.cached_count);
+	rte_tel_data_add_dict_u64(d, "cached_bytes", total.cached_bytes);
+	return 0;
+}
+
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+int
+malloc_cache_init(void)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	unsigned int i;
+
+	if (!internal_conf->malloc_cache)
+		return 0;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		malloc_caches[i].socket_id = -1;
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+	rte_telemetry_register_cmd(EAL_MALLOC_CACHE_STATS_REQ,
+			handle_malloc_cache_stats,
+			"Returns malloc lcore caches stats. Parameters: int lcore_id (optional)");
+#endif
+
+	malloc_cache_enabled = true;
+	RTE_LOG(DEBUG, EAL, "Per-lcore malloc caches enabled\n");
+	return 0;
+}
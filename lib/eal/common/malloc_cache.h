@@ -0,0 +1,39 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef MALLOC_CACHE_H_
+#define MALLOC_CACHE_H_
+
+#include <stddef.h>
+
+#include <rte_common.h>
+
+/* Number of size classes, from RTE_CACHE_LINE_SIZE doubling up to 32 lines */
+#define MALLOC_CACHE_NUM_CLASSES 6
+/* Max number of objects of a size class held by an lcore cache */
+#define MALLOC_CACHE_SIZE 32
+/* Number of objects moved between an lcore cache and the heap at once */
+#define MALLOC_CACHE_BULK (MALLOC_CACHE_SIZE / 2)
+
+/* dummy definition, for pointers */
+struct malloc_elem;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void *
+malloc_cache_alloc(size_t size, int socket_arg);
+
+int
+malloc_cache_free(struct malloc_elem *elem);
+
+int
+malloc_cache_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MALLOC_CACHE_H_ */
@@ -15,7 +15,8 @@ struct malloc_heap;
 enum elem_state {
 	ELEM_FREE = 0,
 	ELEM_BUSY,
-	ELEM_PAD  /* element is a padding-only header */
+	ELEM_PAD, /* element is a padding-only header */
+	ELEM_CACHED /* element is busy in the heap, held by a malloc cache */
 };
 
 struct malloc_elem {
@@ -28,6 +28,7 @@
 #include "eal_memalloc.h"
 #include "eal_memcfg.h"
 #include "eal_private.h"
+#include "malloc_cache.h"
 #include "malloc_elem.h"
 #include "malloc_heap.h"
 #include "malloc_mp.h"
@@ -738,6 +739,36 @@ malloc_heap_alloc(const char *type, size_t size, int socket_arg,
 	return NULL;
 }
 
+/*
+ * Allocate up to n objects of the same size from a heap, taking the heap
+ * lock once. The heap is only expanded when no object can be allocated.
+ */
+unsigned int
+malloc_heap_alloc_bulk(unsigned int heap_id, size_t size, void **objs,
+		unsigned int n)
+{
+	struct rte_mem_config *mcfg = rte_eal_get_configuration()->mem_config;
+	struct malloc_heap *heap = &mcfg->malloc_heaps[heap_id];
+	unsigned int i;
+
+	rte_spinlock_lock(&(heap->lock));
+	for (i = 0; i < n; i++) {
+		objs[i] = heap_alloc(heap, NULL, size, 0, 1, 0, false);
+		if (objs[i] == NULL)
+			break;
+	}
+	rte_spinlock_unlock(&(heap->lock));
+
+	if (i == 0 && n != 0) {
+		objs[0] = malloc_heap_alloc_on_heap_id(NULL, size, heap_id, 0,
+				1, 0, false);
+		if (objs[0] != NULL)
+			i = 1;
+	}
+
+	return i;
+}
+
 static void *
 heap_alloc_biggest_on_heap_id(const char *type, unsigned int heap_id,
 		unsigned int flags, size_t align, bool contig)
@@ -1364,6 +1395,9 @@ rte_eal_malloc_heap_init(void)
 	 */
 	rte_mcfg_mem_read_unlock();
 
+	if (malloc_cache_init() < 0)
+		return -1;
+
 	/* secondary process does not need to initialize anything */
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
 		return 0;
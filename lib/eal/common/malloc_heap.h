@@ -52,6 +52,10 @@ void *
 malloc_heap_alloc(const char *type, size_t size, int socket, unsigned int flags,
 		size_t align, size_t bound, bool contig);
 
+unsigned int
+malloc_heap_alloc_bulk(unsigned int heap_id, size_t size, void **objs,
+		unsigned int n);
+
 void *
 malloc_heap_alloc_biggest(const char *type, int socket, unsigned int flags,
 		size_t align, bool contig);
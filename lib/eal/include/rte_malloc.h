@@ -531,6 +531,57 @@ __rte_experimental
 void
 rte_malloc_dump_heaps(FILE *f);
 
+/**
+ * Statistics of a per-lcore malloc cache.
+ */
+struct rte_malloc_cache_stats {
+	uint64_t alloc_count;  /**< Allocations served by the cache */
+	uint64_t free_count;   /**< Frees kept in the cache */
+	uint64_t refill_count; /**< Refills of the cache from the heap */
+	uint64_t flush_count;  /**< Flushes of the cache to the heap */
+	uint64_t cached_count; /**< Objects currently held in the cache */
+	uint64_t cached_bytes; /**< Bytes currently held in the cache */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the statistics of the malloc cache of an lcore.
+ *
+ * The per-lcore malloc caches are enabled with the ``--malloc-cache`` EAL
+ * option. The objects held in a cache are accounted as allocated in the heap
+ * statistics.
+ *
+ * @param lcore_id
+ *   The lcore to get the cache statistics of.
+ * @param stats
+ *   A structure which provides the statistics.
+ * @return
+ *   0 on success
+ *   -1 in case of error, with rte_errno set to one of the following:
+ *     EINVAL - ``lcore_id`` is invalid or ``stats`` is NULL
+ *     ENOTSUP - the per-lcore malloc caches are not enabled
+ */
+__rte_experimental
+int
+rte_malloc_cache_stats_get(unsigned int lcore_id,
+		struct rte_malloc_cache_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Give back all the objects held in the malloc cache of the calling lcore to
+ * the heaps, for instance before a thread stops using its lcore ID.
+ *
+ * Nothing is done if the per-lcore malloc caches are not enabled or if the
+ * calling thread has no lcore ID.
+ */
+__rte_experimental
+void
+rte_malloc_cache_flush(void);
+
 /**
  * Set the maximum amount of allocated memory for this type.
  *
@@ -35,6 +35,10 @@ struct dir24_8_tbl {
 	uint64_t	def_nh;		/**< Default next hop */
 	uint64_t	*tbl8;		/**< tbl8 table. */
 	uint64_t	*tbl8_idxes;	/**< bitmap containing free tbl8 idxes*/
+	/* RCU config. */
+	struct rte_rcu_qsbr	*v;	/* RCU QSBR variable. */
+	enum rte_fib_qsbr_mode	rcu_mode;/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq	*dq;	/* RCU QSBR defer queue. */
 	/* tbl24 table. */
 	__extension__ uint64_t	tbl24[0] __rte_cache_aligned;
 };
@@ -248,6 +252,10 @@ dir24_8_free(void *p);
 rte_fib_lookup_fn_t
 dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type);
 
+int
+dir24_8_rcu_qsbr_add(struct dir24_8_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name);
+
 int
 dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	uint64_t next_hop, int op);
@@ -12,20 +12,22 @@ update_tunnel_ipv4_tcp_headers(struct rte_mbuf *pkt, uint8_t ipid_delta,
 	struct rte_ipv4_hdr *ipv4_hdr;
 	struct rte_tcp_hdr *tcp_hdr;
 	uint32_t sent_seq;
-	uint16_t outer_id, inner_id, tail_idx, i;
-	uint16_t outer_ipv4_offset, inner_ipv4_offset;
+	uint16_t outer_id = 0, inner_id, tail_idx, i;
+	uint16_t outer_ip_offset, inner_ipv4_offset;
 	uint16_t udp_gre_offset, tcp_offset;
 	uint8_t update_udp_hdr;
 
-	outer_ipv4_offset = pkt->outer_l2_len;
-	udp_gre_offset = outer_ipv4_offset + pkt->outer_l3_len;
+	outer_ip_offset = pkt->outer_l2_len;
+	udp_gre_offset = outer_ip_offset + pkt->outer_l3_len;
 	inner_ipv4_offset = udp_gre_offset + pkt->l2_len;
 	tcp_offset = inner_ipv4_offset + pkt->l3_len;
 
-	/* Outer IPv4 header. */
-	ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
-			outer_ipv4_offset);
-	outer_id = rte_be_to_cpu_16(ipv4_hdr->packet_id);
+	/* Outer IPv4 header, an outer IPv6 header has no ID. */
+	if (!(pkt->ol_flags & PKT_TX_OUTER_IPV6)) {
+		ipv4_hdr = (struct rte_ipv4_hdr *)
+			(rte_pktmbuf_mtod(pkt, char *) + outer_ip_offset);
+		outer_id = rte_be_to_cpu_16(ipv4_hdr->packet_id);
+	}
 
 	/* Inner IPv4 header. */
 	ipv4_hdr = (struct rte_ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
@@ -40,7 +42,7 @@ update_tunnel_ipv4_tcp_headers(struct rte_mbuf *pkt, uint8_t ipid_delta,
 	update_udp_hdr = (pkt->ol_flags & PKT_TX_TUNNEL_VXLAN) ? 1 : 0;
 
 	for (i = 0; i < nb_segs; i++) {
-		update_ipv4_header(segs[i], outer_ipv4_offset, outer_id);
+		update_outer_ip_header(segs[i], outer_ip_offset, outer_id);
 		if (update_udp_hdr)
 			update_udp_header(segs[i], udp_gre_offset);
 		update_ipv4_header(segs[i], inner_ipv4_offset, inner_id);
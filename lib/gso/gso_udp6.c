@@ -0,0 +1,113 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <rte_random.h>
+
+#include "gso_common.h"
+#include "gso_udp6.h"
+
+static inline void
+update_ipv6_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	char *hdr;
+	uint16_t l2_hdrlen = pkt->l2_len;
+	uint16_t hdr_len = l2_hdrlen + pkt->l3_len;
+	uint16_t tail_idx = nb_segs - 1, frag_offset = 0, is_mf, i;
+	uint32_t frag_id;
+	uint8_t proto;
+
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+			l2_hdrlen);
+	proto = ipv6_hdr->proto;
+	/* All the fragments of the packet share the same ID. */
+	frag_id = (uint32_t)rte_rand();
+
+	for (i = 0; i < nb_segs; i++) {
+		/*
+		 * Make room for the fragment header between the IPv6
+		 * header and the payload. The header segment is a freshly
+		 * allocated direct MBUF, so it has enough headroom.
+		 */
+		hdr = rte_pktmbuf_prepend(segs[i], RTE_IPV6_FRAG_HDR_SIZE);
+		memmove(hdr, hdr + RTE_IPV6_FRAG_HDR_SIZE, hdr_len);
+		segs[i]->l3_len += RTE_IPV6_FRAG_HDR_SIZE;
+
+		ipv6_hdr = (struct rte_ipv6_hdr *)(hdr + l2_hdrlen);
+		ipv6_hdr->proto = IPPROTO_FRAGMENT;
+		update_ipv6_header(segs[i], l2_hdrlen);
+
+		is_mf = i < tail_idx ? RTE_IPV6_EHDR_MF_MASK : 0;
+		frag_hdr = (struct rte_ipv6_fragment_ext *)(hdr + hdr_len);
+		frag_hdr->next_header = proto;
+		frag_hdr->reserved = 0;
+		frag_hdr->frag_data = rte_cpu_to_be_16(
+				RTE_IPV6_SET_FRAG_DATA(frag_offset, is_mf));
+		frag_hdr->id = rte_cpu_to_be_32(frag_id);
+
+		frag_offset += segs[i]->pkt_len - hdr_len -
+			RTE_IPV6_FRAG_HDR_SIZE;
+	}
+}
+
+int
+gso_udp6_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t pyld_unit_size, hdr_offset;
+	int ret;
+
+	/*
+	 * Don't process packets with extension headers, the fragment
+	 * header would have to be inserted within them. This also
+	 * skips packets which are already fragments.
+	 */
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+			pkt->l2_len);
+	if (unlikely(pkt->l3_len != sizeof(struct rte_ipv6_hdr) ||
+			ipv6_hdr->proto == IPPROTO_FRAGMENT))
+		return 0;
+
+	/*
+	 * UDP fragmentation is the same as IP fragmentation.
+	 * Except the first one, other output packets just have l2
+	 * and l3 headers.
+	 */
+	hdr_offset = pkt->l2_len + pkt->l3_len;
+
+	/* Don't process the packet without data. */
+	if (unlikely(hdr_offset + pkt->l4_len >= pkt->pkt_len))
+		return 0;
+
+	/* The headers leave no room for payload in a segment */
+	if (unlikely(hdr_offset + RTE_IPV6_FRAG_HDR_SIZE +
+			RTE_IPV6_EHDR_FO_ALIGN > gso_size))
+		return -EINVAL;
+
+	/*
+	 * pyld_unit_size must be a multiple of 8 because the fragment
+	 * offset uses 8 bytes as unit, and it must leave room for the
+	 * fragment header.
+	 */
+	pyld_unit_size = (gso_size - hdr_offset - RTE_IPV6_FRAG_HDR_SIZE) &
+		~7U;
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1)
+		update_ipv6_udp_headers(pkt, pkts_out, ret);
+
+	return ret;
+}
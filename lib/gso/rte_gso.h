@@ -78,9 +78,14 @@ struct rte_gso_ctx {
  * Before calling rte_gso_segment(), applications must set proper ol_flags
  * for the packet. The GSO library uses the same macros as that of TSO.
  * For example, set PKT_TX_TCP_SEG and PKT_TX_IPV4 in ol_flags to segment
- * a TCP/IPv4 packet. If rte_gso_segment() succeeds, the PKT_TX_TCP_SEG
+ * a TCP/IPv4 packet, or PKT_TX_TCP_SEG and PKT_TX_IPV6 to segment a
+ * TCP/IPv6 packet. If rte_gso_segment() succeeds, the PKT_TX_TCP_SEG
  * flag is removed for all GSO segments and the input packet.
  *
+ * As for UDP/IPv4, UDP/IPv6 packets are segmented into IP fragments: an
+ * IPv6 fragment header is inserted in each GSO segment, and its l3_len
+ * is updated accordingly.
+ *
  * Each of the newly-created GSO segments is organized as a two-segment
  * MBUF, where the first segment is a standard MBUF, which stores a copy
  * of packet header, and the second is an indirect MBUF which points to
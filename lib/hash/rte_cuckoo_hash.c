@@ -57,6 +57,10 @@ struct __rte_hash_rcu_dq_entry {
 	uint32_t ext_bkt_idx;
 };
 
+static int32_t __rte_hash_add_key_resizing(const struct rte_hash *h,
+		const void *key, hash_sig_t sig, void *data);
+static void __rte_hash_resize_finish(struct rte_hash *h);
+
 struct rte_hash *
 rte_hash_find_existing(const char *name)
 {
@@ -93,6 +97,8 @@ void rte_hash_set_cmp_func(struct rte_hash *h, rte_hash_cmp_eq_t func)
 {
 	h->cmp_jump_table_idx = KEY_CUSTOM;
 	h->rte_hash_custom_cmp_eq = func;
+	if (h->resize != NULL)
+		rte_hash_set_cmp_func(h->resize->next, func);
 }
 
 static inline int
@@ -134,8 +140,11 @@ get_alt_bucket_index(const struct rte_hash *h,
 	return (cur_bkt_idx ^ sig) & h->bucket_bitmask;
 }
 
-struct rte_hash *
-rte_hash_create(const struct rte_hash_parameters *params)
+/* Create a hash table, added to the list of hash tables unless it is the
+ * internal table of a resize.
+ */
+static struct rte_hash *
+__rte_hash_create(const struct rte_hash_parameters *params, int add_to_list)
 {
 	struct rte_hash *h = NULL;
 	struct rte_tailq_entry *te = NULL;
@@ -263,26 +272,29 @@ rte_hash_create(const struct rte_hash_parameters *params)
 
 	snprintf(hash_name, sizeof(hash_name), "HT_%s", params->name);
 
-	rte_mcfg_tailq_write_lock();
+	if (add_to_list) {
+		rte_mcfg_tailq_write_lock();
 
-	/* guarantee there's no existing: this is normally already checked
-	 * by ring creation above */
-	TAILQ_FOREACH(te, hash_list, next) {
-		h = (struct rte_hash *) te->data;
-		if (strncmp(params->name, h->name, RTE_HASH_NAMESIZE) == 0)
-			break;
-	}
-	h = NULL;
-	if (te != NULL) {
-		rte_errno = EEXIST;
-		te = NULL;
-		goto err_unlock;
-	}
+		/* guarantee there's no existing: this is normally already
+		 * checked by ring creation above */
+		TAILQ_FOREACH(te, hash_list, next) {
+			h = (struct rte_hash *) te->data;
+			if (strncmp(params->name, h->name,
+					RTE_HASH_NAMESIZE) == 0)
+				break;
+		}
+		h = NULL;
+		if (te != NULL) {
+			rte_errno = EEXIST;
+			te = NULL;
+			goto err_unlock;
+		}
 
-	te = rte_zmalloc("HASH_TAILQ_ENTRY", sizeof(*te), 0);
-	if (te == NULL) {
-		RTE_LOG(ERR, HASH, "tailq entry allocation failed\n");
-		goto err_unlock;
+		te = rte_zmalloc("HASH_TAILQ_ENTRY", sizeof(*te), 0);
+		if (te == NULL) {
+			RTE_LOG(ERR, HASH, "tailq entry allocation failed\n");
+			goto err_unlock;
+		}
 	}
 
 	h = (struct rte_hash *)rte_zmalloc_socket(hash_name, sizeof(struct rte_hash),
@@ -414,6 +426,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->key_len = params->key_len;
 	h->key_entry_size = key_entry_size;
 	h->hash_func_init_val = params->hash_func_init_val;
+	h->socket_id = params->socket_id;
 
 	h->num_buckets = num_buckets;
 	h->bucket_bitmask = h->num_buckets - 1;
@@ -464,13 +477,16 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	for (i = 1; i < num_key_slots; i++)
 		rte_ring_sp_enqueue_elem(r, &i, sizeof(uint32_t));
 
-	te->data = (void *) h;
-	TAILQ_INSERT_TAIL(hash_list, te, next);
-	rte_mcfg_tailq_write_unlock();
+	if (add_to_list) {
+		te->data = (void *) h;
+		TAILQ_INSERT_TAIL(hash_list, te, next);
+		rte_mcfg_tailq_write_unlock();
+	}
 
 	return h;
 err_unlock:
-	rte_mcfg_tailq_write_unlock();
+	if (add_to_list)
+		rte_mcfg_tailq_write_unlock();
 err:
 	rte_ring_free(r);
 	rte_ring_free(r_ext);
@@ -485,6 +501,33 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	return NULL;
 }
 
+struct rte_hash *
+rte_hash_create(const struct rte_hash_parameters *params)
+{
+	return __rte_hash_create(params, 1);
+}
+
+/* Free the memory of a hash table, except the hash structure itself */
+static void
+__rte_hash_free_tables(struct rte_hash *h)
+{
+	if (h->dq)
+		rte_rcu_qsbr_dq_delete(h->dq);
+
+	if (h->use_local_cache)
+		rte_free(h->local_free_slots);
+	if (h->writer_takes_lock)
+		rte_free(h->readwrite_lock);
+	rte_ring_free(h->free_slots);
+	rte_ring_free(h->free_ext_bkts);
+	rte_free(h->key_store);
+	rte_free(h->buckets);
+	rte_free(h->buckets_ext);
+	rte_free(h->tbl_chng_cnt);
+	rte_free(h->ext_bkt_to_free);
+	rte_free(h->hash_rcu_cfg);
+}
+
 void
 rte_hash_free(struct rte_hash *h)
 {
@@ -513,20 +556,13 @@ rte_hash_free(struct rte_hash *h)
 
 	rte_mcfg_tailq_write_unlock();
 
-	if (h->dq)
-		rte_rcu_qsbr_dq_delete(h->dq);
+	if (h->resize != NULL) {
+		__rte_hash_free_tables(h->resize->next);
+		rte_free(h->resize->next);
+		rte_free(h->resize);
+	}
 
-	if (h->use_local_cache)
-		rte_free(h->local_free_slots);
-	if (h->writer_takes_lock)
-		rte_free(h->readwrite_lock);
-	rte_ring_free(h->free_slots);
-	rte_ring_free(h->free_ext_bkts);
-	rte_free(h->key_store);
-	rte_free(h->buckets);
-	rte_free(h->buckets_ext);
-	rte_free(h->tbl_chng_cnt);
-	rte_free(h->ext_bkt_to_free);
+	__rte_hash_free_tables(h);
 	rte_free(h);
 	rte_free(te);
 }
@@ -542,6 +578,9 @@ int32_t
 rte_hash_max_key_id(const struct rte_hash *h)
 {
 	RETURN_IF_TRUE((h == NULL), -EINVAL);
+	/* Keys added during a resize take their position in the new table */
+	if (h->resize != NULL)
+		return rte_hash_max_key_id(h->resize->next);
 	if (h->use_local_cache)
 		/*
 		 * Increase number of slots by total number of indices
@@ -574,6 +613,10 @@ rte_hash_count(const struct rte_hash *h)
 		tot_ring_cnt = h->entries;
 		ret = tot_ring_cnt - rte_ring_count(h->free_slots);
 	}
+
+	/* Keys not migrated yet are in the old table, the others in the new */
+	if (h->resize != NULL)
+		ret += rte_hash_count(h->resize->next);
 	return ret;
 }
 
@@ -623,6 +666,12 @@ rte_hash_reset(struct rte_hash *h)
 	if (h == NULL)
 		return;
 
+	if (h->resize != NULL) {
+		/* The keys of both tables are dropped, end the resize */
+		rte_hash_reset(h->resize->next);
+		__rte_hash_resize_finish(h);
+	}
+
 	__hash_rw_writer_lock(h);
 
 	if (h->dq) {
@@ -792,9 +841,10 @@ rte_hash_cuckoo_insert_mw(const struct rte_hash *h,
  * the path head with new entry (sig, alt_hash, new_idx)
  * return 1 if matched key found, return -1 if cuckoo path invalided and fail,
  * return 0 if succeeds.
+ * Writer is expected to hold the lock while calling this function.
  */
 static inline int
-rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
+__rte_hash_cuckoo_move_insert(const struct rte_hash *h,
 			struct rte_hash_bucket *bkt,
 			struct rte_hash_bucket *alt_bkt,
 			const struct rte_hash_key *key, void *data,
@@ -809,20 +859,15 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 	uint32_t prev_slot, curr_slot = leaf_slot;
 	int32_t ret;
 
-	__hash_rw_writer_lock(h);
-
 	/* In case empty slot was gone before entering protected region */
-	if (curr_bkt->key_idx[curr_slot] != EMPTY_SLOT) {
-		__hash_rw_writer_unlock(h);
+	if (curr_bkt->key_idx[curr_slot] != EMPTY_SLOT)
 		return -1;
-	}
 
 	/* Check if key was inserted after last check but before this
 	 * protected region.
 	 */
 	ret = search_and_update(h, data, key, bkt, sig);
 	if (ret != -1) {
-		__hash_rw_writer_unlock(h);
 		*ret_val = ret;
 		return 1;
 	}
@@ -830,7 +875,6 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 	FOR_EACH_BUCKET(cur_bkt, alt_bkt) {
 		ret = search_and_update(h, data, key, cur_bkt, sig);
 		if (ret != -1) {
-			__hash_rw_writer_unlock(h);
 			*ret_val = ret;
 			return 1;
 		}
@@ -851,7 +895,6 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			__atomic_store_n(&curr_bkt->key_idx[curr_slot],
 				EMPTY_SLOT,
 				__ATOMIC_RELEASE);
-			__hash_rw_writer_unlock(h);
 			return -1;
 		}
 
@@ -909,15 +952,32 @@ rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
 			 new_idx,
 			 __ATOMIC_RELEASE);
 
-	__hash_rw_writer_unlock(h);
-
 	return 0;
+}
+
+static inline int
+rte_hash_cuckoo_move_insert_mw(const struct rte_hash *h,
+			struct rte_hash_bucket *bkt,
+			struct rte_hash_bucket *alt_bkt,
+			const struct rte_hash_key *key, void *data,
+			struct queue_node *leaf, uint32_t leaf_slot,
+			uint16_t sig, uint32_t new_idx,
+			int32_t *ret_val)
+{
+	int ret;
+
+	__hash_rw_writer_lock(h);
+	ret = __rte_hash_cuckoo_move_insert(h, bkt, alt_bkt, key, data,
+					leaf, leaf_slot, sig, new_idx, ret_val);
+	__hash_rw_writer_unlock(h);
 
+	return ret;
 }
 
 /*
  * Make space for new key, using bfs Cuckoo Search and Multi-Writer safe
- * Cuckoo
+ * Cuckoo. If @writer_locked is set, the caller already holds the writer
+ * lock and it is not taken again for each cuckoo move.
  */
 static inline int
 rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
@@ -925,7 +985,8 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 			struct rte_hash_bucket *sec_bkt,
 			const struct rte_hash_key *key, void *data,
 			uint16_t sig, uint32_t bucket_idx,
-			uint32_t new_idx, int32_t *ret_val)
+			uint32_t new_idx, int32_t *ret_val,
+			int writer_locked)
 {
 	unsigned int i;
 	struct queue_node queue[RTE_HASH_BFS_QUEUE_MAX_LEN];
@@ -948,7 +1009,15 @@ rte_hash_cuckoo_make_space_mw(const struct rte_hash *h,
 		cur_idx = tail->cur_bkt_idx;
 		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 			if (curr_bkt->key_idx[i] == EMPTY_SLOT) {
-				int32_t ret = rte_hash_cuckoo_move_insert_mw(h,
+				int32_t ret;
+
+				if (writer_locked)
+					ret = __rte_hash_cuckoo_move_insert(h,
+						bkt, sec_bkt, key, data,
+						tail, i, sig,
+						new_idx, ret_val);
+				else
+					ret = rte_hash_cuckoo_move_insert_mw(h,
 						bkt, sec_bkt, key, data,
 						tail, i, sig,
 						new_idx, ret_val);
@@ -1004,6 +1073,93 @@ alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
 	return slot_id;
 }
 
+/* Insert a new key, whose key store entry @slot_id is already filled,
+ * into the secondary bucket linked list, attaching a new extendable bucket
+ * if needed. Duplicates are checked again since the key could have been
+ * inserted before the lock was taken. The slot is returned to the free
+ * list if it is not used.
+ * Writer is expected to hold the lock while calling this function.
+ */
+static inline int32_t
+__rte_hash_add_key_ext(const struct rte_hash *h, const void *key, void *data,
+		struct rte_hash_bucket *prim_bkt,
+		struct rte_hash_bucket *sec_bkt, uint16_t short_sig,
+		uint32_t slot_id, struct lcore_cache *cached_free_slots)
+{
+	struct rte_hash_bucket *cur_bkt, *last;
+	uint32_t ext_bkt_id = 0;
+	unsigned int i;
+	int32_t ret;
+
+	ret = search_and_update(h, data, key, prim_bkt, short_sig);
+	if (ret != -1) {
+		enqueue_slot_back(h, cached_free_slots, slot_id);
+		return ret;
+	}
+
+	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
+		ret = search_and_update(h, data, key, cur_bkt, short_sig);
+		if (ret != -1) {
+			enqueue_slot_back(h, cached_free_slots, slot_id);
+			return ret;
+		}
+	}
+
+	/* Search sec and ext buckets to find an empty entry to insert. */
+	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			/* Check if slot is available */
+			if (likely(cur_bkt->key_idx[i] == EMPTY_SLOT)) {
+				cur_bkt->sig_current[i] = short_sig;
+				/* Store to signature and key should not
+				 * leak after the store to key_idx. i.e.
+				 * key_idx is the guard variable for signature
+				 * and key.
+				 */
+				__atomic_store_n(&cur_bkt->key_idx[i],
+						 slot_id,
+						 __ATOMIC_RELEASE);
+				return slot_id - 1;
+			}
+		}
+	}
+
+	/* Failed to get an empty entry from extendable buckets. Link a new
+	 * extendable bucket. We first get a free bucket from ring.
+	 */
+	if (rte_ring_sc_dequeue_elem(h->free_ext_bkts, &ext_bkt_id,
+						sizeof(uint32_t)) != 0 ||
+					ext_bkt_id == 0) {
+		if (h->dq) {
+			if (rte_rcu_qsbr_dq_reclaim(h->dq,
+					h->hash_rcu_cfg->max_reclaim_size,
+					NULL, NULL, NULL) == 0) {
+				rte_ring_sc_dequeue_elem(h->free_ext_bkts,
+							 &ext_bkt_id,
+							 sizeof(uint32_t));
+			}
+		}
+		if (ext_bkt_id == 0) {
+			enqueue_slot_back(h, cached_free_slots, slot_id);
+			return -ENOSPC;
+		}
+	}
+
+	/* Use the first location of the new bucket */
+	(h->buckets_ext[ext_bkt_id - 1]).sig_current[0] = short_sig;
+	/* Store to signature and key should not leak after
+	 * the store to key_idx. i.e. key_idx is the guard variable
+	 * for signature and key.
+	 */
+	__atomic_store_n(&(h->buckets_ext[ext_bkt_id - 1]).key_idx[0],
+			 slot_id,
+			 __ATOMIC_RELEASE);
+	/* Link the new bucket to sec bucket linked list */
+	last = rte_hash_get_last_bkt(sec_bkt);
+	last->next = &h->buckets_ext[ext_bkt_id - 1];
+	return slot_id - 1;
+}
+
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
@@ -1012,14 +1168,11 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
 	struct rte_hash_key *new_k, *keys = h->key_store;
-	uint32_t ext_bkt_id = 0;
 	uint32_t slot_id;
 	int ret;
 	unsigned lcore_id;
-	unsigned int i;
 	struct lcore_cache *cached_free_slots = NULL;
 	int32_t ret_val;
-	struct rte_hash_bucket *last;
 
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
@@ -1091,7 +1244,8 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 	/* Primary bucket full, need to make space for new entry */
 	ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, key, data,
-				short_sig, prim_bucket_idx, slot_id, &ret_val);
+				short_sig, prim_bucket_idx, slot_id, &ret_val,
+				0);
 	if (ret == 0)
 		return slot_id - 1;
 	else if (ret == 1) {
@@ -1101,7 +1255,8 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 	/* Also search secondary bucket to get better occupancy */
 	ret = rte_hash_cuckoo_make_space_mw(h, sec_bkt, prim_bkt, key, data,
-				short_sig, sec_bucket_idx, slot_id, &ret_val);
+				short_sig, sec_bucket_idx, slot_id, &ret_val,
+				0);
 
 	if (ret == 0)
 		return slot_id - 1;
@@ -1120,96 +1275,154 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	 * to protect all extendable bucket processes.
 	 */
 	__hash_rw_writer_lock(h);
-	/* We check for duplicates again since could be inserted before the lock */
+	ret = __rte_hash_add_key_ext(h, key, data, prim_bkt, sec_bkt,
+				short_sig, slot_id, cached_free_slots);
+	__hash_rw_writer_unlock(h);
+	return ret;
+}
+
+/* Add a key whose primary and secondary buckets are already known.
+ * Unlike __rte_hash_add_key_with_hash(), the whole insertion, including
+ * the cuckoo moves, is done within the caller's critical section.
+ * Writer is expected to hold the lock while calling this function.
+ */
+static inline int32_t
+__rte_hash_add_key_locked(const struct rte_hash *h, const void *key,
+		void *data, uint16_t short_sig, uint32_t prim_bucket_idx,
+		uint32_t sec_bucket_idx, struct lcore_cache *cached_free_slots)
+{
+	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
+	struct rte_hash_key *new_k, *keys = h->key_store;
+	uint32_t slot_id;
+	unsigned int i;
+	int32_t ret_val;
+	int ret;
+
+	prim_bkt = &h->buckets[prim_bucket_idx];
+	sec_bkt = &h->buckets[sec_bucket_idx];
+
+	/* Check if key is already inserted in primary location */
 	ret = search_and_update(h, data, key, prim_bkt, short_sig);
-	if (ret != -1) {
-		enqueue_slot_back(h, cached_free_slots, slot_id);
-		goto failure;
-	}
+	if (ret != -1)
+		return ret;
 
+	/* Check if key is already inserted in secondary location */
 	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
 		ret = search_and_update(h, data, key, cur_bkt, short_sig);
-		if (ret != -1) {
-			enqueue_slot_back(h, cached_free_slots, slot_id);
-			goto failure;
-		}
-	}
-
-	/* Search sec and ext buckets to find an empty entry to insert. */
-	FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
-		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-			/* Check if slot is available */
-			if (likely(cur_bkt->key_idx[i] == EMPTY_SLOT)) {
-				cur_bkt->sig_current[i] = short_sig;
-				/* Store to signature and key should not
-				 * leak after the store to key_idx. i.e.
-				 * key_idx is the guard variable for signature
-				 * and key.
-				 */
-				__atomic_store_n(&cur_bkt->key_idx[i],
-						 slot_id,
-						 __ATOMIC_RELEASE);
-				__hash_rw_writer_unlock(h);
-				return slot_id - 1;
-			}
-		}
+		if (ret != -1)
+			return ret;
 	}
 
-	/* Failed to get an empty entry from extendable buckets. Link a new
-	 * extendable bucket. We first get a free bucket from ring.
-	 */
-	if (rte_ring_sc_dequeue_elem(h->free_ext_bkts, &ext_bkt_id,
-						sizeof(uint32_t)) != 0 ||
-					ext_bkt_id == 0) {
-		if (h->dq) {
-			if (rte_rcu_qsbr_dq_reclaim(h->dq,
+	/* Did not find a match, so get a new slot for storing the new key */
+	slot_id = alloc_slot(h, cached_free_slots);
+	if (slot_id == EMPTY_SLOT) {
+		if (h->dq && rte_rcu_qsbr_dq_reclaim(h->dq,
 					h->hash_rcu_cfg->max_reclaim_size,
-					NULL, NULL, NULL) == 0) {
-				rte_ring_sc_dequeue_elem(h->free_ext_bkts,
-							 &ext_bkt_id,
-							 sizeof(uint32_t));
-			}
-		}
-		if (ext_bkt_id == 0) {
-			ret = -ENOSPC;
-			goto failure;
-		}
+					NULL, NULL, NULL) == 0)
+			slot_id = alloc_slot(h, cached_free_slots);
+		if (slot_id == EMPTY_SLOT)
+			return -ENOSPC;
 	}
 
-	/* Use the first location of the new bucket */
-	(h->buckets_ext[ext_bkt_id - 1]).sig_current[0] = short_sig;
-	/* Store to signature and key should not leak after
-	 * the store to key_idx. i.e. key_idx is the guard variable
-	 * for signature and key.
+	new_k = RTE_PTR_ADD(keys, slot_id * h->key_entry_size);
+	/* The store to application data (by the application) at *data should
+	 * not leak after the store of pdata in the key store. i.e. pdata is
+	 * the guard variable. Release the application data to the readers.
 	 */
-	__atomic_store_n(&(h->buckets_ext[ext_bkt_id - 1]).key_idx[0],
-			 slot_id,
-			 __ATOMIC_RELEASE);
-	/* Link the new bucket to sec bucket linked list */
-	last = rte_hash_get_last_bkt(sec_bkt);
-	last->next = &h->buckets_ext[ext_bkt_id - 1];
-	__hash_rw_writer_unlock(h);
-	return slot_id - 1;
+	__atomic_store_n(&new_k->pdata,
+		data,
+		__ATOMIC_RELEASE);
+	/* Copy key */
+	memcpy(new_k->key, key, h->key_len);
 
-failure:
-	__hash_rw_writer_unlock(h);
-	return ret;
+	/* Insert new entry if there is room in the primary bucket */
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		/* Check if slot is available */
+		if (likely(prim_bkt->key_idx[i] == EMPTY_SLOT)) {
+			prim_bkt->sig_current[i] = short_sig;
+			/* Store to signature and key should not
+			 * leak after the store to key_idx. i.e.
+			 * key_idx is the guard variable for signature
+			 * and key.
+			 */
+			__atomic_store_n(&prim_bkt->key_idx[i],
+					 slot_id,
+					 __ATOMIC_RELEASE);
+			return slot_id - 1;
+		}
+	}
 
+	/* Primary bucket full, need to make space for new entry */
+	ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, key, data,
+				short_sig, prim_bucket_idx, slot_id, &ret_val,
+				1);
+	if (ret == 0)
+		return slot_id - 1;
+	else if (ret == 1) {
+		enqueue_slot_back(h, cached_free_slots, slot_id);
+		return ret_val;
+	}
+
+	/* Also search secondary bucket to get better occupancy */
+	ret = rte_hash_cuckoo_make_space_mw(h, sec_bkt, prim_bkt, key, data,
+				short_sig, sec_bucket_idx, slot_id, &ret_val,
+				1);
+	if (ret == 0)
+		return slot_id - 1;
+	else if (ret == 1) {
+		enqueue_slot_back(h, cached_free_slots, slot_id);
+		return ret_val;
+	}
+
+	/* if ext table not enabled, we failed the insertion */
+	if (!h->ext_table_support) {
+		enqueue_slot_back(h, cached_free_slots, slot_id);
+		return ret;
+	}
+
+	return __rte_hash_add_key_ext(h, key, data, prim_bkt, sec_bkt,
+				short_sig, slot_id, cached_free_slots);
+}
+
+static inline int32_t
+__rte_hash_add_key(const struct rte_hash *h, const void *key,
+						hash_sig_t sig, void *data)
+{
+	if (unlikely(h->resize != NULL))
+		return __rte_hash_add_key_resizing(h, key, sig, data);
+
+	return __rte_hash_add_key_with_hash(h, key, sig, data);
+}
+
+/* A key added with a signature given by the application cannot be
+ * migrated by a resize, which rehashes the keys.
+ */
+static inline void
+__rte_hash_check_ext_sig(const struct rte_hash *h, const void *key,
+		hash_sig_t sig)
+{
+	if (!h->ext_sig_keys && sig != rte_hash_hash(h, key))
+		((struct rte_hash *)(uintptr_t)h)->ext_sig_keys = 1;
 }
 
 int32_t
 rte_hash_add_key_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
 {
+	int32_t ret;
+
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_add_key_with_hash(h, key, sig, 0);
+	ret = __rte_hash_add_key(h, key, sig, 0);
+	if (ret >= 0)
+		__rte_hash_check_ext_sig(h, key, sig);
+	return ret;
 }
 
 int32_t
 rte_hash_add_key(const struct rte_hash *h, const void *key)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), 0);
+	return __rte_hash_add_key(h, key, rte_hash_hash(h, key), 0);
 }
 
 int
@@ -1219,10 +1432,11 @@ rte_hash_add_key_with_hash_data(const struct rte_hash *h,
 	int ret;
 
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	ret = __rte_hash_add_key_with_hash(h, key, sig, data);
-	if (ret >= 0)
+	ret = __rte_hash_add_key(h, key, sig, data);
+	if (ret >= 0) {
+		__rte_hash_check_ext_sig(h, key, sig);
 		return 0;
-	else
+	} else
 		return ret;
 }
 
@@ -1233,7 +1447,7 @@ rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
 
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
 
-	ret = __rte_hash_add_key_with_hash(h, key, rte_hash_hash(h, key), data);
+	ret = __rte_hash_add_key(h, key, rte_hash_hash(h, key), data);
 	if (ret >= 0)
 		return 0;
 	else
@@ -1410,7 +1624,7 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 }
 
 static inline int32_t
-__rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
+__rte_hash_lookup_table(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
 	if (h->readwrite_concur_lf_support)
@@ -1419,6 +1633,39 @@ __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 		return __rte_hash_lookup_with_hash_l(h, key, sig, data);
 }
 
+/* Look a key up while the table is resized. A migrated key is added to the
+ * new table before it is removed from the old one, so looking in the old
+ * table first cannot miss it.
+ */
+static int32_t
+__rte_hash_lookup_resizing(const struct rte_hash *h,
+		const struct rte_hash_resize *rs, const void *key,
+		hash_sig_t sig, void **data)
+{
+	int32_t ret;
+
+	if (!__atomic_load_n(&rs->migrated, __ATOMIC_ACQUIRE)) {
+		ret = __rte_hash_lookup_table(h, key, sig, data);
+		if (ret != -ENOENT)
+			return ret;
+	}
+
+	return __rte_hash_lookup_table(rs->next, key, sig, data);
+}
+
+static inline int32_t
+__rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
+{
+	const struct rte_hash_resize *rs;
+
+	rs = __atomic_load_n(&h->resize, __ATOMIC_ACQUIRE);
+	if (unlikely(rs != NULL))
+		return __rte_hash_lookup_resizing(h, rs, key, sig, data);
+
+	return __rte_hash_lookup_table(h, key, sig, data);
+}
+
 int32_t
 rte_hash_lookup_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
@@ -1676,25 +1923,24 @@ search_and_remove(const struct rte_hash *h, const void *key,
 	return -1;
 }
 
+/* Search the key in its primary and secondary buckets and remove it.
+ * On success, *ext_bkt_idx is set to the index of the extendable bucket
+ * emptied by this removal, EMPTY_SLOT if there is none.
+ * Writer is expected to hold the lock while calling this function.
+ */
 static inline int32_t
-__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
-						hash_sig_t sig)
+__rte_hash_del_key_locked(const struct rte_hash *h, const void *key,
+		uint16_t short_sig, uint32_t prim_bucket_idx,
+		uint32_t sec_bucket_idx, uint32_t *ext_bkt_idx)
 {
-	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *prev_bkt, *last_bkt;
 	struct rte_hash_bucket *cur_bkt;
 	int pos;
 	int32_t ret, i;
-	uint16_t short_sig;
 	uint32_t index = EMPTY_SLOT;
-	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
 
-	short_sig = get_short_sig(sig);
-	prim_bucket_idx = get_prim_bucket_index(h, sig);
-	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 	prim_bkt = &h->buckets[prim_bucket_idx];
 
-	__hash_rw_writer_lock(h);
 	/* look for key in primary bucket */
 	ret = search_and_remove(h, key, prim_bkt, short_sig, &pos);
 	if (ret != -1) {
@@ -1717,7 +1963,6 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
-	__hash_rw_writer_unlock(h);
 	return -ENOENT;
 
 /* Search last bucket to see if empty to be recycled */
@@ -1759,41 +2004,233 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	}
 
 return_key:
+	*ext_bkt_idx = index;
+	return ret;
+}
+
+/* Hand the resources of deleted keys over to the integrated RCU QSBR.
+ * In sync mode, a single grace period covers all the entries.
+ * Writer is expected to hold the lock while calling this function.
+ */
+static inline void
+__hash_rcu_qsbr_free_entries(const struct rte_hash *h,
+		struct __rte_hash_rcu_dq_entry *rcu_dq_entry, unsigned int n)
+{
+	unsigned int i;
+
+	if (h->dq == NULL) {
+		/* Wait for quiescent state change if using
+		 * RTE_HASH_QSBR_MODE_SYNC
+		 */
+		rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+					 RTE_QSBR_THRID_INVALID);
+		for (i = 0; i < n; i++)
+			__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
+						      &rcu_dq_entry[i], 1);
+	} else {
+		/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
+		for (i = 0; i < n; i++)
+			if (rte_rcu_qsbr_dq_enqueue(h->dq,
+						    &rcu_dq_entry[i]) != 0)
+				RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
+	}
+}
+
+static inline int32_t
+__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint32_t index;
+	int32_t ret;
+	uint16_t short_sig;
+	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = get_prim_bucket_index(h, sig);
+	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+
+	__hash_rw_writer_lock(h);
+	ret = __rte_hash_del_key_locked(h, key, short_sig, prim_bucket_idx,
+					sec_bucket_idx, &index);
 	/* Using internal RCU QSBR */
-	if (h->hash_rcu_cfg) {
+	if (ret >= 0 && h->hash_rcu_cfg) {
 		/* Key index where key is stored, adding the first dummy index */
 		rcu_dq_entry.key_idx = ret + 1;
 		rcu_dq_entry.ext_bkt_idx = index;
-		if (h->dq == NULL) {
-			/* Wait for quiescent state change if using
-			 * RTE_HASH_QSBR_MODE_SYNC
-			 */
-			rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
-						 RTE_QSBR_THRID_INVALID);
-			__hash_rcu_qsbr_free_resource((void *)((uintptr_t)h),
-						      &rcu_dq_entry, 1);
-		} else if (h->dq)
-			/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
-			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
-				RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
+		__hash_rcu_qsbr_free_entries(h, &rcu_dq_entry, 1);
 	}
 	__hash_rw_writer_unlock(h);
 	return ret;
 }
 
+/* While the table is resized, a key is either in the old or in the new
+ * table.
+ */
+static inline int32_t
+__rte_hash_del_key(const struct rte_hash *h, const void *key, hash_sig_t sig)
+{
+	int32_t ret;
+
+	ret = __rte_hash_del_key_with_hash(h, key, sig);
+	if (unlikely(h->resize != NULL) && ret == -ENOENT)
+		ret = __rte_hash_del_key_with_hash(h->resize->next, key, sig);
+
+	return ret;
+}
+
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_del_key_with_hash(h, key, sig);
+	return __rte_hash_del_key(h, key, sig);
 }
 
 int32_t
 rte_hash_del_key(const struct rte_hash *h, const void *key)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
-	return __rte_hash_del_key_with_hash(h, key, rte_hash_hash(h, key));
+	return __rte_hash_del_key(h, key, rte_hash_hash(h, key));
+}
+
+#define PREFETCH_OFFSET 4
+
+/* Calculate the short signature and the primary and secondary bucket
+ * indexes of a burst of keys to be added or deleted, prefetching the keys
+ * and the buckets ahead of the update loop.
+ */
+static inline void
+__bulk_write_prefetching_loop(const struct rte_hash *h,
+	const void **keys, uint32_t num_keys,
+	uint16_t *sig, uint32_t *prim_index, uint32_t *sec_index)
+{
+	uint32_t i;
+	hash_sig_t prim_hash;
+
+	/* Prefetch first keys */
+	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
+		rte_prefetch0(keys[i]);
+
+	for (i = 0; i < num_keys; i++) {
+		if (i + PREFETCH_OFFSET < num_keys)
+			rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+
+		prim_hash = rte_hash_hash(h, keys[i]);
+
+		sig[i] = get_short_sig(prim_hash);
+		prim_index[i] = get_prim_bucket_index(h, prim_hash);
+		sec_index[i] = get_alt_bucket_index(h, prim_index[i], sig[i]);
+
+		rte_prefetch0(&h->buckets[prim_index[i]]);
+		rte_prefetch0(&h->buckets[sec_index[i]]);
+	}
+}
+
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+		void **data, uint32_t num_keys, int32_t *positions)
+{
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
+	struct lcore_cache *cached_free_slots = NULL;
+	unsigned int lcore_id;
+	uint32_t i;
+	int num_added = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	if (unlikely(h->resize != NULL)) {
+		for (i = 0; i < num_keys; i++) {
+			positions[i] = __rte_hash_add_key_resizing(h, keys[i],
+					rte_hash_hash(h, keys[i]),
+					data != NULL ? data[i] : NULL);
+			if (positions[i] >= 0)
+				num_added++;
+		}
+		return num_added;
+	}
+
+	__bulk_write_prefetching_loop(h, keys, num_keys, sig,
+				      prim_index, sec_index);
+
+	if (h->use_local_cache) {
+		lcore_id = rte_lcore_id();
+		cached_free_slots = &h->local_free_slots[lcore_id];
+	}
+
+	/* The lock is taken once for the whole burst */
+	__hash_rw_writer_lock(h);
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_add_key_locked(h, keys[i],
+				data != NULL ? data[i] : NULL, sig[i],
+				prim_index[i], sec_index[i],
+				cached_free_slots);
+		if (positions[i] >= 0)
+			num_added++;
+	}
+	__hash_rw_writer_unlock(h);
+
+	return num_added;
+}
+
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions)
+{
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t sec_index[RTE_HASH_LOOKUP_BULK_MAX];
+	struct __rte_hash_rcu_dq_entry rcu_dq_entry[RTE_HASH_LOOKUP_BULK_MAX];
+	unsigned int num_rcu = 0;
+	uint32_t index;
+	uint32_t i;
+	int num_deleted = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	if (unlikely(h->resize != NULL)) {
+		for (i = 0; i < num_keys; i++) {
+			positions[i] = __rte_hash_del_key(h, keys[i],
+					rte_hash_hash(h, keys[i]));
+			if (positions[i] >= 0)
+				num_deleted++;
+		}
+		return num_deleted;
+	}
+
+	__bulk_write_prefetching_loop(h, keys, num_keys, sig,
+				      prim_index, sec_index);
+
+	/* The lock is taken once for the whole burst */
+	__hash_rw_writer_lock(h);
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_del_key_locked(h, keys[i], sig[i],
+				prim_index[i], sec_index[i], &index);
+		if (positions[i] < 0)
+			continue;
+
+		num_deleted++;
+		if (h->hash_rcu_cfg) {
+			/* Key index where key is stored, adding the first
+			 * dummy index
+			 */
+			rcu_dq_entry[num_rcu].key_idx = positions[i] + 1;
+			rcu_dq_entry[num_rcu].ext_bkt_idx = index;
+			num_rcu++;
+		}
+	}
+	/* Using internal RCU QSBR */
+	if (num_rcu != 0)
+		__hash_rcu_qsbr_free_entries(h, rcu_dq_entry, num_rcu);
+	__hash_rw_writer_unlock(h);
+
+	return num_deleted;
 }
 
 int
@@ -1802,6 +2239,10 @@ rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
 
+	/* A position may refer to the old or to the new table */
+	if (h->resize != NULL)
+		return -EBUSY;
+
 	struct rte_hash_key *k, *keys = h->key_store;
 	k = (struct rte_hash_key *) ((char *) keys + (position + 1) *
 				     h->key_entry_size);
@@ -1825,6 +2266,9 @@ rte_hash_free_key_with_position(const struct rte_hash *h,
 
 	RETURN_IF_TRUE(((h == NULL) || (key_idx == EMPTY_SLOT)), -EINVAL);
 
+	if (h->resize != NULL)
+		return -EBUSY;
+
 	const uint32_t total_entries = h->use_local_cache ?
 		h->entries + (RTE_MAX_LCORE - 1) * (LCORE_CACHE_SIZE - 1) + 1
 							: h->entries + 1;
@@ -2226,7 +2670,6 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		*hit_mask = hits;
 }
 
-#define PREFETCH_OFFSET 4
 static inline void
 __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 	const void **keys, int32_t num_keys,
@@ -2312,12 +2755,40 @@ __rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
 		positions, hit_mask, data);
 }
 
+/* Bulk lookup while the table is resized, the keys are looked up one by
+ * one in the old and in the new table.
+ */
+static void
+__rte_hash_lookup_bulk_resizing(const struct rte_hash *h, const void **keys,
+			const hash_sig_t *prim_hash, int32_t num_keys,
+			int32_t *positions, uint64_t *hit_mask, void *data[])
+{
+	uint64_t hits = 0;
+	hash_sig_t sig;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		sig = prim_hash != NULL ? prim_hash[i] :
+			rte_hash_hash(h, keys[i]);
+		positions[i] = __rte_hash_lookup_with_hash(h, keys[i], sig,
+				data != NULL ? &data[i] : NULL);
+		if (positions[i] >= 0)
+			hits |= 1ULL << i;
+	}
+
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+}
+
 static inline void
 __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(__atomic_load_n(&h->resize, __ATOMIC_ACQUIRE) != NULL))
+		__rte_hash_lookup_bulk_resizing(h, keys, NULL, num_keys,
+						positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_bulk_lf(h, keys, num_keys, positions,
 					  hit_mask, data);
 	else
@@ -2429,7 +2900,10 @@ __rte_hash_lookup_with_hash_bulk(const struct rte_hash *h, const void **keys,
 			hash_sig_t *prim_hash, int32_t num_keys,
 			int32_t *positions, uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(__atomic_load_n(&h->resize, __ATOMIC_ACQUIRE) != NULL))
+		__rte_hash_lookup_bulk_resizing(h, keys, prim_hash, num_keys,
+						positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_with_hash_bulk_lf(h, keys, prim_hash,
 				num_keys, positions, hit_mask, data);
 	else
@@ -2470,14 +2944,13 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 	return __builtin_popcountl(*hit_mask);
 }
 
-int32_t
-rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
+static int32_t
+__rte_hash_iterate(const struct rte_hash *h, const void **key, void **data,
+		uint32_t *next)
 {
 	uint32_t bucket_idx, idx, position;
 	struct rte_hash_key *next_key;
 
-	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
-
 	const uint32_t total_entries_main = h->num_buckets *
 							RTE_HASH_BUCKET_ENTRIES;
 	const uint32_t total_entries = total_entries_main << 1;
@@ -2545,3 +3018,330 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	(*next)++;
 	return position - 1;
 }
+
+int32_t
+rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
+{
+	uint32_t total_entries, next_idx;
+	int32_t ret;
+
+	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
+
+	if (likely(h->resize == NULL))
+		return __rte_hash_iterate(h, key, data, next);
+
+	/* Iterate the old table, then the new table of the resize */
+	total_entries = (h->num_buckets * RTE_HASH_BUCKET_ENTRIES) << 1;
+	if (*next < total_entries) {
+		ret = __rte_hash_iterate(h, key, data, next);
+		if (ret != -ENOENT)
+			return ret;
+		*next = total_entries;
+	}
+
+	next_idx = *next - total_entries;
+	ret = __rte_hash_iterate(h->resize->next, key, data, &next_idx);
+	*next = next_idx + total_entries;
+
+	return ret;
+}
+
+/* Remove the key of a bucket slot of the old table of a resize, once the
+ * key is in the new table. The signature is left in place, so that readers
+ * matching it load the released key index, ordered after the addition to
+ * the new table. No key is added to the old table during the resize, its
+ * key slot is not reused before the old table is freed.
+ */
+static void
+__rte_hash_resize_unlink(const struct rte_hash *h,
+		struct rte_hash_bucket *bkt, unsigned int i)
+{
+	uint32_t key_idx = bkt->key_idx[i];
+
+	__atomic_store_n(&bkt->key_idx[i], EMPTY_SLOT, __ATOMIC_RELEASE);
+	if (free_slot(h, key_idx) < 0)
+		RTE_LOG(ERR, HASH,
+			"%s: could not enqueue free slots in global ring\n",
+				__func__);
+}
+
+/* Search a bucket and its linked extendable buckets for a key of the old
+ * table of a resize, and remove it without freeing its data.
+ */
+static int
+__rte_hash_resize_unlink_key(const struct rte_hash *h, const void *key,
+		uint16_t sig, struct rte_hash_bucket *bkt)
+{
+	struct rte_hash_bucket *cur_bkt;
+	struct rte_hash_key *k;
+	unsigned int i;
+
+	FOR_EACH_BUCKET(cur_bkt, bkt) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (cur_bkt->sig_current[i] != sig ||
+					cur_bkt->key_idx[i] == EMPTY_SLOT)
+				continue;
+			k = (struct rte_hash_key *) ((char *)h->key_store +
+				cur_bkt->key_idx[i] * h->key_entry_size);
+			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
+				__rte_hash_resize_unlink(h, cur_bkt, i);
+				return 0;
+			}
+		}
+	}
+
+	return -ENOENT;
+}
+
+/* Add a key while the table is resized. The key goes to the new table,
+ * its entry in the old table is removed afterwards, so that readers find
+ * it in either table.
+ */
+static int32_t
+__rte_hash_add_key_resizing(const struct rte_hash *h, const void *key,
+		hash_sig_t sig, void *data)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint16_t short_sig;
+	int32_t ret;
+
+	ret = __rte_hash_add_key_with_hash(h->resize->next, key, sig, data);
+	if (ret < 0)
+		return ret;
+
+	short_sig = get_short_sig(sig);
+	prim_bucket_idx = get_prim_bucket_index(h, sig);
+	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
+
+	if (__rte_hash_resize_unlink_key(h, key, short_sig,
+			&h->buckets[prim_bucket_idx]) != 0)
+		__rte_hash_resize_unlink_key(h, key, short_sig,
+				&h->buckets[sec_bucket_idx]);
+
+	return ret;
+}
+
+/* Migrate the keys of a bucket of the old table, and of its linked
+ * extendable buckets, to the new table.
+ */
+static int
+__rte_hash_resize_migrate_bucket(struct rte_hash *h, uint32_t bkt_idx)
+{
+	struct rte_hash *next = h->resize->next;
+	struct rte_hash_bucket *cur_bkt;
+	struct rte_hash_key *k;
+	unsigned int i;
+	int32_t ret;
+
+	FOR_EACH_BUCKET(cur_bkt, &h->buckets[bkt_idx]) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (cur_bkt->key_idx[i] == EMPTY_SLOT)
+				continue;
+
+			k = (struct rte_hash_key *) ((char *)h->key_store +
+				cur_bkt->key_idx[i] * h->key_entry_size);
+			ret = __rte_hash_add_key_with_hash(next, k->key,
+					rte_hash_hash(h, k->key), k->pdata);
+			if (ret < 0)
+				return ret;
+
+			__rte_hash_resize_unlink(h, cur_bkt, i);
+		}
+	}
+
+	return 0;
+}
+
+/* Hand the tables of src over to dst */
+static void
+__rte_hash_set_tables(struct rte_hash *dst, const struct rte_hash *src)
+{
+	dst->entries = src->entries;
+	dst->num_buckets = src->num_buckets;
+	dst->bucket_bitmask = src->bucket_bitmask;
+	dst->free_slots = src->free_slots;
+	dst->key_store = src->key_store;
+	dst->buckets = src->buckets;
+	dst->buckets_ext = src->buckets_ext;
+	dst->free_ext_bkts = src->free_ext_bkts;
+	dst->ext_bkt_to_free = src->ext_bkt_to_free;
+	dst->tbl_chng_cnt = src->tbl_chng_cnt;
+}
+
+/* End a resize: the hash table takes the tables of the new table over and
+ * the old tables are freed.
+ */
+static void
+__rte_hash_resize_finish(struct rte_hash *h)
+{
+	struct rte_hash_resize *rs = h->resize;
+	struct rte_hash_rcu_config *rcu_cfg = h->hash_rcu_cfg;
+	struct rte_hash *next = rs->next;
+	struct rte_hash_rcu_config cfg;
+	struct rte_hash old;
+
+	/* The readers stop looking the old table up. Once they are all
+	 * done with it, the tables of the hash table can be replaced.
+	 */
+	__atomic_store_n(&rs->migrated, 1, __ATOMIC_RELEASE);
+	if (rcu_cfg != NULL)
+		rte_rcu_qsbr_synchronize(rcu_cfg->v, RTE_QSBR_THRID_INVALID);
+
+	/* Free the resources of the keys deleted from both tables, the
+	 * defer queues refer to the tables they were created for.
+	 */
+	if (h->dq != NULL) {
+		rte_rcu_qsbr_dq_delete(h->dq);
+		h->dq = NULL;
+	}
+	if (next->dq != NULL) {
+		rte_rcu_qsbr_dq_delete(next->dq);
+		next->dq = NULL;
+	}
+
+	old = *h;
+	__rte_hash_set_tables(h, next);
+	__atomic_store_n(&h->resize, NULL, __ATOMIC_RELEASE);
+
+	if (rcu_cfg != NULL) {
+		/* Wait for the readers still looking the new table up
+		 * through the resize state.
+		 */
+		rte_rcu_qsbr_synchronize(rcu_cfg->v, RTE_QSBR_THRID_INVALID);
+
+		/* Size the defer queue for the new table */
+		if (rcu_cfg->mode == RTE_HASH_QSBR_MODE_DQ) {
+			cfg = *rcu_cfg;
+			cfg.dq_size = next->hash_rcu_cfg->dq_size;
+			h->hash_rcu_cfg = NULL;
+			if (rte_hash_rcu_qsbr_add(h, &cfg) == 0) {
+				rte_free(rcu_cfg);
+			} else {
+				RTE_LOG(ERR, HASH,
+					"defer queue creation failed, using RCU sync mode\n");
+				rcu_cfg->mode = RTE_HASH_QSBR_MODE_SYNC;
+				h->hash_rcu_cfg = rcu_cfg;
+			}
+		}
+	}
+
+	__rte_hash_set_tables(next, &old);
+	__rte_hash_free_tables(next);
+	rte_free(next);
+	rte_free(rs);
+}
+
+int
+rte_hash_resize(struct rte_hash *h, uint32_t entries)
+{
+	struct rte_hash_parameters params = {0};
+	struct rte_hash_rcu_config cfg;
+	char name[RTE_HASH_NAMESIZE];
+	struct rte_hash_resize *rs;
+	struct rte_hash *next;
+
+	if (h == NULL || entries <= h->entries ||
+			entries > RTE_HASH_ENTRIES_MAX)
+		return -EINVAL;
+
+	if (h->resize != NULL)
+		return -EBUSY;
+
+	/* The writers must be serialized by the application and the key
+	 * indexes must be freed by the library.
+	 */
+	if (h->writer_takes_lock ||
+			(h->no_free_on_del && h->hash_rcu_cfg == NULL))
+		return -ENOTSUP;
+
+	/* The keys are migrated to the buckets of their hash */
+	if (h->ext_sig_keys)
+		return -ENOTSUP;
+
+	rs = rte_zmalloc_socket(NULL, sizeof(*rs), 0, h->socket_id);
+	if (rs == NULL)
+		return -ENOMEM;
+
+	/* The rings of the new table are named after it, pick a name not
+	 * used by the previous tables.
+	 */
+	snprintf(name, sizeof(name), "R%u_%s", h->nb_resizes + 1, h->name);
+	params.name = name;
+	params.entries = entries;
+	params.key_len = h->key_len;
+	params.hash_func = h->hash_func;
+	params.hash_func_init_val = h->hash_func_init_val;
+	params.socket_id = h->socket_id;
+	if (h->hw_trans_mem_support)
+		params.extra_flag |= RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT;
+	if (h->ext_table_support)
+		params.extra_flag |= RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	if (h->no_free_on_del)
+		params.extra_flag |= RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL;
+	if (h->readwrite_concur_lf_support)
+		params.extra_flag |= RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+
+	next = __rte_hash_create(&params, 0);
+	if (next == NULL) {
+		rte_free(rs);
+		return -ENOMEM;
+	}
+	next->cmp_jump_table_idx = h->cmp_jump_table_idx;
+	next->rte_hash_custom_cmp_eq = h->rte_hash_custom_cmp_eq;
+
+	if (h->hash_rcu_cfg != NULL) {
+		cfg = *h->hash_rcu_cfg;
+		/* A defer queue of the default size grows with the table */
+		if (cfg.dq_size == h->entries + 1)
+			cfg.dq_size = 0;
+		if (rte_hash_rcu_qsbr_add(next, &cfg) != 0) {
+			__rte_hash_free_tables(next);
+			rte_free(next);
+			rte_free(rs);
+			return -rte_errno;
+		}
+	}
+
+	rs->next = next;
+	h->nb_resizes++;
+
+	/* Readers look the new table up from now on */
+	__atomic_store_n(&h->resize, rs, __ATOMIC_RELEASE);
+
+	/* Wait for the readers still looking the old table up alone,
+	 * before a key is moved out of it.
+	 */
+	if (h->hash_rcu_cfg != NULL)
+		rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+					 RTE_QSBR_THRID_INVALID);
+
+	return 0;
+}
+
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t nb_buckets)
+{
+	struct rte_hash_resize *rs;
+	int ret;
+
+	if (h == NULL)
+		return -EINVAL;
+
+	rs = h->resize;
+	if (rs == NULL)
+		return 0;
+
+	for (; nb_buckets != 0 && rs->cursor < h->num_buckets; nb_buckets--) {
+		ret = __rte_hash_resize_migrate_bucket(h, rs->cursor);
+		if (ret < 0)
+			return ret;
+		rs->cursor++;
+	}
+
+	if (rs->cursor < h->num_buckets)
+		return h->num_buckets - rs->cursor;
+
+	__rte_hash_resize_finish(h);
+
+	return 0;
+}
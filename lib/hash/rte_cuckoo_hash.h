@@ -156,6 +156,16 @@ struct rte_hash_bucket {
 	void *next;
 } __rte_cache_aligned;
 
+/** State of an online resize of a hash table. */
+struct rte_hash_resize {
+	struct rte_hash *next;
+	/**< Larger table the keys are migrated to. */
+	uint32_t cursor;
+	/**< Next bucket of the old table to migrate. */
+	uint32_t migrated;
+	/**< Set once the old table is empty, readers then skip it. */
+};
+
 /** A hash table structure. */
 struct rte_hash {
 	char name[RTE_HASH_NAMESIZE];   /**< Name of the hash. */
@@ -173,6 +183,11 @@ struct rte_hash {
 	/**< HASH RCU QSBR configuration structure */
 	struct rte_rcu_qsbr_dq *dq;	/**< RCU QSBR defer queue. */
 
+	int socket_id;                  /**< Socket of the hash memory. */
+	uint32_t nb_resizes;            /**< Number of resizes started. */
+	uint8_t ext_sig_keys;
+	/**< If keys were added with a signature other than their hash. */
+
 	/* Fields used in lookup */
 
 	uint32_t key_len __rte_cache_aligned;
@@ -225,6 +240,8 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+	struct rte_hash_resize *resize;
+	/**< Resize in progress, NULL if none. */
 } __rte_cache_aligned;
 
 struct queue_node {
@@ -322,6 +322,39 @@ rte_hash_add_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add multiple keys to an existing hash table, each with its own data.
+ * This operation has the same thread safety as rte_hash_add_key_data().
+ * The signatures of the whole burst are computed and the buckets prefetched
+ * before updating the table, and the writer lock (if any) is taken only
+ * once for the burst. If a key already exists in the table, its data is
+ * updated.
+ *
+ * @param h
+ *   Hash table to add the keys to.
+ * @param keys
+ *   A pointer to a list of keys to add.
+ * @param data
+ *   A pointer to a list of data to add, one entry per key.
+ *   If NULL, all the keys are added without data.
+ * @param num_keys
+ *   How many keys are in the keys list (at most RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing a list of values, corresponding to the list of keys,
+ *   which are the same values rte_hash_add_key() would return for each key:
+ *   a unique offset into an array of user data, or a negative error code
+ *   (-ENOSPC if there is no space in the hash for this key).
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys added or updated.
+ */
+__rte_experimental
+int
+rte_hash_add_key_bulk_data(const struct rte_hash *h, const void **keys,
+		void **data, uint32_t num_keys, int32_t *positions);
+
 /**
  * Remove a key from an existing hash table.
  * This operation is not multi-thread safe
@@ -384,6 +417,35 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Remove multiple keys from an existing hash table.
+ * This operation has the same thread safety, and the same behavior
+ * regarding the freeing of key indexes, as rte_hash_del_key().
+ * The writer lock (if any) is taken only once for the burst and, when the
+ * integrated RCU QSBR is used in RTE_HASH_QSBR_MODE_SYNC mode, a single
+ * grace period is waited for all the deleted keys.
+ *
+ * @param h
+ *   Hash table to remove the keys from.
+ * @param keys
+ *   A pointer to a list of keys to remove.
+ * @param num_keys
+ *   How many keys are in the keys list (at most RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing a list of values, corresponding to the list of keys,
+ *   which are the same values that were returned when each key was added.
+ *   If a key in the list was not found, then -ENOENT will be the value.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of keys removed.
+ */
+__rte_experimental
+int
+rte_hash_del_key_bulk(const struct rte_hash *h, const void **keys,
+		uint32_t num_keys, int32_t *positions);
+
 /**
  * Find a key in the hash table given the position.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -400,6 +462,7 @@ rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t
  *   - 0 if retrieved successfully
  *   - -EINVAL if the parameters are invalid.
  *   - -ENOENT if no valid key is found in the given position.
+ *   - -EBUSY if the hash table is being resized.
  */
 int
 rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
@@ -429,6 +492,7 @@ rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
  * @return
  *   - 0 if freed successfully
  *   - -EINVAL if the parameters are invalid.
+ *   - -EBUSY if the hash table is being resized.
  */
 __rte_experimental
 int
@@ -651,6 +715,8 @@ rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 
 /**
  * Iterate through the hash table, returning key-value pairs.
+ * The keys migrated by rte_hash_resize_step() during an iteration
+ * may be missed or returned twice.
  *
  * @param h
  *   Hash table to iterate
@@ -694,6 +760,84 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 __rte_experimental
 int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Start growing a hash table online.
+ *
+ * A larger table is allocated and the keys are migrated to it bucket by
+ * bucket by rte_hash_resize_step(). Until the resize completes, the keys
+ * are looked up in the current table, then in the larger one, and the
+ * added keys go to the larger table: the hash table remains usable by the
+ * readers and the writer for the whole resize.
+ *
+ * This is a writer operation, it must be serialized with the other writer
+ * operations. Tables created with RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD or
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY are not supported. A table created
+ * with RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF or
+ * RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL must have the integrated RCU QSBR
+ * enabled with rte_hash_rcu_qsbr_add(). The resize then waits for a grace
+ * period of its RCU QSBR variable before returning, so that no reader
+ * looks a migrated key up in the current table only, and the calling
+ * thread must not be a reader registered with it.
+ *
+ * The keys are migrated to the buckets of the hash computed by the hash
+ * function of the table. A table is therefore not supported once a key has
+ * been added to it with rte_hash_add_key_with_hash() or
+ * rte_hash_add_key_with_hash_data() and a signature other than this hash,
+ * e.g. the RSS hash of a NIC, even if this key was deleted since.
+ *
+ * The position of a key, as returned by rte_hash_add_key() and the
+ * lookup functions, changes when the key is migrated. The applications
+ * resizing a table should store their data with the rte_hash_xxx_data()
+ * functions.
+ *
+ * @param h
+ *   Hash table to resize.
+ * @param entries
+ *   New number of entries of the hash table, larger than the current one.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EBUSY if a resize is already in progress.
+ *   - -ENOTSUP if the hash table cannot be resized.
+ *   - -ENOMEM if the new table cannot be allocated.
+ */
+__rte_experimental
+int
+rte_hash_resize(struct rte_hash *h, uint32_t entries);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Migrate some buckets of a hash table being resized to the new table.
+ *
+ * Once all the buckets are migrated, the hash table uses the new table
+ * and the memory of the previous table is freed. When the integrated RCU
+ * QSBR is enabled, this last step waits for two grace periods of its RCU
+ * QSBR variable, so the calling thread must not be a reader registered
+ * with it.
+ *
+ * This is a writer operation, it must be serialized with the other writer
+ * operations.
+ *
+ * @param h
+ *   Hash table being resized.
+ * @param nb_buckets
+ *   Maximum number of buckets to migrate. 0 only completes a resize
+ *   whose buckets are all migrated.
+ * @return
+ *   - 0 if the resize is complete, or if no resize is in progress.
+ *   - A positive value, the number of buckets left to migrate.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOSPC if a key could not be added to the new table.
+ */
+__rte_experimental
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t nb_buckets);
+
 #ifdef __cplusplus
 }
 #endif
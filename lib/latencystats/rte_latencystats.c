@@ -2,6 +2,8 @@
  * Copyright(c) 2018 Intel Corporation
  */
 
+#include <ctype.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <stdbool.h>
@@ -16,6 +18,7 @@
 #include <rte_metrics.h>
 #include <rte_memzone.h>
 #include <rte_lcore.h>
+#include <rte_telemetry.h>
 
 #include "rte_latencystats.h"
 
@@ -23,7 +26,7 @@
 #define NS_PER_SEC 1E9
 
 /** Clock cycles per nano second */
-static uint64_t
+static double
 latencystat_cycles_per_ns(void)
 {
 	return rte_get_timer_hz() / NS_PER_SEC;
@@ -45,77 +48,326 @@ timestamp_dynfield(struct rte_mbuf *mbuf)
 static const char *MZ_RTE_LATENCY_STATS = "rte_latencystats";
 static int latency_stats_index;
 static uint64_t samp_intvl;
-static uint64_t timer_tsc;
-static uint64_t prev_tsc;
+
+/*
+ * The latencies are recorded in log-linear histograms: each power of two
+ * range of cycles is split in LATENCY_HIST_SUB_COUNT buckets of equal width,
+ * so that a bucket width is at most 1/LATENCY_HIST_SUB_COUNT of its values.
+ * The latencies of 2^LATENCY_HIST_MAX_BITS cycles and more are all recorded
+ * in the last bucket.
+ */
+#define LATENCY_HIST_SUB_BITS 5
+#define LATENCY_HIST_SUB_COUNT (1 << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_MAX_BITS 40
+#define LATENCY_HIST_NB_BUCKETS \
+	((LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 1) << \
+	 LATENCY_HIST_SUB_BITS)
+
+struct latency_hist {
+	uint64_t count; /**< Number of latency samples */
+	uint64_t sum; /**< Sum of the samples in cycles */
+	uint64_t min; /**< Minimum sample in cycles, UINT64_MAX if none */
+	uint64_t max; /**< Maximum sample in cycles */
+	uint64_t buckets[LATENCY_HIST_NB_BUCKETS];
+};
+
+/*
+ * Latency stats of a Tx queue. A Tx queue is only used by one lcore at a time,
+ * so that its stats are updated without lock and merged when read. The queues
+ * of the devices supporting DEV_TX_OFFLOAD_MT_LOCKFREE can be used by several
+ * lcores at once, their histogram is updated with atomic operations.
+ */
+struct latency_stats_queue {
+	uint16_t port_id;
+	uint16_t queue_id;
+	bool mt_safe; /**< Queue may be used by several lcores at once */
+	float jitter; /**< Latency variation in cycles */
+	uint64_t prev_latency; /**< Previous sample, for the jitter */
+	struct latency_hist hist;
+} __rte_cache_aligned;
 
 struct rte_latency_stats {
-	float min_latency; /**< Minimum latency in nano seconds */
-	float avg_latency; /**< Average latency in nano seconds */
-	float max_latency; /**< Maximum latency in nano seconds */
-	float jitter; /** Latency variation */
-	rte_spinlock_t lock; /** Latency calculation lock */
+	uint32_t nb_queues;
+	struct latency_stats_queue queues[];
 };
 
 static struct rte_latency_stats *glob_stats;
 
 struct rxtx_cbs {
 	const struct rte_eth_rxtx_callback *cb;
-};
+	uint64_t timer_tsc; /**< Cycles since the last Rx timestamp */
+	uint64_t prev_tsc; /**< Time of the last Rx timestamp check */
+} __rte_cache_aligned;
 
 static struct rxtx_cbs rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 static struct rxtx_cbs tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
-struct latency_stats_nameoff {
-	char name[RTE_ETH_XSTATS_NAME_SIZE];
-	unsigned int offset;
+enum latency_stats_id {
+	LATENCY_STATS_MIN,
+	LATENCY_STATS_AVG,
+	LATENCY_STATS_MAX,
+	LATENCY_STATS_JITTER,
+	LATENCY_STATS_P50,
+	LATENCY_STATS_P90,
+	LATENCY_STATS_P99,
+	LATENCY_STATS_P99_9,
+	NUM_LATENCY_STATS
 };
 
-static const struct latency_stats_nameoff lat_stats_strings[] = {
-	{"min_latency_ns", offsetof(struct rte_latency_stats, min_latency)},
-	{"avg_latency_ns", offsetof(struct rte_latency_stats, avg_latency)},
-	{"max_latency_ns", offsetof(struct rte_latency_stats, max_latency)},
-	{"jitter_ns", offsetof(struct rte_latency_stats, jitter)},
+static const char * const lat_stats_strings[NUM_LATENCY_STATS] = {
+	[LATENCY_STATS_MIN] = "min_latency_ns",
+	[LATENCY_STATS_AVG] = "avg_latency_ns",
+	[LATENCY_STATS_MAX] = "max_latency_ns",
+	[LATENCY_STATS_JITTER] = "jitter_ns",
+	[LATENCY_STATS_P50] = "p50_latency_ns",
+	[LATENCY_STATS_P90] = "p90_latency_ns",
+	[LATENCY_STATS_P99] = "p99_latency_ns",
+	[LATENCY_STATS_P99_9] = "p99_9_latency_ns",
 };
 
-#define NUM_LATENCY_STATS (sizeof(lat_stats_strings) / \
-				sizeof(lat_stats_strings[0]))
+/* Percentiles reported from the histograms, in parts per million */
+static const struct {
+	enum latency_stats_id id;
+	uint32_t ppm;
+} lat_stats_percentiles[] = {
+	{ LATENCY_STATS_P50, 500000 },
+	{ LATENCY_STATS_P90, 900000 },
+	{ LATENCY_STATS_P99, 990000 },
+	{ LATENCY_STATS_P99_9, 999000 },
+};
+
+static inline unsigned int
+latency_hist_bucket(uint64_t latency)
+{
+	unsigned int msb;
+
+	if (latency < LATENCY_HIST_SUB_COUNT)
+		return latency;
+	if (latency >= (UINT64_C(1) << LATENCY_HIST_MAX_BITS))
+		return LATENCY_HIST_NB_BUCKETS - 1;
+
+	msb = rte_fls_u64(latency) - 1;
+	return ((msb - LATENCY_HIST_SUB_BITS + 1) << LATENCY_HIST_SUB_BITS) |
+		((latency >> (msb - LATENCY_HIST_SUB_BITS)) &
+		 (LATENCY_HIST_SUB_COUNT - 1));
+}
+
+/* Middle of the range of latencies recorded in a bucket */
+static uint64_t
+latency_hist_bucket_value(unsigned int bucket)
+{
+	unsigned int shift;
+	uint64_t low;
+
+	if (bucket < LATENCY_HIST_SUB_COUNT)
+		return bucket;
+
+	shift = (bucket >> LATENCY_HIST_SUB_BITS) - 1;
+	low = (uint64_t)(LATENCY_HIST_SUB_COUNT |
+			 (bucket & (LATENCY_HIST_SUB_COUNT - 1))) << shift;
+	return low + ((UINT64_C(1) << shift) >> 1);
+}
+
+static inline void
+latency_atomic_min(uint64_t *min, uint64_t latency)
+{
+	uint64_t cur = __atomic_load_n(min, __ATOMIC_RELAXED);
+
+	while (latency < cur && !__atomic_compare_exchange_n(min, &cur,
+			latency, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+static inline void
+latency_atomic_max(uint64_t *max, uint64_t latency)
+{
+	uint64_t cur = __atomic_load_n(max, __ATOMIC_RELAXED);
+
+	while (latency > cur && !__atomic_compare_exchange_n(max, &cur,
+			latency, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+static inline void
+latency_stats_queue_add(struct latency_stats_queue *q, uint64_t latency)
+{
+	struct latency_hist *hist = &q->hist;
+	unsigned int bucket = latency_hist_bucket(latency);
+	uint64_t delta;
+
+	/*
+	 * The jitter is calculated as statistical mean of interpacket
+	 * delay variation. The "jitter estimate" is computed by taking
+	 * the absolute values of the ipdv sequence and applying an
+	 * exponential filter with parameter 1/16 to generate the
+	 * estimate. i.e J=J+(|D(i-1,i)|-J)/16. Where J is jitter,
+	 * D(i-1,i) is difference in latency of two consecutive packets
+	 * i-1 and i.
+	 * Reference: Calculated as per RFC 5481, sec 4.1,
+	 * RFC 3393 sec 4.5, RFC 1889 sec.
+	 * It is only an estimate on the queues used by several lcores.
+	 */
+	delta = latency > q->prev_latency ? latency - q->prev_latency :
+		q->prev_latency - latency;
+	q->jitter += ((float)delta - q->jitter) / 16;
+	q->prev_latency = latency;
+
+	if (unlikely(q->mt_safe)) {
+		__atomic_fetch_add(&hist->buckets[bucket], 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&hist->sum, latency, __ATOMIC_RELAXED);
+		latency_atomic_min(&hist->min, latency);
+		latency_atomic_max(&hist->max, latency);
+		__atomic_fetch_add(&hist->count, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	hist->buckets[bucket]++;
+	hist->sum += latency;
+	if (latency < hist->min)
+		hist->min = latency;
+	if (latency > hist->max)
+		hist->max = latency;
+	__atomic_store_n(&hist->count, hist->count + 1, __ATOMIC_RELEASE);
+}
+
+static const struct rte_latency_stats *
+latency_stats_lookup(void)
+{
+	const struct rte_memzone *mz;
+
+	if (glob_stats != NULL)
+		return glob_stats;
+
+	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
+	if (mz == NULL) {
+		RTE_LOG(ERR, LATENCY_STATS,
+			"Latency stats memzone not found\n");
+		return NULL;
+	}
+	glob_stats = mz->addr;
+
+	return glob_stats;
+}
+
+/*
+ * Merge the histograms of the queues of a port, or of all the ports if
+ * port_id is -1, and of a queue if queue_id is not -1, then compute the
+ * latency stats in nano seconds. Return the number of latency samples.
+ */
+static uint64_t
+latency_stats_compute(const struct rte_latency_stats *stats, int port_id,
+		int queue_id, uint64_t values[NUM_LATENCY_STATS])
+{
+	struct latency_hist merged;
+	double cycles_per_ns = latencystat_cycles_per_ns();
+	double jitter = 0;
+	uint64_t count, rank, seen;
+	unsigned int i, j, bucket;
+
+	memset(&merged, 0, sizeof(merged));
+	merged.min = UINT64_MAX;
+
+	for (i = 0; i < stats->nb_queues; i++) {
+		const struct latency_stats_queue *q = &stats->queues[i];
+		const struct latency_hist *hist = &q->hist;
+
+		if ((port_id >= 0 && q->port_id != port_id) ||
+		    (queue_id >= 0 && q->queue_id != queue_id))
+			continue;
+
+		/* The buckets may be ahead of the count, never behind it */
+		count = __atomic_load_n(&hist->count, __ATOMIC_ACQUIRE);
+		if (count == 0)
+			continue;
+
+		merged.count += count;
+		merged.sum += __atomic_load_n(&hist->sum, __ATOMIC_RELAXED);
+		merged.min = RTE_MIN(merged.min,
+			__atomic_load_n(&hist->min, __ATOMIC_RELAXED));
+		merged.max = RTE_MAX(merged.max,
+			__atomic_load_n(&hist->max, __ATOMIC_RELAXED));
+		for (j = 0; j < LATENCY_HIST_NB_BUCKETS; j++)
+			merged.buckets[j] += __atomic_load_n(&hist->buckets[j],
+					__ATOMIC_RELAXED);
+		jitter += (double)q->jitter * count;
+	}
+
+	memset(values, 0, sizeof(uint64_t) * NUM_LATENCY_STATS);
+	if (merged.count == 0)
+		return 0;
+
+	values[LATENCY_STATS_MIN] = merged.min;
+	values[LATENCY_STATS_AVG] = merged.sum / merged.count;
+	values[LATENCY_STATS_MAX] = merged.max;
+	values[LATENCY_STATS_JITTER] = jitter / merged.count;
+
+	seen = 0;
+	bucket = 0;
+	for (i = 0; i < RTE_DIM(lat_stats_percentiles); i++) {
+		rank = ((double)merged.count * lat_stats_percentiles[i].ppm +
+			999999) / 1000000;
+		while (bucket < LATENCY_HIST_NB_BUCKETS - 1 &&
+		       seen + merged.buckets[bucket] < rank)
+			seen += merged.buckets[bucket++];
+		values[lat_stats_percentiles[i].id] = RTE_MIN(merged.max,
+			RTE_MAX(merged.min, latency_hist_bucket_value(bucket)));
+	}
+
+	for (i = 0; i < NUM_LATENCY_STATS; i++)
+		values[i] = (uint64_t)floor(values[i] / cycles_per_ns);
+
+	return merged.count;
+}
 
 int32_t
 rte_latencystats_update(void)
 {
-	unsigned int i;
-	float *stats_ptr = NULL;
-	uint64_t values[NUM_LATENCY_STATS] = {0};
+	uint64_t values[NUM_LATENCY_STATS];
+	uint32_t i;
 	int ret;
 
-	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
-		values[i] = (uint64_t)floor((*stats_ptr)/
-				latencystat_cycles_per_ns());
-	}
+	if (glob_stats == NULL)
+		return -EINVAL;
 
+	latency_stats_compute(glob_stats, -1, -1, values);
 	ret = rte_metrics_update_values(RTE_METRICS_GLOBAL,
 					latency_stats_index,
 					values, NUM_LATENCY_STATS);
-	if (ret < 0)
+	if (ret < 0) {
 		RTE_LOG(INFO, LATENCY_STATS, "Failed to push the stats\n");
+		return ret;
+	}
 
-	return ret;
+	/* Per port stats, the queues of a port are contiguous */
+	for (i = 0; i < glob_stats->nb_queues; i++) {
+		uint16_t pid = glob_stats->queues[i].port_id;
+
+		if (i > 0 && glob_stats->queues[i - 1].port_id == pid)
+			continue;
+
+		latency_stats_compute(glob_stats, pid, -1, values);
+		ret = rte_metrics_update_values(pid, latency_stats_index,
+						values, NUM_LATENCY_STATS);
+		if (ret < 0) {
+			RTE_LOG(INFO, LATENCY_STATS,
+				"Failed to push the stats of port %u\n", pid);
+			return ret;
+		}
+	}
+
+	return 0;
 }
 
 static void
 rte_latencystats_fill_values(struct rte_metric_value *values)
 {
+	uint64_t stats[NUM_LATENCY_STATS];
 	unsigned int i;
-	float *stats_ptr = NULL;
 
+	latency_stats_compute(glob_stats, -1, -1, stats);
 	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
 		values[i].key = i;
-		values[i].value = (uint64_t)floor((*stats_ptr)/
-						latencystat_cycles_per_ns());
+		values[i].value = stats[i];
 	}
 }
 
@@ -125,8 +377,9 @@ add_time_stamps(uint16_t pid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
 		uint16_t max_pkts __rte_unused,
-		void *user_cb __rte_unused)
+		void *arg)
 {
+	struct rxtx_cbs *cbs = arg;
 	unsigned int i;
 	uint64_t diff_tsc, now;
 
@@ -136,16 +389,16 @@ add_time_stamps(uint16_t pid __rte_unused,
 	 */
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
-		diff_tsc = now - prev_tsc;
-		timer_tsc += diff_tsc;
+		diff_tsc = now - cbs->prev_tsc;
+		cbs->timer_tsc += diff_tsc;
 
 		if ((pkts[i]->ol_flags & timestamp_dynflag) == 0
-				&& (timer_tsc >= samp_intvl)) {
+				&& (cbs->timer_tsc >= samp_intvl)) {
 			*timestamp_dynfield(pkts[i]) = now;
 			pkts[i]->ol_flags |= timestamp_dynflag;
-			timer_tsc = 0;
+			cbs->timer_tsc = 0;
 		}
-		prev_tsc = now;
+		cbs->prev_tsc = now;
 		now = rte_rdtsc();
 	}
 
@@ -157,68 +410,32 @@ calc_latency(uint16_t pid __rte_unused,
 		uint16_t qid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
-		void *_ __rte_unused)
+		void *arg)
 {
-	unsigned int i, cnt = 0;
+	struct latency_stats_queue *q = arg;
+	unsigned int i;
 	uint64_t now;
-	float latency[nb_pkts];
-	static float prev_latency;
-	/*
-	 * Alpha represents degree of weighting decrease in EWMA,
-	 * a constant smoothing factor between 0 and 1. The value
-	 * is used below for measuring average latency.
-	 */
-	const float alpha = 0.2;
 
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
 		if (pkts[i]->ol_flags & timestamp_dynflag)
-			latency[cnt++] = now - *timestamp_dynfield(pkts[i]);
-	}
-
-	rte_spinlock_lock(&glob_stats->lock);
-	for (i = 0; i < cnt; i++) {
-		/*
-		 * The jitter is calculated as statistical mean of interpacket
-		 * delay variation. The "jitter estimate" is computed by taking
-		 * the absolute values of the ipdv sequence and applying an
-		 * exponential filter with parameter 1/16 to generate the
-		 * estimate. i.e J=J+(|D(i-1,i)|-J)/16. Where J is jitter,
-		 * D(i-1,i) is difference in latency of two consecutive packets
-		 * i-1 and i.
-		 * Reference: Calculated as per RFC 5481, sec 4.1,
-		 * RFC 3393 sec 4.5, RFC 1889 sec.
-		 */
-		glob_stats->jitter +=  (fabsf(prev_latency - latency[i])
-					- glob_stats->jitter)/16;
-		if (glob_stats->min_latency == 0)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] < glob_stats->min_latency)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] > glob_stats->max_latency)
-			glob_stats->max_latency = latency[i];
-		/*
-		 * The average latency is measured using exponential moving
-		 * average, i.e. using EWMA
-		 * https://en.wikipedia.org/wiki/Moving_average
-		 */
-		glob_stats->avg_latency +=
-			alpha * (latency[i] - glob_stats->avg_latency);
-		prev_latency = latency[i];
+			latency_stats_queue_add(q,
+				now - *timestamp_dynfield(pkts[i]));
 	}
-	rte_spinlock_unlock(&glob_stats->lock);
 
 	return nb_pkts;
 }
 
 int
 rte_latencystats_init(uint64_t app_samp_intvl,
-		rte_latency_stats_flow_type_fn user_cb)
+		rte_latency_stats_flow_type_fn user_cb __rte_unused)
 {
 	unsigned int i;
 	uint16_t pid;
 	uint16_t qid;
+	uint32_t nb_queues = 0;
 	struct rxtx_cbs *cbs = NULL;
+	struct latency_stats_queue *q;
 	const char *ptr_strings[NUM_LATENCY_STATS] = {0};
 	const struct rte_memzone *mz = NULL;
 	const unsigned int flags = 0;
@@ -227,8 +444,16 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	if (rte_memzone_lookup(MZ_RTE_LATENCY_STATS))
 		return -EEXIST;
 
+	RTE_ETH_FOREACH_DEV(pid) {
+		struct rte_eth_dev_info dev_info;
+
+		if (rte_eth_dev_info_get(pid, &dev_info) == 0)
+			nb_queues += dev_info.nb_tx_queues;
+	}
+
 	/** Allocate stats in shared memory fo multi process support */
-	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats),
+	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats) +
+					nb_queues * sizeof(glob_stats->queues[0]),
 					rte_socket_id(), flags);
 	if (mz == NULL) {
 		RTE_LOG(ERR, LATENCY_STATS, "Cannot reserve memory: %s:%d\n",
@@ -237,12 +462,12 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	}
 
 	glob_stats = mz->addr;
-	rte_spinlock_init(&glob_stats->lock);
+	memset(glob_stats, 0, mz->len);
 	samp_intvl = app_samp_intvl * latencystat_cycles_per_ns();
 
 	/** Register latency stats with stats library */
 	for (i = 0; i < NUM_LATENCY_STATS; i++)
-		ptr_strings[i] = lat_stats_strings[i].name;
+		ptr_strings[i] = lat_stats_strings[i];
 
 	latency_stats_index = rte_metrics_reg_names(ptr_strings,
 							NUM_LATENCY_STATS);
@@ -276,17 +501,29 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 
 		for (qid = 0; qid < dev_info.nb_rx_queues; qid++) {
 			cbs = &rx_cbs[pid][qid];
+			cbs->timer_tsc = 0;
+			cbs->prev_tsc = 0;
 			cbs->cb = rte_eth_add_first_rx_callback(pid, qid,
-					add_time_stamps, user_cb);
+					add_time_stamps, cbs);
 			if (!cbs->cb)
 				RTE_LOG(INFO, LATENCY_STATS, "Failed to "
 					"register Rx callback for pid=%d, "
 					"qid=%d\n", pid, qid);
 		}
 		for (qid = 0; qid < dev_info.nb_tx_queues; qid++) {
+			if (glob_stats->nb_queues == nb_queues)
+				break;
+
+			q = &glob_stats->queues[glob_stats->nb_queues++];
+			q->port_id = pid;
+			q->queue_id = qid;
+			q->mt_safe = !!(dev_info.tx_offload_capa &
+					DEV_TX_OFFLOAD_MT_LOCKFREE);
+			q->hist.min = UINT64_MAX;
+
 			cbs = &tx_cbs[pid][qid];
 			cbs->cb =  rte_eth_add_tx_callback(pid, qid,
-					calc_latency, user_cb);
+					calc_latency, q);
 			if (!cbs->cb)
 				RTE_LOG(INFO, LATENCY_STATS, "Failed to "
 					"register Tx callback for pid=%d, "
@@ -340,6 +577,7 @@ rte_latencystats_uninit(void)
 	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
 	if (mz)
 		rte_memzone_free(mz);
+	glob_stats = NULL;
 
 	return 0;
 }
@@ -353,7 +591,7 @@ rte_latencystats_get_names(struct rte_metric_name *names, uint16_t size)
 		return NUM_LATENCY_STATS;
 
 	for (i = 0; i < NUM_LATENCY_STATS; i++)
-		strlcpy(names[i].name, lat_stats_strings[i].name,
+		strlcpy(names[i].name, lat_stats_strings[i],
 			sizeof(names[i].name));
 
 	return NUM_LATENCY_STATS;
@@ -365,19 +603,60 @@ rte_latencystats_get(struct rte_metric_value *values, uint16_t size)
 	if (size < NUM_LATENCY_STATS || values == NULL)
 		return NUM_LATENCY_STATS;
 
-	if (rte_eal_process_type() == RTE_PROC_SECONDARY) {
-		const struct rte_memzone *mz;
-		mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
-		if (mz == NULL) {
-			RTE_LOG(ERR, LATENCY_STATS,
-				"Latency stats memzone not found\n");
-			return -ENOMEM;
-		}
-		glob_stats =  mz->addr;
-	}
+	if (latency_stats_lookup() == NULL)
+		return -ENOMEM;
 
 	/* Retrieve latency stats */
 	rte_latencystats_fill_values(values);
 
 	return NUM_LATENCY_STATS;
 }
+
+static int
+latencystats_handle_stats(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	const struct rte_latency_stats *stats;
+	uint64_t values[NUM_LATENCY_STATS];
+	int port_id = -1, queue_id = -1;
+	uint64_t count;
+	unsigned int i;
+	char *end_param;
+
+	stats = latency_stats_lookup();
+	if (stats == NULL)
+		return -1;
+
+	if (params != NULL && strlen(params) != 0) {
+		if (!isdigit(*params))
+			return -1;
+		port_id = strtoul(params, &end_param, 0);
+		if (*end_param == ',') {
+			if (!isdigit(end_param[1]))
+				return -1;
+			queue_id = strtoul(end_param + 1, &end_param, 0);
+		}
+		if (*end_param != '\0')
+			RTE_LOG(NOTICE, LATENCY_STATS,
+				"Extra parameters passed to latencystats telemetry command, ignoring\n");
+		if (port_id >= RTE_MAX_ETHPORTS ||
+		    queue_id >= RTE_MAX_QUEUES_PER_PORT)
+			return -1;
+	}
+
+	count = latency_stats_compute(stats, port_id, queue_id, values);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_u64(d, "samples", count);
+	for (i = 0; i < NUM_LATENCY_STATS; i++)
+		rte_tel_data_add_dict_u64(d, lat_stats_strings[i], values[i]);
+
+	return 0;
+}
+
+RTE_INIT(latencystats_init_telemetry)
+{
+	rte_telemetry_register_cmd("/latencystats/stats",
+			latencystats_handle_stats,
+			"Returns the latency stats, with percentiles. Parameters: int port_id (optional), int queue_id (optional)");
+}
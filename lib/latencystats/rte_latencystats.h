@@ -10,6 +10,11 @@
  * RTE latency stats
  *
  * library to provide application and flow based latency stats.
+ *
+ * The latency of the sampled packets is recorded in a histogram per Tx queue,
+ * without lock. The histograms are merged when the stats are read, to report
+ * the minimum, average and maximum latency, the jitter and the 50th, 90th,
+ * 99th and 99.9th percentiles in nano seconds, globally and per port.
  */
 
 #include <stdint.h>
@@ -44,8 +49,8 @@ typedef uint16_t (*rte_latency_stats_flow_type_fn)(struct rte_mbuf *pkt,
  *  Registers Rx/Tx callbacks for each active port, queue.
  *
  * @param samp_intvl
- *  Sampling time period in nano seconds, at which packet
- *  should be marked with time stamp.
+ *  Sampling time period in nano seconds, at which a packet
+ *  of each Rx queue should be marked with time stamp.
  * @param user_cb
  *  Note: This param is for future flow based latency stats
  *  implementation.
@@ -64,7 +69,8 @@ int rte_latencystats_init(uint64_t samp_intvl,
 
 /**
  * Calculates the latency and jitter values internally, exposing the updated
- * values via *rte_latencystats_get* or the rte_metrics API.
+ * values via *rte_latencystats_get* or the rte_metrics API. The values are
+ * updated for RTE_METRICS_GLOBAL and for each port.
  * @return:
  *  0      : on Success
  *  < 0    : Error in updating values.
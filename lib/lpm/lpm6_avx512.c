@@ -0,0 +1,119 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <string.h>
+
+#include <rte_vect.h>
+#include <rte_lpm6.h>
+
+#include "lpm6.h"
+#include "lpm6_avx512.h"
+
+#define LPM6_VEC_LOOKUP_WIDTH	16
+
+static __rte_always_inline void
+transpose_x16(uint8_t ips[16][RTE_LPM6_IPV6_ADDR_SIZE], __m512i chunks[4])
+{
+	__m512i tmp1, tmp2, tmp3, tmp4;
+	__m512i tmp5, tmp6, tmp7, tmp8;
+	const __rte_x86_zmm_t perm_idxes = {
+		.u32 = { 0, 4, 8, 12, 2, 6, 10, 14,
+			1, 5, 9, 13, 3, 7, 11, 15
+		},
+	};
+
+	/* load all ip addresses */
+	tmp1 = _mm512_loadu_si512(&ips[0][0]);
+	tmp2 = _mm512_loadu_si512(&ips[4][0]);
+	tmp3 = _mm512_loadu_si512(&ips[8][0]);
+	tmp4 = _mm512_loadu_si512(&ips[12][0]);
+
+	/* transpose 4 byte chunks of 16 ips */
+	tmp5 = _mm512_unpacklo_epi32(tmp1, tmp2);
+	tmp7 = _mm512_unpackhi_epi32(tmp1, tmp2);
+	tmp6 = _mm512_unpacklo_epi32(tmp3, tmp4);
+	tmp8 = _mm512_unpackhi_epi32(tmp3, tmp4);
+
+	tmp1 = _mm512_unpacklo_epi32(tmp5, tmp6);
+	tmp3 = _mm512_unpackhi_epi32(tmp5, tmp6);
+	tmp2 = _mm512_unpacklo_epi32(tmp7, tmp8);
+	tmp4 = _mm512_unpackhi_epi32(tmp7, tmp8);
+
+	/* chunks[i] holds bytes 4*i .. 4*i + 3 of every ip */
+	chunks[0] = _mm512_permutexvar_epi32(perm_idxes.z, tmp1);
+	chunks[1] = _mm512_permutexvar_epi32(perm_idxes.z, tmp3);
+	chunks[2] = _mm512_permutexvar_epi32(perm_idxes.z, tmp2);
+	chunks[3] = _mm512_permutexvar_epi32(perm_idxes.z, tmp4);
+}
+
+static __rte_always_inline void
+lpm6_vec_lookup_x16(const struct rte_lpm6 *lpm,
+	uint8_t ips[16][RTE_LPM6_IPV6_ADDR_SIZE],
+	int32_t *next_hops, __mmask16 store_msk)
+{
+	const __m512i byte_msk = _mm512_set1_epi32(UINT8_MAX);
+	const __m512i ext_msk =
+		_mm512_set1_epi32(RTE_LPM6_VALID_EXT_ENTRY_BITMASK);
+	const __m512i nh_msk = _mm512_set1_epi32(RTE_LPM6_TBL8_BITMASK);
+	const __m512i miss = _mm512_set1_epi32(-1);
+	__m512i chunks[4];
+	__m512i idxes, res, byte;
+	__mmask16 ext, hit;
+	unsigned int k;
+
+	transpose_x16(ips, chunks);
+
+	/* tbl24 index is built from the first three bytes, big endian */
+	idxes = _mm512_or_epi32(
+		_mm512_slli_epi32(_mm512_and_epi32(chunks[0], byte_msk), 16),
+		_mm512_and_epi32(chunks[0], _mm512_set1_epi32(0xFF00)));
+	idxes = _mm512_or_epi32(idxes, _mm512_and_epi32(
+		_mm512_srli_epi32(chunks[0], 16), byte_msk));
+
+	res = _mm512_i32gather_epi32(idxes, (const int *)lpm->tbl24, 4);
+	ext = _mm512_cmpeq_epi32_mask(_mm512_and_epi32(res, ext_msk), ext_msk);
+
+	/* walk tbl8s only for the lanes that hit an extended entry */
+	for (k = LOOKUP_FIRST_BYTE - 1;
+			ext != 0 && k < RTE_LPM6_IPV6_ADDR_SIZE; k++) {
+		byte = _mm512_and_epi32(_mm512_srlv_epi32(chunks[k / 4],
+			_mm512_set1_epi32((k % 4) * BYTE_SIZE)), byte_msk);
+		idxes = _mm512_add_epi32(byte, _mm512_slli_epi32(
+			_mm512_and_epi32(res, nh_msk), BYTE_SIZE));
+		res = _mm512_mask_i32gather_epi32(res, ext, idxes,
+			(const int *)lpm->tbl8, 4);
+		ext = _mm512_mask_cmpeq_epi32_mask(ext,
+			_mm512_and_epi32(res, ext_msk), ext_msk);
+	}
+
+	hit = _mm512_test_epi32_mask(res,
+		_mm512_set1_epi32(RTE_LPM6_LOOKUP_SUCCESS));
+	res = _mm512_mask_and_epi32(miss, hit, res, nh_msk);
+	_mm512_mask_storeu_epi32(next_hops, store_msk, res);
+}
+
+void
+rte_lpm6_vec_lookup_bulk(const struct rte_lpm6 *lpm,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+	int32_t *next_hops, unsigned int n)
+{
+	uint8_t tail_ips[LPM6_VEC_LOOKUP_WIDTH][RTE_LPM6_IPV6_ADDR_SIZE];
+	unsigned int i, rem;
+
+	for (i = 0; i < n / LPM6_VEC_LOOKUP_WIDTH; i++)
+		lpm6_vec_lookup_x16(lpm,
+			(uint8_t (*)[RTE_LPM6_IPV6_ADDR_SIZE])
+			ips[i * LPM6_VEC_LOOKUP_WIDTH],
+			next_hops + i * LPM6_VEC_LOOKUP_WIDTH, UINT16_MAX);
+
+	rem = n % LPM6_VEC_LOOKUP_WIDTH;
+	if (rem == 0)
+		return;
+
+	/* unused lanes look up ::/0 and are not stored */
+	memset(tail_ips, 0, sizeof(tail_ips));
+	memcpy(tail_ips, ips[n - rem], rem * RTE_LPM6_IPV6_ADDR_SIZE);
+	lpm6_vec_lookup_x16(lpm, tail_ips, next_hops + n - rem,
+		(__mmask16)((1U << rem) - 1));
+}
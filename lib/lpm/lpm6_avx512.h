@@ -0,0 +1,13 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _LPM6_AVX512_H_
+#define _LPM6_AVX512_H_
+
+void
+rte_lpm6_vec_lookup_bulk(const struct rte_lpm6 *lpm,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+	int32_t *next_hops, unsigned int n);
+
+#endif /* _LPM6_AVX512_H_ */
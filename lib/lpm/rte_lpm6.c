@@ -25,25 +25,26 @@
 #include <assert.h>
 #include <rte_jhash.h>
 #include <rte_tailq.h>
+#include <rte_prefetch.h>
+#include <rte_vect.h>
+#include <rte_cpuflags.h>
 
 #include "rte_lpm6.h"
+#include "lpm6.h"
 
-#define RTE_LPM6_TBL24_NUM_ENTRIES        (1 << 24)
-#define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
-#define RTE_LPM6_TBL8_MAX_NUM_GROUPS      (1 << 21)
+#ifdef CC_LPM6_AVX512_SUPPORT
+#include "lpm6_avx512.h"
+#endif
 
-#define RTE_LPM6_VALID_EXT_ENTRY_BITMASK 0xA0000000
-#define RTE_LPM6_LOOKUP_SUCCESS          0x20000000
-#define RTE_LPM6_TBL8_BITMASK            0x001FFFFF
+#define RTE_LPM6_TBL8_MAX_NUM_GROUPS      (1 << 21)
 
 #define ADD_FIRST_BYTE                            3
-#define LOOKUP_FIRST_BYTE                         4
-#define BYTE_SIZE                                 8
-#define BYTES2_SIZE                              16
 
 #define RULE_HASH_TABLE_EXTRA_SPACE              64
 #define TBL24_IND                        UINT32_MAX
 
+#define LPM6_LOOKUP_MAX_INTERLEAVE                8
+
 #define lpm6_tbl8_gindex next_hop
 
 /** Flags for setting an entry as valid/invalid. */
@@ -59,17 +60,6 @@ static struct rte_tailq_elem rte_lpm6_tailq = {
 };
 EAL_REGISTER_TAILQ(rte_lpm6_tailq)
 
-/** Tbl entry structure. It is the same for both tbl24 and tbl8 */
-struct rte_lpm6_tbl_entry {
-	uint32_t next_hop:	21;  /**< Next hop / next table to be checked. */
-	uint32_t depth	:8;      /**< Rule depth. */
-
-	/* Flags. */
-	uint32_t valid     :1;   /**< Validation flag. */
-	uint32_t valid_group :1; /**< Group validation flag. */
-	uint32_t ext_entry :1;   /**< External entry. */
-};
-
 /** Rules tbl entry structure. */
 struct rte_lpm6_rule {
 	uint8_t ip[RTE_LPM6_IPV6_ADDR_SIZE]; /**< Rule IP address. */
@@ -94,28 +84,6 @@ struct rte_lpm_tbl8_hdr {
 	uint32_t ref_cnt; /**< table reference counter */
 };
 
-/** LPM6 structure. */
-struct rte_lpm6 {
-	/* LPM metadata. */
-	char name[RTE_LPM6_NAMESIZE];    /**< Name of the lpm. */
-	uint32_t max_rules;              /**< Max number of rules. */
-	uint32_t used_rules;             /**< Used rules so far. */
-	uint32_t number_tbl8s;           /**< Number of tbl8s to allocate. */
-
-	/* LPM Tables. */
-	struct rte_hash *rules_tbl; /**< LPM rules. */
-	struct rte_lpm6_tbl_entry tbl24[RTE_LPM6_TBL24_NUM_ENTRIES]
-			__rte_cache_aligned; /**< LPM tbl24 table. */
-
-	uint32_t *tbl8_pool; /**< pool of indexes of free tbl8s */
-	uint32_t tbl8_pool_pos; /**< current position in the tbl8 pool */
-
-	struct rte_lpm_tbl8_hdr *tbl8_hdrs; /* array of tbl8 headers */
-
-	struct rte_lpm6_tbl_entry tbl8[0]
-			__rte_cache_aligned; /**< LPM tbl8 table. */
-};
-
 /*
  * Takes an array of uint8_t (IPv6 address) and masks it using the depth.
  * It leaves untouched one bit per unit in the depth variable
@@ -357,6 +325,7 @@ rte_lpm6_create(const char *name, int socket_id,
 	lpm->rules_tbl = rules_tbl;
 	lpm->tbl8_pool = tbl8_pool;
 	lpm->tbl8_hdrs = tbl8_hdrs;
+	rte_lpm6_select_lookup(lpm, RTE_LPM6_LOOKUP_DEFAULT);
 
 	/* init the stack */
 	tbl8_pool_init(lpm);
@@ -972,10 +941,10 @@ rte_lpm6_lookup(const struct rte_lpm6 *lpm, const uint8_t *ip,
 }
 
 /*
- * Looks up a group of IP addresses
+ * Looks up a group of IP addresses, one at a time
  */
-int
-rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
+static void
+lpm6_lookup_bulk_scalar(const struct rte_lpm6 *lpm,
 		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
 		int32_t *next_hops, unsigned int n)
 {
@@ -986,10 +955,6 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 	uint8_t first_byte;
 	int status;
 
-	/* DEBUG: Check user input arguments. */
-	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
-		return -EINVAL;
-
 	for (i = 0; i < n; i++) {
 		first_byte = LOOKUP_FIRST_BYTE;
 		tbl24_index = (ips[i][0] << BYTES2_SIZE) |
@@ -1012,6 +977,138 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 		else
 			next_hops[i] = (int32_t)next_hop;
 	}
+}
+
+/*
+ * Looks up a group of IP addresses, walking the tables for "width"
+ * addresses in lockstep. The entry needed by each address at the next
+ * level is prefetched while the other addresses of the group are
+ * inspected, so the memory accesses of the group overlap.
+ */
+static __rte_always_inline void
+lpm6_lookup_bulk_interleaved(const struct rte_lpm6 *lpm,
+		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+		int32_t *next_hops, unsigned int n, const unsigned int width)
+{
+	const uint32_t *tbl[LPM6_LOOKUP_MAX_INTERLEAVE];
+	const uint32_t *tbl8 = (const uint32_t *)lpm->tbl8;
+	uint32_t tbl24_index, tbl_entry, active;
+	unsigned int i, j;
+	uint8_t first_byte;
+
+	for (i = 0; i + width <= n; i += width) {
+		for (j = 0; j < width; j++) {
+			tbl24_index = (ips[i + j][0] << BYTES2_SIZE) |
+					(ips[i + j][1] << BYTE_SIZE) |
+					ips[i + j][2];
+			tbl[j] = (const uint32_t *)&lpm->tbl24[tbl24_index];
+			rte_prefetch0(tbl[j]);
+		}
+
+		active = (1U << width) - 1;
+		first_byte = LOOKUP_FIRST_BYTE;
+		do {
+			for (j = 0; j < width; j++) {
+				if (!(active & (1U << j)))
+					continue;
+
+				tbl_entry = *tbl[j];
+				if ((tbl_entry & RTE_LPM6_VALID_EXT_ENTRY_BITMASK) ==
+						RTE_LPM6_VALID_EXT_ENTRY_BITMASK) {
+					tbl[j] = &tbl8[ips[i + j][first_byte - 1] +
+						(tbl_entry & RTE_LPM6_TBL8_BITMASK) *
+						RTE_LPM6_TBL8_GROUP_NUM_ENTRIES];
+					rte_prefetch0(tbl[j]);
+					continue;
+				}
+
+				next_hops[i + j] =
+					(tbl_entry & RTE_LPM6_LOOKUP_SUCCESS) ?
+					(int32_t)(tbl_entry & RTE_LPM6_TBL8_BITMASK) :
+					-1;
+				active &= ~(1U << j);
+			}
+			first_byte++;
+		} while (active != 0);
+	}
+
+	lpm6_lookup_bulk_scalar(lpm, &ips[i], &next_hops[i], n - i);
+}
+
+static inline int
+lpm6_vector_supported(void)
+{
+#ifdef CC_LPM6_AVX512_SUPPORT
+	return (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0) &&
+		(rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512);
+#else
+	return 0;
+#endif
+}
+
+/*
+ * Looks up a group of IP addresses
+ */
+int
+rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
+		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+		int32_t *next_hops, unsigned int n)
+{
+	/* DEBUG: Check user input arguments. */
+	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
+		return -EINVAL;
+
+	/*
+	 * The table is shared with the secondary processes, so it stores
+	 * the type of lookup, resolved here, rather than a function address.
+	 */
+	switch (lpm->lookup_type) {
+	case RTE_LPM6_LOOKUP_SCALAR_X4:
+		lpm6_lookup_bulk_interleaved(lpm, ips, next_hops, n, 4);
+		break;
+	case RTE_LPM6_LOOKUP_SCALAR_X8:
+		lpm6_lookup_bulk_interleaved(lpm, ips, next_hops, n, 8);
+		break;
+#ifdef CC_LPM6_AVX512_SUPPORT
+	case RTE_LPM6_LOOKUP_VECTOR_AVX512:
+		rte_lpm6_vec_lookup_bulk(lpm, ips, next_hops, n);
+		break;
+#endif
+	default:
+		lpm6_lookup_bulk_scalar(lpm, ips, next_hops, n);
+		break;
+	}
+
+	return 0;
+}
+
+/*
+ * Sets the bulk lookup implementation
+ */
+int
+rte_lpm6_select_lookup(struct rte_lpm6 *lpm, enum rte_lpm6_lookup_type type)
+{
+	if (lpm == NULL)
+		return -EINVAL;
+
+	switch (type) {
+	case RTE_LPM6_LOOKUP_SCALAR:
+	case RTE_LPM6_LOOKUP_SCALAR_X4:
+	case RTE_LPM6_LOOKUP_SCALAR_X8:
+		break;
+	case RTE_LPM6_LOOKUP_VECTOR_AVX512:
+		if (!lpm6_vector_supported())
+			return -EINVAL;
+		break;
+	case RTE_LPM6_LOOKUP_DEFAULT:
+		type = lpm6_vector_supported() ?
+			RTE_LPM6_LOOKUP_VECTOR_AVX512 : RTE_LPM6_LOOKUP_SCALAR;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	lpm->lookup_type = type;
 
 	return 0;
 }
@@ -32,6 +32,16 @@ struct rte_lpm6_config {
 	int flags;               /**< This field is currently unused. */
 };
 
+/** Type of bulk lookup function implementation */
+enum rte_lpm6_lookup_type {
+	RTE_LPM6_LOOKUP_DEFAULT,
+	/**< Selects the best implementation based on the max simd bitwidth */
+	RTE_LPM6_LOOKUP_SCALAR, /**< One address at a time */
+	RTE_LPM6_LOOKUP_SCALAR_X4, /**< 4 interleaved addresses with prefetch */
+	RTE_LPM6_LOOKUP_SCALAR_X8, /**< 8 interleaved addresses with prefetch */
+	RTE_LPM6_LOOKUP_VECTOR_AVX512 /**< Vector implementation using AVX512 */
+};
+
 /**
  * Create an LPM object.
  *
@@ -194,6 +204,26 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
 		int32_t *next_hops, unsigned int n);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the implementation used by rte_lpm6_lookup_bulk_func().
+ * Must not be called while lookups are in progress on the LPM object.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param type
+ *   type of lookup function
+ *
+ * @return
+ *   0 on success
+ *   -EINVAL on failure, or if the type is not supported on this machine
+ */
+__rte_experimental
+int
+rte_lpm6_select_lookup(struct rte_lpm6 *lpm, enum rte_lpm6_lookup_type type);
+
 #ifdef __cplusplus
 }
 #endif
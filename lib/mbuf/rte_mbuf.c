@@ -452,51 +452,98 @@ int rte_mbuf_check(const struct rte_mbuf *m, int is_header,
 	return 0;
 }
 
+/**
+ * Size of the array holding mbufs from the same mempool pending to be freed
+ * in bulk.
+ */
+#define RTE_PKTMBUF_FREE_PENDING_SZ 64
+
+/**
+ * @internal packet mbuf segments from the same mempool pending to be freed.
+ * They are stored straight into room reserved in the cache of the mempool,
+ * or in an array when the mempool has no cache.
+ */
+struct rte_pktmbuf_free_pending {
+	struct rte_mempool *mp;          /**< Mempool of the segments. */
+	struct rte_mempool_cache *cache; /**< Cache reserved in, or NULL. */
+	void **objs;                     /**< Pending segments. */
+	unsigned int nb;                 /**< Number of pending segments. */
+	void *array[RTE_PKTMBUF_FREE_PENDING_SZ]; /**< Used without cache. */
+};
+
+/**
+ * @internal helper function putting the pending packet mbuf segments back
+ * into their mempool.
+ *
+ * @param p
+ *  Pointer to the pending packet mbuf segments.
+ */
+static void
+__rte_pktmbuf_free_pending_flush(struct rte_pktmbuf_free_pending *p)
+{
+	if (p->cache != NULL)
+		rte_mempool_cache_zc_put_commit(p->cache, p->mp, p->nb);
+	else if (p->nb > 0)
+		rte_mempool_put_bulk(p->mp, p->objs, p->nb);
+
+	p->mp = NULL;
+	p->cache = NULL;
+	p->nb = 0;
+}
+
 /**
  * @internal helper function for freeing a bulk of packet mbuf segments
- * via an array holding the packet mbuf segments from the same mempool
- * pending to be freed.
+ * via the segments from the same mempool pending to be freed.
  *
  * @param m
  *  The packet mbuf segment to be freed.
- * @param pending
- *  Pointer to the array of packet mbuf segments pending to be freed.
- * @param nb_pending
- *  Pointer to the number of elements held in the array.
- * @param pending_sz
- *  Number of elements the array can hold.
- *  Note: The compiler should optimize this parameter away when using a
- *  constant value, such as RTE_PKTMBUF_FREE_PENDING_SZ.
+ * @param p
+ *  Pointer to the pending packet mbuf segments.
  */
 static void
-__rte_pktmbuf_free_seg_via_array(struct rte_mbuf *m,
-	struct rte_mbuf ** const pending, unsigned int * const nb_pending,
-	const unsigned int pending_sz)
+__rte_pktmbuf_free_seg_via_pending(struct rte_mbuf *m,
+	struct rte_pktmbuf_free_pending *p)
 {
+	/*
+	 * Detaching an indirect or external buffer segment may put an mbuf
+	 * in the cache holding the reservation, put the pending ones first.
+	 */
+	if (!RTE_MBUF_DIRECT(m))
+		__rte_pktmbuf_free_pending_flush(p);
+
 	m = rte_pktmbuf_prefree_seg(m);
 	if (likely(m != NULL)) {
-		if (*nb_pending == pending_sz ||
-		    (*nb_pending > 0 && m->pool != pending[0]->pool)) {
-			rte_mempool_put_bulk(pending[0]->pool,
-					(void **)pending, *nb_pending);
-			*nb_pending = 0;
+		if (p->nb == RTE_PKTMBUF_FREE_PENDING_SZ || m->pool != p->mp) {
+			__rte_pktmbuf_free_pending_flush(p);
+
+			p->mp = m->pool;
+			p->cache = rte_mempool_default_cache(p->mp,
+					rte_lcore_id());
+			p->objs = NULL;
+			if (p->cache != NULL)
+				p->objs = rte_mempool_cache_zc_put_reserve(
+						p->cache, p->mp,
+						RTE_PKTMBUF_FREE_PENDING_SZ);
+			if (p->objs == NULL) {
+				p->cache = NULL;
+				p->objs = p->array;
+			}
 		}
 
-		pending[(*nb_pending)++] = m;
+		p->objs[p->nb++] = m;
 	}
 }
 
-/**
- * Size of the array holding mbufs from the same mempool pending to be freed
- * in bulk.
- */
-#define RTE_PKTMBUF_FREE_PENDING_SZ 64
-
 /* Free a bulk of packet mbufs back into their original mempools. */
 void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count)
 {
-	struct rte_mbuf *m, *m_next, *pending[RTE_PKTMBUF_FREE_PENDING_SZ];
-	unsigned int idx, nb_pending = 0;
+	struct rte_pktmbuf_free_pending pending;
+	struct rte_mbuf *m, *m_next;
+	unsigned int idx;
+
+	pending.mp = NULL;
+	pending.cache = NULL;
+	pending.nb = 0;
 
 	for (idx = 0; idx < count; idx++) {
 		m = mbufs[idx];
@@ -507,15 +554,12 @@ void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count)
 
 		do {
 			m_next = m->next;
-			__rte_pktmbuf_free_seg_via_array(m,
-					pending, &nb_pending,
-					RTE_PKTMBUF_FREE_PENDING_SZ);
+			__rte_pktmbuf_free_seg_via_pending(m, &pending);
 			m = m_next;
 		} while (m != NULL);
 	}
 
-	if (nb_pending > 0)
-		rte_mempool_put_bulk(pending[0]->pool, (void **)pending, nb_pending);
+	__rte_pktmbuf_free_pending_flush(&pending);
 }
 
 /* Creates a shallow copy of mbuf */
@@ -46,6 +46,13 @@ EAL_REGISTER_TAILQ(rte_mempool_tailq)
 #define CALC_CACHE_FLUSHTHRESH(c)	\
 	((typeof(c))((c) * CACHE_FLUSHTHRESH_MULTIPLIER))
 
+/* Number of refills and flushes an adaptive cache is resized after. */
+#define CACHE_ADAPT_WINDOW 32
+/* Refills to flushes ratio (or the reverse) making a cache grow (shrink). */
+#define CACHE_ADAPT_RATIO 4
+/* Size of the ring handing objects over to a paired cache. */
+#define CACHE_XFER_RING_SIZE (RTE_MEMPOOL_CACHE_MAX_SIZE * 2)
+
 #if defined(RTE_ARCH_X86)
 /*
  * return the greatest common divisor between a and b (fast algorithm)
@@ -288,6 +295,293 @@ rte_mempool_free_memchunks(struct rte_mempool *mp)
 	}
 }
 
+/*
+ * Adaptive state of the default cache of an lcore, kept out of
+ * struct rte_mempool_cache whose size is part of the ABI.
+ */
+struct mempool_cache_adaptive {
+	uint32_t base_size;   /* Size the cache was created with */
+	uint16_t win_refills; /* Refills in the current adaptation window */
+	uint16_t win_flushes; /* Flushes in the current adaptation window */
+	struct rte_ring *xfer; /* Objects handed over by paired caches */
+	struct rte_ring *peer; /* Handover ring of the paired consumer */
+	uint64_t refills;     /* Refills from the common pool or peers */
+	uint64_t flushes;     /* Flushes to the common pool or peer */
+	uint64_t grows;       /* Times the cache size was increased */
+	uint64_t shrinks;     /* Times the cache size was decreased */
+	uint64_t xfer_in;     /* Objects received from paired caches */
+	uint64_t xfer_out;    /* Objects handed over to the peer cache */
+} __rte_cache_aligned;
+
+/*
+ * Adaptive state of a mempool, stored in its memzone after the private
+ * data. Once the common pool is allocated, the mempool uses the adaptive
+ * ops, which resize the default caches while they are flushed and refilled
+ * by the inline put and get functions, and forward to the ops of the
+ * common pool.
+ */
+struct mempool_adaptive {
+	int32_t ops_index; /* Ops of the common pool */
+	struct mempool_cache_adaptive caches[RTE_MAX_LCORE];
+} __rte_cache_aligned;
+
+/* Index of the adaptive ops, -1 if they could not be registered. */
+static int mempool_adaptive_ops_index = -1;
+
+static inline bool
+mempool_is_adaptive(const struct rte_mempool *mp)
+{
+	return (mp->flags & MEMPOOL_F_CACHE_ADAPTIVE) && mp->cache_size != 0;
+}
+
+static inline struct mempool_adaptive *
+mempool_adaptive_get(const struct rte_mempool *mp)
+{
+	return RTE_PTR_ADD(mp, MEMPOOL_HEADER_SIZE(mp, mp->cache_size) +
+		mp->private_data_size);
+}
+
+static inline const struct rte_mempool_ops *
+mempool_adaptive_ops(const struct rte_mempool *mp)
+{
+	return rte_mempool_get_ops(mempool_adaptive_get(mp)->ops_index);
+}
+
+/*
+ * Resize an adaptive cache once per window of refills and flushes, up to
+ * max_size. A cache mostly refilled (consumer) grows to take bigger
+ * batches from the common pool, a cache mostly flushed (producer) keeps
+ * fewer objects back so that it flushes bigger batches, and a balanced
+ * cache returns to its base size.
+ */
+static void
+mempool_cache_adapt(struct rte_mempool_cache *cache,
+	struct mempool_cache_adaptive *ca, uint32_t max_size)
+{
+	uint32_t refills = ca->win_refills;
+	uint32_t flushes = ca->win_flushes;
+	uint32_t base = ca->base_size;
+	uint32_t size = cache->size;
+
+	if (refills + flushes < CACHE_ADAPT_WINDOW)
+		return;
+	ca->win_refills = 0;
+	ca->win_flushes = 0;
+
+	if (refills > flushes * CACHE_ADAPT_RATIO)
+		size = RTE_MIN(size * 2, (uint32_t)RTE_MEMPOOL_CACHE_MAX_SIZE);
+	else if (flushes > refills * CACHE_ADAPT_RATIO)
+		size = RTE_MAX(size / 2, RTE_MAX(base / 2, 1U));
+	else if (size < base)
+		size = RTE_MIN(size * 2, base);
+	else if (size > base)
+		size = RTE_MAX(size / 2, base);
+	size = RTE_MIN(size, max_size);
+
+	if (size == cache->size)
+		return;
+	if (size > cache->size)
+		ca->grows++;
+	else
+		ca->shrinks++;
+
+	/*
+	 * The threshold never goes below the base one, so that a shrunk
+	 * cache flushes more objects at once.
+	 */
+	cache->size = size;
+	cache->flushthresh = RTE_MAX(CALC_CACHE_FLUSHTHRESH(size),
+		CALC_CACHE_FLUSHTHRESH(base));
+}
+
+/*
+ * Flush the objects above the size of a default cache, to the peer cache if
+ * paired or to the common pool. The caller sets the cache length to the
+ * cache size after the enqueue, so the new size is applied here.
+ */
+static int
+mempool_adaptive_enqueue(struct rte_mempool *mp, void * const *obj_table,
+	unsigned int n)
+{
+	const struct rte_mempool_ops *ops = mempool_adaptive_ops(mp);
+	unsigned int lcore_id = rte_lcore_id();
+	struct mempool_cache_adaptive *ca;
+	struct rte_mempool_cache *cache;
+	unsigned int done = 0;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return ops->enqueue(mp, obj_table, n);
+	cache = &mp->local_cache[lcore_id];
+	if (obj_table != &cache->objs[cache->size] ||
+			n != cache->len - cache->size)
+		return ops->enqueue(mp, obj_table, n);
+
+	ca = &mempool_adaptive_get(mp)->caches[lcore_id];
+	ca->flushes++;
+	ca->win_flushes++;
+	mempool_cache_adapt(cache, ca, cache->len);
+
+	obj_table = &cache->objs[cache->size];
+	n = cache->len - cache->size;
+	if (ca->peer != NULL) {
+		done = rte_ring_mp_enqueue_burst(ca->peer, obj_table, n, NULL);
+		ca->xfer_out += done;
+	}
+	if (done < n)
+		return ops->enqueue(mp, obj_table + done, n - done);
+	return 0;
+}
+
+/*
+ * Refill a default cache from the paired caches first and then from the
+ * common pool. The size read by the caller to compute the refill is not
+ * used afterwards, so the new size is applied here.
+ */
+static int
+mempool_adaptive_dequeue(struct rte_mempool *mp, void **obj_table,
+	unsigned int n)
+{
+	const struct rte_mempool_ops *ops = mempool_adaptive_ops(mp);
+	unsigned int lcore_id = rte_lcore_id();
+	struct mempool_cache_adaptive *ca;
+	struct rte_mempool_cache *cache;
+	unsigned int done = 0;
+	int ret;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return ops->dequeue(mp, obj_table, n);
+	cache = &mp->local_cache[lcore_id];
+	if (obj_table != &cache->objs[cache->len])
+		return ops->dequeue(mp, obj_table, n);
+
+	ca = &mempool_adaptive_get(mp)->caches[lcore_id];
+	if (ca->xfer != NULL)
+		done = rte_ring_sc_dequeue_burst(ca->xfer, obj_table, n, NULL);
+	if (done < n) {
+		ret = ops->dequeue(mp, obj_table + done, n - done);
+		if (ret < 0) {
+			/* all or nothing, like the common pool */
+			if (done != 0)
+				ops->enqueue(mp, obj_table, done);
+			return ret;
+		}
+	}
+	ca->xfer_in += done;
+
+	ca->refills++;
+	ca->win_refills++;
+	mempool_cache_adapt(cache, ca, RTE_MEMPOOL_CACHE_MAX_SIZE);
+	return 0;
+}
+
+static int
+mempool_adaptive_alloc(struct rte_mempool *mp)
+{
+	return mempool_adaptive_ops(mp)->alloc(mp);
+}
+
+static void
+mempool_adaptive_free(struct rte_mempool *mp)
+{
+	const struct rte_mempool_ops *ops = mempool_adaptive_ops(mp);
+
+	if (ops->free != NULL)
+		ops->free(mp);
+}
+
+static unsigned int
+mempool_adaptive_get_count(const struct rte_mempool *mp)
+{
+	return mempool_adaptive_ops(mp)->get_count(mp);
+}
+
+static ssize_t
+mempool_adaptive_calc_mem_size(const struct rte_mempool *mp,
+	uint32_t obj_num, uint32_t pg_shift, size_t *min_chunk_size,
+	size_t *align)
+{
+	const struct rte_mempool_ops *ops = mempool_adaptive_ops(mp);
+
+	if (ops->calc_mem_size == NULL)
+		return rte_mempool_op_calc_mem_size_default(mp, obj_num,
+				pg_shift, min_chunk_size, align);
+	return ops->calc_mem_size(mp, obj_num, pg_shift, min_chunk_size,
+			align);
+}
+
+static int
+mempool_adaptive_populate(struct rte_mempool *mp, unsigned int max_objs,
+	void *vaddr, rte_iova_t iova, size_t len,
+	rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	const struct rte_mempool_ops *ops = mempool_adaptive_ops(mp);
+
+	if (ops->populate == NULL)
+		return rte_mempool_op_populate_default(mp, max_objs, vaddr,
+				iova, len, obj_cb, obj_cb_arg);
+	return ops->populate(mp, max_objs, vaddr, iova, len, obj_cb,
+			obj_cb_arg);
+}
+
+static int
+mempool_adaptive_get_info(const struct rte_mempool *mp,
+	struct rte_mempool_info *info)
+{
+	const struct rte_mempool_ops *ops = mempool_adaptive_ops(mp);
+
+	if (ops->get_info == NULL)
+		return -ENOTSUP;
+	return ops->get_info(mp, info);
+}
+
+static int
+mempool_adaptive_dequeue_contig_blocks(struct rte_mempool *mp,
+	void **first_obj_table, unsigned int n)
+{
+	const struct rte_mempool_ops *ops = mempool_adaptive_ops(mp);
+
+	if (ops->dequeue_contig_blocks == NULL)
+		return -ENOTSUP;
+	return ops->dequeue_contig_blocks(mp, first_obj_table, n);
+}
+
+static const struct rte_mempool_ops mempool_adaptive_ops_def = {
+	.name = "cache_adaptive",
+	.alloc = mempool_adaptive_alloc,
+	.free = mempool_adaptive_free,
+	.enqueue = mempool_adaptive_enqueue,
+	.dequeue = mempool_adaptive_dequeue,
+	.get_count = mempool_adaptive_get_count,
+	.calc_mem_size = mempool_adaptive_calc_mem_size,
+	.populate = mempool_adaptive_populate,
+	.get_info = mempool_adaptive_get_info,
+	.dequeue_contig_blocks = mempool_adaptive_dequeue_contig_blocks,
+};
+
+RTE_INIT(mempool_adaptive_ops_register)
+{
+	mempool_adaptive_ops_index =
+		rte_mempool_register_ops(&mempool_adaptive_ops_def);
+}
+
+/* put the adaptive ops in front of the ones of the common pool */
+static void
+mempool_adaptive_attach(struct rte_mempool *mp)
+{
+	if (!mempool_is_adaptive(mp))
+		return;
+
+	if (mempool_adaptive_ops_index < 0) {
+		RTE_LOG(WARNING, MEMPOOL,
+			"Adaptive ops not registered, caches of %s not resized\n",
+			mp->name);
+		return;
+	}
+
+	mempool_adaptive_get(mp)->ops_index = mp->ops_index;
+	mp->ops_index = mempool_adaptive_ops_index;
+}
+
 static int
 mempool_ops_alloc_once(struct rte_mempool *mp)
 {
@@ -298,6 +592,7 @@ mempool_ops_alloc_once(struct rte_mempool *mp)
 		ret = rte_mempool_ops_alloc(mp);
 		if (ret != 0)
 			return ret;
+		mempool_adaptive_attach(mp);
 		mp->flags |= MEMPOOL_F_POOL_CREATED;
 	}
 	return 0;
@@ -722,6 +1017,15 @@ rte_mempool_free(struct rte_mempool *mp)
 	}
 	rte_mcfg_tailq_write_unlock();
 
+	/* free the handover rings of the paired caches */
+	if (mempool_is_adaptive(mp)) {
+		struct mempool_adaptive *ma = mempool_adaptive_get(mp);
+		unsigned int lcore_id;
+
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			rte_free(ma->caches[lcore_id].xfer);
+	}
+
 	rte_mempool_trace_free(mp);
 	rte_mempool_free_memchunks(mp);
 	rte_mempool_ops_free(mp);
@@ -736,6 +1040,72 @@ mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
 	cache->len = 0;
 }
 
+/* pair the caches of a producer and a consumer lcore */
+int
+rte_mempool_cache_pair(struct rte_mempool *mp, unsigned int producer_lcore,
+	unsigned int consumer_lcore)
+{
+	struct mempool_cache_adaptive *consumer;
+	char name[RTE_RING_NAMESIZE];
+	struct rte_ring *r;
+	ssize_t ring_size;
+
+	if (mp == NULL || !mempool_is_adaptive(mp) ||
+			producer_lcore >= RTE_MAX_LCORE ||
+			consumer_lcore >= RTE_MAX_LCORE ||
+			producer_lcore == consumer_lcore)
+		return -EINVAL;
+
+	consumer = &mempool_adaptive_get(mp)->caches[consumer_lcore];
+	if (consumer->xfer == NULL) {
+		ring_size = rte_ring_get_memsize(CACHE_XFER_RING_SIZE);
+		if (ring_size < 0)
+			return -EINVAL;
+		r = rte_zmalloc_socket("MEMPOOL_CACHE_XFER", ring_size,
+			RTE_CACHE_LINE_SIZE, mp->socket_id);
+		if (r == NULL)
+			return -ENOMEM;
+		snprintf(name, sizeof(name), "MPX_%u_%p", consumer_lcore,
+			(void *)mp);
+		if (rte_ring_init(r, name, CACHE_XFER_RING_SIZE,
+				RING_F_SC_DEQ) != 0) {
+			rte_free(r);
+			return -EINVAL;
+		}
+		consumer->xfer = r;
+	}
+	mempool_adaptive_get(mp)->caches[producer_lcore].peer = consumer->xfer;
+
+	return 0;
+}
+
+int
+rte_mempool_cache_stats_get(const struct rte_mempool *mp,
+	unsigned int lcore_id, struct rte_mempool_cache_stats *stats)
+{
+	const struct mempool_cache_adaptive *ca;
+	const struct rte_mempool_cache *cache;
+
+	if (mp == NULL || !mempool_is_adaptive(mp) ||
+			lcore_id >= RTE_MAX_LCORE || stats == NULL)
+		return -EINVAL;
+
+	cache = &mp->local_cache[lcore_id];
+	ca = &mempool_adaptive_get(mp)->caches[lcore_id];
+	stats->size = cache->size;
+	stats->flushthresh = cache->flushthresh;
+	stats->len = cache->len;
+	stats->xfer_len = ca->xfer != NULL ? rte_ring_count(ca->xfer) : 0;
+	stats->refills = ca->refills;
+	stats->flushes = ca->flushes;
+	stats->grows = ca->grows;
+	stats->shrinks = ca->shrinks;
+	stats->xfer_in = ca->xfer_in;
+	stats->xfer_out = ca->xfer_out;
+
+	return 0;
+}
+
 /*
  * Create and initialize a cache for objects that are retrieved from and
  * returned to an underlying mempool. This structure is identical to the
@@ -850,6 +1220,8 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	mempool_size = MEMPOOL_HEADER_SIZE(mp, cache_size);
 	mempool_size += private_data_size;
+	if ((flags & MEMPOOL_F_CACHE_ADAPTIVE) && cache_size != 0)
+		mempool_size += sizeof(struct mempool_adaptive);
 	mempool_size = RTE_ALIGN_CEIL(mempool_size, RTE_MEMPOOL_ALIGN);
 
 	ret = snprintf(mz_name, sizeof(mz_name), RTE_MEMPOOL_MZ_FORMAT, name);
@@ -897,6 +1269,14 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 					   cache_size);
 	}
 
+	if (mempool_is_adaptive(mp)) {
+		struct mempool_adaptive *ma = mempool_adaptive_get(mp);
+
+		memset(ma, 0, sizeof(*ma));
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			ma->caches[lcore_id].base_size = cache_size;
+	}
+
 	te->data = mp;
 
 	rte_mcfg_tailq_write_lock();
@@ -983,6 +1363,16 @@ rte_mempool_avail_count(const struct rte_mempool *mp)
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 		count += mp->local_cache[lcore_id].len;
 
+	/* objects handed over to paired caches */
+	if (mempool_is_adaptive(mp)) {
+		const struct mempool_adaptive *ma = mempool_adaptive_get(mp);
+
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+			if (ma->caches[lcore_id].xfer != NULL)
+				count += rte_ring_count(
+					ma->caches[lcore_id].xfer);
+	}
+
 	/*
 	 * due to race condition (access to len is not locked), the
 	 * total can be greater than size... so fix the result
@@ -1003,6 +1393,7 @@ rte_mempool_in_use_count(const struct rte_mempool *mp)
 static unsigned
 rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 {
+	const struct mempool_adaptive *ma = NULL;
 	unsigned lcore_id;
 	unsigned count = 0;
 	unsigned cache_count;
@@ -1013,11 +1404,30 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 	if (mp->cache_size == 0)
 		return count;
 
+	if (mempool_is_adaptive(mp))
+		ma = mempool_adaptive_get(mp);
+
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
-		cache_count = mp->local_cache[lcore_id].len;
+		const struct mempool_cache_adaptive *ca;
+		const struct rte_mempool_cache *cache;
+
+		cache = &mp->local_cache[lcore_id];
+		cache_count = cache->len;
+		ca = ma != NULL ? &ma->caches[lcore_id] : NULL;
+		if (ca != NULL && ca->xfer != NULL)
+			cache_count += rte_ring_count(ca->xfer);
 		fprintf(f, "    cache_count[%u]=%"PRIu32"\n",
 			lcore_id, cache_count);
 		count += cache_count;
+		if (ca != NULL && ca->refills + ca->flushes != 0)
+			fprintf(f, "    cache_adaptive[%u]: size=%"PRIu32
+				" flushthresh=%"PRIu32" refills=%"PRIu64
+				" flushes=%"PRIu64" grows=%"PRIu64
+				" shrinks=%"PRIu64" xfer_in=%"PRIu64
+				" xfer_out=%"PRIu64"\n",
+				lcore_id, cache->size, cache->flushthresh,
+				ca->refills, ca->flushes, ca->grows,
+				ca->shrinks, ca->xfer_in, ca->xfer_out);
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
 	return count;
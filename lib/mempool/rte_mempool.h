@@ -98,6 +98,24 @@ struct rte_mempool_cache {
 	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE * 3]; /**< Cache objects */
 } __rte_cache_aligned;
 
+/**
+ * Statistics of the default cache of an lcore in an adaptive mempool.
+ *
+ * @see rte_mempool_cache_stats_get()
+ */
+struct rte_mempool_cache_stats {
+	uint32_t size;        /**< Current size of the cache. */
+	uint32_t flushthresh; /**< Current flush threshold of the cache. */
+	uint32_t len;         /**< Current number of objects in the cache. */
+	uint32_t xfer_len;    /**< Objects waiting in the handover ring. */
+	uint64_t refills;     /**< Refills from the common pool or peers. */
+	uint64_t flushes;     /**< Flushes to the common pool or the peer. */
+	uint64_t grows;       /**< Times the cache size was increased. */
+	uint64_t shrinks;     /**< Times the cache size was decreased. */
+	uint64_t xfer_in;     /**< Objects received from paired caches. */
+	uint64_t xfer_out;    /**< Objects handed over to the peer cache. */
+};
+
 /**
  * A structure that stores the size of mempool elements.
  */
@@ -263,6 +281,7 @@ struct rte_mempool {
 #define MEMPOOL_F_SC_GET         0x0008 /**< Default get is "single-consumer".*/
 #define MEMPOOL_F_POOL_CREATED   0x0010 /**< Internal: pool is created. */
 #define MEMPOOL_F_NO_IOVA_CONTIG 0x0020 /**< Don't need IOVA contiguous objs. */
+#define MEMPOOL_F_CACHE_ADAPTIVE 0x0040 /**< Resize caches at runtime. */
 
 /**
  * @internal When debug is enabled, store some statistics.
@@ -992,6 +1011,12 @@ typedef void (rte_mempool_ctor_t)(struct rte_mempool *, void *);
  *     "single-consumer". Otherwise, it is "multi-consumers".
  *   - MEMPOOL_F_NO_IOVA_CONTIG: If set, allocated objects won't
  *     necessarily be contiguous in IO memory.
+ *   - MEMPOOL_F_CACHE_ADAPTIVE: If set, the size and flush threshold of
+ *     the default caches are adjusted at runtime: caches mostly refilled
+ *     from the common pool grow, caches mostly flushed to it shrink. Caches
+ *     can also be paired with rte_mempool_cache_pair(). This is done by
+ *     mempool ops wrapping the ones of the common pool when it is populated,
+ *     the user-owned caches are not resized.
  * @return
  *   The pointer to the new allocated mempool, on success. NULL on error
  *   with rte_errno set appropriately. Possible rte_errno values include:
@@ -1252,6 +1277,62 @@ rte_mempool_default_cache(struct rte_mempool *mp, unsigned lcore_id)
 	return &mp->local_cache[lcore_id];
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Pair the default caches of two lcores for a mempool created with the
+ * MEMPOOL_F_CACHE_ADAPTIVE flag.
+ *
+ * The objects flushed from the cache of the producer lcore are handed over
+ * to the cache of the consumer lcore through a ring, instead of going back
+ * to the common pool, and the consumer refills its cache from this ring
+ * first. This suits pipelines where objects are allocated on one lcore and
+ * freed on another one. Several producers can be paired with the same
+ * consumer, a producer hands over to a single consumer.
+ *
+ * This function must not be called while the two lcores use the mempool.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param producer_lcore
+ *   The lcore mostly putting objects in the mempool.
+ * @param consumer_lcore
+ *   The lcore mostly getting objects from the mempool.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: The mempool is not adaptive or has no cache, or the lcores
+ *     are invalid.
+ *   - -ENOMEM: The handover ring could not be allocated.
+ */
+__rte_experimental
+int
+rte_mempool_cache_pair(struct rte_mempool *mp, unsigned int producer_lcore,
+	unsigned int consumer_lcore);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the statistics of the default cache of an lcore, for a mempool
+ * created with the MEMPOOL_F_CACHE_ADAPTIVE flag.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param lcore_id
+ *   The lcore owning the default cache.
+ * @param stats
+ *   A pointer to the structure filled with the statistics.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: The mempool is not adaptive or has no cache, the lcore is
+ *     invalid or a parameter is NULL.
+ */
+__rte_experimental
+int
+rte_mempool_cache_stats_get(const struct rte_mempool *mp,
+	unsigned int lcore_id, struct rte_mempool_cache_stats *stats);
+
 /**
  * Flush a user-owned mempool cache to the specified mempool.
  *
@@ -1273,6 +1354,57 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/**
+ * @internal Flush the objects above the size of a cache which reached its
+ * flush threshold to the common pool.
+ *
+ * The size of the default caches of an adaptive mempool is adjusted while
+ * they are flushed, it has to be read again after the enqueue.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache.
+ */
+static __rte_always_inline void
+__mempool_cache_flush_excess(struct rte_mempool *mp,
+			     struct rte_mempool_cache *cache)
+{
+	rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
+			cache->len - cache->size);
+	cache->len = cache->size;
+}
+
+/**
+ * @internal Backfill a cache holding fewer than n objects from the common
+ * pool, so that it holds its size plus n objects.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache.
+ * @param n
+ *   The number of objects about to be taken from the cache.
+ * @return
+ *   - 0: Success; the cache holds at least n objects.
+ *   - <0: Error; code of ring dequeue function.
+ */
+static __rte_always_inline int
+__mempool_cache_refill(struct rte_mempool *mp,
+		       struct rte_mempool_cache *cache, unsigned int n)
+{
+	/* How many do we require i.e. number to fill the cache + the request */
+	uint32_t req = n + (cache->size - cache->len);
+	int ret;
+
+	ret = rte_mempool_ops_dequeue_bulk(mp, &cache->objs[cache->len], req);
+	if (unlikely(ret < 0))
+		return ret;
+
+	cache->len += req;
+	return 0;
+}
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1313,11 +1445,8 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 
 	cache->len += n;
 
-	if (cache->len >= cache->flushthresh) {
-		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
-				cache->len - cache->size);
-		cache->len = cache->size;
-	}
+	if (cache->len >= cache->flushthresh)
+		__mempool_cache_flush_excess(mp, cache);
 
 	return;
 
@@ -1427,12 +1556,7 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 	/* Can this be satisfied from the cache? */
 	if (cache->len < n) {
 		/* No. Backfill the cache first, and then fill from it */
-		uint32_t req = n + (cache->size - cache->len);
-
-		/* How many do we require i.e. number to fill the cache + the request */
-		ret = rte_mempool_ops_dequeue_bulk(mp,
-			&cache->objs[cache->len], req);
-		if (unlikely(ret < 0)) {
+		if (unlikely(__mempool_cache_refill(mp, cache, n) < 0)) {
 			/*
 			 * In the off chance that we are buffer constrained,
 			 * where we are not able to allocate cache + n, go to
@@ -1441,8 +1565,6 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 			 */
 			goto ring_dequeue;
 		}
-
-		cache->len += req;
 	}
 
 	/* Now fill in the response ... */
@@ -1561,6 +1683,151 @@ rte_mempool_get(struct rte_mempool *mp, void **obj_p)
 	return rte_mempool_get_bulk(mp, obj_p, 1);
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Reserve room for objects in a mempool cache, to put them back in the
+ * mempool without copying them through an intermediate table.
+ *
+ * The caller stores up to *n* objects at the returned address, then calls
+ * rte_mempool_cache_zc_put_commit() with the number of objects stored.
+ * Nothing else may put objects in or get objects from the cache in between,
+ * including an mbuf free that could put an attached mbuf back in the same
+ * mempool. For example:
+ *
+ * @code
+ * objs = rte_mempool_cache_zc_put_reserve(cache, mp, n);
+ * if (objs != NULL) {
+ *	for (i = 0; i < n; i++)
+ *		objs[i] = txep[i].mbuf;
+ *	rte_mempool_cache_zc_put_commit(cache, mp, n);
+ * }
+ * @endcode
+ *
+ * @param cache
+ *   A pointer to the mempool cache.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param n
+ *   The number of objects to reserve room for.
+ * @return
+ *   A pointer to the room for *n* objects in the cache, or NULL if *n* is
+ *   greater than RTE_MEMPOOL_CACHE_MAX_SIZE.
+ */
+__rte_experimental
+static __rte_always_inline void **
+rte_mempool_cache_zc_put_reserve(struct rte_mempool_cache *cache,
+				 struct rte_mempool *mp, unsigned int n)
+{
+	RTE_SET_USED(mp);
+
+	/*
+	 * Out of a put, the cache holds at most twice the max size, see
+	 * __mempool_generic_get(), so the objects always fit.
+	 */
+	if (unlikely(n > RTE_MEMPOOL_CACHE_MAX_SIZE))
+		return NULL;
+
+	return &cache->objs[cache->len];
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Put the objects stored in the room reserved with
+ * rte_mempool_cache_zc_put_reserve() in the mempool cache, flushing the
+ * cache to the common pool if it reached its flush threshold.
+ *
+ * @param cache
+ *   A pointer to the mempool cache.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param n
+ *   The number of objects stored, at most the number reserved.
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_mempool_cache_zc_put_commit(struct rte_mempool_cache *cache,
+				struct rte_mempool *mp, unsigned int n)
+{
+	if (unlikely(n == 0))
+		return;
+
+	__mempool_check_cookies(mp, &cache->objs[cache->len], n, 0);
+	__MEMPOOL_STAT_ADD(mp, put_bulk, 1);
+	__MEMPOOL_STAT_ADD(mp, put_objs, n);
+
+	cache->len += n;
+	if (cache->len >= cache->flushthresh)
+		__mempool_cache_flush_excess(mp, cache);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Peek at objects in a mempool cache, backfilling it from the common pool
+ * if needed, to get them from the mempool without copying them through an
+ * intermediate table.
+ *
+ * The caller reads the *n* objects at the returned address, then calls
+ * rte_mempool_cache_zc_get_consume() to take them out of the cache.
+ * Nothing else may put objects in or get objects from the cache in between.
+ *
+ * @param cache
+ *   A pointer to the mempool cache.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param n
+ *   The number of objects to peek at.
+ * @return
+ *   A pointer to *n* objects in the cache, or NULL if *n* is greater than
+ *   RTE_MEMPOOL_CACHE_MAX_SIZE or the mempool is short of objects.
+ */
+__rte_experimental
+static __rte_always_inline void **
+rte_mempool_cache_zc_get_peek(struct rte_mempool_cache *cache,
+			      struct rte_mempool *mp, unsigned int n)
+{
+	if (unlikely(n > RTE_MEMPOOL_CACHE_MAX_SIZE))
+		return NULL;
+
+	if (cache->len < n && unlikely(__mempool_cache_refill(mp, cache, n) < 0))
+		return NULL;
+
+	return &cache->objs[cache->len - n];
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Take the objects returned by rte_mempool_cache_zc_get_peek() out of the
+ * mempool cache.
+ *
+ * @param cache
+ *   A pointer to the mempool cache.
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param n
+ *   The number of objects passed to rte_mempool_cache_zc_get_peek().
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_mempool_cache_zc_get_consume(struct rte_mempool_cache *cache,
+				 struct rte_mempool *mp, unsigned int n)
+{
+	RTE_SET_USED(mp);
+
+	cache->len -= n;
+
+	__mempool_check_cookies(mp, &cache->objs[cache->len], n, 1);
+	__MEMPOOL_STAT_ADD(mp, get_success_bulk, 1);
+	__MEMPOOL_STAT_ADD(mp, get_success_objs, n);
+}
+
 /**
  * Get a contiguous blocks of objects from the mempool.
  *
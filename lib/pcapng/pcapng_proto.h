@@ -0,0 +1,88 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _PCAPNG_PROTO_H_
+#define _PCAPNG_PROTO_H_
+
+/*
+ * Blocks and options of the pcapng file format, as described in
+ * https://datatracker.ietf.org/doc/draft-tuexen-opsawg-pcapng/
+ * The blocks are written in host byte order, readers detect it with
+ * the byte order magic of the section header.
+ */
+
+#include <stdint.h>
+
+#define PCAPNG_SHB_TYPE	0x0A0D0D0A /* section header block */
+#define PCAPNG_IDB_TYPE	0x00000001 /* interface description block */
+#define PCAPNG_EPB_TYPE	0x00000006 /* enhanced packet block */
+
+#define PCAPNG_BYTE_ORDER_MAGIC	0x1A2B3C4D
+#define PCAPNG_MAJOR_VERSION	1
+#define PCAPNG_MINOR_VERSION	0
+
+#define PCAPNG_LINKTYPE_ETHERNET 1
+
+enum pcapng_option_code {
+	PCAPNG_OPT_END = 0,
+	PCAPNG_OPT_COMMENT = 1,
+
+	/* section header block options */
+	PCAPNG_SHB_HARDWARE = 2,
+	PCAPNG_SHB_OS = 3,
+	PCAPNG_SHB_USERAPPL = 4,
+
+	/* interface description block options */
+	PCAPNG_IFB_NAME = 2,
+	PCAPNG_IFB_TSRESOL = 9,
+
+	/* enhanced packet block options */
+	PCAPNG_EPB_FLAGS = 2,
+	PCAPNG_EPB_HASH = 3,
+	PCAPNG_EPB_QUEUE = 6,
+};
+
+/* epb_flags direction bits */
+#define PCAPNG_EPB_FLAG_INBOUND		0x1
+#define PCAPNG_EPB_FLAG_OUTBOUND	0x2
+
+/* epb_hash algorithms */
+#define PCAPNG_HASH_TOEPLITZ		5
+
+struct pcapng_block_header {
+	uint32_t type;
+	uint32_t length;
+};
+
+struct pcapng_section_header {
+	struct pcapng_block_header hdr;
+	uint32_t byte_order_magic;
+	uint16_t major_version;
+	uint16_t minor_version;
+	uint64_t section_length;
+};
+
+struct pcapng_interface_block {
+	struct pcapng_block_header hdr;
+	uint16_t link_type;
+	uint16_t reserved;
+	uint32_t snap_len;
+};
+
+struct pcapng_enhance_packet_block {
+	struct pcapng_block_header hdr;
+	uint32_t interface_id;
+	uint32_t timestamp_hi;
+	uint32_t timestamp_lo;
+	uint32_t capture_length;
+	uint32_t original_length;
+};
+
+struct pcapng_option {
+	uint16_t code;
+	uint16_t length;
+	uint8_t data[];
+};
+
+#endif /* _PCAPNG_PROTO_H_ */
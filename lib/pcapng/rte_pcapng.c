@@ -0,0 +1,523 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/utsname.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_ethdev.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_reciprocal.h>
+#include <rte_string_fns.h>
+#include <rte_version.h>
+
+#include "pcapng_proto.h"
+#include "rte_pcapng.h"
+
+/* Max packets written per system call */
+#define PCAPNG_BURST 64
+/* Max iovecs per system call, below IOV_MAX */
+#define PCAPNG_IOV_MAX 512
+/* Max iovecs of a packet besides its segments: IDB, EPB header and tail */
+#define PCAPNG_PKT_IOV 3
+/* Room for the padding, the options and the trailer of an EPB */
+#define PCAPNG_EPB_TAIL_MAX 48
+/* Room for an IDB with its options */
+#define PCAPNG_IDB_MAX 128
+/* Max length of the strings of the section header */
+#define PCAPNG_STR_MAX 256
+
+/* Index of the IDB written for the packets with an invalid port */
+#define PCAPNG_PORT_UNKNOWN RTE_MAX_ETHPORTS
+
+/* Capture metadata stored in the mbufs by rte_pcapng_copy() */
+struct pcapng_mbuf_meta {
+	uint64_t tsc;
+	uint32_t orig_len;
+	uint16_t queue;
+	uint16_t direction;
+};
+
+static const struct rte_mbuf_dynfield pcapng_dynfield_desc = {
+	.name = "rte_pcapng_dynfield_meta",
+	.size = sizeof(struct pcapng_mbuf_meta),
+	.align = __alignof__(struct pcapng_mbuf_meta),
+};
+
+static const struct rte_mbuf_dynflag pcapng_dynflag_desc = {
+	.name = "rte_pcapng_dynflag_meta",
+};
+
+static int pcapng_dynfield_offset = -1;
+static uint64_t pcapng_dynflag;
+
+struct pcapng_epb_buf {
+	struct pcapng_enhance_packet_block epb;
+	uint8_t tail[PCAPNG_EPB_TAIL_MAX];
+};
+
+struct rte_pcapng {
+	int fd;
+	uint64_t tsc_base;        /* TSC when the file was opened */
+	uint64_t ns_base;         /* real time when the file was opened */
+	uint64_t tsc_hz;
+	struct rte_reciprocal_u64 tsc_hz_inv;
+	uint32_t nb_interfaces;   /* IDBs written */
+	/* IDB index + 1 of each port, 0 when it has none yet */
+	uint32_t port_index[RTE_MAX_ETHPORTS + 1];
+
+	/* blocks and iovecs of the burst being written */
+	struct pcapng_epb_buf epb[PCAPNG_BURST];
+	uint32_t idb[PCAPNG_BURST][PCAPNG_IDB_MAX / sizeof(uint32_t)];
+	uint32_t idb_port[PCAPNG_BURST];  /* port of each IDB of the burst */
+	struct iovec iov[PCAPNG_IOV_MAX];
+};
+
+/*
+ * Register the mbuf field and flag of the capture metadata, the values are
+ * the same in all the processes.
+ */
+static int
+pcapng_dyn_register(void)
+{
+	int offset, bit;
+
+	if (likely(__atomic_load_n(&pcapng_dynfield_offset,
+				   __ATOMIC_ACQUIRE) >= 0))
+		return 0;
+
+	offset = rte_mbuf_dynfield_register(&pcapng_dynfield_desc);
+	if (offset < 0)
+		return -1;
+
+	bit = rte_mbuf_dynflag_register(&pcapng_dynflag_desc);
+	if (bit < 0)
+		return -1;
+
+	pcapng_dynflag = RTE_BIT64(bit);
+	__atomic_store_n(&pcapng_dynfield_offset, offset, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/*
+ * Add an option at p, which does not have to be aligned, and return the
+ * end of the option, padded to 32 bits.
+ */
+static uint8_t *
+pcapng_opt_put(uint8_t *p, uint16_t code, const void *data, uint16_t len)
+{
+	struct pcapng_option opt = {
+		.code = code,
+		.length = len,
+	};
+	uint16_t padded = RTE_ALIGN(len, sizeof(uint32_t));
+
+	memcpy(p, &opt, sizeof(opt));
+	p += sizeof(opt);
+	if (len != 0)
+		memcpy(p, data, len);
+	memset(p + len, 0, padded - len);
+
+	return p + padded;
+}
+
+static uint8_t *
+pcapng_opt_put_str(uint8_t *p, uint16_t code, const char *str)
+{
+	if (str == NULL)
+		return p;
+
+	return pcapng_opt_put(p, code, str, strnlen(str, PCAPNG_STR_MAX));
+}
+
+/* Write a buffer entirely */
+static int
+pcapng_write(int fd, const void *buf, size_t len)
+{
+	ssize_t ret;
+
+	while (len > 0) {
+		ret = write(fd, buf, len);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			rte_errno = errno;
+			return -1;
+		}
+		buf = RTE_PTR_ADD(buf, ret);
+		len -= ret;
+	}
+
+	return 0;
+}
+
+/* Write iovecs entirely, they are modified when the write is partial */
+static ssize_t
+pcapng_writev(int fd, struct iovec *iov, int nb_iov)
+{
+	ssize_t total = 0;
+	ssize_t ret;
+
+	while (nb_iov > 0) {
+		ret = writev(fd, iov, nb_iov);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			rte_errno = errno;
+			return -1;
+		}
+		total += ret;
+
+		/* skip what was written */
+		while (nb_iov > 0 && (size_t)ret >= iov->iov_len) {
+			ret -= iov->iov_len;
+			iov++;
+			nb_iov--;
+		}
+		if (ret > 0) {
+			iov->iov_base = RTE_PTR_ADD(iov->iov_base, ret);
+			iov->iov_len -= ret;
+		}
+	}
+
+	return total;
+}
+
+static int
+pcapng_section_header(rte_pcapng_t *self, const char *osname,
+		      const char *hardware, const char *appname,
+		      const char *comment)
+{
+	struct pcapng_section_header *shb;
+	struct utsname uts;
+	char os[PCAPNG_STR_MAX];
+	uint32_t len;
+	uint8_t *buf, *p;
+	int ret;
+
+	if (osname == NULL) {
+		if (uname(&uts) == 0) {
+			snprintf(os, sizeof(os), "%s %s",
+				 uts.sysname, uts.release);
+			osname = os;
+		}
+	}
+	if (appname == NULL)
+		appname = rte_version();
+
+	/* header, 4 string options, end of options and trailer */
+	buf = malloc(sizeof(*shb) + 4 * (sizeof(struct pcapng_option) +
+		     PCAPNG_STR_MAX) + 2 * sizeof(uint32_t));
+	if (buf == NULL) {
+		rte_errno = ENOMEM;
+		return -1;
+	}
+
+	shb = (struct pcapng_section_header *)buf;
+	p = (uint8_t *)(shb + 1);
+	p = pcapng_opt_put_str(p, PCAPNG_SHB_HARDWARE, hardware);
+	p = pcapng_opt_put_str(p, PCAPNG_SHB_OS, osname);
+	p = pcapng_opt_put_str(p, PCAPNG_SHB_USERAPPL, appname);
+	p = pcapng_opt_put_str(p, PCAPNG_OPT_COMMENT, comment);
+	p = pcapng_opt_put(p, PCAPNG_OPT_END, NULL, 0);
+	len = p - buf + sizeof(len);
+	memcpy(p, &len, sizeof(len));
+
+	*shb = (struct pcapng_section_header) {
+		.hdr = {
+			.type = PCAPNG_SHB_TYPE,
+			.length = len,
+		},
+		.byte_order_magic = PCAPNG_BYTE_ORDER_MAGIC,
+		.major_version = PCAPNG_MAJOR_VERSION,
+		.minor_version = PCAPNG_MINOR_VERSION,
+		.section_length = UINT64_MAX, /* not specified */
+	};
+
+	ret = pcapng_write(self->fd, buf, len);
+	free(buf);
+
+	return ret;
+}
+
+rte_pcapng_t *
+rte_pcapng_fdopen(int fd, const char *osname, const char *hardware,
+		  const char *appname, const char *comment)
+{
+	rte_pcapng_t *self;
+	struct timespec ts;
+
+	if (fd < 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	if (pcapng_dyn_register() < 0)
+		return NULL;
+
+	self = rte_zmalloc("pcapng", sizeof(*self), RTE_CACHE_LINE_SIZE);
+	if (self == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	self->fd = fd;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	self->tsc_base = rte_get_tsc_cycles();
+	self->ns_base = (uint64_t)ts.tv_sec * NS_PER_S + ts.tv_nsec;
+	self->tsc_hz = rte_get_tsc_hz();
+	self->tsc_hz_inv = rte_reciprocal_value_u64(self->tsc_hz);
+
+	if (pcapng_section_header(self, osname, hardware, appname,
+				  comment) < 0) {
+		rte_free(self);
+		return NULL;
+	}
+
+	return self;
+}
+
+void
+rte_pcapng_close(rte_pcapng_t *self)
+{
+	if (self == NULL)
+		return;
+
+	close(self->fd);
+	rte_free(self);
+}
+
+struct rte_mbuf *
+rte_pcapng_copy(uint16_t port_id, uint16_t queue,
+		const struct rte_mbuf *m, struct rte_mempool *mp,
+		uint32_t length, enum rte_pcapng_direction direction)
+{
+	struct pcapng_mbuf_meta *meta;
+	struct rte_mbuf *mc;
+
+	if (unlikely(pcapng_dyn_register() < 0))
+		return NULL;
+
+	mc = rte_pktmbuf_copy(m, mp, 0, length);
+	if (unlikely(mc == NULL))
+		return NULL;
+
+	meta = RTE_MBUF_DYNFIELD(mc, pcapng_dynfield_offset,
+				 struct pcapng_mbuf_meta *);
+	meta->tsc = rte_get_tsc_cycles();
+	meta->orig_len = rte_pktmbuf_pkt_len(m);
+	meta->queue = queue;
+	meta->direction = direction;
+	mc->port = port_id;
+	mc->ol_flags |= pcapng_dynflag;
+
+	return mc;
+}
+
+/* Convert a TSC value to nanoseconds since the epoch */
+static inline uint64_t
+pcapng_tsc_to_ns(const rte_pcapng_t *self, uint64_t tsc)
+{
+	uint64_t delta, sec, ns;
+
+	delta = tsc >= self->tsc_base ? tsc - self->tsc_base :
+		self->tsc_base - tsc;
+	sec = rte_reciprocal_divide_u64(delta, &self->tsc_hz_inv);
+	ns = sec * NS_PER_S + rte_reciprocal_divide_u64(
+		(delta - sec * self->tsc_hz) * NS_PER_S, &self->tsc_hz_inv);
+
+	return tsc >= self->tsc_base ? self->ns_base + ns :
+		self->ns_base - ns;
+}
+
+/* Forget the ports whose IDB could not be written, to describe them again */
+static void
+pcapng_idb_cancel(rte_pcapng_t *self, uint32_t nb_idb)
+{
+	while (nb_idb > 0) {
+		self->port_index[self->idb_port[--nb_idb]] = 0;
+		self->nb_interfaces--;
+	}
+}
+
+/* Build the IDB of a port and return its length */
+static uint32_t
+pcapng_interface_block(uint32_t *buf, uint16_t port)
+{
+	struct pcapng_interface_block *idb;
+	char name[RTE_ETH_NAME_MAX_LEN];
+	uint8_t tsresol = 9; /* nanoseconds */
+	uint32_t len;
+	uint8_t *p;
+
+	if (port == PCAPNG_PORT_UNKNOWN)
+		strlcpy(name, "unknown", sizeof(name));
+	else if (rte_eth_dev_get_name_by_port(port, name) != 0)
+		snprintf(name, sizeof(name), "port%u", port);
+
+	idb = (struct pcapng_interface_block *)buf;
+	p = (uint8_t *)(idb + 1);
+	p = pcapng_opt_put(p, PCAPNG_IFB_NAME, name, strlen(name));
+	p = pcapng_opt_put(p, PCAPNG_IFB_TSRESOL, &tsresol, sizeof(tsresol));
+	p = pcapng_opt_put(p, PCAPNG_OPT_END, NULL, 0);
+	len = p - (uint8_t *)buf + sizeof(len);
+	memcpy(p, &len, sizeof(len));
+
+	*idb = (struct pcapng_interface_block) {
+		.hdr = {
+			.type = PCAPNG_IDB_TYPE,
+			.length = len,
+		},
+		.link_type = PCAPNG_LINKTYPE_ETHERNET,
+		.snap_len = 0, /* no limit */
+	};
+
+	return len;
+}
+
+ssize_t
+rte_pcapng_write_packets(rte_pcapng_t *self, struct rte_mbuf *pkts[],
+			 uint16_t nb_pkts)
+{
+	static const uint8_t pad[sizeof(uint32_t)];
+	const struct pcapng_mbuf_meta *meta;
+	struct pcapng_epb_buf *eb;
+	const struct rte_mbuf *m, *seg;
+	uint32_t nb_epb = 0, nb_idb = 0;
+	uint32_t cap_len, orig_len, len, port, flags, queue;
+	uint64_t now = 0, tsc, ns;
+	ssize_t total = 0, ret;
+	int nb_iov = 0, max_segs;
+	uint8_t hash[1 + sizeof(uint32_t)];
+	uint16_t i, has_queue;
+	uint8_t *p;
+
+	for (i = 0; i < nb_pkts; i++) {
+		m = pkts[i];
+
+		/* flush the burst when out of blocks or iovecs */
+		if (nb_iov > 0 && (nb_epb == PCAPNG_BURST ||
+		    nb_iov + PCAPNG_PKT_IOV + m->nb_segs > PCAPNG_IOV_MAX)) {
+			ret = pcapng_writev(self->fd, self->iov, nb_iov);
+			if (ret < 0) {
+				pcapng_idb_cancel(self, nb_idb);
+				return -1;
+			}
+			total += ret;
+			nb_iov = 0;
+			nb_epb = 0;
+			nb_idb = 0;
+		}
+
+		if (m->ol_flags & pcapng_dynflag) {
+			meta = RTE_MBUF_DYNFIELD(m, pcapng_dynfield_offset,
+				const struct pcapng_mbuf_meta *);
+			tsc = meta->tsc;
+			orig_len = meta->orig_len;
+			queue = meta->queue;
+			has_queue = 1;
+			flags = meta->direction == RTE_PCAPNG_DIRECTION_IN ?
+				PCAPNG_EPB_FLAG_INBOUND :
+				meta->direction == RTE_PCAPNG_DIRECTION_OUT ?
+				PCAPNG_EPB_FLAG_OUTBOUND : 0;
+		} else {
+			if (now == 0)
+				now = rte_get_tsc_cycles();
+			tsc = now;
+			orig_len = rte_pktmbuf_pkt_len(m);
+			queue = 0;
+			has_queue = 0;
+			flags = 0;
+		}
+
+		/* describe the interface before its first packet */
+		port = m->port < RTE_MAX_ETHPORTS ? m->port :
+			PCAPNG_PORT_UNKNOWN;
+		if (self->port_index[port] == 0) {
+			len = pcapng_interface_block(self->idb[nb_idb], port);
+			self->iov[nb_iov].iov_base = self->idb[nb_idb];
+			self->iov[nb_iov].iov_len = len;
+			nb_iov++;
+			self->idb_port[nb_idb++] = port;
+			self->port_index[port] = ++self->nb_interfaces;
+		}
+
+		eb = &self->epb[nb_epb++];
+		self->iov[nb_iov].iov_base = &eb->epb;
+		self->iov[nb_iov].iov_len = sizeof(eb->epb);
+		nb_iov++;
+
+		/* packet data, straight from the mbuf segments */
+		cap_len = 0;
+		max_segs = PCAPNG_IOV_MAX - PCAPNG_PKT_IOV;
+		for (seg = m; seg != NULL && max_segs > 0;
+		     seg = seg->next, max_segs--) {
+			self->iov[nb_iov].iov_base =
+				rte_pktmbuf_mtod(seg, void *);
+			self->iov[nb_iov].iov_len = seg->data_len;
+			cap_len += seg->data_len;
+			nb_iov++;
+		}
+
+		/* padding, options and trailer */
+		p = eb->tail;
+		memcpy(p, pad, RTE_ALIGN(cap_len, sizeof(uint32_t)) - cap_len);
+		p += RTE_ALIGN(cap_len, sizeof(uint32_t)) - cap_len;
+		if (flags != 0)
+			p = pcapng_opt_put(p, PCAPNG_EPB_FLAGS, &flags,
+					   sizeof(flags));
+		if (m->ol_flags & PKT_RX_RSS_HASH) {
+			hash[0] = PCAPNG_HASH_TOEPLITZ;
+			memcpy(&hash[1], &m->hash.rss, sizeof(m->hash.rss));
+			p = pcapng_opt_put(p, PCAPNG_EPB_HASH, hash,
+					   sizeof(hash));
+		}
+		if (has_queue)
+			p = pcapng_opt_put(p, PCAPNG_EPB_QUEUE, &queue,
+					   sizeof(queue));
+		p = pcapng_opt_put(p, PCAPNG_OPT_END, NULL, 0);
+		len = sizeof(eb->epb) + cap_len + (p - eb->tail) +
+			sizeof(len);
+		memcpy(p, &len, sizeof(len));
+		p += sizeof(len);
+		self->iov[nb_iov].iov_base = eb->tail;
+		self->iov[nb_iov].iov_len = p - eb->tail;
+		nb_iov++;
+
+		ns = pcapng_tsc_to_ns(self, tsc);
+		eb->epb = (struct pcapng_enhance_packet_block) {
+			.hdr = {
+				.type = PCAPNG_EPB_TYPE,
+				.length = len,
+			},
+			.interface_id = self->port_index[port] - 1,
+			.timestamp_hi = ns >> 32,
+			.timestamp_lo = (uint32_t)ns,
+			.capture_length = cap_len,
+			.original_length = RTE_MAX(orig_len, cap_len),
+		};
+	}
+
+	if (nb_iov > 0) {
+		ret = pcapng_writev(self->fd, self->iov, nb_iov);
+		if (ret < 0) {
+			pcapng_idb_cancel(self, nb_idb);
+			return -1;
+		}
+		total += ret;
+	}
+
+	return total;
+}
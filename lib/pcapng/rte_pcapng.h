@@ -0,0 +1,149 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_PCAPNG_H_
+#define _RTE_PCAPNG_H_
+
+/**
+ * @file
+ * RTE pcapng
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * Packet capture file writer in the pcapng format, with no dependency on
+ * libpcap. Along with the packets, the file records their port, queue,
+ * direction, RSS hash and original length, and timestamps in nanoseconds
+ * derived from the TSC.
+ *
+ * The packets are written as they are in the mbufs, the mbuf segments are
+ * passed to the kernel with writev() without being copied, one system call
+ * per burst.
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <rte_compat.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Opaque pcapng file writer */
+typedef struct rte_pcapng rte_pcapng_t;
+
+/** Direction of a captured packet */
+enum rte_pcapng_direction {
+	RTE_PCAPNG_DIRECTION_UNKNOWN = 0,
+	RTE_PCAPNG_DIRECTION_IN = 1,  /**< received packet */
+	RTE_PCAPNG_DIRECTION_OUT = 2, /**< transmitted packet */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Start a pcapng file on a file descriptor by writing its section header.
+ * The interface descriptions are written when the first packet of each port
+ * is written.
+ *
+ * @param fd
+ *   File descriptor opened for writing, owned by the writer from now on.
+ * @param osname
+ *   Operating system name recorded in the section header,
+ *   if NULL it is read with uname().
+ * @param hardware
+ *   Hardware description recorded in the section header, can be NULL.
+ * @param appname
+ *   Name of the application recorded in the section header,
+ *   if NULL the DPDK version is recorded.
+ * @param comment
+ *   Comment recorded in the section header, can be NULL.
+ * @return
+ *   The writer, or NULL on error with rte_errno set.
+ */
+__rte_experimental
+rte_pcapng_t *
+rte_pcapng_fdopen(int fd, const char *osname, const char *hardware,
+		  const char *appname, const char *comment);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Close a pcapng writer and its file descriptor.
+ *
+ * @param self
+ *   The writer, can be NULL.
+ */
+__rte_experimental
+void
+rte_pcapng_close(rte_pcapng_t *self);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Copy a packet for capture, along with the metadata recorded when it is
+ * written: port, queue, direction, original length and timestamp.
+ * The RSS hash is recorded when PKT_RX_RSS_HASH is set.
+ *
+ * Can be called on the datapath, from any lcore.
+ *
+ * @param port_id
+ *   Port on which the packet is captured.
+ * @param queue
+ *   Queue on which the packet is captured.
+ * @param m
+ *   Packet to copy.
+ * @param mp
+ *   Mempool to allocate the copy from.
+ * @param length
+ *   Maximum number of bytes to copy, UINT32_MAX for the whole packet.
+ * @param direction
+ *   Direction of the packet.
+ * @return
+ *   The copy, or NULL on error with rte_errno set.
+ */
+__rte_experimental
+struct rte_mbuf *
+rte_pcapng_copy(uint16_t port_id, uint16_t queue,
+		const struct rte_mbuf *m, struct rte_mempool *mp,
+		uint32_t length, enum rte_pcapng_direction direction);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Write a burst of packets to a pcapng file.
+ *
+ * The metadata of the packets copied by rte_pcapng_copy() are recorded.
+ * Other packets are recorded on the interface of their mbuf port, with the
+ * time of the call as timestamp and no queue or direction.
+ *
+ * The packets are not freed.
+ *
+ * @param self
+ *   The writer.
+ * @param pkts
+ *   Packets to write.
+ * @param nb_pkts
+ *   Number of packets to write.
+ * @return
+ *   Number of bytes written, or -1 on error with rte_errno set.
+ */
+__rte_experimental
+ssize_t
+rte_pcapng_write_packets(rte_pcapng_t *self, struct rte_mbuf *pkts[],
+			 uint16_t nb_pkts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_PCAPNG_H_ */
@@ -8,7 +8,10 @@
 #include <rte_lcore.h>
 #include <rte_log.h>
 #include <rte_errno.h>
+#include <rte_pause.h>
 #include <rte_string_fns.h>
+#include <rte_bpf.h>
+#include <rte_pcapng.h>
 
 #include "rte_pdump.h"
 
@@ -28,7 +31,8 @@ enum pdump_operation {
 };
 
 enum pdump_version {
-	V1 = 1
+	V1 = 1,
+	V2 = 2, /* enable request with a BPF filter and a snap length */
 };
 
 struct pdump_request {
@@ -42,6 +46,9 @@ struct pdump_request {
 			struct rte_ring *ring;
 			struct rte_mempool *mp;
 			void *filter;
+			/* V2 only */
+			const struct rte_bpf_prm *prm;
+			uint32_t snaplen;
 		} en_v1;
 		struct disable_v1 {
 			char device[RTE_DEV_NAME_MAX_LEN];
@@ -60,31 +67,112 @@ struct pdump_response {
 };
 
 static struct pdump_rxtx_cbs {
+	uint32_t use; /* usage counter, odd while used by the datapath */
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
 	const struct rte_eth_rxtx_callback *cb;
-	void *filter;
+	struct rte_bpf *filter;
+	struct rte_bpf_jit jit;
+	uint32_t snaplen; /* max length of the copies */
+	int filter_mbuf; /* filter argument is the mbuf, not the data */
+	int pcapng; /* copies carry the pcapng metadata */
 } rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT],
 tx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
 
+/*
+ * The callbacks can still run on the datapath once removed: the filter
+ * is only destroyed after the usage counter shows that they are done with
+ * it, as done for the BPF ethdev callbacks.
+ */
+static inline void
+pdump_cbs_inuse(struct pdump_rxtx_cbs *cbs)
+{
+	cbs->use++;
+	/* make sure no store/load reordering could happen */
+	rte_smp_mb();
+}
 
 static inline void
-pdump_copy(struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
+pdump_cbs_unuse(struct pdump_rxtx_cbs *cbs)
+{
+	/* make sure all previous loads are completed */
+	rte_smp_rmb();
+	cbs->use++;
+}
+
+static void
+pdump_cbs_wait(const struct pdump_rxtx_cbs *cbs)
+{
+	uint32_t nuse, puse;
+
+	/* make sure all previous loads and stores are completed */
+	rte_smp_mb();
+
+	puse = cbs->use;
+
+	/* in use, busy wait till current RX/TX iteration is finished */
+	if ((puse & 1) != 0) {
+		do {
+			rte_pause();
+			rte_compiler_barrier();
+			nuse = cbs->use;
+		} while (nuse == puse);
+	}
+}
+
+/* Run the filter on the packets, rc[i] is 0 for the ones to skip */
+static inline void
+pdump_filter(const struct pdump_rxtx_cbs *cbs, struct rte_mbuf **pkts,
+	uint16_t nb_pkts, uint64_t rc[])
+{
+	void *dp[nb_pkts];
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts; i++)
+		dp[i] = cbs->filter_mbuf ? (void *)pkts[i] :
+			rte_pktmbuf_mtod(pkts[i], void *);
+
+	if (cbs->jit.func != NULL) {
+		for (i = 0; i < nb_pkts; i++)
+			rc[i] = cbs->jit.func(dp[i]);
+	} else
+		rte_bpf_exec_burst(cbs->filter, dp, rc, nb_pkts);
+}
+
+static inline void
+pdump_copy(uint16_t port, uint16_t queue, enum rte_pcapng_direction direction,
+	struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 {
 	unsigned int i;
 	int ring_enq;
 	uint16_t d_pkts = 0;
 	struct rte_mbuf *dup_bufs[nb_pkts];
+	uint64_t rc[nb_pkts];
 	struct pdump_rxtx_cbs *cbs;
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
 	struct rte_mbuf *p;
 
 	cbs  = user_params;
+	pdump_cbs_inuse(cbs);
+	if (unlikely(cbs->cb == NULL)) {
+		pdump_cbs_unuse(cbs);
+		return;
+	}
+
 	ring = cbs->ring;
 	mp = cbs->mp;
+	if (cbs->filter != NULL)
+		pdump_filter(cbs, pkts, nb_pkts, rc);
+
 	for (i = 0; i < nb_pkts; i++) {
-		p = rte_pktmbuf_copy(pkts[i], mp, 0, UINT32_MAX);
+		if (cbs->filter != NULL && rc[i] == 0)
+			continue;
+		if (cbs->pcapng)
+			p = rte_pcapng_copy(port, queue, pkts[i], mp,
+				cbs->snaplen, direction);
+		else
+			p = rte_pktmbuf_copy(pkts[i], mp, 0, cbs->snaplen);
 		if (p)
 			dup_bufs[d_pkts++] = p;
 	}
@@ -97,33 +185,80 @@ pdump_copy(struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 			"only %d of packets enqueued to ring\n", ring_enq);
 		rte_pktmbuf_free_bulk(&dup_bufs[ring_enq], drops);
 	}
+	pdump_cbs_unuse(cbs);
+}
+
+/*
+ * Set up the capture parameters of a queue before its callback is added,
+ * the filter is loaded from the parameters built by the secondary process.
+ */
+static int
+pdump_cbs_set(struct pdump_rxtx_cbs *cbs, struct rte_ring *ring,
+	struct rte_mempool *mp, const struct rte_bpf_prm *prm,
+	uint32_t snaplen, uint32_t flags)
+{
+	cbs->ring = ring;
+	cbs->mp = mp;
+	cbs->snaplen = snaplen == 0 ? UINT32_MAX : snaplen;
+	cbs->pcapng = (flags & RTE_PDUMP_FLAG_PCAPNG) != 0;
+	cbs->filter = NULL;
+	cbs->filter_mbuf = 0;
+	memset(&cbs->jit, 0, sizeof(cbs->jit));
+	if (prm == NULL)
+		return 0;
+
+	cbs->filter = rte_bpf_load(prm);
+	if (cbs->filter == NULL) {
+		PDUMP_LOG(ERR, "failed to load BPF filter, errno=%d\n",
+			rte_errno);
+		return -rte_errno;
+	}
+	cbs->filter_mbuf = prm->prog_arg.type == RTE_BPF_ARG_PTR_MBUF;
+	/* the interpreter is used when there is no JIT */
+	rte_bpf_get_jit(cbs->filter, &cbs->jit);
+
+	return 0;
+}
+
+/* Release the filter of a queue once its callback is removed */
+static void
+pdump_cbs_clear(struct pdump_rxtx_cbs *cbs)
+{
+	pdump_cbs_wait(cbs);
+	rte_bpf_destroy(cbs->filter);
+	cbs->filter = NULL;
+	memset(&cbs->jit, 0, sizeof(cbs->jit));
 }
 
 static uint16_t
-pdump_rx(uint16_t port __rte_unused, uint16_t qidx __rte_unused,
+pdump_rx(uint16_t port, uint16_t qidx,
 	struct rte_mbuf **pkts, uint16_t nb_pkts,
 	uint16_t max_pkts __rte_unused,
 	void *user_params)
 {
-	pdump_copy(pkts, nb_pkts, user_params);
+	pdump_copy(port, qidx, RTE_PCAPNG_DIRECTION_IN, pkts, nb_pkts,
+		user_params);
 	return nb_pkts;
 }
 
 static uint16_t
-pdump_tx(uint16_t port __rte_unused, uint16_t qidx __rte_unused,
+pdump_tx(uint16_t port, uint16_t qidx,
 		struct rte_mbuf **pkts, uint16_t nb_pkts, void *user_params)
 {
-	pdump_copy(pkts, nb_pkts, user_params);
+	pdump_copy(port, qidx, RTE_PCAPNG_DIRECTION_OUT, pkts, nb_pkts,
+		user_params);
 	return nb_pkts;
 }
 
 static int
 pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 				struct rte_ring *ring, struct rte_mempool *mp,
-				uint16_t operation)
+				const struct rte_bpf_prm *prm, uint32_t snaplen,
+				uint32_t flags, uint16_t operation)
 {
 	uint16_t qid;
 	struct pdump_rxtx_cbs *cbs = NULL;
+	int ret;
 
 	qid = (queue == RTE_PDUMP_ALL_QUEUES) ? 0 : queue;
 	for (; qid < end_q; qid++) {
@@ -135,20 +270,21 @@ pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 					port, qid);
 				return -EEXIST;
 			}
-			cbs->ring = ring;
-			cbs->mp = mp;
+			ret = pdump_cbs_set(cbs, ring, mp, prm, snaplen,
+					flags);
+			if (ret < 0)
+				return ret;
 			cbs->cb = rte_eth_add_first_rx_callback(port, qid,
 								pdump_rx, cbs);
 			if (cbs->cb == NULL) {
 				PDUMP_LOG(ERR,
 					"failed to add rx callback, errno=%d\n",
 					rte_errno);
+				pdump_cbs_clear(cbs);
 				return rte_errno;
 			}
 		}
 		if (cbs && operation == DISABLE) {
-			int ret;
-
 			if (cbs->cb == NULL) {
 				PDUMP_LOG(ERR,
 					"no existing rx callback for port=%d queue=%d\n",
@@ -163,6 +299,7 @@ pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 				return ret;
 			}
 			cbs->cb = NULL;
+			pdump_cbs_clear(cbs);
 		}
 	}
 
@@ -172,11 +309,13 @@ pdump_register_rx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 static int
 pdump_register_tx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 				struct rte_ring *ring, struct rte_mempool *mp,
-				uint16_t operation)
+				const struct rte_bpf_prm *prm, uint32_t snaplen,
+				uint32_t flags, uint16_t operation)
 {
 
 	uint16_t qid;
 	struct pdump_rxtx_cbs *cbs = NULL;
+	int ret;
 
 	qid = (queue == RTE_PDUMP_ALL_QUEUES) ? 0 : queue;
 	for (; qid < end_q; qid++) {
@@ -188,20 +327,21 @@ pdump_register_tx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 					port, qid);
 				return -EEXIST;
 			}
-			cbs->ring = ring;
-			cbs->mp = mp;
+			ret = pdump_cbs_set(cbs, ring, mp, prm, snaplen,
+					flags);
+			if (ret < 0)
+				return ret;
 			cbs->cb = rte_eth_add_tx_callback(port, qid, pdump_tx,
 								cbs);
 			if (cbs->cb == NULL) {
 				PDUMP_LOG(ERR,
 					"failed to add tx callback, errno=%d\n",
 					rte_errno);
+				pdump_cbs_clear(cbs);
 				return rte_errno;
 			}
 		}
 		if (cbs && operation == DISABLE) {
-			int ret;
-
 			if (cbs->cb == NULL) {
 				PDUMP_LOG(ERR,
 					"no existing tx callback for port=%d queue=%d\n",
@@ -216,6 +356,7 @@ pdump_register_tx_callbacks(uint16_t end_q, uint16_t port, uint16_t queue,
 				return ret;
 			}
 			cbs->cb = NULL;
+			pdump_cbs_clear(cbs);
 		}
 	}
 
@@ -228,13 +369,21 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	uint16_t nb_rx_q = 0, nb_tx_q = 0, end_q, queue;
 	uint16_t port;
 	int ret = 0;
-	uint32_t flags;
+	uint32_t flags, rxtx;
 	uint16_t operation;
 	struct rte_ring *ring;
 	struct rte_mempool *mp;
+	const struct rte_bpf_prm *prm = NULL;
+	uint32_t snaplen = 0;
+
+	if (p->ver != V1 && p->ver != V2) {
+		PDUMP_LOG(ERR, "unsupported request version %u\n", p->ver);
+		return -EINVAL;
+	}
 
 	flags = p->flags;
 	operation = p->op;
+	rxtx = flags & RTE_PDUMP_FLAG_RXTX;
 	if (operation == ENABLE) {
 		ret = rte_eth_dev_get_port_by_name(p->data.en_v1.device,
 				&port);
@@ -247,6 +396,10 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 		queue = p->data.en_v1.queue;
 		ring = p->data.en_v1.ring;
 		mp = p->data.en_v1.mp;
+		if (p->ver == V2) {
+			prm = p->data.en_v1.prm;
+			snaplen = p->data.en_v1.snaplen;
+		}
 	} else {
 		ret = rte_eth_dev_get_port_by_name(p->data.dis_v1.device,
 				&port);
@@ -286,7 +439,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 			return -EINVAL;
 		}
 		if ((nb_tx_q == 0 || nb_rx_q == 0) &&
-			flags == RTE_PDUMP_FLAG_RXTX) {
+			rxtx == RTE_PDUMP_FLAG_RXTX) {
 			PDUMP_LOG(ERR,
 				"both tx&rx queues must be non zero\n");
 			return -EINVAL;
@@ -297,6 +450,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	if (flags & RTE_PDUMP_FLAG_RX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_rx_q : queue + 1;
 		ret = pdump_register_rx_callbacks(end_q, port, queue, ring, mp,
+							prm, snaplen, flags,
 							operation);
 		if (ret < 0)
 			return ret;
@@ -306,6 +460,7 @@ set_pdump_rxtx_cbs(const struct pdump_request *p)
 	if (flags & RTE_PDUMP_FLAG_TX) {
 		end_q = (queue == RTE_PDUMP_ALL_QUEUES) ? nb_tx_q : queue + 1;
 		ret = pdump_register_tx_callbacks(end_q, port, queue, ring, mp,
+							prm, snaplen, flags,
 							operation);
 		if (ret < 0)
 			return ret;
@@ -392,10 +547,13 @@ pdump_validate_ring_mp(struct rte_ring *ring, struct rte_mempool *mp)
 static int
 pdump_validate_flags(uint32_t flags)
 {
-	if (flags != RTE_PDUMP_FLAG_RX && flags != RTE_PDUMP_FLAG_TX &&
-		flags != RTE_PDUMP_FLAG_RXTX) {
+	uint32_t rxtx = flags & RTE_PDUMP_FLAG_RXTX;
+
+	if (rxtx == 0 || (flags & ~(RTE_PDUMP_FLAG_RXTX |
+			RTE_PDUMP_FLAG_PCAPNG)) != 0) {
 		PDUMP_LOG(ERR,
-			"invalid flags, should be either rx/tx/rxtx\n");
+			"invalid flags, should be either rx/tx/rxtx,"
+			" optionally with pcapng\n");
 		rte_errno = EINVAL;
 		return -1;
 	}
@@ -426,12 +584,12 @@ pdump_validate_port(uint16_t port, char *name)
 }
 
 static int
-pdump_prepare_client_request(char *device, uint16_t queue,
-				uint32_t flags,
+pdump_prepare_client_request(const char *device, uint16_t queue,
+				uint32_t flags, uint32_t snaplen,
 				uint16_t operation,
 				struct rte_ring *ring,
 				struct rte_mempool *mp,
-				void *filter)
+				const struct rte_bpf_prm *prm)
 {
 	int ret = -1;
 	struct rte_mp_msg mp_req, *mp_rep;
@@ -440,7 +598,8 @@ pdump_prepare_client_request(char *device, uint16_t queue,
 	struct pdump_request *req = (struct pdump_request *)mp_req.param;
 	struct pdump_response *resp;
 
-	req->ver = 1;
+	memset(req, 0, sizeof(*req));
+	req->ver = V2;
 	req->flags = flags;
 	req->op = operation;
 	if ((operation & ENABLE) != 0) {
@@ -449,7 +608,8 @@ pdump_prepare_client_request(char *device, uint16_t queue,
 		req->data.en_v1.queue = queue;
 		req->data.en_v1.ring = ring;
 		req->data.en_v1.mp = mp;
-		req->data.en_v1.filter = filter;
+		req->data.en_v1.prm = prm;
+		req->data.en_v1.snaplen = snaplen;
 	} else {
 		strlcpy(req->data.dis_v1.device, device,
 			sizeof(req->data.dis_v1.device));
@@ -477,11 +637,10 @@ pdump_prepare_client_request(char *device, uint16_t queue,
 	return ret;
 }
 
-int
-rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
-			struct rte_ring *ring,
-			struct rte_mempool *mp,
-			void *filter)
+static int
+pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
+		uint32_t snaplen, struct rte_ring *ring,
+		struct rte_mempool *mp, const struct rte_bpf_prm *prm)
 {
 	int ret;
 	char name[RTE_DEV_NAME_MAX_LEN];
@@ -496,18 +655,18 @@ rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(name, queue, flags,
-						ENABLE, ring, mp, filter);
+	ret = pdump_prepare_client_request(name, queue, flags, snaplen,
+						ENABLE, ring, mp, prm);
 
 	return ret;
 }
 
-int
-rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
-				uint32_t flags,
+static int
+pdump_enable_by_deviceid(const char *device_id, uint16_t queue,
+				uint32_t flags, uint32_t snaplen,
 				struct rte_ring *ring,
 				struct rte_mempool *mp,
-				void *filter)
+				const struct rte_bpf_prm *prm)
 {
 	int ret = 0;
 
@@ -518,12 +677,53 @@ rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(device_id, queue, flags,
-						ENABLE, ring, mp, filter);
+	ret = pdump_prepare_client_request(device_id, queue, flags, snaplen,
+						ENABLE, ring, mp, prm);
 
 	return ret;
 }
 
+int
+rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
+			struct rte_ring *ring,
+			struct rte_mempool *mp,
+			void *filter __rte_unused)
+{
+	return pdump_enable(port, queue, flags, 0, ring, mp, NULL);
+}
+
+int
+rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
+				uint32_t flags,
+				struct rte_ring *ring,
+				struct rte_mempool *mp,
+				void *filter __rte_unused)
+{
+	return pdump_enable_by_deviceid(device_id, queue, flags, 0, ring, mp,
+					NULL);
+}
+
+int
+rte_pdump_enable_bpf(uint16_t port, uint16_t queue, uint32_t flags,
+			uint32_t snaplen,
+			struct rte_ring *ring,
+			struct rte_mempool *mp,
+			const struct rte_bpf_prm *prm)
+{
+	return pdump_enable(port, queue, flags, snaplen, ring, mp, prm);
+}
+
+int
+rte_pdump_enable_bpf_by_deviceid(const char *device_id, uint16_t queue,
+				uint32_t flags, uint32_t snaplen,
+				struct rte_ring *ring,
+				struct rte_mempool *mp,
+				const struct rte_bpf_prm *prm)
+{
+	return pdump_enable_by_deviceid(device_id, queue, flags, snaplen,
+					ring, mp, prm);
+}
+
 int
 rte_pdump_disable(uint16_t port, uint16_t queue, uint32_t flags)
 {
@@ -537,7 +737,7 @@ rte_pdump_disable(uint16_t port, uint16_t queue, uint32_t flags)
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(name, queue, flags,
+	ret = pdump_prepare_client_request(name, queue, flags, 0,
 						DISABLE, NULL, NULL, NULL);
 
 	return ret;
@@ -553,7 +753,7 @@ rte_pdump_disable_by_deviceid(char *device_id, uint16_t queue,
 	if (ret < 0)
 		return ret;
 
-	ret = pdump_prepare_client_request(device_id, queue, flags,
+	ret = pdump_prepare_client_request(device_id, queue, flags, 0,
 						DISABLE, NULL, NULL, NULL);
 
 	return ret;
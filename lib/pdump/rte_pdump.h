@@ -13,6 +13,7 @@
  */
 
 #include <stdint.h>
+#include <rte_compat.h>
 #include <rte_mempool.h>
 #include <rte_ring.h>
 
@@ -22,11 +23,15 @@ extern "C" {
 
 #define RTE_PDUMP_ALL_QUEUES UINT16_MAX
 
+struct rte_bpf_prm;
+
 enum {
 	RTE_PDUMP_FLAG_RX = 1,  /* receive direction */
 	RTE_PDUMP_FLAG_TX = 2,  /* transmit direction */
 	/* both receive and transmit directions */
-	RTE_PDUMP_FLAG_RXTX = (RTE_PDUMP_FLAG_RX|RTE_PDUMP_FLAG_TX)
+	RTE_PDUMP_FLAG_RXTX = (RTE_PDUMP_FLAG_RX|RTE_PDUMP_FLAG_TX),
+	/* record the metadata written by rte_pcapng_write_packets() */
+	RTE_PDUMP_FLAG_PCAPNG = 4,
 };
 
 /**
@@ -63,6 +68,8 @@ rte_pdump_uninit(void);
  * @param flags
  *  flags specifies RTE_PDUMP_FLAG_RX/RTE_PDUMP_FLAG_TX/RTE_PDUMP_FLAG_RXTX
  *  on which packet capturing should be enabled for a given port and queue.
+ *  RTE_PDUMP_FLAG_PCAPNG can be added to keep in the copies the metadata
+ *  recorded by rte_pcapng_write_packets().
  * @param ring
  *  ring on which captured packets will be enqueued for user.
  * @param mp
@@ -80,6 +87,53 @@ rte_pdump_enable(uint16_t port, uint16_t queue, uint32_t flags,
 		struct rte_mempool *mp,
 		void *filter);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Enables packet capturing on given port and queue, with a filter selecting
+ * the packets to capture and a limit of the captured length.
+ *
+ * The filter is loaded and run by the process doing the packet I/O, in place
+ * of the whole packet copy for the packets it does not select. It is JIT
+ * compiled when the platform supports it.
+ *
+ * @param port
+ *  port on which packet capturing should be enabled.
+ * @param queue
+ *  queue of a given port on which packet capturing should be enabled.
+ *  users should pass on value UINT16_MAX to enable packet capturing on all
+ *  queues of a given port.
+ * @param flags
+ *  flags specifies RTE_PDUMP_FLAG_RX/RTE_PDUMP_FLAG_TX/RTE_PDUMP_FLAG_RXTX
+ *  on which packet capturing should be enabled for a given port and queue.
+ *  RTE_PDUMP_FLAG_PCAPNG can be added to keep in the copies the metadata
+ *  recorded by rte_pcapng_write_packets().
+ * @param snaplen
+ *  max number of bytes of each packet to capture, 0 for the whole packets.
+ * @param ring
+ *  ring on which captured packets will be enqueued for user.
+ * @param mp
+ *  mempool on to which original packets will be mirrored or duplicated.
+ * @param prm
+ *  BPF program parameters, the packets for which the program returns 0 are
+ *  not captured. The program argument is either the mbuf
+ *  (RTE_BPF_ARG_PTR_MBUF) or the packet data (RTE_BPF_ARG_PTR), e.g. as
+ *  returned by rte_bpf_convert(). The parameters must be in memory shared
+ *  between the processes and must not use any external symbol.
+ *  NULL to capture all the packets.
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_bpf(uint16_t port, uint16_t queue, uint32_t flags,
+		uint32_t snaplen,
+		struct rte_ring *ring,
+		struct rte_mempool *mp,
+		const struct rte_bpf_prm *prm);
+
 /**
  * Disables packet capturing on given port and queue.
  *
@@ -113,6 +167,8 @@ rte_pdump_disable(uint16_t port, uint16_t queue, uint32_t flags);
  * @param flags
  *  flags specifies RTE_PDUMP_FLAG_RX/RTE_PDUMP_FLAG_TX/RTE_PDUMP_FLAG_RXTX
  *  on which packet capturing should be enabled for a given port and queue.
+ *  RTE_PDUMP_FLAG_PCAPNG can be added to keep in the copies the metadata
+ *  recorded by rte_pcapng_write_packets().
  * @param ring
  *  ring on which captured packets will be enqueued for user.
  * @param mp
@@ -131,6 +187,46 @@ rte_pdump_enable_by_deviceid(char *device_id, uint16_t queue,
 				struct rte_mempool *mp,
 				void *filter);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Enables packet capturing on given device id and queue, with a filter
+ * selecting the packets to capture and a limit of the captured length.
+ * device_id can be name or pci address of device.
+ *
+ * @param device_id
+ *  device id on which packet capturing should be enabled.
+ * @param queue
+ *  queue of a given device id on which packet capturing should be enabled.
+ *  users should pass on value UINT16_MAX to enable packet capturing on all
+ *  queues of a given device id.
+ * @param flags
+ *  flags specifies RTE_PDUMP_FLAG_RX/RTE_PDUMP_FLAG_TX/RTE_PDUMP_FLAG_RXTX
+ *  on which packet capturing should be enabled for a given port and queue.
+ *  RTE_PDUMP_FLAG_PCAPNG can be added to keep in the copies the metadata
+ *  recorded by rte_pcapng_write_packets().
+ * @param snaplen
+ *  max number of bytes of each packet to capture, 0 for the whole packets.
+ * @param ring
+ *  ring on which captured packets will be enqueued for user.
+ * @param mp
+ *  mempool on to which original packets will be mirrored or duplicated.
+ * @param prm
+ *  BPF program parameters, see rte_pdump_enable_bpf().
+ *  NULL to capture all the packets.
+ *
+ * @return
+ *    0 on success, -1 on error, rte_errno is set accordingly.
+ */
+__rte_experimental
+int
+rte_pdump_enable_bpf_by_deviceid(const char *device_id, uint16_t queue,
+				uint32_t flags, uint32_t snaplen,
+				struct rte_ring *ring,
+				struct rte_mempool *mp,
+				const struct rte_bpf_prm *prm);
+
 /**
  * Disables packet capturing on given device_id and queue.
  * device_id can be name or pci address of device.
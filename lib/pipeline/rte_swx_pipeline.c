@@ -9,14 +9,19 @@
 #include <sys/queue.h>
 #include <arpa/inet.h>
 
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <dlfcn.h>
+
 #include <rte_common.h>
 #include <rte_prefetch.h>
 #include <rte_byteorder.h>
 #include <rte_cycles.h>
 #include <rte_meter.h>
 
-#include "rte_swx_pipeline.h"
-#include "rte_swx_ctl.h"
+#include "rte_swx_pipeline_internal.h"
 
 #define CHECK(condition, err_code)                                             \
 do {                                                                           \
@@ -37,22 +42,9 @@ do {                                                                           \
 	       RTE_SWX_INSTRUCTION_SIZE),                                      \
 	      err_code)
 
-#ifndef TRACE_LEVEL
-#define TRACE_LEVEL 0
-#endif
-
-#if TRACE_LEVEL
-#define TRACE(...) printf(__VA_ARGS__)
-#else
-#define TRACE(...)
-#endif
-
 /*
  * Environment.
  */
-#define ntoh64(x) rte_be_to_cpu_64(x)
-#define hton64(x) rte_cpu_to_be_64(x)
-
 #ifndef RTE_SWX_PIPELINE_HUGE_PAGES_DISABLE
 
 #include <rte_malloc.h>
@@ -100,1245 +92,6 @@ env_free(void *start, size_t size)
 
 #endif
 
-/*
- * Struct.
- */
-struct field {
-	char name[RTE_SWX_NAME_SIZE];
-	uint32_t n_bits;
-	uint32_t offset;
-};
-
-struct struct_type {
-	TAILQ_ENTRY(struct_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct field *fields;
-	uint32_t n_fields;
-	uint32_t n_bits;
-};
-
-TAILQ_HEAD(struct_type_tailq, struct_type);
-
-/*
- * Input port.
- */
-struct port_in_type {
-	TAILQ_ENTRY(port_in_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct rte_swx_port_in_ops ops;
-};
-
-TAILQ_HEAD(port_in_type_tailq, port_in_type);
-
-struct port_in {
-	TAILQ_ENTRY(port_in) node;
-	struct port_in_type *type;
-	void *obj;
-	uint32_t id;
-};
-
-TAILQ_HEAD(port_in_tailq, port_in);
-
-struct port_in_runtime {
-	rte_swx_port_in_pkt_rx_t pkt_rx;
-	void *obj;
-};
-
-/*
- * Output port.
- */
-struct port_out_type {
-	TAILQ_ENTRY(port_out_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct rte_swx_port_out_ops ops;
-};
-
-TAILQ_HEAD(port_out_type_tailq, port_out_type);
-
-struct port_out {
-	TAILQ_ENTRY(port_out) node;
-	struct port_out_type *type;
-	void *obj;
-	uint32_t id;
-};
-
-TAILQ_HEAD(port_out_tailq, port_out);
-
-struct port_out_runtime {
-	rte_swx_port_out_pkt_tx_t pkt_tx;
-	rte_swx_port_out_flush_t flush;
-	void *obj;
-};
-
-/*
- * Extern object.
- */
-struct extern_type_member_func {
-	TAILQ_ENTRY(extern_type_member_func) node;
-	char name[RTE_SWX_NAME_SIZE];
-	rte_swx_extern_type_member_func_t func;
-	uint32_t id;
-};
-
-TAILQ_HEAD(extern_type_member_func_tailq, extern_type_member_func);
-
-struct extern_type {
-	TAILQ_ENTRY(extern_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct struct_type *mailbox_struct_type;
-	rte_swx_extern_type_constructor_t constructor;
-	rte_swx_extern_type_destructor_t destructor;
-	struct extern_type_member_func_tailq funcs;
-	uint32_t n_funcs;
-};
-
-TAILQ_HEAD(extern_type_tailq, extern_type);
-
-struct extern_obj {
-	TAILQ_ENTRY(extern_obj) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct extern_type *type;
-	void *obj;
-	uint32_t struct_id;
-	uint32_t id;
-};
-
-TAILQ_HEAD(extern_obj_tailq, extern_obj);
-
-#ifndef RTE_SWX_EXTERN_TYPE_MEMBER_FUNCS_MAX
-#define RTE_SWX_EXTERN_TYPE_MEMBER_FUNCS_MAX 8
-#endif
-
-struct extern_obj_runtime {
-	void *obj;
-	uint8_t *mailbox;
-	rte_swx_extern_type_member_func_t funcs[RTE_SWX_EXTERN_TYPE_MEMBER_FUNCS_MAX];
-};
-
-/*
- * Extern function.
- */
-struct extern_func {
-	TAILQ_ENTRY(extern_func) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct struct_type *mailbox_struct_type;
-	rte_swx_extern_func_t func;
-	uint32_t struct_id;
-	uint32_t id;
-};
-
-TAILQ_HEAD(extern_func_tailq, extern_func);
-
-struct extern_func_runtime {
-	uint8_t *mailbox;
-	rte_swx_extern_func_t func;
-};
-
-/*
- * Header.
- */
-struct header {
-	TAILQ_ENTRY(header) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct struct_type *st;
-	uint32_t struct_id;
-	uint32_t id;
-};
-
-TAILQ_HEAD(header_tailq, header);
-
-struct header_runtime {
-	uint8_t *ptr0;
-};
-
-struct header_out_runtime {
-	uint8_t *ptr0;
-	uint8_t *ptr;
-	uint32_t n_bytes;
-};
-
-/*
- * Instruction.
- */
-
-/* Packet headers are always in Network Byte Order (NBO), i.e. big endian.
- * Packet meta-data fields are always assumed to be in Host Byte Order (HBO).
- * Table entry fields can be in either NBO or HBO; they are assumed to be in HBO
- * when transferred to packet meta-data and in NBO when transferred to packet
- * headers.
- */
-
-/* Notation conventions:
- *    -Header field: H = h.header.field (dst/src)
- *    -Meta-data field: M = m.field (dst/src)
- *    -Extern object mailbox field: E = e.field (dst/src)
- *    -Extern function mailbox field: F = f.field (dst/src)
- *    -Table action data field: T = t.field (src only)
- *    -Immediate value: I = 32-bit unsigned value (src only)
- */
-
-enum instruction_type {
-	/* rx m.port_in */
-	INSTR_RX,
-
-	/* tx port_out
-	 * port_out = MI
-	 */
-	INSTR_TX,   /* port_out = M */
-	INSTR_TX_I, /* port_out = I */
-
-	/* extract h.header */
-	INSTR_HDR_EXTRACT,
-	INSTR_HDR_EXTRACT2,
-	INSTR_HDR_EXTRACT3,
-	INSTR_HDR_EXTRACT4,
-	INSTR_HDR_EXTRACT5,
-	INSTR_HDR_EXTRACT6,
-	INSTR_HDR_EXTRACT7,
-	INSTR_HDR_EXTRACT8,
-
-	/* emit h.header */
-	INSTR_HDR_EMIT,
-	INSTR_HDR_EMIT_TX,
-	INSTR_HDR_EMIT2_TX,
-	INSTR_HDR_EMIT3_TX,
-	INSTR_HDR_EMIT4_TX,
-	INSTR_HDR_EMIT5_TX,
-	INSTR_HDR_EMIT6_TX,
-	INSTR_HDR_EMIT7_TX,
-	INSTR_HDR_EMIT8_TX,
-
-	/* validate h.header */
-	INSTR_HDR_VALIDATE,
-
-	/* invalidate h.header */
-	INSTR_HDR_INVALIDATE,
-
-	/* mov dst src
-	 * dst = src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_MOV,    /* dst = MEF, src = MEFT */
-	INSTR_MOV_MH, /* dst = MEF, src = H */
-	INSTR_MOV_HM, /* dst = H, src = MEFT */
-	INSTR_MOV_HH, /* dst = H, src = H */
-	INSTR_MOV_I,  /* dst = HMEF, src = I */
-
-	/* dma h.header t.field
-	 * memcpy(h.header, t.field, sizeof(h.header))
-	 */
-	INSTR_DMA_HT,
-	INSTR_DMA_HT2,
-	INSTR_DMA_HT3,
-	INSTR_DMA_HT4,
-	INSTR_DMA_HT5,
-	INSTR_DMA_HT6,
-	INSTR_DMA_HT7,
-	INSTR_DMA_HT8,
-
-	/* add dst src
-	 * dst += src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_ADD,    /* dst = MEF, src = MEF */
-	INSTR_ALU_ADD_MH, /* dst = MEF, src = H */
-	INSTR_ALU_ADD_HM, /* dst = H, src = MEF */
-	INSTR_ALU_ADD_HH, /* dst = H, src = H */
-	INSTR_ALU_ADD_MI, /* dst = MEF, src = I */
-	INSTR_ALU_ADD_HI, /* dst = H, src = I */
-
-	/* sub dst src
-	 * dst -= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_SUB,    /* dst = MEF, src = MEF */
-	INSTR_ALU_SUB_MH, /* dst = MEF, src = H */
-	INSTR_ALU_SUB_HM, /* dst = H, src = MEF */
-	INSTR_ALU_SUB_HH, /* dst = H, src = H */
-	INSTR_ALU_SUB_MI, /* dst = MEF, src = I */
-	INSTR_ALU_SUB_HI, /* dst = H, src = I */
-
-	/* ckadd dst src
-	 * dst = dst '+ src[0:1] '+ src[2:3] + ...
-	 * dst = H, src = {H, h.header}
-	 */
-	INSTR_ALU_CKADD_FIELD,    /* src = H */
-	INSTR_ALU_CKADD_STRUCT20, /* src = h.header, with sizeof(header) = 20 */
-	INSTR_ALU_CKADD_STRUCT,   /* src = h.hdeader, with any sizeof(header) */
-
-	/* cksub dst src
-	 * dst = dst '- src
-	 * dst = H, src = H
-	 */
-	INSTR_ALU_CKSUB_FIELD,
-
-	/* and dst src
-	 * dst &= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_AND,    /* dst = MEF, src = MEFT */
-	INSTR_ALU_AND_MH, /* dst = MEF, src = H */
-	INSTR_ALU_AND_HM, /* dst = H, src = MEFT */
-	INSTR_ALU_AND_HH, /* dst = H, src = H */
-	INSTR_ALU_AND_I,  /* dst = HMEF, src = I */
-
-	/* or dst src
-	 * dst |= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_OR,    /* dst = MEF, src = MEFT */
-	INSTR_ALU_OR_MH, /* dst = MEF, src = H */
-	INSTR_ALU_OR_HM, /* dst = H, src = MEFT */
-	INSTR_ALU_OR_HH, /* dst = H, src = H */
-	INSTR_ALU_OR_I,  /* dst = HMEF, src = I */
-
-	/* xor dst src
-	 * dst ^= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_XOR,    /* dst = MEF, src = MEFT */
-	INSTR_ALU_XOR_MH, /* dst = MEF, src = H */
-	INSTR_ALU_XOR_HM, /* dst = H, src = MEFT */
-	INSTR_ALU_XOR_HH, /* dst = H, src = H */
-	INSTR_ALU_XOR_I,  /* dst = HMEF, src = I */
-
-	/* shl dst src
-	 * dst <<= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_SHL,    /* dst = MEF, src = MEF */
-	INSTR_ALU_SHL_MH, /* dst = MEF, src = H */
-	INSTR_ALU_SHL_HM, /* dst = H, src = MEF */
-	INSTR_ALU_SHL_HH, /* dst = H, src = H */
-	INSTR_ALU_SHL_MI, /* dst = MEF, src = I */
-	INSTR_ALU_SHL_HI, /* dst = H, src = I */
-
-	/* shr dst src
-	 * dst >>= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_SHR,    /* dst = MEF, src = MEF */
-	INSTR_ALU_SHR_MH, /* dst = MEF, src = H */
-	INSTR_ALU_SHR_HM, /* dst = H, src = MEF */
-	INSTR_ALU_SHR_HH, /* dst = H, src = H */
-	INSTR_ALU_SHR_MI, /* dst = MEF, src = I */
-	INSTR_ALU_SHR_HI, /* dst = H, src = I */
-
-	/* regprefetch REGARRAY index
-	 * prefetch REGARRAY[index]
-	 * index = HMEFTI
-	 */
-	INSTR_REGPREFETCH_RH, /* index = H */
-	INSTR_REGPREFETCH_RM, /* index = MEFT */
-	INSTR_REGPREFETCH_RI, /* index = I */
-
-	/* regrd dst REGARRAY index
-	 * dst = REGARRAY[index]
-	 * dst = HMEF, index = HMEFTI
-	 */
-	INSTR_REGRD_HRH, /* dst = H, index = H */
-	INSTR_REGRD_HRM, /* dst = H, index = MEFT */
-	INSTR_REGRD_HRI, /* dst = H, index = I */
-	INSTR_REGRD_MRH, /* dst = MEF, index = H */
-	INSTR_REGRD_MRM, /* dst = MEF, index = MEFT */
-	INSTR_REGRD_MRI, /* dst = MEF, index = I */
-
-	/* regwr REGARRAY index src
-	 * REGARRAY[index] = src
-	 * index = HMEFTI, src = HMEFTI
-	 */
-	INSTR_REGWR_RHH, /* index = H, src = H */
-	INSTR_REGWR_RHM, /* index = H, src = MEFT */
-	INSTR_REGWR_RHI, /* index = H, src = I */
-	INSTR_REGWR_RMH, /* index = MEFT, src = H */
-	INSTR_REGWR_RMM, /* index = MEFT, src = MEFT */
-	INSTR_REGWR_RMI, /* index = MEFT, src = I */
-	INSTR_REGWR_RIH, /* index = I, src = H */
-	INSTR_REGWR_RIM, /* index = I, src = MEFT */
-	INSTR_REGWR_RII, /* index = I, src = I */
-
-	/* regadd REGARRAY index src
-	 * REGARRAY[index] += src
-	 * index = HMEFTI, src = HMEFTI
-	 */
-	INSTR_REGADD_RHH, /* index = H, src = H */
-	INSTR_REGADD_RHM, /* index = H, src = MEFT */
-	INSTR_REGADD_RHI, /* index = H, src = I */
-	INSTR_REGADD_RMH, /* index = MEFT, src = H */
-	INSTR_REGADD_RMM, /* index = MEFT, src = MEFT */
-	INSTR_REGADD_RMI, /* index = MEFT, src = I */
-	INSTR_REGADD_RIH, /* index = I, src = H */
-	INSTR_REGADD_RIM, /* index = I, src = MEFT */
-	INSTR_REGADD_RII, /* index = I, src = I */
-
-	/* metprefetch METARRAY index
-	 * prefetch METARRAY[index]
-	 * index = HMEFTI
-	 */
-	INSTR_METPREFETCH_H, /* index = H */
-	INSTR_METPREFETCH_M, /* index = MEFT */
-	INSTR_METPREFETCH_I, /* index = I */
-
-	/* meter METARRAY index length color_in color_out
-	 * color_out = meter(METARRAY[index], length, color_in)
-	 * index = HMEFTI, length = HMEFT, color_in = MEFTI, color_out = MEF
-	 */
-	INSTR_METER_HHM, /* index = H, length = H, color_in = MEFT */
-	INSTR_METER_HHI, /* index = H, length = H, color_in = I */
-	INSTR_METER_HMM, /* index = H, length = MEFT, color_in = MEFT */
-	INSTR_METER_HMI, /* index = H, length = MEFT, color_in = I */
-	INSTR_METER_MHM, /* index = MEFT, length = H, color_in = MEFT */
-	INSTR_METER_MHI, /* index = MEFT, length = H, color_in = I */
-	INSTR_METER_MMM, /* index = MEFT, length = MEFT, color_in = MEFT */
-	INSTR_METER_MMI, /* index = MEFT, length = MEFT, color_in = I */
-	INSTR_METER_IHM, /* index = I, length = H, color_in = MEFT */
-	INSTR_METER_IHI, /* index = I, length = H, color_in = I */
-	INSTR_METER_IMM, /* index = I, length = MEFT, color_in = MEFT */
-	INSTR_METER_IMI, /* index = I, length = MEFT, color_in = I */
-
-	/* table TABLE */
-	INSTR_TABLE,
-
-	/* extern e.obj.func */
-	INSTR_EXTERN_OBJ,
-
-	/* extern f.func */
-	INSTR_EXTERN_FUNC,
-
-	/* jmp LABEL
-	 * Unconditional jump
-	 */
-	INSTR_JMP,
-
-	/* jmpv LABEL h.header
-	 * Jump if header is valid
-	 */
-	INSTR_JMP_VALID,
-
-	/* jmpnv LABEL h.header
-	 * Jump if header is invalid
-	 */
-	INSTR_JMP_INVALID,
-
-	/* jmph LABEL
-	 * Jump if table lookup hit
-	 */
-	INSTR_JMP_HIT,
-
-	/* jmpnh LABEL
-	 * Jump if table lookup miss
-	 */
-	INSTR_JMP_MISS,
-
-	/* jmpa LABEL ACTION
-	 * Jump if action run
-	 */
-	INSTR_JMP_ACTION_HIT,
-
-	/* jmpna LABEL ACTION
-	 * Jump if action not run
-	 */
-	INSTR_JMP_ACTION_MISS,
-
-	/* jmpeq LABEL a b
-	 * Jump if a is equal to b
-	 * a = HMEFT, b = HMEFTI
-	 */
-	INSTR_JMP_EQ,    /* a = MEFT, b = MEFT */
-	INSTR_JMP_EQ_MH, /* a = MEFT, b = H */
-	INSTR_JMP_EQ_HM, /* a = H, b = MEFT */
-	INSTR_JMP_EQ_HH, /* a = H, b = H */
-	INSTR_JMP_EQ_I,  /* (a, b) = (MEFT, I) or (a, b) = (H, I) */
-
-	/* jmpneq LABEL a b
-	 * Jump if a is not equal to b
-	 * a = HMEFT, b = HMEFTI
-	 */
-	INSTR_JMP_NEQ,    /* a = MEFT, b = MEFT */
-	INSTR_JMP_NEQ_MH, /* a = MEFT, b = H */
-	INSTR_JMP_NEQ_HM, /* a = H, b = MEFT */
-	INSTR_JMP_NEQ_HH, /* a = H, b = H */
-	INSTR_JMP_NEQ_I,  /* (a, b) = (MEFT, I) or (a, b) = (H, I) */
-
-	/* jmplt LABEL a b
-	 * Jump if a is less than b
-	 * a = HMEFT, b = HMEFTI
-	 */
-	INSTR_JMP_LT,    /* a = MEFT, b = MEFT */
-	INSTR_JMP_LT_MH, /* a = MEFT, b = H */
-	INSTR_JMP_LT_HM, /* a = H, b = MEFT */
-	INSTR_JMP_LT_HH, /* a = H, b = H */
-	INSTR_JMP_LT_MI, /* a = MEFT, b = I */
-	INSTR_JMP_LT_HI, /* a = H, b = I */
-
-	/* jmpgt LABEL a b
-	 * Jump if a is greater than b
-	 * a = HMEFT, b = HMEFTI
-	 */
-	INSTR_JMP_GT,    /* a = MEFT, b = MEFT */
-	INSTR_JMP_GT_MH, /* a = MEFT, b = H */
-	INSTR_JMP_GT_HM, /* a = H, b = MEFT */
-	INSTR_JMP_GT_HH, /* a = H, b = H */
-	INSTR_JMP_GT_MI, /* a = MEFT, b = I */
-	INSTR_JMP_GT_HI, /* a = H, b = I */
-
-	/* return
-	 * Return from action
-	 */
-	INSTR_RETURN,
-};
-
-struct instr_operand {
-	uint8_t struct_id;
-	uint8_t n_bits;
-	uint8_t offset;
-	uint8_t pad;
-};
-
-struct instr_io {
-	struct {
-		union {
-			struct {
-				uint8_t offset;
-				uint8_t n_bits;
-				uint8_t pad[2];
-			};
-
-			uint32_t val;
-		};
-	} io;
-
-	struct {
-		uint8_t header_id[8];
-		uint8_t struct_id[8];
-		uint8_t n_bytes[8];
-	} hdr;
-};
-
-struct instr_hdr_validity {
-	uint8_t header_id;
-};
-
-struct instr_table {
-	uint8_t table_id;
-};
-
-struct instr_extern_obj {
-	uint8_t ext_obj_id;
-	uint8_t func_id;
-};
-
-struct instr_extern_func {
-	uint8_t ext_func_id;
-};
-
-struct instr_dst_src {
-	struct instr_operand dst;
-	union {
-		struct instr_operand src;
-		uint64_t src_val;
-	};
-};
-
-struct instr_regarray {
-	uint8_t regarray_id;
-	uint8_t pad[3];
-
-	union {
-		struct instr_operand idx;
-		uint32_t idx_val;
-	};
-
-	union {
-		struct instr_operand dstsrc;
-		uint64_t dstsrc_val;
-	};
-};
-
-struct instr_meter {
-	uint8_t metarray_id;
-	uint8_t pad[3];
-
-	union {
-		struct instr_operand idx;
-		uint32_t idx_val;
-	};
-
-	struct instr_operand length;
-
-	union {
-		struct instr_operand color_in;
-		uint32_t color_in_val;
-	};
-
-	struct instr_operand color_out;
-};
-
-struct instr_dma {
-	struct {
-		uint8_t header_id[8];
-		uint8_t struct_id[8];
-	} dst;
-
-	struct {
-		uint8_t offset[8];
-	} src;
-
-	uint16_t n_bytes[8];
-};
-
-struct instr_jmp {
-	struct instruction *ip;
-
-	union {
-		struct instr_operand a;
-		uint8_t header_id;
-		uint8_t action_id;
-	};
-
-	union {
-		struct instr_operand b;
-		uint64_t b_val;
-	};
-};
-
-struct instruction {
-	enum instruction_type type;
-	union {
-		struct instr_io io;
-		struct instr_hdr_validity valid;
-		struct instr_dst_src mov;
-		struct instr_regarray regarray;
-		struct instr_meter meter;
-		struct instr_dma dma;
-		struct instr_dst_src alu;
-		struct instr_table table;
-		struct instr_extern_obj ext_obj;
-		struct instr_extern_func ext_func;
-		struct instr_jmp jmp;
-	};
-};
-
-struct instruction_data {
-	char label[RTE_SWX_NAME_SIZE];
-	char jmp_label[RTE_SWX_NAME_SIZE];
-	uint32_t n_users; /* user = jmp instruction to this instruction. */
-	int invalid;
-};
-
-/*
- * Action.
- */
-struct action {
-	TAILQ_ENTRY(action) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct struct_type *st;
-	int *args_endianness; /* 0 = Host Byte Order (HBO). */
-	struct instruction *instructions;
-	uint32_t n_instructions;
-	uint32_t id;
-};
-
-TAILQ_HEAD(action_tailq, action);
-
-/*
- * Table.
- */
-struct table_type {
-	TAILQ_ENTRY(table_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	enum rte_swx_table_match_type match_type;
-	struct rte_swx_table_ops ops;
-};
-
-TAILQ_HEAD(table_type_tailq, table_type);
-
-struct match_field {
-	enum rte_swx_table_match_type match_type;
-	struct field *field;
-};
-
-struct table {
-	TAILQ_ENTRY(table) node;
-	char name[RTE_SWX_NAME_SIZE];
-	char args[RTE_SWX_NAME_SIZE];
-	struct table_type *type; /* NULL when n_fields == 0. */
-
-	/* Match. */
-	struct match_field *fields;
-	uint32_t n_fields;
-	struct header *header; /* Only valid when n_fields > 0. */
-
-	/* Action. */
-	struct action **actions;
-	struct action *default_action;
-	uint8_t *default_action_data;
-	uint32_t n_actions;
-	int default_action_is_const;
-	uint32_t action_data_size_max;
-
-	uint32_t size;
-	uint32_t id;
-};
-
-TAILQ_HEAD(table_tailq, table);
-
-struct table_runtime {
-	rte_swx_table_lookup_t func;
-	void *mailbox;
-	uint8_t **key;
-};
-
-struct table_statistics {
-	uint64_t n_pkts_hit[2]; /* 0 = Miss, 1 = Hit. */
-	uint64_t *n_pkts_action;
-};
-
-/*
- * Register array.
- */
-struct regarray {
-	TAILQ_ENTRY(regarray) node;
-	char name[RTE_SWX_NAME_SIZE];
-	uint64_t init_val;
-	uint32_t size;
-	uint32_t id;
-};
-
-TAILQ_HEAD(regarray_tailq, regarray);
-
-struct regarray_runtime {
-	uint64_t *regarray;
-	uint32_t size_mask;
-};
-
-/*
- * Meter array.
- */
-struct meter_profile {
-	TAILQ_ENTRY(meter_profile) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct rte_meter_trtcm_params params;
-	struct rte_meter_trtcm_profile profile;
-	uint32_t n_users;
-};
-
-TAILQ_HEAD(meter_profile_tailq, meter_profile);
-
-struct metarray {
-	TAILQ_ENTRY(metarray) node;
-	char name[RTE_SWX_NAME_SIZE];
-	uint32_t size;
-	uint32_t id;
-};
-
-TAILQ_HEAD(metarray_tailq, metarray);
-
-struct meter {
-	struct rte_meter_trtcm m;
-	struct meter_profile *profile;
-	enum rte_color color_mask;
-	uint8_t pad[20];
-
-	uint64_t n_pkts[RTE_COLORS];
-	uint64_t n_bytes[RTE_COLORS];
-};
-
-struct metarray_runtime {
-	struct meter *metarray;
-	uint32_t size_mask;
-};
-
-/*
- * Pipeline.
- */
-struct thread {
-	/* Packet. */
-	struct rte_swx_pkt pkt;
-	uint8_t *ptr;
-
-	/* Structures. */
-	uint8_t **structs;
-
-	/* Packet headers. */
-	struct header_runtime *headers; /* Extracted or generated headers. */
-	struct header_out_runtime *headers_out; /* Emitted headers. */
-	uint8_t *header_storage;
-	uint8_t *header_out_storage;
-	uint64_t valid_headers;
-	uint32_t n_headers_out;
-
-	/* Packet meta-data. */
-	uint8_t *metadata;
-
-	/* Tables. */
-	struct table_runtime *tables;
-	struct rte_swx_table_state *table_state;
-	uint64_t action_id;
-	int hit; /* 0 = Miss, 1 = Hit. */
-
-	/* Extern objects and functions. */
-	struct extern_obj_runtime *extern_objs;
-	struct extern_func_runtime *extern_funcs;
-
-	/* Instructions. */
-	struct instruction *ip;
-	struct instruction *ret;
-};
-
-#define MASK64_BIT_GET(mask, pos) ((mask) & (1LLU << (pos)))
-#define MASK64_BIT_SET(mask, pos) ((mask) | (1LLU << (pos)))
-#define MASK64_BIT_CLR(mask, pos) ((mask) & ~(1LLU << (pos)))
-
-#define HEADER_VALID(thread, header_id) \
-	MASK64_BIT_GET((thread)->valid_headers, header_id)
-
-#define ALU(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = dst64 & dst64_mask;                                     \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->alu.src.n_bits);       \
-	uint64_t src = src64 & src64_mask;                                     \
-									       \
-	uint64_t result = dst operator src;                                    \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (result & dst64_mask);            \
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define ALU_MH(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = dst64 & dst64_mask;                                     \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src = ntoh64(src64) >> (64 - (ip)->alu.src.n_bits);           \
-									       \
-	uint64_t result = dst operator src;                                    \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (result & dst64_mask);            \
-}
-
-#define ALU_HM(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = ntoh64(dst64) >> (64 - (ip)->alu.dst.n_bits);           \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->alu.src.n_bits);       \
-	uint64_t src = src64 & src64_mask;                                     \
-									       \
-	uint64_t result = dst operator src;                                    \
-	result = hton64(result << (64 - (ip)->alu.dst.n_bits));                \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                           \
-}
-
-#define ALU_HM_FAST(thread, ip, operator)  \
-{                                                                                 \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];         \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];      \
-	uint64_t dst64 = *dst64_ptr;                                              \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);          \
-	uint64_t dst = dst64 & dst64_mask;                                        \
-										  \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];         \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];      \
-	uint64_t src64 = *src64_ptr;                                              \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->alu.src.n_bits);          \
-	uint64_t src = hton64(src64 & src64_mask) >> (64 - (ip)->alu.dst.n_bits); \
-										  \
-	uint64_t result = dst operator src;                                       \
-										  \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                              \
-}
-
-#define ALU_HH(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = ntoh64(dst64) >> (64 - (ip)->alu.dst.n_bits);           \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src = ntoh64(src64) >> (64 - (ip)->alu.src.n_bits);           \
-									       \
-	uint64_t result = dst operator src;                                    \
-	result = hton64(result << (64 - (ip)->alu.dst.n_bits));                \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                           \
-}
-
-#define ALU_HH_FAST(thread, ip, operator)  \
-{                                                                                             \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];                     \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];                  \
-	uint64_t dst64 = *dst64_ptr;                                                          \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);                      \
-	uint64_t dst = dst64 & dst64_mask;                                                    \
-											      \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];                     \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];                  \
-	uint64_t src64 = *src64_ptr;                                                          \
-	uint64_t src = (src64 << (64 - (ip)->alu.src.n_bits)) >> (64 - (ip)->alu.dst.n_bits); \
-											      \
-	uint64_t result = dst operator src;                                                   \
-											      \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                                          \
-}
-
-#else
-
-#define ALU_MH ALU
-#define ALU_HM ALU
-#define ALU_HM_FAST ALU
-#define ALU_HH ALU
-#define ALU_HH_FAST ALU
-
-#endif
-
-#define ALU_I(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = dst64 & dst64_mask;                                     \
-									       \
-	uint64_t src = (ip)->alu.src_val;                                      \
-									       \
-	uint64_t result = dst operator src;                                    \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (result & dst64_mask);            \
-}
-
-#define ALU_MI ALU_I
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define ALU_HI(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = ntoh64(dst64) >> (64 - (ip)->alu.dst.n_bits);           \
-									       \
-	uint64_t src = (ip)->alu.src_val;                                      \
-									       \
-	uint64_t result = dst operator src;                                    \
-	result = hton64(result << (64 - (ip)->alu.dst.n_bits));                \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                           \
-}
-
-#else
-
-#define ALU_HI ALU_I
-
-#endif
-
-#define MOV(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->mov.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->mov.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->mov.src.n_bits);       \
-	uint64_t src = src64 & src64_mask;                                     \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);               \
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define MOV_MH(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->mov.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->mov.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src = ntoh64(src64) >> (64 - (ip)->mov.src.n_bits);           \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);               \
-}
-
-#define MOV_HM(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->mov.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->mov.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->mov.src.n_bits);       \
-	uint64_t src = src64 & src64_mask;                                     \
-									       \
-	src = hton64(src) >> (64 - (ip)->mov.dst.n_bits);                      \
-	*dst64_ptr = (dst64 & ~dst64_mask) | src;                              \
-}
-
-#define MOV_HH(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->mov.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->mov.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-									       \
-	uint64_t src = src64 << (64 - (ip)->mov.src.n_bits);                   \
-	src = src >> (64 - (ip)->mov.dst.n_bits);                              \
-	*dst64_ptr = (dst64 & ~dst64_mask) | src;                              \
-}
-
-#else
-
-#define MOV_MH MOV
-#define MOV_HM MOV
-#define MOV_HH MOV
-
-#endif
-
-#define MOV_I(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint64_t src = (ip)->mov.src_val;                                      \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);               \
-}
-
-#define JMP_CMP(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a64_mask = UINT64_MAX >> (64 - (ip)->jmp.a.n_bits);           \
-	uint64_t a = a64 & a64_mask;                                           \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b64_mask = UINT64_MAX >> (64 - (ip)->jmp.b.n_bits);           \
-	uint64_t b = b64 & b64_mask;                                           \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define JMP_CMP_MH(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a64_mask = UINT64_MAX >> (64 - (ip)->jmp.a.n_bits);           \
-	uint64_t a = a64 & a64_mask;                                           \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b = ntoh64(b64) >> (64 - (ip)->jmp.b.n_bits);                 \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#define JMP_CMP_HM(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a = ntoh64(a64) >> (64 - (ip)->jmp.a.n_bits);                 \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b64_mask = UINT64_MAX >> (64 - (ip)->jmp.b.n_bits);           \
-	uint64_t b = b64 & b64_mask;                                           \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#define JMP_CMP_HH(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a = ntoh64(a64) >> (64 - (ip)->jmp.a.n_bits);                 \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b = ntoh64(b64) >> (64 - (ip)->jmp.b.n_bits);                 \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#define JMP_CMP_HH_FAST(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a = a64 << (64 - (ip)->jmp.a.n_bits);                         \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b = b64 << (64 - (ip)->jmp.b.n_bits);                         \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#else
-
-#define JMP_CMP_MH JMP_CMP
-#define JMP_CMP_HM JMP_CMP
-#define JMP_CMP_HH JMP_CMP
-#define JMP_CMP_HH_FAST JMP_CMP
-
-#endif
-
-#define JMP_CMP_I(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a64_mask = UINT64_MAX >> (64 - (ip)->jmp.a.n_bits);           \
-	uint64_t a = a64 & a64_mask;                                           \
-									       \
-	uint64_t b = (ip)->jmp.b_val;                                          \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#define JMP_CMP_MI JMP_CMP_I
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define JMP_CMP_HI(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a = ntoh64(a64) >> (64 - (ip)->jmp.a.n_bits);                 \
-									       \
-	uint64_t b = (ip)->jmp.b_val;                                          \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#else
-
-#define JMP_CMP_HI JMP_CMP_I
-
-#endif
-
-#define METADATA_READ(thread, offset, n_bits)                                  \
-({                                                                             \
-	uint64_t *m64_ptr = (uint64_t *)&(thread)->metadata[offset];           \
-	uint64_t m64 = *m64_ptr;                                               \
-	uint64_t m64_mask = UINT64_MAX >> (64 - (n_bits));                     \
-	(m64 & m64_mask);                                                      \
-})
-
-#define METADATA_WRITE(thread, offset, n_bits, value)                          \
-{                                                                              \
-	uint64_t *m64_ptr = (uint64_t *)&(thread)->metadata[offset];           \
-	uint64_t m64 = *m64_ptr;                                               \
-	uint64_t m64_mask = UINT64_MAX >> (64 - (n_bits));                     \
-									       \
-	uint64_t m_new = value;                                                \
-									       \
-	*m64_ptr = (m64 & ~m64_mask) | (m_new & m64_mask);                     \
-}
-
-#ifndef RTE_SWX_PIPELINE_THREADS_MAX
-#define RTE_SWX_PIPELINE_THREADS_MAX 16
-#endif
-
-struct rte_swx_pipeline {
-	struct struct_type_tailq struct_types;
-	struct port_in_type_tailq port_in_types;
-	struct port_in_tailq ports_in;
-	struct port_out_type_tailq port_out_types;
-	struct port_out_tailq ports_out;
-	struct extern_type_tailq extern_types;
-	struct extern_obj_tailq extern_objs;
-	struct extern_func_tailq extern_funcs;
-	struct header_tailq headers;
-	struct struct_type *metadata_st;
-	uint32_t metadata_struct_id;
-	struct action_tailq actions;
-	struct table_type_tailq table_types;
-	struct table_tailq tables;
-	struct regarray_tailq regarrays;
-	struct meter_profile_tailq meter_profiles;
-	struct metarray_tailq metarrays;
-
-	struct port_in_runtime *in;
-	struct port_out_runtime *out;
-	struct instruction **action_instructions;
-	struct rte_swx_table_state *table_state;
-	struct table_statistics *table_stats;
-	struct regarray_runtime *regarray_runtime;
-	struct metarray_runtime *metarray_runtime;
-	struct instruction *instructions;
-	struct thread threads[RTE_SWX_PIPELINE_THREADS_MAX];
-
-	uint32_t n_structs;
-	uint32_t n_ports_in;
-	uint32_t n_ports_out;
-	uint32_t n_extern_objs;
-	uint32_t n_extern_funcs;
-	uint32_t n_actions;
-	uint32_t n_tables;
-	uint32_t n_regarrays;
-	uint32_t n_metarrays;
-	uint32_t n_headers;
-	uint32_t thread_id;
-	uint32_t port_id;
-	uint32_t n_instructions;
-	int build_done;
-	int numa_node;
-};
-
 /*
  * Struct.
  */
@@ -2765,7 +1518,17 @@ thread_ip_action_call(struct rte_swx_pipeline *p,
 		      struct thread *t,
 		      uint32_t action_id)
 {
+	action_func_t action_func = p->action_funcs[action_id];
+
 	t->ret = t->ip + 1;
+
+	/* Actions available as native code run to completion in one go. */
+	if (action_func) {
+		action_func(p);
+		t->ip = t->ret;
+		return;
+	}
+
 	t->ip = p->action_instructions[action_id];
 }
 
@@ -3394,12 +2157,8 @@ instr_hdr_validate_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint32_t header_id = ip->valid.header_id;
-
-	TRACE("[Thread %2u] validate header %u\n", p->thread_id, header_id);
 
-	/* Headers. */
-	t->valid_headers = MASK64_BIT_SET(t->valid_headers, header_id);
+	__instr_hdr_validate_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3433,12 +2192,8 @@ instr_hdr_invalidate_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint32_t header_id = ip->valid.header_id;
-
-	TRACE("[Thread %2u] invalidate header %u\n", p->thread_id, header_id);
 
-	/* Headers. */
-	t->valid_headers = MASK64_BIT_CLR(t->valid_headers, header_id);
+	__instr_hdr_invalidate_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3672,10 +2427,7 @@ instr_mov_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov\n",
-	      p->thread_id);
-
-	MOV(t, ip);
+	__instr_mov_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3687,10 +2439,7 @@ instr_mov_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov (mh)\n",
-	      p->thread_id);
-
-	MOV_MH(t, ip);
+	__instr_mov_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3702,10 +2451,7 @@ instr_mov_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov (hm)\n",
-	      p->thread_id);
-
-	MOV_HM(t, ip);
+	__instr_mov_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3717,10 +2463,7 @@ instr_mov_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov (hh)\n",
-	      p->thread_id);
-
-	MOV_HH(t, ip);
+	__instr_mov_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3732,11 +2475,7 @@ instr_mov_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov m.f %" PRIx64 "\n",
-	      p->thread_id,
-	      ip->mov.src_val);
-
-	MOV_I(t, ip);
+	__instr_mov_i_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3744,48 +2483,14 @@ instr_mov_i_exec(struct rte_swx_pipeline *p)
 
 /*
  * dma.
- */
-static inline void
-__instr_dma_ht_exec(struct rte_swx_pipeline *p, uint32_t n_dma);
-
-static inline void
-__instr_dma_ht_exec(struct rte_swx_pipeline *p, uint32_t n_dma)
-{
-	struct thread *t = &p->threads[p->thread_id];
-	struct instruction *ip = t->ip;
-	uint8_t *action_data = t->structs[0];
-	uint64_t valid_headers = t->valid_headers;
-	uint32_t i;
-
-	for (i = 0; i < n_dma; i++) {
-		uint32_t header_id = ip->dma.dst.header_id[i];
-		uint32_t struct_id = ip->dma.dst.struct_id[i];
-		uint32_t offset = ip->dma.src.offset[i];
-		uint32_t n_bytes = ip->dma.n_bytes[i];
-
-		struct header_runtime *h = &t->headers[header_id];
-		uint8_t *h_ptr0 = h->ptr0;
-		uint8_t *h_ptr = t->structs[struct_id];
-
-		void *dst = MASK64_BIT_GET(valid_headers, header_id) ?
-			h_ptr : h_ptr0;
-		void *src = &action_data[offset];
-
-		TRACE("[Thread %2u] dma h.s t.f\n", p->thread_id);
-
-		/* Headers. */
-		memcpy(dst, src, n_bytes);
-		t->structs[struct_id] = dst;
-		valid_headers = MASK64_BIT_SET(valid_headers, header_id);
-	}
-
-	t->valid_headers = valid_headers;
-}
-
+ */
 static inline void
 instr_dma_ht_exec(struct rte_swx_pipeline *p)
 {
-	__instr_dma_ht_exec(p, 1);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
+	__instr_dma_ht_exec(p, t, ip, 1);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3794,10 +2499,13 @@ instr_dma_ht_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht2_exec(struct rte_swx_pipeline *p)
 {
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
 	TRACE("[Thread %2u] *** The next 2 instructions are fused. ***\n",
 	      p->thread_id);
 
-	__instr_dma_ht_exec(p, 2);
+	__instr_dma_ht_exec(p, t, ip, 2);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3806,10 +2514,13 @@ instr_dma_ht2_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht3_exec(struct rte_swx_pipeline *p)
 {
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
 	TRACE("[Thread %2u] *** The next 3 instructions are fused. ***\n",
 	      p->thread_id);
 
-	__instr_dma_ht_exec(p, 3);
+	__instr_dma_ht_exec(p, t, ip, 3);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3818,10 +2529,13 @@ instr_dma_ht3_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht4_exec(struct rte_swx_pipeline *p)
 {
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
 	TRACE("[Thread %2u] *** The next 4 instructions are fused. ***\n",
 	      p->thread_id);
 
-	__instr_dma_ht_exec(p, 4);
+	__instr_dma_ht_exec(p, t, ip, 4);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3830,10 +2544,13 @@ instr_dma_ht4_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht5_exec(struct rte_swx_pipeline *p)
 {
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
 	TRACE("[Thread %2u] *** The next 5 instructions are fused. ***\n",
 	      p->thread_id);
 
-	__instr_dma_ht_exec(p, 5);
+	__instr_dma_ht_exec(p, t, ip, 5);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3842,10 +2559,13 @@ instr_dma_ht5_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht6_exec(struct rte_swx_pipeline *p)
 {
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
 	TRACE("[Thread %2u] *** The next 6 instructions are fused. ***\n",
 	      p->thread_id);
 
-	__instr_dma_ht_exec(p, 6);
+	__instr_dma_ht_exec(p, t, ip, 6);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3854,10 +2574,13 @@ instr_dma_ht6_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht7_exec(struct rte_swx_pipeline *p)
 {
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
 	TRACE("[Thread %2u] *** The next 7 instructions are fused. ***\n",
 	      p->thread_id);
 
-	__instr_dma_ht_exec(p, 7);
+	__instr_dma_ht_exec(p, t, ip, 7);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3866,10 +2589,13 @@ instr_dma_ht7_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht8_exec(struct rte_swx_pipeline *p)
 {
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
 	TRACE("[Thread %2u] *** The next 8 instructions are fused. ***\n",
 	      p->thread_id);
 
-	__instr_dma_ht_exec(p, 8);
+	__instr_dma_ht_exec(p, t, ip, 8);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4332,10 +3058,7 @@ instr_alu_add_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, +);
+	__instr_alu_add_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4347,10 +3070,7 @@ instr_alu_add_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, +);
+	__instr_alu_add_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4362,10 +3082,7 @@ instr_alu_add_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM(t, ip, +);
+	__instr_alu_add_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4377,10 +3094,7 @@ instr_alu_add_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH(t, ip, +);
+	__instr_alu_add_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4392,10 +3106,7 @@ instr_alu_add_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (mi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MI(t, ip, +);
+	__instr_alu_add_mi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4407,10 +3118,7 @@ instr_alu_add_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (hi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HI(t, ip, +);
+	__instr_alu_add_hi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4422,10 +3130,7 @@ instr_alu_sub_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, -);
+	__instr_alu_sub_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4437,10 +3142,7 @@ instr_alu_sub_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, -);
+	__instr_alu_sub_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4452,10 +3154,7 @@ instr_alu_sub_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM(t, ip, -);
+	__instr_alu_sub_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4467,10 +3166,7 @@ instr_alu_sub_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH(t, ip, -);
+	__instr_alu_sub_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4482,10 +3178,7 @@ instr_alu_sub_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (mi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MI(t, ip, -);
+	__instr_alu_sub_mi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4497,10 +3190,7 @@ instr_alu_sub_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (hi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HI(t, ip, -);
+	__instr_alu_sub_hi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4512,10 +3202,7 @@ instr_alu_shl_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, <<);
+	__instr_alu_shl_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4527,10 +3214,7 @@ instr_alu_shl_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, <<);
+	__instr_alu_shl_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4542,10 +3226,7 @@ instr_alu_shl_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM(t, ip, <<);
+	__instr_alu_shl_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4557,10 +3238,7 @@ instr_alu_shl_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH(t, ip, <<);
+	__instr_alu_shl_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4572,10 +3250,7 @@ instr_alu_shl_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (mi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MI(t, ip, <<);
+	__instr_alu_shl_mi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4587,10 +3262,7 @@ instr_alu_shl_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (hi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HI(t, ip, <<);
+	__instr_alu_shl_hi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4602,10 +3274,7 @@ instr_alu_shr_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, >>);
+	__instr_alu_shr_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4617,10 +3286,7 @@ instr_alu_shr_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, >>);
+	__instr_alu_shr_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4632,10 +3298,7 @@ instr_alu_shr_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM(t, ip, >>);
+	__instr_alu_shr_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4647,10 +3310,7 @@ instr_alu_shr_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH(t, ip, >>);
+	__instr_alu_shr_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4662,10 +3322,7 @@ instr_alu_shr_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (mi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MI(t, ip, >>);
+	__instr_alu_shr_mi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4677,10 +3334,7 @@ instr_alu_shr_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (hi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HI(t, ip, >>);
+	__instr_alu_shr_hi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4692,10 +3346,7 @@ instr_alu_and_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, &);
+	__instr_alu_and_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4707,10 +3358,7 @@ instr_alu_and_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, &);
+	__instr_alu_and_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4722,10 +3370,7 @@ instr_alu_and_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM_FAST(t, ip, &);
+	__instr_alu_and_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4737,10 +3382,7 @@ instr_alu_and_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH_FAST(t, ip, &);
+	__instr_alu_and_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4752,10 +3394,7 @@ instr_alu_and_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and (i)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_I(t, ip, &);
+	__instr_alu_and_i_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4767,10 +3406,7 @@ instr_alu_or_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, |);
+	__instr_alu_or_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4782,10 +3418,7 @@ instr_alu_or_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, |);
+	__instr_alu_or_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4797,10 +3430,7 @@ instr_alu_or_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM_FAST(t, ip, |);
+	__instr_alu_or_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4812,10 +3442,7 @@ instr_alu_or_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH_FAST(t, ip, |);
+	__instr_alu_or_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4827,10 +3454,7 @@ instr_alu_or_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or (i)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_I(t, ip, |);
+	__instr_alu_or_i_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4842,10 +3466,7 @@ instr_alu_xor_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, ^);
+	__instr_alu_xor_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4857,10 +3478,7 @@ instr_alu_xor_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, ^);
+	__instr_alu_xor_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4872,10 +3490,7 @@ instr_alu_xor_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM_FAST(t, ip, ^);
+	__instr_alu_xor_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4887,10 +3502,7 @@ instr_alu_xor_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH_FAST(t, ip, ^);
+	__instr_alu_xor_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4902,10 +3514,7 @@ instr_alu_xor_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor (i)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_I(t, ip, ^);
+	__instr_alu_xor_i_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4916,55 +3525,8 @@ instr_alu_ckadd_field_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint8_t *dst_struct, *src_struct;
-	uint16_t *dst16_ptr, dst;
-	uint64_t *src64_ptr, src64, src64_mask, src;
-	uint64_t r;
 
-	TRACE("[Thread %2u] ckadd (field)\n", p->thread_id);
-
-	/* Structs. */
-	dst_struct = t->structs[ip->alu.dst.struct_id];
-	dst16_ptr = (uint16_t *)&dst_struct[ip->alu.dst.offset];
-	dst = *dst16_ptr;
-
-	src_struct = t->structs[ip->alu.src.struct_id];
-	src64_ptr = (uint64_t *)&src_struct[ip->alu.src.offset];
-	src64 = *src64_ptr;
-	src64_mask = UINT64_MAX >> (64 - ip->alu.src.n_bits);
-	src = src64 & src64_mask;
-
-	r = dst;
-	r = ~r & 0xFFFF;
-
-	/* The first input (r) is a 16-bit number. The second and the third
-	 * inputs are 32-bit numbers. In the worst case scenario, the sum of the
-	 * three numbers (output r) is a 34-bit number.
-	 */
-	r += (src >> 32) + (src & 0xFFFFFFFF);
-
-	/* The first input is a 16-bit number. The second input is an 18-bit
-	 * number. In the worst case scenario, the sum of the two numbers is a
-	 * 19-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* The first input is a 16-bit number (0 .. 0xFFFF). The second input is
-	 * a 3-bit number (0 .. 7). Their sum is a 17-bit number (0 .. 0x10006).
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* When the input r is (0 .. 0xFFFF), the output r is equal to the input
-	 * r, so the output is (0 .. 0xFFFF). When the input r is (0x10000 ..
-	 * 0x10006), the output r is (0 .. 7). So no carry bit can be generated,
-	 * therefore the output r is always a 16-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	r = ~r & 0xFFFF;
-	r = r ? r : 0xFFFF;
-
-	*dst16_ptr = (uint16_t)r;
+	__instr_alu_ckadd_field_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4975,67 +3537,8 @@ instr_alu_cksub_field_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint8_t *dst_struct, *src_struct;
-	uint16_t *dst16_ptr, dst;
-	uint64_t *src64_ptr, src64, src64_mask, src;
-	uint64_t r;
-
-	TRACE("[Thread %2u] cksub (field)\n", p->thread_id);
-
-	/* Structs. */
-	dst_struct = t->structs[ip->alu.dst.struct_id];
-	dst16_ptr = (uint16_t *)&dst_struct[ip->alu.dst.offset];
-	dst = *dst16_ptr;
-
-	src_struct = t->structs[ip->alu.src.struct_id];
-	src64_ptr = (uint64_t *)&src_struct[ip->alu.src.offset];
-	src64 = *src64_ptr;
-	src64_mask = UINT64_MAX >> (64 - ip->alu.src.n_bits);
-	src = src64 & src64_mask;
 
-	r = dst;
-	r = ~r & 0xFFFF;
-
-	/* Subtraction in 1's complement arithmetic (i.e. a '- b) is the same as
-	 * the following sequence of operations in 2's complement arithmetic:
-	 *    a '- b = (a - b) % 0xFFFF.
-	 *
-	 * In order to prevent an underflow for the below subtraction, in which
-	 * a 33-bit number (the subtrahend) is taken out of a 16-bit number (the
-	 * minuend), we first add a multiple of the 0xFFFF modulus to the
-	 * minuend. The number we add to the minuend needs to be a 34-bit number
-	 * or higher, so for readability reasons we picked the 36-bit multiple.
-	 * We are effectively turning the 16-bit minuend into a 36-bit number:
-	 *    (a - b) % 0xFFFF = (a + 0xFFFF00000 - b) % 0xFFFF.
-	 */
-	r += 0xFFFF00000ULL; /* The output r is a 36-bit number. */
-
-	/* A 33-bit number is subtracted from a 36-bit number (the input r). The
-	 * result (the output r) is a 36-bit number.
-	 */
-	r -= (src >> 32) + (src & 0xFFFFFFFF);
-
-	/* The first input is a 16-bit number. The second input is a 20-bit
-	 * number. Their sum is a 21-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* The first input is a 16-bit number (0 .. 0xFFFF). The second input is
-	 * a 5-bit number (0 .. 31). The sum is a 17-bit number (0 .. 0x1001E).
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* When the input r is (0 .. 0xFFFF), the output r is equal to the input
-	 * r, so the output is (0 .. 0xFFFF). When the input r is (0x10000 ..
-	 * 0x1001E), the output r is (0 .. 31). So no carry bit can be
-	 * generated, therefore the output r is always a 16-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	r = ~r & 0xFFFF;
-	r = r ? r : 0xFFFF;
-
-	*dst16_ptr = (uint16_t)r;
+	__instr_alu_cksub_field_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5046,47 +3549,8 @@ instr_alu_ckadd_struct20_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint8_t *dst_struct, *src_struct;
-	uint16_t *dst16_ptr;
-	uint32_t *src32_ptr;
-	uint64_t r0, r1;
-
-	TRACE("[Thread %2u] ckadd (struct of 20 bytes)\n", p->thread_id);
-
-	/* Structs. */
-	dst_struct = t->structs[ip->alu.dst.struct_id];
-	dst16_ptr = (uint16_t *)&dst_struct[ip->alu.dst.offset];
-
-	src_struct = t->structs[ip->alu.src.struct_id];
-	src32_ptr = (uint32_t *)&src_struct[0];
-
-	r0 = src32_ptr[0]; /* r0 is a 32-bit number. */
-	r1 = src32_ptr[1]; /* r1 is a 32-bit number. */
-	r0 += src32_ptr[2]; /* The output r0 is a 33-bit number. */
-	r1 += src32_ptr[3]; /* The output r1 is a 33-bit number. */
-	r0 += r1 + src32_ptr[4]; /* The output r0 is a 35-bit number. */
 
-	/* The first input is a 16-bit number. The second input is a 19-bit
-	 * number. Their sum is a 20-bit number.
-	 */
-	r0 = (r0 & 0xFFFF) + (r0 >> 16);
-
-	/* The first input is a 16-bit number (0 .. 0xFFFF). The second input is
-	 * a 4-bit number (0 .. 15). The sum is a 17-bit number (0 .. 0x1000E).
-	 */
-	r0 = (r0 & 0xFFFF) + (r0 >> 16);
-
-	/* When the input r is (0 .. 0xFFFF), the output r is equal to the input
-	 * r, so the output is (0 .. 0xFFFF). When the input r is (0x10000 ..
-	 * 0x1000E), the output r is (0 .. 15). So no carry bit can be
-	 * generated, therefore the output r is always a 16-bit number.
-	 */
-	r0 = (r0 & 0xFFFF) + (r0 >> 16);
-
-	r0 = ~r0 & 0xFFFF;
-	r0 = r0 ? r0 : 0xFFFF;
-
-	*dst16_ptr = (uint16_t)r0;
+	__instr_alu_ckadd_struct20_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5097,49 +3561,8 @@ instr_alu_ckadd_struct_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint8_t *dst_struct, *src_struct;
-	uint16_t *dst16_ptr;
-	uint32_t *src32_ptr;
-	uint64_t r = 0;
-	uint32_t i;
-
-	TRACE("[Thread %2u] ckadd (struct)\n", p->thread_id);
-
-	/* Structs. */
-	dst_struct = t->structs[ip->alu.dst.struct_id];
-	dst16_ptr = (uint16_t *)&dst_struct[ip->alu.dst.offset];
-
-	src_struct = t->structs[ip->alu.src.struct_id];
-	src32_ptr = (uint32_t *)&src_struct[0];
-
-	/* The max number of 32-bit words in a 256-byte header is 8 = 2^3.
-	 * Therefore, in the worst case scenario, a 35-bit number is added to a
-	 * 16-bit number (the input r), so the output r is 36-bit number.
-	 */
-	for (i = 0; i < ip->alu.src.n_bits / 32; i++, src32_ptr++)
-		r += *src32_ptr;
-
-	/* The first input is a 16-bit number. The second input is a 20-bit
-	 * number. Their sum is a 21-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* The first input is a 16-bit number (0 .. 0xFFFF). The second input is
-	 * a 5-bit number (0 .. 31). The sum is a 17-bit number (0 .. 0x1000E).
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* When the input r is (0 .. 0xFFFF), the output r is equal to the input
-	 * r, so the output is (0 .. 0xFFFF). When the input r is (0x10000 ..
-	 * 0x1001E), the output r is (0 .. 31). So no carry bit can be
-	 * generated, therefore the output r is always a 16-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	r = ~r & 0xFFFF;
-	r = r ? r : 0xFFFF;
 
-	*dst16_ptr = (uint16_t)r;
+	__instr_alu_ckadd_struct_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5430,134 +3853,14 @@ instr_regadd_translate(struct rte_swx_pipeline *p,
 	return 0;
 }
 
-static inline uint64_t *
-instr_regarray_regarray(struct rte_swx_pipeline *p, struct instruction *ip)
-{
-	struct regarray_runtime *r = &p->regarray_runtime[ip->regarray.regarray_id];
-	return r->regarray;
-}
-
-static inline uint64_t
-instr_regarray_idx_hbo(struct rte_swx_pipeline *p, struct thread *t, struct instruction *ip)
-{
-	struct regarray_runtime *r = &p->regarray_runtime[ip->regarray.regarray_id];
-
-	uint8_t *idx_struct = t->structs[ip->regarray.idx.struct_id];
-	uint64_t *idx64_ptr = (uint64_t *)&idx_struct[ip->regarray.idx.offset];
-	uint64_t idx64 = *idx64_ptr;
-	uint64_t idx64_mask = UINT64_MAX >> (64 - ip->regarray.idx.n_bits);
-	uint64_t idx = idx64 & idx64_mask & r->size_mask;
-
-	return idx;
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-static inline uint64_t
-instr_regarray_idx_nbo(struct rte_swx_pipeline *p, struct thread *t, struct instruction *ip)
-{
-	struct regarray_runtime *r = &p->regarray_runtime[ip->regarray.regarray_id];
-
-	uint8_t *idx_struct = t->structs[ip->regarray.idx.struct_id];
-	uint64_t *idx64_ptr = (uint64_t *)&idx_struct[ip->regarray.idx.offset];
-	uint64_t idx64 = *idx64_ptr;
-	uint64_t idx = (ntoh64(idx64) >> (64 - ip->regarray.idx.n_bits)) & r->size_mask;
-
-	return idx;
-}
-
-#else
-
-#define instr_regarray_idx_nbo instr_regarray_idx_hbo
-
-#endif
-
-static inline uint64_t
-instr_regarray_idx_imm(struct rte_swx_pipeline *p, struct instruction *ip)
-{
-	struct regarray_runtime *r = &p->regarray_runtime[ip->regarray.regarray_id];
-
-	uint64_t idx = ip->regarray.idx_val & r->size_mask;
-
-	return idx;
-}
-
-static inline uint64_t
-instr_regarray_src_hbo(struct thread *t, struct instruction *ip)
-{
-	uint8_t *src_struct = t->structs[ip->regarray.dstsrc.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->regarray.dstsrc.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src64_mask = UINT64_MAX >> (64 - ip->regarray.dstsrc.n_bits);
-	uint64_t src = src64 & src64_mask;
-
-	return src;
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-static inline uint64_t
-instr_regarray_src_nbo(struct thread *t, struct instruction *ip)
-{
-	uint8_t *src_struct = t->structs[ip->regarray.dstsrc.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->regarray.dstsrc.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src = ntoh64(src64) >> (64 - ip->regarray.dstsrc.n_bits);
-
-	return src;
-}
-
-#else
-
-#define instr_regarray_src_nbo instr_regarray_src_hbo
-
-#endif
-
-static inline void
-instr_regarray_dst_hbo_src_hbo_set(struct thread *t, struct instruction *ip, uint64_t src)
-{
-	uint8_t *dst_struct = t->structs[ip->regarray.dstsrc.struct_id];
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[ip->regarray.dstsrc.offset];
-	uint64_t dst64 = *dst64_ptr;
-	uint64_t dst64_mask = UINT64_MAX >> (64 - ip->regarray.dstsrc.n_bits);
-
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);
-
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-static inline void
-instr_regarray_dst_nbo_src_hbo_set(struct thread *t, struct instruction *ip, uint64_t src)
-{
-	uint8_t *dst_struct = t->structs[ip->regarray.dstsrc.struct_id];
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[ip->regarray.dstsrc.offset];
-	uint64_t dst64 = *dst64_ptr;
-	uint64_t dst64_mask = UINT64_MAX >> (64 - ip->regarray.dstsrc.n_bits);
-
-	src = hton64(src) >> (64 - ip->regarray.dstsrc.n_bits);
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);
-}
-
-#else
-
-#define instr_regarray_dst_nbo_src_hbo_set instr_regarray_dst_hbo_src_hbo_set
-
-#endif
 
 static inline void
 instr_regprefetch_rh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	TRACE("[Thread %2u] regprefetch (r[h])\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	rte_prefetch0(&regarray[idx]);
+	__instr_regprefetch_rh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5568,14 +3871,8 @@ instr_regprefetch_rm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
-
-	TRACE("[Thread %2u] regprefetch (r[m])\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	rte_prefetch0(&regarray[idx]);
+	__instr_regprefetch_rm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5586,14 +3883,8 @@ instr_regprefetch_ri_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	TRACE("[Thread %2u] regprefetch (r[i])\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	rte_prefetch0(&regarray[idx]);
+	__instr_regprefetch_ri_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5604,14 +3895,8 @@ instr_regrd_hrh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
-
-	TRACE("[Thread %2u] regrd (h = r[h])\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	instr_regarray_dst_nbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_hrh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5622,14 +3907,8 @@ instr_regrd_hrm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	TRACE("[Thread %2u] regrd (h = r[m])\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	instr_regarray_dst_nbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_hrm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5640,14 +3919,8 @@ instr_regrd_mrh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
-
-	TRACE("[Thread %2u] regrd (m = r[h])\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	instr_regarray_dst_hbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_mrh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5658,12 +3931,8 @@ instr_regrd_mrm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	instr_regarray_dst_hbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_mrm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5674,14 +3943,8 @@ instr_regrd_hri_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	TRACE("[Thread %2u] regrd (h = r[i])\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	instr_regarray_dst_nbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_hri_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5692,14 +3955,8 @@ instr_regrd_mri_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
-
-	TRACE("[Thread %2u] regrd (m = r[i])\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	instr_regarray_dst_hbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_mri_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5710,15 +3967,8 @@ instr_regwr_rhh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regwr (r[h] = h)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rhh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5729,15 +3979,8 @@ instr_regwr_rhm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regwr (r[h] = m)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rhm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5748,15 +3991,8 @@ instr_regwr_rmh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regwr (r[m] = h)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rmh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5767,15 +4003,8 @@ instr_regwr_rmm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regwr (r[m] = m)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rmm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5786,15 +4015,8 @@ instr_regwr_rhi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regwr (r[h] = i)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] = src;
+	__instr_regwr_rhi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5805,15 +4027,8 @@ instr_regwr_rmi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regwr (r[m] = i)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] = src;
+	__instr_regwr_rmi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5824,15 +4039,8 @@ instr_regwr_rih_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regwr (r[i] = h)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rih_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5843,15 +4051,8 @@ instr_regwr_rim_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regwr (r[i] = m)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rim_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5862,15 +4063,8 @@ instr_regwr_rii_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regwr (r[i] = i)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] = src;
+	__instr_regwr_rii_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5881,15 +4075,8 @@ instr_regadd_rhh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regadd (r[h] += h)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rhh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5900,15 +4087,8 @@ instr_regadd_rhm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regadd (r[h] += m)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rhm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5919,15 +4099,8 @@ instr_regadd_rmh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regadd (r[m] += h)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rmh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5938,15 +4111,8 @@ instr_regadd_rmm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regadd (r[m] += m)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rmm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5957,15 +4123,8 @@ instr_regadd_rhi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regadd (r[h] += i)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] += src;
+	__instr_regadd_rhi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5976,15 +4135,8 @@ instr_regadd_rmi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regadd (r[m] += i)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] += src;
+	__instr_regadd_rmi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5995,15 +4147,8 @@ instr_regadd_rih_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regadd (r[i] += h)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rih_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6014,15 +4159,8 @@ instr_regadd_rim_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regadd (r[i] += m)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rim_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6033,15 +4171,8 @@ instr_regadd_rii_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regadd (r[i] += i)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] += src;
+	__instr_regadd_rii_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6215,142 +4346,41 @@ instr_meter_translate(struct rte_swx_pipeline *p,
 		instr->meter.color_out.n_bits = fcout->n_bits;
 		instr->meter.color_out.offset = fcout->offset / 8;
 
-		return 0;
-	}
-
-	/* index = I, length = HMEFT, color_in = I, color_out = MEF. */
-	if (!fidx && !fcin) {
-		uint32_t idx_val, color_in_val;
-
-		idx_val = strtoul(idx, &idx, 0);
-		CHECK(!idx[0], EINVAL);
-
-		color_in_val = strtoul(color_in, &color_in, 0);
-		CHECK(!color_in[0], EINVAL);
-
-		instr->type = INSTR_METER_IMI;
-		if (length[0] == 'h')
-			instr->type = INSTR_METER_IHI;
-
-		instr->meter.metarray_id = m->id;
-
-		instr->meter.idx_val = idx_val;
-
-		instr->meter.length.struct_id = (uint8_t)length_struct_id;
-		instr->meter.length.n_bits = flength->n_bits;
-		instr->meter.length.offset = flength->offset / 8;
-
-		instr->meter.color_in_val = color_in_val;
-
-		instr->meter.color_out.struct_id = (uint8_t)color_out_struct_id;
-		instr->meter.color_out.n_bits = fcout->n_bits;
-		instr->meter.color_out.offset = fcout->offset / 8;
-
-		return 0;
-	}
-
-	CHECK(0, EINVAL);
-}
-
-static inline struct meter *
-instr_meter_idx_hbo(struct rte_swx_pipeline *p, struct thread *t, struct instruction *ip)
-{
-	struct metarray_runtime *r = &p->metarray_runtime[ip->meter.metarray_id];
-
-	uint8_t *idx_struct = t->structs[ip->meter.idx.struct_id];
-	uint64_t *idx64_ptr = (uint64_t *)&idx_struct[ip->meter.idx.offset];
-	uint64_t idx64 = *idx64_ptr;
-	uint64_t idx64_mask = UINT64_MAX >> (64 - (ip)->meter.idx.n_bits);
-	uint64_t idx = idx64 & idx64_mask & r->size_mask;
-
-	return &r->metarray[idx];
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-static inline struct meter *
-instr_meter_idx_nbo(struct rte_swx_pipeline *p, struct thread *t, struct instruction *ip)
-{
-	struct metarray_runtime *r = &p->metarray_runtime[ip->meter.metarray_id];
-
-	uint8_t *idx_struct = t->structs[ip->meter.idx.struct_id];
-	uint64_t *idx64_ptr = (uint64_t *)&idx_struct[ip->meter.idx.offset];
-	uint64_t idx64 = *idx64_ptr;
-	uint64_t idx = (ntoh64(idx64) >> (64 - ip->meter.idx.n_bits)) & r->size_mask;
-
-	return &r->metarray[idx];
-}
-
-#else
-
-#define instr_meter_idx_nbo instr_meter_idx_hbo
-
-#endif
-
-static inline struct meter *
-instr_meter_idx_imm(struct rte_swx_pipeline *p, struct instruction *ip)
-{
-	struct metarray_runtime *r = &p->metarray_runtime[ip->meter.metarray_id];
-
-	uint64_t idx =  ip->meter.idx_val & r->size_mask;
-
-	return &r->metarray[idx];
-}
-
-static inline uint32_t
-instr_meter_length_hbo(struct thread *t, struct instruction *ip)
-{
-	uint8_t *src_struct = t->structs[ip->meter.length.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->meter.length.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->meter.length.n_bits);
-	uint64_t src = src64 & src64_mask;
-
-	return (uint32_t)src;
-}
+		return 0;
+	}
 
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
+	/* index = I, length = HMEFT, color_in = I, color_out = MEF. */
+	if (!fidx && !fcin) {
+		uint32_t idx_val, color_in_val;
 
-static inline uint32_t
-instr_meter_length_nbo(struct thread *t, struct instruction *ip)
-{
-	uint8_t *src_struct = t->structs[ip->meter.length.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->meter.length.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src = ntoh64(src64) >> (64 - ip->meter.length.n_bits);
+		idx_val = strtoul(idx, &idx, 0);
+		CHECK(!idx[0], EINVAL);
 
-	return (uint32_t)src;
-}
+		color_in_val = strtoul(color_in, &color_in, 0);
+		CHECK(!color_in[0], EINVAL);
 
-#else
+		instr->type = INSTR_METER_IMI;
+		if (length[0] == 'h')
+			instr->type = INSTR_METER_IHI;
 
-#define instr_meter_length_nbo instr_meter_length_hbo
+		instr->meter.metarray_id = m->id;
 
-#endif
+		instr->meter.idx_val = idx_val;
 
-static inline enum rte_color
-instr_meter_color_in_hbo(struct thread *t, struct instruction *ip)
-{
-	uint8_t *src_struct = t->structs[ip->meter.color_in.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->meter.color_in.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src64_mask = UINT64_MAX >> (64 - ip->meter.color_in.n_bits);
-	uint64_t src = src64 & src64_mask;
+		instr->meter.length.struct_id = (uint8_t)length_struct_id;
+		instr->meter.length.n_bits = flength->n_bits;
+		instr->meter.length.offset = flength->offset / 8;
 
-	return (enum rte_color)src;
-}
+		instr->meter.color_in_val = color_in_val;
 
-static inline void
-instr_meter_color_out_hbo_set(struct thread *t, struct instruction *ip, enum rte_color color_out)
-{
-	uint8_t *dst_struct = t->structs[ip->meter.color_out.struct_id];
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[ip->meter.color_out.offset];
-	uint64_t dst64 = *dst64_ptr;
-	uint64_t dst64_mask = UINT64_MAX >> (64 - ip->meter.color_out.n_bits);
+		instr->meter.color_out.struct_id = (uint8_t)color_out_struct_id;
+		instr->meter.color_out.n_bits = fcout->n_bits;
+		instr->meter.color_out.offset = fcout->offset / 8;
 
-	uint64_t src = (uint64_t)color_out;
+		return 0;
+	}
 
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);
+	CHECK(0, EINVAL);
 }
 
 static inline void
@@ -6358,13 +4388,8 @@ instr_metprefetch_h_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
 
-	TRACE("[Thread %2u] metprefetch (h)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m);
+	__instr_metprefetch_h_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6375,13 +4400,8 @@ instr_metprefetch_m_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
 
-	TRACE("[Thread %2u] metprefetch (m)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m);
+	__instr_metprefetch_m_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6392,13 +4412,8 @@ instr_metprefetch_i_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
 
-	TRACE("[Thread %2u] metprefetch (i)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m);
+	__instr_metprefetch_i_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6409,35 +4424,8 @@ instr_meter_hhm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
 
-	TRACE("[Thread %2u] meter (hhm)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_hhm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6448,35 +4436,8 @@ instr_meter_hhi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (hhi)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_hhi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6487,35 +4448,8 @@ instr_meter_hmm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (hmm)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
 
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_hmm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6525,35 +4459,8 @@ instr_meter_hmi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (hmi)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
 
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_hmi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6564,35 +4471,8 @@ instr_meter_mhm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (mhm)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
 
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_mhm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6603,35 +4483,8 @@ instr_meter_mhi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (mhi)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
 
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_mhi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6642,35 +4495,8 @@ instr_meter_mmm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (mmm)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
 
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_mmm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6681,35 +4507,8 @@ instr_meter_mmi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (mmi)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
 
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_mmi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6720,35 +4519,8 @@ instr_meter_ihm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
 
-	TRACE("[Thread %2u] meter (ihm)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_ihm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6759,35 +4531,8 @@ instr_meter_ihi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (ihi)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_ihi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6798,35 +4543,8 @@ instr_meter_imm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (imm)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
 
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_imm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6836,35 +4554,8 @@ instr_meter_imi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (imi)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
 
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_imi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -7340,7 +5031,7 @@ instr_jmp_eq_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpeq\n", p->thread_id);
 
-	JMP_CMP(t, ip, ==);
+	t->ip = JMP_CMP(t, ip, ==) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7351,7 +5042,7 @@ instr_jmp_eq_mh_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpeq (mh)\n", p->thread_id);
 
-	JMP_CMP_MH(t, ip, ==);
+	t->ip = JMP_CMP_MH(t, ip, ==) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7362,7 +5053,7 @@ instr_jmp_eq_hm_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpeq (hm)\n", p->thread_id);
 
-	JMP_CMP_HM(t, ip, ==);
+	t->ip = JMP_CMP_HM(t, ip, ==) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7373,7 +5064,7 @@ instr_jmp_eq_hh_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpeq (hh)\n", p->thread_id);
 
-	JMP_CMP_HH_FAST(t, ip, ==);
+	t->ip = JMP_CMP_HH_FAST(t, ip, ==) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7384,7 +5075,7 @@ instr_jmp_eq_i_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpeq (i)\n", p->thread_id);
 
-	JMP_CMP_I(t, ip, ==);
+	t->ip = JMP_CMP_I(t, ip, ==) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7395,7 +5086,7 @@ instr_jmp_neq_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpneq\n", p->thread_id);
 
-	JMP_CMP(t, ip, !=);
+	t->ip = JMP_CMP(t, ip, !=) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7406,7 +5097,7 @@ instr_jmp_neq_mh_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpneq (mh)\n", p->thread_id);
 
-	JMP_CMP_MH(t, ip, !=);
+	t->ip = JMP_CMP_MH(t, ip, !=) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7417,7 +5108,7 @@ instr_jmp_neq_hm_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpneq (hm)\n", p->thread_id);
 
-	JMP_CMP_HM(t, ip, !=);
+	t->ip = JMP_CMP_HM(t, ip, !=) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7428,7 +5119,7 @@ instr_jmp_neq_hh_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpneq (hh)\n", p->thread_id);
 
-	JMP_CMP_HH_FAST(t, ip, !=);
+	t->ip = JMP_CMP_HH_FAST(t, ip, !=) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7439,7 +5130,7 @@ instr_jmp_neq_i_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpneq (i)\n", p->thread_id);
 
-	JMP_CMP_I(t, ip, !=);
+	t->ip = JMP_CMP_I(t, ip, !=) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7450,7 +5141,7 @@ instr_jmp_lt_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmplt\n", p->thread_id);
 
-	JMP_CMP(t, ip, <);
+	t->ip = JMP_CMP(t, ip, <) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7461,7 +5152,7 @@ instr_jmp_lt_mh_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmplt (mh)\n", p->thread_id);
 
-	JMP_CMP_MH(t, ip, <);
+	t->ip = JMP_CMP_MH(t, ip, <) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7472,7 +5163,7 @@ instr_jmp_lt_hm_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmplt (hm)\n", p->thread_id);
 
-	JMP_CMP_HM(t, ip, <);
+	t->ip = JMP_CMP_HM(t, ip, <) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7483,7 +5174,7 @@ instr_jmp_lt_hh_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmplt (hh)\n", p->thread_id);
 
-	JMP_CMP_HH(t, ip, <);
+	t->ip = JMP_CMP_HH(t, ip, <) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7494,7 +5185,7 @@ instr_jmp_lt_mi_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmplt (mi)\n", p->thread_id);
 
-	JMP_CMP_MI(t, ip, <);
+	t->ip = JMP_CMP_MI(t, ip, <) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7505,7 +5196,7 @@ instr_jmp_lt_hi_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmplt (hi)\n", p->thread_id);
 
-	JMP_CMP_HI(t, ip, <);
+	t->ip = JMP_CMP_HI(t, ip, <) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7516,7 +5207,7 @@ instr_jmp_gt_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpgt\n", p->thread_id);
 
-	JMP_CMP(t, ip, >);
+	t->ip = JMP_CMP(t, ip, >) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7527,7 +5218,7 @@ instr_jmp_gt_mh_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpgt (mh)\n", p->thread_id);
 
-	JMP_CMP_MH(t, ip, >);
+	t->ip = JMP_CMP_MH(t, ip, >) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7538,7 +5229,7 @@ instr_jmp_gt_hm_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpgt (hm)\n", p->thread_id);
 
-	JMP_CMP_HM(t, ip, >);
+	t->ip = JMP_CMP_HM(t, ip, >) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7549,7 +5240,7 @@ instr_jmp_gt_hh_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpgt (hh)\n", p->thread_id);
 
-	JMP_CMP_HH(t, ip, >);
+	t->ip = JMP_CMP_HH(t, ip, >) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7560,7 +5251,7 @@ instr_jmp_gt_mi_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpgt (mi)\n", p->thread_id);
 
-	JMP_CMP_MI(t, ip, >);
+	t->ip = JMP_CMP_MI(t, ip, >) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7571,7 +5262,7 @@ instr_jmp_gt_hi_exec(struct rte_swx_pipeline *p)
 
 	TRACE("[Thread %2u] jmpgt (hi)\n", p->thread_id);
 
-	JMP_CMP_HI(t, ip, >);
+	t->ip = JMP_CMP_HI(t, ip, >) ? ip->jmp.ip : (t->ip + 1);
 }
 
 /*
@@ -8837,6 +6528,464 @@ instr_exec(struct rte_swx_pipeline *p)
 	instr(p);
 }
 
+/*
+ * Action code generation.
+ *
+ * The actions made up exclusively of instructions that never yield the thread
+ * are translated into C code, which is then compiled into a shared object and
+ * loaded at pipeline build time. The instruction operands of the generated
+ * action functions are compile time constants and the instructions are no
+ * longer dispatched one by one through the instruction table, with the action
+ * running to completion in a single function call. The actions using any other
+ * instruction (e.g. extern object or function calls), as well as all the
+ * actions when the code generation or the compilation fails, are run by the
+ * interpreter.
+ */
+#ifndef RTE_SWX_PIPELINE_CODEGEN_INCLUDE_PATH
+#define RTE_SWX_PIPELINE_CODEGEN_INCLUDE_PATH "/usr/local/include"
+#endif
+
+#define CODEGEN_CMD_FMT "%s -O3 -fPIC -shared%s %s -o %s %s > /dev/null 2>&1"
+
+static const char *instr_codegen_funcs[INSTR_RETURN + 1] = {
+	[INSTR_HDR_VALIDATE] = "hdr_validate",
+	[INSTR_HDR_INVALIDATE] = "hdr_invalidate",
+	[INSTR_MOV] = "mov",
+	[INSTR_MOV_MH] = "mov_mh",
+	[INSTR_MOV_HM] = "mov_hm",
+	[INSTR_MOV_HH] = "mov_hh",
+	[INSTR_MOV_I] = "mov_i",
+	[INSTR_ALU_ADD] = "alu_add",
+	[INSTR_ALU_ADD_MH] = "alu_add_mh",
+	[INSTR_ALU_ADD_HM] = "alu_add_hm",
+	[INSTR_ALU_ADD_HH] = "alu_add_hh",
+	[INSTR_ALU_ADD_MI] = "alu_add_mi",
+	[INSTR_ALU_ADD_HI] = "alu_add_hi",
+	[INSTR_ALU_SUB] = "alu_sub",
+	[INSTR_ALU_SUB_MH] = "alu_sub_mh",
+	[INSTR_ALU_SUB_HM] = "alu_sub_hm",
+	[INSTR_ALU_SUB_HH] = "alu_sub_hh",
+	[INSTR_ALU_SUB_MI] = "alu_sub_mi",
+	[INSTR_ALU_SUB_HI] = "alu_sub_hi",
+	[INSTR_ALU_CKADD_FIELD] = "alu_ckadd_field",
+	[INSTR_ALU_CKADD_STRUCT] = "alu_ckadd_struct",
+	[INSTR_ALU_CKADD_STRUCT20] = "alu_ckadd_struct20",
+	[INSTR_ALU_CKSUB_FIELD] = "alu_cksub_field",
+	[INSTR_ALU_AND] = "alu_and",
+	[INSTR_ALU_AND_MH] = "alu_and_mh",
+	[INSTR_ALU_AND_HM] = "alu_and_hm",
+	[INSTR_ALU_AND_HH] = "alu_and_hh",
+	[INSTR_ALU_AND_I] = "alu_and_i",
+	[INSTR_ALU_OR] = "alu_or",
+	[INSTR_ALU_OR_MH] = "alu_or_mh",
+	[INSTR_ALU_OR_HM] = "alu_or_hm",
+	[INSTR_ALU_OR_HH] = "alu_or_hh",
+	[INSTR_ALU_OR_I] = "alu_or_i",
+	[INSTR_ALU_XOR] = "alu_xor",
+	[INSTR_ALU_XOR_MH] = "alu_xor_mh",
+	[INSTR_ALU_XOR_HM] = "alu_xor_hm",
+	[INSTR_ALU_XOR_HH] = "alu_xor_hh",
+	[INSTR_ALU_XOR_I] = "alu_xor_i",
+	[INSTR_ALU_SHL] = "alu_shl",
+	[INSTR_ALU_SHL_MH] = "alu_shl_mh",
+	[INSTR_ALU_SHL_HM] = "alu_shl_hm",
+	[INSTR_ALU_SHL_HH] = "alu_shl_hh",
+	[INSTR_ALU_SHL_MI] = "alu_shl_mi",
+	[INSTR_ALU_SHL_HI] = "alu_shl_hi",
+	[INSTR_ALU_SHR] = "alu_shr",
+	[INSTR_ALU_SHR_MH] = "alu_shr_mh",
+	[INSTR_ALU_SHR_HM] = "alu_shr_hm",
+	[INSTR_ALU_SHR_HH] = "alu_shr_hh",
+	[INSTR_ALU_SHR_MI] = "alu_shr_mi",
+	[INSTR_ALU_SHR_HI] = "alu_shr_hi",
+	[INSTR_REGPREFETCH_RH] = "regprefetch_rh",
+	[INSTR_REGPREFETCH_RM] = "regprefetch_rm",
+	[INSTR_REGPREFETCH_RI] = "regprefetch_ri",
+	[INSTR_REGRD_HRH] = "regrd_hrh",
+	[INSTR_REGRD_HRM] = "regrd_hrm",
+	[INSTR_REGRD_MRH] = "regrd_mrh",
+	[INSTR_REGRD_MRM] = "regrd_mrm",
+	[INSTR_REGRD_HRI] = "regrd_hri",
+	[INSTR_REGRD_MRI] = "regrd_mri",
+	[INSTR_REGWR_RHH] = "regwr_rhh",
+	[INSTR_REGWR_RHM] = "regwr_rhm",
+	[INSTR_REGWR_RMH] = "regwr_rmh",
+	[INSTR_REGWR_RMM] = "regwr_rmm",
+	[INSTR_REGWR_RHI] = "regwr_rhi",
+	[INSTR_REGWR_RMI] = "regwr_rmi",
+	[INSTR_REGWR_RIH] = "regwr_rih",
+	[INSTR_REGWR_RIM] = "regwr_rim",
+	[INSTR_REGWR_RII] = "regwr_rii",
+	[INSTR_REGADD_RHH] = "regadd_rhh",
+	[INSTR_REGADD_RHM] = "regadd_rhm",
+	[INSTR_REGADD_RMH] = "regadd_rmh",
+	[INSTR_REGADD_RMM] = "regadd_rmm",
+	[INSTR_REGADD_RHI] = "regadd_rhi",
+	[INSTR_REGADD_RMI] = "regadd_rmi",
+	[INSTR_REGADD_RIH] = "regadd_rih",
+	[INSTR_REGADD_RIM] = "regadd_rim",
+	[INSTR_REGADD_RII] = "regadd_rii",
+	[INSTR_METPREFETCH_H] = "metprefetch_h",
+	[INSTR_METPREFETCH_M] = "metprefetch_m",
+	[INSTR_METPREFETCH_I] = "metprefetch_i",
+	[INSTR_METER_HHM] = "meter_hhm",
+	[INSTR_METER_HHI] = "meter_hhi",
+	[INSTR_METER_HMM] = "meter_hmm",
+	[INSTR_METER_HMI] = "meter_hmi",
+	[INSTR_METER_MHM] = "meter_mhm",
+	[INSTR_METER_MHI] = "meter_mhi",
+	[INSTR_METER_MMM] = "meter_mmm",
+	[INSTR_METER_MMI] = "meter_mmi",
+	[INSTR_METER_IHM] = "meter_ihm",
+	[INSTR_METER_IHI] = "meter_ihi",
+	[INSTR_METER_IMM] = "meter_imm",
+	[INSTR_METER_IMI] = "meter_imi",
+};
+
+static const struct {
+	const char *macro;
+	const char *operator;
+} instr_jmp_cmp_codegen[INSTR_RETURN + 1] = {
+	[INSTR_JMP_EQ] = {"JMP_CMP", "=="},
+	[INSTR_JMP_EQ_MH] = {"JMP_CMP_MH", "=="},
+	[INSTR_JMP_EQ_HM] = {"JMP_CMP_HM", "=="},
+	[INSTR_JMP_EQ_HH] = {"JMP_CMP_HH_FAST", "=="},
+	[INSTR_JMP_EQ_I] = {"JMP_CMP_I", "=="},
+	[INSTR_JMP_NEQ] = {"JMP_CMP", "!="},
+	[INSTR_JMP_NEQ_MH] = {"JMP_CMP_MH", "!="},
+	[INSTR_JMP_NEQ_HM] = {"JMP_CMP_HM", "!="},
+	[INSTR_JMP_NEQ_HH] = {"JMP_CMP_HH_FAST", "!="},
+	[INSTR_JMP_NEQ_I] = {"JMP_CMP_I", "!="},
+	[INSTR_JMP_LT] = {"JMP_CMP", "<"},
+	[INSTR_JMP_LT_MH] = {"JMP_CMP_MH", "<"},
+	[INSTR_JMP_LT_HM] = {"JMP_CMP_HM", "<"},
+	[INSTR_JMP_LT_HH] = {"JMP_CMP_HH", "<"},
+	[INSTR_JMP_LT_MI] = {"JMP_CMP_MI", "<"},
+	[INSTR_JMP_LT_HI] = {"JMP_CMP_HI", "<"},
+	[INSTR_JMP_GT] = {"JMP_CMP", ">"},
+	[INSTR_JMP_GT_MH] = {"JMP_CMP_MH", ">"},
+	[INSTR_JMP_GT_HM] = {"JMP_CMP_HM", ">"},
+	[INSTR_JMP_GT_HH] = {"JMP_CMP_HH", ">"},
+	[INSTR_JMP_GT_MI] = {"JMP_CMP_MI", ">"},
+	[INSTR_JMP_GT_HI] = {"JMP_CMP_HI", ">"},
+};
+
+static uint32_t
+instr_dma_ht_codegen_n_dma(enum instruction_type type)
+{
+	switch (type) {
+	case INSTR_DMA_HT: return 1;
+	case INSTR_DMA_HT2: return 2;
+	case INSTR_DMA_HT3: return 3;
+	case INSTR_DMA_HT4: return 4;
+	case INSTR_DMA_HT5: return 5;
+	case INSTR_DMA_HT6: return 6;
+	case INSTR_DMA_HT7: return 7;
+	case INSTR_DMA_HT8: return 8;
+	default: return 0;
+	}
+}
+
+static int
+instr_is_jmp_codegen(struct instruction *instr)
+{
+	return (instr->type == INSTR_JMP) ||
+	       (instr->type == INSTR_JMP_VALID) ||
+	       (instr->type == INSTR_JMP_INVALID) ||
+	       instr_jmp_cmp_codegen[instr->type].macro;
+}
+
+static int
+action_codegen_supported(struct action *a)
+{
+	uint32_t i;
+
+	for (i = 0; i < a->n_instructions; i++) {
+		struct instruction *instr = &a->instructions[i];
+
+		if (!instr_codegen_funcs[instr->type] &&
+		    !instr_dma_ht_codegen_n_dma(instr->type) &&
+		    !instr_is_jmp_codegen(instr) &&
+		    (instr->type != INSTR_RETURN))
+			return 0;
+	}
+
+	return 1;
+}
+
+static void
+instr_operand_codegen(FILE *f, const char *name, struct instr_operand *o)
+{
+	fprintf(f,
+		"\t\t\t.%s = {.struct_id = %u, .n_bits = %u, .offset = %u},\n",
+		name,
+		o->struct_id,
+		o->n_bits,
+		o->offset);
+}
+
+static void
+instr_array_codegen(FILE *f, const char *name, uint32_t n, uint8_t *a8, uint16_t *a16)
+{
+	uint32_t i;
+
+	fprintf(f, "\t\t\t.%s = {", name);
+	for (i = 0; i < n; i++)
+		fprintf(f, "%s%u", i ? ", " : "", a8 ? a8[i] : a16[i]);
+	fprintf(f, "},\n");
+}
+
+/* The operands that are either a field or an immediate value are written as
+ * the immediate value, which covers the memory of both union members.
+ */
+static void
+instr_codegen(FILE *f, struct instruction *instr)
+{
+	const char *func = instr_codegen_funcs[instr->type];
+
+	fprintf(f, "\t{\n");
+	fprintf(f, "\t\t.type = (enum instruction_type)%u,\n", instr->type);
+
+	if (instr_dma_ht_codegen_n_dma(instr->type)) {
+		fprintf(f, "\t\t.dma = {\n");
+		instr_array_codegen(f, "dst.header_id", 8, instr->dma.dst.header_id, NULL);
+		instr_array_codegen(f, "dst.struct_id", 8, instr->dma.dst.struct_id, NULL);
+		instr_array_codegen(f, "src.offset", 8, instr->dma.src.offset, NULL);
+		instr_array_codegen(f, "n_bytes", 8, NULL, instr->dma.n_bytes);
+		fprintf(f, "\t\t},\n");
+	} else if (instr_jmp_cmp_codegen[instr->type].macro) {
+		/* The jump target is part of the generated code. */
+		fprintf(f, "\t\t.jmp = {\n");
+		instr_operand_codegen(f, "a", &instr->jmp.a);
+		fprintf(f, "\t\t\t.b_val = UINT64_C(0x%" PRIx64 "),\n", instr->jmp.b_val);
+		fprintf(f, "\t\t},\n");
+	} else if (!func) {
+		/* Jumps to labels and return: no operands needed. */
+	} else if (!strncmp(func, "hdr_", strlen("hdr_"))) {
+		fprintf(f, "\t\t.valid = {.header_id = %u},\n", instr->valid.header_id);
+	} else if (!strncmp(func, "mov", strlen("mov")) ||
+		   !strncmp(func, "alu_", strlen("alu_"))) {
+		fprintf(f, "\t\t.%s = {\n", (func[0] == 'm') ? "mov" : "alu");
+		instr_operand_codegen(f, "dst", &instr->alu.dst);
+		fprintf(f, "\t\t\t.src_val = UINT64_C(0x%" PRIx64 "),\n", instr->alu.src_val);
+		fprintf(f, "\t\t},\n");
+	} else if (!strncmp(func, "reg", strlen("reg"))) {
+		fprintf(f, "\t\t.regarray = {\n");
+		fprintf(f, "\t\t\t.regarray_id = %u,\n", instr->regarray.regarray_id);
+		fprintf(f, "\t\t\t.idx_val = 0x%" PRIx32 ",\n", instr->regarray.idx_val);
+		fprintf(f, "\t\t\t.dstsrc_val = UINT64_C(0x%" PRIx64 "),\n",
+			instr->regarray.dstsrc_val);
+		fprintf(f, "\t\t},\n");
+	} else {
+		fprintf(f, "\t\t.meter = {\n");
+		fprintf(f, "\t\t\t.metarray_id = %u,\n", instr->meter.metarray_id);
+		fprintf(f, "\t\t\t.idx_val = 0x%" PRIx32 ",\n", instr->meter.idx_val);
+		instr_operand_codegen(f, "length", &instr->meter.length);
+		fprintf(f, "\t\t\t.color_in_val = 0x%" PRIx32 ",\n", instr->meter.color_in_val);
+		instr_operand_codegen(f, "color_out", &instr->meter.color_out);
+		fprintf(f, "\t\t},\n");
+	}
+
+	fprintf(f, "\t},\n");
+}
+
+static int
+action_codegen(FILE *f, struct action *a)
+{
+	int *jmp_target;
+	uint32_t i;
+
+	jmp_target = calloc(a->n_instructions, sizeof(int));
+	CHECK(jmp_target, ENOMEM);
+
+	for (i = 0; i < a->n_instructions; i++) {
+		struct instruction *instr = &a->instructions[i];
+
+		if (instr_is_jmp_codegen(instr))
+			jmp_target[instr->jmp.ip - a->instructions] = 1;
+	}
+
+	/* Instructions. */
+	fprintf(f, "\n/* Action %s. */\n", a->name);
+	fprintf(f, "static const struct instruction action_%u_instructions[] = {\n",
+		a->id);
+
+	for (i = 0; i < a->n_instructions; i++)
+		instr_codegen(f, &a->instructions[i]);
+
+	fprintf(f, "};\n\n");
+
+	/* Action function. */
+	fprintf(f, "void\naction_%u_run(struct rte_swx_pipeline *p);\n\n", a->id);
+	fprintf(f, "void\naction_%u_run(struct rte_swx_pipeline *p)\n{\n", a->id);
+	fprintf(f, "\tstruct thread *t __rte_unused = &p->threads[p->thread_id];\n");
+	fprintf(f, "\tconst struct instruction *ip __rte_unused = action_%u_instructions;\n\n",
+		a->id);
+
+	for (i = 0; i < a->n_instructions; i++) {
+		struct instruction *instr = &a->instructions[i];
+		const char *func = instr_codegen_funcs[instr->type];
+		uint32_t n_dma = instr_dma_ht_codegen_n_dma(instr->type);
+		uint32_t target = 0;
+
+		if (instr_is_jmp_codegen(instr))
+			target = instr->jmp.ip - a->instructions;
+
+		if (jmp_target[i])
+			fprintf(f, "instr_%u:\n", i);
+
+		if (func)
+			fprintf(f, "\t__instr_%s_exec(p, t, &ip[%u]);\n", func, i);
+		else if (n_dma)
+			fprintf(f, "\t__instr_dma_ht_exec(p, t, &ip[%u], %u);\n", i, n_dma);
+		else if (instr->type == INSTR_JMP)
+			fprintf(f, "\tgoto instr_%u;\n", target);
+		else if (instr->type == INSTR_JMP_VALID)
+			fprintf(f, "\tif (HEADER_VALID(t, %u))\n\t\tgoto instr_%u;\n",
+				instr->jmp.header_id,
+				target);
+		else if (instr->type == INSTR_JMP_INVALID)
+			fprintf(f, "\tif (!HEADER_VALID(t, %u))\n\t\tgoto instr_%u;\n",
+				instr->jmp.header_id,
+				target);
+		else if (instr_jmp_cmp_codegen[instr->type].macro)
+			fprintf(f, "\tif (%s(t, &ip[%u], %s))\n\t\tgoto instr_%u;\n",
+				instr_jmp_cmp_codegen[instr->type].macro,
+				i,
+				instr_jmp_cmp_codegen[instr->type].operator,
+				target);
+		else
+			fprintf(f, "\treturn;\n");
+	}
+
+	fprintf(f, "}\n");
+
+	free(jmp_target);
+	return 0;
+}
+
+static int
+action_codegen_build(struct rte_swx_pipeline *p)
+{
+	char tmp_dir[PATH_MAX], src_path[PATH_MAX], lib_path[PATH_MAX];
+	char func_name[64];
+	char *cmd = NULL;
+	struct action *a;
+	FILE *f = NULL;
+	void *lib = NULL;
+	uint32_t n_actions = 0;
+	int cmd_size, fd, status = 0;
+
+	TAILQ_FOREACH(a, &p->actions, node)
+		if (action_codegen_supported(a))
+			n_actions++;
+
+	if (!n_actions)
+		return 0;
+
+	/* Private directory, so that no other user can replace the files
+	 * between their generation and the shared object load.
+	 */
+	CHECK(snprintf(tmp_dir, sizeof(tmp_dir), "%s/swx_pipeline_XXXXXX",
+		       p->codegen.dir) < (int)sizeof(tmp_dir), ENAMETOOLONG);
+	CHECK(mkdtemp(tmp_dir), EIO);
+
+	snprintf(src_path, sizeof(src_path), "%s/actions.c", tmp_dir);
+	snprintf(lib_path, sizeof(lib_path), "%s/actions.so", tmp_dir);
+
+	/* C code generation. */
+	fd = open(src_path, O_WRONLY | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if (fd < 0) {
+		status = -EIO;
+		goto free;
+	}
+
+	f = fdopen(fd, "w");
+	if (!f) {
+		close(fd);
+		status = -EIO;
+		goto free;
+	}
+
+	fprintf(f, "/* Generated by the SWX pipeline library. Do not edit. */\n");
+	fprintf(f, "#include <rte_swx_pipeline_internal.h>\n");
+
+	TAILQ_FOREACH(a, &p->actions, node) {
+		if (!action_codegen_supported(a))
+			continue;
+
+		status = action_codegen(f, a);
+		if (status)
+			goto free;
+	}
+
+	if (fclose(f)) {
+		f = NULL;
+		status = -EIO;
+		goto free;
+	}
+	f = NULL;
+
+	/* Compilation. */
+	cmd_size = snprintf(NULL, 0, CODEGEN_CMD_FMT,
+			    p->codegen.cc,
+			    p->codegen.include_flags,
+			    p->codegen.cflags,
+			    lib_path,
+			    src_path) + 1;
+
+	cmd = malloc(cmd_size);
+	if (!cmd) {
+		status = -ENOMEM;
+		goto free;
+	}
+
+	snprintf(cmd, cmd_size, CODEGEN_CMD_FMT,
+		 p->codegen.cc,
+		 p->codegen.include_flags,
+		 p->codegen.cflags,
+		 lib_path,
+		 src_path);
+
+	if (system(cmd)) {
+		status = -ENOEXEC;
+		goto free;
+	}
+
+	/* Shared object load. */
+	lib = dlopen(lib_path, RTLD_NOW | RTLD_LOCAL);
+	if (!lib) {
+		status = -ENOENT;
+		goto free;
+	}
+
+	TAILQ_FOREACH(a, &p->actions, node) {
+		if (!action_codegen_supported(a))
+			continue;
+
+		snprintf(func_name, sizeof(func_name), "action_%u_run", a->id);
+		p->action_funcs[a->id] = (action_func_t)dlsym(lib, func_name);
+		if (!p->action_funcs[a->id]) {
+			memset(p->action_funcs, 0, p->n_actions * sizeof(action_func_t));
+			dlclose(lib);
+			status = -ENOENT;
+			goto free;
+		}
+	}
+
+	p->codegen.lib = lib;
+	p->codegen.n_action_funcs = n_actions;
+
+free:
+	if (f)
+		fclose(f);
+	free(cmd);
+	unlink(src_path);
+	unlink(lib_path);
+	rmdir(tmp_dir);
+	return status;
+}
+
 /*
  * Action.
  */
@@ -8949,6 +7098,13 @@ action_build(struct rte_swx_pipeline *p)
 	TAILQ_FOREACH(action, &p->actions, node)
 		p->action_instructions[action->id] = action->instructions;
 
+	p->action_funcs = calloc(p->n_actions, sizeof(action_func_t));
+	CHECK(p->action_funcs, ENOMEM);
+
+	/* Not fatal: the actions without native code run in the interpreter. */
+	if (p->codegen.enabled)
+		action_codegen_build(p);
+
 	return 0;
 }
 
@@ -8957,6 +7113,14 @@ action_build_free(struct rte_swx_pipeline *p)
 {
 	free(p->action_instructions);
 	p->action_instructions = NULL;
+
+	free(p->action_funcs);
+	p->action_funcs = NULL;
+
+	if (p->codegen.lib)
+		dlclose(p->codegen.lib);
+	p->codegen.lib = NULL;
+	p->codegen.n_action_funcs = 0;
 }
 
 static void
@@ -10020,6 +8184,11 @@ rte_swx_pipeline_free(struct rte_swx_pipeline *p)
 	port_in_free(p);
 	struct_free(p);
 
+	free(p->codegen.dir);
+	free(p->codegen.cc);
+	free(p->codegen.cflags);
+	free(p->codegen.include_flags);
+
 	free(p);
 }
 
@@ -10045,6 +8214,102 @@ rte_swx_pipeline_instructions_config(struct rte_swx_pipeline *p,
 	return 0;
 }
 
+/* Translate a ':' separated list of directories into compiler -I options. */
+static char *
+codegen_include_flags(const char *include_path)
+{
+	char *path, *dir, *save, *flags;
+	size_t n_dirs = 1, pos = 0, size;
+	const char *s;
+
+	for (s = include_path; *s; s++)
+		if (*s == ':')
+			n_dirs++;
+
+	/* Each directory gets a " -I" prefix. */
+	size = strlen(include_path) + 3 * n_dirs + 1;
+	path = strdup(include_path);
+	flags = malloc(size);
+	if (!path || !flags) {
+		free(path);
+		free(flags);
+		return NULL;
+	}
+
+	flags[0] = 0;
+	for (dir = strtok_r(path, ":", &save); dir;
+	     dir = strtok_r(NULL, ":", &save))
+		pos += snprintf(&flags[pos], size - pos, " -I%s", dir);
+
+	free(path);
+	return flags;
+}
+
+int
+rte_swx_pipeline_codegen_enable(struct rte_swx_pipeline *p,
+				const struct rte_swx_pipeline_codegen_params *params)
+{
+	const char *dir = NULL, *cc = NULL, *cflags = NULL;
+	const char *include_path = NULL;
+	char *dir_copy, *cc_copy, *cflags_copy, *include_flags;
+
+	CHECK(p, EINVAL);
+	CHECK(p->build_done == 0, EEXIST);
+
+	if (params) {
+		dir = params->dir;
+		cc = params->cc;
+		cflags = params->cflags;
+		include_path = params->include_path;
+	}
+
+	if (!dir)
+		dir = "/tmp";
+	if (!cc)
+		cc = getenv("CC");
+	if (!cc)
+		cc = "cc";
+	if (!cflags)
+		cflags = "";
+	if (!include_path)
+		include_path = getenv(RTE_SWX_PIPELINE_INCLUDE_PATH_ENV);
+	if (!include_path)
+		include_path = RTE_SWX_PIPELINE_CODEGEN_INCLUDE_PATH;
+
+	dir_copy = strdup(dir);
+	cc_copy = strdup(cc);
+	cflags_copy = strdup(cflags);
+	include_flags = codegen_include_flags(include_path);
+	if (!dir_copy || !cc_copy || !cflags_copy || !include_flags) {
+		free(dir_copy);
+		free(cc_copy);
+		free(cflags_copy);
+		free(include_flags);
+		CHECK(0, ENOMEM);
+	}
+
+	free(p->codegen.dir);
+	free(p->codegen.cc);
+	free(p->codegen.cflags);
+	free(p->codegen.include_flags);
+
+	p->codegen.dir = dir_copy;
+	p->codegen.cc = cc_copy;
+	p->codegen.cflags = cflags_copy;
+	p->codegen.include_flags = include_flags;
+	p->codegen.enabled = 1;
+
+	return 0;
+}
+
+int
+rte_swx_pipeline_codegen_action_count(struct rte_swx_pipeline *p)
+{
+	CHECK(p, EINVAL);
+
+	return (int)p->codegen.n_action_funcs;
+}
+
 int
 rte_swx_pipeline_build(struct rte_swx_pipeline *p)
 {
@@ -678,6 +678,76 @@ rte_swx_pipeline_instructions_config(struct rte_swx_pipeline *p,
 				     const char **instructions,
 				     uint32_t n_instructions);
 
+/** Environment variable with the default code generation include path. */
+#define RTE_SWX_PIPELINE_INCLUDE_PATH_ENV "RTE_SWX_PIPELINE_INCLUDE_PATH"
+
+/** Pipeline action code generation parameters. */
+struct rte_swx_pipeline_codegen_params {
+	/** Directory where a private temporary directory, holding the C
+	 * source and shared object files, is created. When NULL, "/tmp" is
+	 * used.
+	 */
+	const char *dir;
+
+	/** C compiler command. When NULL, the CC environment variable is used
+	 * when set, otherwise "cc".
+	 */
+	const char *cc;
+
+	/** Additional compiler flags. Can be NULL. */
+	const char *cflags;
+
+	/** Directories of the DPDK header files, separated by ':'. When NULL,
+	 * the RTE_SWX_PIPELINE_INCLUDE_PATH environment variable is used when
+	 * set, otherwise the directories where the DPDK header files are
+	 * installed. This allows the code generation to work in a DPDK tree
+	 * that is not installed.
+	 */
+	const char *include_path;
+};
+
+/**
+ * Pipeline action code generation enable
+ *
+ * When enabled, the pipeline build operation translates the pipeline actions
+ * into C code, compiles this code into a shared object using the system C
+ * compiler and loads it, so that these actions are no longer run by the
+ * instruction interpreter. Only the actions made up of instructions that never
+ * yield the pipeline thread are translated, i.e. the actions that call extern
+ * objects or functions are always interpreted. When the code generation, the
+ * compilation or the loading fails, the pipeline build operation does not fail
+ * and all the actions are interpreted.
+ *
+ * @param[in] p
+ *   Pipeline handle.
+ * @param[in] params
+ *   Code generation parameters. Can be NULL, in which case the defaults
+ *   described for each parameter are used.
+ * @return
+ *   0 on success or the following error codes otherwise:
+ *   -EINVAL: Invalid argument;
+ *   -ENOMEM: Not enough space/cannot allocate memory;
+ *   -EEXIST: Pipeline was already built successfully.
+ */
+__rte_experimental
+int
+rte_swx_pipeline_codegen_enable(struct rte_swx_pipeline *p,
+				const struct rte_swx_pipeline_codegen_params *params);
+
+/**
+ * Pipeline action code generation status
+ *
+ * @param[in] p
+ *   Pipeline handle.
+ * @return
+ *   Number of pipeline actions that run as native code (zero when the code
+ *   generation is not enabled, failed or the pipeline is not built yet) or
+ *   -EINVAL on invalid argument.
+ */
+__rte_experimental
+int
+rte_swx_pipeline_codegen_action_count(struct rte_swx_pipeline *p);
+
 /**
  * Pipeline build
  *
@@ -7,6 +7,7 @@
 
 #include <rte_string_fns.h>
 #include <rte_log.h>
+#include <rte_pause.h>
 #include <rte_mbuf.h>
 #include <rte_mbuf_dyn.h>
 #include <rte_eal_memconfig.h>
@@ -33,6 +34,21 @@ EAL_REGISTER_TAILQ(rte_reorder_tailq)
 #define RTE_REORDER_SEQN_DYNFIELD_NAME "rte_reorder_seqn_dynfield"
 int rte_reorder_seqn_dynfield_offset = -1;
 
+/*
+ * State of an order_buf slot in multi-producer insert mode, holding the
+ * sequence number the slot is waiting for and whether its mbuf is stored.
+ */
+#define RO_SLOT_EMPTY 0 /**< waiting for the mbuf of the sequence number */
+#define RO_SLOT_BUSY 1  /**< mbuf being stored by a producer */
+#define RO_SLOT_READY 2 /**< mbuf stored, to be drained */
+#define RO_SLOT(seqn, state) (((uint64_t)(seqn) << 2) | (state))
+#define RO_SLOT_SEQN(slot) ((uint32_t)((slot) >> 2))
+#define RO_SLOT_STATE(slot) ((slot) & 3)
+
+/* Values of is_initialized in multi-producer insert mode */
+#define RO_MP_INITIALIZING 1
+#define RO_MP_INITIALIZED 2
+
 /* A generic circular buffer */
 struct cir_buffer {
 	unsigned int size;   /**< Number of entries that can be stored */
@@ -50,18 +66,32 @@ struct rte_reorder_buffer {
 	struct cir_buffer ready_buf; /**< temp buffer for dequeued entries */
 	struct cir_buffer order_buf; /**< buffer used to reorder entries */
 	int is_initialized;
+	unsigned int flags; /**< RTE_REORDER_F_* flags given on creation */
+	/** Highest sequence number producers failed to insert as too early */
+	uint32_t skip_seqn;
+	uint64_t *slot_state; /**< order_buf slots state, MP insert mode only */
 } __rte_cache_aligned;
 
 static void
 rte_reorder_free_mbufs(struct rte_reorder_buffer *b);
 
-struct rte_reorder_buffer *
-rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
-		const char *name, unsigned int size)
+static unsigned int
+reorder_memsize(unsigned int size, unsigned int flags)
 {
-	const unsigned int min_bufsize = sizeof(*b) +
+	unsigned int memsize = sizeof(struct rte_reorder_buffer) +
 					(2 * size * sizeof(struct rte_mbuf *));
 
+	if (flags & RTE_REORDER_F_MP_INSERT)
+		memsize += size * sizeof(uint64_t);
+	return memsize;
+}
+
+static struct rte_reorder_buffer *
+reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
+		const char *name, unsigned int size, unsigned int flags)
+{
+	const unsigned int min_bufsize = reorder_memsize(size, flags);
+
 	if (b == NULL) {
 		RTE_LOG(ERR, REORDER, "Invalid reorder buffer parameter:"
 					" NULL\n");
@@ -95,18 +125,29 @@ rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 	b->ready_buf.entries = (void *)&b[1];
 	b->order_buf.entries = RTE_PTR_ADD(&b[1],
 			size * sizeof(b->ready_buf.entries[0]));
+	b->flags = flags;
+	if (flags & RTE_REORDER_F_MP_INSERT)
+		b->slot_state = RTE_PTR_ADD(b->order_buf.entries,
+				size * sizeof(b->order_buf.entries[0]));
 
 	return b;
 }
 
-struct rte_reorder_buffer*
-rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+struct rte_reorder_buffer *
+rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
+		const char *name, unsigned int size)
+{
+	return reorder_init(b, bufsize, name, size, 0);
+}
+
+struct rte_reorder_buffer *
+rte_reorder_create_flags(const char *name, unsigned int socket_id,
+		unsigned int size, unsigned int flags)
 {
 	struct rte_reorder_buffer *b = NULL;
 	struct rte_tailq_entry *te;
 	struct rte_reorder_list *reorder_list;
-	const unsigned int bufsize = sizeof(struct rte_reorder_buffer) +
-					(2 * size * sizeof(struct rte_mbuf *));
+	const unsigned int bufsize = reorder_memsize(size, flags);
 	static const struct rte_mbuf_dynfield reorder_seqn_dynfield_desc = {
 		.name = RTE_REORDER_SEQN_DYNFIELD_NAME,
 		.size = sizeof(rte_reorder_seqn_t),
@@ -128,6 +169,12 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 		rte_errno = EINVAL;
 		return NULL;
 	}
+	if (flags & ~RTE_REORDER_F_MP_INSERT) {
+		RTE_LOG(ERR, REORDER, "Invalid reorder buffer flags: 0x%x\n",
+				flags);
+		rte_errno = EINVAL;
+		return NULL;
+	}
 
 	rte_reorder_seqn_dynfield_offset =
 		rte_mbuf_dynfield_register(&reorder_seqn_dynfield_desc);
@@ -164,7 +211,7 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 		rte_errno = ENOMEM;
 		rte_free(te);
 	} else {
-		rte_reorder_init(b, bufsize, name, size);
+		reorder_init(b, bufsize, name, size, flags);
 		te->data = (void *)b;
 		TAILQ_INSERT_TAIL(reorder_list, te, next);
 	}
@@ -174,6 +221,12 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 	return b;
 }
 
+struct rte_reorder_buffer*
+rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+{
+	return rte_reorder_create_flags(name, socket_id, size, 0);
+}
+
 void
 rte_reorder_reset(struct rte_reorder_buffer *b)
 {
@@ -182,7 +235,7 @@ rte_reorder_reset(struct rte_reorder_buffer *b)
 	rte_reorder_free_mbufs(b);
 	strlcpy(name, b->name, sizeof(name));
 	/* No error checking as current values should be valid */
-	rte_reorder_init(b, b->memsize, name, b->order_buf.size);
+	reorder_init(b, b->memsize, name, b->order_buf.size, b->flags);
 }
 
 static void
@@ -314,22 +367,11 @@ rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 	return order_head_adv;
 }
 
-int
-rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+static inline int
+reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 {
 	uint32_t offset, position;
-	struct cir_buffer *order_buf;
-
-	if (b == NULL || mbuf == NULL) {
-		rte_errno = EINVAL;
-		return -1;
-	}
-
-	order_buf = &b->order_buf;
-	if (!b->is_initialized) {
-		b->min_seqn = *rte_reorder_seqn(mbuf);
-		b->is_initialized = 1;
-	}
+	struct cir_buffer *order_buf = &b->order_buf;
 
 	/*
 	 * calculate the offset from the head pointer we need to go.
@@ -380,6 +422,205 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 	return 0;
 }
 
+/*
+ * Multi-producer insert mode.
+ *
+ * The window starts at the sequence number of the first inserted mbuf, and
+ * order_buf slot (seqn & mask) is reserved to seqn. Each slot state holds the
+ * sequence number the slot is waiting for: producers claim an empty slot
+ * with a compare-and-swap before storing the mbuf, so that the consumer
+ * cannot skip the slot meanwhile. The consumer hands the slot over to the
+ * sequence number of the next window once drained or skipped. As only the consumer
+ * moves the window, producers with too early mbufs raise skip_seqn instead,
+ * asking the consumer to skip the missing mbufs in its next drain.
+ */
+static void
+reorder_mp_start(struct rte_reorder_buffer *b, uint32_t seqn)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	int expected = 0;
+	unsigned int i;
+
+	if (__atomic_compare_exchange_n(&b->is_initialized, &expected,
+			RO_MP_INITIALIZING, 0, __ATOMIC_ACQUIRE,
+			__ATOMIC_ACQUIRE)) {
+		b->min_seqn = seqn;
+		b->skip_seqn = seqn;
+		order_buf->head = seqn & order_buf->mask;
+		for (i = 0; i < order_buf->size; i++)
+			b->slot_state[(seqn + i) & order_buf->mask] =
+					RO_SLOT(seqn + i, RO_SLOT_EMPTY);
+		__atomic_store_n(&b->is_initialized, RO_MP_INITIALIZED,
+				__ATOMIC_RELEASE);
+		return;
+	}
+
+	while (__atomic_load_n(&b->is_initialized, __ATOMIC_ACQUIRE) !=
+			RO_MP_INITIALIZED)
+		rte_pause();
+}
+
+static inline int
+reorder_mp_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	uint32_t seqn = *rte_reorder_seqn(mbuf);
+	uint32_t position = seqn & order_buf->mask;
+	uint64_t *slot = &b->slot_state[position];
+	uint64_t state;
+	uint32_t skip;
+	int32_t offset;
+
+	state = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+	offset = seqn - RO_SLOT_SEQN(state);
+
+	if (likely(offset == 0)) {
+		if (RO_SLOT_STATE(state) == RO_SLOT_EMPTY &&
+				__atomic_compare_exchange_n(slot, &state,
+					RO_SLOT(seqn, RO_SLOT_BUSY), 0,
+					__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			order_buf->entries[position] = mbuf;
+			__atomic_store_n(slot, RO_SLOT(seqn, RO_SLOT_READY),
+					__ATOMIC_RELEASE);
+			return 0;
+		}
+		/* duplicate, or skipped by the consumer meanwhile */
+		rte_errno = ERANGE;
+		return -1;
+	}
+
+	/*
+	 * The slot still waits for the mbuf of a previous window: the mbuf
+	 * can be inserted once the consumer has drained or skipped up to it.
+	 */
+	if (offset > 0) {
+		skip = __atomic_load_n(&b->skip_seqn, __ATOMIC_RELAXED);
+		while ((int32_t)(seqn - skip) > 0 &&
+				!__atomic_compare_exchange_n(&b->skip_seqn,
+					&skip, seqn, 1, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED))
+			;
+		rte_errno = ENOSPC;
+		return -1;
+	}
+
+	/* Put in handling for enqueue straight to output */
+	rte_errno = ERANGE;
+	return -1;
+}
+
+static unsigned int
+reorder_mp_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	unsigned int drain_cnt = 0;
+	uint64_t *slot, state, next;
+	uint32_t skip;
+
+	if (__atomic_load_n(&b->is_initialized, __ATOMIC_ACQUIRE) !=
+			RO_MP_INITIALIZED)
+		return 0;
+
+	skip = __atomic_load_n(&b->skip_seqn, __ATOMIC_RELAXED);
+	while (drain_cnt < max_mbufs) {
+		slot = &b->slot_state[order_buf->head];
+		state = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+		next = RO_SLOT(b->min_seqn + order_buf->size, RO_SLOT_EMPTY);
+
+		if (RO_SLOT_STATE(state) == RO_SLOT_READY) {
+			mbufs[drain_cnt++] = order_buf->entries[order_buf->head];
+			order_buf->entries[order_buf->head] = NULL;
+			__atomic_store_n(slot, next, __ATOMIC_RELEASE);
+		} else if (RO_SLOT_STATE(state) == RO_SLOT_BUSY ||
+				(int32_t)(skip - b->min_seqn) <
+					(int32_t)order_buf->size ||
+				!__atomic_compare_exchange_n(slot, &state,
+					next, 0, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED)) {
+			/*
+			 * Wait for the mbuf, unless a later one needs room
+			 * and no producer has claimed the slot meanwhile.
+			 */
+			break;
+		}
+
+		b->min_seqn++;
+		order_buf->head = (order_buf->head + 1) & order_buf->mask;
+	}
+
+	return drain_cnt;
+}
+
+int
+rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+{
+	if (b == NULL || mbuf == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	if (b->flags & RTE_REORDER_F_MP_INSERT) {
+		if (unlikely(__atomic_load_n(&b->is_initialized,
+				__ATOMIC_ACQUIRE) != RO_MP_INITIALIZED))
+			reorder_mp_start(b, *rte_reorder_seqn(mbuf));
+		return reorder_mp_insert(b, mbuf);
+	}
+
+	if (!b->is_initialized) {
+		b->min_seqn = *rte_reorder_seqn(mbuf);
+		b->is_initialized = 1;
+	}
+
+	return reorder_insert(b, mbuf);
+}
+
+unsigned int
+rte_reorder_insert_burst(struct rte_reorder_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs)
+{
+	struct cir_buffer *order_buf;
+	uint32_t offset;
+	unsigned int i;
+
+	if (b == NULL || (mbufs == NULL && nb_mbufs != 0)) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+	if (nb_mbufs == 0)
+		return 0;
+
+	if (b->flags & RTE_REORDER_F_MP_INSERT) {
+		if (unlikely(__atomic_load_n(&b->is_initialized,
+				__ATOMIC_ACQUIRE) != RO_MP_INITIALIZED))
+			reorder_mp_start(b, *rte_reorder_seqn(mbufs[0]));
+		for (i = 0; i < nb_mbufs; i++)
+			if (reorder_mp_insert(b, mbufs[i]) < 0)
+				break;
+		return i;
+	}
+
+	order_buf = &b->order_buf;
+	if (!b->is_initialized) {
+		b->min_seqn = *rte_reorder_seqn(mbufs[0]);
+		b->is_initialized = 1;
+	}
+
+	for (i = 0; i < nb_mbufs; i++) {
+		/* mbufs within the window are stored right away */
+		offset = *rte_reorder_seqn(mbufs[i]) - b->min_seqn;
+		if (likely(offset < order_buf->size)) {
+			order_buf->entries[(order_buf->head + offset) &
+					order_buf->mask] = mbufs[i];
+			continue;
+		}
+		if (reorder_insert(b, mbufs[i]) < 0)
+			break;
+	}
+
+	return i;
+}
+
 unsigned int
 rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 		unsigned max_mbufs)
@@ -389,6 +630,9 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 	struct cir_buffer *order_buf = &b->order_buf,
 			*ready_buf = &b->ready_buf;
 
+	if (b->flags & RTE_REORDER_F_MP_INSERT)
+		return reorder_mp_drain(b, mbufs, max_mbufs);
+
 	/* Try to fetch requested number of mbufs from ready buffer */
 	while ((drain_cnt < max_mbufs) && (ready_buf->tail != ready_buf->head)) {
 		mbufs[drain_cnt++] = ready_buf->entries[ready_buf->tail];
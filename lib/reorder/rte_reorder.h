@@ -27,6 +27,12 @@ struct rte_reorder_buffer;
 typedef uint32_t rte_reorder_seqn_t;
 extern int rte_reorder_seqn_dynfield_offset;
 
+/**
+ * Flag to create a reorder buffer where mbufs can be inserted by several
+ * threads concurrently, while a single thread drains it.
+ */
+#define RTE_REORDER_F_MP_INSERT 0x0001
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -66,6 +72,41 @@ rte_reorder_seqn(struct rte_mbuf *mbuf)
 struct rte_reorder_buffer *
 rte_reorder_create(const char *name, unsigned socket_id, unsigned int size);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new reorder buffer instance with flags
+ *
+ * Same as rte_reorder_create(), with flags selecting the mode of the buffer.
+ *
+ * With RTE_REORDER_F_MP_INSERT, rte_reorder_insert() and
+ * rte_reorder_insert_burst() may be called by several threads concurrently,
+ * while rte_reorder_drain() is called by a single thread. In this mode, an
+ * early mbuf outside of the window is not inserted and ENOSPC is returned,
+ * until the draining thread skips the missing mbufs preventing the window
+ * to move.
+ *
+ * @param name
+ *   The name to be given to the reorder buffer instance.
+ * @param socket_id
+ *   The NUMA node on which the memory for the reorder buffer
+ *   instance is to be reserved.
+ * @param size
+ *   Max number of elements that can be stored in the reorder buffer
+ * @param flags
+ *   0, or RTE_REORDER_F_MP_INSERT.
+ * @return
+ *   The initialized reorder buffer instance, or NULL on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ *    - EINVAL - invalid parameters
+ */
+__rte_experimental
+struct rte_reorder_buffer *
+rte_reorder_create_flags(const char *name, unsigned int socket_id,
+		unsigned int size, unsigned int flags);
+
 /**
  * Initializes given reorder buffer instance
  *
@@ -146,6 +187,31 @@ rte_reorder_free(struct rte_reorder_buffer *b);
 int
 rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Insert a burst of mbufs in reorder buffer in their correct positions
+ *
+ * Same as calling rte_reorder_insert() for each mbuf, stopping at the first
+ * mbuf which cannot be inserted.
+ *
+ * @param b
+ *   Reorder buffer where the mbufs have to be inserted.
+ * @param mbufs
+ *   Array of mbufs of packets that need to be inserted in reorder buffer.
+ * @param nb_mbufs
+ *   Number of mbufs in the array.
+ * @return
+ *   Number of mbufs inserted, from the start of the array. If less than
+ *   nb_mbufs, rte_errno is set as by rte_reorder_insert() for the first
+ *   mbuf not inserted, or to EINVAL on invalid parameters.
+ */
+__rte_experimental
+unsigned int
+rte_reorder_insert_burst(struct rte_reorder_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs);
+
 /**
  * Fetch reordered buffers
  *
@@ -154,6 +220,9 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf);
  * delayed too long before reaching the reorder window, or have been previously
  * dropped by the system.
  *
+ * This function must not be called by several threads concurrently, even
+ * for a reorder buffer created with RTE_REORDER_F_MP_INSERT.
+ *
  * @param b
  *   Reorder buffer instance from which packets are to be drained
  * @param mbufs
@@ -0,0 +1,173 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_string_fns.h>
+
+#include "rte_ring.h"
+#include "rte_ring_elem.h"
+#include "rte_ring_elastic.h"
+
+/* create the next ring of the elastic ring */
+static struct rte_ring *
+ring_elastic_create_ring(struct rte_ring_elastic *er, unsigned int count)
+{
+	char name[RTE_RING_NAMESIZE];
+	struct rte_ring *r;
+	int ret;
+
+	ret = snprintf(name, sizeof(name), "%s_%u", er->name, er->nb_rings);
+	if (ret < 0 || ret >= (int)sizeof(name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	r = rte_ring_create_elem(name, er->esize, count, er->socket_id,
+			er->flags);
+	if (r == NULL) {
+		/* the invalid sizes are reported as negative values */
+		if (rte_errno < 0)
+			rte_errno = -rte_errno;
+		return NULL;
+	}
+
+	er->rings[er->nb_rings++] = r;
+	return r;
+}
+
+/* create the elastic ring */
+struct rte_ring_elastic *
+rte_ring_elastic_create(const char *name, unsigned int esize,
+		unsigned int count, int socket_id, unsigned int flags)
+{
+	char ring_name[RTE_RING_NAMESIZE];
+	struct rte_ring_elastic *er;
+	int ret;
+
+	if (name == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	/* the name of the last ring must fit */
+	ret = snprintf(ring_name, sizeof(ring_name), "%s_%u", name,
+			RTE_RING_ELASTIC_MAX_RINGS - 1);
+	if (ret < 0 || ret >= (int)sizeof(ring_name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	er = rte_zmalloc_socket("RING_ELASTIC", sizeof(*er),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (er == NULL) {
+		RTE_LOG(ERR, RING, "Cannot reserve memory for elastic ring\n");
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	strlcpy(er->name, name, sizeof(er->name));
+	er->esize = esize;
+	er->flags = flags;
+	er->socket_id = socket_id;
+
+	er->ring = ring_elastic_create_ring(er, count);
+	if (er->ring == NULL) {
+		rte_free(er);
+		return NULL;
+	}
+
+	return er;
+}
+
+/* free the elastic ring */
+void
+rte_ring_elastic_free(struct rte_ring_elastic *er)
+{
+	unsigned int i;
+
+	if (er == NULL)
+		return;
+
+	for (i = 0; i < er->nb_rings; i++)
+		rte_ring_free(er->rings[i]);
+	rte_free(er);
+}
+
+/* link a larger ring to the elastic ring */
+int
+rte_ring_elastic_grow(struct rte_ring_elastic *er, unsigned int count)
+{
+	struct rte_ring *r, *old;
+
+	if (er == NULL || count <= rte_ring_get_capacity(er->ring))
+		return -EINVAL;
+
+	/* the consumers may not have found the sealed ring empty yet */
+	old = __atomic_load_n(&er->old, __ATOMIC_ACQUIRE);
+	if (old != NULL && (er->sealed != old || !rte_ring_empty(old)))
+		return -EBUSY;
+
+	if (er->nb_rings == RTE_RING_ELASTIC_MAX_RINGS)
+		return -ENOSPC;
+
+	r = ring_elastic_create_ring(er, count);
+	if (r == NULL) {
+		RTE_LOG(ERR, RING, "Cannot grow elastic ring %s: %s\n",
+			er->name, rte_strerror(rte_errno));
+		return -rte_errno;
+	}
+
+	/* the consumers reading the new ring also read the previous one */
+	__atomic_store_n(&er->old, er->ring, __ATOMIC_RELEASE);
+	__atomic_store_n(&er->ring, r, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/* seal the ring replaced by the last growth */
+void
+rte_ring_elastic_seal(struct rte_ring_elastic *er)
+{
+	struct rte_ring *old;
+
+	old = __atomic_load_n(&er->old, __ATOMIC_RELAXED);
+	if (old == NULL || er->sealed == old)
+		return;
+
+	/* order the objects of the late producers before the seal */
+	__atomic_store_n(&er->sealed, old, __ATOMIC_RELEASE);
+}
+
+/* dump the status of the elastic ring on the console */
+void
+rte_ring_elastic_dump(FILE *f, const struct rte_ring_elastic *er)
+{
+	const struct rte_ring *r, *old;
+	unsigned int i;
+
+	r = __atomic_load_n(&er->ring, __ATOMIC_ACQUIRE);
+	old = __atomic_load_n(&er->old, __ATOMIC_ACQUIRE);
+
+	fprintf(f, "elastic ring <%s>@%p\n", er->name, er);
+	fprintf(f, "  esize=%u\n", er->esize);
+	fprintf(f, "  flags=%x\n", er->flags);
+	fprintf(f, "  nb_rings=%u\n", er->nb_rings);
+	fprintf(f, "  ring=<%s>@%p\n", r->name, r);
+	if (old != NULL)
+		fprintf(f, "  old=<%s>@%p sealed=%d\n", old->name, old,
+			__atomic_load_n(&er->sealed, __ATOMIC_RELAXED) == old);
+
+	for (i = 0; i < er->nb_rings; i++)
+		fprintf(f, "  ring %u: <%s>@%p capacity=%u used=%u\n", i,
+			er->rings[i]->name, er->rings[i],
+			rte_ring_get_capacity(er->rings[i]),
+			rte_ring_count(er->rings[i]));
+}
@@ -0,0 +1,435 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_RING_ELASTIC_H_
+#define _RTE_RING_ELASTIC_H_
+
+/**
+ * @file
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * RTE Elastic Ring
+ *
+ * An elastic ring is a ring whose capacity can grow while it is in use,
+ * so that it does not have to be sized for the worst burst at creation.
+ *
+ * Growing links a larger ring: the producers enqueue to the new ring,
+ * while the consumers first drain the previous ring, then dequeue from
+ * the new one. The objects are never copied between the rings and the
+ * FIFO order is kept across a growth.
+ *
+ * A producer may still enqueue to the previous ring for a short time after
+ * the growth. The consumers stop waiting for such objects once the
+ * previous ring is sealed with rte_ring_elastic_seal(), which the
+ * application calls when no producer can still use the previous ring:
+ * for instance after a grace period of an RCU QSBR variable the producers
+ * report their quiescent state to, or right after the growth when the
+ * thread growing the ring is the only producer.
+ *
+ * The rings are freed with the elastic ring, the consumers never wait for
+ * each other. As the capacity at least doubles at each growth, the
+ * previous rings use less memory than the current one.
+ *
+ * The rings keep the sync modes requested at creation. They must only be
+ * accessed with the elastic ring API.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_ring_elem.h>
+
+/** Maximum number of rings of an elastic ring, i.e. of growths plus one. */
+#define RTE_RING_ELASTIC_MAX_RINGS 32
+
+/**
+ * A ring whose capacity can grow online.
+ */
+struct rte_ring_elastic {
+	char name[RTE_RING_NAMESIZE] __rte_cache_aligned; /**< Name. */
+	unsigned int esize;     /**< Size of an element, in bytes. */
+	unsigned int flags;     /**< Flags of the rings. */
+	int socket_id;          /**< Socket of the rings. */
+	unsigned int nb_rings;  /**< Number of rings created. */
+	/** Rings created, freed with the elastic ring. */
+	struct rte_ring *rings[RTE_RING_ELASTIC_MAX_RINGS];
+
+	/** Ring the objects are enqueued to. */
+	struct rte_ring *ring __rte_cache_aligned;
+	/** Previous ring, drained first, NULL once empty. */
+	struct rte_ring *old;
+	/** Previous ring once sealed. */
+	struct rte_ring *sealed;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create an elastic ring.
+ *
+ * @param name
+ *   The name of the elastic ring. Its rings are named after it.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4,
+ *   sizeof(void *) for the functions enqueuing pointers.
+ * @param count
+ *   The initial size of the ring, see rte_ring_create_elem().
+ * @param socket_id
+ *   The *socket_id* argument is the socket identifier in case of
+ *   NUMA. The value can be *SOCKET_ID_ANY* if there is no NUMA
+ *   constraint for the reserved zone.
+ * @param flags
+ *   The flags of the rings, see rte_ring_create_elem().
+ * @return
+ *   On success, the pointer to the new elastic ring. NULL on error with
+ *    rte_errno set appropriately. Possible errno values include:
+ *    - EINVAL - esize, count or flags are invalid
+ *    - ENAMETOOLONG - the name is too long
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ *    - EEXIST - a ring with the same name already exists
+ */
+__rte_experimental
+struct rte_ring_elastic *
+rte_ring_elastic_create(const char *name, unsigned int esize,
+		unsigned int count, int socket_id, unsigned int flags);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free an elastic ring and its rings.
+ *
+ * @param er
+ *   Elastic ring to free, or NULL.
+ */
+__rte_experimental
+void
+rte_ring_elastic_free(struct rte_ring_elastic *er);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Grow an elastic ring.
+ *
+ * A ring of the new size is linked and the producers enqueue to it from
+ * now on. The consumers dequeue from it once the current ring is drained
+ * and sealed with rte_ring_elastic_seal().
+ *
+ * This function is not multi-thread safe with the other calls growing or
+ * sealing the same elastic ring, but the ring may be used while it grows.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ * @param count
+ *   The new size of the ring, larger than its capacity.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: invalid parameters.
+ *   - -EBUSY: the previous growth is not complete, the ring it replaced
+ *     is not sealed or not drained yet.
+ *   - -ENOSPC: the elastic ring already has RTE_RING_ELASTIC_MAX_RINGS
+ *     rings.
+ *   - -ENOMEM: the new ring cannot be allocated.
+ */
+__rte_experimental
+int
+rte_ring_elastic_grow(struct rte_ring_elastic *er, unsigned int count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Seal the ring replaced by the last growth of an elastic ring.
+ *
+ * It must be called once no producer can enqueue to the previous ring
+ * anymore: the consumers then move to the new ring as soon as they find
+ * the previous one empty. Until then, they wait for the objects of the
+ * late producers, to keep the FIFO order.
+ *
+ * This function is not multi-thread safe with the other calls growing or
+ * sealing the same elastic ring.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ */
+__rte_experimental
+void
+rte_ring_elastic_seal(struct rte_ring_elastic *er);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dump the status of an elastic ring and of its rings.
+ *
+ * @param f
+ *   A pointer to a file for output.
+ * @param er
+ *   A pointer to the elastic ring.
+ */
+__rte_experimental
+void
+rte_ring_elastic_dump(FILE *f, const struct rte_ring_elastic *er);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Return the number of objects in an elastic ring.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ * @return
+ *   The number of objects in the current and previous rings.
+ */
+__rte_experimental
+static inline unsigned int
+rte_ring_elastic_count(const struct rte_ring_elastic *er)
+{
+	const struct rte_ring *r, *old;
+	unsigned int count;
+
+	r = __atomic_load_n(&er->ring, __ATOMIC_ACQUIRE);
+	old = __atomic_load_n(&er->old, __ATOMIC_ACQUIRE);
+	count = rte_ring_count(r);
+	if (old != NULL && old != r)
+		count += rte_ring_count(old);
+	return count;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Return the capacity of an elastic ring, i.e. of its current ring.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ * @return
+ *   The number of objects the current ring can store.
+ */
+__rte_experimental
+static inline unsigned int
+rte_ring_elastic_get_capacity(const struct rte_ring_elastic *er)
+{
+	return rte_ring_get_capacity(__atomic_load_n(&er->ring,
+				__ATOMIC_ACQUIRE));
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue several objects on an elastic ring.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued, either 0 or n
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_elastic_enqueue_bulk_elem(struct rte_ring_elastic *er,
+		const void *obj_table, unsigned int esize, unsigned int n,
+		unsigned int *free_space)
+{
+	return rte_ring_enqueue_bulk_elem(__atomic_load_n(&er->ring,
+				__ATOMIC_ACQUIRE), obj_table, esize, n,
+			free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue several objects on an elastic ring.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued, either 0 or n
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_elastic_enqueue_bulk(struct rte_ring_elastic *er,
+		void * const *obj_table, unsigned int n,
+		unsigned int *free_space)
+{
+	return rte_ring_elastic_enqueue_bulk_elem(er, obj_table,
+			sizeof(void *), n, free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue up to n objects on an elastic ring.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   - n: Actual number of objects enqueued.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_elastic_enqueue_burst_elem(struct rte_ring_elastic *er,
+		const void *obj_table, unsigned int esize, unsigned int n,
+		unsigned int *free_space)
+{
+	return rte_ring_enqueue_burst_elem(__atomic_load_n(&er->ring,
+				__ATOMIC_ACQUIRE), obj_table, esize, n,
+			free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue up to n objects on an elastic ring.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   - n: Actual number of objects enqueued.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_elastic_enqueue_burst(struct rte_ring_elastic *er,
+		void * const *obj_table, unsigned int n,
+		unsigned int *free_space)
+{
+	return rte_ring_elastic_enqueue_burst_elem(er, obj_table,
+			sizeof(void *), n, free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dequeue up to n objects from an elastic ring.
+ *
+ * While the ring replaced by the last growth is not drained, the objects
+ * are dequeued from it. Once it is empty, nothing is dequeued until it is
+ * sealed, then the objects are dequeued from the current ring.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ * @param obj_table
+ *   A pointer to a table of objects that will be filled.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to dequeue from the ring to the obj_table.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished, in the ring the objects were dequeued from.
+ * @return
+ *   - n: Actual number of objects dequeued, 0 if ring is empty
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_elastic_dequeue_burst_elem(struct rte_ring_elastic *er,
+		void *obj_table, unsigned int esize, unsigned int n,
+		unsigned int *available)
+{
+	struct rte_ring *r, *old;
+	unsigned int nb;
+	int sealed;
+
+	/* the previous ring is read after the current one, see grow */
+	r = __atomic_load_n(&er->ring, __ATOMIC_ACQUIRE);
+	old = __atomic_load_n(&er->old, __ATOMIC_ACQUIRE);
+
+	if (unlikely(old != NULL && old != r)) {
+		/* once sealed, an empty previous ring remains empty */
+		sealed = __atomic_load_n(&er->sealed, __ATOMIC_ACQUIRE) == old;
+		nb = rte_ring_dequeue_burst_elem(old, obj_table, esize, n,
+				available);
+		if (nb != 0 || !sealed)
+			return nb;
+		/* the previous ring is drained, move to the current one */
+		__atomic_compare_exchange_n(&er->old, &old, NULL, 0,
+				__ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	}
+
+	return rte_ring_dequeue_burst_elem(r, obj_table, esize, n, available);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dequeue up to n objects from an elastic ring.
+ *
+ * @param er
+ *   A pointer to the elastic ring.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The number of objects to dequeue from the ring to the obj_table.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   dequeue has finished, in the ring the objects were dequeued from.
+ * @return
+ *   - n: Actual number of objects dequeued, 0 if ring is empty
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_elastic_dequeue_burst(struct rte_ring_elastic *er,
+		void **obj_table, unsigned int n, unsigned int *available)
+{
+	return rte_ring_elastic_dequeue_burst_elem(er, obj_table,
+			sizeof(void *), n, available);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RING_ELASTIC_H_ */
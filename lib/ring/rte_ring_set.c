@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_string_fns.h>
+
+#include "rte_ring.h"
+#include "rte_ring_set.h"
+
+/* create the ring set */
+struct rte_ring_set *
+rte_ring_set_create(const char *name, unsigned int max_rings, int socket_id,
+		unsigned int flags)
+{
+	struct rte_ring_set *set;
+	size_t doorbell_size;
+	size_t set_size;
+	int ret;
+
+	if (name == NULL || max_rings == 0 ||
+			max_rings > RTE_RING_SET_MAX_RINGS) {
+		RTE_LOG(ERR, RING, "Invalid ring set parameters\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	if (flags & ~RTE_RING_SET_F_MASK) {
+		RTE_LOG(ERR, RING,
+			"Unsupported ring set flags requested %#x\n", flags);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	/* the doorbell and the rings table follow the set structure */
+	doorbell_size = RTE_ALIGN_CEIL(max_rings, __RTE_RING_SET_WORD_BITS) /
+		__RTE_RING_SET_WORD_BITS * sizeof(uint64_t);
+	doorbell_size = RTE_ALIGN_CEIL(doorbell_size, RTE_CACHE_LINE_SIZE);
+	set_size = sizeof(*set) + doorbell_size +
+		max_rings * sizeof(struct rte_ring *);
+
+	set = rte_zmalloc_socket("RING_SET", set_size, RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (set == NULL) {
+		RTE_LOG(ERR, RING, "Cannot reserve memory for ring set\n");
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	ret = strlcpy(set->name, name, sizeof(set->name));
+	if (ret < 0 || ret >= (int)sizeof(set->name)) {
+		rte_free(set);
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+	set->flags = flags;
+	set->max_rings = max_rings;
+	set->rings = RTE_PTR_ADD(set->doorbell, doorbell_size);
+
+	return set;
+}
+
+/* free the ring set */
+void
+rte_ring_set_free(struct rte_ring_set *set)
+{
+	rte_free(set);
+}
+
+/* add a ring to the ring set */
+int
+rte_ring_set_add(struct rte_ring_set *set, struct rte_ring *r)
+{
+	unsigned int idx;
+
+	if (set == NULL || r == NULL)
+		return -EINVAL;
+
+	idx = set->nb_rings;
+	if (idx == set->max_rings)
+		return -ENOSPC;
+
+	set->rings[idx] = r;
+	/* objects may already be in the ring */
+	if (rte_ring_count(r) != 0)
+		__atomic_fetch_or(&set->doorbell[idx / __RTE_RING_SET_WORD_BITS],
+				  UINT64_C(1) << (idx % __RTE_RING_SET_WORD_BITS),
+				  __ATOMIC_RELAXED);
+
+	/* publish the ring to the consumers */
+	__atomic_store_n(&set->nb_rings, idx + 1, __ATOMIC_RELEASE);
+
+	return idx;
+}
+
+/* dump the status of the ring set on the console */
+void
+rte_ring_set_dump(FILE *f, const struct rte_ring_set *set)
+{
+	unsigned int i, nb_rings;
+	uint64_t word;
+
+	nb_rings = __atomic_load_n(&set->nb_rings, __ATOMIC_ACQUIRE);
+
+	fprintf(f, "ring set <%s>@%p\n", set->name, set);
+	fprintf(f, "  flags=%x\n", set->flags);
+	fprintf(f, "  max_rings=%u\n", set->max_rings);
+	fprintf(f, "  nb_rings=%u\n", nb_rings);
+	fprintf(f, "  next=%u\n", set->next);
+
+	for (i = 0; i < nb_rings; i++) {
+		word = __atomic_load_n(&set->doorbell[i /
+				__RTE_RING_SET_WORD_BITS], __ATOMIC_RELAXED);
+		fprintf(f, "  ring %u: <%s>@%p doorbell=%u used=%u\n", i,
+			set->rings[i]->name, set->rings[i],
+			(unsigned int)(word >> (i % __RTE_RING_SET_WORD_BITS)) & 1,
+			rte_ring_count(set->rings[i]));
+	}
+}
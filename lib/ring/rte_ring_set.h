@@ -0,0 +1,489 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_RING_SET_H_
+#define _RTE_RING_SET_H_
+
+/**
+ * @file
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * RTE Ring Set
+ *
+ * A ring set groups the rings polled by a consumer, for instance the rings
+ * between a worker and each of the cores feeding it. The set keeps a
+ * doorbell bitmap, with one bit per ring, which producers set when they
+ * enqueue objects through the set. The consumer dequeues only from the
+ * rings whose bit is set, instead of reading the producer tail of every
+ * ring, most of which are usually empty.
+ *
+ * The consumer clears the bit of a ring when it finds the ring empty, then
+ * reads the ring again and sets the bit back if objects were enqueued
+ * meanwhile. A producer sets the bit after its enqueue, unless it is
+ * already set. So, as long as a ring is refilled before the consumer comes
+ * back to it, neither side writes its bit.
+ * Both sides use a full memory barrier between their ring access and their
+ * doorbell access, so that a ring with objects never stays with its bit
+ * cleared.
+ *
+ * The rings are served in turn (round-robin), or lowest index first when
+ * the set is created with RTE_RING_SET_F_PRIORITY.
+ *
+ * The rings keep their own sync modes. Objects enqueued in a ring of the
+ * set without the ring set API must be signalled with
+ * rte_ring_set_notify().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_atomic.h>
+#include <rte_ring.h>
+
+/** Maximum number of rings in a ring set. */
+#define RTE_RING_SET_MAX_RINGS 4096
+
+/**
+ * Serve the rings by priority: the ring with the lowest index which has
+ * objects is dequeued first. By default, the rings are served in turn.
+ */
+#define RTE_RING_SET_F_PRIORITY 0x0001
+
+/** @internal Mask of all the supported ring set flags. */
+#define RTE_RING_SET_F_MASK RTE_RING_SET_F_PRIORITY
+
+/** @internal Number of rings per doorbell word. */
+#define __RTE_RING_SET_WORD_BITS 64
+
+/**
+ * A set of rings polled by a consumer.
+ */
+struct rte_ring_set {
+	char name[RTE_RING_NAMESIZE] __rte_cache_aligned; /**< Name. */
+	unsigned int flags;       /**< Flags supplied at creation. */
+	unsigned int max_rings;   /**< Maximum number of rings. */
+	unsigned int nb_rings;    /**< Number of rings added. */
+	struct rte_ring **rings;  /**< Rings, by index. */
+
+	/** Index of the next ring to serve, in round-robin mode. */
+	unsigned int next __rte_cache_aligned;
+
+	/** Doorbell bitmap: a bit per ring which may have objects. */
+	uint64_t doorbell[] __rte_cache_aligned;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a ring set.
+ *
+ * The rings are added to the set with rte_ring_set_add().
+ *
+ * @param name
+ *   The name of the ring set.
+ * @param max_rings
+ *   The maximum number of rings in the set, up to RTE_RING_SET_MAX_RINGS.
+ * @param socket_id
+ *   The *socket_id* argument is the socket identifier in case of
+ *   NUMA. The value can be *SOCKET_ID_ANY* if there is no NUMA
+ *   constraint for the reserved zone.
+ * @param flags
+ *   0 or RTE_RING_SET_F_PRIORITY.
+ * @return
+ *   On success, the pointer to the new ring set. NULL on error with
+ *    rte_errno set appropriately. Possible errno values include:
+ *    - EINVAL - max_rings or flags are invalid
+ *    - ENAMETOOLONG - the name is too long
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ */
+__rte_experimental
+struct rte_ring_set *
+rte_ring_set_create(const char *name, unsigned int max_rings, int socket_id,
+		unsigned int flags);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free a ring set. The rings of the set are not freed.
+ *
+ * @param set
+ *   Ring set to free, or NULL.
+ */
+__rte_experimental
+void
+rte_ring_set_free(struct rte_ring_set *set);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a ring to a ring set.
+ *
+ * This function is not multi-thread safe with other calls adding rings to
+ * the same set, but the set may be used while rings are added.
+ *
+ * @param set
+ *   A pointer to the ring set.
+ * @param r
+ *   A pointer to the ring to add.
+ * @return
+ *   - The index of the ring in the set, used by the producers.
+ *   - -EINVAL: invalid parameters.
+ *   - -ENOSPC: the set already has max_rings rings.
+ */
+__rte_experimental
+int
+rte_ring_set_add(struct rte_ring_set *set, struct rte_ring *r);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dump the status of a ring set and of its rings.
+ *
+ * @param f
+ *   A pointer to a file for output.
+ * @param set
+ *   A pointer to the ring set.
+ */
+__rte_experimental
+void
+rte_ring_set_dump(FILE *f, const struct rte_ring_set *set);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Signal that objects were enqueued in a ring of a set.
+ *
+ * It must be called after enqueuing objects in the ring without the ring
+ * set API, for instance with the zero-copy enqueue API.
+ *
+ * @param set
+ *   A pointer to the ring set.
+ * @param idx
+ *   The index of the ring in the set.
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_ring_set_notify(struct rte_ring_set *set, unsigned int idx)
+{
+	uint64_t *word = &set->doorbell[idx / __RTE_RING_SET_WORD_BITS];
+	uint64_t bit = UINT64_C(1) << (idx % __RTE_RING_SET_WORD_BITS);
+
+	/* order the enqueue before the doorbell read, see consumer side */
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	/* do not write the shared doorbell while the bit is set */
+	if ((__atomic_load_n(word, __ATOMIC_RELAXED) & bit) == 0)
+		__atomic_fetch_or(word, bit, __ATOMIC_RELAXED);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue several objects on a ring of a set.
+ *
+ * @param set
+ *   A pointer to the ring set.
+ * @param idx
+ *   The index of the ring in the set.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued, either 0 or n
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_enqueue_bulk_elem(struct rte_ring_set *set, unsigned int idx,
+		const void *obj_table, unsigned int esize, unsigned int n,
+		unsigned int *free_space)
+{
+	n = rte_ring_enqueue_bulk_elem(set->rings[idx], obj_table, esize, n,
+			free_space);
+	if (n != 0)
+		rte_ring_set_notify(set, idx);
+	return n;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue several objects on a ring of a set.
+ *
+ * @param set
+ *   A pointer to the ring set.
+ * @param idx
+ *   The index of the ring in the set.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued, either 0 or n
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_enqueue_bulk(struct rte_ring_set *set, unsigned int idx,
+		void * const *obj_table, unsigned int n,
+		unsigned int *free_space)
+{
+	return rte_ring_set_enqueue_bulk_elem(set, idx, obj_table,
+			sizeof(void *), n, free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue up to n objects on a ring of a set.
+ *
+ * @param set
+ *   A pointer to the ring set.
+ * @param idx
+ *   The index of the ring in the set.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   - n: Actual number of objects enqueued.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_enqueue_burst_elem(struct rte_ring_set *set, unsigned int idx,
+		const void *obj_table, unsigned int esize, unsigned int n,
+		unsigned int *free_space)
+{
+	n = rte_ring_enqueue_burst_elem(set->rings[idx], obj_table, esize, n,
+			free_space);
+	if (n != 0)
+		rte_ring_set_notify(set, idx);
+	return n;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue up to n objects on a ring of a set.
+ *
+ * @param set
+ *   A pointer to the ring set.
+ * @param idx
+ *   The index of the ring in the set.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   if non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   - n: Actual number of objects enqueued.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_enqueue_burst(struct rte_ring_set *set, unsigned int idx,
+		void * const *obj_table, unsigned int n,
+		unsigned int *free_space)
+{
+	return rte_ring_set_enqueue_burst_elem(set, idx, obj_table,
+			sizeof(void *), n, free_space);
+}
+
+/**
+ * @internal Read a doorbell word, without the bits of the rings added
+ * after nb_rings was read.
+ */
+static __rte_always_inline uint64_t
+__rte_ring_set_word(const struct rte_ring_set *set, unsigned int nb_rings,
+		unsigned int w)
+{
+	uint64_t bits = __atomic_load_n(&set->doorbell[w], __ATOMIC_RELAXED);
+	unsigned int last = nb_rings - w * __RTE_RING_SET_WORD_BITS;
+
+	if (last < __RTE_RING_SET_WORD_BITS)
+		bits &= (UINT64_C(1) << last) - 1;
+	return bits;
+}
+
+/**
+ * @internal Find the first ring from index start, wrapping around, whose
+ * doorbell is set. Return nb_rings if there is none.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_set_next(const struct rte_ring_set *set, unsigned int nb_rings,
+		unsigned int start)
+{
+	unsigned int nb_words, w, i;
+	uint64_t bits;
+
+	nb_words = RTE_ALIGN_CEIL(nb_rings, __RTE_RING_SET_WORD_BITS) /
+		__RTE_RING_SET_WORD_BITS;
+	w = start / __RTE_RING_SET_WORD_BITS;
+	bits = __rte_ring_set_word(set, nb_rings, w) &
+		(UINT64_MAX << (start % __RTE_RING_SET_WORD_BITS));
+
+	/* the start word is read again last, for the bits before start */
+	for (i = 0; bits == 0; i++) {
+		if (i == nb_words)
+			return nb_rings;
+		if (++w == nb_words)
+			w = 0;
+		bits = __rte_ring_set_word(set, nb_rings, w);
+	}
+
+	return w * __RTE_RING_SET_WORD_BITS + rte_bsf64(bits);
+}
+
+/**
+ * @internal Clear the doorbell of a ring found empty, and set it back if
+ * objects were enqueued meanwhile.
+ */
+static __rte_always_inline void
+__rte_ring_set_clear(struct rte_ring_set *set, unsigned int idx)
+{
+	uint64_t *word = &set->doorbell[idx / __RTE_RING_SET_WORD_BITS];
+	uint64_t bit = UINT64_C(1) << (idx % __RTE_RING_SET_WORD_BITS);
+	struct rte_ring *r = set->rings[idx];
+
+	/* order the doorbell clear before the ring read, see producer side */
+	__atomic_fetch_and(word, ~bit, __ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&r->prod.tail, __ATOMIC_SEQ_CST) !=
+			__atomic_load_n(&r->cons.tail, __ATOMIC_RELAXED))
+		__atomic_fetch_or(word, bit, __ATOMIC_RELAXED);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dequeue up to n objects from the next ring of a set which has objects.
+ *
+ * The objects are dequeued from a single ring, chosen following the
+ * policy of the set. When the set is polled by several threads, the
+ * rings must allow multiple consumers, and the round-robin order is
+ * shared by the threads.
+ *
+ * @param set
+ *   A pointer to the ring set.
+ * @param obj_table
+ *   A pointer to a table of objects that will be filled.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the rings. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to dequeue from the ring to the obj_table.
+ * @param ring_idx
+ *   If non-NULL, returns the index of the ring the objects were dequeued
+ *   from.
+ * @return
+ *   - n: Actual number of objects dequeued, 0 if all the rings are empty.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_dequeue_burst_elem(struct rte_ring_set *set, void *obj_table,
+		unsigned int esize, unsigned int n, unsigned int *ring_idx)
+{
+	unsigned int nb_rings, start, idx, nb, i;
+
+	nb_rings = __atomic_load_n(&set->nb_rings, __ATOMIC_ACQUIRE);
+	if (unlikely(nb_rings == 0))
+		return 0;
+
+	if (set->flags & RTE_RING_SET_F_PRIORITY)
+		start = 0;
+	else
+		start = __atomic_load_n(&set->next, __ATOMIC_RELAXED);
+	if (unlikely(start >= nb_rings))
+		start = 0;
+
+	/* the doorbell of a ring emptied by the last dequeue is still set */
+	for (i = 0; i < nb_rings; i++) {
+		idx = __rte_ring_set_next(set, nb_rings, start);
+		if (idx == nb_rings)
+			return 0;
+
+		nb = rte_ring_dequeue_burst_elem(set->rings[idx], obj_table,
+				esize, n, NULL);
+		if (nb == 0)
+			__rte_ring_set_clear(set, idx);
+
+		start = idx + 1 == nb_rings ? 0 : idx + 1;
+		if (nb != 0) {
+			if (!(set->flags & RTE_RING_SET_F_PRIORITY))
+				__atomic_store_n(&set->next, start,
+						__ATOMIC_RELAXED);
+			if (ring_idx != NULL)
+				*ring_idx = idx;
+			return nb;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dequeue up to n objects from the next ring of a set which has objects.
+ *
+ * @param set
+ *   A pointer to the ring set.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The number of objects to dequeue from the ring to the obj_table.
+ * @param ring_idx
+ *   If non-NULL, returns the index of the ring the objects were dequeued
+ *   from.
+ * @return
+ *   - n: Actual number of objects dequeued, 0 if all the rings are empty.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_dequeue_burst(struct rte_ring_set *set, void **obj_table,
+		unsigned int n, unsigned int *ring_idx)
+{
+	return rte_ring_set_dequeue_burst_elem(set, obj_table,
+			sizeof(void *), n, ring_idx);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RING_SET_H_ */
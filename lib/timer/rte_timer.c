@@ -53,9 +53,54 @@ struct priv_timer {
 #endif
 } __rte_cache_aligned;
 
+/*
+ * The wheel backend does not use the skiplist levels of the timers: a timer
+ * in a wheel slot is linked through sl_next[WHEEL_NEXT], and
+ * sl_next[WHEEL_PPREV] points to the link that points to it (NULL when the
+ * timer is not in a slot). Timers armed from another lcore are queued
+ * through sl_next[WHEEL_QNEXT].
+ */
+#define WHEEL_NEXT	0
+#define WHEEL_PPREV	1
+#define WHEEL_QNEXT	2
+
+#define WHEEL_LEVELS	4
+#define WHEEL_SLOT_BITS	8
+#define WHEEL_SLOTS	(1 << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK	(WHEEL_SLOTS - 1)
+/* timers expiring later than that are cascaded until they get closer */
+#define WHEEL_RANGE	(UINT64_C(1) << (WHEEL_LEVELS * WHEEL_SLOT_BITS))
+
+/* default resolution of the wheels, in ticks per second */
+#define WHEEL_DEFAULT_TICK_HZ	100000
+
+/**
+ * Per-lcore hierarchical timing wheel. Level n slot i holds the timers
+ * expiring in the 256^n ticks at (i * 256^n) modulo 256^(n+1), the slots
+ * of level n+1 are spread over the lower levels when level n wraps.
+ * The wheel lock is the list_lock of the lcore, only arm_queue is written
+ * without it.
+ */
+struct timer_wheel {
+	/** timers armed by other lcores, not yet in the wheel */
+	struct rte_timer *arm_queue;
+
+	/** next tick to process */
+	uint64_t cur_tick __rte_cache_aligned;
+	/** number of timers in the slots */
+	unsigned int nb_pending;
+	/** slots that may be non-empty */
+	uint64_t slot_map[WHEEL_LEVELS][WHEEL_SLOTS / 64];
+	/** timer lists of each level */
+	struct rte_timer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+} __rte_cache_aligned;
+
 #define FL_ALLOCATED	(1 << 0)
 struct rte_timer_data {
 	struct priv_timer priv_timer[RTE_MAX_LCORE];
+	/** per-lcore wheels, NULL with the skiplist backend */
+	struct timer_wheel *wheel;
+	unsigned int wheel_shift;   /**< log2 of timer cycles per wheel tick */
 	uint8_t internal_flags;
 };
 
@@ -122,6 +167,64 @@ rte_timer_data_dealloc(uint32_t id)
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
+	rte_free(timer_data->wheel);
+	timer_data->wheel = NULL;
+
+	return 0;
+}
+
+int
+rte_timer_data_alloc_conf(uint32_t *id_ptr,
+			  const struct rte_timer_data_conf *conf)
+{
+	struct timer_wheel *wheel;
+	uint64_t tick, cur_tick;
+	unsigned int shift;
+	uint32_t id;
+	int i, ret;
+
+	if (conf == NULL)
+		return -EINVAL;
+
+	switch (conf->backend) {
+	case RTE_TIMER_BACKEND_SKIPLIST:
+		return rte_timer_data_alloc(id_ptr);
+	case RTE_TIMER_BACKEND_WHEEL:
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (!rte_timer_subsystem_initialized)
+		return -ENOMEM;
+
+	tick = conf->wheel_tick;
+	if (tick == 0)
+		tick = RTE_MAX(rte_get_timer_hz() / WHEEL_DEFAULT_TICK_HZ,
+			       UINT64_C(1));
+	if (tick > UINT64_C(1) << 63)
+		return -EINVAL;
+	shift = rte_log2_u64(tick);
+
+	wheel = rte_zmalloc("timer_wheel", sizeof(*wheel) * RTE_MAX_LCORE,
+			    RTE_CACHE_LINE_SIZE);
+	if (wheel == NULL)
+		return -ENOMEM;
+
+	cur_tick = rte_get_timer_cycles() >> shift;
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		wheel[i].cur_tick = cur_tick;
+
+	ret = rte_timer_data_alloc(&id);
+	if (ret < 0) {
+		rte_free(wheel);
+		return ret;
+	}
+
+	rte_timer_data_arr[id].wheel = wheel;
+	rte_timer_data_arr[id].wheel_shift = shift;
+	if (id_ptr)
+		*id_ptr = id;
 
 	return 0;
 }
@@ -170,6 +273,7 @@ rte_timer_subsystem_init(void)
 	if (do_full_init) {
 		for (i = 0; i < RTE_MAX_DATA_ELS; i++) {
 			data = &rte_timer_data_arr[i];
+			data->wheel = NULL;
 
 			for (lcore_id = 0; lcore_id < RTE_MAX_LCORE;
 			     lcore_id++) {
@@ -470,6 +574,356 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
 
+static inline struct rte_timer **
+timer_wheel_pprev(const struct rte_timer *tim)
+{
+	return (struct rte_timer **)(void *)tim->sl_next[WHEEL_PPREV];
+}
+
+static inline void
+timer_wheel_set_pprev(struct rte_timer *tim, struct rte_timer **pprev)
+{
+	tim->sl_next[WHEEL_PPREV] = (struct rte_timer *)(void *)pprev;
+}
+
+/*
+ * call with the wheel lock held
+ * add in the slot of the expiry tick, relative to the current tick
+ */
+static void
+timer_wheel_link(struct timer_wheel *w, struct rte_timer *tim,
+		 unsigned int shift)
+{
+	uint64_t tick, delta;
+	unsigned int level, idx;
+	struct rte_timer **head;
+
+	/* round up, a timer never expires before its expiry time */
+	tick = tim->expire >> shift;
+	if (tim->expire & ((UINT64_C(1) << shift) - 1))
+		tick++;
+
+	if (tick < w->cur_tick)
+		tick = w->cur_tick;
+	delta = tick - w->cur_tick;
+	if (delta >= WHEEL_RANGE) {
+		/* park it in the last level, it is cascaded back there
+		 * until it comes within range
+		 */
+		delta = WHEEL_RANGE - 1;
+		tick = w->cur_tick + delta;
+	}
+
+	level = delta < WHEEL_SLOTS ? 0 :
+		(rte_fls_u64(delta) - 1) / WHEEL_SLOT_BITS;
+	idx = (tick >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+	head = &w->slots[level][idx];
+
+	tim->sl_next[WHEEL_NEXT] = *head;
+	if (*head != NULL)
+		timer_wheel_set_pprev(*head, &tim->sl_next[WHEEL_NEXT]);
+	timer_wheel_set_pprev(tim, head);
+	*head = tim;
+
+	w->slot_map[level][idx / 64] |= UINT64_C(1) << (idx % 64);
+}
+
+/*
+ * call with the wheel lock held
+ * timer must be in a slot; the slot map bit is left set, the slot is
+ * found empty when the wheel reaches it
+ */
+static void
+timer_wheel_unlink(struct rte_timer *tim)
+{
+	struct rte_timer **pprev = timer_wheel_pprev(tim);
+	struct rte_timer *next = tim->sl_next[WHEEL_NEXT];
+
+	*pprev = next;
+	if (next != NULL)
+		timer_wheel_set_pprev(next, pprev);
+	timer_wheel_set_pprev(tim, NULL);
+}
+
+/*
+ * call with the wheel lock held
+ * an empty wheel is not advanced by rte_timer_manage(), bring it to the
+ * current tick before adding to it
+ */
+static inline void
+timer_wheel_sync(struct timer_wheel *w, unsigned int shift)
+{
+	if (w->nb_pending == 0)
+		w->cur_tick = RTE_MAX(w->cur_tick,
+				      rte_get_timer_cycles() >> shift);
+}
+
+/* call with the wheel lock held, move the queued timers to the slots */
+static void
+timer_wheel_drain(struct timer_wheel *w, unsigned int shift)
+{
+	struct rte_timer *tim, *next_tim;
+
+	/* taking the whole queue at once is safe against concurrent
+	 * pushes without any ABA issue
+	 */
+	tim = __atomic_exchange_n(&w->arm_queue, NULL, __ATOMIC_ACQUIRE);
+	if (tim != NULL)
+		timer_wheel_sync(w, shift);
+	for ( ; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[WHEEL_QNEXT];
+		timer_wheel_link(w, tim, shift);
+		w->nb_pending++;
+	}
+}
+
+/* lock-free, queue a timer to be added to the wheel of another lcore */
+static void
+timer_wheel_push(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct rte_timer *head;
+
+	head = __atomic_load_n(&w->arm_queue, __ATOMIC_RELAXED);
+	do {
+		tim->sl_next[WHEEL_QNEXT] = head;
+		/* The "RELEASE" ordering publishes the timer fields to the
+		 * lcore that drains the queue
+		 */
+	} while (!__atomic_compare_exchange_n(&w->arm_queue, &head, tim, 0,
+					      __ATOMIC_RELEASE,
+					      __ATOMIC_RELAXED));
+}
+
+/*
+ * add in the wheel of tim_lcore and mark the timer pending
+ * timer must be in config state
+ * timer must not be in a wheel
+ */
+static void
+timer_wheel_add(struct rte_timer *tim, unsigned int tim_lcore,
+		int local_is_locked, struct rte_timer_data *timer_data)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+	struct timer_wheel *w = &timer_data->wheel[tim_lcore];
+	union rte_timer_status status;
+
+	status.state = RTE_TIMER_PENDING;
+	status.owner = (int16_t)tim_lcore;
+
+	timer_wheel_set_pprev(tim, NULL);
+
+	/* the timers of another lcore are queued without locking, the
+	 * status is updated after the push so that anyone who sees the
+	 * timer pending on tim_lcore finds it in the queue or the wheel
+	 */
+	if (tim_lcore != lcore_id) {
+		timer_wheel_push(w, tim);
+		__atomic_store_n(&tim->status.u32, status.u32,
+				 __ATOMIC_RELEASE);
+		return;
+	}
+
+	if (!local_is_locked)
+		rte_spinlock_lock(&priv_timer[tim_lcore].list_lock);
+
+	timer_wheel_sync(w, timer_data->wheel_shift);
+	timer_wheel_link(w, tim, timer_data->wheel_shift);
+	w->nb_pending++;
+	/* The "RELEASE" ordering guarantees the memory operations above
+	 * the status update are observed before the update by all threads
+	 */
+	__atomic_store_n(&tim->status.u32, status.u32, __ATOMIC_RELEASE);
+
+	if (!local_is_locked)
+		rte_spinlock_unlock(&priv_timer[tim_lcore].list_lock);
+}
+
+/*
+ * del from the wheel, lock if needed
+ * timer must be in config state
+ * timer must be pending, in the wheel or in the queue of its owner
+ */
+static void
+timer_wheel_del(struct rte_timer *tim, union rte_timer_status prev_status,
+		int local_is_locked, struct rte_timer_data *timer_data)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int prev_owner = prev_status.owner;
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+	struct timer_wheel *w = &timer_data->wheel[prev_owner];
+
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+
+	/* not in a slot yet, it is still queued */
+	if (timer_wheel_pprev(tim) == NULL)
+		timer_wheel_drain(w, timer_data->wheel_shift);
+
+	/* a periodic timer reloaded by rte_timer_manage() is in none */
+	if (timer_wheel_pprev(tim) != NULL) {
+		timer_wheel_unlink(tim);
+		w->nb_pending--;
+	}
+
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
+}
+
+/*
+ * find the first slot of a level that may be non-empty, from idx and
+ * wrapping around, WHEEL_SLOTS if none
+ */
+static unsigned int
+timer_wheel_next_slot(const uint64_t *map, unsigned int idx)
+{
+	unsigned int i = idx / 64;
+	uint64_t bits = map[i] & (UINT64_MAX << (idx % 64));
+	unsigned int n;
+
+	for (n = 0; n <= WHEEL_SLOTS / 64; n++) {
+		if (bits != 0)
+			return i * 64 + rte_bsf64(bits);
+		i = (i + 1) % (WHEEL_SLOTS / 64);
+		bits = map[i];
+	}
+
+	return WHEEL_SLOTS;
+}
+
+/*
+ * call with the wheel lock held
+ * return the first tick after the current one with a level 0 slot to
+ * expire or a slot to cascade, so that the ticks in between are skipped
+ */
+static uint64_t
+timer_wheel_next_tick(const struct timer_wheel *w)
+{
+	uint64_t tick = w->cur_tick + 1;
+	uint64_t next_tick = UINT64_MAX;
+	uint64_t block, cand;
+	unsigned int level, shift, idx, slot;
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		shift = level * WHEEL_SLOT_BITS;
+		/* level n slots are reached every 256^n ticks */
+		block = level == 0 ? tick : ((tick - 1) >> shift) + 1;
+		idx = block & WHEEL_SLOT_MASK;
+
+		slot = timer_wheel_next_slot(w->slot_map[level], idx);
+		if (slot == WHEEL_SLOTS)
+			continue;
+
+		cand = (block + ((slot - idx) & WHEEL_SLOT_MASK)) << shift;
+		next_tick = RTE_MIN(next_tick, cand);
+	}
+
+	return next_tick;
+}
+
+/* call with the wheel lock held, when level 0 wraps */
+static void
+timer_wheel_cascade(struct timer_wheel *w, unsigned int shift)
+{
+	struct rte_timer *tim, *next_tim;
+	unsigned int level, idx;
+
+	for (level = 1; level < WHEEL_LEVELS; level++) {
+		idx = (w->cur_tick >> (level * WHEEL_SLOT_BITS)) &
+			WHEEL_SLOT_MASK;
+
+		tim = w->slots[level][idx];
+		w->slots[level][idx] = NULL;
+		w->slot_map[level][idx / 64] &= ~(UINT64_C(1) << (idx % 64));
+		for ( ; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[WHEEL_NEXT];
+			timer_wheel_link(w, tim, shift);
+		}
+
+		/* the next level only wraps with this one */
+		if (idx != 0)
+			break;
+	}
+}
+
+/*
+ * Move the queued timers to the wheel of an lcore and take the timers that
+ * expired out of it, return them in a run list in the running state.
+ */
+static struct rte_timer *
+timer_wheel_expired(struct rte_timer_data *timer_data, unsigned int lcore)
+{
+	struct priv_timer *privp = &timer_data->priv_timer[lcore];
+	struct timer_wheel *w = &timer_data->wheel[lcore];
+	const unsigned int shift = timer_data->wheel_shift;
+	struct rte_timer *tim, *next_tim, *busy_tim = NULL;
+	struct rte_timer *run_first_tim = NULL, **pprev = &run_first_tim;
+	uint64_t now;
+	unsigned int idx;
+
+	/* optimize for the case where nothing is queued or due, without
+	 * taking the lock
+	 */
+	if (__atomic_load_n(&w->arm_queue, __ATOMIC_RELAXED) == NULL &&
+	    w->nb_pending == 0)
+		return NULL;
+	now = rte_get_timer_cycles() >> shift;
+#ifdef RTE_ARCH_64
+	if (__atomic_load_n(&w->arm_queue, __ATOMIC_RELAXED) == NULL &&
+	    likely(w->cur_tick > now))
+		return NULL;
+#endif
+
+	rte_spinlock_lock(&privp->list_lock);
+
+	timer_wheel_drain(w, shift);
+
+	while (w->cur_tick <= now) {
+		idx = w->cur_tick & WHEEL_SLOT_MASK;
+		if (idx == 0)
+			timer_wheel_cascade(w, shift);
+
+		/* transition the slot from PENDING to RUNNING */
+		tim = w->slots[0][idx];
+		w->slots[0][idx] = NULL;
+		w->slot_map[0][idx / 64] &= ~(UINT64_C(1) << (idx % 64));
+		for ( ; tim != NULL; tim = next_tim) {
+			next_tim = tim->sl_next[WHEEL_NEXT];
+			timer_wheel_set_pprev(tim, NULL);
+			w->nb_pending--;
+
+			if (likely(timer_set_running_state(tim) == 0)) {
+				*pprev = tim;
+				pprev = &tim->sl_next[0];
+			} else {
+				/* another core is configuring this one, it
+				 * expects to find it in the wheel
+				 */
+				tim->sl_next[WHEEL_NEXT] = busy_tim;
+				busy_tim = tim;
+			}
+		}
+
+		/* skip the ticks with nothing to do */
+		if (w->nb_pending == 0)
+			w->cur_tick = now + 1;
+		else
+			w->cur_tick = RTE_MIN(timer_wheel_next_tick(w),
+					      now + 1);
+	}
+	*pprev = NULL;
+
+	for (tim = busy_tim; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[WHEEL_NEXT];
+		timer_wheel_link(w, tim, shift);
+		w->nb_pending++;
+	}
+
+	rte_spinlock_unlock(&privp->list_lock);
+
+	return run_first_tim;
+}
+
 /* Reset and start the timer associated with the timer handle (private func) */
 static int
 __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
@@ -511,7 +965,12 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 
 	/* remove it from list */
 	if (prev_status.state == RTE_TIMER_PENDING) {
-		timer_del(tim, prev_status, local_is_locked, priv_timer);
+		if (timer_data->wheel != NULL)
+			timer_wheel_del(tim, prev_status, local_is_locked,
+					timer_data);
+		else
+			timer_del(tim, prev_status, local_is_locked,
+				  priv_timer);
 		__TIMER_STAT_ADD(priv_timer, pending, -1);
 	}
 
@@ -520,6 +979,12 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 	tim->f = fct;
 	tim->arg = arg;
 
+	if (timer_data->wheel != NULL) {
+		__TIMER_STAT_ADD(priv_timer, pending, 1);
+		timer_wheel_add(tim, tim_lcore, local_is_locked, timer_data);
+		return 0;
+	}
+
 	/* if timer needs to be scheduled on another core, we need to
 	 * lock the destination list; if it is on local core, we need to lock if
 	 * we are not called from rte_timer_manage()
@@ -609,7 +1074,12 @@ __rte_timer_stop(struct rte_timer *tim, int local_is_locked,
 
 	/* remove it from list */
 	if (prev_status.state == RTE_TIMER_PENDING) {
-		timer_del(tim, prev_status, local_is_locked, priv_timer);
+		if (timer_data->wheel != NULL)
+			timer_wheel_del(tim, prev_status, local_is_locked,
+					timer_data);
+		else
+			timer_del(tim, prev_status, local_is_locked,
+				  priv_timer);
 		__TIMER_STAT_ADD(priv_timer, pending, -1);
 	}
 
@@ -657,26 +1127,22 @@ rte_timer_pending(struct rte_timer *tim)
 				__ATOMIC_RELAXED) == RTE_TIMER_PENDING;
 }
 
-/* must be called periodically, run all timer that expired */
-static void
-__rte_timer_manage(struct rte_timer_data *timer_data)
+/*
+ * Take the timers that expired out of the skiplist of an lcore, return them
+ * in a run list in the running state.
+ */
+static struct rte_timer *
+timer_skiplist_expired(struct priv_timer *priv_timer, unsigned int lcore_id)
 {
-	union rte_timer_status status;
 	struct rte_timer *tim, *next_tim;
 	struct rte_timer *run_first_tim, **pprev;
-	unsigned lcore_id = rte_lcore_id();
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
 	uint64_t cur_time;
 	int i, ret;
-	struct priv_timer *priv_timer = timer_data->priv_timer;
 
-	/* timer manager only runs on EAL thread with valid lcore_id */
-	assert(lcore_id < RTE_MAX_LCORE);
-
-	__TIMER_STAT_ADD(priv_timer, manage, 1);
 	/* optimize for the case where per-cpu list is empty */
 	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
-		return;
+		return NULL;
 	cur_time = rte_get_timer_cycles();
 
 #ifdef RTE_ARCH_64
@@ -684,7 +1150,7 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 	 * updated atomically, so we can consult that for a quick check here
 	 * outside the lock */
 	if (likely(priv_timer[lcore_id].pending_head.expire > cur_time))
-		return;
+		return NULL;
 #endif
 
 	/* browse ordered list, add expired timers in 'expired' list */
@@ -694,7 +1160,7 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
 	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
 		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
-		return;
+		return NULL;
 	}
 
 	/* save start of list of expired timers */
@@ -737,6 +1203,28 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 
 	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
 
+	return run_first_tim;
+}
+
+/* must be called periodically, run all timer that expired */
+static void
+__rte_timer_manage(struct rte_timer_data *timer_data)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim;
+	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+	if (timer_data->wheel != NULL)
+		run_first_tim = timer_wheel_expired(timer_data, lcore_id);
+	else
+		run_first_tim = timer_skiplist_expired(priv_timer, lcore_id);
+
 	/* now scan expired list and call callbacks */
 	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
 		next_tim = tim->sl_next[0];
@@ -831,6 +1319,13 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 		poll_lcore = poll_lcores[i];
 		privp = &data->priv_timer[poll_lcore];
 
+		if (data->wheel != NULL) {
+			tim = timer_wheel_expired(data, poll_lcore);
+			if (tim != NULL)
+				run_first_tims[nb_runlists++] = tim;
+			continue;
+		}
+
 		/* optimize for the case where per-cpu list is empty */
 		if (privp->pending_head.sl_next[0] == NULL)
 			continue;
@@ -976,6 +1471,53 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* Walk the wheel of an lcore, stopping timers and calling f */
+static void
+timer_wheel_stop_all(struct rte_timer_data *timer_data, unsigned int lcore,
+		     rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+	struct timer_wheel *w = &timer_data->wheel[lcore];
+	union rte_timer_status prev_status, status;
+	struct rte_timer *tim, *next_tim;
+	unsigned int level, idx;
+
+	rte_spinlock_lock(&priv_timer[lcore].list_lock);
+
+	timer_wheel_drain(w, timer_data->wheel_shift);
+
+	for (level = 0; level < WHEEL_LEVELS && w->nb_pending != 0; level++) {
+		for (idx = 0; idx < WHEEL_SLOTS; idx++) {
+			for (tim = w->slots[level][idx]; tim != NULL;
+			     tim = next_tim) {
+				next_tim = tim->sl_next[WHEEL_NEXT];
+
+				/* leave the timers being configured by
+				 * another core to it
+				 */
+				if (timer_set_config_state(tim, &prev_status,
+							   priv_timer) < 0)
+					continue;
+
+				timer_wheel_unlink(tim);
+				w->nb_pending--;
+				__TIMER_STAT_ADD(priv_timer, stop, 1);
+				__TIMER_STAT_ADD(priv_timer, pending, -1);
+
+				status.state = RTE_TIMER_STOP;
+				status.owner = RTE_TIMER_NO_OWNER;
+				__atomic_store_n(&tim->status.u32, status.u32,
+						 __ATOMIC_RELEASE);
+
+				if (f)
+					f(tim, f_arg);
+			}
+		}
+	}
+
+	rte_spinlock_unlock(&priv_timer[lcore].list_lock);
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -994,6 +1536,11 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 		walk_lcore = walk_lcores[i];
 		priv_timer = &timer_data->priv_timer[walk_lcore];
 
+		if (timer_data->wheel != NULL) {
+			timer_wheel_stop_all(timer_data, walk_lcore, f, f_arg);
+			continue;
+		}
+
 		rte_spinlock_lock(&priv_timer->list_lock);
 
 		for (tim = priv_timer->pending_head.sl_next[0];
@@ -158,6 +158,61 @@ int rte_timer_data_alloc(uint32_t *id_ptr);
  */
 int rte_timer_data_dealloc(uint32_t id);
 
+/**
+ * Implementation of the pending timer lists of a timer data instance.
+ */
+enum rte_timer_backend {
+	/** Skiplists sorted by expiry time, O(log n) add and delete. */
+	RTE_TIMER_BACKEND_SKIPLIST = 0,
+	/** Hierarchical timing wheels, O(1) add and delete. */
+	RTE_TIMER_BACKEND_WHEEL,
+};
+
+/**
+ * Configuration of a timer data instance.
+ */
+struct rte_timer_data_conf {
+	enum rte_timer_backend backend; /**< Pending timer lists. */
+	/**
+	 * Resolution of the wheel backend in timer cycles, rounded up to a
+	 * power of two; 0 selects about 10 us. Timers expire in the first
+	 * call to rte_timer_alt_manage() after the end of the wheel tick
+	 * that contains their expiry time, and the timers expiring in the
+	 * same tick run in no particular order.
+	 */
+	uint64_t wheel_tick;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate a timer data instance with the given pending timer lists.
+ *
+ * With the wheel backend, each lcore owns a hierarchical timing wheel: the
+ * timers are added and deleted in constant time and rte_timer_alt_manage()
+ * only visits the wheel slots that elapsed. Timers armed from another lcore
+ * are pushed to a lock-free queue of the target lcore, which moves them to
+ * its wheel on its next rte_timer_alt_manage(). The timers of a wheel
+ * backend instance are managed with the rte_timer_alt_*() functions.
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param conf
+ *   Configuration of the timer data instance.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: invalid configuration
+ *   - -ENOMEM: not enough memory for the timing wheels, or timer library
+ *     not initialized
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ */
+__rte_experimental
+int rte_timer_data_alloc_conf(uint32_t *id_ptr,
+			      const struct rte_timer_data_conf *conf);
+
 /**
  * Initialize the timer library.
  *
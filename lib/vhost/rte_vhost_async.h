@@ -90,6 +90,7 @@ struct async_inflight_info {
 	struct rte_mbuf *mbuf;
 	uint16_t descs; /* num of descs inflight */
 	uint16_t nr_buffers; /* num of buffers inflight for packed ring */
+	struct virtio_net_hdr nethdr; /* virtio-net header for dequeue */
 };
 
 /**
@@ -193,4 +194,35 @@ __rte_experimental
 uint16_t rte_vhost_poll_enqueue_completed(int vid, uint16_t queue_id,
 		struct rte_mbuf **pkts, uint16_t count);
 
+/**
+ * This function tries to receive packets from the guest with offloading
+ * copies to the async channel. Packet data is submitted to the async
+ * engine and the packets whose copies are completed are returned in
+ * "pkts", in the order they were sent by the guest. Packets whose copies
+ * are submitted but not completed yet are called in-flight packets; they
+ * are returned by later calls of this function, so users need to keep
+ * calling it until no in-flight packet is left before unregistering the
+ * async channel.
+ *
+ * @param vid
+ *  id of vhost device to dequeue data
+ * @param queue_id
+ *  queue id to dequeue data
+ * @param mbuf_pool
+ *  mbuf_pool where host mbuf is allocated
+ * @param pkts
+ *  blank array to keep successfully dequeued packets
+ * @param count
+ *  size of the packet array
+ * @param nr_inflight
+ *  num of in-flight packets when this API returns. If error occurred,
+ *  its value is set to -1.
+ * @return
+ *  num of successfully dequeued packets
+ */
+__rte_experimental
+uint16_t rte_vhost_async_try_dequeue_burst(int vid, uint16_t queue_id,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count, int *nr_inflight);
+
 #endif /* _RTE_VHOST_ASYNC_H_ */
@@ -1702,7 +1702,7 @@ vhost_update_used_packed(struct vhost_virtqueue *vq,
 	for (i = 0; i < count; i++) {
 		uint16_t flags;
 
-		if (vq->shadow_used_packed[i].len)
+		if (shadow_ring[i].len)
 			flags = VRING_DESC_F_WRITE;
 		else
 			flags = 0;
@@ -3165,3 +3165,681 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 
 	return count;
 }
+
+static __rte_always_inline int
+async_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		  struct buf_vector *buf_vec, uint16_t nr_vec,
+		  struct rte_mbuf *m, struct rte_mempool *mbuf_pool,
+		  struct virtio_net_hdr *nethdr, uint16_t max_segs,
+		  struct iovec *src_iovec, struct iovec *dst_iovec,
+		  struct rte_vhost_iov_iter *src_it,
+		  struct rte_vhost_iov_iter *dst_it)
+{
+	uint32_t buf_avail, buf_offset;
+	uint64_t buf_addr, buf_iova, buf_len;
+	uint32_t mbuf_avail, mbuf_offset;
+	uint32_t cpy_len, cpy_threshold;
+	uint64_t mapped_len;
+	struct rte_mbuf *cur = m, *prev = m;
+	/* A counter to avoid desc dead loop chain */
+	uint16_t vec_idx = 0;
+	struct batch_copy_elem *batch_copy = vq->batch_copy_elems;
+	int error = 0;
+
+	uint32_t tlen = 0;
+	int tvec_idx = 0;
+	void *hpa;
+
+	cpy_threshold = vq->async_threshold;
+
+	buf_addr = buf_vec[vec_idx].buf_addr;
+	buf_iova = buf_vec[vec_idx].buf_iova;
+	buf_len = buf_vec[vec_idx].buf_len;
+
+	if (unlikely(buf_len < dev->vhost_hlen && nr_vec <= 1)) {
+		error = -1;
+		goto out;
+	}
+
+	/*
+	 * Offloads are only parsed once the packet data has landed in
+	 * the mbuf, so keep a copy of the header instead of a pointer
+	 * into a descriptor that is given back to the guest meanwhile.
+	 */
+	if (virtio_net_with_host_offload(dev)) {
+		if (unlikely(buf_len < sizeof(struct virtio_net_hdr)))
+			copy_vnet_hdr_from_desc(nethdr, buf_vec);
+		else
+			rte_memcpy(nethdr, (void *)(uintptr_t)buf_addr,
+					sizeof(struct virtio_net_hdr));
+	}
+
+	if (unlikely(buf_len < dev->vhost_hlen)) {
+		buf_offset = dev->vhost_hlen - buf_len;
+		vec_idx++;
+		buf_addr = buf_vec[vec_idx].buf_addr;
+		buf_iova = buf_vec[vec_idx].buf_iova;
+		buf_len = buf_vec[vec_idx].buf_len;
+		buf_avail  = buf_len - buf_offset;
+	} else if (buf_len == dev->vhost_hlen) {
+		if (unlikely(++vec_idx >= nr_vec))
+			goto out;
+		buf_addr = buf_vec[vec_idx].buf_addr;
+		buf_iova = buf_vec[vec_idx].buf_iova;
+		buf_len = buf_vec[vec_idx].buf_len;
+
+		buf_offset = 0;
+		buf_avail = buf_len;
+	} else {
+		buf_offset = dev->vhost_hlen;
+		buf_avail = buf_vec[vec_idx].buf_len - dev->vhost_hlen;
+	}
+
+	PRINT_PACKET(dev,
+			(uintptr_t)(buf_addr + buf_offset),
+			(uint32_t)buf_avail, 0);
+
+	mbuf_offset = 0;
+	mbuf_avail  = m->buf_len - RTE_PKTMBUF_HEADROOM;
+	while (1) {
+		cpy_len = RTE_MIN(buf_avail, mbuf_avail);
+
+		while (unlikely(cpy_len && cpy_len >= cpy_threshold &&
+					tvec_idx < max_segs)) {
+			hpa = (void *)(uintptr_t)gpa_to_first_hpa(dev,
+					buf_iova + buf_offset,
+					cpy_len, &mapped_len);
+
+			if (unlikely(!hpa || mapped_len < cpy_threshold))
+				break;
+
+			async_fill_vec(src_iovec + tvec_idx, hpa,
+					(size_t)mapped_len);
+
+			async_fill_vec(dst_iovec + tvec_idx,
+				(void *)(uintptr_t)rte_pktmbuf_iova_offset(cur,
+				mbuf_offset), (size_t)mapped_len);
+
+			tlen += (uint32_t)mapped_len;
+			cpy_len -= (uint32_t)mapped_len;
+			mbuf_avail  -= (uint32_t)mapped_len;
+			mbuf_offset += (uint32_t)mapped_len;
+			buf_avail  -= (uint32_t)mapped_len;
+			buf_offset += (uint32_t)mapped_len;
+			tvec_idx++;
+		}
+
+		if (likely(cpy_len)) {
+			if (unlikely(cpy_len > MAX_BATCH_LEN ||
+					vq->batch_copy_nb_elems >= vq->size)) {
+				rte_memcpy(rte_pktmbuf_mtod_offset(cur, void *,
+							mbuf_offset),
+						(void *)((uintptr_t)(buf_addr +
+								buf_offset)),
+						cpy_len);
+			} else {
+				batch_copy[vq->batch_copy_nb_elems].dst =
+					rte_pktmbuf_mtod_offset(cur, void *,
+							mbuf_offset);
+				batch_copy[vq->batch_copy_nb_elems].src =
+					(void *)((uintptr_t)(buf_addr +
+								buf_offset));
+				batch_copy[vq->batch_copy_nb_elems].len =
+					cpy_len;
+				vq->batch_copy_nb_elems++;
+			}
+
+			mbuf_avail  -= cpy_len;
+			mbuf_offset += cpy_len;
+			buf_avail -= cpy_len;
+			buf_offset += cpy_len;
+		}
+
+		/* This buf reaches to its end, get the next one */
+		if (buf_avail == 0) {
+			if (++vec_idx >= nr_vec)
+				break;
+
+			buf_addr = buf_vec[vec_idx].buf_addr;
+			buf_iova = buf_vec[vec_idx].buf_iova;
+			buf_len = buf_vec[vec_idx].buf_len;
+
+			buf_offset = 0;
+			buf_avail  = buf_len;
+
+			PRINT_PACKET(dev, (uintptr_t)buf_addr,
+					(uint32_t)buf_avail, 0);
+		}
+
+		/*
+		 * This mbuf reaches to its end, get a new one
+		 * to hold more data.
+		 */
+		if (mbuf_avail == 0) {
+			cur = rte_pktmbuf_alloc(mbuf_pool);
+			if (unlikely(cur == NULL)) {
+				VHOST_LOG_DATA(ERR, "Failed to "
+					"allocate memory for mbuf.\n");
+				error = -1;
+				goto out;
+			}
+
+			prev->next = cur;
+			prev->data_len = mbuf_offset;
+			m->nb_segs += 1;
+			m->pkt_len += mbuf_offset;
+			prev = cur;
+
+			mbuf_offset = 0;
+			mbuf_avail  = cur->buf_len - RTE_PKTMBUF_HEADROOM;
+		}
+	}
+
+	prev->data_len = mbuf_offset;
+	m->pkt_len    += mbuf_offset;
+
+out:
+	if (tlen) {
+		async_fill_iter(src_it, tlen, src_iovec, tvec_idx);
+		async_fill_iter(dst_it, tlen, dst_iovec, tvec_idx);
+	} else {
+		src_it->count = 0;
+	}
+
+	return error;
+}
+
+/*
+ * Dequeue in-flight slots are kept in [0, vq->size), as packed rings
+ * don't need to have a power of two size.
+ */
+static __rte_always_inline uint16_t
+async_dequeue_slot(struct vhost_virtqueue *vq, uint16_t idx)
+{
+	return idx < vq->size ? idx : idx - vq->size;
+}
+
+/*
+ * Copy one guest buffer into "pkt". Segments above the async threshold
+ * are described in the iov iterators for the async engine, the rest is
+ * copied by the CPU. Return 1 if the packet has copies for the async
+ * engine, 0 if it is only copied by the CPU, and -1 on failure.
+ */
+static __rte_always_inline int
+virtio_dev_tx_async_pkt(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf *pkt,
+		struct buf_vector *buf_vec, uint16_t nr_vec, uint32_t buf_len,
+		struct virtio_net_hdr *nethdr, uint16_t iovec_idx,
+		struct rte_vhost_iov_iter *src_it,
+		struct rte_vhost_iov_iter *dst_it)
+{
+	struct iovec *src_iovec = vq->vec_pool;
+	struct iovec *dst_iovec = vq->vec_pool + (VHOST_MAX_ASYNC_VEC >> 1);
+	uint16_t nr_batch = vq->batch_copy_nb_elems;
+	static bool allocerr_warned;
+
+	if (unlikely(virtio_dev_pktmbuf_prep(dev, pkt, buf_len))) {
+		if (!allocerr_warned) {
+			VHOST_LOG_DATA(ERR,
+				"Failed mbuf alloc of size %d from %s on %s.\n",
+				buf_len, mbuf_pool->name, dev->ifname);
+			allocerr_warned = true;
+		}
+		return -1;
+	}
+
+	if (unlikely(async_desc_to_mbuf(dev, vq, buf_vec, nr_vec, pkt,
+				mbuf_pool, nethdr,
+				(VHOST_MAX_ASYNC_VEC >> 1) - iovec_idx,
+				src_iovec + iovec_idx, dst_iovec + iovec_idx,
+				src_it, dst_it) < 0)) {
+		/* the packet is dropped, so are its pending CPU copies */
+		vq->batch_copy_nb_elems = nr_batch;
+		if (!allocerr_warned) {
+			VHOST_LOG_DATA(ERR,
+				"Failed to copy desc to mbuf on %s.\n",
+				dev->ifname);
+			allocerr_warned = true;
+		}
+		return -1;
+	}
+
+	return src_it->count ? 1 : 0;
+}
+
+/*
+ * Hand the copies of a burst to the async engine. If the engine doesn't
+ * take all of them, the packets from the first rejected one onwards are
+ * freed and the number of packets to keep in flight is returned.
+ */
+static __rte_always_inline uint16_t
+virtio_dev_tx_async_transfer(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t queue_id,
+		struct rte_vhost_async_desc *tdes, uint16_t *tdes_pkt_idx,
+		uint16_t nr_tdes, uint16_t nr_pkts)
+{
+	struct async_inflight_info *pkts_info = vq->async_pkts_info;
+	uint32_t n_xfer = 0;
+	uint16_t i, slot_idx;
+
+	if (nr_tdes)
+		n_xfer = vq->async_ops.transfer_data(dev->vid, queue_id,
+				tdes, 0, nr_tdes);
+
+	/* CPU copies are done while the async engine is busy */
+	do_data_copy_dequeue(vq);
+
+	if (likely(n_xfer >= nr_tdes))
+		return nr_pkts;
+
+	VHOST_LOG_DATA(DEBUG, "(%d) %s: failed to transfer %u packets for queue id %d.\n",
+		dev->vid, __func__, nr_tdes - n_xfer, queue_id);
+
+	for (i = tdes_pkt_idx[n_xfer]; i < nr_pkts; i++) {
+		slot_idx = async_dequeue_slot(vq, vq->async_pkts_idx + i);
+		rte_pktmbuf_free(pkts_info[slot_idx].mbuf);
+	}
+
+	return tdes_pkt_idx[n_xfer];
+}
+
+static __rte_noinline uint16_t
+virtio_dev_tx_async_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		uint16_t queue_id, struct rte_mempool *mbuf_pool,
+		uint16_t count)
+{
+	struct rte_vhost_iov_iter *it_pool = vq->it_pool;
+	struct async_inflight_info *pkts_info = vq->async_pkts_info;
+	struct rte_mbuf *pkts_prealloc[MAX_PKT_BURST];
+	struct rte_vhost_async_desc tdes[MAX_PKT_BURST];
+	uint16_t tdes_pkt_idx[MAX_PKT_BURST];
+	uint16_t pkt_idx, pkt_burst_idx = 0;
+	uint16_t iovec_idx = 0, it_idx = 0;
+	uint16_t free_entries, slot_idx;
+	int ret;
+
+	/*
+	 * The ordering between avail index and
+	 * desc reads needs to be enforced.
+	 */
+	free_entries = __atomic_load_n(&vq->avail->idx, __ATOMIC_ACQUIRE) -
+			vq->last_avail_idx;
+	count = RTE_MIN(count, MAX_PKT_BURST);
+	count = RTE_MIN(count, free_entries);
+	count = RTE_MIN(count, vq->size - vq->async_pkts_inflight_n);
+	if (count == 0)
+		return 0;
+
+	rte_prefetch0(&vq->avail->ring[vq->last_avail_idx & (vq->size - 1)]);
+
+	if (unlikely(rte_pktmbuf_alloc_bulk(mbuf_pool, pkts_prealloc, count)))
+		return 0;
+
+	for (pkt_idx = 0; pkt_idx < count; pkt_idx++) {
+		struct buf_vector buf_vec[BUF_VECTOR_MAX];
+		struct rte_mbuf *pkt = pkts_prealloc[pkt_idx];
+		uint16_t head_idx, nr_vec = 0;
+		uint32_t buf_len;
+
+		if (unlikely(fill_vec_buf_split(dev, vq,
+						vq->last_avail_idx + pkt_idx,
+						&nr_vec, buf_vec,
+						&head_idx, &buf_len,
+						VHOST_ACCESS_RO) < 0))
+			break;
+
+		slot_idx = async_dequeue_slot(vq, vq->async_pkts_idx + pkt_idx);
+		vq->async_descs_split[slot_idx].id = head_idx;
+		vq->async_descs_split[slot_idx].len = 0;
+
+		ret = virtio_dev_tx_async_pkt(dev, vq, mbuf_pool, pkt,
+				buf_vec, nr_vec, buf_len,
+				&pkts_info[slot_idx].nethdr, iovec_idx,
+				&it_pool[it_idx], &it_pool[it_idx + 1]);
+		if (unlikely(ret < 0)) {
+			/* drop the packet, its descs are still used */
+			rte_pktmbuf_free(pkt);
+			pkts_info[slot_idx].mbuf = NULL;
+			pkts_info[slot_idx].descs = 0;
+			pkt_idx++;
+			break;
+		}
+
+		pkts_info[slot_idx].mbuf = pkt;
+		pkts_info[slot_idx].descs = ret;
+		if (ret) {
+			async_fill_desc(&tdes[pkt_burst_idx],
+				&it_pool[it_idx], &it_pool[it_idx + 1]);
+			tdes_pkt_idx[pkt_burst_idx++] = pkt_idx;
+			iovec_idx += it_pool[it_idx].nr_segs;
+			it_idx += 2;
+		}
+	}
+
+	if (unlikely(pkt_idx < count))
+		rte_pktmbuf_free_bulk(&pkts_prealloc[pkt_idx],
+				count - pkt_idx);
+
+	pkt_idx = virtio_dev_tx_async_transfer(dev, vq, queue_id, tdes,
+			tdes_pkt_idx, pkt_burst_idx, pkt_idx);
+
+	vq->last_avail_idx += pkt_idx;
+	vq->async_pkts_idx = async_dequeue_slot(vq,
+			vq->async_pkts_idx + pkt_idx);
+	vq->async_pkts_inflight_n += pkt_idx;
+
+	return pkt_idx;
+}
+
+static __rte_noinline uint16_t
+virtio_dev_tx_async_packed(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		uint16_t queue_id, struct rte_mempool *mbuf_pool,
+		uint16_t count)
+{
+	struct rte_vhost_iov_iter *it_pool = vq->it_pool;
+	struct async_inflight_info *pkts_info = vq->async_pkts_info;
+	struct rte_mbuf *pkts_prealloc[MAX_PKT_BURST];
+	struct rte_vhost_async_desc tdes[MAX_PKT_BURST];
+	uint16_t tdes_pkt_idx[MAX_PKT_BURST];
+	uint16_t pkt_idx, pkt_burst_idx = 0;
+	uint16_t iovec_idx = 0, it_idx = 0;
+	uint16_t slot_idx, nr_pkts;
+	int ret;
+	struct {
+		uint16_t last_avail_idx;
+		bool avail_wrap_counter;
+	} async_pkts_log[MAX_PKT_BURST];
+
+	count = RTE_MIN(count, MAX_PKT_BURST);
+	count = RTE_MIN(count, vq->size - vq->async_pkts_inflight_n);
+	if (count == 0)
+		return 0;
+
+	if (unlikely(rte_pktmbuf_alloc_bulk(mbuf_pool, pkts_prealloc, count)))
+		return 0;
+
+	for (pkt_idx = 0; pkt_idx < count; pkt_idx++) {
+		struct buf_vector buf_vec[BUF_VECTOR_MAX];
+		struct rte_mbuf *pkt = pkts_prealloc[pkt_idx];
+		uint16_t buf_id, desc_count = 0, nr_vec = 0;
+		uint32_t buf_len;
+
+		rte_prefetch0(&vq->desc_packed[vq->last_avail_idx]);
+
+		if (unlikely(fill_vec_buf_packed(dev, vq,
+						 vq->last_avail_idx, &desc_count,
+						 buf_vec, &nr_vec,
+						 &buf_id, &buf_len,
+						 VHOST_ACCESS_RO) < 0))
+			break;
+
+		async_pkts_log[pkt_idx].last_avail_idx = vq->last_avail_idx;
+		async_pkts_log[pkt_idx].avail_wrap_counter =
+			vq->avail_wrap_counter;
+		vq_inc_last_avail_packed(vq, desc_count);
+
+		slot_idx = async_dequeue_slot(vq, vq->async_pkts_idx + pkt_idx);
+		vq->async_buffers_packed[slot_idx].id = buf_id;
+		vq->async_buffers_packed[slot_idx].len = 0;
+		vq->async_buffers_packed[slot_idx].count = desc_count;
+
+		ret = virtio_dev_tx_async_pkt(dev, vq, mbuf_pool, pkt,
+				buf_vec, nr_vec, buf_len,
+				&pkts_info[slot_idx].nethdr, iovec_idx,
+				&it_pool[it_idx], &it_pool[it_idx + 1]);
+		if (unlikely(ret < 0)) {
+			/* drop the packet, its descs are still used */
+			rte_pktmbuf_free(pkt);
+			pkts_info[slot_idx].mbuf = NULL;
+			pkts_info[slot_idx].descs = 0;
+			pkt_idx++;
+			break;
+		}
+
+		pkts_info[slot_idx].mbuf = pkt;
+		pkts_info[slot_idx].descs = ret;
+		if (ret) {
+			async_fill_desc(&tdes[pkt_burst_idx],
+				&it_pool[it_idx], &it_pool[it_idx + 1]);
+			tdes_pkt_idx[pkt_burst_idx++] = pkt_idx;
+			iovec_idx += it_pool[it_idx].nr_segs;
+			it_idx += 2;
+		}
+	}
+
+	if (unlikely(pkt_idx < count))
+		rte_pktmbuf_free_bulk(&pkts_prealloc[pkt_idx],
+				count - pkt_idx);
+
+	nr_pkts = virtio_dev_tx_async_transfer(dev, vq, queue_id, tdes,
+			tdes_pkt_idx, pkt_burst_idx, pkt_idx);
+	if (unlikely(nr_pkts < pkt_idx)) {
+		/* recover available ring */
+		vq->last_avail_idx = async_pkts_log[nr_pkts].last_avail_idx;
+		vq->avail_wrap_counter =
+			async_pkts_log[nr_pkts].avail_wrap_counter;
+	}
+
+	vq->async_pkts_idx = async_dequeue_slot(vq,
+			vq->async_pkts_idx + nr_pkts);
+	vq->async_pkts_inflight_n += nr_pkts;
+
+	return nr_pkts;
+}
+
+static __rte_always_inline void
+write_back_dequeue_descs_split(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t start_idx, uint16_t count)
+{
+	uint16_t i, from, to;
+
+	for (i = 0; i < count; i++) {
+		from = async_dequeue_slot(vq, start_idx + i);
+		to = vq->last_used_idx++ & (vq->size - 1);
+
+		vq->used->ring[to] = vq->async_descs_split[from];
+		vhost_log_cache_used_vring(dev, vq,
+				offsetof(struct vring_used, ring[to]),
+				sizeof(struct vring_used_elem));
+	}
+
+	vhost_log_cache_sync(dev, vq);
+
+	__atomic_add_fetch(&vq->used->idx, count, __ATOMIC_RELEASE);
+	vhost_log_used_vring(dev, vq, offsetof(struct vring_used, idx),
+		sizeof(vq->used->idx));
+}
+
+static __rte_always_inline void
+write_back_dequeue_buffers_packed(struct vhost_virtqueue *vq,
+		uint16_t start_idx, uint16_t count)
+{
+	uint16_t nr_copy = RTE_MIN(count, vq->size - start_idx);
+
+	vhost_update_used_packed(vq, vq->async_buffers_packed + start_idx,
+			nr_copy);
+	if (count > nr_copy)
+		vhost_update_used_packed(vq, vq->async_buffers_packed,
+				count - nr_copy);
+}
+
+/*
+ * Return the in-flight packets whose copies are completed, in the order
+ * they were taken from the vring, and give their descs back to the guest.
+ * Packets without async copies are complete as soon as they are reached.
+ */
+static __rte_always_inline uint16_t
+async_poll_dequeue_completed(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t queue_id,
+		struct rte_mbuf **pkts, uint16_t count, bool legacy_ol_flags)
+{
+	struct async_inflight_info *pkts_info = vq->async_pkts_info;
+	uint16_t start_idx, slot_idx, nr_async = 0, nr_cpl, nr_done = 0;
+	struct rte_mbuf *m;
+
+	count = RTE_MIN(count, vq->async_pkts_inflight_n);
+	if (count == 0)
+		return 0;
+
+	start_idx = async_dequeue_slot(vq, vq->async_pkts_idx + vq->size -
+			vq->async_pkts_inflight_n);
+
+	for (nr_cpl = 0; nr_cpl < count; nr_cpl++)
+		nr_async += pkts_info[async_dequeue_slot(vq,
+				start_idx + nr_cpl)].descs;
+
+	if (nr_async > vq->async_last_pkts_n)
+		vq->async_last_pkts_n += vq->async_ops.check_completed_copies(
+				dev->vid, queue_id, 0,
+				nr_async - vq->async_last_pkts_n);
+
+	for (nr_cpl = 0; nr_cpl < count; nr_cpl++) {
+		slot_idx = async_dequeue_slot(vq, start_idx + nr_cpl);
+		if (pkts_info[slot_idx].descs) {
+			if (vq->async_last_pkts_n == 0)
+				break;
+			vq->async_last_pkts_n--;
+		}
+
+		m = pkts_info[slot_idx].mbuf;
+		if (unlikely(m == NULL))
+			continue;
+
+		if (virtio_net_with_host_offload(dev))
+			vhost_dequeue_offload(&pkts_info[slot_idx].nethdr, m,
+					legacy_ol_flags);
+		pkts[nr_done++] = m;
+	}
+
+	if (unlikely(nr_cpl == 0))
+		return 0;
+
+	vq->async_pkts_inflight_n -= nr_cpl;
+
+	if (likely(vq->enabled && vq->access_ok)) {
+		if (vq_is_packed(dev)) {
+			write_back_dequeue_buffers_packed(vq, start_idx,
+					nr_cpl);
+			vhost_vring_call_packed(dev, vq);
+		} else {
+			write_back_dequeue_descs_split(dev, vq, start_idx,
+					nr_cpl);
+			vhost_vring_call_split(dev, vq);
+		}
+	}
+
+	return nr_done;
+}
+
+uint16_t
+rte_vhost_async_try_dequeue_burst(int vid, uint16_t queue_id,
+	struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts, uint16_t count,
+	int *nr_inflight)
+{
+	struct virtio_net *dev;
+	struct rte_mbuf *rarp_mbuf = NULL;
+	struct vhost_virtqueue *vq;
+	int16_t success = 1;
+	bool legacy_ol_flags;
+
+	*nr_inflight = -1;
+
+	dev = get_device(vid);
+	if (!dev)
+		return 0;
+
+	if (unlikely(!(dev->flags & VIRTIO_DEV_BUILTIN_VIRTIO_NET))) {
+		VHOST_LOG_DATA(ERR,
+			"(%d) %s: built-in vhost net backend is disabled.\n",
+			dev->vid, __func__);
+		return 0;
+	}
+
+	if (unlikely(!is_valid_virt_queue_idx(queue_id, 1, dev->nr_vring))) {
+		VHOST_LOG_DATA(ERR,
+			"(%d) %s: invalid virtqueue idx %d.\n",
+			dev->vid, __func__, queue_id);
+		return 0;
+	}
+
+	vq = dev->virtqueue[queue_id];
+
+	if (unlikely(rte_spinlock_trylock(&vq->access_lock) == 0))
+		return 0;
+
+	if (unlikely(!vq->async_registered)) {
+		VHOST_LOG_DATA(ERR, "(%d) %s: async not registered for queue id %d.\n",
+			dev->vid, __func__, queue_id);
+		rte_spinlock_unlock(&vq->access_lock);
+		return 0;
+	}
+
+	legacy_ol_flags = !!(dev->flags & VIRTIO_DEV_LEGACY_OL_FLAGS);
+	count = RTE_MIN(count, MAX_PKT_BURST);
+	/* no room for a packet, nor for the RARP one */
+	if (unlikely(count == 0))
+		goto out_access_unlock;
+
+	/*
+	 * Keep completing in-flight packets on a disabled vring, so
+	 * that the application can drain them before unregistering.
+	 */
+	if (unlikely(!vq->enabled)) {
+		count = async_poll_dequeue_completed(dev, vq, queue_id, pkts,
+				count, legacy_ol_flags);
+		goto out_access_unlock;
+	}
+
+	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
+		vhost_user_iotlb_rd_lock(vq);
+
+	if (unlikely(!vq->access_ok))
+		if (unlikely(vring_translate(dev, vq) < 0))
+			goto out;
+
+	/*
+	 * Construct a RARP broadcast packet, and inject it to the "pkts"
+	 * array, the same way rte_vhost_dequeue_burst() does.
+	 */
+	if (unlikely(__atomic_load_n(&dev->broadcast_rarp, __ATOMIC_ACQUIRE) &&
+			__atomic_compare_exchange_n(&dev->broadcast_rarp,
+			&success, 0, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))) {
+
+		rarp_mbuf = rte_net_make_rarp_packet(mbuf_pool, &dev->mac);
+		if (rarp_mbuf == NULL) {
+			VHOST_LOG_DATA(ERR, "Failed to make RARP packet.\n");
+			count = 0;
+			goto out_unlock;
+		}
+		count -= 1;
+	}
+
+	if (vq_is_packed(dev))
+		virtio_dev_tx_async_packed(dev, vq, queue_id, mbuf_pool, count);
+	else
+		virtio_dev_tx_async_split(dev, vq, queue_id, mbuf_pool, count);
+
+out:
+	count = async_poll_dequeue_completed(dev, vq, queue_id, pkts, count,
+			legacy_ol_flags);
+
+out_unlock:
+	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
+		vhost_user_iotlb_rd_unlock(vq);
+
+out_access_unlock:
+	*nr_inflight = vq->async_pkts_inflight_n;
+	rte_spinlock_unlock(&vq->access_lock);
+
+	if (unlikely(rarp_mbuf != NULL)) {
+		/*
+		 * Inject it to the head of "pkts" array, so that switch's mac
+		 * learning table will get updated first.
+		 */
+		memmove(&pkts[1], pkts, count * sizeof(struct rte_mbuf *));
+		pkts[0] = rarp_mbuf;
+		count += 1;
+	}
+
+	return count;
+}